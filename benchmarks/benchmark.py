@@ -30,6 +30,9 @@ class Benchmark(object):
     of every benchmark for one-time setup.
     """
 
+    #: Name of the items counted by :py:meth:`~.bench_items`.
+    item_name = 'items'
+
     def __init__(self):
         """Initialize benchmark.
 
@@ -37,6 +40,7 @@ class Benchmark(object):
         """
         self._N = None
         self._t = 0
+        self._items = None
 
     def bench_setup(self, N):
         """Setup function for benchmark.
@@ -63,6 +67,23 @@ class Benchmark(object):
         """
         pass
 
+    def bench_items(self, N):
+        """Number of work items processed by :py:meth:`~.bench_run`.
+
+        Benchmarks of kernels whose work is not proportional to :math:`N`,
+        such as the number of bonds of a neighbor query, override this method
+        to report their throughput in items per second. It is called after
+        :py:meth:`~.bench_setup`.
+
+        Args:
+            N (int):
+                Size of the input.
+
+        Returns:
+            int: Number of items (Default value = :code:`N`).
+        """
+        return N
+
     def bench_run_parallel(self, N, num_threads):
         """Run :py:meth:`~.bench_run` with :code:`num_threads` threads.
 
@@ -123,6 +144,7 @@ class Benchmark(object):
         # Save results for later summarization
         self._N = N
         self._t = t / number
+        self._items = self.bench_items(N) if N is not None else None
         if print_stats:
             self.print_stats()
 
@@ -135,8 +157,9 @@ class Benchmark(object):
         printed for the results of the last call to :py:meth:`~.run_benchmark`.
         """
         if self._N is not None:
-            print('{0:8.3f} ms | {1:8.3f} ns per item'.format(
-                self._t/1e-3, self._t/self._N/1e-9))
+            print('{0:8.3f} ms | {1:8.3f} ns per item | {2:10.4g} {3}/s'
+                  .format(self._t/1e-3, self._t/self._N/1e-9,
+                          self._items/self._t, self.item_name))
         else:
             print('{0:8.3f} ms'.format(self._t/1e-3))
 
@@ -181,7 +204,9 @@ class Benchmark(object):
                 :py:meth:`~.bench_run` (Default value = 1).
 
         Returns:
-            list of float: A list of average runtimes following N (in seconds)
+            list of float: A list of average runtimes following N (in seconds).
+            The numbers of items of each N (see :py:meth:`~.bench_items`) are
+            stored in :code:`size_scaling_items`.
         """
         if len(N_list) == 0:
             raise TypeError('N_list must be iterable')
@@ -189,8 +214,10 @@ class Benchmark(object):
         # Compute benchmark size
         size = number * N_list[0]
 
-        # Loop over N and run the benchmarks
+        # Loop over N and run the benchmarks, keeping the number of items of
+        # each N for throughput reports
         results = []
+        self.size_scaling_items = []
         for N in N_list:
             if print_stats:
                 print('{0:10d}'.format(N), end=': ')
@@ -199,6 +226,7 @@ class Benchmark(object):
             current_number = max(int(size // N), 1)
             t = self.run_benchmark(N, current_number, print_stats, repeat)
             results.append(t)
+            self.size_scaling_items.append(self._items)
 
         return results
 
@@ -261,8 +289,9 @@ class Benchmark(object):
 
                 if print_stats:
                     speedup = times[1, j] / times[ncores, j]
-                    print('{0:8.3f} ms {1:9.2f}x'.format(
-                        times[ncores, j]*1000, speedup), end=' | ')
+                    print('{0:8.3f} ms {1:6.2f}x {2:4.0%}'.format(
+                        times[ncores, j]*1000, speedup, speedup/ncores),
+                        end=' | ')
                     sys.stdout.flush()
 
             if print_stats:
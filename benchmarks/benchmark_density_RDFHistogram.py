@@ -0,0 +1,45 @@
+import freud
+import util
+from benchmark import Benchmark
+from benchmarker import run_benchmarks
+
+
+class BenchmarkDensityRDFHistogram(Benchmark):
+    """Compute an RDF from a precomputed NeighborList, which times binning
+    the bonds into the thread-local histograms and reducing them."""
+    item_name = 'bonds'
+
+    def __init__(self, density, r_max, bins, shape):
+        self.density = density
+        self.r_max = r_max
+        self.bins = bins
+        self.shape = shape
+
+    def bench_setup(self, N):
+        self.box, self.points = util.make_random_box_system(
+            N, self.density, self.shape)
+        self.nlist = freud.locality.AABBQuery(self.box, self.points).query(
+            self.points, dict(r_max=self.r_max, exclude_ii=True)
+        ).toNeighborList()
+        self.rdf = freud.density.RDF(self.bins, self.r_max)
+
+    def bench_items(self, N):
+        return len(self.nlist)
+
+    def bench_run(self, N):
+        self.rdf.compute((self.box, self.points), neighbors=self.nlist)
+        self.rdf.rdf
+
+
+def run():
+    Ns = [1000, 10000, 100000]
+    number = 100
+
+    name = 'freud.density.RDF histogram'
+    return [run_benchmarks(name, Ns, number, BenchmarkDensityRDFHistogram,
+                           density=1.0, r_max=2.5, bins=100, shape=shape)
+            for shape in ('cubic', 'triclinic')]
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,35 @@
+import freud
+import util
+from benchmark import Benchmark
+from benchmarker import run_benchmarks
+
+
+class BenchmarkLocalityAABBQueryBuild(Benchmark):
+    """Build an AABBQuery without querying it, which times building the AABB
+    tree."""
+    item_name = 'points'
+
+    def __init__(self, density, shape):
+        self.density = density
+        self.shape = shape
+
+    def bench_setup(self, N):
+        self.box, self.points = util.make_random_box_system(
+            N, self.density, self.shape)
+
+    def bench_run(self, N):
+        freud.locality.AABBQuery(self.box, self.points)
+
+
+def run():
+    Ns = [1000, 10000, 100000]
+    number = 100
+
+    name = 'freud.locality.AABBQuery build'
+    return [run_benchmarks(name, Ns, number, BenchmarkLocalityAABBQueryBuild,
+                           density=1.0, shape=shape)
+            for shape in ('cubic', 'triclinic', 'square')]
+
+
+if __name__ == '__main__':
+    run()
@@ -0,0 +1,36 @@
+import freud
+import util
+from benchmark import Benchmark
+from benchmarker import run_benchmarks
+
+
+class BenchmarkLocalityLinkCellBuild(Benchmark):
+    """Build a LinkCell without querying it, which times binning the points
+    into the cell list."""
+    item_name = 'points'
+
+    def __init__(self, density, cell_width, shape):
+        self.density = density
+        self.cell_width = cell_width
+        self.shape = shape
+
+    def bench_setup(self, N):
+        self.box, self.points = util.make_random_box_system(
+            N, self.density, self.shape)
+
+    def bench_run(self, N):
+        freud.locality.LinkCell(self.box, self.points, self.cell_width)
+
+
+def run():
+    Ns = [1000, 10000, 100000]
+    number = 100
+
+    name = 'freud.locality.LinkCell build'
+    return [run_benchmarks(name, Ns, number, BenchmarkLocalityLinkCellBuild,
+                           density=1.0, cell_width=1.5, shape=shape)
+            for shape in ('cubic', 'triclinic', 'square')]
+
+
+if __name__ == '__main__':
+    run()
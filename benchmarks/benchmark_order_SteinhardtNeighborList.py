@@ -0,0 +1,50 @@
+import freud
+import util
+from benchmark import Benchmark
+from benchmarker import run_benchmarks
+
+
+class BenchmarkOrderSteinhardtNeighborList(Benchmark):
+    """Compute Steinhardt order parameters from a precomputed NeighborList,
+    which times the spherical harmonics of the bonds and their averages."""
+    item_name = 'bonds'
+
+    def __init__(self, density, num_neighbors, sph_l, average, shape):
+        self.density = density
+        self.num_neighbors = num_neighbors
+        self.sph_l = sph_l
+        self.average = average
+        self.shape = shape
+
+    def bench_setup(self, N):
+        self.box, self.points = util.make_random_box_system(
+            N, self.density, self.shape)
+        self.nlist = freud.locality.AABBQuery(self.box, self.points).query(
+            self.points,
+            dict(num_neighbors=self.num_neighbors, exclude_ii=True)
+        ).toNeighborList()
+        self.steinhardt = freud.order.Steinhardt(
+            self.sph_l, average=self.average)
+
+    def bench_items(self, N):
+        return len(self.nlist)
+
+    def bench_run(self, N):
+        self.steinhardt.compute((self.box, self.points),
+                                neighbors=self.nlist)
+
+
+def run():
+    Ns = [1000, 10000, 100000]
+    number = 100
+
+    name = 'freud.order.Steinhardt NeighborList'
+    return [run_benchmarks(name, Ns, number,
+                           BenchmarkOrderSteinhardtNeighborList,
+                           density=1.0, num_neighbors=12, sph_l=6,
+                           average=average, shape=shape)
+            for average in (False, True) for shape in ('cubic', 'triclinic')]
+
+
+if __name__ == '__main__':
+    run()
@@ -4,6 +4,7 @@ import os
 import argparse
 import sys
 import importlib
+import numpy as np
 
 
 def get_report_filename(filename):
@@ -56,13 +57,39 @@ def benchmark_desc(name, params):
     return s
 
 
+def get_Ns(Ns):
+    """Function to get the N values to run benchmarks with.
+
+    The environment variable BENCHMARK_NS overrides the N values of all
+    benchmarks with a comma separated list, for example
+    :code:`BENCHMARK_NS=1e3,1e4,1e5,1e6,1e7,1e8`.
+
+    Args:
+        Ns (list of int): Default N values of the benchmark.
+
+    Returns:
+        list of int: N values to run the benchmark with.
+
+    """
+    override = os.environ.get('BENCHMARK_NS')
+    if override:
+        return [int(float(N)) for N in override.split(',')]
+    return Ns
+
+
 def run_benchmarks(name, Ns, number, classobj, print_stats=True,
                    **kwargs):
     """Function to run benchmark.
 
+    The result contains the runtimes of each N with all threads and with
+    each number of threads, the number of items processed for each N (see
+    :meth:`Benchmark.bench_items`), and the scaling efficiency of each
+    number of threads, its speedup over one thread divided by the number of
+    threads.
+
     Args:
         name (str): Name of the benchmark.
-        Ns (list of int): List of N values to run benchmark.
+        Ns (list of int): List of N values to run benchmark (see get_Ns).
         number (int): Number of times to run to measure the time.
         classobj (Benchmark): Benchmark class to run benchmark.
         print_stats (bool): Print stats if true.
@@ -84,18 +111,28 @@ def run_benchmarks(name, Ns, number, classobj, print_stats=True,
         return {"name": name, "misc": "No result"}
 
     # run benchmark with repeat
+    Ns = get_Ns(Ns)
     repeat = 5
     ssr = b.run_size_scaling_benchmark(Ns, number, print_stats,
                                        repeat)
     tsr = b.run_thread_scaling_benchmark(Ns, number, print_stats,
                                          repeat)
 
+    # speedup over one thread per thread, with zeros for numbers of threads
+    # that were skipped
+    threads = np.arange(len(tsr))[:, np.newaxis]
+    with np.errstate(divide='ignore', invalid='ignore'):
+        efficiency = np.where(tsr > 0, tsr[1] / tsr / threads, 0)
+
     if print_stats:
         print('\n ----------------')
 
     return {"name": name, "params": kwargs, "Ns": Ns,
             "size_scale": {N: r for N, r in zip(Ns, ssr)},
-            "thread_scale": tsr.tolist()}
+            "thread_scale": tsr.tolist(),
+            "item_name": classobj.item_name,
+            "items": {N: i for N, i in zip(Ns, b.size_scaling_items)},
+            "efficiency": efficiency.tolist()}
 
 
 def main_report(args):
@@ -132,13 +169,19 @@ def print_benchmark_results_in_human_readable_way(data):
         bdesc = benchmark_desc(bresult["name"], bresult["params"])
         print(bdesc)
 
-        # print size scaling benchmark
+        # print size scaling benchmark, with the throughput of results that
+        # record their number of items
+        items = bresult.get("items", {})
+        item_name = bresult.get("item_name", "items")
         for N, r in bresult["size_scale"].items():
-            N = int(N)
             r = float(r)
-            print('{0:10d}'.format(N), end=': ')
+            print('{0:10d}'.format(int(N)), end=': ')
             print('{0:8.3f} ms | {1:8.3f} ns per item'.format(
-                float(r)/1e-3, float(r)/int(N)/1e-9))
+                r/1e-3, r/int(N)/1e-9), end='')
+            if items.get(N) is not None:
+                print(' | {0:10.4g} {1}/s'.format(items[N]/r, item_name),
+                      end='')
+            print()
 
         # print thread scaling benchmark
         print('Threads ', end='')
@@ -148,10 +191,13 @@ def print_benchmark_results_in_human_readable_way(data):
         times = bresult["thread_scale"]
         num_threads = len(times) - 1
         for i in range(1, num_threads + 1):
+            if times[i][0] == 0:
+                continue
             print('{0:7d}'.format(i), end=' ')
             for j, N in enumerate(bresult["Ns"]):
                 speedup = times[1][j] / times[i][j]
-                print('{0:9.2f}x'.format(speedup), end=' | ')
+                print('{0:6.2f}x {1:4.0%}'.format(speedup, speedup/i),
+                      end=' | ')
             print()
 
 
@@ -248,9 +294,14 @@ def main_run(args):
         if m:
             try:
                 r = m.run()
-                results.append(r)
             except AttributeError:
                 print("Something is wrong with {}".format(m))
+                continue
+            # modules benchmarking several configurations return a list
+            if isinstance(r, list):
+                results.extend(r)
+            else:
+                results.append(r)
 
     save_benchmark_result(results, args.output)
 
@@ -345,13 +396,17 @@ def main_compare(args):
     save_comparison_result(rt, ro, slowers, fasters, sames)
 
     # exit 1 if too slow
-    threshold = 0.70
+    threshold = 0.70 if args.fail_above is None else 1 / args.fail_above
+    too_slow = False
     for info in slowers:
         if info["ratio"] < threshold:
             desc = benchmark_desc(info["name"], info["params"])
             print("TOO SLOW (beyond threshold of {})".format(threshold))
             print("\t" + desc)
             print("\t\tratio = {}".format(info["ratio"]))
+            too_slow = True
+    if too_slow and args.fail_above is not None:
+        sys.exit(1)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,186 @@
+"""Strong and weak scaling benchmarks of compute classes on structured systems.
+
+Strong scaling runs a system of fixed size with an increasing number of
+threads, and its parallel efficiency with :math:`p` threads is
+:math:`t_1 / (p t_p)`. Weak scaling grows the system with the number of
+threads, with :math:`N` points per thread, and its efficiency is
+:math:`t_1(N) / t_p(pN)`. Efficiencies well below 1 show computes that do not
+scale, for example because of load imbalance on clustered systems or serial
+reductions.
+
+Example::
+
+    python scaling.py --threads 1,2,4,8,16,32,64,128 --N 100000 \\
+        --systems fcc,clustered,slab --output scaling.json
+"""
+from __future__ import print_function
+from __future__ import division
+
+import argparse
+import json
+import timeit
+
+import numpy as np
+
+import freud
+import util
+
+
+def _ball(r_max):
+    return dict(r_max=r_max, exclude_ii=True)
+
+
+def _aabbquery(box, points):
+    aq = freud.locality.AABBQuery(box, points)
+    return aq.query(points, _ball(1.5)).toNeighborList()
+
+
+def _linkcell(box, points):
+    lc = freud.locality.LinkCell(box, points, 1.5)
+    return lc.query(points, _ball(1.5)).toNeighborList()
+
+
+def _rdf(box, points):
+    return freud.density.RDF(100, 2.5).compute(
+        (box, points), neighbors=_ball(2.5)).rdf
+
+
+def _local_density(box, points):
+    return freud.density.LocalDensity(1.5, 1).compute((box, points)).density
+
+
+def _steinhardt(box, points):
+    return freud.order.Steinhardt(6, average=True).compute(
+        (box, points), neighbors=dict(num_neighbors=12)).particle_order
+
+
+def _cluster(box, points):
+    return freud.cluster.Cluster().compute(
+        (box, points), neighbors=_ball(1.0)).cluster_idx
+
+
+def _gaussian_density(box, points):
+    return freud.density.GaussianDensity(64, 2.0, 0.5).compute(
+        (box, points)).density
+
+
+#: Compute classes benchmarked, as functions running the compute once on a
+#: box and points.
+COMPUTES = {
+    'AABBQuery': _aabbquery,
+    'LinkCell': _linkcell,
+    'RDF': _rdf,
+    'LocalDensity': _local_density,
+    'Steinhardt': _steinhardt,
+    'Cluster': _cluster,
+    'GaussianDensity': _gaussian_density,
+}
+
+SYSTEMS = ('fcc', 'bcc', 'clustered', 'slab', 'polydisperse')
+
+
+def time_compute(run, repeat):
+    """Median time of a function in seconds, after a warmup run."""
+    run()
+    return float(np.median(timeit.repeat(run, number=1, repeat=repeat)))
+
+
+def scaling_benchmark(compute, system, N, threads, weak, repeat):
+    """Time a compute on a system for each number of threads.
+
+    Args:
+        compute (str): Key of the compute in COMPUTES.
+        system (str): Kind of system (see util.make_structured_system).
+        N (int): Number of points, or number of points per thread if weak.
+        threads (list of int): Numbers of threads, starting with 1.
+        weak (bool): Whether to run a weak scaling benchmark.
+        repeat (int): Number of times to repeat each measurement.
+
+    Returns:
+        dict: The sizes, times, and parallel efficiencies of each number of
+        threads.
+    """
+    sizes, times = [], []
+    if not weak:
+        box, points = util.make_structured_system(system, N)
+    for num_threads in threads:
+        if weak:
+            box, points = util.make_structured_system(system, N * num_threads)
+        with freud.parallel.NumThreads(num_threads):
+            times.append(time_compute(
+                lambda: COMPUTES[compute](box, points), repeat))
+        sizes.append(len(points))
+
+    times = np.array(times)
+    if weak:
+        efficiency = times[0] / times
+    else:
+        efficiency = times[0] / (times * np.asarray(threads))
+    return {"compute": compute, "system": system, "weak": weak,
+            "threads": list(threads), "Ns": sizes, "times": times.tolist(),
+            "efficiency": efficiency.tolist()}
+
+
+def print_result(result):
+    """Print the efficiency of each number of threads of a result."""
+    print('{:16s} {:13s} {:6s}'.format(
+        result["compute"], result["system"],
+        'weak' if result["weak"] else 'strong'), end='')
+    for t, e in zip(result["times"], result["efficiency"]):
+        print(' {:8.2f} ms {:4.0%}'.format(t*1e3, e), end=' |')
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Measure the strong and weak scaling of compute classes "
+                    "on structured systems.")
+    parser.add_argument(
+        '--threads', default='1,2,4',
+        help="Comma separated numbers of threads, default='1,2,4'. A single "
+             "thread is always run first as the reference.")
+    parser.add_argument(
+        '--N', type=float, default=1e5,
+        help="Number of points of strong scaling runs and number of points "
+             "per thread of weak scaling runs, default=1e5.")
+    parser.add_argument(
+        '--systems', default=','.join(SYSTEMS),
+        help="Comma separated kinds of systems, default='{}'.".format(
+            ','.join(SYSTEMS)))
+    parser.add_argument(
+        '--computes', default=','.join(sorted(COMPUTES)),
+        help="Comma separated compute classes, default=all.")
+    parser.add_argument(
+        '--weak', action='store_true',
+        help="Also run weak scaling benchmarks.")
+    parser.add_argument(
+        '--repeat', type=int, default=3,
+        help="Number of times to repeat each measurement, default=3.")
+    parser.add_argument(
+        '-o', '--output', default=None,
+        help="JSON file to store the results in.")
+    args = parser.parse_args()
+
+    threads = [int(t) for t in args.threads.split(',')]
+    if threads[0] != 1:
+        threads.insert(0, 1)
+    modes = (False, True) if args.weak else (False,)
+
+    print('{:16s} {:13s} {:6s} time and efficiency for threads {}'.format(
+        'compute', 'system', 'mode', threads))
+    results = []
+    for compute in args.computes.split(','):
+        for system in args.systems.split(','):
+            for weak in modes:
+                result = scaling_benchmark(compute, system, int(args.N),
+                                           threads, weak, args.repeat)
+                print_result(result)
+                results.append(result)
+
+    if args.output is not None:
+        with open(args.output, 'w') as outfile:
+            json.dump(results, outfile, indent=4)
+
+
+if __name__ == '__main__':
+    main()
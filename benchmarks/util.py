@@ -38,3 +38,118 @@ def make_fcc(nx=1, ny=1, nz=1, scale=1.0, noise=0.0):
         positions += np.random.normal(scale=noise, size=positions.shape)
 
     return freud.box.Box(*box), positions
+
+
+def make_random_box_system(N, density, shape='cubic', seed=0):
+    """Make uniformly random points at a given density for kernel benchmarks
+
+    The box is scaled with N so that every N has the same density, which
+    keeps the number of neighbors per point constant.
+
+    :param N: Number of points
+    :param density: Number of points per unit volume (area in 2D)
+    :param shape: One of 'cubic', 'triclinic', or 'square' (2D)
+    :param seed: Random seed
+    :type N: int
+    :type density: float
+    :type shape: str
+    :type seed: int
+    :return: freud Box, particle positions, shape=(N, 3)
+    :rtype: (:class:`freud.box.Box`, :class:`np.ndarray`)
+    """
+    if shape == 'square':
+        box = freud.box.Box.square(np.sqrt(N / density))
+    else:
+        L = np.cbrt(N / density)
+        tilts = (0.5, 0.3, 0.2) if shape == 'triclinic' else (0, 0, 0)
+        box = freud.box.Box(L, L, L, *tilts)
+    np.random.seed(seed)
+    fractions = np.random.random_sample((N, 3))
+    if box.is2D:
+        fractions[:, 2] = 0
+    return box, box.make_absolute(fractions).astype(np.float32)
+
+
+def _lattice_system(basis, N, density, noise, seed):
+    """Make a cubic lattice of a basis with about N points at a density"""
+    n = max(int(np.round(np.cbrt(N / len(basis)))), 1)
+    L = np.cbrt(n**3 * len(basis) / density)
+    cells = np.stack(np.meshgrid(*[np.arange(n)] * 3, indexing='ij'),
+                     axis=-1).reshape(-1, 1, 3)
+    fractions = ((cells + np.asarray(basis)) / n).reshape(-1, 3)
+    box = freud.box.Box.cube(L)
+    points = box.make_absolute(fractions)
+    if noise != 0:
+        np.random.seed(seed)
+        points += np.random.normal(scale=noise * L / n, size=points.shape)
+    return box, box.wrap(points).astype(np.float32)
+
+
+def make_structured_system(kind, N, density=1.0, seed=0):
+    """Make a structured system of about N points for scaling benchmarks
+
+    Unlike uniformly random points, these systems have the load imbalance
+    and memory access patterns of real systems:
+
+    * 'fcc' and 'bcc': Lattices with Gaussian noise of 5% of the lattice
+      constant. The number of points is rounded to a whole lattice.
+    * 'clustered': Gaussian blobs of about 100 points in a dilute
+      background, a tenth of the points.
+    * 'slab': A dense slab filling a third of the box along z with a vapor
+      at a tenth of its density, like a liquid-vapor interface.
+    * 'polydisperse': A phase separated mixture of particles of diameters
+      0.5, 1, and 2, each filling a third of the box along x at a number
+      density proportional to the inverse cube of its diameter, so the
+      number of neighbors of a point varies by a factor of 64.
+
+    :param kind: The kind of system
+    :param N: Number of points
+    :param density: Average number of points per unit volume
+    :param seed: Random seed
+    :type kind: str
+    :type N: int
+    :type density: float
+    :type seed: int
+    :return: freud Box, particle positions, shape=(N, 3)
+    :rtype: (:class:`freud.box.Box`, :class:`np.ndarray`)
+    """
+    if kind == 'fcc':
+        return _lattice_system([[0, 0, 0], [.5, .5, 0], [.5, 0, .5],
+                                [0, .5, .5]], N, density, 0.05, seed)
+    if kind == 'bcc':
+        return _lattice_system([[0, 0, 0], [.5, .5, .5]], N, density,
+                               0.05, seed)
+
+    np.random.seed(seed)
+    L = np.cbrt(N / density)
+    box = freud.box.Box.cube(L)
+    if kind == 'clustered':
+        num_background = N // 10
+        num_clusters = max((N - num_background) // 100, 1)
+        centers = np.random.uniform(-L/2, L/2, (num_clusters, 3))
+        members = np.random.randint(num_clusters, size=N - num_background)
+        points = np.concatenate([
+            centers[members] + np.random.normal(
+                size=(N - num_background, 3)),
+            np.random.uniform(-L/2, L/2, (num_background, 3))])
+    elif kind == 'slab':
+        # Slab of thickness L/3 with density ratio 10 to the vapor.
+        num_slab = int(N * 10 / 12)
+        slab = np.random.uniform(-L/2, L/2, (num_slab, 3))
+        slab[:, 2] /= 3
+        vapor = np.random.uniform(-L/2, L/2, (N - num_slab, 3))
+        vapor[:, 2] = vapor[:, 2] * 2 / 3
+        vapor[:, 2] += np.sign(vapor[:, 2]) * L / 6
+        points = np.concatenate([slab, vapor])
+    elif kind == 'polydisperse':
+        # Each size fills a third of the box along x at a number density
+        # proportional to the inverse cube of its diameter.
+        weights = 1 / np.array([0.5, 1.0, 2.0])**3
+        counts = np.round(N * weights / weights.sum()).astype(int)
+        counts[-1] = N - counts[:-1].sum()
+        points = np.random.uniform(-L/2, L/2, (N, 3))
+        points[:, 0] = (points[:, 0] + L/2) / 3 - L/2 + np.repeat(
+            np.arange(3), counts) * L / 3
+    else:
+        raise ValueError("Unknown kind of system {}.".format(kind))
+    return box, box.wrap(points).astype(np.float32)
@@ -6,6 +6,9 @@
 
 #include "utils.h"
 #include <complex>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <sstream>
 #include <stdexcept>
 
@@ -32,6 +35,11 @@ namespace freud { namespace box {
      - wrap()
      - unwrap()
 
+    The versions of these functions operating on arrays are parallelized, and process four vectors at a
+ time with SSE2 instructions when available. They are specialized for orthorhombic and triclinic boxes and
+ for 2D and 3D boxes, so no tilt factor math is done for orthorhombic boxes. Their results are identical to
+ those of the functions operating on single vectors.
+
     A Box can represent either a two or three dimensional box. By default, a Box is 3D, but can be set as 2D
  with the method set2D(), or via an optional boolean argument to the constructor. is2D() queries if a Box is
  2D or not. 2D boxes have a "volume" of Lx * Ly, and Lz is set to 0. To keep programming simple, all inputs
@@ -229,12 +237,7 @@ public:
      */
     void makeAbsolute(vec3<float>* vecs, unsigned int Nvecs) const
     {
-        util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
-            for (size_t i = begin; i < end; ++i)
-            {
-                vecs[i] = makeAbsolute(vecs[i]);
-            }
-        });
+        applyArrayKernel<MakeAbsoluteKernel>(Nvecs, vecs);
     }
 
     //! Compute the position of the particle in box relative coordinates
@@ -261,14 +264,13 @@ public:
         return delta;
     }
 
+    //! Convert absolute coordinates into fractional coordinates in place
+    /*! \param vecs Vectors of absolute coordinates
+     *  \param Nvecs Number of vectors
+     */
     void makeFractional(vec3<float>* vecs, unsigned int Nvecs) const
     {
-        util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
-            for (size_t i = begin; i < end; ++i)
-            {
-                vecs[i] = makeFractional(vecs[i]);
-            }
-        });
+        applyArrayKernel<MakeFractionalKernel>(Nvecs, vecs);
     }
 
     //! Get the periodic image vectors belongs to
@@ -278,19 +280,28 @@ public:
      */
     void getImage(vec3<float>* vecs, unsigned int Nvecs, vec3<int>* res) const
     {
-        util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
-            for (size_t i = begin; i < end; ++i)
-            {
-                vec3<float> f = makeFractional(vecs[i]) - vec3<float>(0.5, 0.5, 0.5);
-                res[i].x = (int) ((f.x >= 0.0f) ? f.x + 0.5f : f.x - 0.5f);
-                res[i].y = (int) ((f.y >= 0.0f) ? f.y + 0.5f : f.y - 0.5f);
-                res[i].z = (int) ((f.z >= 0.0f) ? f.z + 0.5f : f.z - 0.5f);
-            }
-        });
+        applyArrayKernel<GetImageKernel>(Nvecs, vecs, res);
+    }
+
+    //! Get the periodic image a vector belongs to
+    /*! \param v The vector to check
+     *  \returns The image of the vector
+     */
+    vec3<int> getImage(const vec3<float>& v) const
+    {
+        const vec3<float> f = makeFractional(v) - vec3<float>(0.5, 0.5, 0.5);
+        return vec3<int>((int) ((f.x >= 0.0f) ? f.x + 0.5f : f.x - 0.5f),
+                         (int) ((f.y >= 0.0f) ? f.y + 0.5f : f.y - 0.5f),
+                         (int) ((f.z >= 0.0f) ? f.z + 0.5f : f.z - 0.5f));
     }
 
     //! Wrap a vector back into the box
-    /*! \param v Vector to wrap, updated to the minimum image obeying the periodic settings
+    /*! The vector is shifted by the box vectors of its image rather than
+     *  converted to fractional coordinates and back, so that vectors inside
+     *  the box are unchanged and the wrapped vectors of large boxes are only
+     *  rounded once.
+     *
+     *  \param v Vector to wrap, updated to the minimum image obeying the periodic settings
      *  \returns Wrapped vector
      */
     vec3<float> wrap(const vec3<float>& v) const
@@ -301,20 +312,18 @@ public:
             return v;
         }
 
-        vec3<float> v_frac = makeFractional(v);
-        if (m_periodic.x)
-        {
-            v_frac.x = util::modulusPositive(v_frac.x, 1.0f);
-        }
-        if (m_periodic.y)
-        {
-            v_frac.y = util::modulusPositive(v_frac.y, 1.0f);
-        }
-        if (m_periodic.z)
+        const vec3<float> v_frac = makeFractional(v);
+        const vec3<float> image(m_periodic.x ? std::floor(v_frac.x) : 0.0f,
+                                m_periodic.y ? std::floor(v_frac.y) : 0.0f,
+                                m_periodic.z ? std::floor(v_frac.z) : 0.0f);
+        // The shifts are summed in the same order as in WrapKernel.
+        vec3<float> wrapped(v.x - (image.x * m_L.x + (image.y * (m_xy * m_L.y) + image.z * (m_xz * m_L.z))),
+                            v.y - (image.y * m_L.y + image.z * (m_yz * m_L.z)), v.z - image.z * m_L.z);
+        if (m_2d)
         {
-            v_frac.z = util::modulusPositive(v_frac.z, 1.0f);
+            wrapped.z = 0.0f;
         }
-        return makeAbsolute(v_frac);
+        return wrapped;
     }
 
     //! Wrap vectors back into the box in place
@@ -323,12 +332,12 @@ public:
      */
     void wrap(vec3<float>* vecs, unsigned int Nvecs) const
     {
-        util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
-            for (size_t i = begin; i < end; ++i)
-            {
-                vecs[i] = wrap(vecs[i]);
-            }
-        });
+        // Return quickly if the box is aperiodic
+        if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+        {
+            return;
+        }
+        applyArrayKernel<WrapKernel>(Nvecs, vecs);
     }
 
     //! Unwrap given positions to their absolute location in place
@@ -338,17 +347,24 @@ public:
     */
     void unwrap(vec3<float>* vecs, const vec3<int>* images, unsigned int Nvecs) const
     {
-        util::forLoopWrapper(0, Nvecs, [=](size_t begin, size_t end) {
-            for (size_t i = begin; i < end; ++i)
-            {
-                vecs[i] += getLatticeVector(0) * float(images[i].x);
-                vecs[i] += getLatticeVector(1) * float(images[i].y);
-                if (!m_2d)
-                {
-                    vecs[i] += getLatticeVector(2) * float(images[i].z);
-                }
-            }
-        });
+        applyArrayKernel<UnwrapKernel>(Nvecs, vecs, images);
+    }
+
+    //! Unwrap a position to its absolute location
+    /*! \param v Coordinates to unwrap
+     *  \param image Image flags of the point
+     *  \returns The unwrapped position
+     */
+    vec3<float> unwrap(const vec3<float>& v, const vec3<int>& image) const
+    {
+        vec3<float> u = v;
+        u += getLatticeVector(0) * float(image.x);
+        u += getLatticeVector(1) * float(image.y);
+        if (!m_2d)
+        {
+            u += getLatticeVector(2) * float(image.z);
+        }
+        return u;
     }
 
     //! Compute center of mass for vectors
@@ -566,6 +582,292 @@ public:
     }
 
 private:
+    //! Run a kernel over arrays of vectors, specialized for the shape of this box.
+    /*! \tparam Kernel Class template parameterized by whether the box is
+     *          triclinic and whether it is 2D. It is constructed from a
+     *          reference to this box and \a args, and has a method single(i)
+     *          processing the vectors at index i and, if SSE2 is available,
+     *          a method block(i) processing the four vectors at index i.
+     *  \param N Number of vectors.
+     *  \param args Pointers to the arrays of vectors.
+     */
+    template<template<bool, bool> class Kernel, typename... Args>
+    void applyArrayKernel(unsigned int N, Args... args) const
+    {
+        const bool triclinic = (m_xy != 0 || m_xz != 0 || m_yz != 0);
+        if (triclinic)
+        {
+            if (m_2d)
+                runArrayKernel(Kernel<true, true> {*this, args...}, N);
+            else
+                runArrayKernel(Kernel<true, false> {*this, args...}, N);
+        }
+        else
+        {
+            if (m_2d)
+                runArrayKernel(Kernel<false, true> {*this, args...}, N);
+            else
+                runArrayKernel(Kernel<false, false> {*this, args...}, N);
+        }
+    }
+
+    //! Run a kernel over N vectors in parallel, four at a time when possible.
+    template<typename Kernel> static void runArrayKernel(const Kernel& kernel, unsigned int N)
+    {
+        util::forLoopWrapper(0, N, [&](size_t begin, size_t end) {
+            size_t i = begin;
+#ifdef __SSE2__
+            for (; i + 4 <= end; i += 4)
+            {
+                kernel.block(i);
+            }
+#endif
+            for (; i < end; ++i)
+            {
+                kernel.single(i);
+            }
+        });
+    }
+
+#ifdef __SSE2__
+    //! Four vectors in structure-of-arrays layout.
+    struct Vec3x4
+    {
+        __m128 x; //!< x components.
+        __m128 y; //!< y components.
+        __m128 z; //!< z components.
+    };
+
+    //! Load four consecutive vectors of three 32-bit components into structure-of-arrays layout.
+    static Vec3x4 loadVec3x4(const void* ptr)
+    {
+        // The inputs are a = (x0, y0, z0, x1), b = (y1, z1, x2, y2), c = (z2, x3, y3, z3).
+        const float* p = static_cast<const float*>(ptr);
+        const __m128 a = _mm_loadu_ps(p);
+        const __m128 b = _mm_loadu_ps(p + 4);
+        const __m128 c = _mm_loadu_ps(p + 8);
+        Vec3x4 v;
+        v.x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 1, 0, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        v.y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 1)),
+                             _mm_shuffle_ps(b, c, _MM_SHUFFLE(0, 2, 0, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        v.z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 1, 0, 2)),
+                             _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        return v;
+    }
+
+    //! Store four vectors in structure-of-arrays layout as consecutive vectors of three components.
+    static void storeVec3x4(void* ptr, const Vec3x4& v)
+    {
+        // The outputs are a = (x0, y0, z0, x1), b = (y1, z1, x2, y2), c = (z2, x3, y3, z3).
+        float* p = static_cast<float*>(ptr);
+        const __m128 x0y0 = _mm_shuffle_ps(v.x, v.y, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 z0x1 = _mm_shuffle_ps(v.z, v.x, _MM_SHUFFLE(0, 1, 0, 0));
+        const __m128 y1z1 = _mm_shuffle_ps(v.y, v.z, _MM_SHUFFLE(0, 1, 0, 1));
+        const __m128 x2y2 = _mm_shuffle_ps(v.x, v.y, _MM_SHUFFLE(0, 2, 0, 2));
+        const __m128 z2x3 = _mm_shuffle_ps(v.z, v.x, _MM_SHUFFLE(0, 3, 0, 2));
+        const __m128 y3z3 = _mm_shuffle_ps(v.y, v.z, _MM_SHUFFLE(0, 3, 0, 3));
+        _mm_storeu_ps(p, _mm_shuffle_ps(x0y0, z0x1, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(p + 4, _mm_shuffle_ps(y1z1, x2y2, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(p + 8, _mm_shuffle_ps(z2x3, y3z3, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+
+    //! Round four floats toward zero.
+    static __m128 truncate4(__m128 f)
+    {
+        // Floats of magnitude 2^23 or more are integers, which may not fit in an int.
+        const __m128 abs_f = _mm_andnot_ps(_mm_set1_ps(-0.0f), f);
+        const __m128 small = _mm_cmplt_ps(abs_f, _mm_set1_ps(8388608.0f));
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(f));
+        return _mm_or_ps(_mm_and_ps(small, truncated), _mm_andnot_ps(small, f));
+    }
+
+    //! Round four floats down.
+    static __m128 floor4(__m128 f)
+    {
+        const __m128 truncated = truncate4(f);
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmplt_ps(f, truncated), _mm_set1_ps(1.0f)));
+    }
+
+    //! Same as makeFractional() for four vectors.
+    template<bool triclinic, bool is_2d> Vec3x4 makeFractional4(const Vec3x4& v) const
+    {
+        __m128 dx = _mm_sub_ps(v.x, _mm_set1_ps(m_lo.x));
+        __m128 dy = _mm_sub_ps(v.y, _mm_set1_ps(m_lo.y));
+        if (triclinic)
+        {
+            dx = _mm_sub_ps(dx, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m_xz - m_yz * m_xy), v.z),
+                                           _mm_mul_ps(_mm_set1_ps(m_xy), v.y)));
+            dy = _mm_sub_ps(dy, _mm_mul_ps(_mm_set1_ps(m_yz), v.z));
+        }
+        Vec3x4 f;
+        f.x = _mm_div_ps(dx, _mm_set1_ps(m_L.x));
+        f.y = _mm_div_ps(dy, _mm_set1_ps(m_L.y));
+        f.z = is_2d ? _mm_setzero_ps() : _mm_div_ps(_mm_sub_ps(v.z, _mm_set1_ps(m_lo.z)), _mm_set1_ps(m_L.z));
+        return f;
+    }
+
+    //! Same as makeAbsolute() for four vectors.
+    template<bool triclinic, bool is_2d> Vec3x4 makeAbsolute4(const Vec3x4& f) const
+    {
+        Vec3x4 v;
+        v.x = _mm_add_ps(_mm_set1_ps(m_lo.x), _mm_mul_ps(f.x, _mm_set1_ps(m_L.x)));
+        v.y = _mm_add_ps(_mm_set1_ps(m_lo.y), _mm_mul_ps(f.y, _mm_set1_ps(m_L.y)));
+        v.z = is_2d ? _mm_setzero_ps() : _mm_add_ps(_mm_set1_ps(m_lo.z), _mm_mul_ps(f.z, _mm_set1_ps(m_L.z)));
+        if (triclinic)
+        {
+            v.x = _mm_add_ps(v.x, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(m_xy), v.y),
+                                             _mm_mul_ps(_mm_set1_ps(m_xz), v.z)));
+            v.y = _mm_add_ps(v.y, _mm_mul_ps(_mm_set1_ps(m_yz), v.z));
+        }
+        return v;
+    }
+#endif
+
+    //! Array kernel of makeFractional().
+    template<bool triclinic, bool is_2d> struct MakeFractionalKernel
+    {
+        const Box& box;    //!< The box.
+        vec3<float>* vecs; //!< Vectors converted in place.
+
+#ifdef __SSE2__
+        void block(size_t i) const
+        {
+            storeVec3x4(&vecs[i], box.makeFractional4<triclinic, is_2d>(loadVec3x4(&vecs[i])));
+        }
+#endif
+        void single(size_t i) const
+        {
+            vecs[i] = box.makeFractional(vecs[i]);
+        }
+    };
+
+    //! Array kernel of makeAbsolute().
+    template<bool triclinic, bool is_2d> struct MakeAbsoluteKernel
+    {
+        const Box& box;    //!< The box.
+        vec3<float>* vecs; //!< Vectors converted in place.
+
+#ifdef __SSE2__
+        void block(size_t i) const
+        {
+            storeVec3x4(&vecs[i], box.makeAbsolute4<triclinic, is_2d>(loadVec3x4(&vecs[i])));
+        }
+#endif
+        void single(size_t i) const
+        {
+            vecs[i] = box.makeAbsolute(vecs[i]);
+        }
+    };
+
+    //! Array kernel of wrap().
+    template<bool triclinic, bool is_2d> struct WrapKernel
+    {
+        const Box& box;    //!< The box.
+        vec3<float>* vecs; //!< Vectors wrapped in place.
+
+#ifdef __SSE2__
+        void block(size_t i) const
+        {
+            Vec3x4 v = loadVec3x4(&vecs[i]);
+            const Vec3x4 f = box.makeFractional4<triclinic, is_2d>(v);
+            const __m128 image_x = box.m_periodic.x ? floor4(f.x) : _mm_setzero_ps();
+            const __m128 image_y = box.m_periodic.y ? floor4(f.y) : _mm_setzero_ps();
+            const __m128 image_z = (!is_2d && box.m_periodic.z) ? floor4(f.z) : _mm_setzero_ps();
+            __m128 shift_x = _mm_mul_ps(image_x, _mm_set1_ps(box.m_L.x));
+            __m128 shift_y = _mm_mul_ps(image_y, _mm_set1_ps(box.m_L.y));
+            if (triclinic)
+            {
+                const __m128 tilt_x = _mm_add_ps(_mm_mul_ps(image_y, _mm_set1_ps(box.m_xy * box.m_L.y)),
+                                                 _mm_mul_ps(image_z, _mm_set1_ps(box.m_xz * box.m_L.z)));
+                shift_x = _mm_add_ps(shift_x, tilt_x);
+                shift_y = _mm_add_ps(shift_y, _mm_mul_ps(image_z, _mm_set1_ps(box.m_yz * box.m_L.z)));
+            }
+            v.x = _mm_sub_ps(v.x, shift_x);
+            v.y = _mm_sub_ps(v.y, shift_y);
+            v.z = is_2d ? _mm_setzero_ps() : _mm_sub_ps(v.z, _mm_mul_ps(image_z, _mm_set1_ps(box.m_L.z)));
+            storeVec3x4(&vecs[i], v);
+        }
+#endif
+        void single(size_t i) const
+        {
+            vecs[i] = box.wrap(vecs[i]);
+        }
+    };
+
+    //! Array kernel of unwrap().
+    template<bool triclinic, bool is_2d> struct UnwrapKernel
+    {
+        const Box& box;           //!< The box.
+        vec3<float>* vecs;        //!< Vectors unwrapped in place.
+        const vec3<int>* images; //!< Image flags of the vectors.
+
+#ifdef __SSE2__
+        void block(size_t i) const
+        {
+            Vec3x4 v = loadVec3x4(&vecs[i]);
+            const Vec3x4 image_bits = loadVec3x4(&images[i]);
+            const __m128 image_x = _mm_cvtepi32_ps(_mm_castps_si128(image_bits.x));
+            const __m128 image_y = _mm_cvtepi32_ps(_mm_castps_si128(image_bits.y));
+            const __m128 image_z = _mm_cvtepi32_ps(_mm_castps_si128(image_bits.z));
+            v.x = _mm_add_ps(v.x, _mm_mul_ps(_mm_set1_ps(box.m_L.x), image_x));
+            if (triclinic)
+            {
+                v.x = _mm_add_ps(v.x, _mm_mul_ps(_mm_set1_ps(box.m_L.y * box.m_xy), image_y));
+            }
+            v.y = _mm_add_ps(v.y, _mm_mul_ps(_mm_set1_ps(box.m_L.y), image_y));
+            if (!is_2d)
+            {
+                if (triclinic)
+                {
+                    v.x = _mm_add_ps(v.x, _mm_mul_ps(_mm_set1_ps(box.m_L.z * box.m_xz), image_z));
+                    v.y = _mm_add_ps(v.y, _mm_mul_ps(_mm_set1_ps(box.m_L.z * box.m_yz), image_z));
+                }
+                v.z = _mm_add_ps(v.z, _mm_mul_ps(_mm_set1_ps(box.m_L.z), image_z));
+            }
+            storeVec3x4(&vecs[i], v);
+        }
+#endif
+        void single(size_t i) const
+        {
+            vecs[i] = box.unwrap(vecs[i], images[i]);
+        }
+    };
+
+    //! Array kernel of getImage().
+    template<bool triclinic, bool is_2d> struct GetImageKernel
+    {
+        const Box& box;          //!< The box.
+        const vec3<float>* vecs; //!< Vectors to check.
+        vec3<int>* images;       //!< Output image flags.
+
+#ifdef __SSE2__
+        void block(size_t i) const
+        {
+            const Vec3x4 f = box.makeFractional4<triclinic, is_2d>(loadVec3x4(&vecs[i]));
+            Vec3x4 image_bits;
+            image_bits.x = roundImage4(f.x);
+            image_bits.y = roundImage4(f.y);
+            image_bits.z = roundImage4(f.z);
+            storeVec3x4(&images[i], image_bits);
+        }
+
+        //! Compute the image flags of four fractional coordinates, as the bits of ints.
+        static __m128 roundImage4(__m128 f)
+        {
+            const __m128 half = _mm_set1_ps(0.5f);
+            const __m128 centered = _mm_sub_ps(f, half);
+            const __m128 positive = _mm_cmpge_ps(centered, _mm_setzero_ps());
+            const __m128 rounded = _mm_or_ps(_mm_and_ps(positive, _mm_add_ps(centered, half)),
+                                             _mm_andnot_ps(positive, _mm_sub_ps(centered, half)));
+            return _mm_castsi128_ps(_mm_cvttps_epi32(rounded));
+        }
+#endif
+        void single(size_t i) const
+        {
+            images[i] = box.getImage(vecs[i]);
+        }
+    };
+
     vec3<float> m_lo;      //!< Minimum coords in the box
     vec3<float> m_hi;      //!< Maximum coords in the box
     vec3<float> m_L;       //!< L precomputed (used to avoid subtractions in boundary conditions)
@@ -0,0 +1,146 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BOX_TRAITS_H
+#define BOX_TRAITS_H
+
+#include "Box.h"
+#include "VectorMath.h"
+#include "utils.h"
+
+/*! \file BoxTraits.h
+    \brief Box coordinate routines specialized at compile time for the shape of a box.
+*/
+
+namespace freud { namespace box {
+
+//! Copy of the geometry of a Box whose dimension and tilt are known at compile time
+/*! Box::wrap() checks whether the box is 2D and applies all tilt factors for
+ *  every vector. Loops wrapping a vector for every bond or grid cell can
+ *  instead be written as templates over a BoxTraits, which has the same
+ *  coordinate routines with these branches resolved at compile time, and be
+ *  instantiated once per box shape with dispatchBoxTraits(). Orthorhombic
+ *  traits skip all tilt factor math and 2D traits skip the z axis. The
+ *  results are identical to those of the Box routines.
+ *
+ *  \tparam Dim Number of dimensions of the box, 2 or 3.
+ *  \tparam Triclinic Whether the box has any nonzero tilt factor.
+ */
+template<unsigned int Dim, bool Triclinic> class BoxTraits
+{
+public:
+    static_assert(Dim == 2 || Dim == 3, "BoxTraits only supports 2D and 3D boxes.");
+
+    //! Constructor
+    /*! \param box The box to copy. Its tilt factors are ignored unless
+     *         Triclinic is true.
+     */
+    explicit BoxTraits(const Box& box)
+        : m_L(box.getL()), m_lo(-(box.getL() / 2.0f)), m_xy(box.getTiltFactorXY()),
+          m_xz(box.getTiltFactorXZ()), m_yz(box.getTiltFactorYZ()), m_periodic(box.getPeriodic())
+    {}
+
+    //! Same as Box::makeFractional().
+    vec3<float> makeFractional(const vec3<float>& v) const
+    {
+        vec3<float> f(v.x - m_lo.x, v.y - m_lo.y, 0);
+        if (Triclinic)
+        {
+            f.x -= (m_xz - m_yz * m_xy) * v.z + m_xy * v.y;
+            f.y -= m_yz * v.z;
+        }
+        f.x /= m_L.x;
+        f.y /= m_L.y;
+        if (Dim == 3)
+        {
+            f.z = (v.z - m_lo.z) / m_L.z;
+        }
+        return f;
+    }
+
+    //! Same as Box::makeAbsolute().
+    vec3<float> makeAbsolute(const vec3<float>& f) const
+    {
+        vec3<float> v(m_lo.x + f.x * m_L.x, m_lo.y + f.y * m_L.y, 0);
+        if (Dim == 3)
+        {
+            v.z = m_lo.z + f.z * m_L.z;
+        }
+        if (Triclinic)
+        {
+            v.x += m_xy * v.y + m_xz * v.z;
+            v.y += m_yz * v.z;
+        }
+        return v;
+    }
+
+    //! Same as Box::wrap().
+    vec3<float> wrap(const vec3<float>& v) const
+    {
+        // Return quickly if the box is aperiodic
+        if (!m_periodic.x && !m_periodic.y && !m_periodic.z)
+        {
+            return v;
+        }
+
+        const vec3<float> f = makeFractional(v);
+        const float image_x = m_periodic.x ? std::floor(f.x) : 0.0f;
+        const float image_y = m_periodic.y ? std::floor(f.y) : 0.0f;
+        const float image_z = (Dim == 3 && m_periodic.z) ? std::floor(f.z) : 0.0f;
+        float shift_x = image_x * m_L.x;
+        float shift_y = image_y * m_L.y;
+        if (Triclinic)
+        {
+            shift_x += image_y * (m_xy * m_L.y) + image_z * (m_xz * m_L.z);
+            shift_y += image_z * (m_yz * m_L.z);
+        }
+        return vec3<float>(v.x - shift_x, v.y - shift_y, (Dim == 3) ? v.z - image_z * m_L.z : 0);
+    }
+
+private:
+    vec3<float> m_L;       //!< Box lengths.
+    vec3<float> m_lo;      //!< Minimum coordinates in the box.
+    float m_xy;            //!< xy tilt factor.
+    float m_xz;            //!< xz tilt factor.
+    float m_yz;            //!< yz tilt factor.
+    vec3<bool> m_periodic; //!< Whether the box is periodic in each dimension.
+};
+
+//! Call a function with the BoxTraits matching the dimension and tilt of a box.
+/*! This is meant to be called once per compute, so that the loops in the
+ *  function are compiled separately for each box shape.
+ *
+ *  \param box The box.
+ *  \param function An object with a template operator() taking a BoxTraits.
+ */
+template<typename Function> void dispatchBoxTraits(const Box& box, const Function& function)
+{
+    const bool triclinic = box.getTiltFactorXY() != 0 || box.getTiltFactorXZ() != 0
+        || box.getTiltFactorYZ() != 0;
+    if (box.is2D())
+    {
+        if (triclinic)
+        {
+            function(BoxTraits<2, true>(box));
+        }
+        else
+        {
+            function(BoxTraits<2, false>(box));
+        }
+    }
+    else
+    {
+        if (triclinic)
+        {
+            function(BoxTraits<3, true>(box));
+        }
+        else
+        {
+            function(BoxTraits<3, false>(box));
+        }
+    }
+}
+
+}; }; // end namespace freud::box
+
+#endif // BOX_TRAITS_H
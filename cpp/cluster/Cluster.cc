@@ -2,121 +2,239 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <numeric>
+#include <tbb/parallel_sort.h>
 
 #include "Cluster.h"
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
-#include "dset/dset.h"
 
 //! Finds clusters using a network of neighbors.
 namespace freud { namespace cluster {
 
-void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
-                      freud::locality::QueryArgs qargs, const unsigned int* keys)
+namespace {
+
+//! Number of fixed blocks used by the parallel prefix sum.
+const size_t SCAN_BLOCKS = 256;
+
+//! Segments above this size are sorted with a parallel sort.
+const size_t PARALLEL_SORT_SIZE = size_t(1) << 16;
+
+//! Replace counts by their exclusive prefix sum, in parallel over fixed blocks.
+/*! \param counts Array of n counts, replaced with the sum of all previous counts.
+ *  \return The sum of all counts.
+ */
+size_t exclusiveScan(std::atomic<size_t>* counts, size_t n)
 {
-    const unsigned int num_points = nq->getNPoints();
-    m_cluster_idx.prepare(num_points);
-    DisjointSets dj(num_points);
+    const size_t block_size = (n + SCAN_BLOCKS - 1) / SCAN_BLOCKS;
+    std::vector<size_t> block_sums(SCAN_BLOCKS + 1, 0);
+    util::forLoopWrapper(0, SCAN_BLOCKS, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            size_t sum = 0;
+            for (size_t i = block * block_size; i < std::min(n, (block + 1) * block_size); ++i)
+            {
+                sum += counts[i].load(std::memory_order_relaxed);
+            }
+            block_sums[block + 1] = sum;
+        }
+    });
+    std::partial_sum(block_sums.begin(), block_sums.end(), block_sums.begin());
+    util::forLoopWrapper(0, SCAN_BLOCKS, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            size_t sum = block_sums[block];
+            for (size_t i = block * block_size; i < std::min(n, (block + 1) * block_size); ++i)
+            {
+                sum += counts[i].exchange(sum, std::memory_order_relaxed);
+            }
+        }
+    });
+    return block_sums[SCAN_BLOCKS];
+}
 
-    freud::locality::loopOverNeighbors(
-        nq, nq->getPoints(), num_points, qargs, nlist,
-        [&dj](const freud::locality::NeighborBond& neighbor_bond) {
-            // Merge the two sets using the disjoint set
-            if (!dj.same(neighbor_bond.point_idx, neighbor_bond.query_point_idx))
+//! Stable parallel counting sort of the indices of items by bucket.
+/*! Counts of consecutive items in the same bucket are added and their output
+ *  slots reserved with a single atomic operation, which keeps contention low
+ *  when many items share a bucket. Since threads reserve slots in any
+ *  order, each bucket is sorted afterwards, so the result is deterministic.
+ *
+ *  \param n_items Number of items.
+ *  \param n_buckets Number of buckets.
+ *  \param bucket Function returning the bucket of an item, or n_buckets to
+ *         leave the item out.
+ *  \param offsets Filled with the n_buckets + 1 offsets of the buckets in order.
+ *  \param order Filled with the sorted item indices, in increasing order within each bucket.
+ */
+template<typename Bucket>
+void countingSort(size_t n_items, size_t n_buckets, const Bucket& bucket, std::vector<size_t>& offsets,
+                  std::vector<unsigned int>& order)
+{
+    // Apply body(first_item, end_item, bucket) to all runs of consecutive
+    // items in the same bucket.
+    auto for_each_run = [&](const std::function<void(size_t, size_t, size_t)>& body) {
+        util::forLoopWrapper(0, n_items, [&](size_t begin, size_t end) {
+            size_t item = begin;
+            while (item < end)
             {
-                dj.unite(neighbor_bond.point_idx, neighbor_bond.query_point_idx);
+                const size_t item_bucket = bucket(item);
+                size_t run_end = item + 1;
+                while (run_end < end && bucket(run_end) == item_bucket)
+                {
+                    ++run_end;
+                }
+                if (item_bucket < n_buckets)
+                {
+                    body(item, run_end, item_bucket);
+                }
+                item = run_end;
             }
         });
+    };
 
-    // Done looping over points. All clusters are now determined.
-    // Next, we renumber clusters from zero to num_clusters-1.
-    // These new cluster indexes are then sorted by cluster size from largest
-    // to smallest, with equally-sized clusters sorted based on their minimum
-    // point index.
-    std::vector<size_t> cluster_label(num_points, num_points);
-    std::vector<size_t> cluster_label_count(num_points);
-    std::vector<size_t> cluster_min_id(num_points, num_points);
-
-    // Loop over every point.
-    m_num_clusters = 0;
-    for (size_t i = 0; i < num_points; i++)
-    {
-        size_t s = dj.find(i);
+    std::unique_ptr<std::atomic<size_t>[]> cursors(new std::atomic<size_t>[n_buckets]());
+    for_each_run([&](size_t first, size_t last, size_t b) {
+        cursors[b].fetch_add(last - first, std::memory_order_relaxed);
+    });
+    const size_t n_sorted = exclusiveScan(cursors.get(), n_buckets);
 
-        // Label this cluster if we haven't seen it yet.
-        if (cluster_label[s] == num_points)
+    offsets.resize(n_buckets + 1);
+    util::forLoopWrapper(0, n_buckets, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
         {
-            // Label this cluster uniquely.
-            cluster_label[s] = m_num_clusters;
-            // Track the smallest point index in this cluster.
-            cluster_min_id[cluster_label[s]] = i;
-            // Increment the count of unique clusters.
-            m_num_clusters++;
+            offsets[b] = cursors[b].load(std::memory_order_relaxed);
         }
+    });
+    offsets[n_buckets] = n_sorted;
 
-        // Increment the counter for this cluster label.
-        cluster_label_count[cluster_label[s]]++;
-    }
+    order.resize(n_sorted);
+    for_each_run([&](size_t first, size_t last, size_t b) {
+        size_t slot = cursors[b].fetch_add(last - first, std::memory_order_relaxed);
+        for (size_t item = first; item < last; ++item, ++slot)
+        {
+            order[slot] = static_cast<unsigned int>(item);
+        }
+    });
 
-    // Resize label counts and min ids to the number of unique clusters found.
-    cluster_label_count.resize(m_num_clusters);
-    cluster_label_count.shrink_to_fit();
-    cluster_min_id.resize(m_num_clusters);
-    cluster_min_id.shrink_to_fit();
+    util::forLoopWrapper(0, n_buckets, [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const auto first = order.begin() + offsets[b];
+            const auto last = order.begin() + offsets[b + 1];
+            if (std::is_sorted(first, last))
+            {
+                continue;
+            }
+            if (size_t(last - first) > PARALLEL_SORT_SIZE)
+            {
+                tbb::parallel_sort(first, last);
+            }
+            else
+            {
+                std::sort(first, last);
+            }
+        }
+    });
+}
 
-    // Get a permutation that reorders clusters, largest to smallest.
-    std::vector<size_t> cluster_reindex = sort_indexes_inverse(cluster_label_count, cluster_min_id);
+}; // namespace
 
-    // Clear the cluster keys
-    m_cluster_keys = std::vector<std::vector<unsigned int>>(m_num_clusters, std::vector<unsigned int>());
+void Cluster::compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
+                      freud::locality::QueryArgs qargs, const unsigned int* keys)
+{
+    util::profiling::ScopedTimer timer("Cluster::compute");
+    ConcurrentUnionFind sets(nq->getNPoints());
 
-    /* Loop over all points, set their cluster ids and add them to a list of
-     * sets. Each set contains all the keys that are part of that cluster. If
-     * no keys are provided, the keys use point ids. Get the computed list
-     * with getClusterKeys().
-     */
-    for (size_t i = 0; i < num_points; i++)
-    {
-        size_t s = dj.find(i);
-        size_t cluster_idx = cluster_reindex[cluster_label[s]];
-        m_cluster_idx[i] = cluster_idx;
-        unsigned int key = i;
-        if (keys != NULL)
-            key = keys[i];
-        m_cluster_keys[cluster_idx].push_back(key);
-    }
+    freud::locality::loopOverNeighbors(
+        nq, nq->getPoints(), nq->getNPoints(), qargs, nlist,
+        [&sets](const freud::locality::NeighborBond& neighbor_bond) {
+            // Merge the two sets using the disjoint set
+            sets.unite(neighbor_bond.point_idx, neighbor_bond.query_point_idx);
+        });
+
+    // Done looping over points. All clusters are now determined.
+    labelClusters(sets, keys);
 }
 
-// Returns inverse permutation of cluster indexes, sorted from largest to smallest.
-// Adapted from https://stackoverflow.com/questions/1577475/c-sorting-and-keeping-track-of-indexes
-std::vector<size_t> Cluster::sort_indexes_inverse(const std::vector<size_t>& counts,
-                                                  const std::vector<size_t>& min_ids)
+void Cluster::labelClusters(const ConcurrentUnionFind& sets, const unsigned int* keys)
 {
-    // Initialize original index locations.
-    std::vector<size_t> idx(counts.size());
-    std::iota(idx.begin(), idx.end(), 0);
+    const unsigned int num_points = sets.size();
+    m_cluster_idx.prepare(num_points);
 
-    // Sort indexes based on comparing values in counts, min_ids.
-    std::sort(idx.begin(), idx.end(), [&counts, &min_ids](size_t i1, size_t i2) {
-        if (counts[i1] != counts[i2])
+    // Compress all paths. The root of each cluster is its smallest point
+    // index, so the cluster index array temporarily holds these roots.
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            // If the counts are unequal, return the largest cluster first.
-            return counts[i1] > counts[i2];
+            m_cluster_idx[i] = sets.find(i);
         }
-        else
+    });
+
+    // Count the points of each cluster at its root.
+    std::unique_ptr<std::atomic<size_t>[]> sizes(new std::atomic<size_t>[num_points]());
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        size_t i = begin;
+        while (i < end)
+        {
+            const unsigned int root = m_cluster_idx[i];
+            size_t run_end = i + 1;
+            while (run_end < end && m_cluster_idx[run_end] == root)
+            {
+                ++run_end;
+            }
+            sizes[root].fetch_add(run_end - i, std::memory_order_relaxed);
+            i = run_end;
+        }
+    });
+
+    // Order the roots by decreasing cluster size, and by increasing root
+    // (the smallest point index) for clusters of equal size.
+    std::vector<size_t> size_offsets;
+    std::vector<unsigned int> roots;
+    countingSort(
+        num_points, num_points,
+        [&](size_t i) {
+            return (m_cluster_idx[i] == i) ? num_points - sizes[i].load(std::memory_order_relaxed)
+                                           : size_t(num_points);
+        },
+        size_offsets, roots);
+    m_num_clusters = static_cast<unsigned int>(roots.size());
+
+    // Renumber clusters from zero to num_clusters-1 in that order, reusing
+    // the counts array for the label of each root.
+    util::forLoopWrapper(0, m_num_clusters, [&](size_t begin, size_t end) {
+        for (size_t cluster = begin; cluster < end; ++cluster)
+        {
+            sizes[roots[cluster]].store(cluster, std::memory_order_relaxed);
+        }
+    });
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            // If the counts are equal, return the cluster with the smallest
-            // point id first.
-            return min_ids[i1] < min_ids[i2];
+            m_cluster_idx[i]
+                = static_cast<unsigned int>(sizes[m_cluster_idx[i]].load(std::memory_order_relaxed));
         }
     });
 
-    // Invert the permutation.
-    std::vector<size_t> inv_idx(idx.size());
-    for (size_t i = 0; i < idx.size(); i++)
-        inv_idx[idx[i]] = i;
-    return inv_idx;
+    /* Sort all points by cluster to get the keys of each cluster with
+     * getClusterKeys(). Keys within a cluster are in increasing order of
+     * point index. If no keys are provided, the keys use point ids.
+     */
+    countingSort(
+        num_points, m_num_clusters, [&](size_t i) { return size_t(m_cluster_idx[i]); }, m_cluster_key_offsets,
+        m_cluster_keys);
+    if (keys != NULL)
+    {
+        util::forLoopWrapper(0, m_cluster_keys.size(), [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+            {
+                m_cluster_keys[k] = keys[m_cluster_keys[k]];
+            }
+        });
+    }
 }
 
 }; }; // end namespace freud::cluster
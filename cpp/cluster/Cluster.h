@@ -9,7 +9,9 @@
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "ConcurrentUnionFind.h"
 #include "VectorMath.h"
+#include "utils.h"
 
 /*! \file Cluster.h
     \brief Routines for clustering points.
@@ -41,12 +43,62 @@ class Cluster
 {
 public:
     //! Constructor
-    Cluster() {}
+    Cluster() : m_num_clusters(0) {}
 
     //! Compute the point clusters.
     void compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
                  freud::locality::QueryArgs qargs, const unsigned int* keys = NULL);
 
+    //! Compute the point clusters formed by the bonds of a NeighborList accepted by a filter.
+    /*! The accepted bonds are united concurrently in the disjoint sets, so
+     *  callers that select bonds by a criterion do not need to build a
+     *  filtered copy of the NeighborList.
+     *
+     *  \param num_points Number of points to cluster.
+     *  \param nlist NeighborList containing the candidate bonds.
+     *  \param accept Function of a bond index returning whether the bond
+     *         connects its points. It is called concurrently.
+     *  \param keys Optional key of each point.
+     */
+    template<typename Filter>
+    void computeFiltered(unsigned int num_points, const freud::locality::NeighborList* nlist,
+                         const Filter& accept, const unsigned int* keys = NULL)
+    {
+        const unsigned int* query_point_indices = nlist->getQueryPointIndices().get();
+        const unsigned int* point_indices = nlist->getPointIndices().get();
+        computeUnited(
+            num_points,
+            [&](ConcurrentUnionFind& sets) {
+                util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+                    for (size_t bond = begin; bond < end; ++bond)
+                    {
+                        if (accept(bond))
+                        {
+                            sets.unite(query_point_indices[bond], point_indices[bond]);
+                        }
+                    }
+                });
+            },
+            keys);
+    }
+
+    //! Compute the point clusters formed by the pairs united by a function.
+    /*! This lets callers that find the bonds in pieces, such as chunked
+     *  NeighborLists, add them to the disjoint sets as they are found.
+     *
+     *  \param num_points Number of points to cluster.
+     *  \param unite Function of the ConcurrentUnionFind of the points that
+     *         unites the points of each bond.
+     *  \param keys Optional key of each point.
+     */
+    template<typename Unite>
+    void computeUnited(unsigned int num_points, const Unite& unite, const unsigned int* keys = NULL)
+    {
+        ConcurrentUnionFind sets(num_points);
+        unite(sets);
+        labelClusters(sets, keys);
+    }
+
     //! Get the total number of clusters.
     unsigned int getNumClusters() const
     {
@@ -59,22 +111,49 @@ public:
         return m_cluster_idx;
     }
 
-    //! Get a reference to the cluster keys.
-    const std::vector<std::vector<unsigned int>>& getClusterKeys() const
+    //! Get the number of points in a cluster.
+    unsigned int getClusterSize(unsigned int cluster) const
+    {
+        return static_cast<unsigned int>(m_cluster_key_offsets[cluster + 1] - m_cluster_key_offsets[cluster]);
+    }
+
+    //! Get the keys of all points, ordered by cluster.
+    /*! The keys of cluster c are in the range [getClusterKeyOffsets()[c],
+     *  getClusterKeyOffsets()[c + 1]), in increasing order of point index.
+     */
+    const std::vector<unsigned int>& getClusterKeysFlat() const
     {
         return m_cluster_keys;
     }
 
+    //! Get the offset of the keys of each cluster in getClusterKeysFlat().
+    const std::vector<size_t>& getClusterKeyOffsets() const
+    {
+        return m_cluster_key_offsets;
+    }
+
+    //! Get a list of the keys in each cluster.
+    std::vector<std::vector<unsigned int>> getClusterKeys() const
+    {
+        std::vector<std::vector<unsigned int>> cluster_keys(m_num_clusters);
+        for (unsigned int cluster = 0; cluster < m_num_clusters; ++cluster)
+        {
+            cluster_keys[cluster].assign(m_cluster_keys.begin() + m_cluster_key_offsets[cluster],
+                                         m_cluster_keys.begin() + m_cluster_key_offsets[cluster + 1]);
+        }
+        return cluster_keys;
+    }
+
 private:
-    unsigned int m_num_clusters;                           //!< Number of clusters found
-    util::ManagedArray<unsigned int> m_cluster_idx;        //!< Cluster index for each point
-    std::vector<std::vector<unsigned int>> m_cluster_keys; //!< List of keys in each cluster
-
-    // Returns inverse permutation of cluster indices, sorted from largest to
-    // smallest. Adapted from
-    // https://stackoverflow.com/questions/1577475/c-sorting-and-keeping-track-of-indexes
-    static std::vector<size_t> sort_indexes_inverse(const std::vector<size_t>& counts,
-                                                    const std::vector<size_t>& min_ids);
+    //! Number the clusters of the disjoint sets by decreasing size and collect their keys.
+    /*! Clusters of equal size are ordered by their smallest point index.
+     */
+    void labelClusters(const ConcurrentUnionFind& sets, const unsigned int* keys);
+
+    unsigned int m_num_clusters;                    //!< Number of clusters found
+    util::ManagedArray<unsigned int> m_cluster_idx; //!< Cluster index for each point
+    std::vector<unsigned int> m_cluster_keys;       //!< Keys of all points, ordered by cluster
+    std::vector<size_t> m_cluster_key_offsets;      //!< Offset of the keys of each cluster
 };
 
 }; }; // end namespace freud::cluster
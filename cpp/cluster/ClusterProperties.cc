@@ -1,10 +1,14 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
 #include <vector>
 
 #include "ClusterProperties.h"
 #include "NeighborComputeFunctional.h"
+#include "ParallelAccumulator.h"
+#include "utils.h"
 
 /*! \file ClusterProperties.cc
     \brief Routines for computing properties of point clusters.
@@ -12,81 +16,166 @@
 
 namespace freud { namespace cluster {
 
+namespace {
+
+//! Number of first pass sums per cluster: the count, and the cosine and sine of the phase of each coordinate.
+const unsigned int NUM_CENTER_SUMS = 7;
+
+//! Number of second pass sums per cluster: the independent components of the second moment.
+const unsigned int NUM_MOMENT_SUMS = 6;
+
+//! Add the values of every point to the sums of its cluster.
+/*! Runs of consecutive points in the same cluster are summed locally before
+ *  they are added to the accumulator, which makes clusters stored
+ *  contiguously (such as molecules) cheap to reduce.
+ *
+ *  \param values Function filling the K values of a point.
+ */
+template<unsigned int K, typename Values>
+void accumulateClusterSums(const unsigned int* cluster_idx, unsigned int num_points, const Values& values,
+                           util::ParallelAccumulator<double>& sums)
+{
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        double run_sums[K];
+        double point_values[K];
+        size_t i = begin;
+        while (i < end)
+        {
+            const unsigned int c = cluster_idx[i];
+            std::fill(run_sums, run_sums + K, 0.0);
+            for (; i < end && cluster_idx[i] == c; ++i)
+            {
+                values(i, point_values);
+                for (unsigned int k = 0; k < K; ++k)
+                {
+                    run_sums[k] += point_values[k];
+                }
+            }
+            for (unsigned int k = 0; k < K; ++k)
+            {
+                sums.add(size_t(c) * K + k, run_sums[k]);
+            }
+        }
+    });
+}
+
+}; // namespace
+
 /*! \param nq NeighborQuery containing the points making up the clusters
     \param cluster_idx Index of which cluster each point belongs to
 
     compute loops over all points in the given array and determines the center
-    of mass of the cluster as well as the gyration tensor. These can be
-    accessed after the call to compute with getClusterCenters() and
-    getClusterGyrations().
+    of mass of the cluster as well as the gyration tensor, radius of gyration,
+    moment of inertia tensor, and size. These can be accessed after the call to
+    compute with getClusterCenters(), getClusterGyrations(),
+    getClusterRadiiOfGyration(), getClusterInertiaTensors(), and
+    getClusterSizes().
 */
 
 void ClusterProperties::compute(const freud::locality::NeighborQuery* nq, const unsigned int* cluster_idx)
 {
+    const unsigned int num_points = nq->getNPoints();
+    const vec3<float>* points = nq->getPoints();
+    const box::Box& box = nq->getBox();
+
     // determine the number of clusters
-    const unsigned int* max_cluster_id = std::max_element(cluster_idx, cluster_idx + nq->getNPoints());
-    const unsigned int num_clusters = *max_cluster_id + 1;
+    const unsigned int num_clusters
+        = (num_points == 0) ? 0 : *std::max_element(cluster_idx, cluster_idx + num_points) + 1;
 
-    // allocate memory for the cluster properties and temporary arrays
-    // initialize arrays to 0
+    // allocate memory for the cluster properties and initialize arrays to 0
     m_cluster_centers.prepare(num_clusters);
     m_cluster_gyrations.prepare({num_clusters, 3, 3});
+    m_cluster_radii_of_gyration.prepare(num_clusters);
+    m_cluster_inertia_tensors.prepare({num_clusters, 3, 3});
     m_cluster_sizes.prepare(num_clusters);
 
-    // Create a vector to store cluster points, used to compute center of mass
-    std::vector<std::vector<vec3<float>>> cluster_points(num_clusters, std::vector<vec3<float>>());
-
-    // Start by determining the center of mass of each cluster. Since we are
-    // given an array of points, the easiest way to do this is to loop over
-    // all points and add the appropriate information to m_cluster_centers as
-    // we go.
-    for (unsigned int i = 0; i < nq->getNPoints(); i++)
-    {
-        const unsigned int c = cluster_idx[i];
-        cluster_points[c].push_back((*nq)[i]);
-        m_cluster_sizes[c]++;
-    }
-
-    // Now that we have located all of the cluster vectors, compute the centers
-    for (unsigned int c = 0; c < num_clusters; c++)
-    {
-        m_cluster_centers[c] = nq->getBox().centerOfMass(cluster_points[c].data(), m_cluster_sizes[c]);
-    }
+    // Start by determining the center of mass of each cluster, as the
+    // circular mean of the fractional coordinates like Box::centerOfMass.
+    util::ParallelAccumulator<double> center_sums(size_t(num_clusters) * NUM_CENTER_SUMS);
+    accumulateClusterSums<NUM_CENTER_SUMS>(
+        cluster_idx, num_points,
+        [&](size_t i, double* values) {
+            const vec3<float> phase(constants::TWO_PI * box.makeFractional(points[i]));
+            values[0] = 1;
+            values[1] = std::cos(phase.x);
+            values[2] = std::sin(phase.x);
+            values[3] = std::cos(phase.y);
+            values[4] = std::sin(phase.y);
+            values[5] = std::cos(phase.z);
+            values[6] = std::sin(phase.z);
+        },
+        center_sums);
+    util::ManagedArray<double> center_totals(size_t(num_clusters) * NUM_CENTER_SUMS);
+    center_sums.reduceInto(center_totals);
+
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const double* totals = &center_totals[c * NUM_CENTER_SUMS];
+            m_cluster_sizes[c] = static_cast<unsigned int>(totals[0]);
+            // Empty clusters have a NaN center, since 0/0 is NaN.
+            const vec3<float> mean_phase(std::atan2(totals[2] / totals[0], totals[1] / totals[0]),
+                                         std::atan2(totals[4] / totals[0], totals[3] / totals[0]),
+                                         std::atan2(totals[6] / totals[0], totals[5] / totals[0]));
+            m_cluster_centers[c] = box.wrap(box.makeAbsolute(mean_phase / constants::TWO_PI));
+        }
+    });
 
     // Now that we have determined the centers of mass for each cluster, tally
-    // up the gyration tensor. This has to be done in a loop over the points.
-    for (unsigned int i = 0; i < nq->getNPoints(); i++)
-    {
-        unsigned int c = cluster_idx[i];
-        vec3<float> pos = (*nq)[i];
-        vec3<float> delta = nq->getBox().wrap(pos - m_cluster_centers[c]);
-
-        // get the start pointer for our 3x3 matrix
-        m_cluster_gyrations(c, 0, 0) += delta.x * delta.x;
-        m_cluster_gyrations(c, 0, 1) += delta.x * delta.y;
-        m_cluster_gyrations(c, 0, 2) += delta.x * delta.z;
-        m_cluster_gyrations(c, 1, 0) += delta.y * delta.x;
-        m_cluster_gyrations(c, 1, 1) += delta.y * delta.y;
-        m_cluster_gyrations(c, 1, 2) += delta.y * delta.z;
-        m_cluster_gyrations(c, 2, 0) += delta.z * delta.x;
-        m_cluster_gyrations(c, 2, 1) += delta.z * delta.y;
-        m_cluster_gyrations(c, 2, 2) += delta.z * delta.z;
-    }
-
-    // Normalize by the cluster size.
-    for (unsigned int c = 0; c < num_clusters; c++)
-    {
-        float s = float(m_cluster_sizes[c]);
-        m_cluster_gyrations(c, 0, 0) /= s;
-        m_cluster_gyrations(c, 0, 1) /= s;
-        m_cluster_gyrations(c, 0, 2) /= s;
-        m_cluster_gyrations(c, 1, 0) /= s;
-        m_cluster_gyrations(c, 1, 1) /= s;
-        m_cluster_gyrations(c, 1, 2) /= s;
-        m_cluster_gyrations(c, 2, 0) /= s;
-        m_cluster_gyrations(c, 2, 1) /= s;
-        m_cluster_gyrations(c, 2, 2) /= s;
-    }
+    // up the second moments of the minimum image vectors from the centers.
+    util::ParallelAccumulator<double> moment_sums(size_t(num_clusters) * NUM_MOMENT_SUMS);
+    accumulateClusterSums<NUM_MOMENT_SUMS>(
+        cluster_idx, num_points,
+        [&](size_t i, double* values) {
+            const vec3<double> delta(box.wrap(points[i] - m_cluster_centers[cluster_idx[i]]));
+            values[0] = delta.x * delta.x;
+            values[1] = delta.x * delta.y;
+            values[2] = delta.x * delta.z;
+            values[3] = delta.y * delta.y;
+            values[4] = delta.y * delta.z;
+            values[5] = delta.z * delta.z;
+        },
+        moment_sums);
+    util::ManagedArray<double> moment_totals(size_t(num_clusters) * NUM_MOMENT_SUMS);
+    moment_sums.reduceInto(moment_totals);
+
+    // The gyration tensor is the second moment normalized by the cluster
+    // size, and the moment of inertia tensor of unit masses is
+    // sum_i (|r_i|^2 I - r_i r_i^T).
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            const double* totals = &moment_totals[c * NUM_MOMENT_SUMS];
+            const double moments[3][3] = {{totals[0], totals[1], totals[2]},
+                                          {totals[1], totals[3], totals[4]},
+                                          {totals[2], totals[4], totals[5]}};
+            const double trace = totals[0] + totals[3] + totals[5];
+            const double size = m_cluster_sizes[c];
+            for (unsigned int a = 0; a < 3; ++a)
+            {
+                for (unsigned int b = 0; b < 3; ++b)
+                {
+                    m_cluster_gyrations(c, a, b) = static_cast<float>(moments[a][b] / size);
+                    m_cluster_inertia_tensors(c, a, b)
+                        = static_cast<float>(((a == b) ? trace : 0.0) - moments[a][b]);
+                }
+            }
+            m_cluster_radii_of_gyration[c] = static_cast<float>(std::sqrt(trace / size));
+        }
+    });
+
+    // Count the clusters of each size.
+    const unsigned int* sizes = m_cluster_sizes.get();
+    const unsigned int max_size = (num_clusters == 0) ? 0 : *std::max_element(sizes, sizes + num_clusters);
+    util::ParallelAccumulator<unsigned int> size_counts(size_t(max_size) + 1);
+    util::forLoopWrapper(0, num_clusters, [&](size_t begin, size_t end) {
+        for (size_t c = begin; c < end; ++c)
+        {
+            size_counts.add(m_cluster_sizes[c], 1);
+        }
+    });
+    m_cluster_size_histogram.prepare(size_t(max_size) + 1);
+    size_counts.reduceInto(m_cluster_size_histogram);
 }
 
 }; }; // end namespace freud::cluster
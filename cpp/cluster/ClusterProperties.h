@@ -19,11 +19,20 @@ namespace freud { namespace cluster {
     cluster:
      - Center of mass
      - Gyration tensor
+     - Radius of gyration
+     - Moment of inertia tensor (for unit masses)
+     - Size, and the number of clusters of each size
 
     m_cluster_centers stores the computed center of mass for each cluster,
     properly handling periodic boundary conditions.
     m_cluster_gyrations stores a 3x3 gyration tensor for each cluster. The
     tensors are symmetric.
+
+    Points are processed in parallel, and the sums of each cluster are
+    reduced from per-thread partial sums in double precision, buffering runs
+    of consecutive points in the same cluster. The center of every cluster is
+    computed in a first pass over the points, and all moments about the
+    center in a second pass.
 */
 class ClusterProperties
 {
@@ -46,18 +55,40 @@ public:
         return m_cluster_gyrations;
     }
 
+    //! Get a reference to the last computed cluster radii of gyration
+    const util::ManagedArray<float>& getClusterRadiiOfGyration() const
+    {
+        return m_cluster_radii_of_gyration;
+    }
+
+    //! Get a reference to the last computed cluster moment of inertia tensors
+    const util::ManagedArray<float>& getClusterInertiaTensors() const
+    {
+        return m_cluster_inertia_tensors;
+    }
+
     //! Get a reference to the last computed cluster size
     const util::ManagedArray<unsigned int>& getClusterSizes() const
     {
         return m_cluster_sizes;
     }
 
+    //! Get a reference to the number of clusters of each size, from zero to the largest size
+    const util::ManagedArray<unsigned int>& getClusterSizeHistogram() const
+    {
+        return m_cluster_size_histogram;
+    }
+
 private:
     util::ManagedArray<vec3<float>>
         m_cluster_centers; //!< Center of mass computed for each cluster (length: m_num_clusters)
     util::ManagedArray<float>
         m_cluster_gyrations; //!< Gyration tensor computed for each cluster (m_num_clusters x 3 x 3 array)
-    util::ManagedArray<unsigned int> m_cluster_sizes; //!< Size per cluster
+    util::ManagedArray<float> m_cluster_radii_of_gyration; //!< Radius of gyration of each cluster
+    util::ManagedArray<float>
+        m_cluster_inertia_tensors; //!< Inertia tensor of each cluster (m_num_clusters x 3 x 3 array)
+    util::ManagedArray<unsigned int> m_cluster_sizes;          //!< Size per cluster
+    util::ManagedArray<unsigned int> m_cluster_size_histogram; //!< Number of clusters of each size
 };
 
 }; }; // end namespace freud::cluster
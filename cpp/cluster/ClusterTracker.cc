@@ -0,0 +1,247 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_sort.h>
+#include <unordered_map>
+#include <utility>
+
+#include "ClusterTracker.h"
+#include "ParallelAccumulator.h"
+#include "utils.h"
+
+/*! \file ClusterTracker.cc
+    \brief Follows clusters of points across the frames of a trajectory.
+*/
+
+namespace freud { namespace cluster {
+
+// Definition of the constant, which is bound to references (e.g. by std::vector constructors).
+const unsigned int ClusterTracker::NO_ID;
+
+ClusterTracker::ClusterTracker(unsigned int min_size) : m_min_size(min_size), m_num_frames(0), m_next_id(0)
+{
+    if (min_size == 0)
+    {
+        throw std::invalid_argument("ClusterTracker requires a minimum cluster size of at least 1.");
+    }
+}
+
+void ClusterTracker::reset()
+{
+    m_num_frames = 0;
+    m_next_id = 0;
+    m_cluster_idx = util::ManagedArray<unsigned int>();
+    m_cluster_ids = util::ManagedArray<unsigned int>();
+    m_overlap = util::ManagedArray<unsigned int>();
+    m_events = util::ManagedArray<unsigned int>();
+}
+
+void ClusterTracker::compute(const freud::locality::NeighborQuery* nq,
+                             const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+{
+    m_cluster.compute(nq, nlist, qargs);
+    track(m_cluster.getClusterIdx().get(), nq->getNPoints());
+}
+
+void ClusterTracker::computeOverlap(const util::ManagedArray<unsigned int>& previous_idx,
+                                    const util::ManagedArray<unsigned int>& previous_ids,
+                                    const util::ManagedArray<unsigned int>& sizes)
+{
+    // Count the points of each pair of tracked clusters into per-thread
+    // hash maps keyed by the pair, adding runs of consecutive points in the
+    // same pair at once.
+    typedef std::unordered_map<uint64_t, unsigned int> OverlapMap;
+    tbb::enumerable_thread_specific<OverlapMap> local_overlaps;
+    const size_t num_points = m_cluster_idx.size();
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        OverlapMap& overlaps = local_overlaps.local();
+        size_t i = begin;
+        while (i < end)
+        {
+            const unsigned int previous = previous_idx[i];
+            const unsigned int current = m_cluster_idx[i];
+            size_t run_end = i + 1;
+            while (run_end < end && previous_idx[run_end] == previous && m_cluster_idx[run_end] == current)
+            {
+                ++run_end;
+            }
+            if (previous_ids[previous] != NO_ID && sizes[current] >= m_min_size)
+            {
+                overlaps[(uint64_t(previous) << 32) | current] += static_cast<unsigned int>(run_end - i);
+            }
+            i = run_end;
+        }
+    });
+
+    std::vector<std::pair<uint64_t, unsigned int>> entries;
+    for (auto overlaps = local_overlaps.begin(); overlaps != local_overlaps.end(); ++overlaps)
+    {
+        entries.insert(entries.end(), overlaps->begin(), overlaps->end());
+    }
+    tbb::parallel_sort(entries.begin(), entries.end());
+
+    // Combine the counts of pairs found by several threads.
+    size_t num_entries = 0;
+    for (size_t e = 0; e < entries.size(); ++e)
+    {
+        if (num_entries > 0 && entries[num_entries - 1].first == entries[e].first)
+        {
+            entries[num_entries - 1].second += entries[e].second;
+        }
+        else
+        {
+            entries[num_entries++] = entries[e];
+        }
+    }
+
+    m_overlap.prepare({num_entries, 3});
+    util::forLoopWrapper(0, num_entries, [&](size_t begin, size_t end) {
+        for (size_t e = begin; e < end; ++e)
+        {
+            m_overlap(e, 0) = static_cast<unsigned int>(entries[e].first >> 32);
+            m_overlap(e, 1) = static_cast<unsigned int>(entries[e].first & 0xFFFFFFFF);
+            m_overlap(e, 2) = entries[e].second;
+        }
+    });
+}
+
+void ClusterTracker::track(const unsigned int* cluster_idx, unsigned int num_points)
+{
+    if (m_num_frames > 0 && num_points != m_cluster_idx.size())
+    {
+        throw std::invalid_argument(
+            "ClusterTracker requires the same number of points in all frames tracked since the last reset.");
+    }
+
+    // Keep the previous frame. Preparing the current arrays reallocates them
+    // since these references are outstanding.
+    const util::ManagedArray<unsigned int> previous_idx = m_cluster_idx;
+    const util::ManagedArray<unsigned int> previous_ids = m_cluster_ids;
+    const unsigned int num_previous = static_cast<unsigned int>(previous_ids.size());
+
+    const unsigned int num_clusters
+        = (num_points == 0) ? 0 : *std::max_element(cluster_idx, cluster_idx + num_points) + 1;
+    m_cluster_idx.prepare(num_points);
+    util::ParallelAccumulator<unsigned int> size_counts(num_clusters);
+    util::forLoopWrapper(0, num_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_cluster_idx[i] = cluster_idx[i];
+            size_counts.add(cluster_idx[i], 1);
+        }
+    });
+    util::ManagedArray<unsigned int> sizes(num_clusters);
+    size_counts.reduceInto(sizes);
+
+    if (m_num_frames > 0)
+    {
+        computeOverlap(previous_idx, previous_ids, sizes);
+    }
+    else
+    {
+        m_overlap.prepare({0, 3});
+    }
+    const size_t num_overlaps = m_overlap.shape()[0];
+
+    // Find the number of overlapping clusters of each cluster, and the one
+    // sharing the most points. Rows are sorted by previous and then current
+    // cluster, so strict comparisons keep the smallest index on ties.
+    std::vector<unsigned int> num_successors(num_previous, 0), best_successor(num_previous, NO_ID);
+    std::vector<unsigned int> best_successor_overlap(num_previous, 0);
+    std::vector<unsigned int> num_predecessors(num_clusters, 0), best_predecessor(num_clusters, NO_ID);
+    std::vector<unsigned int> best_predecessor_overlap(num_clusters, 0);
+    for (size_t e = 0; e < num_overlaps; ++e)
+    {
+        const unsigned int previous = m_overlap(e, 0);
+        const unsigned int current = m_overlap(e, 1);
+        const unsigned int overlap = m_overlap(e, 2);
+        ++num_successors[previous];
+        ++num_predecessors[current];
+        if (overlap > best_successor_overlap[previous])
+        {
+            best_successor_overlap[previous] = overlap;
+            best_successor[previous] = current;
+        }
+        if (overlap > best_predecessor_overlap[current])
+        {
+            best_predecessor_overlap[current] = overlap;
+            best_predecessor[current] = previous;
+        }
+    }
+
+    // Clusters inherit the id of a mutually best matching previous cluster.
+    m_cluster_ids.prepare(num_clusters);
+    for (unsigned int c = 0; c < num_clusters; ++c)
+    {
+        const unsigned int previous = best_predecessor[c];
+        if (sizes[c] < m_min_size)
+        {
+            m_cluster_ids[c] = NO_ID;
+        }
+        else if (previous != NO_ID && best_successor[previous] == c)
+        {
+            m_cluster_ids[c] = previous_ids[previous];
+        }
+        else
+        {
+            m_cluster_ids[c] = m_next_id++;
+        }
+    }
+
+    std::vector<unsigned int> events;
+    auto add_event = [&events](ClusterEventType type, unsigned int previous_id, unsigned int current_id) {
+        events.push_back(type);
+        events.push_back(previous_id);
+        events.push_back(current_id);
+    };
+    for (unsigned int c = 0; c < num_clusters; ++c)
+    {
+        if (m_cluster_ids[c] != NO_ID && num_predecessors[c] == 0)
+        {
+            add_event(cluster_birth, NO_ID, m_cluster_ids[c]);
+        }
+    }
+    for (unsigned int previous = 0; previous < num_previous; ++previous)
+    {
+        if (previous_ids[previous] != NO_ID && num_successors[previous] == 0)
+        {
+            add_event(cluster_death, previous_ids[previous], NO_ID);
+        }
+    }
+
+    // Merges are listed by current cluster, so sort the rows by current
+    // cluster, keeping the order of previous clusters.
+    std::vector<size_t> rows_by_current(num_overlaps);
+    for (size_t e = 0; e < num_overlaps; ++e)
+    {
+        rows_by_current[e] = e;
+    }
+    std::stable_sort(rows_by_current.begin(), rows_by_current.end(),
+                     [this](size_t a, size_t b) { return m_overlap(a, 1) < m_overlap(b, 1); });
+    for (const size_t e : rows_by_current)
+    {
+        const unsigned int current = m_overlap(e, 1);
+        if (num_predecessors[current] > 1)
+        {
+            add_event(cluster_merge, previous_ids[m_overlap(e, 0)], m_cluster_ids[current]);
+        }
+    }
+    for (size_t e = 0; e < num_overlaps; ++e)
+    {
+        const unsigned int previous = m_overlap(e, 0);
+        if (num_successors[previous] > 1)
+        {
+            add_event(cluster_split, previous_ids[previous], m_cluster_ids[m_overlap(e, 1)]);
+        }
+    }
+
+    m_events.prepare({events.size() / 3, 3});
+    std::copy(events.begin(), events.end(), m_events.get());
+    ++m_num_frames;
+}
+
+}; }; // end namespace freud::cluster
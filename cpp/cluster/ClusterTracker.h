@@ -0,0 +1,144 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef CLUSTER_TRACKER_H
+#define CLUSTER_TRACKER_H
+
+#include <limits>
+#include <vector>
+
+#include "Cluster.h"
+#include "ManagedArray.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+
+/*! \file ClusterTracker.h
+    \brief Follows clusters of points across the frames of a trajectory.
+*/
+
+namespace freud { namespace cluster {
+
+//! Types of events between the clusters of consecutive frames.
+enum ClusterEventType
+{
+    cluster_birth = 0, //!< A cluster sharing no points with tracked clusters of the previous frame.
+    cluster_death = 1, //!< A previous cluster sharing no points with tracked clusters of the frame.
+    cluster_merge = 2, //!< One of several previous clusters sharing points with one cluster.
+    cluster_split = 3  //!< One of several clusters sharing points with one previous cluster.
+};
+
+//! Tracks clusters over a trajectory and assigns them persistent ids.
+/*! Each frame is clustered (or given cluster indices computed elsewhere) and
+ *  compared to the previous frame through the overlap matrix, the number of
+ *  points shared by each pair of previous and current clusters. The overlap
+ *  is counted in parallel into per-thread hash maps of the nonzero entries,
+ *  so its cost is linear in the number of points rather than quadratic in
+ *  the number of clusters.
+ *
+ *  A current cluster inherits the persistent id of the previous cluster it
+ *  shares the most points with, if that cluster also shares the most points
+ *  with it (ties go to the smaller cluster index). All other clusters get new
+ *  ids, in increasing order of cluster index. Clusters with fewer than
+ *  min_size points are not tracked: they have no id and do not take part in
+ *  the overlap or events, which avoids tracking every isolated point.
+ *
+ *  Events are reported as rows of (event type, previous id, current id),
+ *  where the id of a missing side is NO_ID. Births and deaths have one row
+ *  per cluster, while merges and splits have one row per pair of overlapping
+ *  clusters taking part in them.
+ */
+class ClusterTracker
+{
+public:
+    //! Id of untracked clusters and of missing sides of events.
+    static const unsigned int NO_ID = std::numeric_limits<unsigned int>::max();
+
+    //! Constructor
+    /*! \param min_size Minimum number of points of tracked clusters.
+     */
+    explicit ClusterTracker(unsigned int min_size = 1);
+
+    //! Forget all previous frames.
+    void reset();
+
+    //! Cluster a frame and track its clusters.
+    void compute(const freud::locality::NeighborQuery* nq, const freud::locality::NeighborList* nlist,
+                 freud::locality::QueryArgs qargs);
+
+    //! Track the clusters of a frame from given cluster indices.
+    /*! \param cluster_idx Index of the cluster of each point. Clusters should
+     *         be numbered contiguously from zero.
+     *  \param num_points Number of points, which must be the same in all frames.
+     */
+    void track(const unsigned int* cluster_idx, unsigned int num_points);
+
+    //! Get the minimum number of points of tracked clusters.
+    unsigned int getMinSize() const
+    {
+        return m_min_size;
+    }
+
+    //! Get the number of frames tracked since the last reset.
+    size_t getNumFrames() const
+    {
+        return m_num_frames;
+    }
+
+    //! Get the number of persistent ids assigned since the last reset.
+    unsigned int getNumIds() const
+    {
+        return m_next_id;
+    }
+
+    //! Get the number of clusters of the last frame.
+    unsigned int getNumClusters() const
+    {
+        return static_cast<unsigned int>(m_cluster_ids.size());
+    }
+
+    //! Get the cluster index of each point in the last frame.
+    const util::ManagedArray<unsigned int>& getClusterIdx() const
+    {
+        return m_cluster_idx;
+    }
+
+    //! Get the persistent id of each cluster of the last frame, or NO_ID for untracked clusters.
+    const util::ManagedArray<unsigned int>& getClusterIds() const
+    {
+        return m_cluster_ids;
+    }
+
+    //! Get the nonzero overlaps as rows of (previous cluster, current cluster, number of points).
+    /*! Rows are sorted by previous cluster, then by current cluster.
+     */
+    const util::ManagedArray<unsigned int>& getOverlap() const
+    {
+        return m_overlap;
+    }
+
+    //! Get the events of the last frame as rows of (event type, previous id, current id).
+    const util::ManagedArray<unsigned int>& getEvents() const
+    {
+        return m_events;
+    }
+
+private:
+    //! Compute the sorted nonzero overlap of the tracked clusters of two frames.
+    void computeOverlap(const util::ManagedArray<unsigned int>& previous_idx,
+                        const util::ManagedArray<unsigned int>& previous_ids,
+                        const util::ManagedArray<unsigned int>& sizes);
+
+    unsigned int m_min_size; //!< Minimum number of points of tracked clusters.
+    size_t m_num_frames;     //!< Number of frames tracked since the last reset.
+    unsigned int m_next_id;  //!< Next persistent id to assign.
+    Cluster m_cluster;       //!< Clusters of the last frame computed by compute.
+
+    util::ManagedArray<unsigned int> m_cluster_idx; //!< Cluster index of each point.
+    util::ManagedArray<unsigned int> m_cluster_ids; //!< Persistent id of each cluster.
+    util::ManagedArray<unsigned int> m_overlap;     //!< Nonzero overlaps with the previous frame.
+    util::ManagedArray<unsigned int> m_events;      //!< Events of the last frame.
+};
+
+}; }; // end namespace freud::cluster
+
+#endif // CLUSTER_TRACKER_H
@@ -0,0 +1,118 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef CONCURRENT_UNION_FIND_H
+#define CONCURRENT_UNION_FIND_H
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+/*! \file ConcurrentUnionFind.h
+    \brief Wait-free disjoint sets that can be united by many threads.
+*/
+
+namespace freud { namespace cluster {
+
+//! Disjoint sets supporting concurrent find and unite operations.
+/*! This follows the concurrent union-find of Jayanti and Tarjan ("A
+ *  Randomized Concurrent Algorithm for Disjoint Set Union", PODC 2016):
+ *  sets are linked with a single compare-and-swap of the parent of a root,
+ *  and find compresses paths by splitting, replacing the parent of each
+ *  visited element with its grandparent.
+ *
+ *  Roots are always linked below the root with the smaller index, so the
+ *  parent of every element is at most its own index, the structure never
+ *  contains cycles, and the root of each set is its smallest element once all
+ *  unite operations have completed. This makes the representative of every
+ *  set independent of the order in which threads unite elements.
+ */
+class ConcurrentUnionFind
+{
+public:
+    //! Constructor
+    /*! \param size Number of elements, each initially in its own set.
+     */
+    explicit ConcurrentUnionFind(unsigned int size)
+        : m_size(size), m_parents(new std::atomic<unsigned int>[size])
+    {
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            m_parents[i].store(i, std::memory_order_relaxed);
+        }
+    }
+
+    //! Get the number of elements.
+    unsigned int size() const
+    {
+        return m_size;
+    }
+
+    //! Find the root of the set containing an element.
+    unsigned int find(unsigned int id) const
+    {
+        unsigned int parent = m_parents[id].load(std::memory_order_relaxed);
+        while (parent != id)
+        {
+            const unsigned int grandparent = m_parents[parent].load(std::memory_order_relaxed);
+            if (grandparent != parent)
+            {
+                // Splitting may fail if another thread changed the parent,
+                // which can only have moved it closer to the root. The
+                // expected value is a copy, so a failure does not change
+                // the element visited next.
+                unsigned int expected = parent;
+                m_parents[id].compare_exchange_weak(expected, grandparent, std::memory_order_relaxed);
+            }
+            // The parent of the next element is read again, since it may
+            // have been linked below another root since it was loaded.
+            id = parent;
+            parent = m_parents[id].load(std::memory_order_relaxed);
+        }
+        return id;
+    }
+
+    //! Unite the sets containing two elements.
+    /*! \return Whether the elements were in different sets.
+     */
+    bool unite(unsigned int id1, unsigned int id2)
+    {
+        for (;;)
+        {
+            id1 = find(id1);
+            id2 = find(id2);
+            if (id1 == id2)
+            {
+                return false;
+            }
+            if (id1 < id2)
+            {
+                std::swap(id1, id2);
+            }
+            // Link the root with the larger index below the other one. This
+            // fails if another thread linked id1 first, in which case both
+            // roots are searched again.
+            unsigned int expected = id1;
+            if (m_parents[id1].compare_exchange_strong(expected, id2, std::memory_order_acq_rel))
+            {
+                return true;
+            }
+        }
+    }
+
+    //! Whether two elements are in the same set.
+    /*! The result is only guaranteed if no unite operations run concurrently.
+     */
+    bool same(unsigned int id1, unsigned int id2) const
+    {
+        return find(id1) == find(id2);
+    }
+
+private:
+    unsigned int m_size;                                    //!< Number of elements.
+    std::unique_ptr<std::atomic<unsigned int>[]> m_parents; //!< Parent of each element.
+};
+
+}; }; // end namespace freud::cluster
+
+#endif // CONCURRENT_UNION_FIND_H
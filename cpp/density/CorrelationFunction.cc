@@ -1,15 +1,21 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <cmath>
 #include <complex>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
 
 #include "CorrelationFunction.h"
+#include "FFT.h"
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
+#include "ParallelAccumulator.h"
+#include "Profiling.h"
 
 /*! \file CorrelationFunction.cc
     \brief Generic pairwise correlation functions.
@@ -18,7 +24,9 @@
 namespace freud { namespace density {
 
 template<typename T>
-CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max) : BondHistogramCompute()
+CorrelationFunction<T>::CorrelationFunction(unsigned int bins, float r_max)
+    : BondHistogramCompute(), m_engine(correlation_direct), m_grid_width(0, 0, 0),
+      m_assignment(assignment_cic)
 {
     if (bins == 0)
         throw std::invalid_argument("CorrelationFunction  requires a nonzero number of bins.");
@@ -57,6 +65,12 @@ template<typename T> void CorrelationFunction<T>::reduce()
     });
 }
 
+template<typename T> void CorrelationFunction<T>::setAccumulationStrategy(util::AccumulationStrategy strategy)
+{
+    m_local_correlation_function = CFThreadHistogram(m_correlation_function, strategy);
+    BondHistogramCompute::setAccumulationStrategy(strategy);
+}
+
 template<typename T> void CorrelationFunction<T>::reset()
 {
     BondHistogramCompute::reset();
@@ -66,6 +80,51 @@ template<typename T> void CorrelationFunction<T>::reset()
     m_local_correlation_function.reset();
 }
 
+// Name the value types of serialized states, since types of the same size
+// have different layouts.
+inline std::string valueTypeName(std::complex<double>)
+{
+    return "complex128";
+}
+
+inline std::string valueTypeName(double)
+{
+    return "float64";
+}
+
+inline std::string valueTypeName(std::complex<float>)
+{
+    return "complex64";
+}
+
+inline std::string valueTypeName(float)
+{
+    return "float32";
+}
+
+template<typename T> std::string CorrelationFunction<T>::getStateName() const
+{
+    return "CorrelationFunction<" + valueTypeName(T()) + ">";
+}
+
+template<typename T> void CorrelationFunction<T>::saveState(util::BinaryWriter& writer)
+{
+    BondHistogramCompute::saveState(writer);
+    // The sums of the correlations are stored rather than the normalized
+    // correlation function so that merged states are averaged by bond.
+    util::ManagedArray<T> correlation_sums(m_correlation_function.shape());
+    m_local_correlation_function.reduceInto(correlation_sums);
+    writer.writeArray(correlation_sums.get(), correlation_sums.size());
+}
+
+template<typename T> void CorrelationFunction<T>::loadState(util::BinaryReader& reader)
+{
+    BondHistogramCompute::loadState(reader);
+    util::ManagedArray<T> correlation_sums(m_correlation_function.shape());
+    reader.readArray(correlation_sums.get(), correlation_sums.size());
+    m_local_correlation_function.add(correlation_sums.get());
+}
+
 // Define an overloaded pair of product functions to deal with complex conjugation if necessary.
 inline std::complex<double> product(std::complex<double> x, std::complex<double> y)
 {
@@ -77,6 +136,378 @@ inline double product(double x, double y)
     return x * y;
 }
 
+inline std::complex<float> product(std::complex<float> x, std::complex<float> y)
+{
+    return std::conj(x) * y;
+}
+
+inline float product(float x, float y)
+{
+    return x * y;
+}
+
+//! Accumulates the bonds of one block of work into a correlation function.
+/*! The bonds of half neighbor lists also accumulate the product of the
+ *  reversed bond, from the point to the query point.
+ */
+template<typename T> class CorrelationBlock
+{
+public:
+    CorrelationBlock(const util::Histogram<unsigned int>& histogram,
+                     util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms,
+                     typename util::Histogram<T>::ThreadLocalHistogram& local_correlation_function,
+                     const T* values, const T* query_values, bool half)
+        : m_histogram(histogram), m_counts(local_histograms), m_correlation(local_correlation_function),
+          m_values(values), m_query_values(query_values), m_half(half)
+    {}
+
+    void operator()(const freud::locality::NeighborBond& neighbor_bond)
+    {
+        size_t value_bin;
+        m_histogram.bin(&neighbor_bond.distance, 1, &value_bin);
+        T value = product(m_values[neighbor_bond.point_idx], m_query_values[neighbor_bond.query_point_idx]);
+        if (m_half)
+        {
+            value += product(m_values[neighbor_bond.query_point_idx],
+                             m_query_values[neighbor_bond.point_idx]);
+        }
+        m_counts.increment(value_bin, m_half ? 2 : 1);
+        m_correlation.increment(value_bin, value);
+    }
+
+    void finish()
+    {
+        m_counts.finish();
+        m_correlation.finish();
+    }
+
+private:
+    const util::Histogram<unsigned int>& m_histogram;                            //!< Histogram for binning.
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_counts;    //!< Privatized bin counts.
+    typename util::Histogram<T>::ThreadLocalHistogram::LocalBlock m_correlation; //!< Privatized products.
+    const T* m_values;                                                           //!< Values of the points.
+    const T* m_query_values;                                                     //!< Query point values.
+    bool m_half; //!< Whether bonds also accumulate their reversed bond.
+};
+
+namespace {
+
+//! Convert a value of a correlation grid to the type of the correlation function.
+inline void fromGrid(const std::complex<double>& value, std::complex<double>& result)
+{
+    result = value;
+}
+
+inline void fromGrid(const std::complex<double>& value, double& result)
+{
+    result = value.real();
+}
+
+inline void fromGrid(const std::complex<double>& value, std::complex<float>& result)
+{
+    result = std::complex<float>(value);
+}
+
+inline void fromGrid(const std::complex<double>& value, float& result)
+{
+    result = float(value.real());
+}
+
+//! Grid cells receiving a point along each axis and their assignment weights.
+struct PointCells
+{
+    PointCells(const box::Box& box, const vec3<float>& point, const vec3<unsigned int>& width,
+               MassAssignment assignment)
+    {
+        // Positions in units of cells relative to the center of the first cell.
+        const vec3<float> f = box.makeFractional(point);
+        n[0] = assignmentWeights(f.x * width.x - 0.5f, width.x, assignment, indices[0], weights[0]);
+        n[1] = assignmentWeights(f.y * width.y - 0.5f, width.y, assignment, indices[1], weights[1]);
+        if (width.z == 1)
+        {
+            n[2] = 1;
+            indices[2][0] = 0;
+            weights[2][0] = 1;
+        }
+        else
+        {
+            n[2] = assignmentWeights(f.z * width.z - 0.5f, width.z, assignment, indices[2], weights[2]);
+        }
+    }
+
+    unsigned int n[3];          //!< Number of cells along each axis.
+    unsigned int indices[3][3]; //!< Index of each cell along each axis.
+    float weights[3][3];        //!< Weight of each cell along each axis.
+};
+
+//! Assign values and unit counts of points to periodic grids.
+/*! \param get_point Function returning the point of an index.
+ */
+template<typename T, typename Points>
+void assignToGrid(const box::Box& box, Points get_point, const T* values, unsigned int n_points,
+                  const vec3<unsigned int>& width, MassAssignment assignment,
+                  util::ManagedArray<std::complex<double>>& value_grid,
+                  util::ManagedArray<std::complex<double>>& count_grid)
+{
+    util::ParallelAccumulator<std::complex<double>> local_values(value_grid.size());
+    util::ParallelAccumulator<std::complex<double>> local_counts(count_grid.size());
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const PointCells cells(box, get_point(idx), width, assignment);
+            const std::complex<double> value(values[idx]);
+            for (unsigned int i = 0; i < cells.n[0]; ++i)
+            {
+                for (unsigned int j = 0; j < cells.n[1]; ++j)
+                {
+                    const double weight_xy = double(cells.weights[0][i]) * cells.weights[1][j];
+                    for (unsigned int k = 0; k < cells.n[2]; ++k)
+                    {
+                        const size_t cell
+                            = (size_t(cells.indices[0][i]) * width.y + cells.indices[1][j]) * width.z
+                            + cells.indices[2][k];
+                        const double weight = weight_xy * cells.weights[2][k];
+                        local_values.add(cell, weight * value);
+                        local_counts.add(cell, weight);
+                    }
+                }
+            }
+        }
+    });
+    local_values.reduceInto(value_grid);
+    local_counts.reduceInto(count_grid);
+}
+
+//! Fourier transform of the assignment window along one axis.
+/*! The window of cloud in cell assignment is sinc^2 and that of triangular
+ *  shaped cloud assignment is sinc^3, at each frequency of the grid.
+ */
+std::vector<double> assignmentWindow(unsigned int width, MassAssignment assignment)
+{
+    const double order = (assignment == assignment_cic) ? 2 : 3;
+    std::vector<double> window(width, 1.0);
+    for (unsigned int m = 1; m < width; ++m)
+    {
+        const int frequency = (2 * m <= width) ? int(m) : int(m) - int(width);
+        const double x = M_PI * frequency / width;
+        window[m] = std::pow(std::sin(x) / x, order);
+    }
+    return window;
+}
+
+}; // namespace
+
+template<typename T>
+void CorrelationFunction<T>::accumulateGrid(const freud::locality::NeighborQuery* neighbor_query,
+                                            const T* values, const vec3<float>* query_points,
+                                            const T* query_values, unsigned int n_query_points,
+                                            const freud::locality::NeighborList* nlist,
+                                            const freud::locality::QueryArgs& qargs)
+{
+    util::profiling::ScopedTimer timer("CorrelationFunction::accumulateGrid");
+    if (nlist != nullptr || qargs.mode != freud::locality::QueryArgs::ball
+        || freud::locality::isTypedQuery(qargs))
+    {
+        throw std::invalid_argument("The FFT CorrelationFunction engine only supports ball queries without "
+                                    "a NeighborList or type filters.");
+    }
+    const box::Box& box = neighbor_query->getBox();
+    const vec3<bool> periodic = box.getPeriodic();
+    if (!periodic.x || !periodic.y || (!box.is2D() && !periodic.z))
+    {
+        throw std::invalid_argument("The FFT CorrelationFunction engine requires a periodic box.");
+    }
+
+    // Grids have one cell per bin width along axes without a given width.
+    const size_t n_bins = getAxisSizes()[0];
+    const float bin_width = getBounds()[0].second / n_bins;
+    const vec3<float> L = box.getL();
+    vec3<unsigned int> width = m_grid_width;
+    width.x = width.x ? width.x : std::max(1u, static_cast<unsigned int>(std::ceil(L.x / bin_width)));
+    width.y = width.y ? width.y : std::max(1u, static_cast<unsigned int>(std::ceil(L.y / bin_width)));
+    width.z = box.is2D() ? 1
+                         : (width.z ? width.z
+                                    : std::max(1u, static_cast<unsigned int>(std::ceil(L.z / bin_width))));
+    const size_t n_cells = size_t(width.x) * width.y * width.z;
+    const unsigned int n_points = neighbor_query->getNPoints();
+
+    startFrame(neighbor_query, n_query_points);
+    util::ManagedArray<std::complex<double>> correlation(n_cells), counts(n_cells);
+    util::ManagedArray<std::complex<double>> query_grid(n_cells), query_counts(n_cells);
+    assignToGrid(
+        box, [=](size_t i) { return (*neighbor_query)[i]; }, values, n_points, width, m_assignment,
+        correlation, counts);
+    assignToGrid(
+        box, [=](size_t i) { return query_points[i]; }, query_values, n_query_points, width, m_assignment,
+        query_grid, query_counts);
+
+    // The correlation sum_x conj(P(x)) Q(x + d) of two grids is the inverse
+    // transform of conj(P(k)) Q(k).
+    util::GridFFT fft(width);
+    fft.transform(correlation.get(), false);
+    fft.transform(counts.get(), false);
+    fft.transform(query_grid.get(), false);
+    fft.transform(query_counts.get(), false);
+    util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            correlation[idx] = std::conj(correlation[idx]) * query_grid[idx];
+            counts[idx] = std::conj(counts[idx]) * query_counts[idx];
+        }
+    });
+
+    if (qargs.exclude_ii)
+    {
+        // Subtract the pairs of a point and the query point of the same
+        // index, with the same assignment weights as in the correlation.
+        fft.transform(correlation.get(), true);
+        fft.transform(counts.get(), true);
+        const unsigned int n_pairs = std::min(n_points, n_query_points);
+        util::ParallelAccumulator<std::complex<double>> self_correlation(n_cells), self_counts(n_cells);
+        util::forLoopWrapper(0, n_pairs, [&](size_t begin, size_t end) {
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                const PointCells cells(box, (*neighbor_query)[idx], width, m_assignment);
+                const PointCells query_cells(box, query_points[idx], width, m_assignment);
+                const std::complex<double> value(product(values[idx], query_values[idx]));
+
+                // Offsets between the cells of the pair along each axis.
+                unsigned int n_offsets[3];
+                unsigned int offsets[3][9];
+                double offset_weights[3][9];
+                const unsigned int lengths[3] = {width.x, width.y, width.z};
+                for (unsigned int axis = 0; axis < 3; ++axis)
+                {
+                    n_offsets[axis] = 0;
+                    for (unsigned int a = 0; a < cells.n[axis]; ++a)
+                    {
+                        for (unsigned int b = 0; b < query_cells.n[axis]; ++b)
+                        {
+                            offsets[axis][n_offsets[axis]]
+                                = (query_cells.indices[axis][b] + lengths[axis] - cells.indices[axis][a])
+                                % lengths[axis];
+                            offset_weights[axis][n_offsets[axis]]
+                                = double(cells.weights[axis][a]) * query_cells.weights[axis][b];
+                            ++n_offsets[axis];
+                        }
+                    }
+                }
+                for (unsigned int i = 0; i < n_offsets[0]; ++i)
+                {
+                    for (unsigned int j = 0; j < n_offsets[1]; ++j)
+                    {
+                        for (unsigned int k = 0; k < n_offsets[2]; ++k)
+                        {
+                            const size_t cell = (size_t(offsets[0][i]) * width.y + offsets[1][j]) * width.z
+                                + offsets[2][k];
+                            const double weight = offset_weights[0][i] * offset_weights[1][j]
+                                * offset_weights[2][k];
+                            self_correlation.add(cell, weight * value);
+                            self_counts.add(cell, weight);
+                        }
+                    }
+                }
+            }
+        });
+        self_correlation.reduceInto(query_grid);
+        self_counts.reduceInto(query_counts);
+        util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+            for (size_t idx = begin; idx < end; ++idx)
+            {
+                correlation[idx] -= query_grid[idx];
+                counts[idx] -= query_counts[idx];
+            }
+        });
+        fft.transform(correlation.get(), false);
+        fft.transform(counts.get(), false);
+    }
+
+    // Divide out the assignment window of both grids.
+    const std::vector<double> x_window = assignmentWindow(width.x, m_assignment);
+    const std::vector<double> y_window = assignmentWindow(width.y, m_assignment);
+    const std::vector<double> z_window = assignmentWindow(width.z, m_assignment);
+    util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const size_t i = idx / (size_t(width.y) * width.z);
+            const size_t j = (idx / width.z) % width.y;
+            const size_t k = idx % width.z;
+            const double window = x_window[i] * y_window[j] * z_window[k];
+            correlation[idx] /= window * window;
+            counts[idx] /= window * window;
+        }
+    });
+    fft.transform(correlation.get(), true);
+    fft.transform(counts.get(), true);
+
+    // Bin the correlation at each offset between cells by its wrapped length.
+    const float r_cut_sq = qargs.r_max * qargs.r_max;
+    const vec3<float> origin = box.makeAbsolute(vec3<float>(0, 0, 0));
+    util::ParallelAccumulator<std::complex<double>> bin_correlation(n_bins), bin_counts(n_bins);
+    util::ParallelAccumulator<double> bin_offsets(n_bins);
+    util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const size_t i = idx / (size_t(width.y) * width.z);
+            const size_t j = (idx / width.z) % width.y;
+            const size_t k = idx % width.z;
+            const vec3<float> delta = box.wrap(
+                box.makeAbsolute(vec3<float>(float(i) / width.x, float(j) / width.y, float(k) / width.z))
+                - origin);
+            const float r_sq = dot(delta, delta);
+            if (r_sq < r_cut_sq)
+            {
+                const float distance = std::sqrt(r_sq);
+                size_t bin;
+                m_histogram.bin(&distance, 1, &bin);
+                if (bin < n_bins)
+                {
+                    bin_correlation.add(bin, correlation[idx]);
+                    bin_counts.add(bin, counts[idx]);
+                    bin_offsets.add(bin, 1);
+                }
+            }
+        }
+    });
+    util::ManagedArray<std::complex<double>> correlation_sums(n_bins), count_sums(n_bins);
+    util::ManagedArray<double> offset_counts(n_bins);
+    bin_correlation.reduceInto(correlation_sums);
+    bin_counts.reduceInto(count_sums);
+    bin_offsets.reduceInto(offset_counts);
+
+    // The offsets between cells sample each shell unevenly, so the sums over
+    // shells within the minimum image sphere are scaled to the volume of the
+    // shell. The bin counts are the expected numbers of pairs, rounded to
+    // integers, and the correlation is scaled to keep its mean over pairs.
+    const vec3<float> nearest = box.getNearestPlaneDistance();
+    const float r_inside = float(0.5)
+        * std::min(std::min(nearest.x, nearest.y), box.is2D() ? nearest.x : nearest.z);
+    const double cell_volume = double(box.getVolume()) / n_cells;
+    for (size_t bin = 0; bin < n_bins; ++bin)
+    {
+        const double r_low = bin * double(bin_width);
+        const double r_high = std::min((bin + 1) * double(bin_width), double(qargs.r_max));
+        double scale = 1;
+        if (r_high <= r_inside && offset_counts[bin] > 0)
+        {
+            const double shell_volume = box.is2D()
+                ? M_PI * (r_high * r_high - r_low * r_low)
+                : 4 * M_PI / 3 * (r_high * r_high * r_high - r_low * r_low * r_low);
+            scale = shell_volume / (cell_volume * offset_counts[bin]);
+        }
+        const double count = scale * count_sums[bin].real();
+        const long long rounded_count = std::llround(count);
+        if (count > 0 && rounded_count > 0)
+        {
+            T value;
+            fromGrid(correlation_sums[bin] * (scale * double(rounded_count) / count), value);
+            m_local_histograms.increment(bin, static_cast<unsigned int>(rounded_count));
+            m_local_correlation_function.increment(bin, value);
+        }
+    }
+    finishFrame();
+}
+
 template<typename T>
 void CorrelationFunction<T>::accumulate(const freud::locality::NeighborQuery* neighbor_query, const T* values,
                                         const vec3<float>* query_points, const T* query_values,
@@ -84,18 +515,35 @@ void CorrelationFunction<T>::accumulate(const freud::locality::NeighborQuery* ne
                                         const freud::locality::NeighborList* nlist,
                                         freud::locality::QueryArgs qargs)
 {
-    accumulateGeneral(
-        neighbor_query, query_points, n_query_points, nlist, qargs,
-        [=](const freud::locality::NeighborBond& neighbor_bond) {
-            size_t value_bin = m_histogram.bin({neighbor_bond.distance});
-            m_local_histograms.increment(value_bin);
-            m_local_correlation_function.increment(
-                value_bin,
-                product(values[neighbor_bond.point_idx], query_values[neighbor_bond.query_point_idx]));
-        });
+    if (m_engine == correlation_fft)
+    {
+        accumulateGrid(neighbor_query, values, query_points, query_values, n_query_points, nlist, qargs);
+        return;
+    }
+    const bool half = freud::locality::isHalfNeighbors(nlist, qargs);
+    accumulateBlocks(neighbor_query, query_points, n_query_points, nlist, qargs, [=]() {
+        return CorrelationBlock<T>(m_histogram, m_local_histograms, m_local_correlation_function, values,
+                                   query_values, half);
+    });
+}
+
+template<typename T>
+void CorrelationFunction<T>::accumulateTrajectory(const freud::locality::Trajectory& trajectory,
+                                                  const T* values, freud::locality::QueryArgs qargs,
+                                                  bool parallel_frames)
+{
+    const unsigned int n_points = trajectory.getNPoints();
+    accumulateFrames(trajectory, parallel_frames,
+                     [&](const freud::locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                         const T* frame_values = values + size_t(frame) * n_points;
+                         accumulate(neighbor_query, frame_values, trajectory.getPoints(frame), frame_values,
+                                    n_points, nullptr, qargs);
+                     });
 }
 
 template class CorrelationFunction<std::complex<double>>;
 template class CorrelationFunction<double>;
+template class CorrelationFunction<std::complex<float>>;
+template class CorrelationFunction<float>;
 
 }; }; // end namespace freud::density
@@ -6,10 +6,12 @@
 
 #include "BondHistogramCompute.h"
 #include "Box.h"
+#include "GaussianDensity.h"
 #include "Histogram.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "Trajectory.h"
 #include "VectorMath.h"
 
 /*! \file CorrelationFunction.h
@@ -18,6 +20,13 @@
 
 namespace freud { namespace density {
 
+//! Algorithms for accumulating the correlation function.
+enum CorrelationEngine
+{
+    correlation_direct, //!< Sum the products of the values of every bond within r_max.
+    correlation_fft     //!< Correlate the values assigned to a periodic grid with fast Fourier transforms.
+};
+
 //! Computes the pairwise correlation function <p*q>(r) between two sets of points with associated values p
 //! and q.
 /*! Two sets of points and two sets of values associated with those
@@ -42,6 +51,18 @@ namespace freud { namespace density {
     for both points and ref_points, we omit accumulating the
     self-correlation value in the first bin.
 
+    <b>Engines:</b><br>
+    The correlation_direct engine finds every bond within r_max, which costs
+    O(N rho r_max^3) and becomes prohibitive for correlations over a large
+    fraction of the box. The correlation_fft engine instead assigns the
+    values and the number of points to periodic grids, correlates the grids
+    with fast Fourier transforms in O(M log M) for M grid cells, and bins the
+    correlation at every offset between cells by its wrapped length. The
+    assignment window is divided out of the correlations, and pairs of a
+    point with the query point of the same index are subtracted if
+    exclude_ii is set, so the result approximates the direct engine with an
+    error on the scale of a grid cell. Since neighbors are not found, the
+    engine only accepts ball queries without neighbor lists.
 */
 template<typename T> class CorrelationFunction : public locality::BondHistogramCompute
 {
@@ -60,22 +81,93 @@ public:
                     const vec3<float>* query_points, const T* query_values, unsigned int n_query_points,
                     const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
 
+    //! Accumulate all frames of a trajectory, correlating the values of each frame with themselves.
+    /*! \param trajectory The frames of points.
+     *  \param values Values of shape (n_frames, n_points).
+     *  \param qargs Query arguments.
+     *  \param parallel_frames Whether to accumulate frames concurrently, see
+     *         BondHistogramCompute::accumulateFrames.
+     */
+    void accumulateTrajectory(const freud::locality::Trajectory& trajectory, const T* values,
+                              freud::locality::QueryArgs qargs, bool parallel_frames = false);
+
     //! \internal
     //! helper function to reduce the thread specific arrays into one array
     virtual void reduce();
 
+    //! Set how bonds and values are accumulated in parallel, resetting the correlation function.
+    virtual void setAccumulationStrategy(util::AccumulationStrategy strategy);
+
+    //! Return the name identifying correlation functions of this value type in serialized states.
+    virtual std::string getStateName() const;
+
+    //! Set the algorithm used to accumulate the correlation function.
+    void setEngine(CorrelationEngine engine)
+    {
+        m_engine = engine;
+    }
+
+    //! Get the algorithm used to accumulate the correlation function.
+    CorrelationEngine getEngine() const
+    {
+        return m_engine;
+    }
+
+    //! Set the number of cells of the grid of correlation_fft along each axis.
+    /*! \param width Number of cells along each axis. Axes with no cells
+     *         have one cell per bin width, and the z axis of 2D boxes has a
+     *         single cell.
+     */
+    void setGridWidth(vec3<unsigned int> width)
+    {
+        m_grid_width = width;
+    }
+
+    //! Get the number of cells of the grid of correlation_fft along each axis.
+    vec3<unsigned int> getGridWidth() const
+    {
+        return m_grid_width;
+    }
+
+    //! Set the scheme used by correlation_fft to assign points to the grid.
+    void setMassAssignment(MassAssignment assignment)
+    {
+        m_assignment = assignment;
+    }
+
+    //! Get the scheme used by correlation_fft to assign points to the grid.
+    MassAssignment getMassAssignment() const
+    {
+        return m_assignment;
+    }
+
     //! Get a reference to the last computed correlation function.
     const util::ManagedArray<T>& getCorrelation()
     {
         return reduceAndReturn(m_correlation_function.getBinCounts());
     }
 
+protected:
+    //! Write the accumulated state, including the sums of the correlations of each bin.
+    virtual void saveState(util::BinaryWriter& writer);
+
+    //! Add the accumulated state written by saveState.
+    virtual void loadState(util::BinaryReader& reader);
+
 private:
     // Typedef thread local histogram type for use in code.
     typedef typename util::Histogram<T>::ThreadLocalHistogram CFThreadHistogram;
 
+    //! Accumulate a frame with the correlation_fft engine.
+    void accumulateGrid(const freud::locality::NeighborQuery* neighbor_query, const T* values,
+                        const vec3<float>* query_points, const T* query_values, unsigned int n_query_points,
+                        const freud::locality::NeighborList* nlist, const freud::locality::QueryArgs& qargs);
+
     util::Histogram<T> m_correlation_function;      //!< The correlation function
     CFThreadHistogram m_local_correlation_function; //!< Thread local copy of the correlation function
+    CorrelationEngine m_engine;                     //!< Algorithm used to accumulate.
+    vec3<unsigned int> m_grid_width;                //!< Cells of the correlation_fft grid, 0 for automatic.
+    MassAssignment m_assignment;                    //!< Scheme used by correlation_fft to assign points.
 };
 
 }; }; // end namespace freud::density
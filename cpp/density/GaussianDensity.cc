@@ -2,8 +2,12 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <cmath>
+#include <complex>
 #include <stdexcept>
+#include <vector>
 
+#include "BoxTraits.h"
+#include "FFT.h"
 #include "GaussianDensity.h"
 
 /*! \file GaussianDensity.cc
@@ -12,8 +16,59 @@
 
 namespace freud { namespace density {
 
+namespace {
+
+//! Grid cells along one axis within the cutoff of a point.
+struct AxisCells
+{
+    std::vector<unsigned int> indices; //!< Grid index of each cell.
+    std::vector<float> dist_sq;        //!< Squared wrapped distance from the point to the cell center.
+    std::vector<float> gaussian;       //!< One dimensional Gaussian factor of each cell.
+
+    void clear()
+    {
+        indices.clear();
+        dist_sq.clear();
+        gaussian.clear();
+    }
+};
+
+}; // namespace
+
+unsigned int assignmentWeights(float u, unsigned int width, MassAssignment assignment, unsigned int* indices,
+                               float* weights)
+{
+    int first;
+    unsigned int n;
+    if (assignment == assignment_cic)
+    {
+        first = int(std::floor(u));
+        const float f = u - float(first);
+        weights[0] = float(1.0) - f;
+        weights[1] = f;
+        n = 2;
+    }
+    else
+    {
+        const int nearest = int(std::floor(u + float(0.5)));
+        const float d = u - float(nearest);
+        first = nearest - 1;
+        weights[0] = float(0.5) * (float(0.5) - d) * (float(0.5) - d);
+        weights[1] = float(0.75) - d * d;
+        weights[2] = float(0.5) * (float(0.5) + d) * (float(0.5) + d);
+        n = 3;
+    }
+    for (unsigned int c = 0; c < n; ++c)
+    {
+        const int index = (first + int(c)) % int(width);
+        indices[c] = (index < 0) ? index + width : index;
+    }
+    return n;
+}
+
 GaussianDensity::GaussianDensity(vec3<unsigned int> width, float r_max, float sigma)
-    : m_box(), m_width(width), m_r_max(r_max), m_sigma(sigma), m_has_computed(false)
+    : m_box(), m_width(width), m_r_max(r_max), m_sigma(sigma), m_normalization(0), m_has_computed(false),
+      m_strategy(util::accumulate_auto), m_engine(gaussian_auto), m_assignment(assignment_cic)
 {
     if (r_max <= 0.0f)
         throw std::invalid_argument("GaussianDensity requires r_max to be positive.");
@@ -32,7 +87,7 @@ vec3<unsigned int> GaussianDensity::getWidth()
 }
 
 //! Compute the density array.
-void GaussianDensity::compute(const freud::locality::NeighborQuery* nq)
+void GaussianDensity::compute(const freud::locality::NeighborQuery* nq, float* density_buffer)
 {
     // set the number of dimensions for the calculation the first time it is done
     if (!m_has_computed || nq->getBox().is2D() == m_box.is2D())
@@ -48,8 +103,6 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq)
             "number of dimensions.");
     }
 
-    auto n_points = nq->getNPoints();
-
     // if the user gives a single number for width, but the nq box is 2D, and
     // we want a 2D calculation
     if (m_box.is2D())
@@ -57,9 +110,91 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq)
         m_width.z = 1;
     }
 
-    m_density_array.prepare({m_width.x, m_width.y, m_width.z});
-    util::ThreadStorage<float> local_bin_counts({m_width.x, m_width.y, m_width.z});
+    const bool tilted = m_box.getTiltFactorXY() != 0 || m_box.getTiltFactorXZ() != 0
+        || m_box.getTiltFactorYZ() != 0;
+    const vec3<bool> periodic = m_box.getPeriodic();
+    GaussianDensityEngine engine = m_engine;
+    if (engine == gaussian_auto)
+    {
+        engine = tilted ? gaussian_direct : gaussian_separable;
+    }
+    else if (engine == gaussian_separable && tilted)
+    {
+        throw std::invalid_argument("The separable GaussianDensity engine requires a box without tilt.");
+    }
+    else if (engine == gaussian_fft && (!periodic.x || !periodic.y || (!m_box.is2D() && !periodic.z)))
+    {
+        throw std::invalid_argument("The FFT GaussianDensity engine requires a periodic box.");
+    }
+
+    const float sigmasq = m_sigma * m_sigma;
+    const float normalization_base = 1.0f / std::sqrt(constants::TWO_PI * sigmasq);
+    const float dimensions = m_box.is2D() ? 2.0f : 3.0f;
+    m_normalization = std::pow(normalization_base, dimensions);
+
+    if (density_buffer != nullptr)
+    {
+        m_density_array.setBuffer(density_buffer, {m_width.x, m_width.y, m_width.z});
+    }
+    else
+    {
+        m_density_array.releaseBuffer();
+    }
+    // The reduction below overwrites the whole array.
+    m_density_array.prepareForOverwrite({m_width.x, m_width.y, m_width.z});
+
+    // The accumulator persists across calls, so that its thread local copies
+    // are reused and only zeroed by the threads that write to them.
+    const size_t size = m_density_array.size();
+    if (m_local_density.size() != size
+        || m_local_density.getStrategy()
+            != util::ParallelAccumulator<float>::resolveStrategy(m_strategy, size))
+    {
+        m_local_density = util::ParallelAccumulator<float>(size, m_strategy);
+    }
+    else
+    {
+        m_local_density.reset();
+    }
+
+    switch (engine)
+    {
+    case gaussian_direct:
+        computeDirect(nq, m_local_density);
+        break;
+    case gaussian_separable:
+        computeSeparable(nq, m_local_density);
+        break;
+    default:
+        assignPoints(nq, m_local_density);
+        break;
+    }
+
+    // Parallel reduction over the accumulated contributions
+    m_local_density.reduceInto(m_density_array);
 
+    if (engine == gaussian_fft)
+    {
+        convolveGaussian();
+    }
+}
+
+struct GaussianDensity::DirectEngine
+{
+    GaussianDensity& gaussian_density;
+    const freud::locality::NeighborQuery* nq;
+    util::ParallelAccumulator<float>& density;
+
+    template<typename BoxType> void operator()(const BoxType& box) const
+    {
+        gaussian_density.computeDirect(box, nq, density);
+    }
+};
+
+template<typename BoxType>
+void GaussianDensity::computeDirect(const BoxType& box, const freud::locality::NeighborQuery* nq,
+                                    util::ParallelAccumulator<float>& density)
+{
     // set up some constants first
     const float Lx = m_box.getLx();
     const float Ly = m_box.getLy();
@@ -75,12 +210,8 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq)
     const int bin_cut_y = int(m_r_max / grid_size_y);
     const int bin_cut_z = m_box.is2D() ? 0 : int(m_r_max / grid_size_z);
     const float r_max_sq = m_r_max * m_r_max;
-    const float sigmasq = m_sigma * m_sigma;
-    const float normalization_base = 1.0f / std::sqrt(constants::TWO_PI * sigmasq);
-    const float dimensions = m_box.is2D() ? 2.0f : 3.0f;
-    const float normalization = std::pow(normalization_base, dimensions);
 
-    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+    util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
         // for each reference point
         for (size_t idx = begin; idx < end; ++idx)
         {
@@ -123,16 +254,13 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq)
                         const float dx = float((grid_size_x * i + grid_size_x / 2.0f) - point.x - Lx / 2.0f);
 
                         // Calculate the distance from the particle to the grid cell
-                        const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
+                        const vec3<float> delta = box.wrap(vec3<float>(dx, dy, dz));
 
                         const float r_sq = dot(delta, delta);
 
                         // Check to see if this distance is within the specified r_max
                         if (r_sq < r_max_sq)
                         {
-                            // Evaluate the gaussian
-                            const float gaussian = normalization * std::exp(-r_sq / (float(2.0) * sigmasq));
-
                             // Assure that out of range indices are corrected for storage
                             // in the array i.e. bin -1 is actually bin 29 for nbins = 30
                             const unsigned int ni = (i + m_width.x) % m_width.x;
@@ -140,16 +268,205 @@ void GaussianDensity::compute(const freud::locality::NeighborQuery* nq)
                             const unsigned int nk = (k + m_width.z) % m_width.z;
 
                             // Store the gaussian contribution
-                            local_bin_counts.local()(ni, nj, nk) += gaussian;
+                            density.add((size_t(ni) * m_width.y + nj) * m_width.z + nk, gaussian(r_sq));
                         }
                     }
                 }
             }
         }
     });
+}
+
+void GaussianDensity::computeDirect(const freud::locality::NeighborQuery* nq,
+                                    util::ParallelAccumulator<float>& density)
+{
+    box::dispatchBoxTraits(m_box, DirectEngine {*this, nq, density});
+}
+
+void GaussianDensity::computeSeparable(const freud::locality::NeighborQuery* nq,
+                                       util::ParallelAccumulator<float>& density)
+{
+    const float Lx = m_box.getLx();
+    const float Ly = m_box.getLy();
+    const float Lz = m_box.getLz();
+    const vec3<bool> periodic = m_box.getPeriodic();
 
-    // Parallel reduction over thread storage
-    local_bin_counts.reduceInto(m_density_array);
+    const float grid_size_x = Lx / m_width.x;
+    const float grid_size_y = Ly / m_width.y;
+    const float grid_size_z = m_box.is2D() ? 0 : Lz / m_width.z;
+
+    const int bin_cut_x = int(m_r_max / grid_size_x);
+    const int bin_cut_y = int(m_r_max / grid_size_y);
+    const int bin_cut_z = m_box.is2D() ? 0 : int(m_r_max / grid_size_z);
+    const float r_max_sq = m_r_max * m_r_max;
+    const float two_sigmasq = float(2.0) * m_sigma * m_sigma;
+
+    // Without tilt, each component of a wrapped vector only depends on the
+    // same component of the vector, so the wrapped distances along each axis
+    // match those of the direct engine exactly. The x and y components of
+    // the orthorhombic 3D traits are also those of 2D boxes.
+    const box::BoxTraits<3, false> box(m_box);
+    const auto fill_axis = [&](AxisCells& cells, int bin, int bin_cut, unsigned int width, bool axis_periodic,
+                               float grid_size, float L, float position, unsigned int axis) {
+        cells.clear();
+        for (int i = bin - bin_cut; i <= bin + bin_cut; i++)
+        {
+            if (!axis_periodic && (i < 0 || i >= int(width)))
+            {
+                continue;
+            }
+            const float d = float((grid_size * i + grid_size / 2.0f) - position - L / 2.0f);
+            const float wrapped
+                = (axis == 0) ? box.wrap(vec3<float>(d, 0, 0)).x : box.wrap(vec3<float>(0, d, 0)).y;
+            cells.indices.push_back((i + width) % width);
+            cells.dist_sq.push_back(wrapped * wrapped);
+            cells.gaussian.push_back(std::exp(-(wrapped * wrapped) / two_sigmasq));
+        }
+    };
+
+    util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
+        AxisCells x_cells, y_cells, z_cells;
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const vec3<float> point = (*nq)[idx];
+            const int bin_x = int((point.x + Lx / 2.0f) / grid_size_x);
+            const int bin_y = int((point.y + Ly / 2.0f) / grid_size_y);
+            fill_axis(x_cells, bin_x, bin_cut_x, m_width.x, periodic.x, grid_size_x, Lx, point.x, 0);
+            fill_axis(y_cells, bin_y, bin_cut_y, m_width.y, periodic.y, grid_size_y, Ly, point.y, 1);
+
+            z_cells.clear();
+            if (m_box.is2D())
+            {
+                // The wrapped z component is always zero in 2D.
+                z_cells.indices.push_back(0);
+                z_cells.dist_sq.push_back(0);
+                z_cells.gaussian.push_back(1);
+            }
+            else
+            {
+                const int bin_z = int((point.z + Lz / 2.0f) / grid_size_z);
+                for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+                {
+                    if (!periodic.z && (k < 0 || k >= int(m_width.z)))
+                    {
+                        continue;
+                    }
+                    const float dz = float((grid_size_z * k + grid_size_z / 2.0f) - point.z - Lz / 2.0f);
+                    const float wrapped = box.wrap(vec3<float>(0, 0, dz)).z;
+                    z_cells.indices.push_back((k + m_width.z) % m_width.z);
+                    z_cells.dist_sq.push_back(wrapped * wrapped);
+                    z_cells.gaussian.push_back(std::exp(-(wrapped * wrapped) / two_sigmasq));
+                }
+            }
+
+            for (size_t k = 0; k < z_cells.indices.size(); ++k)
+            {
+                for (size_t j = 0; j < y_cells.indices.size(); ++j)
+                {
+                    // The squared distance only grows with the x component.
+                    if (y_cells.dist_sq[j] + z_cells.dist_sq[k] >= r_max_sq)
+                    {
+                        continue;
+                    }
+                    const float yz_gaussian = m_normalization * y_cells.gaussian[j] * z_cells.gaussian[k];
+                    for (size_t i = 0; i < x_cells.indices.size(); ++i)
+                    {
+                        // Same evaluation order as dot(delta, delta) in the direct engine.
+                        const float r_sq = x_cells.dist_sq[i] + y_cells.dist_sq[j] + z_cells.dist_sq[k];
+                        if (r_sq < r_max_sq)
+                        {
+                            density.add((size_t(x_cells.indices[i]) * m_width.y + y_cells.indices[j])
+                                                * m_width.z
+                                            + z_cells.indices[k],
+                                        yz_gaussian * x_cells.gaussian[i]);
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+void GaussianDensity::assignPoints(const freud::locality::NeighborQuery* nq,
+                                   util::ParallelAccumulator<float>& density)
+{
+    const vec3<float> L = m_box.getL();
+    const float grid_size_x = L.x / m_width.x;
+    const float grid_size_y = L.y / m_width.y;
+    const float grid_size_z = L.z / m_width.z;
+
+    util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
+        unsigned int x_indices[3], y_indices[3], z_indices[3] = {0, 0, 0};
+        float x_weights[3], y_weights[3], z_weights[3] = {1, 1, 1};
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const vec3<float> point = (*nq)[idx];
+            // Positions in units of cells relative to the center of the first cell.
+            const unsigned int n_x = assignmentWeights((point.x + L.x / 2.0f) / grid_size_x - 0.5f, m_width.x,
+                                                       m_assignment, x_indices, x_weights);
+            const unsigned int n_y = assignmentWeights((point.y + L.y / 2.0f) / grid_size_y - 0.5f, m_width.y,
+                                                       m_assignment, y_indices, y_weights);
+            const unsigned int n_z = m_box.is2D()
+                ? 1
+                : assignmentWeights((point.z + L.z / 2.0f) / grid_size_z - 0.5f, m_width.z, m_assignment,
+                                    z_indices, z_weights);
+
+            for (unsigned int i = 0; i < n_x; ++i)
+            {
+                for (unsigned int j = 0; j < n_y; ++j)
+                {
+                    for (unsigned int k = 0; k < n_z; ++k)
+                    {
+                        density.add((size_t(x_indices[i]) * m_width.y + y_indices[j]) * m_width.z
+                                        + z_indices[k],
+                                    x_weights[i] * y_weights[j] * z_weights[k]);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void GaussianDensity::convolveGaussian()
+{
+    const float grid_size_x = m_box.getLx() / m_width.x;
+    const float grid_size_y = m_box.getLy() / m_width.y;
+    const float grid_size_z = m_box.is2D() ? 0 : m_box.getLz() / m_width.z;
+    const float r_max_sq = m_r_max * m_r_max;
+    const size_t n_cells = m_density_array.size();
+
+    // The kernel holds the Gaussian at every wrapped offset between cells.
+    std::vector<std::complex<float>> grid(n_cells), kernel(n_cells);
+    util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            const size_t i = idx / (size_t(m_width.y) * m_width.z);
+            const size_t j = (idx / m_width.z) % m_width.y;
+            const size_t k = idx % m_width.z;
+            const vec3<float> delta
+                = m_box.wrap(vec3<float>(grid_size_x * i, grid_size_y * j, grid_size_z * k));
+            const float r_sq = dot(delta, delta);
+            kernel[idx] = (r_sq < r_max_sq) ? gaussian(r_sq) : 0;
+            grid[idx] = m_density_array[idx];
+        }
+    });
+
+    util::transformGrid(grid.data(), m_width, false);
+    util::transformGrid(kernel.data(), m_width, false);
+    util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            grid[idx] *= kernel[idx];
+        }
+    });
+    util::transformGrid(grid.data(), m_width, true);
+
+    util::forLoopWrapper(0, n_cells, [&](size_t begin, size_t end) {
+        for (size_t idx = begin; idx < end; ++idx)
+        {
+            m_density_array[idx] = grid[idx].real();
+        }
+    });
 }
 
 }; }; // end namespace freud::density
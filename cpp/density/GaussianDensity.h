@@ -4,10 +4,12 @@
 #ifndef GAUSSIAN_DENSITY_H
 #define GAUSSIAN_DENSITY_H
 
+#include <cmath>
+
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborQuery.h"
-#include "ThreadStorage.h"
+#include "ParallelAccumulator.h"
 #include "VectorMath.h"
 
 /*! \file GaussianDensity.h
@@ -16,10 +18,48 @@
 
 namespace freud { namespace density {
 
+//! Algorithms for evaluating the Gaussian density on the grid.
+enum GaussianDensityEngine
+{
+    gaussian_auto,      //!< gaussian_separable for boxes without tilt, gaussian_direct otherwise.
+    gaussian_direct,    //!< Evaluate the Gaussian of every point at every grid cell within r_max.
+    gaussian_separable, //!< Build the Gaussian of every point from per-axis tables, requires no tilt.
+    gaussian_fft        //!< Assign points to the grid and convolve with a Gaussian, requires periodicity.
+};
+
+//! Schemes for assigning points to the grid in the gaussian_fft engine.
+enum MassAssignment
+{
+    assignment_cic, //!< Cloud in cell, linear weights over the 2 nearest cells along each axis.
+    assignment_tsc  //!< Triangular shaped cloud, quadratic weights over the 3 nearest cells.
+};
+
+//! Find the cells of one axis receiving a point and their assignment weights.
+/*! \param u Position of the point along the axis in units of cells,
+ *         relative to the center of the first cell.
+ *  \param width Number of cells along the axis.
+ *  \param assignment Assignment scheme.
+ *  \param indices Output grid indices, wrapped periodically.
+ *  \param weights Output weights of each index.
+ *  \returns The number of cells receiving the point, at most 3.
+ */
+unsigned int assignmentWeights(float u, unsigned int width, MassAssignment assignment, unsigned int* indices,
+                               float* weights);
+
 //! Computes the density of a system on a grid.
 /*! Replaces particle positions with a gaussian and calculates the
         contribution from the grid based upon the distance of the grid cell
         from the center of the Gaussian.
+
+    The gaussian_direct engine evaluates an exponential for every pair of
+    a point and a grid cell within r_max. For boxes without tilt, the
+    Gaussian factorizes into a product of one dimensional Gaussians, so the
+    gaussian_separable engine only evaluates exponentials for each axis and
+    gives the same result. The gaussian_fft engine assigns the points to the
+    grid and convolves the grid with the Gaussian using fast Fourier
+    transforms, so its cost does not depend on how many grid cells lie within
+    r_max. It approximates each point by its assignment to nearby grid cells,
+    which smooths the density on the scale of a grid cell.
 */
 class GaussianDensity
 {
@@ -48,8 +88,50 @@ public:
         return m_r_max;
     }
 
+    //! Set how the density is accumulated in parallel.
+    void setAccumulationStrategy(util::AccumulationStrategy strategy)
+    {
+        m_strategy = strategy;
+    }
+
+    //! Get how the density is accumulated in parallel.
+    util::AccumulationStrategy getAccumulationStrategy() const
+    {
+        return m_strategy;
+    }
+
+    //! Set the algorithm used to evaluate the density.
+    void setEngine(GaussianDensityEngine engine)
+    {
+        m_engine = engine;
+    }
+
+    //! Get the algorithm used to evaluate the density.
+    GaussianDensityEngine getEngine() const
+    {
+        return m_engine;
+    }
+
+    //! Set the scheme used by gaussian_fft to assign points to the grid.
+    void setMassAssignment(MassAssignment assignment)
+    {
+        m_assignment = assignment;
+    }
+
+    //! Get the scheme used by gaussian_fft to assign points to the grid.
+    MassAssignment getMassAssignment() const
+    {
+        return m_assignment;
+    }
+
     //! Compute the density.
-    void compute(const freud::locality::NeighborQuery* nq);
+    /*! \param nq The points to compute the density of.
+     *  \param density_buffer Caller-owned buffer of w_x * w_y * w_z floats
+     *         into which the density is written, or nullptr to write it into
+     *         an array owned by this object. Passing the same buffer on every
+     *         frame avoids allocating a new grid for each compute.
+     */
+    void compute(const freud::locality::NeighborQuery* nq, float* density_buffer = nullptr);
 
     //! Get a reference to the last computed density.
     const util::ManagedArray<float>& getDensity() const;
@@ -57,13 +139,45 @@ public:
     vec3<unsigned int> getWidth();
 
 private:
-    box::Box m_box;             //!< Simulation box containing the points.
-    vec3<unsigned int> m_width; //!< Number of bins in the grid in each dimension.
-    float m_r_max;              //!< Max distance at which to compute density.
-    float m_sigma;              //!< Gaussian width sigma.
-    bool m_has_computed;        //!< Tracks whether a call to compute has been made.
+    //! Add the Gaussian of every point to the cells within r_max, evaluated directly.
+    void computeDirect(const freud::locality::NeighborQuery* nq, util::ParallelAccumulator<float>& density);
+
+    //! Implementation of computeDirect for a box shape known at compile time.
+    template<typename BoxType>
+    void computeDirect(const BoxType& box, const freud::locality::NeighborQuery* nq,
+                       util::ParallelAccumulator<float>& density);
+
+    //! Forwards computeDirect to its implementation for the shape of the box.
+    struct DirectEngine;
+
+    //! Add the Gaussian of every point to the cells within r_max, evaluated from per-axis tables.
+    void computeSeparable(const freud::locality::NeighborQuery* nq,
+                          util::ParallelAccumulator<float>& density);
+
+    //! Add the assignment weights of every point to the cells nearest to it.
+    void assignPoints(const freud::locality::NeighborQuery* nq, util::ParallelAccumulator<float>& density);
+
+    //! Convolve the density array with the Gaussian using fast Fourier transforms.
+    void convolveGaussian();
+
+    //! Get the value of the normalized Gaussian at a squared distance.
+    float gaussian(float r_sq) const
+    {
+        return m_normalization * std::exp(-r_sq / (float(2.0) * m_sigma * m_sigma));
+    }
 
-    util::ManagedArray<float> m_density_array; //! Computed density array.
+    box::Box m_box;                        //!< Simulation box containing the points.
+    vec3<unsigned int> m_width;            //!< Number of bins in the grid in each dimension.
+    float m_r_max;                         //!< Max distance at which to compute density.
+    float m_sigma;                         //!< Gaussian width sigma.
+    float m_normalization;                 //!< Normalization of the Gaussian in the current dimension.
+    bool m_has_computed;                   //!< Tracks whether a call to compute has been made.
+    util::AccumulationStrategy m_strategy; //!< How the density is accumulated in parallel.
+    GaussianDensityEngine m_engine;        //!< Algorithm used to evaluate the density.
+    MassAssignment m_assignment;           //!< Scheme used by gaussian_fft to assign points.
+
+    util::ManagedArray<float> m_density_array;         //! Computed density array.
+    util::ParallelAccumulator<float> m_local_density; //!< Contributions of each thread to the density.
 };
 
 }; }; // end namespace freud::density
@@ -1,8 +1,12 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <stdexcept>
+#include <vector>
+
 #include "LocalDensity.h"
 #include "NeighborComputeFunctional.h"
+#include "ParallelAccumulator.h"
 
 /*! \file LocalDensity.cc
     \brief Routines for computing local density around a point.
@@ -11,56 +15,150 @@
 namespace freud { namespace density {
 
 LocalDensity::LocalDensity(float r_max, float diameter)
-    : m_box(box::Box()), m_r_max(r_max), m_diameter(diameter)
+    : LocalDensity(std::vector<float>(1, r_max), diameter)
 {}
 
+LocalDensity::LocalDensity(const std::vector<float>& r_maxs, float diameter)
+    : m_box(box::Box()), m_r_maxs(r_maxs), m_diameter(diameter)
+{
+    if (m_r_maxs.empty())
+    {
+        throw std::invalid_argument("LocalDensity requires at least one value of r_max.");
+    }
+    for (size_t k = 1; k < m_r_maxs.size(); ++k)
+    {
+        if (m_r_maxs[k] <= m_r_maxs[k - 1])
+        {
+            throw std::invalid_argument("LocalDensity requires the values of r_max to be increasing.");
+        }
+    }
+    for (const float r_max : m_r_maxs)
+    {
+        m_inner_radii.push_back(r_max - m_diameter / float(2.0));
+        m_outer_radii.push_back(r_max + m_diameter / float(2.0));
+    }
+}
+
 LocalDensity::~LocalDensity() {}
 
 void LocalDensity::compute(const freud::locality::NeighborQuery* neighbor_query,
                            const vec3<float>* query_points, unsigned int n_query_points,
                            const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
 {
-    m_box = neighbor_query->getBox();
+    util::profiling::ScopedTimer timer("LocalDensity::compute");
+    prepare(neighbor_query, n_query_points);
+    const size_t num_r = m_r_maxs.size();
+
+    if (freud::locality::isHalfNeighbors(nlist, qargs))
+    {
+        // Each bond of a half list is a neighbor of both of its points.
+        util::ParallelAccumulator<float> num_neighbors(n_query_points * num_r);
+        freud::locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist,
+                                           [&](const freud::locality::NeighborBond& nb) {
+                                               addWeightDeltas(nb.distance, [&](unsigned int k, float delta) {
+                                                   num_neighbors.add(nb.query_point_idx * num_r + k, delta);
+                                                   num_neighbors.add(nb.point_idx * num_r + k, delta);
+                                               });
+                                           });
+        num_neighbors.reduceInto(m_num_neighbors_array);
+
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                finishPoint(i);
+            }
+        });
+        return;
+    }
 
-    m_density_array.prepare(n_query_points);
-    m_num_neighbors_array.prepare(n_query_points);
+    const freud::locality::QueryArgs resolved_qargs = neighbor_query->resolveQueryArgs(qargs);
+    if (nlist == nullptr && num_r == 1 && m_diameter == 0
+        && resolved_qargs.mode == freud::locality::QueryArgs::ball && resolved_qargs.r_max <= m_r_maxs[0])
+    {
+        // Point particles within r_max count fully, so the neighbors are
+        // counted without finding their bonds.
+        freud::locality::QueryArgs count_qargs(resolved_qargs);
+        count_qargs.mode = freud::locality::QueryArgs::count;
+        std::vector<unsigned int> counts(n_query_points);
+        neighbor_query->queryCounts(query_points, n_query_points, count_qargs, counts.data());
+
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_num_neighbors_array[i] = static_cast<float>(counts[i]);
+                m_density_array[i] = m_num_neighbors_array[i] / m_sphere_volumes[0];
+            }
+        });
+        return;
+    }
 
-    const float area = M_PI * m_r_max * m_r_max;
-    const float volume = float(4.0 / 3.0) * M_PI * m_r_max * m_r_max * m_r_max;
     // compute the local density
     freud::locality::loopOverNeighborsIterator(
         neighbor_query, query_points, n_query_points, qargs, nlist,
         [=](size_t i, std::shared_ptr<freud::locality::NeighborPerPointIterator> ppiter) {
-            float num_neighbors = 0;
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
-            {
-                // count particles that are fully in the r_max sphere
-                if (nb.distance < (m_r_max - m_diameter / float(2.0)))
-                {
-                    num_neighbors += float(1.0);
-                }
-                else
-                {
-                    // partially count particles that intersect the r_max sphere
-                    // this is not particularly accurate for a single particle, but works well on average for
-                    // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
-                    // that obscure data
-                    num_neighbors
-                        += float(1.0) + (m_r_max - (nb.distance + m_diameter / float(2.0))) / m_diameter;
-                }
-                m_num_neighbors_array[i] = num_neighbors;
-                if (m_box.is2D())
-                {
-                    // local density is area of particles divided by the area of the circle
-                    m_density_array[i] = m_num_neighbors_array[i] / area;
-                }
-                else
-                {
-                    // local density is volume of particles divided by the volume of the sphere
-                    m_density_array[i] = m_num_neighbors_array[i] / volume;
-                }
-            }
-        });
+            computePoint(i, *ppiter);
+        },
+        true, m_schedule);
+}
+
+void LocalDensity::prepare(const freud::locality::NeighborQuery* neighbor_query, unsigned int n_query_points)
+{
+    m_box = neighbor_query->getBox();
+
+    m_sphere_volumes.clear();
+    for (const float r_max : m_r_maxs)
+    {
+        m_sphere_volumes.push_back(getSphereVolume(r_max));
+    }
+
+    // A single r_max keeps the one-dimensional arrays of one value per point.
+    if (m_r_maxs.size() == 1)
+    {
+        m_density_array.prepare(n_query_points);
+        m_num_neighbors_array.prepare(n_query_points);
+    }
+    else
+    {
+        m_density_array.prepare({n_query_points, m_r_maxs.size()});
+        m_num_neighbors_array.prepare({n_query_points, m_r_maxs.size()});
+    }
+}
+
+float LocalDensity::getSphereVolume(float r) const
+{
+    if (m_box.is2D())
+    {
+        // local density is area of particles divided by the area of the circle
+        return M_PI * r * r;
+    }
+    // local density is volume of particles divided by the volume of the sphere
+    return float(4.0 / 3.0) * M_PI * r * r * r;
+}
+
+void LocalDensity::computePoint(size_t i, freud::locality::NeighborPerPointIterator& ppiter)
+{
+    // The weight deltas are summed in place of the numbers of neighbors.
+    float* num_neighbors = &m_num_neighbors_array[i * m_r_maxs.size()];
+    for (freud::locality::NeighborBond nb = ppiter.next(); !ppiter.end(); nb = ppiter.next())
+    {
+        addWeightDeltas(nb.distance,
+                        [num_neighbors](unsigned int k, float delta) { num_neighbors[k] += delta; });
+    }
+    finishPoint(i);
+}
+
+void LocalDensity::finishPoint(size_t i)
+{
+    const size_t num_r = m_r_maxs.size();
+    float* num_neighbors = &m_num_neighbors_array[i * num_r];
+    float* density = &m_density_array[i * num_r];
+    float num_neighbors_k = 0;
+    for (size_t k = 0; k < num_r; ++k)
+    {
+        num_neighbors_k += num_neighbors[k];
+        num_neighbors[k] = num_neighbors_k;
+        density[k] = num_neighbors_k / m_sphere_volumes[k];
+    }
 }
 
 }; }; // end namespace freud::density
@@ -4,11 +4,17 @@
 #ifndef LOCAL_DENSITY_H
 #define LOCAL_DENSITY_H
 
+#include <algorithm>
+#include <vector>
+
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
+#include "NeighborPerPointIterator.h"
+#include "NeighborPipeline.h"
 #include "NeighborQuery.h"
 #include "VectorMath.h"
+#include "utils.h"
 
 /*! \file LocalDensity.h
     \brief Routines for computing local density around a point.
@@ -17,7 +23,13 @@
 namespace freud { namespace density {
 
 //! Compute the local density at each point
-/*!
+/*! The density can be computed for several values of r_max from the bonds
+ *  of a single query at the largest r_max. Each bond adds the differences
+ *  between its weights at consecutive values of r_max, which are zero
+ *  except where the sphere of the neighbor crosses one of the cutoffs, and
+ *  the weights of each point are recovered with a prefix sum. The cost per
+ *  bond is then a binary search over the cutoffs rather than a weight per
+ *  cutoff.
  */
 class LocalDensity
 {
@@ -25,6 +37,12 @@ public:
     //! Constructor
     LocalDensity(float r_max, float diameter);
 
+    //! Constructor for several values of r_max
+    /*! \param r_maxs Maximum neighbor distances, in increasing order.
+     *  \param diameter Diameter of the particles.
+     */
+    LocalDensity(const std::vector<float>& r_maxs, float diameter);
+
     //! Destructor
     ~LocalDensity();
 
@@ -34,10 +52,22 @@ public:
         return m_box;
     }
 
-    //! Return the cutoff distance.
+    //! Return the largest cutoff distance.
     float getRMax() const
     {
-        return m_r_max;
+        return m_r_maxs.back();
+    }
+
+    //! Return the cutoff distances.
+    const std::vector<float>& getRMaxs() const
+    {
+        return m_r_maxs;
+    }
+
+    //! Return the number of cutoff distances.
+    unsigned int getNumRMax() const
+    {
+        return m_r_maxs.size();
     }
 
     //! Return the cutoff distance.
@@ -46,32 +76,134 @@ public:
         return m_diameter;
     }
 
+    //! Set how query points are split among threads
+    void setLoopSchedule(const util::LoopSchedule& schedule)
+    {
+        m_schedule = schedule;
+    }
+
+    //! Get how query points are split among threads
+    const util::LoopSchedule& getLoopSchedule() const
+    {
+        return m_schedule;
+    }
+
     //! Compute the local density
+    /*! Half neighbor lists (see QueryArgs::half) count each bond as a
+     *  neighbor of both of its points.
+     */
     void compute(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                  unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                  freud::locality::QueryArgs qargs);
 
-    //! Get a reference to the last computed density
+    //! Allocate and zero the output arrays for a new computation
+    void prepare(const freud::locality::NeighborQuery* neighbor_query, unsigned int n_query_points);
+
+    //! Compute the local density of one query point from its neighbors
+    void computePoint(size_t i, freud::locality::NeighborPerPointIterator& ppiter);
+
+    //! Get a reference to the last computed density, with one column per r_max
     const util::ManagedArray<float>& getDensity() const
     {
         return m_density_array;
     }
 
-    //! Get a reference to the last computed number of neighbors
+    //! Get a reference to the last computed number of neighbors, with one column per r_max
     const util::ManagedArray<float>& getNumNeighbors() const
     {
         return m_num_neighbors_array;
     }
 
 private:
-    box::Box m_box;   //!< Simulation box where the particles belong
-    float m_r_max;    //!< Maximum neighbor distance
-    float m_diameter; //!< Diameter of the particles
+    //! Number of particles counted for a neighbor at a distance from the k-th cutoff's center.
+    /*! The neighbor must intersect the sphere of radius r_maxs[k], otherwise
+     *  it counts fully or not at all.
+     */
+    float partialWeight(unsigned int k, float distance) const
+    {
+        // this is not particularly accurate for a single particle, but works well on average for
+        // lots of them. It smooths out the neighbor count distributions and avoids noisy spikes
+        // that obscure data
+        return float(1.0) + (m_r_maxs[k] - (distance + m_diameter / float(2.0))) / m_diameter;
+    }
+
+    //! Call add(k, delta) with the differences between the weights of a neighbor at consecutive cutoffs.
+    /*! The weight of the neighbor at cutoff k is the sum of the deltas of
+     *  the cutoffs up to k. Neighbors fully within the smallest cutoff only
+     *  add 1 to k = 0.
+     */
+    template<typename AddDelta> void addWeightDeltas(float distance, const AddDelta& add) const
+    {
+        // Cutoffs before first do not reach the neighbor, and cutoffs from
+        // full on fully contain it.
+        unsigned int k = static_cast<unsigned int>(
+            std::upper_bound(m_outer_radii.begin(), m_outer_radii.end(), distance) - m_outer_radii.begin());
+        const unsigned int full = static_cast<unsigned int>(
+            std::upper_bound(m_inner_radii.begin(), m_inner_radii.end(), distance) - m_inner_radii.begin());
+        float previous = 0;
+        for (; k < full; ++k)
+        {
+            const float weight = partialWeight(k, distance);
+            add(k, weight - previous);
+            previous = weight;
+        }
+        if (full < m_r_maxs.size())
+        {
+            add(full, float(1.0) - previous);
+        }
+    }
+
+    //! Turn the weight deltas of one point into its numbers of neighbors and densities.
+    void finishPoint(size_t i);
+
+    //! Volume of a sphere of radius r, or area of the circle in 2D
+    float getSphereVolume(float r) const;
+
+    box::Box m_box;                   //!< Simulation box where the particles belong
+    std::vector<float> m_r_maxs;      //!< Maximum neighbor distances, in increasing order
+    float m_diameter;                 //!< Diameter of the particles
+    std::vector<float> m_inner_radii; //!< Distances below which neighbors are fully inside each cutoff
+    std::vector<float> m_outer_radii; //!< Distances from which neighbors are fully outside each cutoff
+    std::vector<float> m_sphere_volumes; //!< Volume of the sphere of each cutoff
+
+    util::LoopSchedule m_schedule; //!< How query points are split among threads
 
     util::ManagedArray<float> m_density_array;       //!< density array computed
     util::ManagedArray<float> m_num_neighbors_array; //!< number of neighbors array computed
 };
 
+//! Adapter running a LocalDensity as a stage of a NeighborPipeline.
+/*! Neighbors farther than the largest r_max + diameter / 2 do not overlap
+ *  any sphere and are not passed to the LocalDensity.
+ */
+class LocalDensityPipelineStage : public locality::NeighborPipelineStage
+{
+public:
+    //! Constructor
+    explicit LocalDensityPipelineStage(LocalDensity* local_density) : m_local_density(local_density) {}
+
+    virtual float getRMax() const
+    {
+        return m_local_density->getRMax() + m_local_density->getDiameter() / float(2.0);
+    }
+
+    virtual void begin(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                       unsigned int n_query_points)
+    {
+        m_local_density->prepare(neighbor_query, n_query_points);
+    }
+
+    virtual void visitPoint(size_t query_point_idx, locality::NeighborPerPointIterator& ppiter)
+    {
+        m_local_density->computePoint(query_point_idx, ppiter);
+    }
+
+    virtual void end() {}
+
+private:
+    LocalDensity* m_local_density; //!< The LocalDensity being computed.
+};
+
 }; }; // end namespace freud::density
 
 #endif // LOCAL_DENSITY_H
@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "RDF.h"
@@ -11,8 +12,8 @@
 
 namespace freud { namespace density {
 
-RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
-    : BondHistogramCompute(), m_normalize(normalize)
+RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize, unsigned int n_types)
+    : BondHistogramCompute(), m_normalize(normalize), m_n_types(n_types)
 {
     if (bins == 0)
         throw std::invalid_argument("RDF requires a nonzero number of bins.");
@@ -27,6 +28,19 @@ RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
     m_histogram = BondHistogram(axes);
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
 
+    if (m_n_types != 0)
+    {
+        // Types are binned by index, with the bond distance as the last axis.
+        BHAxes partial_axes;
+        partial_axes.push_back(std::make_shared<util::RegularAxis>(m_n_types, 0, m_n_types));
+        partial_axes.push_back(std::make_shared<util::RegularAxis>(m_n_types, 0, m_n_types));
+        partial_axes.push_back(axes[0]);
+        m_partial_histogram = BondHistogram(partial_axes);
+        m_local_partial_histograms = BondHistogram::ThreadLocalHistogram(m_partial_histogram);
+        m_partial_norms.assign(m_n_types * m_n_types, 0);
+        m_query_type_counts.assign(m_n_types, 0);
+    }
+
     // Precompute the cell volumes to speed up later calculations.
     m_vol_array2D.prepare(bins);
     m_vol_array3D.prepare(bins);
@@ -42,15 +56,79 @@ RDF::RDF(unsigned int bins, float r_max, float r_min, bool normalize)
     }
 }
 
+void RDF::saveState(util::BinaryWriter& writer)
+{
+    BondHistogramCompute::saveState(writer);
+    writer.write<uint32_t>(m_n_types);
+    if (m_n_types != 0)
+    {
+        util::ManagedArray<unsigned int> partial_counts(m_partial_histogram.shape());
+        m_local_partial_histograms.reduceInto(partial_counts);
+        writer.writeArray(partial_counts.get(), partial_counts.size());
+        writer.writeArray(m_partial_norms);
+        writer.writeArray(m_query_type_counts);
+    }
+}
+
+void RDF::loadState(util::BinaryReader& reader)
+{
+    BondHistogramCompute::loadState(reader);
+    if (reader.read<uint32_t>() != m_n_types)
+    {
+        throw std::invalid_argument("The serialized state has a different number of types than this RDF.");
+    }
+    if (m_n_types != 0)
+    {
+        util::ManagedArray<unsigned int> partial_counts(m_partial_histogram.shape());
+        reader.readArray(partial_counts.get(), partial_counts.size());
+        std::vector<double> partial_norms(m_partial_norms.size());
+        reader.readArray(partial_norms.data(), partial_norms.size());
+        std::vector<double> query_type_counts(m_query_type_counts.size());
+        reader.readArray(query_type_counts.data(), query_type_counts.size());
+
+        m_local_partial_histograms.add(partial_counts.get());
+        for (size_t i = 0; i < partial_norms.size(); ++i)
+        {
+            m_partial_norms[i] += partial_norms[i];
+        }
+        for (size_t i = 0; i < query_type_counts.size(); ++i)
+        {
+            m_query_type_counts[i] += query_type_counts[i];
+        }
+    }
+}
+
+void RDF::reset()
+{
+    BondHistogramCompute::reset();
+    if (m_n_types != 0)
+    {
+        m_local_partial_histograms.reset();
+    }
+    std::fill(m_partial_norms.begin(), m_partial_norms.end(), 0);
+    std::fill(m_query_type_counts.begin(), m_query_type_counts.end(), 0);
+}
+
+void RDF::setAccumulationStrategy(util::AccumulationStrategy strategy)
+{
+    if (m_n_types != 0)
+    {
+        m_local_partial_histograms = BondHistogram::ThreadLocalHistogram(m_partial_histogram, strategy);
+    }
+    BondHistogramCompute::setAccumulationStrategy(strategy);
+}
+
 void RDF::reduce()
 {
+    util::profiling::ScopedTimer timer("RDF::reduce");
     m_pcf.prepare(getAxisSizes()[0]);
     m_histogram.prepare(getAxisSizes()[0]);
     m_N_r.prepare(getAxisSizes()[0]);
 
     // Define prefactors with appropriate types to simplify and speed later code.
     float number_density = float(m_n_query_points) / m_box.getVolume();
-    if (m_normalize)
+    // Points and query points of different types are never the same point, so no bonds are excluded.
+    if (m_normalize && m_same_types)
     {
         number_density *= static_cast<float>(m_n_query_points - 1) / (m_n_query_points);
     }
@@ -70,16 +148,229 @@ void RDF::reduce()
     {
         m_N_r[i] = m_N_r[i - 1] + m_histogram[i] * prefactor;
     }
+
+    if (m_n_types != 0)
+    {
+        reducePartial(vol_array);
+    }
+}
+
+void RDF::reducePartial(const util::ManagedArray<float>& vol_array)
+{
+    const size_t bins = getAxisSizes()[0];
+    m_partial_pcf.prepare({m_n_types, m_n_types, bins});
+    m_partial_N_r.prepare({m_n_types, m_n_types, bins});
+    m_partial_histogram.prepare({m_n_types, m_n_types, bins});
+
+    // Pairs of types without expected bonds, such as types without points,
+    // are left at zero.
+    m_partial_histogram.reduceOverThreadsPerBin(m_local_partial_histograms, [&](size_t i) {
+        const double norm = m_partial_norms[i / bins];
+        if (norm > 0)
+        {
+            m_partial_pcf[i] = static_cast<float>(m_partial_histogram[i] / (norm * vol_array[i % bins]));
+        }
+    });
+
+    // The cumulative sums of each pair of types are independent.
+    util::forLoopWrapper(0, m_n_types * m_n_types, [&](size_t begin, size_t end) {
+        for (size_t pair = begin; pair < end; ++pair)
+        {
+            const double query_count = m_query_type_counts[pair / m_n_types];
+            if (query_count == 0)
+            {
+                continue;
+            }
+            double cumulative_count = 0;
+            for (size_t i = 0; i < bins; ++i)
+            {
+                cumulative_count += m_partial_histogram[pair * bins + i];
+                m_partial_N_r[pair * bins + i] = static_cast<float>(cumulative_count / query_count);
+            }
+        }
+    });
+}
+
+void RDF::addPartialNormalization(const unsigned int* point_types, unsigned int n_points,
+                                  const unsigned int* query_point_types, unsigned int n_query_points,
+                                  const box::Box& box)
+{
+    std::vector<double> point_type_counts(m_n_types, 0);
+    std::vector<double> query_type_counts(m_n_types, 0);
+    for (unsigned int j = 0; j < n_points; ++j)
+    {
+        if (point_types[j] >= m_n_types)
+        {
+            throw std::invalid_argument("The point types must be less than the number of types.");
+        }
+        point_type_counts[point_types[j]]++;
+    }
+    for (unsigned int i = 0; i < n_query_points; ++i)
+    {
+        if (query_point_types[i] >= m_n_types)
+        {
+            throw std::invalid_argument("The query point types must be less than the number of types.");
+        }
+        query_type_counts[query_point_types[i]]++;
+    }
+
+    // Each query point of type a expects the number density of points of
+    // type b, excluding itself from its own type if normalized, as the
+    // total RDF does.
+    for (unsigned int a = 0; a < m_n_types; ++a)
+    {
+        m_query_type_counts[a] += query_type_counts[a];
+        for (unsigned int b = 0; b < m_n_types; ++b)
+        {
+            const double n_b = point_type_counts[b] - ((m_normalize && a == b && n_points > 0) ? 1 : 0);
+            m_partial_norms[a * m_n_types + b] += query_type_counts[a] * std::max(n_b, 0.0) / box.getVolume();
+        }
+    }
 }
 
+//! Accumulates the bond distances of one block of work into the RDF histogram.
+/*! The bonds of half neighbor lists are counted twice, once for each
+ *  direction of the pair.
+ */
+class RDFBlock
+{
+public:
+    RDFBlock(const util::Histogram<unsigned int>& histogram,
+             util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms, bool half)
+        : m_histogram(histogram), m_block(local_histograms), m_half(half)
+    {}
+
+    void operator()(const freud::locality::NeighborBond& neighbor_bond)
+    {
+        if (m_half)
+        {
+            size_t bin;
+            m_histogram.bin(&neighbor_bond.distance, 1, &bin);
+            m_block.increment(bin, 2);
+        }
+        else
+        {
+            m_block.buffer(neighbor_bond.distance);
+        }
+    }
+
+    void finish()
+    {
+        m_block.finish();
+    }
+
+private:
+    const util::Histogram<unsigned int>& m_histogram;                        //!< Histogram for binning.
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_block; //!< Privatized bin counts.
+    bool m_half;                                                             //!< Whether bonds count twice.
+};
+
+//! Accumulates one block of bonds into the total RDF histogram and the partial RDF histogram.
+/*! Each bond distance is binned once, and the bin is offset into the
+ *  partial histogram by the pair of types of the bond. The bonds of half
+ *  neighbor lists count once for each direction, with the types swapped.
+ */
+class PartialRDFBlock
+{
+public:
+    PartialRDFBlock(const util::Histogram<unsigned int>& histogram,
+                    util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms,
+                    util::Histogram<unsigned int>::ThreadLocalHistogram& local_partial_histograms,
+                    const unsigned int* point_types, const unsigned int* query_point_types,
+                    unsigned int n_types, bool half)
+        : m_histogram(histogram), m_block(local_histograms), m_partial_block(local_partial_histograms),
+          m_point_types(point_types), m_query_point_types(query_point_types), m_n_types(n_types),
+          m_bins(histogram.size()), m_half(half)
+    {}
+
+    void operator()(const freud::locality::NeighborBond& neighbor_bond)
+    {
+        size_t bin;
+        m_histogram.bin(&neighbor_bond.distance, 1, &bin);
+        if (bin == util::Axis::OVERFLOW_BIN)
+        {
+            return;
+        }
+        const unsigned int query_point_type = m_query_point_types[neighbor_bond.query_point_idx];
+        const unsigned int point_type = m_point_types[neighbor_bond.point_idx];
+        m_partial_block.increment((query_point_type * m_n_types + point_type) * m_bins + bin);
+        if (m_half)
+        {
+            m_block.increment(bin, 2);
+            // The query points of half queries are the points.
+            const unsigned int reverse_pair
+                = point_type * m_n_types + m_point_types[neighbor_bond.query_point_idx];
+            m_partial_block.increment(reverse_pair * m_bins + bin);
+        }
+        else
+        {
+            m_block.increment(bin);
+        }
+    }
+
+    void finish()
+    {
+        m_block.finish();
+        m_partial_block.finish();
+    }
+
+private:
+    const util::Histogram<unsigned int>& m_histogram; //!< Total histogram for binning.
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_block; //!< Privatized total counts.
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock
+        m_partial_block;                    //!< Privatized partial counts.
+    const unsigned int* m_point_types;       //!< Type of each point.
+    const unsigned int* m_query_point_types; //!< Type of each query point.
+    unsigned int m_n_types;                  //!< Number of types.
+    size_t m_bins;                           //!< Number of distance bins.
+    bool m_half;                             //!< Whether bonds count twice.
+};
+
 void RDF::accumulate(const freud::locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
                      unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                      freud::locality::QueryArgs qargs)
 {
-    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
-                      [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          m_local_histograms(neighbor_bond.distance);
-                      });
+    accumulate(neighbor_query, nullptr, query_points, nullptr, n_query_points, nlist, qargs);
+}
+
+void RDF::accumulate(const freud::locality::NeighborQuery* neighbor_query, const unsigned int* point_types,
+                     const vec3<float>* query_points, const unsigned int* query_point_types,
+                     unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                     freud::locality::QueryArgs qargs)
+{
+    const bool half = freud::locality::isHalfNeighbors(nlist, qargs);
+    if (m_n_types == 0)
+    {
+        accumulateBlocks(neighbor_query, query_points, n_query_points, nlist, qargs,
+                         [this, half]() { return RDFBlock(m_histogram, m_local_histograms, half); });
+        return;
+    }
+
+    if (point_types == nullptr || query_point_types == nullptr)
+    {
+        throw std::invalid_argument("Partial RDFs require the types of the points and query points.");
+    }
+    addPartialNormalization(point_types, neighbor_query->getNPoints(), query_point_types, n_query_points,
+                            neighbor_query->getBox());
+    accumulateBlocks(neighbor_query, query_points, n_query_points, nlist, qargs, [&]() {
+        return PartialRDFBlock(m_histogram, m_local_histograms, m_local_partial_histograms, point_types,
+                               query_point_types, m_n_types, half);
+    });
+    m_local_partial_histograms.flush();
+}
+
+void RDF::accumulateTrajectory(const freud::locality::Trajectory& trajectory,
+                               freud::locality::QueryArgs qargs, bool parallel_frames)
+{
+    if (m_n_types != 0)
+    {
+        throw std::invalid_argument("Partial RDFs require the types of the points and query points.");
+    }
+    accumulateFrames(trajectory, parallel_frames,
+                     [&](const freud::locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                         accumulate(neighbor_query, trajectory.getPoints(frame), trajectory.getNPoints(),
+                                    nullptr, qargs);
+                     });
 }
 
 }; }; // end namespace freud::density
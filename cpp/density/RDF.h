@@ -4,24 +4,57 @@
 #ifndef RDF_H
 #define RDF_H
 
+#include <stdexcept>
+#include <vector>
+
 #include "BondHistogramCompute.h"
 #include "Box.h"
 #include "Histogram.h"
+#include "NeighborPipeline.h"
+#include "Trajectory.h"
 
 /*! \file RDF.h
     \brief Routines for computing radial density functions.
 */
 
 namespace freud { namespace density {
+
+//! Computes the radial distribution function of bond distances.
+/*! If the number of types is nonzero, the partial RDFs of every pair of
+ *  query point type and point type are accumulated from the same bonds as
+ *  the total RDF, into a histogram of shape (n_types, n_types, bins).
+ *
+ *  Several RDFs with different bins or cutoffs can share one neighbor
+ *  traversal at the largest cutoff by running them as stages of a
+ *  NeighborPipeline.
+ */
 class RDF : public locality::BondHistogramCompute
 {
 public:
     //! Constructor
-    RDF(unsigned int bins, float r_max, float r_min = 0, bool normalize = false);
+    /*! \param bins Number of bins.
+     *  \param r_max Maximum bond distance.
+     *  \param r_min Minimum bond distance.
+     *  \param normalize Whether the RDF should tend to 1 (see m_normalize).
+     *  \param n_types Number of types of the partial RDFs, or 0 to only compute the total RDF.
+     */
+    RDF(unsigned int bins, float r_max, float r_min = 0, bool normalize = false, unsigned int n_types = 0);
 
     //! Destructor
     virtual ~RDF() {};
 
+    //! Reset the RDF arrays to all zeros
+    virtual void reset();
+
+    //! Set how bonds are accumulated in parallel, resetting the histograms.
+    virtual void setAccumulationStrategy(util::AccumulationStrategy strategy);
+
+    //! Return the name identifying RDFs in serialized states.
+    virtual std::string getStateName() const
+    {
+        return "RDF";
+    }
+
     //! Compute the RDF
     /*! Accumulate the given points to the histogram. Accumulation is performed
      * in parallel on thread-local copies of the data, which are reduced into
@@ -31,6 +64,30 @@ public:
                     unsigned int n_query_points, const freud::locality::NeighborList* nlist,
                     freud::locality::QueryArgs qargs);
 
+    //! Compute the total and partial RDFs
+    /*! \param neighbor_query NeighborQuery of the points.
+     *  \param point_types Type of each point, less than the number of types.
+     *  \param query_points The query points.
+     *  \param query_point_types Type of each query point, less than the number of types.
+     *  \param n_query_points Number of query points.
+     *  \param nlist NeighborList of the bonds, or NULL to query neighbor_query with qargs.
+     *  \param qargs Query arguments, used if nlist is NULL.
+     */
+    void accumulate(const freud::locality::NeighborQuery* neighbor_query, const unsigned int* point_types,
+                    const vec3<float>* query_points, const unsigned int* query_point_types,
+                    unsigned int n_query_points, const freud::locality::NeighborList* nlist,
+                    freud::locality::QueryArgs qargs);
+
+    //! Accumulate all frames of a trajectory, using the points of each frame as query points.
+    void accumulateTrajectory(const freud::locality::Trajectory& trajectory,
+                              freud::locality::QueryArgs qargs, bool parallel_frames = false);
+
+    //! Add a single bond to the histogram.
+    void accumulateBond(const freud::locality::NeighborBond& neighbor_bond)
+    {
+        m_local_histograms.buffer(neighbor_bond.distance);
+    }
+
     //! Reduce thread-local arrays onto the primary data arrays.
     virtual void reduce();
 
@@ -50,9 +107,47 @@ public:
         return reduceAndReturn(m_N_r);
     }
 
+    //! Get the number of types of the partial RDFs, or 0 if they are not computed.
+    unsigned int getNumTypes() const
+    {
+        return m_n_types;
+    }
+
+    //! Get the partial RDFs, indexed by query point type, point type, and bin.
+    const util::ManagedArray<float>& getPartialRDF()
+    {
+        return reduceAndReturn(m_partial_pcf);
+    }
+
+    //! Get the partial N_r arrays, indexed by query point type, point type, and bin.
+    /*! m_partial_N_r[a][b][i] is the average number of points of type b
+     *  within a ball of radius getBinEdges()[i+1] centered at a query point
+     *  of type a.
+     */
+    const util::ManagedArray<float>& getPartialNr()
+    {
+        return reduceAndReturn(m_partial_N_r);
+    }
+
+protected:
+    //! Write the accumulated state, including the partial histograms and normalizations.
+    virtual void saveState(util::BinaryWriter& writer);
+
+    //! Add the accumulated state written by saveState.
+    virtual void loadState(util::BinaryReader& reader);
+
 private:
+    //! Add the expected numbers of bonds between the types of one frame to the partial normalizations.
+    void addPartialNormalization(const unsigned int* point_types, unsigned int n_points,
+                                 const unsigned int* query_point_types, unsigned int n_query_points,
+                                 const box::Box& box);
+
+    //! Reduce the partial histograms onto the partial RDF and N_r arrays.
+    void reducePartial(const util::ManagedArray<float>& vol_array);
+
     bool m_normalize;                //!< Whether to enforce that the RDF should tend to 1 (instead of
                                      //!< num_query_points/num_points).
+    unsigned int m_n_types;          //!< Number of types of the partial RDFs.
     util::ManagedArray<float> m_pcf; //!< The computed pair correlation function.
     util::ManagedArray<float>
         m_N_r; //!< Cumulative bin sum N(r) (the average number of points in a ball of radius r).
@@ -60,6 +155,56 @@ private:
         m_vol_array2D; //!< Areas of concentric rings corresponding to the histogram bins in 2D.
     util::ManagedArray<float>
         m_vol_array3D; //!< Areas of concentric spherical shells corresponding to the histogram bins in 3D.
+
+    util::Histogram<unsigned int> m_partial_histogram; //!< Bond distances by query point and point type.
+    util::Histogram<unsigned int>::ThreadLocalHistogram
+        m_local_partial_histograms;          //!< Thread local copies of the partial histogram.
+    std::vector<double> m_partial_norms;     //!< Expected bonds per unit volume of each pair of types.
+    std::vector<double> m_query_type_counts; //!< Number of query points of each type, over all frames.
+    util::ManagedArray<float> m_partial_pcf; //!< The partial pair correlation functions.
+    util::ManagedArray<float> m_partial_N_r; //!< The partial cumulative bin sums.
+};
+
+//! Adapter running an RDF as a stage of a NeighborPipeline.
+/*! Each traversal accumulates one frame.
+ */
+class RDFPipelineStage : public locality::NeighborPipelineStage
+{
+public:
+    //! Constructor
+    explicit RDFPipelineStage(RDF* rdf) : m_rdf(rdf), m_r_max(rdf->getBounds()[0].second) {}
+
+    virtual float getRMax() const
+    {
+        return m_r_max;
+    }
+
+    virtual void begin(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                       unsigned int n_query_points)
+    {
+        if (m_rdf->getNumTypes() != 0)
+        {
+            throw std::invalid_argument("Partial RDFs cannot be computed in a NeighborPipeline.");
+        }
+        m_rdf->startFrame(neighbor_query, n_query_points);
+    }
+
+    virtual void visitPoint(size_t query_point_idx, locality::NeighborPerPointIterator& ppiter)
+    {
+        for (locality::NeighborBond nb = ppiter.next(); !ppiter.end(); nb = ppiter.next())
+        {
+            m_rdf->accumulateBond(nb);
+        }
+    }
+
+    virtual void end()
+    {
+        m_rdf->finishFrame();
+    }
+
+private:
+    RDF* m_rdf;    //!< The RDF accumulating the bonds.
+    float m_r_max; //!< The RDF's maximum bond distance.
 };
 
 }; }; // end namespace freud::density
@@ -1,8 +1,10 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 
 #include "SphereVoxelization.h"
 
@@ -12,8 +14,37 @@
 
 namespace freud { namespace density {
 
+namespace {
+
+//! Set the bits [begin, end) of a row of bytes, most significant bit first.
+void setBits(unsigned char* row, unsigned int begin, unsigned int end)
+{
+    for (; begin < end && begin % 8 != 0; ++begin)
+    {
+        row[begin / 8] |= (0x80 >> (begin % 8));
+    }
+    if (end - begin >= 8)
+    {
+        std::fill(row + begin / 8, row + end / 8, 0xFF);
+        begin = end - end % 8;
+    }
+    for (; begin < end; ++begin)
+    {
+        row[begin / 8] |= (0x80 >> (begin % 8));
+    }
+}
+
+//! Get the remainder of a divided by b in [0, b).
+int positiveModulo(int a, int b)
+{
+    const int remainder = a % b;
+    return (remainder < 0) ? remainder + b : remainder;
+}
+
+}; // namespace
+
 SphereVoxelization::SphereVoxelization(vec3<unsigned int> width, float r_max)
-    : m_box(), m_width(width), m_r_max(r_max), m_has_computed(false)
+    : m_box(), m_width(width), m_r_max(r_max), m_has_computed(false), m_packed(false)
 {
     if (r_max <= 0.0f)
         throw std::invalid_argument("SphereVoxelization requires r_max to be positive.");
@@ -25,12 +56,38 @@ const util::ManagedArray<unsigned int>& SphereVoxelization::getVoxels() const
     return m_voxels_array;
 }
 
+//! Get a reference to the last computed packed voxels.
+const util::ManagedArray<unsigned char>& SphereVoxelization::getPackedVoxels() const
+{
+    return m_packed_voxels_array;
+}
+
 //! Get width.
 vec3<unsigned int> SphereVoxelization::getWidth() const
 {
     return m_width;
 }
 
+void SphereVoxelization::fillRun(unsigned int i, unsigned int j, unsigned int k_begin, unsigned int k_end)
+{
+    if (!m_packed)
+    {
+        unsigned int* row = m_voxels_array.get() + (size_t(i) * m_width.y + j) * m_width.z;
+        std::fill(row + k_begin, row + k_end, 1);
+    }
+    else if (m_box.is2D())
+    {
+        // Bits run along y in 2D, since the grid has a single z layer.
+        const size_t row_size = m_packed_voxels_array.shape()[1];
+        setBits(m_packed_voxels_array.get() + i * row_size, j, j + 1);
+    }
+    else
+    {
+        const size_t row_size = m_packed_voxels_array.shape()[2];
+        setBits(m_packed_voxels_array.get() + (size_t(i) * m_width.y + j) * row_size, k_begin, k_end);
+    }
+}
+
 //! Compute the voxels array.
 void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
 {
@@ -57,13 +114,32 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
         m_width.z = 1;
     }
 
-    m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+    // Only the array of the current mode is allocated.
+    if (m_packed)
+    {
+        if (m_box.is2D())
+        {
+            m_packed_voxels_array.prepare({m_width.x, (m_width.y + 7) / 8});
+        }
+        else
+        {
+            m_packed_voxels_array.prepare({m_width.x, m_width.y, (m_width.z + 7) / 8});
+        }
+        m_voxels_array = util::ManagedArray<unsigned int>();
+    }
+    else
+    {
+        m_voxels_array.prepare({m_width.x, m_width.y, m_width.z});
+        m_packed_voxels_array = util::ManagedArray<unsigned char>();
+    }
 
     // set up some constants first
     const float Lx = m_box.getLx();
     const float Ly = m_box.getLy();
     const float Lz = m_box.getLz();
     const vec3<bool> periodic = m_box.getPeriodic();
+    const bool tilted = m_box.getTiltFactorXY() != 0 || m_box.getTiltFactorXZ() != 0
+        || m_box.getTiltFactorYZ() != 0;
 
     const float grid_size_x = Lx / m_width.x;
     const float grid_size_y = Ly / m_width.y;
@@ -74,61 +150,167 @@ void SphereVoxelization::compute(const freud::locality::NeighborQuery* nq)
     const int bin_cut_y = int(m_r_max / grid_size_y);
     const int bin_cut_z = m_box.is2D() ? 0 : int(m_r_max / grid_size_z);
     const float r_max_sq = m_r_max * m_r_max;
+    const int width_x = m_width.x;
+
+    // Sort the points by the x slice containing them with a counting sort.
+    // Points outside of the grid along an aperiodic x axis are assigned to
+    // the nearest slice, which is always within the cutoff of the slices
+    // that their spheres overlap.
+    std::vector<int> point_bins_x(n_points);
+    std::vector<unsigned int> slice_starts(m_width.x + 1, 0);
+    for (unsigned int idx = 0; idx < n_points; ++idx)
+    {
+        const int bin_x = int(((*nq)[idx].x + Lx / 2.0f) / grid_size_x);
+        point_bins_x[idx] = bin_x;
+        const int slice = periodic.x ? positiveModulo(bin_x, width_x)
+                                     : std::min(std::max(bin_x, 0), width_x - 1);
+        ++slice_starts[slice + 1];
+    }
+    for (unsigned int slice = 0; slice < m_width.x; ++slice)
+    {
+        slice_starts[slice + 1] += slice_starts[slice];
+    }
+    std::vector<unsigned int> slice_points(n_points);
+    {
+        std::vector<unsigned int> slice_ends(slice_starts.begin(), slice_starts.end() - 1);
+        for (unsigned int idx = 0; idx < n_points; ++idx)
+        {
+            const int bin_x = point_bins_x[idx];
+            const int slice = periodic.x ? positiveModulo(bin_x, width_x)
+                                         : std::min(std::max(bin_x, 0), width_x - 1);
+            slice_points[slice_ends[slice]++] = idx;
+        }
+    }
 
-    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
-        // for each reference point
-        for (size_t idx = begin; idx < end; ++idx)
+    // Each x slice of the grid is only written by the thread that owns it.
+    util::forLoopWrapper(0, m_width.x, [&](size_t begin, size_t end) {
+        std::vector<float> dz_sq;
+        for (size_t slice = begin; slice < end; ++slice)
         {
-            const vec3<float> point = (*nq)[idx];
-            // Find which bin the particle is in
-            const int bin_x = int((point.x + Lx / 2.0f) / grid_size_x);
-            const int bin_y = int((point.y + Ly / 2.0f) / grid_size_y);
-            // In 2D, only loop over the z=0 plane
-            const int bin_z = m_box.is2D() ? 0 : int((point.z + Lz / 2.0f) / grid_size_z);
-
-            // Only evaluate over bins that are within the cutoff, rejecting bins
-            // that are outside the box in aperiodic directions.
-            for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+            const int i_slice = int(slice);
+
+            // Slices containing points whose spheres may overlap this slice.
+            int first_slice = i_slice - bin_cut_x;
+            int last_slice = i_slice + bin_cut_x;
+            if (periodic.x && 2 * bin_cut_x + 1 >= width_x)
             {
-                if (!periodic.z && (k < 0 || k >= int(m_width.z)))
-                {
-                    continue;
-                }
-                const float dz = float((grid_size_z * k + grid_size_z / 2.0f) - point.z - Lz / 2.0f);
+                first_slice = 0;
+                last_slice = width_x - 1;
+            }
+            else if (!periodic.x)
+            {
+                first_slice = std::max(first_slice, 0);
+                last_slice = std::min(last_slice, width_x - 1);
+            }
 
-                for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
+            for (int source_slice = first_slice; source_slice <= last_slice; ++source_slice)
+            {
+                const unsigned int wrapped_slice = positiveModulo(source_slice, width_x);
+                for (unsigned int p = slice_starts[wrapped_slice]; p < slice_starts[wrapped_slice + 1]; ++p)
                 {
-                    if (!periodic.y && (j < 0 || j >= int(m_width.y)))
+                    const unsigned int idx = slice_points[p];
+                    const vec3<float> point = (*nq)[idx];
+                    const int bin_x = point_bins_x[idx];
+                    const int bin_y = int((point.y + Ly / 2.0f) / grid_size_y);
+                    // In 2D, only loop over the z=0 plane
+                    const int bin_z = m_box.is2D() ? 0 : int((point.z + Lz / 2.0f) / grid_size_z);
+
+                    // Without tilt, each component of a wrapped vector only
+                    // depends on the same component of the vector, so the
+                    // squared z distances are tabulated once per point.
+                    if (!tilted)
                     {
-                        continue;
+                        dz_sq.clear();
+                        for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+                        {
+                            const float dz
+                                = float((grid_size_z * k + grid_size_z / 2.0f) - point.z - Lz / 2.0f);
+                            const float wrapped_dz = m_box.wrap(vec3<float>(0, 0, dz)).z;
+                            dz_sq.push_back(wrapped_dz * wrapped_dz);
+                        }
                     }
-                    const float dy = float((grid_size_y * j + grid_size_y / 2.0f) - point.y - Ly / 2.0f);
 
-                    for (int i = bin_x - bin_cut_x; i <= bin_x + bin_cut_x; i++)
+                    // Unwrapped x indices within the cutoff of the point that
+                    // map to this slice.
+                    int i = i_slice;
+                    if (periodic.x)
+                    {
+                        i = bin_x - bin_cut_x + positiveModulo(i_slice - (bin_x - bin_cut_x), width_x);
+                    }
+                    for (; i <= bin_x + bin_cut_x; i += width_x)
                     {
-                        if (!periodic.x && (i < 0 || i >= int(m_width.x)))
+                        if (i < bin_x - bin_cut_x)
                         {
-                            continue;
+                            break;
                         }
                         const float dx = float((grid_size_x * i + grid_size_x / 2.0f) - point.x - Lx / 2.0f);
+                        const float wrapped_dx = tilted ? 0 : m_box.wrap(vec3<float>(dx, 0, 0)).x;
 
-                        // Calculate the distance from the particle to the grid cell
-                        const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
-
-                        const float r_sq = dot(delta, delta);
-
-                        // Check to see if this distance is within the specified r_max
-                        if (r_sq < r_max_sq)
+                        // Only evaluate over bins that are within the cutoff, rejecting bins
+                        // that are outside the box in aperiodic directions.
+                        for (int j = bin_y - bin_cut_y; j <= bin_y + bin_cut_y; j++)
                         {
-                            // Assure that out of range indices are corrected for storage
-                            // in the array i.e. bin -1 is actually bin 29 for nbins = 30
-                            const unsigned int ni = (i + m_width.x) % m_width.x;
+                            if (!periodic.y && (j < 0 || j >= int(m_width.y)))
+                            {
+                                continue;
+                            }
+                            const float dy
+                                = float((grid_size_y * j + grid_size_y / 2.0f) - point.y - Ly / 2.0f);
+                            const float wrapped_dy = tilted ? 0 : m_box.wrap(vec3<float>(0, dy, 0)).y;
+                            const float dxy_sq = wrapped_dx * wrapped_dx + wrapped_dy * wrapped_dy;
                             const unsigned int nj = (j + m_width.y) % m_width.y;
-                            const unsigned int nk = (k + m_width.z) % m_width.z;
 
-                            // This array value could be written by multiple threads in parallel.
-                            // This is only safe because all threads are writing the same value (1).
-                            m_voxels_array(ni, nj, nk) = 1;
+                            // Occupied voxels with consecutive grid indices are filled as runs.
+                            bool in_run = false;
+                            unsigned int run_begin = 0;
+                            unsigned int run_end = 0;
+                            for (int k = bin_z - bin_cut_z; k <= bin_z + bin_cut_z; k++)
+                            {
+                                if (!periodic.z && (k < 0 || k >= int(m_width.z)))
+                                {
+                                    continue;
+                                }
+
+                                float r_sq;
+                                if (!tilted)
+                                {
+                                    // Same evaluation order as dot(delta, delta).
+                                    r_sq = dxy_sq + dz_sq[k - (bin_z - bin_cut_z)];
+                                }
+                                else
+                                {
+                                    const float dz = float((grid_size_z * k + grid_size_z / 2.0f) - point.z
+                                                           - Lz / 2.0f);
+                                    const vec3<float> delta = m_box.wrap(vec3<float>(dx, dy, dz));
+                                    r_sq = dot(delta, delta);
+                                }
+
+                                if (r_sq < r_max_sq)
+                                {
+                                    const unsigned int nk = (k + m_width.z) % m_width.z;
+                                    if (in_run && nk == run_end)
+                                    {
+                                        ++run_end;
+                                        continue;
+                                    }
+                                    if (in_run)
+                                    {
+                                        fillRun(i_slice, nj, run_begin, run_end);
+                                    }
+                                    in_run = true;
+                                    run_begin = nk;
+                                    run_end = nk + 1;
+                                }
+                            }
+                            if (in_run)
+                            {
+                                fillRun(i_slice, nj, run_begin, run_end);
+                            }
+                        }
+
+                        if (!periodic.x)
+                        {
+                            break;
                         }
                     }
                 }
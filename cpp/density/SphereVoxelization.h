@@ -22,6 +22,14 @@ namespace freud { namespace density {
     otherwise. The dimensions of the grid are set in the constructor, and can
     either be set equally for all dimensions or for each dimension
     independently.
+
+    The grid is partitioned among threads by slices along x, and each thread
+    writes all voxels of its slices for the spheres that overlap them, so no
+    voxel is written by more than one thread. Voxels along the last grid
+    axis are filled in runs. In packed mode the grid is stored with one bit
+    per voxel, in the layout of numpy.packbits along the last axis of the
+    grid (z in 3D and y in 2D, most significant bit first), which uses 32
+    times less memory than the unpacked grid.
 */
 class SphereVoxelization
 {
@@ -44,21 +52,41 @@ public:
         return m_r_max;
     }
 
+    //! Set whether the voxels are stored with one bit per voxel.
+    void setPacked(bool packed)
+    {
+        m_packed = packed;
+    }
+
+    //! Get whether the voxels are stored with one bit per voxel.
+    bool isPacked() const
+    {
+        return m_packed;
+    }
+
     //! Compute the voxelization.
     void compute(const freud::locality::NeighborQuery* nq);
 
     //! Get a reference to the last computed voxels.
     const util::ManagedArray<unsigned int>& getVoxels() const;
 
+    //! Get a reference to the last computed voxels in packed mode, eight voxels per byte.
+    const util::ManagedArray<unsigned char>& getPackedVoxels() const;
+
     vec3<unsigned int> getWidth() const;
 
 private:
+    //! Mark the voxels (i, j, k) with k in [k_begin, k_end) as occupied.
+    void fillRun(unsigned int i, unsigned int j, unsigned int k_begin, unsigned int k_end);
+
     box::Box m_box;             //!< Simulation box containing the points.
     vec3<unsigned int> m_width; //!< Number of bins in the grid in each dimension.
     float m_r_max;              //!< Sphere radius used for voxelization.
     bool m_has_computed;        //!< Tracks whether a call to compute has been made.
+    bool m_packed;              //!< Whether the voxels are stored with one bit per voxel.
 
-    util::ManagedArray<unsigned int> m_voxels_array; //! Computed voxels array.
+    util::ManagedArray<unsigned int> m_voxels_array;         //! Computed voxels array.
+    util::ManagedArray<unsigned char> m_packed_voxels_array; //! Computed packed voxels array.
 };
 
 }; }; // end namespace freud::density
@@ -0,0 +1,163 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "DiffractionPattern.h"
+#include "ParallelAccumulator.h"
+#include "utils.h"
+
+/*! \file DiffractionPattern.cc
+    \brief Computes 2D diffraction patterns of points.
+*/
+
+namespace freud { namespace diffraction {
+
+DiffractionPattern::DiffractionPattern(unsigned int output_size)
+    : m_output_size(output_size), m_n_views(0), m_reduce(true)
+{
+    if (output_size == 0)
+    {
+        throw std::invalid_argument("DiffractionPattern requires a positive output size.");
+    }
+    m_diffraction_sum.prepare({m_output_size, m_output_size});
+}
+
+void DiffractionPattern::reset()
+{
+    m_diffraction_sum.prepare({m_output_size, m_output_size});
+    m_n_views = 0;
+    m_reduce = true;
+}
+
+void DiffractionPattern::binPoints(const vec3<float>* points, unsigned int n_points,
+                                   const quat<double>& view_orientation, const double* inv_shear)
+{
+    const unsigned int grid_size = m_fft->getShape().x;
+    util::ParallelAccumulator<double> local_counts(size_t(grid_size) * grid_size);
+
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const vec3<double> point = rotate(view_orientation, vec3<double>(points[i]));
+            // Fractional coordinates of the projected box, wrapped into [0, 1).
+            const double frac_x = util::modulusPositive(
+                inv_shear[0] * point.x + inv_shear[1] * point.y + 0.5, 1.0);
+            const double frac_y = util::modulusPositive(
+                inv_shear[2] * point.x + inv_shear[3] * point.y + 0.5, 1.0);
+            const unsigned int bin_x = std::min(static_cast<unsigned int>(frac_x * grid_size), grid_size - 1);
+            const unsigned int bin_y = std::min(static_cast<unsigned int>(frac_y * grid_size), grid_size - 1);
+            local_counts.add(size_t(bin_x) * grid_size + bin_y, 1.0);
+        }
+    });
+
+    util::ManagedArray<double> counts(size_t(grid_size) * grid_size);
+    local_counts.reduceInto(counts);
+    util::forLoopWrapper(0, counts.size(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_grid[i] = counts[i];
+        }
+    });
+}
+
+void DiffractionPattern::accumulate(const vec3<float>* points, unsigned int n_points,
+                                    const quat<double>& view_orientation, const double* inv_shear,
+                                    unsigned int grid_size, double sigma, const double* inverse_transform)
+{
+    if (grid_size == 0)
+    {
+        throw std::invalid_argument("DiffractionPattern requires a positive grid size.");
+    }
+    if (n_points == 0)
+    {
+        throw std::invalid_argument("DiffractionPattern requires at least one point.");
+    }
+
+    // Transforms and buffers are only rebuilt when the grid size changes.
+    if (!m_fft || m_fft->getShape().x != grid_size)
+    {
+        m_fft.reset(new util::GridFFT(vec3<unsigned int>(grid_size, grid_size, 1)));
+        m_grid.resize(size_t(grid_size) * grid_size);
+        m_structure_factor.resize(size_t(grid_size) * grid_size);
+    }
+
+    binPoints(points, n_points, view_orientation, inv_shear);
+    m_fft->transform(m_grid.data(), false);
+
+    // Multiply by the transform of a Gaussian, exp(-2 pi^2 sigma^2 f^2) for
+    // the frequency f of each axis, and store the squared modulus with the
+    // zero frequency moved to the center of the grid.
+    const double gaussian_factor = -2 * M_PI * M_PI * sigma * sigma / (double(grid_size) * grid_size);
+    const unsigned int half = grid_size / 2;
+    util::forLoopWrapper(0, grid_size, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const double freq_i = (i < (grid_size + 1) / 2) ? double(i) : double(i) - grid_size;
+            const size_t shifted_i = (i + half) % grid_size;
+            for (size_t j = 0; j < grid_size; ++j)
+            {
+                const double freq_j = (j < (grid_size + 1) / 2) ? double(j) : double(j) - grid_size;
+                const size_t shifted_j = (j + half) % grid_size;
+                const std::complex<double> value = m_grid[i * grid_size + j]
+                    * std::exp(gaussian_factor * (freq_i * freq_i + freq_j * freq_j));
+                m_structure_factor[shifted_i * grid_size + shifted_j] = std::norm(value);
+            }
+        }
+    });
+
+    // Zoom and shear the structure factor into the output image with
+    // bilinear interpolation, using zero outside of the grid.
+    const double normalization = 1.0 / (double(n_points) * n_points);
+    const double max_coordinate = double(grid_size) - 1;
+    util::forLoopWrapper(0, m_output_size, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (size_t j = 0; j < m_output_size; ++j)
+            {
+                const double u = inverse_transform[0] * i + inverse_transform[1] * j + inverse_transform[2];
+                const double v = inverse_transform[3] * i + inverse_transform[4] * j + inverse_transform[5];
+                if (u < 0 || u > max_coordinate || v < 0 || v > max_coordinate)
+                {
+                    continue;
+                }
+                const size_t u0 = static_cast<size_t>(u);
+                const size_t v0 = static_cast<size_t>(v);
+                const size_t u1 = std::min(u0 + 1, size_t(grid_size) - 1);
+                const size_t v1 = std::min(v0 + 1, size_t(grid_size) - 1);
+                const double fu = u - double(u0);
+                const double fv = v - double(v0);
+                const double value = (1 - fu) * ((1 - fv) * m_structure_factor[u0 * grid_size + v0]
+                                                 + fv * m_structure_factor[u0 * grid_size + v1])
+                    + fu
+                        * ((1 - fv) * m_structure_factor[u1 * grid_size + v0]
+                           + fv * m_structure_factor[u1 * grid_size + v1]);
+                m_diffraction_sum(i, j) += value * normalization;
+            }
+        }
+    });
+
+    ++m_n_views;
+    m_reduce = true;
+}
+
+const util::ManagedArray<double>& DiffractionPattern::getDiffraction()
+{
+    if (m_reduce)
+    {
+        m_diffraction.prepare({m_output_size, m_output_size});
+        const double scale = (m_n_views > 0) ? 1.0 / m_n_views : 0;
+        util::forLoopWrapper(0, m_diffraction.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_diffraction[i] = m_diffraction_sum[i] * scale;
+            }
+        });
+        m_reduce = false;
+    }
+    return m_diffraction;
+}
+
+}; }; // end namespace freud::diffraction
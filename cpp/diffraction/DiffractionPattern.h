@@ -0,0 +1,100 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef DIFFRACTION_PATTERN_H
+#define DIFFRACTION_PATTERN_H
+
+#include <complex>
+#include <memory>
+#include <vector>
+
+#include "FFT.h"
+#include "ManagedArray.h"
+#include "VectorMath.h"
+
+/*! \file DiffractionPattern.h
+    \brief Computes 2D diffraction patterns of points.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Computes the 2D diffraction pattern of points viewed along an axis.
+/*! Each view rotates the points, projects them onto the plane orthogonal to
+ *  the view axis and bins their fractional coordinates in the projected box
+ *  into a square grid. The squared modulus of the Fourier transform of the
+ *  grid, convolved with a Gaussian through a multiplication in Fourier
+ *  space, is the static structure factor of the view. It is zoomed and
+ *  sheared into the output image by bilinear interpolation and normalized by
+ *  the squared number of points.
+ *
+ *  The diffraction pattern is the average of all views accumulated since the
+ *  last reset, so many view orientations or frames can be combined. The
+ *  transforms and buffers of the grid are kept between views with the same
+ *  grid size.
+ */
+class DiffractionPattern
+{
+public:
+    //! Constructor
+    /*! \param output_size Number of pixels along each axis of the output image.
+     */
+    explicit DiffractionPattern(unsigned int output_size);
+
+    // Destructor
+    ~DiffractionPattern() {}
+
+    //! Reset the accumulated diffraction pattern.
+    void reset();
+
+    //! Add the diffraction pattern of a view of the points.
+    /*! \param points The points.
+     *  \param n_points Number of points.
+     *  \param view_orientation Rotation applied to the points, which are then
+     *         viewed along the z axis.
+     *  \param inv_shear Row-major 2x2 matrix mapping the rotated x and y
+     *         coordinates of a point to fractional coordinates of the
+     *         projected box.
+     *  \param grid_size Number of bins along each axis of the grid.
+     *  \param sigma Width of the Gaussian convolved with the grid, in bins.
+     *  \param inverse_transform Row-major 3x3 matrix in homogeneous
+     *         coordinates mapping output pixel indices to grid coordinates
+     *         of the centered structure factor.
+     */
+    void accumulate(const vec3<float>* points, unsigned int n_points, const quat<double>& view_orientation,
+                    const double* inv_shear, unsigned int grid_size, double sigma,
+                    const double* inverse_transform);
+
+    //! Get the diffraction pattern averaged over the accumulated views.
+    const util::ManagedArray<double>& getDiffraction();
+
+    //! Get the number of pixels along each axis of the output image.
+    unsigned int getOutputSize() const
+    {
+        return m_output_size;
+    }
+
+    //! Get the number of views accumulated since the last reset.
+    unsigned int getNViews() const
+    {
+        return m_n_views;
+    }
+
+private:
+    //! Bin the fractional coordinates of the projected points into m_grid.
+    void binPoints(const vec3<float>* points, unsigned int n_points, const quat<double>& view_orientation,
+                   const double* inv_shear);
+
+    unsigned int m_output_size; //!< Number of pixels along each axis of the output image.
+    unsigned int m_n_views;     //!< Number of views accumulated since the last reset.
+    bool m_reduce;              //!< Whether the average needs to be recomputed.
+
+    std::unique_ptr<util::GridFFT> m_fft;         //!< Transforms of the current grid size.
+    std::vector<std::complex<double>> m_grid;     //!< Binned points and their transform.
+    std::vector<double> m_structure_factor;       //!< Centered structure factor of the current view.
+    util::ManagedArray<double> m_diffraction_sum; //!< Sum of the output images of all views.
+    util::ManagedArray<double> m_diffraction;     //!< Average output image.
+};
+
+}; }; // end namespace freud::diffraction
+
+#endif // DIFFRACTION_PATTERN_H
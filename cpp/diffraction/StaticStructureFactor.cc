@@ -0,0 +1,460 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+#include "ParallelAccumulator.h"
+#include "StaticStructureFactor.h"
+#include "utils.h"
+
+/*! \file StaticStructureFactor.cc
+    \brief Computes the static structure factor of points in direct space.
+*/
+
+namespace freud { namespace diffraction {
+
+namespace {
+
+//! Number of points whose phases are evaluated together.
+const size_t PHASE_BLOCK_SIZE = 256;
+
+//! Evaluate cos(2 pi t) and sin(2 pi t) for n phases t given in turns.
+/*! Each phase is reduced to an angle in [-pi/4, pi/4] and a number of
+ *  quarter turns, and the sine and cosine of the angle are evaluated with
+ *  Taylor polynomials accurate to about 1e-11. The loop has no branches,
+ *  reductions or library calls, so the compiler can vectorize it.
+ */
+inline void evaluatePhases(const double* turns, size_t n, double* cos_values, double* sin_values)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double t = turns[i] - std::rint(turns[i]);
+        const double quarters = std::rint(4 * t);
+        const double x = 2 * M_PI * (t - 0.25 * quarters);
+        const double x2 = x * x;
+        // Taylor polynomials in Horner form, from the highest order.
+        double s = -1.0 / 39916800;
+        s = s * x2 + 1.0 / 362880;
+        s = s * x2 - 1.0 / 5040;
+        s = s * x2 + 1.0 / 120;
+        s = s * x2 - 1.0 / 6;
+        s = (s * x2 + 1) * x;
+        double c = 1.0 / 479001600;
+        c = c * x2 - 1.0 / 3628800;
+        c = c * x2 + 1.0 / 40320;
+        c = c * x2 - 1.0 / 720;
+        c = c * x2 + 1.0 / 24;
+        c = c * x2 - 1.0 / 2;
+        c = c * x2 + 1;
+
+        // Rotate (c, s) by the quarter turns, which are in [-2, 2], using
+        // arithmetic instead of branches: odd quarters swap c and s, and the
+        // signs follow the quadrant.
+        const int q = static_cast<int>(quarters) & 3;
+        const double swap = double(q & 1);
+        const double cos_sign = double(1 - 2 * ((q ^ (q >> 1)) & 1));
+        const double sin_sign = double(1 - 2 * ((q >> 1) & 1));
+        cos_values[i] = cos_sign * ((1 - swap) * c + swap * s);
+        sin_values[i] = sin_sign * ((1 - swap) * s + swap * c);
+    }
+}
+
+//! Mix the bits of a 64 bit integer (the splitmix64 finalizer).
+inline uint64_t mixBits(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+//! Uniform random number in [0, 1) determined by a seed and a lattice vector.
+inline double latticeRandom(unsigned int seed, int n_x, int n_y, int n_z)
+{
+    uint64_t x = mixBits(seed);
+    x = mixBits(x ^ static_cast<uint32_t>(n_x));
+    x = mixBits(x ^ static_cast<uint32_t>(n_y));
+    x = mixBits(x ^ static_cast<uint32_t>(n_z));
+    return double(x >> 11) * (1.0 / double(uint64_t(1) << 53));
+}
+
+//! Bessel function of the first kind of order zero.
+/*! Uses \f$ J_0(x) = \frac{1}{\pi} \int_0^\pi \cos(x \sin t) dt \f$. The
+ *  integrand is smooth and periodic, so the trapezoidal rule converges
+ *  exponentially once the number of nodes exceeds x.
+ */
+inline double besselJ0(double x)
+{
+    const unsigned int n_nodes = static_cast<unsigned int>(std::abs(x)) + 32;
+    double sum = 0;
+    for (unsigned int i = 0; i < n_nodes; ++i)
+    {
+        sum += std::cos(x * std::sin(M_PI * double(i) / double(n_nodes)));
+    }
+    return sum / double(n_nodes);
+}
+
+//! Reciprocal lattice vectors of half of the reciprocal space within a radius.
+/*! The lattice vectors n_x b_x + n_y b_y + n_z b_z are enumerated in lines
+ *  of constant (n_x, n_y), so that lines can be processed in parallel.
+ */
+struct ReciprocalLattice
+{
+    ReciprocalLattice(const box::Box& box, float k_max)
+    {
+        const vec3<float> L = box.getL();
+        const vec3<double> a_x(L.x, 0, 0);
+        const vec3<double> a_y(box.getTiltFactorXY() * L.y, L.y, 0);
+        const vec3<double> a_z = box.is2D()
+            ? vec3<double>(0, 0, 1)
+            : vec3<double>(box.getTiltFactorXZ() * L.z, box.getTiltFactorYZ() * L.z, L.z);
+        const double scale = 2 * M_PI / dot(a_x, cross(a_y, a_z));
+        b[0] = cross(a_y, a_z) * scale;
+        b[1] = cross(a_z, a_x) * scale;
+        b[2] = cross(a_x, a_y) * scale;
+
+        // Since n_i = k . a_i / (2 pi), |n_i| is at most k_max |a_i| / (2 pi).
+        const vec3<double> a[3] = {a_x, a_y, a_z};
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+            n_max[i] = static_cast<int>(std::floor(k_max * std::sqrt(dot(a[i], a[i])) / (2 * M_PI)));
+        }
+        if (box.is2D())
+        {
+            n_max[2] = 0;
+        }
+    }
+
+    //! Number of lines of lattice vectors
+    size_t numLines() const
+    {
+        return size_t(n_max[0] + 1) * size_t(2 * n_max[1] + 1);
+    }
+
+    //! Call body(n_x, n_y, n_z, k) for the lattice vectors of a line.
+    /*! Only one of each pair of opposite vectors is used, and the zero
+     *  vector is skipped.
+     */
+    template<typename Body> void forEachInLine(size_t line, const Body& body) const
+    {
+        const int n_x = static_cast<int>(line / size_t(2 * n_max[1] + 1));
+        const int n_y = static_cast<int>(line % size_t(2 * n_max[1] + 1)) - n_max[1];
+        if (n_x == 0 && n_y < 0)
+        {
+            return;
+        }
+        const int n_z_begin = (n_x == 0 && n_y == 0) ? 1 : -n_max[2];
+        for (int n_z = n_z_begin; n_z <= n_max[2]; ++n_z)
+        {
+            body(n_x, n_y, n_z, b[0] * double(n_x) + b[1] * double(n_y) + b[2] * double(n_z));
+        }
+    }
+
+    vec3<double> b[3]; //!< Reciprocal lattice vectors.
+    int n_max[3];      //!< Largest index along each reciprocal lattice vector.
+};
+
+}; // namespace
+
+StaticStructureFactor::StaticStructureFactor(unsigned int bins, float k_max, float k_min)
+    : m_bins(bins), m_k_max(k_max), m_k_min(k_min), m_frame_counter(0), m_reduce(true)
+{
+    if (bins == 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires a nonzero number of bins.");
+    }
+    if (k_max <= 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires k_max to be positive.");
+    }
+    if (k_min < 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires k_min to be non-negative.");
+    }
+    if (k_max <= k_min)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires that k_max must be greater than k_min.");
+    }
+    m_bin_k_counts.assign(m_bins, 0);
+}
+
+void StaticStructureFactor::reset()
+{
+    m_k_sum.assign(m_k_vectors.size(), 0);
+    m_frame_counter = 0;
+    m_reduce = true;
+}
+
+unsigned int StaticStructureFactor::getBin(float k) const
+{
+    if (k < m_k_min || k >= m_k_max)
+    {
+        return m_bins;
+    }
+    const unsigned int bin = static_cast<unsigned int>((k - m_k_min) * float(m_bins) / (m_k_max - m_k_min));
+    return std::min(bin, m_bins - 1);
+}
+
+void StaticStructureFactor::countKVectorBins()
+{
+    m_k_bins.resize(m_k_vectors.size());
+    m_bin_k_counts.assign(m_bins, 0);
+    for (size_t i = 0; i < m_k_vectors.size(); ++i)
+    {
+        const vec3<float>& k = m_k_vectors[i];
+        m_k_bins[i] = getBin(std::sqrt(dot(k, k)));
+        if (m_k_bins[i] < m_bins)
+        {
+            ++m_bin_k_counts[m_k_bins[i]];
+        }
+    }
+}
+
+void StaticStructureFactor::setKVectors(const vec3<float>* k_vectors, unsigned int n_k_vectors)
+{
+    m_k_vectors.prepare(n_k_vectors);
+    std::copy(k_vectors, k_vectors + n_k_vectors, m_k_vectors.get());
+    countKVectorBins();
+    reset();
+}
+
+void StaticStructureFactor::sampleKVectors(const box::Box& box, unsigned int max_k_points, unsigned int seed)
+{
+    const ReciprocalLattice lattice(box, m_k_max);
+    const size_t n_lines = lattice.numLines();
+
+    // Each bin keeps every lattice vector with the probability that leaves
+    // max_k_points of them on average, so bins are counted first.
+    std::vector<double> keep_probability(m_bins, 1.0);
+    if (max_k_points > 0)
+    {
+        util::ParallelAccumulator<unsigned int> bin_counts(m_bins);
+        util::forLoopWrapper(0, n_lines, [&](size_t begin, size_t end) {
+            std::vector<unsigned int> local_counts(m_bins, 0);
+            for (size_t line = begin; line < end; ++line)
+            {
+                lattice.forEachInLine(line, [&](int, int, int, const vec3<double>& k) {
+                    const unsigned int bin = getBin(static_cast<float>(std::sqrt(dot(k, k))));
+                    if (bin < m_bins)
+                    {
+                        ++local_counts[bin];
+                    }
+                });
+            }
+            bin_counts.add(local_counts.data());
+        });
+        util::ManagedArray<unsigned int> counts(m_bins);
+        bin_counts.reduceInto(counts);
+        for (unsigned int bin = 0; bin < m_bins; ++bin)
+        {
+            if (counts[bin] > max_k_points)
+            {
+                keep_probability[bin] = double(max_k_points) / double(counts[bin]);
+            }
+        }
+    }
+
+    // The kept vectors of each line are stored separately so that their
+    // order does not depend on the scheduling of threads.
+    std::vector<std::vector<vec3<float>>> line_k_vectors(n_lines);
+    util::forLoopWrapper(0, n_lines, [&](size_t begin, size_t end) {
+        for (size_t line = begin; line < end; ++line)
+        {
+            lattice.forEachInLine(line, [&](int n_x, int n_y, int n_z, const vec3<double>& k) {
+                const unsigned int bin = getBin(static_cast<float>(std::sqrt(dot(k, k))));
+                if (bin < m_bins
+                    && (keep_probability[bin] >= 1.0
+                        || latticeRandom(seed, n_x, n_y, n_z) < keep_probability[bin]))
+                {
+                    line_k_vectors[line].push_back(vec3<float>(k));
+                }
+            });
+        }
+    });
+
+    size_t n_k_vectors = 0;
+    for (const auto& k_vectors : line_k_vectors)
+    {
+        n_k_vectors += k_vectors.size();
+    }
+    m_k_vectors.prepare(n_k_vectors);
+    size_t offset = 0;
+    for (const auto& k_vectors : line_k_vectors)
+    {
+        std::copy(k_vectors.begin(), k_vectors.end(), m_k_vectors.get() + offset);
+        offset += k_vectors.size();
+    }
+    countKVectorBins();
+    reset();
+}
+
+void StaticStructureFactor::accumulate(const vec3<float>* points, unsigned int n_points)
+{
+    if (n_points == 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires at least one point.");
+    }
+    const size_t n_k_vectors = m_k_vectors.size();
+    if (n_k_vectors == 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires at least one wavevector.");
+    }
+
+    // Phases are computed in turns, k . r / (2 pi), from contiguous arrays
+    // of double precision coordinates.
+    std::vector<double> x(n_points), y(n_points), z(n_points);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            x[i] = points[i].x;
+            y[i] = points[i].y;
+            z[i] = points[i].z;
+        }
+    });
+
+    // Blocks of wavevectors and points are summed in parallel, so that
+    // systems with few wavevectors and many points are still parallelized.
+    util::ParallelAccumulator<std::complex<double>> local_rho(n_k_vectors);
+    auto sum_block = [&](size_t begin_k, size_t end_k, size_t begin_point, size_t end_point) {
+        double turns[PHASE_BLOCK_SIZE];
+        double cos_values[PHASE_BLOCK_SIZE];
+        double sin_values[PHASE_BLOCK_SIZE];
+        for (size_t k_idx = begin_k; k_idx < end_k; ++k_idx)
+        {
+            const vec3<double> k = vec3<double>(m_k_vectors[k_idx]) / (2 * M_PI);
+            double sum_cos = 0;
+            double sum_sin = 0;
+            for (size_t block = begin_point; block < end_point; block += PHASE_BLOCK_SIZE)
+            {
+                const size_t n = std::min(PHASE_BLOCK_SIZE, end_point - block);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    turns[i] = k.x * x[block + i] + k.y * y[block + i] + k.z * z[block + i];
+                }
+                evaluatePhases(turns, n, cos_values, sin_values);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    sum_cos += cos_values[i];
+                    sum_sin += sin_values[i];
+                }
+            }
+            local_rho.add(k_idx, std::complex<double>(sum_cos, sum_sin));
+        }
+    };
+    util::forLoopWrapper2D(0, n_k_vectors, 0, n_points, sum_block);
+
+    util::ManagedArray<std::complex<double>> rho(n_k_vectors);
+    local_rho.reduceInto(rho);
+    util::forLoopWrapper(0, n_k_vectors, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_k_sum[i] += std::norm(rho[i]) / double(n_points);
+        }
+    });
+
+    ++m_frame_counter;
+    m_reduce = true;
+}
+
+void StaticStructureFactor::computeDebye(const float* bin_edges, const float* rdf, unsigned int n_r_bins,
+                                         float density, bool is2D)
+{
+    if (n_r_bins == 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires a nonzero number of RDF bins.");
+    }
+    if (density <= 0)
+    {
+        throw std::invalid_argument("StaticStructureFactor requires the density to be positive.");
+    }
+
+    m_k_vectors.prepare(0);
+    countKVectorBins();
+    reset();
+    m_k_structure_factor.prepare(0);
+    m_structure_factor.prepare(m_bins);
+
+    const std::vector<float> k_values = getBinCenters();
+    util::forLoopWrapper(0, m_bins, [&](size_t begin, size_t end) {
+        for (size_t bin = begin; bin < end; ++bin)
+        {
+            const double k = k_values[bin];
+            double integral = 0;
+            for (unsigned int i = 0; i < n_r_bins; ++i)
+            {
+                const double r = 0.5 * (double(bin_edges[i]) + double(bin_edges[i + 1]));
+                const double dr = double(bin_edges[i + 1]) - double(bin_edges[i]);
+                const double kr = k * r;
+                const double weight = is2D ? 2 * M_PI * r * besselJ0(kr)
+                                           : 4 * M_PI * r * r * ((kr > 0) ? std::sin(kr) / kr : 1.0);
+                integral += (double(rdf[i]) - 1) * weight * dr;
+            }
+            m_structure_factor[bin] = static_cast<float>(1 + density * integral);
+        }
+    });
+    m_reduce = false;
+}
+
+const util::ManagedArray<float>& StaticStructureFactor::getStructureFactor()
+{
+    if (m_reduce)
+    {
+        const size_t n_k_vectors = m_k_vectors.size();
+        m_k_structure_factor.prepare(n_k_vectors);
+        m_structure_factor.prepare(m_bins);
+
+        const double frame_scale = (m_frame_counter > 0) ? 1.0 / m_frame_counter : 0;
+        std::vector<double> bin_sums(m_bins, 0);
+        for (size_t i = 0; i < n_k_vectors; ++i)
+        {
+            m_k_structure_factor[i] = static_cast<float>(m_k_sum[i] * frame_scale);
+            if (m_k_bins[i] < m_bins)
+            {
+                bin_sums[m_k_bins[i]] += m_k_sum[i];
+            }
+        }
+        for (unsigned int bin = 0; bin < m_bins; ++bin)
+        {
+            m_structure_factor[bin] = (m_bin_k_counts[bin] > 0 && m_frame_counter > 0)
+                ? static_cast<float>(bin_sums[bin] * frame_scale / m_bin_k_counts[bin])
+                : std::numeric_limits<float>::quiet_NaN();
+        }
+        m_reduce = false;
+    }
+    return m_structure_factor;
+}
+
+const util::ManagedArray<float>& StaticStructureFactor::getKVectorStructureFactor()
+{
+    getStructureFactor();
+    return m_k_structure_factor;
+}
+
+std::vector<float> StaticStructureFactor::getBinEdges() const
+{
+    std::vector<float> bin_edges(m_bins + 1);
+    const float dk = (m_k_max - m_k_min) / float(m_bins);
+    for (unsigned int i = 0; i <= m_bins; ++i)
+    {
+        bin_edges[i] = m_k_min + float(i) * dk;
+    }
+    return bin_edges;
+}
+
+std::vector<float> StaticStructureFactor::getBinCenters() const
+{
+    std::vector<float> bin_centers(m_bins);
+    const float dk = (m_k_max - m_k_min) / float(m_bins);
+    for (unsigned int i = 0; i < m_bins; ++i)
+    {
+        bin_centers[i] = m_k_min + (float(i) + 0.5f) * dk;
+    }
+    return bin_centers;
+}
+
+}; }; // end namespace freud::diffraction
@@ -0,0 +1,137 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef STATIC_STRUCTURE_FACTOR_H
+#define STATIC_STRUCTURE_FACTOR_H
+
+#include <vector>
+
+#include "Box.h"
+#include "ManagedArray.h"
+#include "VectorMath.h"
+
+/*! \file StaticStructureFactor.h
+    \brief Computes the static structure factor of points in direct space.
+*/
+
+namespace freud { namespace diffraction {
+
+//! Computes the static structure factor S(k) of points at chosen wavevectors.
+/*! For each wavevector \f$\vec{k}\f$ the structure factor of a frame is
+ *  \f$ S(\vec{k}) = \frac{1}{N} \left| \sum_j e^{i \vec{k} \cdot \vec{r}_j}
+ *  \right|^2 \f$, evaluated directly from the point positions. Unlike a
+ *  Fourier transform of a density grid, the memory used only grows with the
+ *  number of wavevectors, so large boxes can be analyzed by sampling a subset
+ *  of the reciprocal lattice. The sums are computed in parallel over blocks
+ *  of wavevectors and points, using a polynomial sine and cosine that the
+ *  compiler can vectorize.
+ *
+ *  The isotropic structure factor S(k) is the average of S(k-vector) over
+ *  the wavevectors whose magnitude falls in each bin and over all frames
+ *  accumulated since the last reset. Bins without any wavevector are NaN.
+ *
+ *  For small k, computeDebye evaluates S(k) from a radial distribution
+ *  function instead, using the Debye formula.
+ */
+class StaticStructureFactor
+{
+public:
+    //! Constructor
+    /*! \param bins Number of bins of wavevector magnitudes.
+     *  \param k_max Largest wavevector magnitude.
+     *  \param k_min Smallest wavevector magnitude.
+     */
+    StaticStructureFactor(unsigned int bins, float k_max, float k_min = 0);
+
+    // Destructor
+    ~StaticStructureFactor() {}
+
+    //! Reset the accumulated structure factor, keeping the wavevectors.
+    void reset();
+
+    //! Set the wavevectors at which the structure factor is evaluated.
+    /*! This resets the accumulated structure factor.
+     */
+    void setKVectors(const vec3<float>* k_vectors, unsigned int n_k_vectors);
+
+    //! Sample wavevectors of the reciprocal lattice of a box.
+    /*! Only one of each pair of wavevectors \f$\pm\vec{k}\f$ is used, since
+     *  both have the same structure factor. Bins with more than max_k_points
+     *  wavevectors keep a random subset of max_k_points of them on average,
+     *  selected deterministically from the seed. This resets the accumulated
+     *  structure factor.
+     *
+     *  \param box The periodic box.
+     *  \param max_k_points Average number of wavevectors kept per bin, or 0
+     *         to keep all of them.
+     *  \param seed Seed of the random selection.
+     */
+    void sampleKVectors(const box::Box& box, unsigned int max_k_points, unsigned int seed);
+
+    //! Add the structure factor of a frame at the current wavevectors.
+    void accumulate(const vec3<float>* points, unsigned int n_points);
+
+    //! Compute S(k) from a radial distribution function with the Debye formula.
+    /*! In 3D, \f$ S(k) = 1 + 4 \pi \rho \int r^2 (g(r) - 1)
+     *  \frac{\sin(kr)}{kr} dr \f$, and in 2D \f$ S(k) = 1 + 2 \pi \rho \int
+     *  r (g(r) - 1) J_0(kr) dr \f$, integrated over the bins of g(r) at the
+     *  center of each bin of k. The result replaces the accumulated
+     *  structure factor, and the wavevector outputs are cleared.
+     *
+     *  \param bin_edges The n_r_bins + 1 edges of the bins of g(r).
+     *  \param rdf The n_r_bins values of g(r).
+     *  \param n_r_bins Number of bins of g(r).
+     *  \param density Number density of the points.
+     *  \param is2D Whether the system is two-dimensional.
+     */
+    void computeDebye(const float* bin_edges, const float* rdf, unsigned int n_r_bins, float density,
+                      bool is2D);
+
+    //! Get the structure factor averaged over the wavevectors of each bin.
+    const util::ManagedArray<float>& getStructureFactor();
+
+    //! Get the structure factor of each wavevector averaged over frames.
+    const util::ManagedArray<float>& getKVectorStructureFactor();
+
+    //! Get the wavevectors.
+    const util::ManagedArray<vec3<float>>& getKVectors() const
+    {
+        return m_k_vectors;
+    }
+
+    //! Get the edges of the bins of wavevector magnitudes.
+    std::vector<float> getBinEdges() const;
+
+    //! Get the centers of the bins of wavevector magnitudes.
+    std::vector<float> getBinCenters() const;
+
+    //! Get the number of frames accumulated since the last reset.
+    unsigned int getFrameCounter() const
+    {
+        return m_frame_counter;
+    }
+
+private:
+    //! Get the bin of a wavevector magnitude, or m_bins if it is outside of the range.
+    unsigned int getBin(float k) const;
+
+    //! Count the wavevectors of each bin.
+    void countKVectorBins();
+
+    unsigned int m_bins;          //!< Number of bins of wavevector magnitudes.
+    float m_k_max;                //!< Largest wavevector magnitude.
+    float m_k_min;                //!< Smallest wavevector magnitude.
+    unsigned int m_frame_counter; //!< Number of frames accumulated since the last reset.
+    bool m_reduce;                //!< Whether the outputs need to be recomputed.
+
+    util::ManagedArray<vec3<float>> m_k_vectors;    //!< Wavevectors.
+    std::vector<unsigned int> m_k_bins;             //!< Bin of each wavevector.
+    std::vector<unsigned int> m_bin_k_counts;       //!< Number of wavevectors per bin.
+    std::vector<double> m_k_sum;                    //!< Sum of S over frames for each wavevector.
+    util::ManagedArray<float> m_structure_factor;   //!< Structure factor of each bin.
+    util::ManagedArray<float> m_k_structure_factor; //!< Structure factor of each wavevector.
+};
+
+}; }; // end namespace freud::diffraction
+
+#endif // STATIC_STRUCTURE_FACTOR_H
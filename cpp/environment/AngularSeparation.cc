@@ -1,6 +1,14 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "AngularSeparation.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
@@ -70,9 +78,9 @@ void AngularSeparationNeighbor::compute(const locality::NeighborQuery* nq, const
         {
             quat<float> q = orientations[i];
 
-            for (; bond < tot_num_neigh && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
+            for (; bond < tot_num_neigh && m_nlist.getQueryPointIndices()[bond] == i; ++bond)
             {
-                const size_t j(m_nlist.getNeighbors()(bond, 1));
+                const size_t j(m_nlist.getPointIndices()[bond]);
                 quat<float> query_q = query_orientations[j];
 
                 float theta = computeMinSeparationAngle(q, query_q, equiv_orientations, n_equiv_orientations);
@@ -82,23 +90,122 @@ void AngularSeparationNeighbor::compute(const locality::NeighborQuery* nq, const
     });
 }
 
+namespace {
+
+//! Number of points whose separation angles are computed together.
+const size_t POINT_BLOCK_SIZE = 64;
+
+//! Number of candidate orientations in a tile of global orientations.
+/*! The candidates of a tile take 16 KB, so they stay in the L1 cache while
+ *  they are compared to a block of points.
+ */
+const size_t TILE_CANDIDATES = 1024;
+
+//! Find the largest quaternion dot product of an orientation with a set of candidates.
+/*! The dot product is the scalar part of q * conj(ref_q) that is computed in
+ *  computeSeparationAngle, evaluated in the same order so that the result
+ *  is identical.
+ *
+ *  \param s Scalar parts of the candidates.
+ *  \param x First vector components of the candidates.
+ *  \param y Second vector components of the candidates.
+ *  \param z Third vector components of the candidates.
+ *  \param n Number of candidates, a multiple of 4.
+ *  \param ref_q The orientation to compare to.
+ */
+inline float maxDot(const float* s, const float* x, const float* y, const float* z, size_t n,
+                    const quat<float>& ref_q)
+{
+#ifdef __SSE2__
+    const __m128 ref_s = _mm_set1_ps(ref_q.s);
+    const __m128 ref_x = _mm_set1_ps(ref_q.v.x);
+    const __m128 ref_y = _mm_set1_ps(ref_q.v.y);
+    const __m128 ref_z = _mm_set1_ps(ref_q.v.z);
+    __m128 best = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    for (size_t k = 0; k < n; k += 4)
+    {
+        const __m128 vector_dot = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x + k), ref_x), _mm_mul_ps(_mm_loadu_ps(y + k), ref_y)),
+            _mm_mul_ps(_mm_loadu_ps(z + k), ref_z));
+        best = _mm_max_ps(best, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(s + k), ref_s), vector_dot));
+    }
+    best = _mm_max_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_max_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(best);
+#else
+    float best = -std::numeric_limits<float>::infinity();
+    for (size_t k = 0; k < n; ++k)
+    {
+        const float vector_dot = x[k] * ref_q.v.x + y[k] * ref_q.v.y + z[k] * ref_q.v.z;
+        best = std::max(best, s[k] * ref_q.s + vector_dot);
+    }
+    return best;
+#endif
+}
+
+}; // end anonymous namespace
+
 void AngularSeparationGlobal::compute(const quat<float>* global_orientations, unsigned int n_global,
                                       const quat<float>* orientations, unsigned int n_points,
                                       const quat<float>* equiv_orientations,
                                       unsigned int n_equiv_orientations)
 {
     m_angles.prepare({n_points, n_global});
+    if (n_global == 0)
+    {
+        return;
+    }
 
-    util::forLoopWrapper(0, n_points, [=](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+    // The orientations compared to each point by computeMinSeparationAngle
+    // only depend on the global orientation, so they are computed once and
+    // stored as a structure of arrays, padded to a multiple of 4 per global
+    // orientation by repeating the first candidate. Since the separation
+    // angle decreases with the dot product, acos is only evaluated for the
+    // largest dot product.
+    const size_t n_candidates = size_t(n_equiv_orientations) + 1;
+    const size_t stride = (n_candidates + 3) / 4 * 4;
+    std::vector<float> candidates_s(n_global * stride), candidates_x(n_global * stride),
+        candidates_y(n_global * stride), candidates_z(n_global * stride);
+    util::forLoopWrapper(0, n_global, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j)
         {
-            quat<float> q = orientations[i];
-            for (unsigned int j = 0; j < n_global; j++)
+            const quat<float> global_q = global_orientations[j];
+            const quat<float> qtemp
+                = (n_equiv_orientations > 0) ? global_q * conj(equiv_orientations[0]) : global_q;
+            for (size_t k = 0; k < stride; ++k)
+            {
+                const quat<float> candidate = (k == 0 || k >= n_candidates)
+                    ? global_q
+                    : qtemp * equiv_orientations[k - 1];
+                candidates_s[j * stride + k] = candidate.s;
+                candidates_x[j * stride + k] = candidate.v.x;
+                candidates_y[j * stride + k] = candidate.v.y;
+                candidates_z[j * stride + k] = candidate.v.z;
+            }
+        }
+    });
+
+    // Compare blocks of points to tiles of global orientations.
+    const size_t tile_size = std::max(size_t(1), TILE_CANDIDATES / stride);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t block_begin = begin; block_begin < end; block_begin += POINT_BLOCK_SIZE)
+        {
+            const size_t block_end = std::min(end, block_begin + POINT_BLOCK_SIZE);
+            for (size_t tile_begin = 0; tile_begin < n_global; tile_begin += tile_size)
             {
-                quat<float> global_q = global_orientations[j];
-                float theta
-                    = computeMinSeparationAngle(q, global_q, equiv_orientations, n_equiv_orientations);
-                m_angles(i, j) = theta;
+                const size_t tile_end = std::min(size_t(n_global), tile_begin + tile_size);
+                for (size_t i = block_begin; i < block_end; ++i)
+                {
+                    const quat<float> q = orientations[i];
+                    for (size_t j = tile_begin; j < tile_end; ++j)
+                    {
+                        const size_t offset = j * stride;
+                        const float max_dot
+                            = maxDot(candidates_s.data() + offset, candidates_x.data() + offset,
+                                     candidates_y.data() + offset, candidates_z.data() + offset, stride, q);
+                        m_angles(i, j) = float(2.0 * std::acos(util::clamp(max_dot, -1, 1)));
+                    }
+                }
             }
         }
     });
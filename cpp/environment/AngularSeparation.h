@@ -20,6 +20,11 @@ namespace freud { namespace environment {
  * the total angular distance between them. The output is an array of shape
  * (num_orientations, num_global_orientations) containing the pairwise
  * separation angles between the provided orientations and global orientations.
+ *
+ * The orientations equivalent to each global orientation are computed once,
+ * and blocks of points are compared to tiles of global orientations by taking
+ * the largest quaternion dot product over equivalent orientations, so acos is
+ * evaluated only once per pair.
  */
 class AngularSeparationGlobal
 {
@@ -1,8 +1,10 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
+#include <vector>
 #ifdef __SSE2__
 #include <emmintrin.h>
 #endif
@@ -54,10 +56,23 @@ BondOrder::BondOrder(unsigned int n_bins_theta, unsigned int n_bins_phi, BondOrd
     m_histogram = BondHistogram(axes);
 
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
+
+    // precompute the directions of the bin edges used by the batched binning
+    const std::vector<std::vector<float>> bin_edges = m_histogram.getBinEdges();
+    for (const float theta : bin_edges[0])
+    {
+        m_cos_theta_edges.push_back(std::cos(theta));
+        m_sin_theta_edges.push_back(std::sin(theta));
+    }
+    for (const float phi : bin_edges[1])
+    {
+        m_cos_phi_edges.push_back(std::cos(phi));
+    }
 }
 
 void BondOrder::reduce()
 {
+    util::profiling::ScopedTimer timer("BondOrder::reduce");
     m_histogram.prepare(m_histogram.shape());
     m_bo_array.prepare(m_histogram.shape());
 
@@ -71,53 +86,324 @@ const util::ManagedArray<float>& BondOrder::getBondOrder()
     return reduceAndReturn(m_bo_array);
 }
 
+namespace {
+
+//! Distance of unit bond vectors from a bin edge within which bonds are binned exactly.
+/*! Distances are measured along z from the cones of constant phi, and in the
+ *  xy plane from the half-planes of constant theta, so that they do not
+ *  depend on the conditioning of the angles close to the poles. This is much
+ *  larger than the error of approximateAtan2, of std::acos and of rotating
+ *  bonds by matrices instead of quaternions, so bonds binned from approximate
+ *  angles fall into the same bins as with exact angles.
+ */
+const float EDGE_TOLERANCE = 1e-5;
+
+//! Approximate std::atan2 to within a few float rounding errors.
+/*! This uses the polynomial approximation of arctangent on [0, 1] of
+ *  Abramowitz and Stegun (4.4.49), with an error of at most 2e-8, and is
+ *  branch-free so that loops over many angles can be vectorized.
+ */
+inline float approximateAtan2(float y, float x)
+{
+    const float abs_x = std::abs(x);
+    const float abs_y = std::abs(y);
+    const float max_xy = std::max(abs_x, abs_y);
+    const float a = (max_xy > 0) ? std::min(abs_x, abs_y) / max_xy : float(0);
+    const float a2 = a * a;
+    float r = float(0.0028662257);
+    r = r * a2 - float(0.0161657367);
+    r = r * a2 + float(0.0429096138);
+    r = r * a2 - float(0.0752896400);
+    r = r * a2 + float(0.1065626393);
+    r = r * a2 - float(0.1420889944);
+    r = r * a2 + float(0.1999355085);
+    r = r * a2 - float(0.3333314528);
+    r = (r * a2 + float(1)) * a;
+    r = (abs_y > abs_x) ? float(M_PI_2) - r : r;
+    r = (x < 0) ? float(M_PI) - r : r;
+    return (y < 0) ? -r : r;
+}
+
+//! Compute the angles of a bond exactly, one bond at a time.
+/*! \param mode The mode of the bond order diagram.
+ *  \param neighbor_bond The bond.
+ *  \param orientations Orientations of the points.
+ *  \param query_orientations Orientations of the query points.
+ *  \param theta Azimuthal angle of the bond in [0, 2 PI).
+ *  \param phi Polar angle of the bond in [0, PI].
+ */
+void exactBondAngles(BondOrderMode mode, const freud::locality::NeighborBond& neighbor_bond,
+                     const quat<float>* orientations, const quat<float>* query_orientations, float& theta,
+                     float& phi)
+{
+    const quat<float>& ref_q = orientations[neighbor_bond.point_idx];
+    vec3<float> v(neighbor_bond.vector);
+    const quat<float>& q = query_orientations[neighbor_bond.query_point_idx];
+    if (mode == obcd)
+    {
+        // give bond directions of neighboring particles rotated by the matrix
+        // that takes the orientation of particle neighbor_bond.id to the orientation of
+        // particle neighbor_bond.ref_id.
+        v = rotate(conj(ref_q), v);
+        v = rotate(q, v);
+    }
+    else if (mode == lbod)
+    {
+        // give bond directions of neighboring particles rotated into the
+        // local orientation of the central particle.
+        v = rotate(conj(ref_q), v);
+    }
+    else if (mode == oocd)
+    {
+        // give the directors of neighboring particles rotated into the local
+        // orientation of the central particle. pick a (random vector)
+        vec3<float> z(0, 0, 1);
+        // rotate that vector by the orientation of the neighboring particle
+        z = rotate(q, z);
+        // get the direction of this vector with respect to the orientation of
+        // the central particle
+        v = rotate(conj(ref_q), z);
+    }
+
+    // NOTE that angles are defined in the "mathematical" way, rather than how
+    // most physics textbooks do it. get theta (azimuthal angle), phi (polar
+    // angle)
+    theta = std::atan2(v.y, v.x); //-Pi..Pi
+    theta = util::modulusPositive(theta, constants::TWO_PI);
+
+    // NOTE that the below has replaced the commented out expression for phi.
+    phi = std::acos(v.z / std::sqrt(dot(v, v))); // 0..Pi
+}
+
+//! Bins the bonds of one block of work into the bond order histogram in batches.
+/*! Bonds are rotated by precomputed rotation matrices and collected into
+ *  batches. The angles of a batch are computed together by approximateAtan2,
+ *  and bonds that lie within EDGE_TOLERANCE of a bin edge are binned from
+ *  their exact angles instead.
+ */
+class BondOrderBlock
+{
+public:
+    //! Number of bonds whose angles are computed together.
+    static const size_t BATCH_SIZE = 256;
+
+    //! Constructor
+    /*! \param local_histograms The histogram to accumulate into.
+     *  \param mode The mode of the bond order diagram.
+     *  \param orientations Orientations of the points.
+     *  \param query_orientations Orientations of the query points.
+     *  \param inverse_rotations Rotations by the conjugate orientation of each point.
+     *  \param query_rotations Rotations by the orientation of each query point (obcd only).
+     *  \param query_directors The z axis rotated by the orientation of each query point (oocd only).
+     *  \param cos_theta_edges Cosines of the n_bins_theta + 1 edges of the bins in theta.
+     *  \param sin_theta_edges Sines of the n_bins_theta + 1 edges of the bins in theta.
+     *  \param cos_phi_edges Cosines of the n_bins_phi + 1 edges of the bins in phi.
+     */
+    BondOrderBlock(util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms, BondOrderMode mode,
+                   const quat<float>* orientations, const quat<float>* query_orientations,
+                   const rotmat3<float>* inverse_rotations, const rotmat3<float>* query_rotations,
+                   const vec3<float>* query_directors, const std::vector<float>& cos_theta_edges,
+                   const std::vector<float>& sin_theta_edges, const std::vector<float>& cos_phi_edges)
+        : m_block(local_histograms), m_mode(mode), m_orientations(orientations),
+          m_query_orientations(query_orientations), m_inverse_rotations(inverse_rotations),
+          m_query_rotations(query_rotations), m_query_directors(query_directors),
+          m_cos_theta_edges(cos_theta_edges.data()), m_sin_theta_edges(sin_theta_edges.data()),
+          m_cos_phi_edges(cos_phi_edges.data()), m_n_bins_theta(cos_theta_edges.size() - 1),
+          m_n_bins_phi(cos_phi_edges.size() - 1), m_bonds(BATCH_SIZE), m_x(BATCH_SIZE), m_y(BATCH_SIZE),
+          m_z(BATCH_SIZE), m_theta(BATCH_SIZE), m_phi(BATCH_SIZE), m_num_bonds(0)
+    {}
+
+    void operator()(const freud::locality::NeighborBond& neighbor_bond)
+    {
+        vec3<float> v(neighbor_bond.vector);
+        if (m_mode == obcd)
+        {
+            v = m_query_rotations[neighbor_bond.query_point_idx]
+                * (m_inverse_rotations[neighbor_bond.point_idx] * v);
+        }
+        else if (m_mode == lbod)
+        {
+            v = m_inverse_rotations[neighbor_bond.point_idx] * v;
+        }
+        else if (m_mode == oocd)
+        {
+            v = m_inverse_rotations[neighbor_bond.point_idx]
+                * m_query_directors[neighbor_bond.query_point_idx];
+        }
+        m_bonds[m_num_bonds] = neighbor_bond;
+        m_x[m_num_bonds] = v.x;
+        m_y[m_num_bonds] = v.y;
+        m_z[m_num_bonds] = v.z;
+        if (++m_num_bonds == BATCH_SIZE)
+        {
+            flushBatch();
+        }
+    }
+
+    void finish()
+    {
+        flushBatch();
+        m_block.finish();
+    }
+
+private:
+    //! Bin and count the bonds of the current batch.
+    void flushBatch()
+    {
+        // Normalize the bonds and compute their approximate angles. The polar
+        // angle is computed from atan2 rather than acos, which is also more
+        // accurate close to the poles.
+        for (size_t i = 0; i < m_num_bonds; ++i)
+        {
+            const float inverse_length
+                = float(1) / std::sqrt(m_x[i] * m_x[i] + m_y[i] * m_y[i] + m_z[i] * m_z[i]);
+            m_x[i] *= inverse_length;
+            m_y[i] *= inverse_length;
+            m_z[i] *= inverse_length;
+            const float theta = approximateAtan2(m_y[i], m_x[i]);
+            m_theta[i] = (theta < 0) ? theta + constants::TWO_PI : theta;
+            m_phi[i] = approximateAtan2(std::sqrt(m_x[i] * m_x[i] + m_y[i] * m_y[i]), m_z[i]);
+        }
+
+        const float theta_scale = static_cast<float>(m_n_bins_theta) / constants::TWO_PI;
+        const float phi_scale = static_cast<float>(m_n_bins_phi) / float(M_PI);
+        for (size_t i = 0; i < m_num_bonds; ++i)
+        {
+            const float scaled_theta = m_theta[i] * theta_scale;
+            const float scaled_phi = m_phi[i] * phi_scale;
+            // These comparisons also send NaNs to the exact binning.
+            bool exact = !(scaled_theta >= 0 && scaled_theta < static_cast<float>(m_n_bins_theta)
+                           && scaled_phi >= 0 && scaled_phi < static_cast<float>(m_n_bins_phi));
+            size_t bin_theta = 0;
+            size_t bin_phi = 0;
+            if (!exact)
+            {
+                bin_theta = static_cast<size_t>(scaled_theta);
+                bin_phi = static_cast<size_t>(scaled_phi);
+                const float x = m_x[i];
+                const float y = m_y[i];
+                const float z = m_z[i];
+                exact = !(std::abs(z - m_cos_phi_edges[bin_phi]) > EDGE_TOLERANCE
+                          && std::abs(z - m_cos_phi_edges[bin_phi + 1]) > EDGE_TOLERANCE
+                          && std::abs(m_cos_theta_edges[bin_theta] * y - m_sin_theta_edges[bin_theta] * x)
+                              > EDGE_TOLERANCE
+                          && std::abs(m_cos_theta_edges[bin_theta + 1] * y
+                                      - m_sin_theta_edges[bin_theta + 1] * x)
+                              > EDGE_TOLERANCE);
+            }
+            if (exact)
+            {
+                float theta, phi;
+                exactBondAngles(m_mode, m_bonds[i], m_orientations, m_query_orientations, theta, phi);
+                m_block.buffer(theta, phi);
+            }
+            else
+            {
+                m_block.increment(bin_theta * m_n_bins_phi + bin_phi);
+            }
+        }
+        m_num_bonds = 0;
+    }
+
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_block; //!< Privatized bin counts.
+    BondOrderMode m_mode;                               //!< The mode of the bond order diagram.
+    const quat<float>* m_orientations;                  //!< Orientations of the points.
+    const quat<float>* m_query_orientations;            //!< Orientations of the query points.
+    const rotmat3<float>* m_inverse_rotations;          //!< Conjugate rotations of the points.
+    const rotmat3<float>* m_query_rotations;            //!< Rotations of the query points.
+    const vec3<float>* m_query_directors;               //!< Rotated z axes of the query points.
+    const float* m_cos_theta_edges;                     //!< Cosines of the edges in theta.
+    const float* m_sin_theta_edges;                     //!< Sines of the edges in theta.
+    const float* m_cos_phi_edges;                       //!< Cosines of the edges in phi.
+    size_t m_n_bins_theta;                              //!< Number of bins in theta.
+    size_t m_n_bins_phi;                                //!< Number of bins in phi.
+    std::vector<freud::locality::NeighborBond> m_bonds; //!< Bonds of the current batch.
+    std::vector<float> m_x;                             //!< Bond x components.
+    std::vector<float> m_y;                             //!< Bond y components.
+    std::vector<float> m_z;                             //!< Bond z components.
+    std::vector<float> m_theta;                         //!< Approximate azimuthal angles.
+    std::vector<float> m_phi;                           //!< Approximate polar angles.
+    size_t m_num_bonds;                                 //!< Number of bonds in the current batch.
+};
+
+}; // end anonymous namespace
+
 void BondOrder::accumulate(const locality::NeighborQuery* neighbor_query, quat<float>* orientations,
                            vec3<float>* query_points, quat<float>* query_orientations,
                            unsigned int n_query_points, const freud::locality::NeighborList* nlist,
-                           freud::locality::QueryArgs qargs)
+                           freud::locality::QueryArgs qargs, locality::BondGeometry* geometry)
 {
-    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
-                      [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          quat<float>& ref_q = orientations[neighbor_bond.point_idx];
-                          vec3<float> v(bondVector(neighbor_bond, neighbor_query, query_points));
-                          quat<float>& q = query_orientations[neighbor_bond.query_point_idx];
-                          if (m_mode == obcd)
-                          {
-                              // give bond directions of neighboring particles rotated by the matrix
-                              // that takes the orientation of particle neighbor_bond.id to the orientation of
-                              // particle neighbor_bond.ref_id.
-                              v = rotate(conj(ref_q), v);
-                              v = rotate(q, v);
-                          }
-                          else if (m_mode == lbod)
-                          {
-                              // give bond directions of neighboring particles rotated into the
-                              // local orientation of the central particle.
-                              v = rotate(conj(ref_q), v);
-                          }
-                          else if (m_mode == oocd)
-                          {
-                              // give the directors of neighboring particles rotated into the local
-                              // orientation of the central particle. pick a (random vector)
-                              vec3<float> z(0, 0, 1);
-                              // rotate that vector by the orientation of the neighboring particle
-                              z = rotate(q, z);
-                              // get the direction of this vector with respect to the orientation of
-                              // the central particle
-                              v = rotate(conj(ref_q), z);
-                          }
-
-                          // NOTE that angles are defined in the "mathematical" way, rather than how
-                          // most physics textbooks do it. get theta (azimuthal angle), phi (polar
-                          // angle)
-                          float theta = std::atan2(v.y, v.x); //-Pi..Pi
-                          theta = util::modulusPositive(theta, constants::TWO_PI);
-
-                          // NOTE that the below has replaced the commented out expression for phi.
-                          float phi = std::acos(v.z / std::sqrt(dot(v, v))); // 0..Pi
-
-                          m_local_histograms(theta, phi);
-                      });
+    const BondOrderMode mode = m_mode;
+    if (geometry != nullptr)
+    {
+        geometry->validate(nlist);
+    }
+    if (geometry != nullptr && mode == bod)
+    {
+        util::profiling::ScopedTimer timer("BondHistogramCompute::accumulate");
+        const float* theta = geometry->getTheta().get();
+        const float* phi = geometry->getPhi().get();
+        startFrame(neighbor_query, n_query_points);
+        util::forLoopWrapper(
+            0, geometry->getNumBonds(),
+            [&](size_t begin, size_t end) {
+                util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock block(m_local_histograms);
+                for (size_t bond = begin; bond < end; ++bond)
+                {
+                    block.buffer(theta[bond], phi[bond]);
+                }
+                block.finish();
+            },
+            !m_parallel_frames);
+        finishFrame();
+        return;
+    }
+
+    // Convert orientations to rotation matrices once instead of rotating
+    // every bond by quaternions.
+    std::vector<rotmat3<float>> inverse_rotations;
+    std::vector<rotmat3<float>> query_rotations;
+    std::vector<vec3<float>> query_directors;
+    if (mode != bod)
+    {
+        inverse_rotations.resize(neighbor_query->getNPoints());
+        util::forLoopWrapper(0, inverse_rotations.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                inverse_rotations[i] = rotmat3<float>(conj(orientations[i]));
+            }
+        });
+    }
+    if (mode == obcd || mode == oocd)
+    {
+        if (mode == obcd)
+        {
+            query_rotations.resize(n_query_points);
+        }
+        else
+        {
+            query_directors.resize(n_query_points);
+        }
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (mode == obcd)
+                {
+                    query_rotations[i] = rotmat3<float>(query_orientations[i]);
+                }
+                else
+                {
+                    query_directors[i] = rotate(query_orientations[i], vec3<float>(0, 0, 1));
+                }
+            }
+        });
+    }
+
+    accumulateBlocks(neighbor_query, query_points, n_query_points, nlist, qargs, [&]() {
+        return BondOrderBlock(m_local_histograms, mode, orientations, query_orientations,
+                              inverse_rotations.data(), query_rotations.data(), query_directors.data(),
+                              m_cos_theta_edges, m_sin_theta_edges, m_cos_phi_edges);
+    });
 }
 
 }; }; // end namespace freud::environment
@@ -4,6 +4,9 @@
 #ifndef BOND_ORDER_H
 #define BOND_ORDER_H
 
+#include <vector>
+
+#include "BondGeometry.h"
 #include "BondHistogramCompute.h"
 #include "Box.h"
 #include "Histogram.h"
@@ -40,9 +43,18 @@ public:
     ~BondOrder() {}
 
     //! Accumulate the bond order
+    /*! Bonds are rotated by rotation matrices precomputed from the
+     *  orientations and binned in batches from approximate angles, except for
+     *  bonds close to bin edges, which are binned from exact angles so that
+     *  the result is the same as binning every bond exactly.
+     *
+     *  If a bond geometry of nlist is provided in the bod mode, whose bonds
+     *  are not rotated, the bonds are binned from its angles instead.
+     */
     void accumulate(const locality::NeighborQuery* neighbor_query, quat<float>* orientations,
                     vec3<float>* query_points, quat<float>* query_orientations, unsigned int n_query_points,
-                    const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
+                    const freud::locality::NeighborList* nlist, freud::locality::QueryArgs qargs,
+                    locality::BondGeometry* geometry = nullptr);
 
     virtual void reduce();
 
@@ -54,10 +66,19 @@ public:
         return m_mode;
     }
 
+    //! Return the name identifying BondOrders in serialized states.
+    virtual std::string getStateName() const
+    {
+        return "BondOrder";
+    }
+
 private:
     util::ManagedArray<float> m_bo_array; //!< bond order array computed
     util::ManagedArray<float> m_sa_array; //!< surface area array computed
     BondOrderMode m_mode;                 //!< The mode to calculate with.
+    std::vector<float> m_cos_theta_edges; //!< Cosines of the bin edges in theta.
+    std::vector<float> m_sin_theta_edges; //!< Sines of the bin edges in theta.
+    std::vector<float> m_cos_phi_edges;   //!< Cosines of the bin edges in phi.
 };
 
 }; }; // end namespace freud::environment
@@ -1,6 +1,14 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is part of the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "LocalBondProjection.h"
 #include "NeighborComputeFunctional.h"
 
@@ -11,7 +19,7 @@
 
 namespace freud { namespace environment {
 
-LocalBondProjection::LocalBondProjection() {}
+LocalBondProjection::LocalBondProjection(LocalBondProjectionOutputs outputs) : m_outputs(outputs) {}
 
 LocalBondProjection::~LocalBondProjection() {}
 
@@ -52,6 +60,45 @@ float computeMaxProjection(const vec3<float> proj_vec, const vec3<float> local_b
     return max_proj;
 }
 
+namespace {
+
+//! Find the largest projection of a bond onto a set of candidate vectors.
+/*! \param x First components of the candidates.
+ *  \param y Second components of the candidates.
+ *  \param z Third components of the candidates.
+ *  \param n Number of candidates, a multiple of 4.
+ *  \param local_bond The bond to project.
+ */
+inline float maxProjection(const float* x, const float* y, const float* z, size_t n,
+                           const vec3<float>& local_bond)
+{
+#ifdef __SSE2__
+    const __m128 bond_x = _mm_set1_ps(local_bond.x);
+    const __m128 bond_y = _mm_set1_ps(local_bond.y);
+    const __m128 bond_z = _mm_set1_ps(local_bond.z);
+    __m128 best = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    for (size_t k = 0; k < n; k += 4)
+    {
+        const __m128 proj = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(x + k), bond_x), _mm_mul_ps(_mm_loadu_ps(y + k), bond_y)),
+            _mm_mul_ps(_mm_loadu_ps(z + k), bond_z));
+        best = _mm_max_ps(best, proj);
+    }
+    best = _mm_max_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(1, 0, 3, 2)));
+    best = _mm_max_ps(best, _mm_shuffle_ps(best, best, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtss_f32(best);
+#else
+    float best = -std::numeric_limits<float>::infinity();
+    for (size_t k = 0; k < n; ++k)
+    {
+        best = std::max(best, x[k] * local_bond.x + y[k] * local_bond.y + z[k] * local_bond.z);
+    }
+    return best;
+#endif
+}
+
+}; // end anonymous namespace
+
 void LocalBondProjection::compute(const locality::NeighborQuery* nq, const quat<float>* orientations,
                                   const vec3<float>* query_points, unsigned int n_query_points,
                                   const vec3<float>* proj_vecs, unsigned int n_proj,
@@ -62,22 +109,53 @@ void LocalBondProjection::compute(const locality::NeighborQuery* nq, const quat<
     m_nlist = locality::makeDefaultNlist(nq, nlist, query_points, n_query_points, qargs);
 
     // Get the maximum total number of bonds in the neighbor list
-    const unsigned int tot_num_neigh = m_nlist.getNumBonds();
+    const size_t tot_num_neigh = m_nlist.getNumBonds();
 
-    m_local_bond_proj.prepare({tot_num_neigh, n_proj});
+    const bool all_outputs = (m_outputs == local_bond_projection_all);
+    m_local_bond_proj = util::ManagedArray<float>();
+    if (all_outputs)
+    {
+        m_local_bond_proj.prepare({tot_num_neigh, n_proj});
+    }
     m_local_bond_proj_norm.prepare({tot_num_neigh, n_proj});
 
+    // The vectors compared by computeMaxProjection do not depend on the bond,
+    // so they are computed once for each projection vector and stored as a
+    // structure of arrays, padded to a multiple of 4 by repeating the
+    // projection vector itself.
+    const size_t n_candidates = size_t(n_equiv_orientations) + 1;
+    const size_t stride = (n_candidates + 3) / 4 * 4;
+    std::vector<float> candidates_x(n_proj * stride), candidates_y(n_proj * stride),
+        candidates_z(n_proj * stride);
+    for (unsigned int k = 0; k < n_proj; k++)
+    {
+        const vec3<float> proj_vec = proj_vecs[k];
+        for (size_t c = 0; c < stride; ++c)
+        {
+            vec3<float> candidate = proj_vec;
+            if (c > 0 && c < n_candidates)
+            {
+                // here we undo a rotation represented by one of the equivalent orientations
+                const quat<float> qtest = conj(equiv_orientations[0]) * equiv_orientations[c - 1];
+                candidate = rotate(qtest, proj_vec);
+            }
+            candidates_x[k * stride + c] = candidate.x;
+            candidates_y[k * stride + c] = candidate.y;
+            candidates_z[k * stride + c] = candidate.z;
+        }
+    }
+
     // compute the order parameter
-    util::forLoopWrapper(0, n_query_points, [=](size_t begin, size_t end) {
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
         size_t bond(m_nlist.find_first_index(begin));
         for (size_t i = begin; i < end; ++i)
         {
-            for (; bond < tot_num_neigh && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
+            for (; bond < tot_num_neigh && m_nlist.getQueryPointIndices()[bond] == i; ++bond)
             {
-                const size_t j(m_nlist.getNeighbors()(bond, 1));
+                const size_t j(m_nlist.getPointIndices()[bond]);
 
                 // compute bond vector between the two particles
-                vec3<float> local_bond(bondVector(locality::NeighborBond(i, j), nq, query_points));
+                vec3<float> local_bond(bondVector(&m_nlist, bond, nq, query_points));
                 // rotate bond vector into the local frame of particle p
                 local_bond = rotate(conj(orientations[j]), local_bond);
                 // store the length of this local bond
@@ -85,10 +163,14 @@ void LocalBondProjection::compute(const locality::NeighborQuery* nq, const quat<
 
                 for (unsigned int k = 0; k < n_proj; k++)
                 {
-                    vec3<float> proj_vec = proj_vecs[k];
-                    float max_proj = computeMaxProjection(proj_vec, local_bond, equiv_orientations,
-                                                          n_equiv_orientations);
-                    m_local_bond_proj(bond, k) = max_proj;
+                    const size_t offset = k * stride;
+                    const float max_proj
+                        = maxProjection(candidates_x.data() + offset, candidates_y.data() + offset,
+                                        candidates_z.data() + offset, stride, local_bond);
+                    if (all_outputs)
+                    {
+                        m_local_bond_proj(bond, k) = max_proj;
+                    }
                     m_local_bond_proj_norm(bond, k) = max_proj / local_bond_len;
                 }
             }
@@ -22,11 +22,28 @@ namespace freud { namespace environment {
 float computeMaxProjection(const vec3<float> proj_vec, const vec3<float> local_bond,
                            const quat<float>* equiv_qs, unsigned int Nequiv);
 
+//! Outputs computed by LocalBondProjection, each including the previous ones.
+enum LocalBondProjectionOutputs
+{
+    local_bond_projection_normed, //!< Only the projections normalized by the bond lengths.
+    local_bond_projection_all     //!< Both the projections and the normalized projections.
+};
+
+//! Compute the maximal projections of bonds onto a set of vectors in the local frames of points.
+/*! The vectors equivalent to each projection vector under the equivalent
+ *  orientations are computed once per call to compute, and the projections
+ *  of each bond onto all equivalent vectors of a projection vector are
+ *  compared together by a vectorized loop. Skipping the unnormalized
+ *  projections saves the storage of one (N_bonds, N_projection_vecs) array.
+ *  Arrays of outputs that were not computed are empty.
+ */
 class LocalBondProjection
 {
 public:
     //! Constructor
-    LocalBondProjection();
+    /*! \param outputs Outputs to compute.
+     */
+    explicit LocalBondProjection(LocalBondProjectionOutputs outputs = local_bond_projection_all);
 
     //! Destructor
     ~LocalBondProjection();
@@ -38,6 +55,12 @@ public:
                  unsigned int n_equiv_orientations, const freud::locality::NeighborList* nlist,
                  locality::QueryArgs qargs);
 
+    //! Get the outputs to compute.
+    LocalBondProjectionOutputs getOutputs() const
+    {
+        return m_outputs;
+    }
+
     //! Get a reference to the last computed maximal local bond projection array
     const util::ManagedArray<float>& getProjections() const
     {
@@ -57,7 +80,8 @@ public:
     }
 
 private:
-    locality::NeighborList m_nlist; //!< The NeighborList used in the last call to compute.
+    LocalBondProjectionOutputs m_outputs; //!< Outputs to compute.
+    locality::NeighborList m_nlist;       //!< The NeighborList used in the last call to compute.
 
     util::ManagedArray<float> m_local_bond_proj;      //!< Local bond projection array computed
     util::ManagedArray<float> m_local_bond_proj_norm; //!< Normalized local bond projection array computed
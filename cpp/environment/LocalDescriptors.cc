@@ -1,11 +1,13 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <vector>
 
 #include "LocalDescriptors.h"
 #include "NeighborComputeFunctional.h"
 #include "diagonalize.h"
+#include "utils.h"
 
 /*! \file LocalDescriptors.cc
   \brief Computes local descriptors.
@@ -14,29 +16,118 @@
 namespace freud { namespace environment {
 
 LocalDescriptors::LocalDescriptors(unsigned int l_max, bool negative_m,
-                                   LocalDescriptorOrientation orientation)
-    : m_l_max(l_max), m_negative_m(negative_m), m_nSphs(0), m_orientation(orientation)
+                                   LocalDescriptorOrientation orientation,
+                                   LocalDescriptorReduction reduction, bool half_precision)
+    : m_l_max(l_max), m_negative_m(negative_m), m_nSphs(0), m_orientation(orientation),
+      m_reduction(reduction), m_half_precision(half_precision), m_memory_budget(0)
 {}
 
 void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<float>* query_points,
                                unsigned int n_query_points, const quat<float>* orientations,
                                const freud::locality::NeighborList* nlist, locality::QueryArgs qargs,
-                               unsigned int max_num_neighbors)
+                               unsigned int max_num_neighbors, locality::BondGeometry* geometry)
 {
-    // This function requires a NeighborList object, so we always make one and store it locally.
-    m_nlist = locality::makeDefaultNlist(nq, nlist, query_points, n_query_points, qargs);
+    // The harmonics of a bond geometry are those of unrotated bonds, and
+    // follow the sign convention of util::SphericalHarmonics, which differs
+    // from that of fsph by a factor of (-1)^m for m >= 0.
+    const vec3<float>* vectors = nullptr;
+    const std::complex<float>* harmonics = nullptr;
+    const unsigned int num_harmonics = (m_l_max + 1) * (m_l_max + 1);
+    if (geometry != nullptr)
+    {
+        geometry->validate(nlist, (m_orientation == Global) ? m_l_max : 0);
+        vectors = geometry->getVectors().get();
+        if (m_orientation == Global)
+        {
+            harmonics = geometry->getHarmonics().get();
+        }
+    }
+
+    // This function requires a NeighborList object, so we make one and
+    // store it locally, unless the bonds of reductions exceed the memory
+    // budget. In that case the bonds are found for chunks of query points
+    // that fit in the budget, and the NeighborList is not stored.
+    const bool chunked = nlist == nullptr && m_reduction != NoReduction && m_memory_budget != 0
+        && locality::estimateNeighborListBytes(nq, n_query_points, qargs) > m_memory_budget;
+    m_nlist = chunked ? locality::NeighborList()
+                      : locality::makeDefaultNlist(nq, nlist, query_points, n_query_points, qargs);
 
     if (max_num_neighbors == 0)
         max_num_neighbors = std::numeric_limits<unsigned int>::max();
 
-    m_sphArray.prepare({m_nlist.getNumBonds(), getSphWidth()});
+    // Only the array of the requested output is allocated, and the others
+    // are reset.
+    const unsigned int sph_width(getSphWidth());
+    const size_t num_rows(m_reduction == NoReduction ? m_nlist.getNumBonds() : nq->getNPoints());
+    const unsigned int width(m_reduction == PowerSpectrum ? m_l_max + 1 : sph_width);
+    m_sphArray = util::ManagedArray<std::complex<float>>();
+    m_powerSpectrum = util::ManagedArray<float>();
+    m_halfArray = util::ManagedArray<uint16_t>();
+    if (m_half_precision)
+    {
+        std::vector<size_t> shape {num_rows, width};
+        if (m_reduction != PowerSpectrum)
+        {
+            shape.push_back(2);
+        }
+        m_halfArray.prepare(shape);
+    }
+    else if (m_reduction == PowerSpectrum)
+    {
+        m_powerSpectrum.prepare({num_rows, width});
+    }
+    else
+    {
+        m_sphArray.prepare({num_rows, width});
+    }
+
+    // Store a row of spherical harmonics or power spectra.
+    auto store_sph = [&](size_t row, const std::complex<float>* values) {
+        if (m_half_precision)
+        {
+            uint16_t* out = &m_halfArray[2 * row * width];
+            for (unsigned int k = 0; k < width; ++k)
+            {
+                out[2 * k] = util::floatToHalf(values[k].real());
+                out[2 * k + 1] = util::floatToHalf(values[k].imag());
+            }
+        }
+        else
+        {
+            std::copy(values, values + width, &m_sphArray[row * width]);
+        }
+    };
+    auto store_power = [&](size_t row, const float* values) {
+        if (m_half_precision)
+        {
+            std::transform(values, values + width, &m_halfArray[row * width], util::floatToHalf);
+        }
+        else
+        {
+            std::copy(values, values + width, &m_powerSpectrum[row * width]);
+        }
+    };
 
-    util::forLoopWrapper(0, nq->getNPoints(), [=](size_t begin, size_t end) {
+    // Compute the outputs of the query points at positions [begin, end) of
+    // indices, or of the points [begin, end) if indices is NULL.
+    auto compute_points = [&](const locality::NeighborList& point_nlist, const unsigned int* indices,
+                              size_t begin, size_t end) {
         fsph::PointSPHEvaluator<float> sph_eval(m_l_max);
+        // Per-thread buffers for the reductions and half precision output.
+        std::vector<std::complex<float>> sph_values(sph_width);
+        std::vector<std::complex<float>> bond_values(sph_width);
+        std::vector<float> powers(m_l_max + 1);
 
-        for (size_t i = begin; i < end; ++i)
+        for (size_t k_point = begin; k_point < end; ++k_point)
         {
-            size_t bond(m_nlist.find_first_index(i));
+            const size_t i((indices != nullptr) ? indices[k_point] : k_point);
+            // Query points without a row of the points are skipped, as by
+            // the loop over the points.
+            if (indices != nullptr && i >= num_rows)
+            {
+                continue;
+            }
+            size_t bond(point_nlist.find_first_index(i));
             unsigned int neighbor_count(0);
 
             vec3<float> rotation_0, rotation_1, rotation_2;
@@ -45,12 +136,14 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
             {
                 util::ManagedArray<float> inertiaTensor = util::ManagedArray<float>({3, 3});
 
-                for (size_t bond_copy(bond); bond_copy < m_nlist.getNumBonds()
-                     && m_nlist.getNeighbors()(bond_copy, 0) == i && neighbor_count < max_num_neighbors;
+                for (size_t bond_copy(bond); bond_copy < point_nlist.getNumBonds()
+                     && point_nlist.getQueryPointIndices()[bond_copy] == i
+                     && neighbor_count < max_num_neighbors;
                      ++bond_copy, ++neighbor_count)
                 {
-                    const size_t j(m_nlist.getNeighbors()(bond_copy, 1));
-                    const vec3<float> r_ij(bondVector(locality::NeighborBond(i, j), nq, query_points));
+                    const vec3<float> r_ij((vectors != nullptr)
+                                               ? vectors[bond_copy]
+                                               : bondVector(&point_nlist, bond_copy, nq, query_points));
                     const float r_sq(dot(r_ij, r_ij));
 
                     for (size_t ii(0); ii < 3; ++ii)
@@ -97,13 +190,49 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
             }
 
             neighbor_count = 0;
-            for (; bond < m_nlist.getNumBonds() && m_nlist.getNeighbors()(bond, 0) == i
+            std::fill(sph_values.begin(), sph_values.end(), std::complex<float>(0));
+            for (; bond < point_nlist.getNumBonds() && point_nlist.getQueryPointIndices()[bond] == i
                  && neighbor_count < max_num_neighbors;
                  ++bond, ++neighbor_count)
             {
-                const unsigned int sphCount(bond * getSphWidth());
-                const size_t j(m_nlist.getNeighbors()(bond, 1));
-                const vec3<float> r_ij(bondVector(locality::NeighborBond(i, j), nq, query_points));
+                if (harmonics != nullptr)
+                {
+                    // Reorder the harmonics of the bond as those of fsph,
+                    // writing bonds without reduction to their output row.
+                    std::complex<float>* values = (m_reduction == NoReduction && !m_half_precision)
+                        ? &m_sphArray[bond * sph_width]
+                        : bond_values.data();
+                    const std::complex<float>* bond_harmonics = harmonics + bond * num_harmonics;
+                    unsigned int k(0);
+                    for (unsigned int l = 0; l <= m_l_max; ++l)
+                    {
+                        const std::complex<float>* Ylm = bond_harmonics + l * l;
+                        for (unsigned int m = 0; m <= l; ++m)
+                        {
+                            values[k++] = (m % 2) ? -Ylm[m] : Ylm[m];
+                        }
+                        for (unsigned int m = 1; m_negative_m && m <= l; ++m)
+                        {
+                            values[k++] = Ylm[l + m];
+                        }
+                    }
+                    if (m_reduction != NoReduction)
+                    {
+                        for (k = 0; k < sph_width; ++k)
+                        {
+                            sph_values[k] += values[k];
+                        }
+                    }
+                    else if (m_half_precision)
+                    {
+                        store_sph(bond, values);
+                    }
+                    continue;
+                }
+
+                const vec3<float> r_ij((vectors != nullptr)
+                                           ? vectors[bond]
+                                           : bondVector(&point_nlist, bond, nq, query_points));
                 const float r_sq(dot(r_ij, r_ij));
                 const vec3<float> bond_ij(dot(rotation_0, r_ij), dot(rotation_1, r_ij),
                                           dot(rotation_2, r_ij));
@@ -124,13 +253,96 @@ void LocalDescriptors::compute(const locality::NeighborQuery* nq, const vec3<flo
 
                 sph_eval.compute(phi, theta);
 
-                std::copy(sph_eval.begin(m_negative_m), sph_eval.end(), &m_sphArray[sphCount]);
+                if (m_reduction != NoReduction)
+                {
+                    // accumulate the spherical harmonics of the bonds of i
+                    unsigned int k(0);
+                    for (auto ylm = sph_eval.begin(m_negative_m); ylm != sph_eval.end(); ++ylm, ++k)
+                    {
+                        sph_values[k] += *ylm;
+                    }
+                }
+                else if (m_half_precision)
+                {
+                    std::copy(sph_eval.begin(m_negative_m), sph_eval.end(), sph_values.begin());
+                    store_sph(bond, sph_values.data());
+                }
+                else
+                {
+                    std::copy(sph_eval.begin(m_negative_m), sph_eval.end(), &m_sphArray[bond * sph_width]);
+                }
+            }
+
+            if (m_reduction == NoReduction)
+            {
+                continue;
+            }
+
+            if (neighbor_count > 0)
+            {
+                for (std::complex<float>& value : sph_values)
+                {
+                    value /= float(neighbor_count);
+                }
+            }
+
+            if (m_reduction == ParticleAverage)
+            {
+                store_sph(i, sph_values.data());
+            }
+            else
+            {
+                // Harmonics are ordered by l, then by m as [0, 1, ..., l]
+                // followed by [-1, ..., -l] if negative m are computed. The
+                // averages for -m and m have the same magnitude, so without
+                // negative m those of m > 0 are counted twice.
+                for (unsigned int l = 0; l <= m_l_max; ++l)
+                {
+                    if (m_negative_m)
+                    {
+                        powers[l] = 0;
+                        for (unsigned int k = l * l; k < (l + 1) * (l + 1); ++k)
+                        {
+                            powers[l] += std::norm(sph_values[k]);
+                        }
+                    }
+                    else
+                    {
+                        const unsigned int offset(l * (l + 1) / 2);
+                        powers[l] = std::norm(sph_values[offset]);
+                        for (unsigned int m = 1; m <= l; ++m)
+                        {
+                            powers[l] += 2 * std::norm(sph_values[offset + m]);
+                        }
+                    }
+                }
+                store_power(i, powers.data());
             }
         }
-    });
+    };
+
+    size_t num_bonds(m_nlist.getNumBonds());
+    if (chunked)
+    {
+        num_bonds = 0;
+        locality::forEachNeighborListChunk(
+            nq, query_points, n_query_points, qargs, m_memory_budget,
+            [&](const locality::NeighborList& chunk, const std::vector<unsigned int>& indices) {
+                util::forLoopWrapper(0, indices.size(), [&](size_t begin, size_t end) {
+                    compute_points(chunk, indices.data(), begin, end);
+                });
+                num_bonds += chunk.getNumBonds();
+            });
+    }
+    else
+    {
+        util::forLoopWrapper(0, nq->getNPoints(), [&](size_t begin, size_t end) {
+            compute_points(m_nlist, nullptr, begin, end);
+        });
+    }
 
     // save the last computed number of particles
-    m_nSphs = m_nlist.getNumBonds();
+    m_nSphs = num_bonds;
 }
 
 }; }; // end namespace freud::environment
@@ -5,7 +5,9 @@
 #define LOCAL_DESCRIPTORS_H
 
 #include <complex>
+#include <cstdint>
 
+#include "BondGeometry.h"
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
@@ -26,8 +28,21 @@ enum LocalDescriptorOrientation
     ParticleLocal
 };
 
+//! Reductions of the bond spherical harmonics, computed while evaluating them.
+enum LocalDescriptorReduction
+{
+    NoReduction,     //!< Spherical harmonics of each bond.
+    ParticleAverage, //!< Spherical harmonics averaged over the bonds of each point.
+    PowerSpectrum    //!< Sum over m of the squared magnitudes of the averages, for each l.
+};
+
 /*! Compute a set of descriptors (a numerical "fingerprint") of a
  *  particle's local environment.
+ *
+ *  The spherical harmonics of the bonds can be stored as they are, or
+ *  reduced to per-point averages or power spectra while they are computed,
+ *  which avoids storing an array with one row per bond. Any of these can be
+ *  stored in half precision to reduce the size of the output.
  */
 class LocalDescriptors
 {
@@ -36,10 +51,14 @@ public:
     //!
     //! \param l_max Maximum spherical harmonic l to consider
     //! \param negative_m whether to calculate Ylm for negative m
-    LocalDescriptors(unsigned int l_max, bool negative_m, LocalDescriptorOrientation orientation);
+    //! \param orientation The orientation mode to compute with
+    //! \param reduction The reduction of the bond spherical harmonics to store
+    //! \param half_precision whether to store the output in half precision
+    LocalDescriptors(unsigned int l_max, bool negative_m, LocalDescriptorOrientation orientation,
+                     LocalDescriptorReduction reduction = NoReduction, bool half_precision = false);
 
     //! Get the last number of spherical harmonics computed
-    unsigned int getNSphs() const
+    size_t getNSphs() const
     {
         return m_nSphs;
     }
@@ -52,17 +71,41 @@ public:
 
     //! Compute the local neighborhood descriptors given some
     //! positions and the number of particles
+    /*! If a bond geometry of nlist is provided, its bond vectors are used,
+     *  and in the Global orientation mode its spherical harmonics are read
+     *  instead of evaluated. Bonds of the other modes are rotated into the
+     *  frame of their query point, so their harmonics are always evaluated.
+     */
     void compute(const locality::NeighborQuery* nq, const vec3<float>* query_points,
                  unsigned int n_query_points, const quat<float>* orientations,
                  const freud::locality::NeighborList* nlist, locality::QueryArgs qargs,
-                 unsigned int max_num_neighbors = 0);
+                 unsigned int max_num_neighbors = 0, locality::BondGeometry* geometry = nullptr);
 
     //! Get a reference to the last computed spherical harmonic array
+    /*! This has one row per bond, or one row per point if the spherical
+     *  harmonics are averaged. It is empty for power spectra and half
+     *  precision output.
+     */
     const util::ManagedArray<std::complex<float>>& getSph() const
     {
         return m_sphArray;
     }
 
+    //! Get a reference to the last computed power spectra, with one row per point and one column per l
+    const util::ManagedArray<float>& getPowerSpectrum() const
+    {
+        return m_powerSpectrum;
+    }
+
+    //! Get a reference to the last computed half precision output
+    /*! This holds the bits of IEEE half precision floats. Spherical harmonics
+     *  have a last axis of size 2 holding their real and imaginary parts.
+     */
+    const util::ManagedArray<uint16_t>& getHalfOutput() const
+    {
+        return m_halfArray;
+    }
+
     //! Return the number of spherical harmonics that will be computed for each bond.
     unsigned int getSphWidth() const
     {
@@ -85,15 +128,53 @@ public:
         return m_orientation;
     }
 
+    LocalDescriptorReduction getReduction() const
+    {
+        return m_reduction;
+    }
+
+    bool getHalfPrecision() const
+    {
+        return m_half_precision;
+    }
+
+    //! Get the memory budget of the bonds, in bytes, or 0 if the bonds are not chunked.
+    size_t getMemoryBudget() const
+    {
+        return m_memory_budget;
+    }
+
+    //! Set the memory budget of the bonds found by queries for reductions.
+    /*! If the NeighborList of a query is estimated to need more bytes than
+     *  the budget (see locality::estimateNeighborListBytes), compute finds
+     *  the bonds of the averages and power spectra in chunks of query points
+     *  that fit in it instead, and the NeighborList is not stored. The
+     *  spherical harmonics of each bond are always computed from a
+     *  NeighborList of all bonds.
+     *
+     *  \param memory_budget The budget in bytes, or 0 to never chunk the bonds.
+     */
+    void setMemoryBudget(size_t memory_budget)
+    {
+        m_memory_budget = memory_budget;
+    }
+
 private:
     unsigned int m_l_max;                     //!< Maximum spherical harmonic l to calculate
     bool m_negative_m;                        //!< true if we should compute Ylm for negative m
-    unsigned int m_nSphs;                     //!< Last number of bond spherical harmonics computed
+    size_t m_nSphs;                           //!< Last number of bond spherical harmonics computed
     locality::NeighborList m_nlist;           //!< The NeighborList used in the last call to compute.
     LocalDescriptorOrientation m_orientation; //!< The orientation mode to compute with.
+    LocalDescriptorReduction m_reduction;     //!< The reduction of the bond spherical harmonics.
+    bool m_half_precision;                    //!< true if we should store the output in half precision
+    size_t m_memory_budget;                   //!< Bytes of the bonds of a chunk of query points, or 0.
 
-    //! Spherical harmonics for each neighbor
+    //! Spherical harmonics for each neighbor, or averaged for each point
     util::ManagedArray<std::complex<float>> m_sphArray;
+    //! Power spectra for each point
+    util::ManagedArray<float> m_powerSpectrum;
+    //! Half precision spherical harmonics or power spectra
+    util::ManagedArray<uint16_t> m_halfArray;
 };
 
 }; }; // end namespace freud::environment
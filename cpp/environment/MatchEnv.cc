@@ -1,16 +1,195 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_sort.h>
+#include <utility>
 
 #include "MatchEnv.h"
 
+#include "ConcurrentUnionFind.h"
 #include "NeighborBond.h"
 #include "NeighborComputeFunctional.h"
+#include "utils.h"
 
 namespace freud { namespace environment {
 
+namespace {
+
+//! Relative tolerance of bond length comparisons, covering the change of
+//! lengths of vectors rotated by registration in single precision.
+const float BOND_LENGTH_TOLERANCE = 1e-4;
+
+//! A match between two environments that united their clusters.
+struct EnvironmentMatch
+{
+    unsigned int i;                    //!< First environment.
+    unsigned int j;                    //!< Second environment.
+    rotmat3<float> rotation;           //!< Rotation taking the vectors of j to those of i.
+    std::vector<unsigned int> vec_map; //!< Index of the vector of j matching each vector of i.
+};
+
+//! Whether two sorted lists of bond lengths can belong to matching environments.
+/*! Vectors closer than the threshold differ in length by less than the
+ *  threshold, and pairing the lengths in sorted order minimizes the largest
+ *  difference of any pairing, so environments whose sorted bond lengths
+ *  differ by at least the threshold cannot match.
+ */
+bool bondLengthsMatch(const float* lengths1, const float* lengths2, unsigned int num_lengths, float threshold)
+{
+    for (unsigned int k = 0; k < num_lengths; ++k)
+    {
+        if (std::abs(lengths1[k] - lengths2[k])
+            >= threshold + BOND_LENGTH_TOLERANCE * (lengths1[k] + lengths2[k]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Get the vectors of an environment in their proper order and orientation.
+std::vector<vec3<float>> properVectors(const Environment& e)
+{
+    std::vector<vec3<float>> vecs(e.vecs.size());
+    for (unsigned int m = 0; m < e.vecs.size(); ++m)
+    {
+        vecs[m] = e.proper_rot * e.vecs[e.vec_ind[m]];
+    }
+    return vecs;
+}
+
+//! Make the environment characterized by a motif.
+Environment makeMotifEnvironment(const box::Box& box, const vec3<float>* motif, unsigned int motif_size)
+{
+    // set the IGNORE flag to true, since this is not an environment we have
+    // actually encountered in the simulation.
+    Environment e0 = Environment(true);
+
+    // loop through all the vectors in motif and add them to the environment.
+    // wrap all the vectors back into the box. I think this is necessary since
+    // all the vectors that will be added to actual particle environments will
+    // be wrapped into the box as well.
+    for (unsigned int i = 0; i < motif_size; i++)
+    {
+        vec3<float> p = box.wrap(motif[i]);
+        e0.addVec(p);
+    }
+    return e0;
+}
+
+//! Rotate and reorder the vectors of an environment to match a motif.
+/*! This is how merging the environment into the set of the motif aligns it.
+ */
+void alignToMotif(Environment& e, const BiMap<unsigned int, unsigned int>& vec_map,
+                  const rotmat3<float>& rotation)
+{
+    const std::vector<unsigned int> old_vec_ind = e.vec_ind;
+    for (unsigned int proper_ind = 0; proper_ind < vec_map.size(); ++proper_ind)
+    {
+        e.vec_ind[proper_ind] = old_vec_ind[vec_map.left.at(proper_ind)];
+    }
+    e.proper_rot = rotation * e.proper_rot;
+}
+
+//! Rotate and reorder the vectors of environments to match their clusters.
+/*! The root of each cluster keeps its environment as built, and every other
+ *  environment is rotated and reordered to match its neighbor closer to the
+ *  root in the spanning forest of matches. Clusters are independent, so they
+ *  are traversed in parallel.
+ */
+void alignEnvironments(const cluster::ConcurrentUnionFind& clusters,
+                       const std::vector<EnvironmentMatch>& matches, std::vector<Environment>& envs)
+{
+    const unsigned int Np = static_cast<unsigned int>(envs.size());
+
+    // List the matches of each environment.
+    std::vector<size_t> match_offsets(Np + 1, 0);
+    for (const EnvironmentMatch& environment_match : matches)
+    {
+        ++match_offsets[environment_match.i + 1];
+        ++match_offsets[environment_match.j + 1];
+    }
+    std::partial_sum(match_offsets.begin(), match_offsets.end(), match_offsets.begin());
+    std::vector<size_t> environment_matches(match_offsets[Np]);
+    std::vector<size_t> match_cursors(match_offsets.begin(), match_offsets.end() - 1);
+    for (size_t m = 0; m < matches.size(); ++m)
+    {
+        environment_matches[match_cursors[matches[m].i]++] = m;
+        environment_matches[match_cursors[matches[m].j]++] = m;
+    }
+
+    std::vector<unsigned int> roots;
+    for (unsigned int i = 0; i < Np; ++i)
+    {
+        if (clusters.find(i) == i && match_offsets[i + 1] > match_offsets[i])
+        {
+            roots.push_back(i);
+        }
+    }
+    util::forLoopWrapper(0, roots.size(), [&](size_t begin, size_t end) {
+        std::vector<unsigned int> inverse_vec_map;
+        std::vector<std::pair<unsigned int, size_t>> stack;
+        for (size_t r = begin; r < end; ++r)
+        {
+            // Traverse the tree depth first, storing each environment with the
+            // match it was reached through.
+            stack.assign(1, std::make_pair(roots[r], matches.size()));
+            while (!stack.empty())
+            {
+                const unsigned int parent = stack.back().first;
+                const size_t reached_through = stack.back().second;
+                stack.pop_back();
+                for (size_t k = match_offsets[parent]; k < match_offsets[parent + 1]; ++k)
+                {
+                    const size_t m = environment_matches[k];
+                    if (m == reached_through)
+                    {
+                        continue;
+                    }
+                    const EnvironmentMatch& environment_match = matches[m];
+                    const Environment& parent_env = envs[parent];
+                    Environment& child_env
+                        = envs[(environment_match.i == parent) ? environment_match.j : environment_match.i];
+                    if (environment_match.i == parent)
+                    {
+                        // The rotation takes the vectors of the child to
+                        // those of the parent.
+                        for (unsigned int n = 0; n < child_env.num_vecs; ++n)
+                        {
+                            child_env.vec_ind[n] = environment_match.vec_map[parent_env.vec_ind[n]];
+                        }
+                        child_env.proper_rot = parent_env.proper_rot * environment_match.rotation;
+                    }
+                    else
+                    {
+                        // The rotation takes the vectors of the parent to
+                        // those of the child, so it is inverted.
+                        inverse_vec_map.resize(child_env.num_vecs);
+                        for (unsigned int n = 0; n < child_env.num_vecs; ++n)
+                        {
+                            inverse_vec_map[environment_match.vec_map[n]] = n;
+                        }
+                        for (unsigned int n = 0; n < child_env.num_vecs; ++n)
+                        {
+                            child_env.vec_ind[n] = inverse_vec_map[parent_env.vec_ind[n]];
+                        }
+                        child_env.proper_rot = parent_env.proper_rot * transpose(environment_match.rotation);
+                    }
+                    stack.push_back(std::make_pair(child_env.env_ind, m));
+                }
+            }
+        }
+    });
+}
+
+}; // namespace
+
 /*****************
  * EnvDisjoinSet *
  *****************/
@@ -18,7 +197,7 @@ EnvDisjointSet::EnvDisjointSet(unsigned int Np) : rank(std::vector<unsigned int>
 {}
 
 void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
-                           BiMap<unsigned int, unsigned int> vec_map, rotmat3<float> rotation)
+                           const BiMap<unsigned int, unsigned int>& vec_map, const rotmat3<float>& rotation)
 {
     // if tree heights are equal, merge b to a
     if (rank[s[a].env_ind] == rank[s[b].env_ind])
@@ -41,7 +220,7 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
             // and set it properly.
             for (unsigned int proper_a_ind = 0; proper_a_ind < vec_map.size(); proper_a_ind++)
             {
-                unsigned int proper_b_ind = vec_map.left[proper_a_ind];
+                unsigned int proper_b_ind = vec_map.left.at(proper_a_ind);
 
                 // old_node_vec_ind[proper_b_ind] is "relative_b_ind"
                 s[node].vec_ind[proper_a_ind] = old_node_vec_ind[proper_b_ind];
@@ -81,7 +260,7 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
                 // and set it properly.
                 for (unsigned int proper_a_ind = 0; proper_a_ind < vec_map.size(); proper_a_ind++)
                 {
-                    unsigned int proper_b_ind = vec_map.left[proper_a_ind];
+                    unsigned int proper_b_ind = vec_map.left.at(proper_a_ind);
 
                     // old_node_vec_ind[proper_b_ind] is "relative_b_ind"
                     s[node].vec_ind[proper_a_ind] = old_node_vec_ind[proper_b_ind];
@@ -118,7 +297,7 @@ void EnvDisjointSet::merge(const unsigned int a, const unsigned int b,
                 // and set it properly.
                 for (unsigned int proper_b_ind = 0; proper_b_ind < vec_map.size(); proper_b_ind++)
                 {
-                    unsigned int proper_a_ind = vec_map.right[proper_b_ind];
+                    unsigned int proper_a_ind = vec_map.right.at(proper_b_ind);
 
                     // old_node_vec_ind[proper_a_ind] is "relative_a_ind"
                     s[node].vec_ind[proper_b_ind] = old_node_vec_ind[proper_a_ind];
@@ -271,6 +450,14 @@ std::vector<vec3<float>> EnvDisjointSet::getIndividualEnv(const unsigned int m)
  *************************/
 std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
                                                                        float threshold_sq, bool registration)
+{
+    RegisterBruteForce r = RegisterBruteForce(registration ? properVectors(e1) : std::vector<vec3<float>>());
+    return isSimilar(e1, e2, threshold_sq, registration, r);
+}
+
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+isSimilar(const Environment& e1, const Environment& e2, float threshold_sq, bool registration,
+          RegisterBruteForce& r)
 {
     BiMap<unsigned int, unsigned int> vec_map;
     rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
@@ -282,22 +469,15 @@ std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environme
         return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, vec_map);
     }
 
-    std::vector<vec3<float>> v1(e1.vecs.size());
-    std::vector<vec3<float>> v2(e2.vecs.size());
-
     // get the vectors into the proper orientation and order with respect to
     // their parent environment
-    for (unsigned int m = 0; m < e1.vecs.size(); m++)
-    {
-        v1[m] = e1.proper_rot * e1.vecs[e1.vec_ind[m]];
-        v2[m] = e2.proper_rot * e2.vecs[e2.vec_ind[m]];
-    }
+    const std::vector<vec3<float>> v1 = properVectors(e1);
+    std::vector<vec3<float>> v2 = properVectors(e2);
 
     // If we have to register, first find the rotated set of v2 that best maps
     // to v1. The Fit operation CHANGES v2.
     if (registration == true)
     {
-        RegisterBruteForce r = RegisterBruteForce(v1);
         r.Fit(v2);
         // get the optimal rotation to take v2 to v1
         std::vector<vec3<float>> rot = r.getRotation();
@@ -408,6 +588,14 @@ std::pair<Environment, Environment> makeEnvironments(const box::Box& box, const
 
 std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
                                                                           float& min_rmsd, bool registration)
+{
+    RegisterBruteForce r = RegisterBruteForce(properVectors(e1));
+    return minimizeRMSD(e1, e2, min_rmsd, registration, r);
+}
+
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+minimizeRMSD(const Environment& e1, const Environment& e2, float& min_rmsd, bool registration,
+             RegisterBruteForce& r)
 {
     BiMap<unsigned int, unsigned int> vec_map;
     rotmat3<float> rotation = rotmat3<float>(); // this initializes to the identity matrix
@@ -421,19 +609,11 @@ std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Enviro
         return std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>(rotation, vec_map);
     }
 
-    std::vector<vec3<float>> v1(e1.vecs.size());
-    std::vector<vec3<float>> v2(e2.vecs.size());
-
     // Get the vectors into the proper orientation and order with respect
     // to their parent environment
-    for (unsigned int m = 0; m < e1.vecs.size(); m++)
-    {
-        v1[m] = e1.proper_rot * e1.vecs[e1.vec_ind[m]];
-        v2[m] = e2.proper_rot * e2.vecs[e2.vec_ind[m]];
-    }
+    std::vector<vec3<float>> v2 = properVectors(e2);
 
     // call RegisterBruteForce::Fit and update min_rmsd accordingly
-    RegisterBruteForce r = RegisterBruteForce(v1);
     // If we have to register, first find the rotated set of v2 that best
     // maps to v1. The Fit operation CHANGES v2.
     if (registration == true)
@@ -501,13 +681,13 @@ Environment MatchEnv::buildEnv(const freud::locality::NeighborQuery* nq,
     // set the environment index equal to the particle index
     ei.env_ind = env_ind;
 
-    for (; bond < num_bonds && nlist->getNeighbors()(bond, 0) == i; ++bond)
+    for (; bond < num_bonds && nlist->getQueryPointIndices()[bond] == i; ++bond)
     {
         // compute vec{r} between the two particles
-        const size_t j(nlist->getNeighbors()(bond, 1));
+        const size_t j(nlist->getPointIndices()[bond]);
         if (i != j)
         {
-            vec3<float> delta(bondVector(locality::NeighborBond(i, j), nq, nq->getPoints()));
+            vec3<float> delta(bondVector(nlist, bond, nq, nq->getPoints()));
             ei.addVec(delta);
         }
     }
@@ -533,135 +713,185 @@ void EnvironmentCluster::compute(const freud::locality::NeighborQuery* nq,
 
     nlist.validate(Np, Np);
     env_nlist.validate(Np, Np);
-    size_t env_bond(0);
     const size_t env_num_bonds(env_nlist.getNumBonds());
 
-    // create a disjoint set where all particles belong in their own cluster
-    EnvDisjointSet dj(Np);
-
-    // add all the environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment
-    // matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
-    for (unsigned int i = 0; i < Np; i++)
+    // Build the environment of every point. Environments are compared as
+    // they are built, and only aligned to their clusters once all matches are
+    // known, so comparisons do not depend on each other.
+    std::vector<Environment> envs(Np);
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            size_t env_bond = env_nlist.getSegments()[i];
+            envs[i] = buildEnv(nq, &env_nlist, env_num_bonds, env_bond, i, i);
+        }
+    });
+    unsigned int max_num_neigh = 0;
+    for (const Environment& env : envs)
     {
-        Environment ei = buildEnv(nq, &env_nlist, env_num_bonds, env_bond, i, i);
-        dj.s.push_back(ei);
-        dj.m_max_num_neigh = std::max(dj.m_max_num_neigh, ei.num_vecs);
-        ;
+        max_num_neigh = std::max(max_num_neigh, env.num_vecs);
     }
 
-    // reallocate the m_point_environments array
-    m_point_environments.prepare({Np, dj.m_max_num_neigh});
-
-    size_t bond(0);
-    // loop through points
-    for (unsigned int i = 0; i < Np; i++)
-    {
-        if (global == false)
+    // The sorted bond lengths of each environment are a rotation and
+    // permutation invariant fingerprint used to skip comparisons of
+    // environments that cannot match.
+    std::vector<float> bond_lengths(size_t(Np) * max_num_neigh);
+    std::vector<float> mean_bond_lengths(Np, 0);
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            // loop over the neighbors
-            for (; bond < nlist.getNumBonds() && nlist.getNeighbors()(bond, 0) == i; ++bond)
+            float* lengths = bond_lengths.data() + i * max_num_neigh;
+            for (unsigned int m = 0; m < envs[i].num_vecs; ++m)
             {
-                const size_t j(nlist.getNeighbors()(bond, 1));
-                std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-                    = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
-                rotmat3<float> rotation = mapping.first;
-                BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-                // if the mapping between the vectors of the environments
-                // is NOT empty, then the environments are similar, so
-                // merge them.
-                if (!vec_map.empty())
-                {
-                    // merge the two sets using the disjoint set
-                    unsigned int a = dj.find(i);
-                    unsigned int b = dj.find(j);
-                    if (a != b)
-                        dj.merge(i, j, vec_map, rotation);
-                }
+                lengths[m] = std::sqrt(dot(envs[i].vecs[m], envs[i].vecs[m]));
+                mean_bond_lengths[i] += lengths[m];
+            }
+            std::sort(lengths, lengths + envs[i].num_vecs);
+            if (envs[i].num_vecs > 0)
+            {
+                mean_bond_lengths[i] /= float(envs[i].num_vecs);
             }
         }
-        else
+    });
+
+    // Compare pairs of environments in parallel, uniting the clusters of
+    // matching environments. Pairs already in the same cluster are skipped,
+    // and the matches that united clusters form a spanning forest of the
+    // clusters, which is used to align their environments.
+    cluster::ConcurrentUnionFind clusters(Np);
+    tbb::enumerable_thread_specific<std::vector<EnvironmentMatch>> local_matches;
+    auto match = [&](unsigned int i, unsigned int j) {
+        if (envs[i].num_vecs != envs[j].num_vecs || clusters.same(i, j)
+            || !bondLengthsMatch(bond_lengths.data() + size_t(i) * max_num_neigh,
+                                 bond_lengths.data() + size_t(j) * max_num_neigh, envs[i].num_vecs,
+                                 threshold))
         {
-            // loop over all other particles
-            for (unsigned int j = i + 1; j < Np; j++)
+            return;
+        }
+        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+            = isSimilar(envs[i], envs[j], m_threshold_sq, registration);
+        // if the mapping between the vectors of the environments is NOT
+        // empty, then the environments are similar, so merge them.
+        if (!mapping.second.empty() && clusters.unite(i, j))
+        {
+            EnvironmentMatch environment_match;
+            environment_match.i = i;
+            environment_match.j = j;
+            environment_match.rotation = mapping.first;
+            environment_match.vec_map.resize(envs[i].num_vecs);
+            for (unsigned int m = 0; m < envs[i].num_vecs; ++m)
+            {
+                environment_match.vec_map[m] = mapping.second.left.at(m);
+            }
+            local_matches.local().push_back(std::move(environment_match));
+        }
+    };
+
+    if (global)
+    {
+        // Matching environments have the same number of bonds and mean bond
+        // lengths differing by less than the threshold. Sorting points by
+        // both, each point only needs to be compared to the following points
+        // up to that difference.
+        std::vector<unsigned int> order(Np);
+        std::iota(order.begin(), order.end(), 0);
+        tbb::parallel_sort(order.begin(), order.end(), [&](unsigned int a, unsigned int b) {
+            if (envs[a].num_vecs != envs[b].num_vecs)
+            {
+                return envs[a].num_vecs < envs[b].num_vecs;
+            }
+            if (mean_bond_lengths[a] != mean_bond_lengths[b])
+            {
+                return mean_bond_lengths[a] < mean_bond_lengths[b];
+            }
+            return a < b;
+        });
+        util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p)
             {
-                std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-                    = isSimilar(dj.s[i], dj.s[j], m_threshold_sq, registration);
-                rotmat3<float> rotation = mapping.first;
-                BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-                // if the mapping between the vectors of the environments
-                // is NOT empty, then the environments are similar, so
-                // merge them.
-                if (!vec_map.empty())
+                const unsigned int i = order[p];
+                for (size_t q = p + 1; q < Np; ++q)
                 {
-                    // merge the two sets using the disjoint set
-                    unsigned int a = dj.find(i);
-                    unsigned int b = dj.find(j);
-                    if (a != b)
-                        dj.merge(i, j, vec_map, rotation);
+                    const unsigned int j = order[q];
+                    if (envs[j].num_vecs != envs[i].num_vecs
+                        || mean_bond_lengths[j] - mean_bond_lengths[i]
+                            >= threshold
+                                + BOND_LENGTH_TOLERANCE * (mean_bond_lengths[i] + mean_bond_lengths[j]))
+                    {
+                        break;
+                    }
+                    match(std::min(i, j), std::max(i, j));
                 }
             }
-        }
+        });
+    }
+    else
+    {
+        util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                const size_t segment = nlist.getSegments()[i];
+                for (size_t bond = segment; bond < segment + nlist.getCounts()[i]; ++bond)
+                {
+                    match(i, nlist.getPointIndices()[bond]);
+                }
+            }
+        });
     }
 
-    // done looping over points. All clusters are now determined. Renumber
-    // them from zero to num_clusters-1.
-    m_num_clusters = populateEnv(dj);
-}
-
-unsigned int EnvironmentCluster::populateEnv(EnvDisjointSet dj)
-{
-    std::map<unsigned int, unsigned int> label_map;
-    std::map<unsigned int, std::vector<vec3<float>>> cluster_env;
+    // done looping over points. All clusters are now determined.
+    std::vector<EnvironmentMatch> matches;
+    for (auto local = local_matches.begin(); local != local_matches.end(); ++local)
+    {
+        std::move(local->begin(), local->end(), std::back_inserter(matches));
+    }
+    alignEnvironments(clusters, matches, envs);
 
-    // loop over all environments
-    unsigned int label_ind;
-    unsigned int cur_set = 0;
-    unsigned int particle_ind = 0;
-    for (unsigned int i = 0; i < dj.s.size(); i++)
+    // Renumber clusters from zero to num_clusters-1 in order of their first
+    // point, and store the aligned environments of points and clusters.
+    std::vector<unsigned int> root_labels(Np, Np);
+    m_num_clusters = 0;
+    for (unsigned int i = 0; i < Np; ++i)
     {
-        // only count this if the environment is physical
-        if (dj.s[i].ghost == false)
+        const unsigned int root = clusters.find(i);
+        if (root_labels[root] == Np)
         {
-            // grab the set of vectors that define this individual environment
-            std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(i);
+            root_labels[root] = m_num_clusters++;
+        }
+        m_env_index[i] = root_labels[root];
+    }
 
-            unsigned int c = dj.find(i);
-            // insert the set into the mapping if we haven't seen it before.
-            // also grab the vectors that define the set and insert them into cluster_env
-            if (label_map.count(c) == 0)
-            {
-                label_map[c] = cur_set;
-                std::vector<vec3<float>> vecs = dj.getAvgEnv(c);
-                label_ind = label_map[c];
-                cluster_env[label_ind] = vecs;
-                cur_set++;
-            }
-            else
+    m_point_environments.prepare({Np, max_num_neigh});
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            for (unsigned int m = 0; m < envs[i].num_vecs; ++m)
             {
-                label_ind = label_map[c];
+                m_point_environments(i, m) = envs[i].proper_rot * envs[i].vecs[envs[i].vec_ind[m]];
             }
+        }
+    });
 
-            // label this particle in m_env_index
-            m_env_index[particle_ind] = label_ind;
-            for (unsigned int m = 0; m < part_vecs.size(); m++)
-            {
-                m_point_environments(particle_ind, m) = part_vecs[m];
-            }
-            particle_ind++;
+    // Cluster environments are averaged over the aligned environments of
+    // their points.
+    m_cluster_environments.assign(m_num_clusters, std::vector<vec3<float>>(max_num_neigh));
+    std::vector<unsigned int> cluster_sizes(m_num_clusters, 0);
+    for (unsigned int i = 0; i < Np; ++i)
+    {
+        std::vector<vec3<float>>& cluster_env = m_cluster_environments[m_env_index[i]];
+        for (unsigned int m = 0; m < max_num_neigh; ++m)
+        {
+            cluster_env[m] += m_point_environments(i, m);
         }
+        ++cluster_sizes[m_env_index[i]];
     }
-
-    // Now update the vector of environments from the map.
-    m_cluster_environments.resize(cluster_env.size());
-    for (auto it = cluster_env.begin(); it != cluster_env.end(); ++it)
+    for (unsigned int c = 0; c < m_num_clusters; ++c)
     {
-        m_cluster_environments[it->first] = it->second;
+        for (unsigned int m = 0; m < max_num_neigh; ++m)
+        {
+            m_cluster_environments[c][m] /= float(cluster_sizes[c]);
+        }
     }
-
-    // specify the number of cluster environments
-    return cur_set;
 }
 
 /*************************
@@ -680,68 +910,46 @@ void EnvironmentMotifMatch::compute(const freud::locality::NeighborQuery* nq,
 
     nlist.validate(Np, Np);
 
-    // create a disjoint set where all particles belong in their own cluster.
-    // this has to have ONE MORE environment than there are actual particles,
-    // because we're inserting the motif into it.
-    EnvDisjointSet dj(Np + 1);
-    dj.m_max_num_neigh = motif_size;
-
     // reallocate the m_point_environments array
     m_point_environments.prepare({Np, motif_size});
-
-    // create the environment characterized by motif. Index it as 0.
-    // set the IGNORE flag to true, since this is not an environment we have
-    // actually encountered in the simulation.
-    Environment e0 = Environment(true);
-
-    // loop through all the vectors in motif and add them to the environment.
-    // wrap all the vectors back into the box. I think this is necessary since
-    // all the vectors that will be added to actual particle environments will
-    // be wrapped into the box as well.
-    for (unsigned int i = 0; i < motif_size; i++)
-    {
-        vec3<float> p = nq->getBox().wrap(motif[i]);
-        e0.addVec(p);
-    }
-
-    // add this environment to the set
-    dj.s.push_back(e0);
-
-    size_t bond(0);
-    const size_t num_bonds(nlist.getNumBonds());
-
     m_matches.prepare(Np);
 
-    // loop through the particles and add their environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment
-    // matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
-    for (unsigned int i = 0; i < Np; i++)
-    {
-        unsigned int dummy = i + 1;
-        Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, dummy);
-        dj.s.push_back(ei);
+    const Environment e0 = makeMotifEnvironment(nq->getBox(), motif, motif_size);
+    const size_t num_bonds(nlist.getNumBonds());
 
-        // if the environment matches e0, merge it into the e0 environment set
-        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-            = isSimilar(dj.s[0], dj.s[dummy], m_threshold_sq, registration);
-        rotmat3<float> rotation = mapping.first;
-        BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-        // if the mapping between the vectors of the environments is NOT empty,
-        // then the environments are similar.
-        if (!vec_map.empty())
+    // Points are compared to the motif independently. Each thread reuses a
+    // registration of the motif, seeded by point index so that results do
+    // not depend on the number of threads.
+    tbb::enumerable_thread_specific<RegisterBruteForce> registrations(RegisterBruteForce(properVectors(e0)));
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        RegisterBruteForce& r = registrations.local();
+        for (size_t i = begin; i < end; ++i)
         {
-            dj.merge(0, dummy, vec_map, rotation);
-            m_matches[i] = true;
-        }
-        // grab the set of vectors that define this individual environment
-        std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(dummy);
+            size_t bond = nlist.getSegments()[i];
+            Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, i + 1);
 
-        for (unsigned int m = 0; m < part_vecs.size(); m++)
-        {
-            m_point_environments(i, m) = part_vecs[m];
+            // if the environment matches e0, align it to the motif
+            if (registration)
+            {
+                r.setSeed(i);
+            }
+            std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+                = isSimilar(e0, ei, m_threshold_sq, registration, r);
+            // if the mapping between the vectors of the environments is NOT empty,
+            // then the environments are similar.
+            if (!mapping.second.empty())
+            {
+                alignToMotif(ei, mapping.second, mapping.first);
+                m_matches[i] = true;
+            }
+            // store the vectors that define this individual environment
+            const std::vector<vec3<float>> part_vecs = properVectors(ei);
+            for (unsigned int m = 0; m < std::min(motif_size, ei.num_vecs); m++)
+            {
+                m_point_environments(i, m) = part_vecs[m];
+            }
         }
-    }
+    });
 }
 
 /****************************
@@ -757,74 +965,48 @@ void EnvironmentRMSDMinimizer::compute(const freud::locality::NeighborQuery* nq,
 
     unsigned int Np = nq->getNPoints();
 
-    // create a disjoint set where all particles belong in their own cluster.
-    // this has to have ONE MORE environment than there are actual particles,
-    // because we're inserting the motif into it.
-    EnvDisjointSet dj(Np + 1);
-    dj.m_max_num_neigh = motif_size;
-
     // reallocate the m_point_environments array
     m_point_environments.prepare({Np, motif_size});
-
-    // create the environment characterized by motif. Index it as 0.
-    // set the IGNORE flag to true, since this is not an environment we
-    // have actually encountered in the simulation.
-    Environment e0 = Environment(true);
-
-    // loop through all the vectors in motif and add them to the environment.
-    // wrap all the vectors back into the box. I think this is necessary since
-    // all the vectors that will be added to actual particle environments will
-    // be wrapped into the box as well.
-    for (unsigned int i = 0; i < motif_size; i++)
-    {
-        vec3<float> p = nq->getBox().wrap(motif[i]);
-        e0.addVec(p);
-    }
-
-    // add this environment to the set
-    dj.s.push_back(e0);
-
-    size_t bond(0);
-    const size_t num_bonds(nlist.getNumBonds());
-
     m_rmsds.prepare(Np);
 
-    // loop through the particles and add their environments to the set
-    // take care, here: set things up s.t. the env_ind of every environment
-    // matches its location in the disjoint set.
-    // if you don't do this, things will get screwy.
-    for (unsigned int i = 0; i < Np; i++)
-    {
-        unsigned int dummy = i + 1;
-        Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, dummy);
-        dj.s.push_back(ei);
-
-        // if the environment matches e0, merge it into the e0 environment set
-        float min_rmsd = -1.0;
-        std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
-            = minimizeRMSD(dj.s[0], dj.s[dummy], min_rmsd, registration);
-        rotmat3<float> rotation = mapping.first;
-        BiMap<unsigned int, unsigned int> vec_map = mapping.second;
-        // populate the min_rmsd vector
-        m_rmsds[i] = min_rmsd;
+    const Environment e0 = makeMotifEnvironment(nq->getBox(), motif, motif_size);
+    const size_t num_bonds(nlist.getNumBonds());
 
-        // if the mapping between the vectors of the environments is NOT
-        // empty, then the environments are similar.
-        // minimizeRMSD should always return a non-empty vec_map, except if
-        // e0 and e1 have different numbers of vectors.
-        if (!vec_map.empty())
+    // Points are compared to the motif independently. Each thread reuses a
+    // registration of the motif, seeded by point index so that results do
+    // not depend on the number of threads.
+    tbb::enumerable_thread_specific<RegisterBruteForce> registrations(RegisterBruteForce(properVectors(e0)));
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        RegisterBruteForce& r = registrations.local();
+        for (size_t i = begin; i < end; ++i)
         {
-            dj.merge(0, dummy, vec_map, rotation);
-        }
-
-        // grab the set of vectors that define this individual environment
-        std::vector<vec3<float>> part_vecs = dj.getIndividualEnv(dummy);
+            size_t bond = nlist.getSegments()[i];
+            Environment ei = buildEnv(nq, &nlist, num_bonds, bond, i, i + 1);
 
-        for (unsigned int m = 0; m < part_vecs.size(); m++)
-        {
-            m_point_environments(i, m) = part_vecs[m];
+            if (registration)
+            {
+                r.setSeed(i);
+            }
+            float min_rmsd = -1.0;
+            std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> mapping
+                = minimizeRMSD(e0, ei, min_rmsd, registration, r);
+            // populate the min_rmsd vector
+            m_rmsds[i] = min_rmsd;
+
+            // minimizeRMSD should always return a non-empty vec_map, except if
+            // e0 and e1 have different numbers of vectors.
+            if (!mapping.second.empty())
+            {
+                alignToMotif(ei, mapping.second, mapping.first);
+            }
+            // store the vectors that define this individual environment
+            const std::vector<vec3<float>> part_vecs = properVectors(ei);
+            for (unsigned int m = 0; m < std::min(motif_size, ei.num_vecs); m++)
+            {
+                m_point_environments(i, m) = part_vecs[m];
+            }
         }
-    }
+    });
 }
 
 }; }; // end namespace freud::environment
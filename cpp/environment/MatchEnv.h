@@ -62,8 +62,8 @@ struct EnvDisjointSet
      * the right. The rotation must take the set of PROPERLY ROTATED vectors b
      * and rotate them to match the set of PROPERLY ROTATED vectors a
      */
-    void merge(const unsigned int a, const unsigned int b, BiMap<unsigned int, unsigned int> vec_map,
-               rotmat3<float> rotation);
+    void merge(const unsigned int a, const unsigned int b, const BiMap<unsigned int, unsigned int>& vec_map,
+               const rotmat3<float>& rotation);
 
     //! Find the set with a given element (taken mostly from Cluster.cc).
     unsigned int find(const unsigned int c);
@@ -125,6 +125,15 @@ std::pair<Environment, Environment> makeEnvironments(const box::Box& box, const
 std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> minimizeRMSD(Environment& e1, Environment& e2,
                                                                           float& min_rmsd, bool registration);
 
+//! Overload of the above minimizeRMSD function reusing a brute force registration.
+/*! \param r Registration whose reference points are the properly ordered and
+ *           rotated vectors of e1, so that it can be reused to compare many
+ *           environments to e1.
+ */
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+minimizeRMSD(const Environment& e1, const Environment& e2, float& min_rmsd, bool registration,
+             RegisterBruteForce& r);
+
 //! Overload of the above minimizeRMSD function that provides an easier interface to Python.
 /*! Construct the environments accordingly, and utilize minimizeRMSD() as
  * above. Arguments are pointers to interface directly with python. Return
@@ -167,6 +176,15 @@ std::map<unsigned int, unsigned int> minimizeRMSD(const box::Box& box, const vec
 std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>> isSimilar(Environment& e1, Environment& e2,
                                                                        float threshold_sq, bool registration);
 
+//! Overload of the above isSimilar function reusing a brute force registration.
+/*! \param r Registration whose reference points are the properly ordered and
+ *           rotated vectors of e1, so that it can be reused to compare many
+ *           environments to e1. It is only used if registration is true.
+ */
+std::pair<rotmat3<float>, BiMap<unsigned int, unsigned int>>
+isSimilar(const Environment& e1, const Environment& e2, float threshold_sq, bool registration,
+          RegisterBruteForce& r);
+
 //! Overload of the above isSimilar function that provides an easier interface to Python.
 /*! If the two environments correspond, returns a std::pair of the rotation matrix that takes the
  * vectors of e2 to the vectors of e1 AND the mapping between the properly
@@ -229,6 +247,16 @@ protected:
  * point. By performing this sort of registration between various pairs of
  * points, we identify regions where neighboring points share similar local
  * environments.
+ *
+ * Pairs of environments are compared in parallel, and matching pairs are
+ * united with a concurrent union-find. Pairs already in the same cluster are
+ * not compared, and neither are pairs whose sorted bond lengths, which do not
+ * change under rotations and permutations of the bonds, differ by at least
+ * the threshold, since their environments cannot match. In global mode,
+ * points are sorted by their number of bonds and mean bond length, so each
+ * point is only compared to the points with nearby mean bond lengths rather
+ * than to all other points. The environments of each cluster are aligned
+ * once all matches are known, following the matches that united the cluster.
  */
 class EnvironmentCluster : public MatchEnv
 {
@@ -249,8 +277,8 @@ public:
      * environments and then attempts to cluster nearby particles with similar
      * environments, unless global is set true. Otherwise, it performs a
      * pairwise comparison of all particle environments to perform the match.
-     * WARNING: A global search can be extremely slow.
-     * This is taken from Cluster.cc and SolLiq.cc and LocalQlNear.cc
+     * WARNING: A global search can be slow if many environments have similar
+     * bond lengths without matching.
      *
      * \param env_nlist The NeighborList used to build the environment of every particle.
      * \param nlist The NeighborList used to determine the neighbors against which
@@ -291,24 +319,6 @@ public:
     }
 
 private:
-    //! Populate the env_index, env and tot_env arrays (updated by reference) based on the contents of an
-    //! EnvDisjointSet.
-    /*! T
-     * \param dj The object encoding the set of clusters found.
-     * \param env_index An array indexed by point id indicating the cluster id for each point.
-     * \param cluster_env A mapping from cluster id to a list of vectors composing
-     *                    that cluster's environment. A null pointer may be passed
-     *                    indicating that we do not need to keep track of cluster
-     *                    environments.
-     * \param tot_env An array indexed by point id indicating the environment of each point.
-     * \param reLabel If true, the cluster ids are relabeled to ensur contiguous
-     *                ordering from 0 to the number of clusters. Otherwise, the
-     *                cluster ids will match the point id of the first point found
-     *                with that environment (which defines the cluster).
-     * \return The number of clusters found.
-     */
-    unsigned int populateEnv(EnvDisjointSet dj);
-
     unsigned int m_num_clusters;                  //!< Last number of local environments computed
     util::ManagedArray<unsigned int> m_env_index; //!< Cluster index determined for each particle
     std::vector<std::vector<vec3<float>>>
@@ -4,10 +4,12 @@
 #ifndef REGISTRATION_H
 #define REGISTRATION_H
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <random>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 #ifdef _WIN32
@@ -23,6 +25,7 @@
 
 #include "BiMap.h"
 #include "VectorMath.h"
+#include "utils.h"
 
 namespace freud { namespace environment {
 
@@ -110,9 +113,33 @@ inline matrix Rotate(const matrix& R, const matrix& P)
 // some helpful references:
 // http://cnx.org/contents/HV-RsdwL@23/Molecular-Distance-Measures
 // http://btk.sourceforge.net/html_docs/0.8.1/rmsd_theory.html
+inline Eigen::Matrix3d KabschRotation(const Eigen::Matrix3d& A)
+{
+    // A = P^T Q is the 3x3 covariance of the two point sets. All matrices
+    // have fixed sizes, so no memory is allocated here.
+    Eigen::JacobiSVD<Eigen::Matrix3d> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
+    const Eigen::Matrix3d U = svd.matrixU();
+    Eigen::Matrix3d V = svd.matrixV();
+
+    // if the rotation as we've found it, rot=VU^T, is IMPROPER, find the next best
+    // (proper) rotation by reflecting the smallest principal axis in rot:
+    if ((V * U.transpose()).determinant() < 0)
+    {
+        V.col(2) *= -1.0;
+    }
+    return V * U.transpose();
+}
+
 inline void KabschAlgorithm(const matrix& P, const matrix& Q, matrix& Rotation)
 {
     // Preconditions: P and Q have been translated to have the same center of mass.
+    if (P.cols() == 3 && Q.cols() == 3)
+    {
+        // Three dimensional points use the fixed size path.
+        const Eigen::Matrix3d A = P.transpose() * Q;
+        Rotation = KabschRotation(A);
+        return;
+    }
     matrix A = P.transpose() * Q;
     // singular value decomposition (~ eigen decomposition)
     Eigen::JacobiSVD<matrix> svd(A, Eigen::ComputeFullU | Eigen::ComputeFullV);
@@ -155,144 +182,138 @@ inline void AlignVectorSets(matrix& P, matrix& Q, matrix* pRotation = NULL)
 class RegisterBruteForce
 {
 public:
-    RegisterBruteForce(std::vector<vec3<float>> vecs) : m_rmsd(0.0), m_tol(1e-6), m_shuffles(1)
-    {
-        // make the Eigen matrix from vecs
-        m_ref_points = makeEigenMatrix(vecs);
-    }
+    RegisterBruteForce(std::vector<vec3<float>> vecs)
+        : m_ref_points(std::move(vecs)), m_rmsd(0.0), m_tol(1e-6), m_shuffles(1), m_seeded(false)
+    {}
 
     ~RegisterBruteForce() {}
 
     void Fit(std::vector<vec3<float>>& pts)
     {
-        matrix points;
-        matrix p, q, r;
-        // make the Eigen matrix from pts
-        points = makeEigenMatrix(pts);
-        int num_pts;
-
-        unsigned int N = points.rows();
-        if (N != m_ref_points.rows())
+        const unsigned int N = pts.size();
+        if (N != m_ref_points.size())
         {
             std::ostringstream msg;
-            msg << "There are " << m_ref_points.rows() << " reference points and " << N << " points. ";
+            msg << "There are " << m_ref_points.size() << " reference points and " << N << " points. ";
             msg << "Brute force matching requires the same number of reference points and points!"
                 << std::endl;
             throw std::invalid_argument(msg.str());
         }
 
-        RandomNumber<std::mt19937_64> rng;
+        // Each candidate alignment maps (up to) three of the points onto
+        // three randomly chosen reference points, so the candidates are all
+        // ordered triplets of points. They are enumerated in the order of
+        // the combinations and their permutations.
+        const unsigned int num_pts = (N < 3) ? N : 3;
+        std::vector<unsigned int> candidates;
+        size_t comb[3] = {0, 1, 2};
+        do
+        {
+            size_t perm[3] = {comb[0], comb[1], comb[2]};
+            do
+            {
+                candidates.insert(candidates.end(), perm, perm + num_pts);
+            } while (std::next_permutation(perm, perm + num_pts));
+        } while (NextCombination(comb, N, num_pts));
+        const size_t num_candidates = (num_pts == 0) ? 0 : candidates.size() / num_pts;
+
+        std::vector<Eigen::Matrix3d> rotations(CANDIDATE_BLOCK_SIZE);
+        std::vector<double> rmsds(CANDIDATE_BLOCK_SIZE);
+        Eigen::Matrix3d best_rotation = Eigen::Matrix3d::Identity();
+
+        if (!m_seeded)
+        {
+            m_rng.seed_generator();
+        }
         double rmsd_min = -1.0;
-        for (size_t shuffles = 0; shuffles < m_shuffles; shuffles++)
+        bool converged = false;
+        for (size_t shuffles = 0; shuffles < m_shuffles && !converged; shuffles++)
         {
-            int p0 = 0, p1 = 0, p2 = 0;
-            while (p0 == p1 || p0 == p2 || p1 == p2)
+            int ref[3] = {0, 0, 0};
+            while (ref[0] == ref[1] || ref[0] == ref[2] || ref[1] == ref[2])
             {
-                p0 = rng.random_int(0, N - 1);
+                ref[0] = m_rng.random_int(0, N - 1);
                 if (N == 1)
                 {
-                    p1 = -2;
+                    ref[1] = -2;
                 }
                 else
                 {
-                    p1 = rng.random_int(0, N - 1);
+                    ref[1] = m_rng.random_int(0, N - 1);
                 }
 
                 if (N == 2 || N == 1)
                 {
-                    p2 = -1;
+                    ref[2] = -1;
                 }
                 else
                 {
-                    p2 = rng.random_int(0, N - 1);
+                    ref[2] = m_rng.random_int(0, N - 1);
                 }
             }
 
-            size_t comb[3] = {0, 1, 2};
-            if (N == 2)
-            {
-                num_pts = 2;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                p.row(1) = m_ref_points.row(p1);
-                q.resize(num_pts, m_ref_points.cols());
-            }
-            else if (N == int(1))
-            {
-                num_pts = 1;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                q.resize(num_pts, m_ref_points.cols());
-            }
-            else
-            {
-                num_pts = 3;
-                p.resize(num_pts, m_ref_points.cols());
-                p.row(0) = m_ref_points.row(p0);
-                p.row(1) = m_ref_points.row(p1);
-                p.row(2) = m_ref_points.row(p2);
-                q.resize(num_pts, m_ref_points.cols());
-            }
-            do
+            // Candidates are evaluated in parallel in consecutive blocks,
+            // which are then scanned in order. This finds the same alignment
+            // as evaluating them one after the other: the first one within
+            // the tolerance, or else the first one with the smallest RMSD.
+            for (size_t block = 0; block < num_candidates && !converged; block += CANDIDATE_BLOCK_SIZE)
             {
-                do
-                {
-                    if (N == int(2))
-                    {
-                        q.row(0) = points.row(comb[0]);
-                        q.row(1) = points.row(comb[1]);
-                    }
-                    else if (N == int(1))
-                    {
-                        q.row(0) = points.row(comb[0]);
-                    }
-                    else
-                    {
-                        q.row(0) = points.row(comb[0]);
-                        q.row(1) = points.row(comb[1]);
-                        q.row(2) = points.row(comb[2]);
-                    }
-
-                    // finds the optimal rotation of the FIRST input set
-                    // of points such that they match the SECOND input
-                    // set of points
-                    KabschAlgorithm(q, p, r);
-
-                    // The rotation that we've found from the
-                    // KabschAlgorithm actually acts on P^T.
-                    matrix rot_points = Rotate(r, points.transpose());
-
-                    // feed back in the TRANSPOSE of rot_points such that
-                    // the input matrix is (Nx3).
-                    BiMap<unsigned int, unsigned int> vec_map;
-                    double rmsd = AlignedRMSDTree(rot_points.transpose(), vec_map);
-                    if (rmsd < rmsd_min || rmsd_min < 0.0)
-                    {
-                        m_rmsd = rmsd;
-                        m_rotation = r;
-                        m_vec_map = vec_map;
-                        rmsd_min = m_rmsd;
-                        if (rmsd_min < m_tol)
+                // std::min takes references, so it is passed a copy of the constant, which has no
+                // definition outside the class.
+                const size_t block_size = std::min(size_t(CANDIDATE_BLOCK_SIZE), num_candidates - block);
+                util::forLoopWrapper(
+                    0, block_size,
+                    [&](size_t begin, size_t end) {
+                        std::vector<vec3<float>> fit_points(N);
+                        std::vector<char> used(N);
+                        for (size_t c = begin; c < end; ++c)
                         {
-                            // The rotation that we've found from the KabschAlgorithm
-                            // actually acts on P^T.
-                            matrix ptsT = Rotate(m_rotation, points.transpose());
-                            // Then we have to take the transpose again to get our matrix
-                            // back to its original dimensionality.
-                            pts = makeVec3Matrix(ptsT.transpose());
-                            return;
+                            // Find the optimal rotation of the points of the
+                            // candidate onto the reference points.
+                            const unsigned int* cand = &candidates[(block + c) * num_pts];
+                            Eigen::Matrix3d A = Eigen::Matrix3d::Zero();
+                            for (unsigned int i = 0; i < num_pts; ++i)
+                            {
+                                A += toEigen(pts[cand[i]]) * toEigen(m_ref_points[ref[i]]).transpose();
+                            }
+                            rotations[c] = KabschRotation(A);
+                            for (unsigned int i = 0; i < N; ++i)
+                            {
+                                fit_points[i] = rotate(rotations[c], pts[i]);
+                            }
+                            rmsds[c] = matchPoints(fit_points, used, nullptr);
                         }
+                    },
+                    num_candidates >= MIN_PARALLEL_CANDIDATES);
+
+                for (size_t c = 0; c < block_size && !converged; ++c)
+                {
+                    if (rmsds[c] < rmsd_min || rmsd_min < 0.0)
+                    {
+                        rmsd_min = rmsds[c];
+                        best_rotation = rotations[c];
+                        converged = rmsd_min < m_tol;
                     }
-                } while (std::next_permutation(comb, comb + num_pts));
-            } while (NextCombination(comb, N, num_pts));
+                }
+            }
         } // end for loop over shuffles
-        // The rotation that we've found from the KabschAlgorithm
-        // actually acts on P^T.
-        matrix ptsT = Rotate(m_rotation, points.transpose());
-        // Then we have to take the transpose again to get our matrix
-        // back to its original dimensionality.
-        pts = makeVec3Matrix(ptsT.transpose());
-        return;
+
+        // Recover the mapping of the best alignment, and rotate the points.
+        std::vector<vec3<float>> fit_points(N);
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            fit_points[i] = rotate(best_rotation, pts[i]);
+        }
+        std::vector<char> used(N);
+        std::vector<unsigned int> matches(N);
+        m_rmsd = matchPoints(fit_points, used, &matches);
+        m_vec_map.clear();
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            m_vec_map.emplace(matches[i], i);
+        }
+        m_rotation = best_rotation;
+        pts = fit_points;
     }
 
     std::vector<vec3<float>> getRotation()
@@ -327,59 +348,103 @@ public:
         m_tol = tol;
     }
 
-    // This uses an R-tree to efficiently determine pairs of points that
-    // are closest, next closest, etc to each other. NOTE that this does
-    // not guarantee an absolutely minimal RMSD. It doesn't figure out the
-    // optimal permutation of BOTH sets of vectors to minimize the RMSD.
+    //! Seed the choice of reference points of the following fits.
+    /*! Unless seeded, every fit chooses them with a new random seed.
+     */
+    void setSeed(size_t seed)
+    {
+        m_rng.seed(seed);
+        m_seeded = true;
+    }
+
+    // This greedily pairs each point with the closest unused reference
+    // point, in order. NOTE that this does not guarantee an absolutely
+    // minimal RMSD. It doesn't figure out the optimal permutation of BOTH
+    // sets of vectors to minimize the RMSD.
     // Rather, it just figures out the optimal permutation of the second
     // set, the vector set used in the argument below.
     // To fully solve this, we need to use the Hungarian algorithm or some
     // other way of solving the so-called assignment problem.
     double AlignedRMSDTree(const matrix& points, BiMap<unsigned int, unsigned int>& m)
     {
-        // Also brute force.
-        double rmsd = 0.0;
+        std::vector<vec3<float>> fit_points;
+        for (int r = 0; r < points.rows(); r++)
+        {
+            fit_points.push_back(make_point(points.row(r)));
+        }
+        std::vector<char> used(m_ref_points.size());
+        std::vector<unsigned int> matches(fit_points.size());
+        const double rmsd = matchPoints(fit_points, used, &matches);
 
         // a mapping between the vectors of m_ref_points and the vectors of points
         BiMap<unsigned int, unsigned int> vec_map;
-
-        // keeps track of whether m_ref_points have been matched to any point in points
-        // guarantees 1-1 mapping
-        std::set<unsigned int> unused_indices;
-        for (int i = 0; i < m_ref_points.rows(); i++)
+        for (unsigned int r = 0; r < matches.size(); r++)
         {
-            unused_indices.insert(i);
+            vec_map.emplace(matches[r], r);
         }
+        m = vec_map;
+        return rmsd;
+    }
 
-        // loop through all the points
-        for (int r = 0; r < points.rows(); r++)
+private:
+    //! Number of candidate alignments evaluated at once by Fit.
+    static constexpr size_t CANDIDATE_BLOCK_SIZE = 256;
+
+    //! Minimum number of candidate alignments to evaluate them in parallel.
+    static constexpr size_t MIN_PARALLEL_CANDIDATES = 64;
+
+    static Eigen::Vector3d toEigen(const vec3<float>& v)
+    {
+        return Eigen::Vector3d(v.x, v.y, v.z);
+    }
+
+    static vec3<float> rotate(const Eigen::Matrix3d& R, const vec3<float>& v)
+    {
+        const Eigen::Vector3d rotated = R * toEigen(v);
+        return vec3<float>(rotated[0], rotated[1], rotated[2]);
+    }
+
+    //! Greedily match points to the closest unused reference points.
+    /*! \param fit_points Points in the frame of the reference points.
+     *  \param used Scratch space with one entry per reference point.
+     *  \param matches If not null, set to the reference point matched to each point.
+     *  \return The RMSD of the matched pairs.
+     */
+    double matchPoints(const std::vector<vec3<float>>& fit_points, std::vector<char>& used,
+                       std::vector<unsigned int>* matches) const
+    {
+        std::fill(used.begin(), used.end(), 0);
+        double rmsd = 0.0;
+        for (unsigned int r = 0; r < fit_points.size(); r++)
         {
-            // get the rotated point
-            vec3<float> pfit = make_point(points.row(r));
-            // compute squared distances to all unused reference points
-            std::vector<std::pair<unsigned int, double>> ref_distances;
-            for (auto ref_index : unused_indices)
+            // find the nearest unused reference point, the first one on ties
+            unsigned int nearest = 0;
+            double r_sq_min = -1.0;
+            for (unsigned int ref_index = 0; ref_index < m_ref_points.size(); ref_index++)
             {
-                vec3<float> ref_point = make_point(m_ref_points.row(ref_index));
-                vec3<float> delta = ref_point - pfit;
-                double r_sq = dot(delta, delta);
-                ref_distances.push_back(std::pair<unsigned int, double>(ref_index, r_sq));
+                if (used[ref_index])
+                {
+                    continue;
+                }
+                const vec3<float> delta = m_ref_points[ref_index] - fit_points[r];
+                const double r_sq = dot(delta, delta);
+                if (r_sq < r_sq_min || r_sq_min < 0.0)
+                {
+                    r_sq_min = r_sq;
+                    nearest = ref_index;
+                }
             }
-            // sort the ref_distances from nearest to farthest
-            sort(ref_distances.begin(), ref_distances.end(), compare_ref_distances);
-            // take the first (nearest) ref_point found and mark it as used
-            unused_indices.erase(ref_distances[0].first);
-            // add this pairing to the mapping between vectors
-            vec_map.emplace(ref_distances[0].first, r);
-            // add this squared distance to the rmsd
-            rmsd += ref_distances[0].second;
+            // mark it as used and add this squared distance to the rmsd
+            used[nearest] = 1;
+            if (matches != nullptr)
+            {
+                (*matches)[r] = nearest;
+            }
+            rmsd += r_sq_min;
         }
-
-        m = vec_map;
-        return std::sqrt(rmsd / double(points.rows()));
+        return std::sqrt(rmsd / double(fit_points.size()));
     }
 
-private:
     vec3<float> make_point(const Eigen::VectorXd& row)
     {
         if (row.rows() == 2)
@@ -390,12 +455,6 @@ private:
             throw(std::runtime_error("points must 2 or 3 dimensions"));
     }
 
-    static bool compare_ref_distances(const std::pair<unsigned int, float>& a,
-                                      const std::pair<unsigned int, float>& b)
-    {
-        return (a.second < b.second);
-    }
-
     inline bool NextCombination(size_t* comb, int N, int k)
     {
         // returns next combination.
@@ -424,17 +483,17 @@ private:
     template<class RNG> class RandomNumber
     {
     public:
-        RandomNumber()
-        {
-            seed_generator();
-        }
         int random_int(int a, int b)
         {
             std::uniform_int_distribution<int> distribution(a, b);
             return distribution(m_generator);
         }
 
-    private:
+        inline void seed(size_t s)
+        {
+            m_generator.seed(s);
+        }
+
         inline void seed_generator(const size_t& n = 100)
         {
             std::vector<size_t> seeds;
@@ -453,17 +512,21 @@ private:
             std::seed_seq seq(seeds.begin(), seeds.end());
             m_generator.seed(seq);
         }
+
+    private:
         RNG m_generator;
     };
 
 private:
-    matrix m_ref_points;
+    std::vector<vec3<float>> m_ref_points;
     matrix m_rotation;
     matrix m_translation;
     double m_rmsd;
     double m_tol;
     size_t m_shuffles;
     BiMap<unsigned int, unsigned int> m_vec_map;
+    RandomNumber<std::mt19937_64> m_rng;
+    bool m_seeded;
 };
 
 }; }; // end namespace freud::environment
@@ -0,0 +1,222 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "Interface.h"
+#include "NeighborComputeFunctional.h"
+#include "utils.h"
+
+/*! \file Interface.cc
+    \brief Finds the points at the interface between two sets of points.
+*/
+
+namespace freud { namespace interface {
+
+namespace {
+
+//! Bitset whose bits can be set from multiple threads.
+class AtomicBitset
+{
+public:
+    //! Constructor
+    /*! \param size Number of bits, all initially unset.
+     */
+    explicit AtomicBitset(size_t size) : m_words((size + 63) / 64)
+    {
+        for (auto& word : m_words)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    //! Set a bit.
+    /*! Most bonds set bits that are already set, so the word is read
+     *  first to avoid contended atomic writes.
+     */
+    void set(size_t index)
+    {
+        const uint64_t bit = uint64_t(1) << (index % 64);
+        std::atomic<uint64_t>& word = m_words[index / 64];
+        if ((word.load(std::memory_order_relaxed) & bit) == 0)
+        {
+            word.fetch_or(bit, std::memory_order_relaxed);
+        }
+    }
+
+    //! Write the sorted indices of the set bits into an array.
+    /*! Words are split into blocks whose set bits are counted and then
+     *  written in parallel, each block starting at the prefix sum of the
+     *  counts of the previous blocks.
+     */
+    void compact(util::ManagedArray<unsigned int>& indices) const
+    {
+        const size_t words_per_block = 1024;
+        const size_t num_blocks = (m_words.size() + words_per_block - 1) / words_per_block;
+        std::vector<size_t> offsets(num_blocks + 1, 0);
+        util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block)
+            {
+                size_t count = 0;
+                for (size_t w = block * words_per_block;
+                     w < std::min((block + 1) * words_per_block, m_words.size()); ++w)
+                {
+                    count += popcount(m_words[w].load(std::memory_order_relaxed));
+                }
+                offsets[block + 1] = count;
+            }
+        });
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        indices.prepareForOverwrite({offsets.back()});
+        util::forLoopWrapper(0, num_blocks, [&](size_t begin, size_t end) {
+            for (size_t block = begin; block < end; ++block)
+            {
+                size_t position = offsets[block];
+                for (size_t w = block * words_per_block;
+                     w < std::min((block + 1) * words_per_block, m_words.size()); ++w)
+                {
+                    uint64_t bits = m_words[w].load(std::memory_order_relaxed);
+                    for (unsigned int bit = 0; bits != 0; ++bit, bits >>= 1)
+                    {
+                        if (bits & 1)
+                        {
+                            indices[position++] = static_cast<unsigned int>(w * 64 + bit);
+                        }
+                    }
+                }
+            }
+        });
+    }
+
+private:
+    //! Count the set bits of a word.
+    static size_t popcount(uint64_t bits)
+    {
+        size_t count = 0;
+        for (; bits != 0; bits &= bits - 1)
+        {
+            ++count;
+        }
+        return count;
+    }
+
+    std::vector<std::atomic<uint64_t>> m_words; //!< Bits, 64 per word.
+};
+
+//! Whether every bond of a query is also a bond of the query with the points and query points swapped.
+bool isSymmetricBallQuery(const locality::QueryArgs& qargs)
+{
+    return qargs.mode == locality::QueryArgs::ball && !qargs.half;
+}
+
+//! Set the bits of the points and query points with a neighbor within a ball query's distance range.
+/*! The query points with a neighbor are found with an exists query, which
+ *  stops at the first neighbor of each query point. If few query points have
+ *  a neighbor, as for two sets of points in contact, the points are found by
+ *  streaming the bonds of only those query points. Otherwise the points are
+ *  found with an exists query of the points against the query points, which
+ *  is much faster than streaming all bonds of a dense interface.
+ */
+void computeBall(const locality::NeighborQuery* nq, const vec3<float>* query_points,
+                 unsigned int n_query_points, const locality::QueryArgs& qargs, AtomicBitset& point_bits,
+                 AtomicBitset& query_point_bits)
+{
+    locality::QueryArgs exists_qargs(qargs);
+    exists_qargs.mode = locality::QueryArgs::exists;
+    std::vector<unsigned int> query_point_exists(n_query_points);
+    nq->queryCounts(query_points, n_query_points, exists_qargs, query_point_exists.data());
+
+    std::vector<unsigned int> interface_query_point_ids;
+    for (unsigned int i = 0; i < n_query_points; ++i)
+    {
+        if (query_point_exists[i] != 0)
+        {
+            query_point_bits.set(i);
+            interface_query_point_ids.push_back(i);
+        }
+    }
+
+    if (interface_query_point_ids.size() <= n_query_points / 4)
+    {
+        std::vector<vec3<float>> interface_query_points(interface_query_point_ids.size());
+        for (size_t i = 0; i < interface_query_point_ids.size(); ++i)
+        {
+            interface_query_points[i] = query_points[interface_query_point_ids[i]];
+        }
+        // Indices of the subset of query points must still be compared with
+        // the point indices, so bonds of the same index are excluded here.
+        locality::QueryArgs subset_qargs(qargs);
+        subset_qargs.exclude_ii = false;
+        locality::forEachNeighbor(nq, interface_query_points.data(),
+                                  static_cast<unsigned int>(interface_query_points.size()), subset_qargs,
+                                  [&](const locality::NeighborBond& nb) {
+                                      if (!qargs.exclude_ii
+                                          || interface_query_point_ids[nb.query_point_idx] != nb.point_idx)
+                                      {
+                                          point_bits.set(nb.point_idx);
+                                      }
+                                  });
+    }
+    else
+    {
+        const locality::AABBQuery query_point_nq(nq->getBox(), query_points, n_query_points);
+        std::vector<unsigned int> point_exists(nq->getNPoints());
+        query_point_nq.queryCounts(nq->getPoints(), nq->getNPoints(), exists_qargs, point_exists.data());
+        util::forLoopWrapper(0, point_exists.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (point_exists[i] != 0)
+                {
+                    point_bits.set(i);
+                }
+            }
+        });
+    }
+}
+
+}; // namespace
+
+void Interface::compute(const locality::NeighborQuery* nq, const vec3<float>* query_points,
+                        unsigned int n_query_points, const locality::NeighborList* nlist,
+                        locality::QueryArgs qargs)
+{
+    AtomicBitset point_bits(nq->getNPoints());
+    AtomicBitset query_point_bits(n_query_points);
+
+    // Bonds are streamed into the bitsets without being stored.
+    if (nlist != nullptr)
+    {
+        const unsigned int* bond_query_points = nlist->getQueryPointIndices().get();
+        const unsigned int* bond_points = nlist->getPointIndices().get();
+        util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+            for (size_t bond = begin; bond < end; ++bond)
+            {
+                query_point_bits.set(bond_query_points[bond]);
+                point_bits.set(bond_points[bond]);
+            }
+        });
+    }
+    else if (isSymmetricBallQuery(nq->resolveQueryArgs(qargs)))
+    {
+        computeBall(nq, query_points, n_query_points, nq->resolveQueryArgs(qargs), point_bits,
+                    query_point_bits);
+    }
+    else
+    {
+        locality::forEachNeighbor(nq, query_points, n_query_points, qargs,
+                                  [&](const locality::NeighborBond& nb) {
+                                      query_point_bits.set(nb.query_point_idx);
+                                      point_bits.set(nb.point_idx);
+                                  });
+    }
+    query_point_bits.compact(m_query_point_ids);
+    point_bits.compact(m_point_ids);
+}
+
+}; }; // end namespace freud::interface
@@ -0,0 +1,60 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include "ManagedArray.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file Interface.h
+    \brief Finds the points at the interface between two sets of points.
+*/
+
+namespace freud { namespace interface {
+
+//! Finds the points and query points that have at least one neighbor in the other set.
+/*! The bonds of a query or NeighborList are streamed into one bitset of the
+ *  points and one of the query points, which are then compacted into sorted
+ *  arrays of indices in parallel, so no NeighborList is built. Ball queries
+ *  that are not half queries instead use exists queries, which stop at the
+ *  first neighbor of each point.
+ */
+class Interface
+{
+public:
+    //! Constructor
+    Interface() {}
+
+    //! Find the points and query points at the interface.
+    /*! \param nq NeighborQuery of the points.
+     *  \param query_points The query points.
+     *  \param n_query_points Number of query points.
+     *  \param nlist NeighborList of the bonds, or NULL to query nq with qargs.
+     *  \param qargs Query arguments, used if nlist is NULL.
+     */
+    void compute(const locality::NeighborQuery* nq, const vec3<float>* query_points,
+                 unsigned int n_query_points, const locality::NeighborList* nlist, locality::QueryArgs qargs);
+
+    //! Get the sorted indices of the points with a neighbor.
+    const util::ManagedArray<unsigned int>& getPointIds() const
+    {
+        return m_point_ids;
+    }
+
+    //! Get the sorted indices of the query points with a neighbor.
+    const util::ManagedArray<unsigned int>& getQueryPointIds() const
+    {
+        return m_query_point_ids;
+    }
+
+private:
+    util::ManagedArray<unsigned int> m_point_ids;       //!< Indices of the points with a neighbor.
+    util::ManagedArray<unsigned int> m_query_point_ids; //!< Indices of the query points with a neighbor.
+};
+
+}; }; // end namespace freud::interface
+
+#endif // INTERFACE_H
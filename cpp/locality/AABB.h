@@ -324,6 +324,84 @@ inline bool overlap(const AABB& a, const AABBSphere& b)
 #endif
 }
 
+//! Check which of four spheres of equal radius overlap an AABB
+/*! \param a AABB
+    \param x x coordinates of the four sphere centers
+    \param y y coordinates of the four sphere centers
+    \param z z coordinates of the four sphere centers
+    \param r_sq Squared radius of the spheres
+    \returns a mask whose bit i is set when sphere i overlaps the AABB
+
+    The sphere centers are given in structure-of-arrays layout so that all four are tested at once. Each
+   sphere is tested with the same operations as overlap(const AABB&, const AABBSphere&).
+*/
+inline unsigned int overlapMask4(const AABB& a, const float* x, const float* y, const float* z, float r_sq)
+{
+#if defined(__SSE__)
+    const __m128 x_v = _mm_loadu_ps(x);
+    const __m128 y_v = _mm_loadu_ps(y);
+    const __m128 z_v = _mm_loadu_ps(z);
+    const __m128 dx_v = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(x_v, _mm_shuffle_ps(a.lower_v, a.lower_v, _MM_SHUFFLE(0, 0, 0, 0))),
+                   _mm_shuffle_ps(a.upper_v, a.upper_v, _MM_SHUFFLE(0, 0, 0, 0))),
+        x_v);
+    const __m128 dy_v = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(y_v, _mm_shuffle_ps(a.lower_v, a.lower_v, _MM_SHUFFLE(1, 1, 1, 1))),
+                   _mm_shuffle_ps(a.upper_v, a.upper_v, _MM_SHUFFLE(1, 1, 1, 1))),
+        y_v);
+    const __m128 dz_v = _mm_sub_ps(
+        _mm_min_ps(_mm_max_ps(z_v, _mm_shuffle_ps(a.lower_v, a.lower_v, _MM_SHUFFLE(2, 2, 2, 2))),
+                   _mm_shuffle_ps(a.upper_v, a.upper_v, _MM_SHUFFLE(2, 2, 2, 2))),
+        z_v);
+    const __m128 dr2_v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx_v, dx_v), _mm_mul_ps(dy_v, dy_v)),
+                                    _mm_mul_ps(dz_v, dz_v));
+    return static_cast<unsigned int>(_mm_movemask_ps(_mm_cmplt_ps(dr2_v, _mm_set1_ps(r_sq))));
+
+#else
+    unsigned int mask = 0;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        vec3<float> dr = vec3<float>(std::min(std::max(x[i], a.lower.x), a.upper.x) - x[i],
+                                     std::min(std::max(y[i], a.lower.y), a.upper.y) - y[i],
+                                     std::min(std::max(z[i], a.lower.z), a.upper.z) - z[i]);
+        if (dot(dr, dr) < r_sq)
+        {
+            mask |= 1u << i;
+        }
+    }
+    return mask;
+
+#endif
+}
+
+//! Compute the squared distance from the center of an AABBSphere to an AABB
+/*! \param a AABB
+    \param b AABBSphere, whose radius is ignored
+    \returns the squared distance from the center of b to the nearest point of a, or zero if it is inside a
+
+    The distance is computed with the same operations as the squared distance from the center of b to a point
+   in a, so it never exceeds the squared distance to any point contained in a.
+*/
+inline float distanceSquared(const AABB& a, const AABBSphere& b)
+{
+#if defined(__SSE__)
+    __m128 dr_v = _mm_sub_ps(_mm_min_ps(_mm_max_ps(b.position_v, a.lower_v), a.upper_v), b.position_v);
+    __m128 dr2_v = _mm_mul_ps(dr_v, dr_v);
+    __m128 shuf = _mm_shuffle_ps(dr2_v, dr2_v, _MM_SHUFFLE(2, 3, 0, 1));
+    __m128 sums = _mm_add_ps(dr2_v, shuf);
+    shuf = _mm_movehl_ps(shuf, sums);
+    sums = _mm_add_ss(sums, shuf);
+    return _mm_cvtss_f32(sums);
+
+#else
+    vec3<float> dr = vec3<float>(std::min(std::max(b.position.x, a.lower.x), a.upper.x) - b.position.x,
+                                 std::min(std::max(b.position.y, a.lower.y), a.upper.y) - b.position.y,
+                                 std::min(std::max(b.position.z, a.lower.z), a.upper.z) - b.position.z);
+    return dot(dr, dr);
+
+#endif
+}
+
 //! Check if one AABB contains another
 /*! \param a First AABB
     \param b Second AABB
@@ -2,24 +2,123 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <stdexcept>
 
 #include "AABBQuery.h"
+#include "NearestNeighborHeap.h"
 
 namespace freud { namespace locality {
 
-AABBQuery::AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points)
-    : NeighborQuery(box, points, n_points)
+namespace {
+
+//! Distance, as a fraction of the box, that query points may lie outside of the box when using ghosts.
+/*! Ghosts are generated this much farther out, plus as much again to absorb
+ *  rounding, so that query points on the faces of the box rounded slightly
+ *  outside still find all of their neighbors.
+ */
+const float GHOST_TOLERANCE = 1e-3;
+
+}; // end anonymous namespace
+
+AABBQuery::AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                     bool spatial_sort, float ghost_width)
+    : NeighborQuery(box, points, n_points), m_tree_points(m_points), m_ghost_width(ghost_width)
 {
+    if (ghost_width < 0)
+    {
+        throw std::invalid_argument("The AABBQuery ghost_width must be non-negative.");
+    }
+    const vec3<float> nearest_plane_distance = m_box.getNearestPlaneDistance();
+    const vec3<bool> periodic = m_box.getPeriodic();
+    if ((periodic.x && nearest_plane_distance.x <= ghost_width * 2.0)
+        || (periodic.y && nearest_plane_distance.y <= ghost_width * 2.0)
+        || (!m_box.is2D() && periodic.z && nearest_plane_distance.z <= ghost_width * 2.0))
+    {
+        throw std::invalid_argument("The AABBQuery ghost_width is too large for this box.");
+    }
+
     // Allocate memory and create image vectors
+    util::profiling::ScopedTimer timer("AABBQuery::build");
     setupTree(m_n_points);
 
+    // Sort a copy of the points along a space-filling curve. The tree
+    // indexes into this copy, while the particle tags keep the original
+    // indices, so points near each other in space are near each other in
+    // memory when the tree is traversed.
+    if (spatial_sort)
+    {
+        computeSpatialOrder();
+        m_sorted_points.prepare(m_n_points);
+        util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_sorted_points[i] = m_points[m_spatial_order[i]];
+            }
+        });
+        m_tree_points = m_sorted_points.get();
+    }
+
     // Build the tree
-    buildTree(m_points, m_n_points);
+    buildTree(m_tree_points, m_n_points);
+    if (m_ghost_width > 0)
+    {
+        buildPaddedTree();
+    }
 }
 
 AABBQuery::~AABBQuery() {}
 
+void AABBQuery::update(const vec3<float>* points)
+{
+    validatePoints(points);
+    m_points = points;
+
+    // Keep using the original spatial order, which remains a valid
+    // permutation even if it is no longer ideal.
+    if (m_spatial_order.size() != 0)
+    {
+        util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                m_sorted_points[i] = m_points[m_spatial_order[i]];
+            }
+        });
+    }
+    else
+    {
+        m_tree_points = m_points;
+    }
+
+    // Recreate the AABBs in the order of the tree's particle indices.
+    const bool is2D = m_box.is2D();
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            vec3<float> my_pos(m_tree_points[i]);
+            if (is2D)
+                my_pos.z = 0;
+            const unsigned int tag = (m_spatial_order.size() != 0) ? m_spatial_order[i] : i;
+            m_aabbs[i] = AABB(my_pos, tag);
+        }
+    });
+    m_aabb_tree.refit(m_aabbs.data());
+    fillLeafBlock(m_aabb_tree, m_tree_points, m_leaves);
+
+    // Points may have moved into or out of the layer of ghosts, so the
+    // padded tree cannot simply be refit.
+    if (m_ghost_width > 0)
+    {
+        buildPaddedTree();
+    }
+
+    if (hasPointTypes())
+    {
+        updateTypeQueries();
+    }
+}
+
 std::shared_ptr<NeighborQueryPerPointIterator>
 AABBQuery::querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const
 {
@@ -27,13 +126,12 @@ AABBQuery::querySingle(const vec3<float> query_point, unsigned int query_point_i
     if (args.mode == QueryArgs::ball)
     {
         return std::make_shared<AABBQueryBallIterator>(this, query_point, query_point_idx, args.r_max,
-                                                       args.r_min, args.exclude_ii);
+                                                       args.r_min, args.exclude_ii, args.half);
     }
     else if (args.mode == QueryArgs::nearest)
     {
         return std::make_shared<AABBQueryIterator>(this, query_point, query_point_idx, args.num_neighbors,
-                                                   args.r_guess, args.r_max, args.r_min, args.scale,
-                                                   args.exclude_ii);
+                                                   args.r_max, args.r_min, args.exclude_ii);
     }
     else
     {
@@ -49,17 +147,510 @@ void AABBQuery::setupTree(unsigned int Np)
 void AABBQuery::buildTree(const vec3<float>* points, unsigned int Np)
 {
     // Construct a point AABB for each point
-    for (unsigned int i = 0; i < Np; ++i)
+    const bool is2D = m_box.is2D();
+    util::forLoopWrapper(0, Np, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            vec3<float> my_pos(points[i]);
+            if (is2D)
+                my_pos.z = 0;
+            const unsigned int tag = (m_spatial_order.size() != 0) ? m_spatial_order[i] : i;
+            m_aabbs[i] = AABB(my_pos, tag);
+        }
+    });
+
+    // Call the tree build routine
+    m_aabb_tree.buildTree(m_aabbs.data(), Np);
+
+    setupLeafBlock(m_aabb_tree, m_leaves);
+    fillLeafBlock(m_aabb_tree, m_tree_points, m_leaves);
+}
+
+void AABBQuery::setupLeafBlock(const AABBTree& tree, LeafBlock& leaves) const
+{
+    // Number the points of the leaves contiguously in traversal order.
+    const unsigned int num_nodes = tree.getNumNodes();
+    leaves.offsets.resize(num_nodes);
+    unsigned int num_leaf_points = 0;
+    for (unsigned int node = 0; node < num_nodes; ++node)
     {
-        // Make a point AABB
-        vec3<float> my_pos(points[i]);
-        if (m_box.is2D())
-            my_pos.z = 0;
-        m_aabbs[i] = AABB(my_pos, i);
+        leaves.offsets[node] = num_leaf_points;
+        if (tree.isNodeLeaf(node))
+        {
+            num_leaf_points += tree.getNodeNumParticles(node);
+        }
     }
+    leaves.x.resize(num_leaf_points);
+    leaves.y.resize(num_leaf_points);
+    leaves.z.resize(num_leaf_points);
+    leaves.tags.resize(num_leaf_points);
+}
 
-    // Call the tree build routine, one tree per type
-    m_aabb_tree.buildTree(m_aabbs.data(), Np);
+void AABBQuery::fillLeafBlock(const AABBTree& tree, const vec3<float>* tree_points, LeafBlock& leaves) const
+{
+    const bool is2D = m_box.is2D();
+    util::forLoopWrapper(0, tree.getNumNodes(), [&](size_t begin, size_t end) {
+        for (size_t node = begin; node < end; ++node)
+        {
+            if (!tree.isNodeLeaf(node))
+            {
+                continue;
+            }
+            const unsigned int offset = leaves.offsets[node];
+            for (unsigned int p = 0; p < tree.getNodeNumParticles(node); ++p)
+            {
+                const vec3<float>& pos = tree_points[tree.getNodeParticle(node, p)];
+                leaves.x[offset + p] = pos.x;
+                leaves.y[offset + p] = pos.y;
+                leaves.z[offset + p] = is2D ? 0 : pos.z;
+                leaves.tags[offset + p] = tree.getNodeParticleTag(node, p);
+            }
+        }
+    });
+}
+
+void AABBQuery::buildPaddedTree()
+{
+    const vec3<float> nearest_plane_distance = m_box.getNearestPlaneDistance();
+    const vec3<bool> periodic = m_box.getPeriodic();
+    const bool is2D = m_box.is2D();
+    const bool periodic_dims[3] = {periodic.x, periodic.y, !is2D && periodic.z};
+    const float plane_distances[3]
+        = {nearest_plane_distance.x, nearest_plane_distance.y, nearest_plane_distance.z};
+    const vec3<float> lattice[3] = {vec3<float>(m_box.getLatticeVector(0)),
+                                    vec3<float>(m_box.getLatticeVector(1)),
+                                    is2D ? vec3<float>(0, 0, 0) : vec3<float>(m_box.getLatticeVector(2))};
+
+    // Fractional distance that ghosts may extend beyond each face of the box.
+    float reach[3];
+    for (unsigned int dim = 0; dim < 3; ++dim)
+    {
+        reach[dim] = m_ghost_width / plane_distances[dim] + float(2.0) * GHOST_TOLERANCE;
+    }
+
+    // The image of a point shifted by a number of lattice vectors is a
+    // ghost if it lies within the reach of the box along every dimension.
+    // Fractional coordinates are measured between pairs of box faces, so
+    // this holds for triclinic boxes too. The allowed shifts are found
+    // independently in each dimension, and the ghosts of a point are all of
+    // their combinations except the point itself.
+    auto find_shifts = [&](unsigned int i, int shifts[3][3], unsigned int num_shifts[3]) {
+        const vec3<float> frac = m_box.makeFractional(m_points[i]);
+        const float frac_dims[3] = {frac.x, frac.y, frac.z};
+        bool has_self = true;
+        for (unsigned int dim = 0; dim < 3; ++dim)
+        {
+            num_shifts[dim] = 0;
+            if (!periodic_dims[dim])
+            {
+                shifts[dim][num_shifts[dim]++] = 0;
+                continue;
+            }
+            for (int shift = -1; shift <= 1; ++shift)
+            {
+                const float shifted = frac_dims[dim] + float(shift);
+                if (shifted >= -reach[dim] && shifted <= float(1.0) + reach[dim])
+                {
+                    shifts[dim][num_shifts[dim]++] = shift;
+                }
+                else if (shift == 0)
+                {
+                    has_self = false;
+                }
+            }
+        }
+        return num_shifts[0] * num_shifts[1] * num_shifts[2] - (has_self ? 1 : 0);
+    };
+
+    // Count the ghosts of each point before generating them, so that they
+    // are stored in order of their points regardless of the parallelism.
+    // The ghosts follow the points, which are stored in the order of the
+    // main tree.
+    std::vector<unsigned int> ghost_offsets(m_n_points + 1, 0);
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        int shifts[3][3];
+        unsigned int num_shifts[3];
+        for (size_t i = begin; i < end; ++i)
+        {
+            ghost_offsets[i + 1] = find_shifts(i, shifts, num_shifts);
+        }
+    });
+    ghost_offsets[0] = m_n_points;
+    for (unsigned int i = 0; i < m_n_points; ++i)
+    {
+        ghost_offsets[i + 1] += ghost_offsets[i];
+    }
+
+    const unsigned int num_padded = ghost_offsets[m_n_points];
+    m_padded_points.resize(num_padded);
+    m_padded_aabbs.resize(num_padded);
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_padded_points[i] = m_aabbs[i].getPosition();
+            m_padded_aabbs[i] = m_aabbs[i];
+        }
+    });
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        int shifts[3][3];
+        unsigned int num_shifts[3];
+        for (size_t i = begin; i < end; ++i)
+        {
+            find_shifts(i, shifts, num_shifts);
+            unsigned int ghost = ghost_offsets[i];
+            for (unsigned int a = 0; a < num_shifts[0]; ++a)
+            {
+                for (unsigned int b = 0; b < num_shifts[1]; ++b)
+                {
+                    for (unsigned int c = 0; c < num_shifts[2]; ++c)
+                    {
+                        if (shifts[0][a] == 0 && shifts[1][b] == 0 && shifts[2][c] == 0)
+                        {
+                            continue;
+                        }
+                        vec3<float> pos = m_points[i] + float(shifts[0][a]) * lattice[0]
+                            + float(shifts[1][b]) * lattice[1] + float(shifts[2][c]) * lattice[2];
+                        if (is2D)
+                        {
+                            pos.z = 0;
+                        }
+                        m_padded_points[ghost] = pos;
+                        m_padded_aabbs[ghost] = AABB(pos, static_cast<unsigned int>(i));
+                        ++ghost;
+                    }
+                }
+            }
+        }
+    });
+
+    m_padded_tree.buildTree(m_padded_aabbs.data(), num_padded);
+    setupLeafBlock(m_padded_tree, m_padded_leaves);
+    fillLeafBlock(m_padded_tree, m_padded_points.data(), m_padded_leaves);
+}
+
+AABBQuery::ImageList AABBQuery::computeImageList(float r_max, bool check_r_max,
+                                                 const vec3<float>* query_points,
+                                                 unsigned int n_query_points) const
+{
+    const vec3<float> nearest_plane_distance = m_box.getNearestPlaneDistance();
+    const vec3<bool> periodic = m_box.getPeriodic();
+    if (check_r_max)
+    {
+        if ((periodic.x && nearest_plane_distance.x <= r_max * 2.0)
+            || (periodic.y && nearest_plane_distance.y <= r_max * 2.0)
+            || (!m_box.is2D() && periodic.z && nearest_plane_distance.z <= r_max * 2.0))
+        {
+            throw std::runtime_error("The AABBQuery r_max is too large for this box.");
+        }
+    }
+
+    if (m_ghost_width > 0 && r_max <= m_ghost_width && query_points != nullptr)
+    {
+        // The ghosts only cover query points in the box.
+        const bool periodic_dims[3] = {periodic.x, periodic.y, !m_box.is2D() && periodic.z};
+        std::atomic<bool> in_box(true);
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end && in_box.load(std::memory_order_relaxed); ++i)
+            {
+                const vec3<float> frac = m_box.makeFractional(query_points[i]);
+                const float frac_dims[3] = {frac.x, frac.y, frac.z};
+                for (unsigned int dim = 0; dim < 3; ++dim)
+                {
+                    if (periodic_dims[dim]
+                        && !(frac_dims[dim] >= -GHOST_TOLERANCE
+                             && frac_dims[dim] <= float(1.0) + GHOST_TOLERANCE))
+                    {
+                        in_box.store(false, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+        if (in_box.load())
+        {
+            ImageList images;
+            images.vectors[0] = vec3<float>(0.0, 0.0, 0.0);
+            images.size = 1;
+            images.ghosts = true;
+            return images;
+        }
+    }
+    return computeAllImages();
+}
+
+AABBQuery::ImageList AABBQuery::computeAllImages() const
+{
+    ImageList images;
+    images.ghosts = false;
+    const vec3<bool> periodic = m_box.getPeriodic();
+    const vec3<float> latt_a = vec3<float>(m_box.getLatticeVector(0));
+    const vec3<float> latt_b = vec3<float>(m_box.getLatticeVector(1));
+    vec3<float> latt_c = vec3<float>(0.0, 0.0, 0.0);
+    if (!m_box.is2D())
+    {
+        latt_c = vec3<float>(m_box.getLatticeVector(2));
+    }
+
+    // The zero image is always first, matching AABBIterator::updateImageVectors.
+    images.vectors[0] = vec3<float>(0.0, 0.0, 0.0);
+    images.size = 1;
+    for (int i = -1; i <= 1; ++i)
+    {
+        for (int j = -1; j <= 1; ++j)
+        {
+            for (int k = -1; k <= 1; ++k)
+            {
+                if (i == 0 && j == 0 && k == 0)
+                    continue;
+                // Skip any periodic images if we don't have periodicity
+                if (i != 0 && !periodic.x)
+                    continue;
+                if (j != 0 && !periodic.y)
+                    continue;
+                if (k != 0 && (m_box.is2D() || !periodic.z))
+                    continue;
+
+                images.vectors[images.size] = float(i) * latt_a + float(j) * latt_b + float(k) * latt_c;
+                ++images.size;
+            }
+        }
+    }
+    return images;
+}
+
+namespace {
+
+//! A tree node waiting to be searched by a k-nearest-neighbor search.
+struct PendingNode
+{
+    float r_sq;        //!< Lower bound on the squared distance of points in the node.
+    unsigned int node; //!< Index of the node in the tree.
+};
+
+}; // end anonymous namespace
+
+unsigned int AABBQuery::countBall(const ImageList& images, const vec3<float>& query_point,
+                                  unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                                  bool half, unsigned int max_count) const
+{
+    vec3<float> pos_i(query_point);
+    if (m_box.is2D())
+    {
+        pos_i.z = 0;
+    }
+
+    unsigned int count = 0;
+    if (images.ghosts)
+    {
+        countTreeBall(m_padded_tree, m_padded_points.data(), pos_i, query_point_idx, r_max, r_min, exclude_ii,
+                      half, max_count, count);
+        return count;
+    }
+    for (unsigned int cur_image = 0; cur_image < images.size && count < max_count; ++cur_image)
+    {
+        countTreeBall(m_aabb_tree, m_tree_points, pos_i + images.vectors[cur_image], query_point_idx, r_max,
+                      r_min, exclude_ii, half, max_count, count);
+    }
+    return count;
+}
+
+void AABBQuery::countTreeBall(const AABBTree& tree, const vec3<float>* tree_points, const vec3<float>& pos_i,
+                              unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                              bool half, unsigned int max_count, unsigned int& count) const
+{
+    if (count >= max_count)
+    {
+        return;
+    }
+
+    const float r_max_sq = r_max * r_max;
+    const float r_min_sq = r_min * r_min;
+    const bool is2D = m_box.is2D();
+    const AABBSphere asphere(pos_i, r_max);
+
+    // Stackless traversal of the tree, as in visitTreeBall
+    const unsigned int num_nodes = tree.getNumNodes();
+    util::profiling::LocalCounter nodes_tested(util::profiling::counter_nodes_tested);
+    for (unsigned int cur_node_idx = 0; cur_node_idx < num_nodes; ++cur_node_idx)
+    {
+        nodes_tested.add();
+        if (overlap(tree.getNodeAABB(cur_node_idx), asphere))
+        {
+            if (tree.isNodeLeaf(cur_node_idx))
+            {
+                const unsigned int num_particles = tree.getNodeNumParticles(cur_node_idx);
+                for (unsigned int cur_p = 0; cur_p < num_particles; ++cur_p)
+                {
+                    const unsigned int j = tree.getNodeParticleTag(cur_node_idx, cur_p);
+                    if (skipPair(query_point_idx, j, exclude_ii, half))
+                    {
+                        continue;
+                    }
+
+                    vec3<float> pos_j(tree_points[tree.getNodeParticle(cur_node_idx, cur_p)]);
+                    if (is2D)
+                    {
+                        pos_j.z = 0;
+                    }
+
+                    const vec3<float> r_ij = pos_j - pos_i;
+                    const float r_sq = dot(r_ij, r_ij);
+                    if (r_sq < r_max_sq && r_sq >= r_min_sq && ++count == max_count)
+                    {
+                        return;
+                    }
+                }
+            }
+        }
+        else
+        {
+            // Skip ahead
+            cur_node_idx += tree.getNodeSkip(cur_node_idx);
+        }
+    }
+}
+
+void AABBQuery::findNearest(const ImageList& images, const vec3<float>& query_point,
+                            unsigned int query_point_idx, unsigned int num_neighbors, float r_max,
+                            float r_min, bool exclude_ii, std::vector<NeighborBond>& neighbors) const
+{
+    neighbors.clear();
+    if (num_neighbors == 0 || m_aabb_tree.getNumNodes() == 0)
+    {
+        return;
+    }
+
+    const float r_max_sq = r_max * r_max;
+    const bool is2D = m_box.is2D();
+    vec3<float> pos_i(query_point);
+    if (is2D)
+    {
+        pos_i.z = 0;
+    }
+
+    // Two images of a point are at least the smallest nearest plane
+    // distance apart, so bonds shorter than half of it cannot be to a point
+    // already kept at another image.
+    const vec3<float> plane_distance = m_box.getNearestPlaneDistance();
+    float min_plane_distance = std::min(plane_distance.x, plane_distance.y);
+    if (!is2D)
+    {
+        min_plane_distance = std::min(min_plane_distance, plane_distance.z);
+    }
+    const float unique_distance = min_plane_distance / float(2.0);
+
+    // A point is excluded if its closest image is nearer than r_min, even
+    // if another of its images is not. Those points are all within r_min of
+    // the query point, so they are found up front with a small ball query.
+    std::vector<unsigned int> excluded;
+    if (r_min > 0)
+    {
+        visitBall(images, query_point, query_point_idx, r_min, 0, exclude_ii, false,
+                  [&excluded](const NeighborBond& nb) { excluded.push_back(nb.point_idx); });
+        std::sort(excluded.begin(), excluded.end());
+    }
+
+    // Each image is searched depth first, always descending into the nearer
+    // child first, and skipping any node that cannot contain a point closer
+    // than the farthest one kept. The zero image comes first, so the heap is
+    // usually full before other images are reached and most of them are
+    // pruned at the root.
+    NearestNeighborHeap heap(num_neighbors);
+    float prune_r_sq = r_max_sq;
+    std::vector<PendingNode> stack;
+    util::profiling::LocalCounter nodes_tested(util::profiling::counter_nodes_tested);
+    auto search_tree = [&](const AABBTree& tree, const vec3<float>* tree_points,
+                           const vec3<float>& pos_i_image) {
+        if (tree.getNumNodes() == 0)
+        {
+            return;
+        }
+        const AABBSphere image_sphere(pos_i_image, 0);
+        stack.push_back({distanceSquared(tree.getNodeAABB(0), image_sphere), 0});
+        while (!stack.empty())
+        {
+            const PendingNode cur = stack.back();
+            stack.pop_back();
+            nodes_tested.add();
+            if (cur.r_sq >= prune_r_sq)
+            {
+                continue;
+            }
+
+            if (tree.isNodeLeaf(cur.node))
+            {
+                const unsigned int num_particles = tree.getNodeNumParticles(cur.node);
+                for (unsigned int cur_p = 0; cur_p < num_particles; ++cur_p)
+                {
+                    const unsigned int j = tree.getNodeParticleTag(cur.node, cur_p);
+                    if (exclude_ii && query_point_idx == j)
+                    {
+                        continue;
+                    }
+
+                    vec3<float> pos_j(tree_points[tree.getNodeParticle(cur.node, cur_p)]);
+                    if (is2D)
+                    {
+                        pos_j.z = 0;
+                    }
+
+                    const vec3<float> r_ij = pos_j - pos_i_image;
+                    const float r_sq = dot(r_ij, r_ij);
+                    if (r_sq >= prune_r_sq)
+                    {
+                        continue;
+                    }
+                    const float distance = std::sqrt(r_sq);
+                    if (distance < r_min || !heap.accepts(distance, j)
+                        || std::binary_search(excluded.begin(), excluded.end(), j))
+                    {
+                        continue;
+                    }
+
+                    const NeighborBond bond(query_point_idx, j, distance, 1, r_ij);
+                    if (distance < unique_distance && heap.allCloserThan(unique_distance))
+                    {
+                        heap.push(bond);
+                    }
+                    else
+                    {
+                        heap.pushUnique(bond);
+                    }
+                    prune_r_sq = std::min(r_max_sq, heap.pruneDistanceSquared());
+                }
+            }
+            else
+            {
+                const AABBNode& node = tree.getNode(cur.node);
+                PendingNode near = {distanceSquared(tree.getNodeAABB(node.left), image_sphere), node.left};
+                PendingNode far = {distanceSquared(tree.getNodeAABB(node.right), image_sphere), node.right};
+                if (far.r_sq < near.r_sq)
+                {
+                    std::swap(near, far);
+                }
+                if (far.r_sq < prune_r_sq)
+                {
+                    stack.push_back(far);
+                }
+                if (near.r_sq < prune_r_sq)
+                {
+                    stack.push_back(near);
+                }
+            }
+        }
+    };
+
+    for (unsigned int cur_image = 0; cur_image < images.size; ++cur_image)
+    {
+        if (images.ghosts)
+        {
+            search_tree(m_padded_tree, m_padded_points.data(), pos_i);
+        }
+        else
+        {
+            search_tree(m_aabb_tree, m_tree_points, pos_i + images.vectors[cur_image]);
+        }
+    }
+    heap.extractSorted(neighbors);
 }
 
 void AABBIterator::updateImageVectors(float r_max, bool _check_r_max)
@@ -163,8 +754,8 @@ NeighborBond AABBQueryBallIterator::next()
                         // Increment before possible return.
                         cur_ref_p++;
 
-                        // Skip ii matches immediately if requested.
-                        if (m_exclude_ii && m_query_point_idx == j)
+                        // Skip ii matches (or all j <= i for half queries) immediately if requested.
+                        if (skipPoint(j))
                         {
                             continue;
                         }
@@ -183,7 +774,7 @@ NeighborBond AABBQueryBallIterator::next()
                         // Check ii exclusion before including the pair.
                         if (r_sq < r_max_sq && r_sq >= r_min_sq)
                         {
-                            return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq));
+                            return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq), 1, r_ij);
                         }
                     }
                 }
@@ -206,120 +797,20 @@ NeighborBond AABBQueryBallIterator::next()
 
 NeighborBond AABBQueryIterator::next()
 {
-    vec3<float> plane_distance = m_neighbor_query->getBox().getNearestPlaneDistance();
-    float min_plane_distance = std::min(plane_distance.x, plane_distance.y);
-    float max_plane_distance = std::max(plane_distance.x, plane_distance.y);
-    if (!m_neighbor_query->getBox().is2D())
+    // This iterator is not truly lazy: the nearest neighbors are only known
+    // once the whole search is complete, so they are found and cached the
+    // first time next is called and then returned one-by-one.
+    if (!m_searched)
     {
-        min_plane_distance = std::min(min_plane_distance, plane_distance.z);
-        max_plane_distance = std::max(max_plane_distance, plane_distance.z);
+        m_aabb_query->findNearest(m_aabb_query->computeImageList(m_r_max, false), m_query_point,
+                                  m_query_point_idx, m_num_neighbors, m_r_max, m_r_min, m_exclude_ii,
+                                  m_current_neighbors);
+        m_searched = true;
     }
 
-    // This iterator is not truly lazy; because it needs to get possible
-    // neighbors and sort them to find the actual ones, it computes and caches
-    // them and then returns them one-by-one. This check ensures that we only
-    // search for new neighbors the first time next is called.
-    if (!m_current_neighbors.size())
+    if (m_count < m_current_neighbors.size())
     {
-        // Continually perform ball queries until the termination conditions are met.
-        while (true)
-        {
-            // Perform a ball query to get neighbors. To ensure that we allow
-            // ball queries to exceed their normal boundaries, we pass false as
-            // the _check_r_max. We also can't depend on the ball query for
-            // r_min filtering because we're querying beyond the normally safe
-            // bounds, so we have to do it in this class.
-            m_current_neighbors.clear();
-            m_all_distances.clear();
-            m_query_points_below_r_min.clear();
-            std::shared_ptr<NeighborQueryPerPointIterator> ball_it = std::make_shared<AABBQueryBallIterator>(
-                static_cast<const AABBQuery*>(m_neighbor_query), m_query_point, m_query_point_idx,
-                std::min(m_r_cur, m_r_max), 0, m_exclude_ii, false);
-            while (!ball_it->end())
-            {
-                NeighborBond nb = ball_it->next();
-                if (nb == NeighborQueryIterator::ITERATOR_TERMINATOR)
-                    continue;
-
-                if (!m_exclude_ii || m_query_point_idx != nb.point_idx)
-                {
-                    nb.query_point_idx = m_query_point_idx;
-                    // If we've expanded our search radius beyond safe
-                    // distance, use the map instead of the vector.
-                    if (m_search_extended)
-                    {
-                        if (!m_all_distances.count(nb.point_idx)
-                            || m_all_distances[nb.point_idx] > nb.distance)
-                        {
-                            m_all_distances[nb.point_idx] = nb.distance;
-                            if (nb.distance < m_r_min)
-                            {
-                                m_query_points_below_r_min.insert(nb.point_idx);
-                            }
-                        }
-                    }
-                    else
-                    {
-                        if (nb.distance >= m_r_min)
-                            m_current_neighbors.emplace_back(nb);
-                    }
-                }
-            }
-
-            // Break if there are enough neighbors, or if we are querying beyond the limits of
-            // the periodic box.
-            m_r_cur *= m_scale;
-
-            if (m_current_neighbors.size() >= m_num_neighbors)
-            {
-                std::sort(m_current_neighbors.begin(), m_current_neighbors.end());
-                break;
-            }
-            else if ((m_r_cur >= m_r_max) || (m_r_cur >= max_plane_distance)
-                     || ((m_all_distances.size() - m_query_points_below_r_min.size()) >= m_num_neighbors))
-            {
-                // Once this condition is reached, either we found enough
-                // neighbors beyond the normal min_plane_distance
-                // condition or we conclude that there are not enough
-                // neighbors left in the system.
-                for (std::map<unsigned int, float>::const_iterator it(m_all_distances.begin());
-                     it != m_all_distances.end(); it++)
-                {
-                    if (it->second >= m_r_min)
-                    {
-                        m_current_neighbors.emplace_back(m_query_point_idx, it->first, it->second);
-                    }
-                }
-                std::sort(m_current_neighbors.begin(), m_current_neighbors.end());
-                break;
-            }
-            else if (m_r_cur > min_plane_distance / 2)
-            {
-                // If we have to go beyond the cutoff radius, we need to
-                // start tracking what particles are already in the set so
-                // that we can make sure that we find the closest image
-                // because we now run the risk of finding duplicates.
-                //
-                // We could make this marginally more efficient by checking
-                // whether we've exactly hit the limit, or if there's a
-                // rescaling that would let us try the exact limit once
-                // before going beyond the min plane distance.
-                m_search_extended = true;
-            }
-        }
-    }
-
-    // Now we return all the points found for the current point, stopping when
-    // any are beyond the maximum distance allowed.
-    while ((m_count < m_num_neighbors) && (m_count < m_current_neighbors.size()))
-    {
-        m_count++;
-        if (m_current_neighbors[m_count - 1].distance > m_r_max)
-        {
-            m_finished = true;
-            return NeighborQueryIterator::ITERATOR_TERMINATOR;
-        }
-        return m_current_neighbors[m_count - 1];
+        return m_current_neighbors[m_count++];
     }
 
     m_finished = true;
@@ -5,26 +5,29 @@
 #define AABBQUERY_H
 
 #include <cmath>
-#include <map>
 #include <memory>
-#include <unordered_set>
 #include <vector>
 
 #include "AABBTree.h"
 #include "Box.h"
 #include "NeighborQuery.h"
+#include "Profiling.h"
 
 /*! \file AABBQuery.h
  *  \brief Build an AABB tree from points and query it for neighbors.
  * A bounding volume hierarchy (BVH) tree is a binary search tree. It is
  * constructed from axis-aligned bounding boxes (AABBs). The AABB for a node in
  * the tree encloses all child AABBs. A leaf AABB holds multiple particles. The
- * tree is constructed in a balanced way using a heuristic to minimize AABB
- * volume. We build one tree per particle type, and use point AABBs for the
- * particles. The neighbor list is built by traversing down the tree with an
- * AABB that encloses the pairwise cutoff for the particle. Periodic boundaries
- * are treated by translating the query AABB by all possible image vectors,
- * many of which are trivially rejected for not intersecting the root node.
+ * tree is constructed in a balanced way, in parallel, by splitting every node
+ * at the median point along its longest dimension. We build one tree per
+ * particle type, and use point AABBs for the particles. The neighbor list is
+ * built by traversing down the tree with an AABB that encloses the pairwise
+ * cutoff for the particle. Periodic boundaries are treated by translating the
+ * query AABB by all possible image vectors, many of which are trivially
+ * rejected for not intersecting the root node. Alternatively, a second tree
+ * can be built over the points padded with ghosts, the periodic images of
+ * points within a given width of the box, so that queries within that width
+ * traverse it once without translating the query point.
  */
 
 namespace freud { namespace locality {
@@ -36,11 +39,42 @@ public:
     AABBQuery();
 
     //! New-style constructor.
-    AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points);
+    /*! \param box Simulation box.
+     *  \param points Point coordinates.
+     *  \param n_points Number of points.
+     *  \param spatial_sort If true, build the tree over a copy of the points
+     *         sorted along a space-filling curve. Query results are unchanged.
+     *  \param ghost_width If positive, also build a tree over the points
+     *         and their periodic images within this distance of the box,
+     *         which is used instead of image vectors by queries up to that
+     *         distance, see computeImageList.
+     */
+    AABBQuery(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+              bool spatial_sort = false, float ghost_width = 0);
 
     //! Destructor
     ~AABBQuery();
 
+    //! Update the point positions without rebuilding the tree.
+    /*! The tree topology is kept and the bounding boxes of all nodes are
+     *  refit to the new positions. This is much cheaper than constructing a
+     *  new AABBQuery, and queries remain exact, but they become slower if
+     *  points move far from the positions the tree was built with. The same
+     *  number of points must be provided, and the new points must remain
+     *  valid for as long as this object is used.
+     *
+     *  The ghosts, if any, are regenerated and the padded tree is rebuilt.
+     *
+     *  \param points The new point coordinates.
+     */
+    void update(const vec3<float>* points);
+
+    //! Get the width of the layer of ghosts around the box, zero if there are none.
+    float getGhostWidth() const
+    {
+        return m_ghost_width;
+    }
+
     //! Implementation of per-particle query for AABBQuery (see NeighborQuery.h for documentation).
     /*! \param query_point The point to find neighbors for.
      *  \param n_query_points The number of query points.
@@ -49,6 +83,267 @@ public:
     virtual std::shared_ptr<NeighborQueryPerPointIterator>
     querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const;
 
+    //! The periodic images that must be searched for a ball query.
+    /*! There are at most 27 images (3 in each periodic dimension), so they
+     *  are stored inline to avoid any allocation. If the tree padded with
+     *  ghosts is searched, only the zero image is.
+     */
+    struct ImageList
+    {
+        vec3<float> vectors[27]; //!< Translation vectors, the first is always zero.
+        unsigned int size;       //!< Number of valid image vectors.
+        bool ghosts;             //!< Whether the tree padded with ghosts is searched.
+    };
+
+    //! Compute the image vectors to search for a ball query.
+    /*! The tree padded with ghosts replaces the image vectors if the ghosts
+     *  extend at least r_max beyond the box and all query points are in the
+     *  box, within a small tolerance. The bonds found are the same either way, but their
+     *  distances may differ in the last digit due to rounding. Without
+     *  query points, the image vectors are always used.
+     *
+     *  \param r_max The query distance.
+     *  \param check_r_max If true, throw if r_max is too large for the box.
+     *  \param query_points The points that will be queried, if known.
+     *  \param n_query_points The number of query points.
+     */
+    ImageList computeImageList(float r_max, bool check_r_max = true,
+                               const vec3<float>* query_points = nullptr,
+                               unsigned int n_query_points = 0) const;
+
+    //! Call a visitor on all neighbors of a point within a ball.
+    /*! This is the allocation-free counterpart to AABBQueryBallIterator. The
+     *  tree is traversed once per image, and every neighbor found is passed
+     *  to the visitor immediately instead of being returned through a virtual
+     *  next() call.
+     *
+     *  \param images Image vectors to search, from computeImageList.
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx (see skipPair).
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void visitBall(const ImageList& images, const vec3<float>& query_point, unsigned int query_point_idx,
+                   float r_max, float r_min, bool exclude_ii, bool half, const Visitor& visitor) const
+    {
+        vec3<float> pos_i(query_point);
+        if (m_box.is2D())
+        {
+            pos_i.z = 0;
+        }
+
+        if (images.ghosts)
+        {
+            visitTreeBall(m_padded_tree, m_padded_points.data(), pos_i, query_point_idx, r_max, r_min,
+                          exclude_ii, half, visitor);
+            return;
+        }
+        for (unsigned int cur_image = 0; cur_image < images.size; ++cur_image)
+        {
+            visitTreeBall(m_aabb_tree, m_tree_points, pos_i + images.vectors[cur_image], query_point_idx,
+                          r_max, r_min, exclude_ii, half, visitor);
+        }
+    }
+
+    //! Count the neighbors of a point within a ball, stopping once max_count are found.
+    /*! This is the counterpart to visitBall for count and exists queries.
+     *  The same points are tested, but no bonds are created and the
+     *  traversal returns as soon as max_count neighbors have been found.
+     *
+     *  \param images Image vectors to search, from computeImageList.
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx (see skipPair).
+     *  \param max_count Number of neighbors after which to stop searching.
+     *  \returns The number of neighbors found, at most max_count.
+     */
+    unsigned int countBall(const ImageList& images, const vec3<float>& query_point,
+                           unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii, bool half,
+                           unsigned int max_count) const;
+
+    //! Maximum number of query points traversing the tree together in visitBallPacket.
+    static const unsigned int PACKET_SIZE = 8;
+
+    //! Call a visitor on all neighbors of a packet of nearby points within a ball.
+    /*! The query points traverse the tree together: each node is tested
+     *  against all of them at once and descended if any of them overlaps
+     *  it, so nodes are loaded once per packet instead of once per point.
+     *  The points of a leaf are tested against the whole packet with
+     *  vectorized distance computations on the leaf points, which are
+     *  stored in structure-of-arrays layout. This pays off when the query
+     *  points are close to each other compared to r_max, so that they
+     *  overlap mostly the same nodes.
+     *
+     *  The bonds found are the same as those of visitBall, and the bonds of
+     *  each query point are visited in the same order, but the bonds of
+     *  different query points of the packet are interleaved.
+     *
+     *  \param images Image vectors to search, from computeImageList.
+     *  \param query_points Query point coordinates.
+     *  \param query_point_indices Indices of the query points of the packet.
+     *  \param num_query_points Number of query points in the packet, at most PACKET_SIZE.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx (see skipPair).
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void visitBallPacket(const ImageList& images, const vec3<float>* query_points,
+                         const unsigned int* query_point_indices, unsigned int num_query_points, float r_max,
+                         float r_min, bool exclude_ii, bool half, const Visitor& visitor) const
+    {
+        const float r_max_sq = r_max * r_max;
+        const float r_min_sq = r_min * r_min;
+        const bool is2D = m_box.is2D();
+        const unsigned int packet_lanes = (1u << num_query_points) - 1;
+
+        // Unused lanes repeat the first query point and are masked out.
+        vec3<float> pos[PACKET_SIZE];
+        for (unsigned int lane = 0; lane < PACKET_SIZE; ++lane)
+        {
+            pos[lane] = query_points[query_point_indices[(lane < num_query_points) ? lane : 0]];
+            if (is2D)
+            {
+                pos[lane].z = 0;
+            }
+        }
+
+        // Query points of the current image and their bonds to the current
+        // leaf point, in structure-of-arrays layout.
+        float x[PACKET_SIZE], y[PACKET_SIZE], z[PACKET_SIZE];
+        float dx[PACKET_SIZE], dy[PACKET_SIZE], dz[PACKET_SIZE], r_sq[PACKET_SIZE];
+#if defined(__SSE__)
+        const __m128 r_max_sq_v = _mm_set1_ps(r_max_sq);
+        const __m128 r_min_sq_v = _mm_set1_ps(r_min_sq);
+#endif
+
+        const AABBTree& tree = images.ghosts ? m_padded_tree : m_aabb_tree;
+        const LeafBlock& leaves = images.ghosts ? m_padded_leaves : m_leaves;
+        const unsigned int num_nodes = tree.getNumNodes();
+        util::profiling::LocalCounter nodes_tested(util::profiling::counter_nodes_tested);
+        for (unsigned int cur_image = 0; cur_image < images.size; ++cur_image)
+        {
+            for (unsigned int lane = 0; lane < PACKET_SIZE; ++lane)
+            {
+                const vec3<float> pos_image = pos[lane] + images.vectors[cur_image];
+                x[lane] = pos_image.x;
+                y[lane] = pos_image.y;
+                z[lane] = pos_image.z;
+            }
+
+            // Stackless traversal of the tree
+            for (unsigned int cur_node_idx = 0; cur_node_idx < num_nodes; ++cur_node_idx)
+            {
+                const AABB& node_aabb = tree.getNodeAABB(cur_node_idx);
+                nodes_tested.add();
+                unsigned int lanes = 0;
+                for (unsigned int group = 0; group < PACKET_SIZE; group += 4)
+                {
+                    lanes |= overlapMask4(node_aabb, x + group, y + group, z + group, r_max_sq) << group;
+                }
+                lanes &= packet_lanes;
+                if (lanes == 0)
+                {
+                    // Skip ahead
+                    cur_node_idx += tree.getNodeSkip(cur_node_idx);
+                    continue;
+                }
+                if (!tree.isNodeLeaf(cur_node_idx))
+                {
+                    continue;
+                }
+
+                const unsigned int leaf_begin = leaves.offsets[cur_node_idx];
+                const unsigned int leaf_end = leaf_begin + tree.getNodeNumParticles(cur_node_idx);
+                for (unsigned int p = leaf_begin; p < leaf_end; ++p)
+                {
+                    unsigned int hits = 0;
+#if defined(__SSE__)
+                    const __m128 x_j = _mm_set1_ps(leaves.x[p]);
+                    const __m128 y_j = _mm_set1_ps(leaves.y[p]);
+                    const __m128 z_j = _mm_set1_ps(leaves.z[p]);
+                    for (unsigned int group = 0; group < PACKET_SIZE; group += 4)
+                    {
+                        const __m128 dx_v = _mm_sub_ps(x_j, _mm_loadu_ps(x + group));
+                        const __m128 dy_v = _mm_sub_ps(y_j, _mm_loadu_ps(y + group));
+                        const __m128 dz_v = _mm_sub_ps(z_j, _mm_loadu_ps(z + group));
+                        const __m128 r_sq_v
+                            = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx_v, dx_v), _mm_mul_ps(dy_v, dy_v)),
+                                         _mm_mul_ps(dz_v, dz_v));
+                        const unsigned int group_hits = static_cast<unsigned int>(_mm_movemask_ps(
+                            _mm_and_ps(_mm_cmplt_ps(r_sq_v, r_max_sq_v), _mm_cmpge_ps(r_sq_v, r_min_sq_v))));
+                        if (group_hits != 0)
+                        {
+                            _mm_storeu_ps(dx + group, dx_v);
+                            _mm_storeu_ps(dy + group, dy_v);
+                            _mm_storeu_ps(dz + group, dz_v);
+                            _mm_storeu_ps(r_sq + group, r_sq_v);
+                            hits |= group_hits << group;
+                        }
+                    }
+#else
+                    for (unsigned int lane = 0; lane < PACKET_SIZE; ++lane)
+                    {
+                        dx[lane] = leaves.x[p] - x[lane];
+                        dy[lane] = leaves.y[p] - y[lane];
+                        dz[lane] = leaves.z[p] - z[lane];
+                        r_sq[lane] = dx[lane] * dx[lane] + dy[lane] * dy[lane] + dz[lane] * dz[lane];
+                        if (r_sq[lane] < r_max_sq && r_sq[lane] >= r_min_sq)
+                        {
+                            hits |= 1u << lane;
+                        }
+                    }
+#endif
+                    hits &= lanes;
+                    if (hits == 0)
+                    {
+                        continue;
+                    }
+
+                    const unsigned int j = leaves.tags[p];
+                    for (unsigned int lane = 0; lane < num_query_points; ++lane)
+                    {
+                        const unsigned int query_point_idx = query_point_indices[lane];
+                        if (((hits >> lane) & 1) != 0 && !skipPair(query_point_idx, j, exclude_ii, half))
+                        {
+                            visitor(NeighborBond(query_point_idx, j, std::sqrt(r_sq[lane]), 1,
+                                                 vec3<float>(dx[lane], dy[lane], dz[lane])));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //! Find the nearest neighbors of a point with a single traversal of the tree.
+    /*! Each periodic image is searched depth first, visiting the nearer child
+     *  of every node first, while a bounded max-heap keeps the nearest points
+     *  found so far. Nodes farther than the farthest point kept are pruned, so
+     *  the tree is traversed once regardless of the number of neighbors
+     *  requested. Each point is found at its closest image, and points whose
+     *  closest image is nearer than r_min are excluded.
+     *
+     *  \param images Image vectors to search, from computeImageList.
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param num_neighbors The number of neighbors to find.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param neighbors Vector filled with the bonds found, sorted by distance.
+     */
+    void findNearest(const ImageList& images, const vec3<float>& query_point, unsigned int query_point_idx,
+                     unsigned int num_neighbors, float r_max, float r_min, bool exclude_ii,
+                     std::vector<NeighborBond>& neighbors) const;
+
     AABBTree m_aabb_tree; //!< AABB tree of points
 
 protected:
@@ -97,6 +392,14 @@ protected:
         }
     }
 
+    //! Build an AABBQuery with the same parameters over the points of one type, see setPointTypes.
+    virtual std::shared_ptr<NeighborQuery> makeTypeQuery(const vec3<float>* points,
+                                                         unsigned int n_points) const
+    {
+        return std::make_shared<AABBQuery>(m_box, points, n_points, m_spatial_order.size() != 0,
+                                           m_ghost_width);
+    }
+
 private:
     //! Driver for tree configuration
     void setupTree(unsigned int N);
@@ -107,7 +410,118 @@ private:
     //! Driver to build AABB trees
     void buildTree(const vec3<float>* points, unsigned int N);
 
+    //! The points of the leaves of a tree, leaf by leaf, in structure-of-arrays layout.
+    struct LeafBlock
+    {
+        std::vector<unsigned int> offsets; //!< Offset of the points of each node in the block.
+        std::vector<float> x;              //!< x coordinates of the points.
+        std::vector<float> y;              //!< y coordinates of the points.
+        std::vector<float> z;              //!< z coordinates of the points, zero in 2D.
+        std::vector<unsigned int> tags;    //!< Point indices of the points.
+    };
+
+    //! Number the points of the leaves of a tree and allocate its leaf block
+    void setupLeafBlock(const AABBTree& tree, LeafBlock& leaves) const;
+
+    //! Copy the points of each leaf of a tree into its leaf block
+    void fillLeafBlock(const AABBTree& tree, const vec3<float>* tree_points, LeafBlock& leaves) const;
+
+    //! Generate the ghosts of the current points and build the padded tree
+    void buildPaddedTree();
+
+    //! Compute all periodic image vectors of the box
+    ImageList computeAllImages() const;
+
+    //! Call a visitor on all points of a tree within a ball, see visitBall.
+    /*! \param tree The tree to traverse.
+     *  \param tree_points Points indexed by the tree's particle indices.
+     *  \param pos_i The center of the ball, with z = 0 in 2D.
+     *  \param query_point_idx The index of the query point.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx.
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void visitTreeBall(const AABBTree& tree, const vec3<float>* tree_points, const vec3<float>& pos_i,
+                       unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii, bool half,
+                       const Visitor& visitor) const
+    {
+        const float r_max_sq = r_max * r_max;
+        const float r_min_sq = r_min * r_min;
+        const bool is2D = m_box.is2D();
+        const AABBSphere asphere(pos_i, r_max);
+
+        // Stackless traversal of the tree
+        const unsigned int num_nodes = tree.getNumNodes();
+        util::profiling::LocalCounter nodes_tested(util::profiling::counter_nodes_tested);
+        for (unsigned int cur_node_idx = 0; cur_node_idx < num_nodes; ++cur_node_idx)
+        {
+            nodes_tested.add();
+            if (overlap(tree.getNodeAABB(cur_node_idx), asphere))
+            {
+                if (tree.isNodeLeaf(cur_node_idx))
+                {
+                    const unsigned int num_particles = tree.getNodeNumParticles(cur_node_idx);
+                    for (unsigned int cur_p = 0; cur_p < num_particles; ++cur_p)
+                    {
+                        const unsigned int j = tree.getNodeParticleTag(cur_node_idx, cur_p);
+                        if (skipPair(query_point_idx, j, exclude_ii, half))
+                        {
+                            continue;
+                        }
+
+                        vec3<float> pos_j(tree_points[tree.getNodeParticle(cur_node_idx, cur_p)]);
+                        if (is2D)
+                        {
+                            pos_j.z = 0;
+                        }
+
+                        const vec3<float> r_ij = pos_j - pos_i;
+                        const float r_sq = dot(r_ij, r_ij);
+                        if (r_sq < r_max_sq && r_sq >= r_min_sq)
+                        {
+                            visitor(NeighborBond(query_point_idx, j, std::sqrt(r_sq), 1, r_ij));
+                        }
+                    }
+                }
+            }
+            else
+            {
+                // Skip ahead
+                cur_node_idx += tree.getNodeSkip(cur_node_idx);
+            }
+        }
+    }
+
+    //! Count the points of a tree within a ball up to max_count, see countBall.
+    /*! \param tree The tree to traverse.
+     *  \param tree_points Points indexed by the tree's particle indices.
+     *  \param pos_i The center of the ball, with z = 0 in 2D.
+     *  \param query_point_idx The index of the query point.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx.
+     *  \param max_count Number of neighbors after which to stop searching.
+     *  \param count Number of neighbors found so far, incremented by the neighbors in this tree.
+     */
+    void countTreeBall(const AABBTree& tree, const vec3<float>* tree_points, const vec3<float>& pos_i,
+                       unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii, bool half,
+                       unsigned int max_count, unsigned int& count) const;
+
     std::vector<AABB> m_aabbs; //!< Flat array of AABBs of all types
+    util::ManagedArray<vec3<float>> m_sorted_points; //!< Copy of the points in spatial order, if requested.
+    const vec3<float>* m_tree_points; //!< Points indexed by the tree's particle indices.
+
+    LeafBlock m_leaves; //!< Points of the leaves of the tree.
+
+    float m_ghost_width;                      //!< Width of the layer of ghosts around the box.
+    AABBTree m_padded_tree;                   //!< AABB tree of the points and their ghosts.
+    std::vector<vec3<float>> m_padded_points; //!< Points followed by ghosts, with z = 0 in 2D.
+    std::vector<AABB> m_padded_aabbs;         //!< AABBs of the points and ghosts, tagged with point indices.
+    LeafBlock m_padded_leaves;                //!< Points of the leaves of the padded tree.
 };
 
 //! Parent class of AABB iterators that knows how to traverse general AABB tree structures.
@@ -116,9 +530,9 @@ class AABBIterator : public NeighborQueryPerPointIterator
 public:
     //! Constructor
     AABBIterator(const AABBQuery* neighbor_query, const vec3<float> query_point, unsigned int query_point_idx,
-                 float r_max, float r_min, bool exclude_ii)
+                 float r_max, float r_min, bool exclude_ii, bool half = false)
         : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min,
-                                        exclude_ii),
+                                        exclude_ii, half),
           m_aabb_query(neighbor_query)
     {}
 
@@ -135,19 +549,19 @@ protected:
 };
 
 //! Iterator that gets a specified number of nearest neighbors from AABB tree structures.
+/*! The neighbors are found all at once by AABBQuery::findNearest the first
+ *  time next() is called, and then returned one at a time.
+ */
 class AABBQueryIterator : public AABBIterator
 {
 public:
     //! Constructor
     AABBQueryIterator(const AABBQuery* neighbor_query, const vec3<float> query_point,
-                      unsigned int query_point_idx, unsigned int num_neighbors, float r_guess, float r_max,
-                      float r_min, float scale, bool exclude_ii)
+                      unsigned int query_point_idx, unsigned int num_neighbors, float r_max, float r_min,
+                      bool exclude_ii)
         : AABBIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii), m_count(0),
-          m_num_neighbors(num_neighbors), m_search_extended(false), m_r_cur(r_guess), m_scale(scale),
-          m_all_distances(), m_query_points_below_r_min()
-    {
-        updateImageVectors(0);
-    }
+          m_num_neighbors(num_neighbors), m_searched(false)
+    {}
 
     //! Empty Destructor
     virtual ~AABBQueryIterator() {}
@@ -158,16 +572,8 @@ public:
 protected:
     unsigned int m_count;                          //!< Number of neighbors returned for the current point.
     unsigned int m_num_neighbors;                  //!< Number of nearest neighbors to find
+    bool m_searched;                               //!< Whether the neighbors have been found yet.
     std::vector<NeighborBond> m_current_neighbors; //!< The current set of found neighbors.
-    float m_search_extended; //!< Flag to see whether we've gone past the safe cutoff distance and have to be
-                             //!< worried about finding duplicates.
-    float
-        m_r_cur; //!< Current search ball cutoff distance in use for the current particle (expands as needed).
-    float m_scale; //!< The amount to scale m_r by when the current ball is too small.
-    std::map<unsigned int, float> m_all_distances; //!< Hash map of minimum distances found for a given point,
-                                                   //!< used when searching beyond maximum safe AABB distance.
-    std::unordered_set<unsigned int> m_query_points_below_r_min; //!< The set of query_points that were too
-                                                                 //!< close based on the r_min threshold.
 };
 
 //! Iterator that gets neighbors in a ball of size r_max using AABB tree structures.
@@ -177,9 +583,9 @@ public:
     //! Constructor
     AABBQueryBallIterator(const AABBQuery* neighbor_query, const vec3<float> query_point,
                           unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
-                          bool _check_r_max = true)
-        : AABBIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii), cur_image(0),
-          cur_node_idx(0), cur_ref_p(0)
+                          bool half = false, bool _check_r_max = true)
+        : AABBIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii, half),
+          cur_image(0), cur_node_idx(0), cur_ref_p(0)
     {
         updateImageVectors(m_r_max, _check_r_max);
     }
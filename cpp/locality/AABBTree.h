@@ -4,9 +4,11 @@
 #ifndef AABB_TREE_H
 #define AABB_TREE_H
 
+#include <algorithm>
 #include <cstring>
 #include <stack>
 #include <stdexcept>
+#include <tbb/task_group.h>
 #include <vector>
 
 #include "AABB.h"
@@ -27,8 +29,9 @@
 
 namespace freud { namespace locality {
 
-const unsigned int NODE_CAPACITY = 16;        //!< Maximum number of particles in a node
-const unsigned int INVALID_NODE = 0xffffffff; //!< Invalid node index sentinel
+const unsigned int NODE_CAPACITY = 16;           //!< Maximum number of particles in a node
+const unsigned int INVALID_NODE = 0xffffffff;    //!< Invalid node index sentinel
+const unsigned int PARALLEL_BUILD_CUTOFF = 4096; //!< Minimum number of particles of a parallel subtree build
 
 //! Node in an AABBTree
 /*! Stores data for a node in the AABB tree
@@ -69,11 +72,12 @@ struct CACHE_ALIGN AABBNode
 
     **Implementation details**
 
-    AABBTree stores all nodes in a flat array managed by std::vector. To easily locate particle leaf nodes for
-   update, a reverse mapping is stored to locate the leaf node containing a particle. m_root tracks the index
-   of the root node as the tree is built. The nodes store the indices of their left and right children along
-   with their AABB. Nodes are allocated as needed with allocate(). With multiple particles per leaf node, the
-   total number of internal nodes needed is not known (but can be estimated) until build time.
+    AABBTree stores all nodes in a flat aligned array, in the pre-order of a depth first traversal. To easily
+   locate particle leaf nodes for update, a reverse mapping is stored to locate the leaf node containing a
+   particle. The nodes store the indices of their left and right children along with their AABB. Every node is
+   split at the median particle, so the number of nodes of each subtree only depends on its number of
+   particles. The node array is therefore allocated once at build time, and subtrees are built in parallel
+   directly into their final positions.
 
     For performance, no recursive calls are used. Instead, each function is either turned into a loop if it
    uses tail recursion, or it uses a local stack to traverse the tree. The stack is cached between calls to
@@ -145,7 +149,10 @@ public:
     }
 
     //! Build a tree smartly from a list of AABBs
-    inline void buildTree(AABB* aabbs, unsigned int N);
+    inline void buildTree(const AABB* aabbs, unsigned int N);
+
+    //! Get the number of nodes of a tree built over a given number of particles
+    static inline unsigned int countNodes(unsigned int N);
 
     //! Find all particles that overlap with the query AABB
     inline unsigned int query(std::vector<unsigned int>& hits, const AABB& aabb) const;
@@ -153,6 +160,9 @@ public:
     //! Update the AABB of a particle
     inline void update(unsigned int idx, const AABB& aabb);
 
+    //! Recompute all node AABBs from a new set of particle AABBs
+    inline void refit(const AABB* aabbs);
+
     //! Get the height of a given particle's leaf node
     inline unsigned int height(unsigned int idx);
 
@@ -237,15 +247,16 @@ private:
     //! Initialize the tree to hold N particles
     inline void init(unsigned int N);
 
-    //! Build a node of the tree recursively
-    inline unsigned int buildNode(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
-                                  unsigned int len, unsigned int parent);
-
-    //! Allocate a new node
-    inline unsigned int allocateNode();
+    //! A particle being sorted into the tree by buildTree()
+    struct BuildParticle
+    {
+        vec3<float> center; //!< Center of the particle's AABB
+        unsigned int idx;   //!< Index of the particle
+    };
 
-    //! Update the skip value for a node
-    inline unsigned int updateSkip(unsigned int idx);
+    //! Build the subtree rooted at a node
+    inline void buildNode(const AABB* aabbs, BuildParticle* particles, unsigned int start, unsigned int len,
+                          unsigned int node_idx, unsigned int parent);
 };
 
 /*! \param N Number of particles to allocate space for
@@ -254,15 +265,66 @@ private:
 */
 inline void AABBTree::init(unsigned int N)
 {
-    // clear the nodes
-    m_num_nodes = 0;
+    // allocate all the nodes at once, reusing the old memory if it is large enough
+    m_num_nodes = countNodes(N);
+    if (m_num_nodes > m_node_capacity)
+    {
+        if (m_nodes != NULL)
+        {
+            posix_memalign_free(m_nodes);
+            m_nodes = NULL;
+            m_node_capacity = 0;
+        }
+        int retval = posix_memalign((void**) &m_nodes, 32, m_num_nodes * sizeof(AABBNode));
+        if (retval != 0)
+        {
+            m_nodes = NULL;
+            m_num_nodes = 0;
+            throw std::runtime_error("Error allocating AABBTree memory");
+        }
+        m_node_capacity = m_num_nodes;
+    }
 
     // init the root node and mapping to invalid states
     m_root = INVALID_NODE;
-    m_mapping.resize(N);
+    m_mapping.assign(N, INVALID_NODE);
+}
+
+/*! \param N Number of particles
+    \returns the number of nodes of a tree built by buildTree() over N particles
+
+    Subtrees are split in halves, so the subtrees at a given depth have at most two consecutive sizes, and
+   their numbers are counted one depth at a time.
+*/
+inline unsigned int AABBTree::countNodes(unsigned int N)
+{
+    if (N == 0)
+    {
+        return 0;
+    }
 
-    for (unsigned int i = 0; i < N; i++)
-        m_mapping[i] = INVALID_NODE;
+    unsigned int num_nodes = 0;
+    unsigned int size = N;
+    unsigned int counts[2] = {1, 0}; // number of subtrees of size and size + 1 at the current depth
+    while (counts[0] + counts[1] != 0)
+    {
+        const unsigned int next_size = size / 2;
+        unsigned int next_counts[2] = {0, 0};
+        for (unsigned int k = 0; k < 2; ++k)
+        {
+            const unsigned int len = size + k;
+            num_nodes += counts[k];
+            if (len > NODE_CAPACITY)
+            {
+                next_counts[len / 2 - next_size] += counts[k];
+                next_counts[len - len / 2 - next_size] += counts[k];
+            }
+        }
+        size = next_size;
+        counts[0] = next_counts[0];
+        counts[1] = next_counts[1];
+    }
+    return num_nodes;
 }
 
 /*! \param hits Output vector of positive hits.
@@ -334,6 +396,35 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
     }
 }
 
+/*! \param aabbs List of AABBs for each particle, in the order originally passed to buildTree()
+
+    Recompute the AABB of every node to tightly enclose the new particle AABBs. Unlike update(), node volumes
+   can shrink, so refitting repeatedly does not degrade the tree. The tree topology is left unchanged, so the
+   tree should still be rebuilt if particles move far from their original positions. Runs in O(N) time.
+*/
+inline void AABBTree::refit(const AABB* aabbs)
+{
+    // Nodes are always allocated before their children in buildNode(), so a
+    // reverse pass visits all children before their parents.
+    for (unsigned int node_idx = m_num_nodes; node_idx-- > 0;)
+    {
+        AABBNode& node = m_nodes[node_idx];
+        if (node.left == INVALID_NODE)
+        {
+            AABB node_aabb = aabbs[node.particles[0]];
+            for (unsigned int i = 1; i < node.num_particles; ++i)
+            {
+                node_aabb = merge(node_aabb, aabbs[node.particles[i]]);
+            }
+            node.aabb = node_aabb;
+        }
+        else
+        {
+            node.aabb = merge(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+        }
+    }
+}
+
 /*! \param idx Particle to get height for
     \returns Height of the node
 */
@@ -362,233 +453,120 @@ inline unsigned int AABBTree::height(unsigned int idx)
 /*! \param aabbs List of AABBs for each particle (must be 32-byte aligned)
     \param N Number of AABBs in the list
 
-    Builds a balanced tree from a given list of AABBs for each particle. Data in \a aabbs will be modified
-   during the construction process.
+    Builds a balanced tree from a given list of AABBs for each particle. Each node is split at the median
+   particle along the longest dimension of the particle centers. Subtrees of at least PARALLEL_BUILD_CUTOFF
+   particles are built in parallel, and the resulting tree does not depend on the number of threads.
 */
-inline void AABBTree::buildTree(AABB* aabbs, unsigned int N)
+inline void AABBTree::buildTree(const AABB* aabbs, unsigned int N)
 {
     init(N);
+    if (N == 0)
+    {
+        return;
+    }
 
-    std::vector<unsigned int> idx;
-    for (unsigned int i = 0; i < N; i++)
-        idx.push_back(i);
+    // the centers are stored with the indices so that partitioning accesses memory contiguously
+    std::vector<BuildParticle> particles(N);
+    for (unsigned int i = 0; i < N; ++i)
+    {
+        particles[i].center = aabbs[i].getPosition();
+        particles[i].idx = i;
+    }
 
-    m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
-    updateSkip(m_root);
+    m_root = 0;
+    buildNode(aabbs, particles.data(), 0, N, m_root, INVALID_NODE);
 }
 
 /*! \param aabbs List of AABBs
-    \param idx List of indices
-    \param start Start point in aabbs and idx to examine
+    \param particles List of particle centers and indices
+    \param start Start point in particles to examine
     \param len Number of aabbs to examine
+    \param node_idx Index of the node to build
     \param parent Index of the parent node
 
-    buildNode is the main driver of the smart AABB tree build algorithm. Each call produces a node, given a
-   set of AABBs. If there are fewer AABBs than fit in a leaf, a leaf is generated. If there are too many, the
-   total AABB is computed and split on the largest length axis. The total tree is built by recursive
-   splitting.
+    buildNode is the main driver of the AABB tree build algorithm. Each call produces the subtree of a node,
+   given a set of AABBs. If there are fewer AABBs than fit in a leaf, a leaf is generated. If there are too
+   many, the first half of the AABBs along the longest dimension goes to the left child and the rest to the
+   right child. The left subtree immediately follows the node in the node array and the right subtree follows
+   the left subtree, so the skip of the node is the number of nodes in both subtrees.
 
-    The aabbs and idx lists are passed in by reference. Each node is given a subrange of the list to own
-   (start to start + len). When building the node, it partitions its subrange into two sides (like quick
-   sort).
+    The particles list is partitioned in place. Each node owns the subrange from start to start + len.
 */
-inline unsigned int AABBTree::buildNode(AABB* aabbs, std::vector<unsigned int>& idx, unsigned int start,
-                                        unsigned int len, unsigned int parent)
+inline void AABBTree::buildNode(const AABB* aabbs, BuildParticle* particles, unsigned int start,
+                                unsigned int len, unsigned int node_idx, unsigned int parent)
 {
-    // merge all the AABBs into one
-    AABB my_aabb = aabbs[start];
-    for (unsigned int i = 1; i < len; i++)
-    {
-        my_aabb = merge(my_aabb, aabbs[start + i]);
-    }
-    vec3<float> my_radius = my_aabb.getUpper() - my_aabb.getLower();
+    AABBNode& node = m_nodes[node_idx];
+    node = AABBNode();
+    node.parent = parent;
 
     // handle the case of a leaf node creation
     if (len <= NODE_CAPACITY)
     {
-        unsigned int new_node = allocateNode();
-        m_nodes[new_node].aabb = my_aabb;
-        m_nodes[new_node].parent = parent;
-        m_nodes[new_node].num_particles = len;
-
+        node.aabb = aabbs[particles[start].idx];
         for (unsigned int i = 0; i < len; i++)
         {
             // assign the particle indices into the leaf node
-            m_nodes[new_node].particles[i] = idx[start + i];
-            m_nodes[new_node].particle_tags[i] = aabbs[start + i].tag;
+            const unsigned int particle = particles[start + i].idx;
+            node.aabb = merge(node.aabb, aabbs[particle]);
+            node.particles[i] = particle;
+            node.particle_tags[i] = aabbs[particle].tag;
 
             // assign the reverse mapping from particle indices to leaf node indices
-            m_mapping[idx[start + i]] = new_node;
+            m_mapping[particle] = node_idx;
         }
-
-        return new_node;
+        node.num_particles = len;
+        return;
     }
 
-    // otherwise, we are creating an internal node - allocate an index
-    unsigned int my_idx = allocateNode();
-
-    // need to split the list of aabbs into two sets for left and right
-    unsigned int start_left = 0;
-    unsigned int start_right = len;
-
-    // if there are only 2 aabbs, put one on each side
-    if (len == 2)
+    // split the longest dimension at the median, breaking ties by index so that the partition is
+    // deterministic
+    const unsigned int len_left = len / 2;
+    vec3<float> lower(particles[start].center);
+    vec3<float> upper(lower);
+    for (unsigned int i = 1; i < len; i++)
     {
-        // nothing to do, already partitioned
+        const vec3<float>& center = particles[start + i].center;
+        lower = vec3<float>(std::min(lower.x, center.x), std::min(lower.y, center.y),
+                            std::min(lower.z, center.z));
+        upper = vec3<float>(std::max(upper.x, center.x), std::max(upper.y, center.y),
+                            std::max(upper.z, center.z));
     }
-    else
+    const vec3<float> extent = upper - lower;
+    float vec3<float>::*axis = &vec3<float>::z;
+    if (extent.x > extent.y && extent.x > extent.z)
     {
-        // otherwise, we need to split them based on a heuristic. split the longest dimension in half
-        if (my_radius.x > my_radius.y && my_radius.x > my_radius.z)
-        {
-            // split on x direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().x < my_aabb.getPosition().x)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
-        }
-        else if (my_radius.y > my_radius.z)
-        {
-            // split on y direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().y < my_aabb.getPosition().y)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
-        }
-        else
-        {
-            // split on z direction
-            for (unsigned int i = 0; i < start_right; i++)
-            {
-                if (aabbs[start + i].getPosition().z < my_aabb.getPosition().z)
-                {
-                    // if on the left side, everything is happy, just continue on
-                }
-                else
-                {
-                    // if on the right side, need to swap the current aabb with the one at
-                    // start_right-1, subtract one off of start_right to indicate the addition
-                    // of one to the right side and subtract 1 from i to look at the current
-                    // index (new aabb). This is quick and easy to write, but will randomize
-                    // indices - might need to look into a stable partitioning algorithm!
-                    std::swap(aabbs[start + i], aabbs[start + start_right - 1]);
-                    std::swap(idx[start + i], idx[start + start_right - 1]);
-                    start_right--;
-                    i--;
-                }
-            }
-        }
+        axis = &vec3<float>::x;
     }
-
-    // sanity check. The left or right tree may have ended up empty. If so, just borrow one particle from it
-    if (start_right == len)
-        start_right = len - 1;
-    if (start_right == 0)
-        start_right = 1;
-
-    // note: calling buildNode has side effects, the m_nodes array may be reallocated. So we need to determine
-    // the left and right children, then build our node (can't say m_nodes[my_idx].left = buildNode(...))
-    unsigned int new_left = buildNode(aabbs, idx, start + start_left, start_right - start_left, my_idx);
-    unsigned int new_right = buildNode(aabbs, idx, start + start_right, len - start_right, my_idx);
-
-    // now, create the children and connect them up
-    m_nodes[my_idx].aabb = my_aabb;
-    m_nodes[my_idx].parent = parent;
-    m_nodes[my_idx].left = new_left;
-    m_nodes[my_idx].right = new_right;
-
-    return my_idx;
-}
-
-/*! \param idx Index of the node to update
-
-    updateSkip() updates the skip field of every node in the tree. The skip field is used in the stackless
-    implementation of query. Each node's skip field lists the number of nodes that are children to this node.
-   Because of the order in which nodes are built in buildNode(), this number is the number of elements to skip
-   in a search if a box-box test does not overlap.
-*/
-inline unsigned int AABBTree::updateSkip(unsigned int idx)
-{
-    // leaf nodes have no nodes under them
-    if (isNodeLeaf(idx))
+    else if (extent.y > extent.z)
     {
-        return 1;
+        axis = &vec3<float>::y;
     }
-    else
+    std::nth_element(particles + start, particles + start + len_left, particles + start + len,
+                     [axis](const BuildParticle& a, const BuildParticle& b) {
+                         return a.center.*axis < b.center.*axis
+                             || (a.center.*axis == b.center.*axis && a.idx < b.idx);
+                     });
+
+    const unsigned int left = node_idx + 1;
+    const unsigned int right = left + countNodes(len_left);
+    if (len >= PARALLEL_BUILD_CUTOFF)
     {
-        // node idx needs to skip all the nodes underneath it (determined recursively)
-        unsigned int left_idx = m_nodes[idx].left;
-        unsigned int right_idx = m_nodes[idx].right;
-
-        unsigned int skip = updateSkip(left_idx) + updateSkip(right_idx);
-        m_nodes[idx].skip = skip;
-        return skip + 1;
+        tbb::task_group group;
+        group.run([=] { buildNode(aabbs, particles, start, len_left, left, node_idx); });
+        buildNode(aabbs, particles, start + len_left, len - len_left, right, node_idx);
+        group.wait();
     }
-}
-
-/*! Allocates a new node in the tree
- */
-inline unsigned int AABBTree::allocateNode()
-{
-    // grow the memory if needed
-    if (m_num_nodes >= m_node_capacity)
+    else
     {
-        // determine new capacity
-        AABBNode* m_new_nodes = NULL;
-        unsigned int m_new_node_capacity = m_node_capacity * 2;
-        if (m_new_node_capacity == 0)
-            m_new_node_capacity = 16;
-
-        // allocate new memory
-        int retval = posix_memalign((void**) &m_new_nodes, 32, m_new_node_capacity * sizeof(AABBNode));
-        if (retval != 0)
-        {
-            throw std::runtime_error("Error allocating AABBTree memory");
-        }
-
-        // if we have old memory, copy it over
-        if (m_nodes != NULL)
-        {
-            std::memcpy((void*) m_new_nodes, (void*) m_nodes, sizeof(AABBNode) * m_num_nodes);
-            posix_memalign_free(m_nodes);
-        }
-        m_nodes = m_new_nodes;
-        m_node_capacity = m_new_node_capacity;
+        buildNode(aabbs, particles, start, len_left, left, node_idx);
+        buildNode(aabbs, particles, start + len_left, len - len_left, right, node_idx);
     }
 
-    m_nodes[m_num_nodes] = AABBNode();
-    m_num_nodes++;
-    return m_num_nodes - 1;
+    // the children are complete, so the node encloses them
+    node.aabb = merge(m_nodes[left].aabb, m_nodes[right].aabb);
+    node.left = left;
+    node.right = right;
+    node.skip = countNodes(len) - 1;
 }
 
 }; }; // end namespace freud::locality
@@ -0,0 +1,151 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
+
+#include "BondGeometry.h"
+#include "NeighborComputeFunctional.h"
+#include "Profiling.h"
+#include "SphericalHarmonics.h"
+#include "utils.h"
+
+/*! \file BondGeometry.cc
+    \brief Per-bond directions and spherical harmonics shared by computes.
+*/
+
+namespace freud { namespace locality {
+
+BondGeometry::BondGeometry(const NeighborList* nlist, const NeighborQuery* neighbor_query,
+                           const vec3<float>* query_points, unsigned int l_max)
+    : m_nlist(nlist), m_l_max(l_max), m_has_unit_vectors(false), m_has_angles(false),
+      m_has_harmonics(false)
+{
+    if (nlist->getNumPoints() != neighbor_query->getNPoints())
+    {
+        throw std::invalid_argument("The number of points must match the number of points of the "
+                                    "NeighborList.");
+    }
+    if (nlist->hasVectors())
+    {
+        m_vectors = nlist->getVectors();
+        return;
+    }
+    m_vectors.prepareForOverwrite({nlist->getNumBonds()});
+    util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            m_vectors[bond] = bondVector(nlist, bond, neighbor_query, query_points);
+        }
+    });
+}
+
+void BondGeometry::validate(const NeighborList* nlist, unsigned int l_max) const
+{
+    if (nlist != m_nlist)
+    {
+        throw std::invalid_argument("The BondGeometry was computed for a different NeighborList.");
+    }
+    if (l_max > m_l_max)
+    {
+        throw std::invalid_argument("The BondGeometry does not store the spherical harmonics of l = "
+                                    + std::to_string(l_max) + ", its largest l is "
+                                    + std::to_string(m_l_max) + ".");
+    }
+}
+
+const util::ManagedArray<vec3<float>>& BondGeometry::getUnitVectors()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_has_unit_vectors)
+    {
+        util::profiling::ScopedTimer timer("BondGeometry::computeUnitVectors");
+        const float* distances = m_nlist->getDistances().get();
+        m_unit_vectors.prepareForOverwrite({m_nlist->getNumBonds()});
+        // Isolation keeps this thread from picking up work that waits for the lock.
+        tbb::this_task_arena::isolate([&]() {
+            util::forLoopWrapper(0, m_nlist->getNumBonds(), [&](size_t begin, size_t end) {
+                for (size_t bond = begin; bond < end; ++bond)
+                {
+                    m_unit_vectors[bond] = (distances[bond] > 0) ? m_vectors[bond] / distances[bond]
+                                                                 : vec3<float>(0, 0, 1);
+                }
+            });
+        });
+        m_has_unit_vectors = true;
+    }
+    return m_unit_vectors;
+}
+
+void BondGeometry::computeAngles()
+{
+    if (m_has_angles)
+    {
+        return;
+    }
+    util::profiling::ScopedTimer timer("BondGeometry::computeAngles");
+    m_theta.prepareForOverwrite({m_nlist->getNumBonds()});
+    m_phi.prepareForOverwrite({m_nlist->getNumBonds()});
+    tbb::this_task_arena::isolate([&]() {
+        util::forLoopWrapper(0, m_nlist->getNumBonds(), [&](size_t begin, size_t end) {
+            for (size_t bond = begin; bond < end; ++bond)
+            {
+                // The angles are computed from the bond vector as by BondOrder
+                // and LocalDescriptors, so that they bin bonds identically.
+                const vec3<float>& v = m_vectors[bond];
+                const float r_sq = dot(v, v);
+                m_theta[bond] = util::modulusPositive(std::atan2(v.y, v.x), constants::TWO_PI);
+                m_phi[bond] = (r_sq > 0) ? std::acos(util::clamp(v.z / std::sqrt(r_sq), -1, 1)) : 0;
+            }
+        });
+    });
+    m_has_angles = true;
+}
+
+const util::ManagedArray<float>& BondGeometry::getTheta()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    computeAngles();
+    return m_theta;
+}
+
+const util::ManagedArray<float>& BondGeometry::getPhi()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    computeAngles();
+    return m_phi;
+}
+
+const util::ManagedArray<std::complex<float>>& BondGeometry::getHarmonics()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_has_harmonics)
+    {
+        util::profiling::ScopedTimer timer("BondGeometry::computeHarmonics");
+        const unsigned int num_ms = (m_l_max + 1) * (m_l_max + 1);
+        const float* distances = m_nlist->getDistances().get();
+        m_harmonics.prepareForOverwrite({m_nlist->getNumBonds(), num_ms});
+        const util::SphericalHarmonics exemplar(m_l_max);
+        tbb::enumerable_thread_specific<util::SphericalHarmonics> local_ylm(exemplar);
+        tbb::this_task_arena::isolate([&]() {
+            util::forLoopWrapper(0, m_nlist->getNumBonds(), [&](size_t begin, size_t end) {
+                util::SphericalHarmonics& ylm = local_ylm.local();
+                for (size_t bond = begin; bond < end; ++bond)
+                {
+                    // The harmonics are evaluated from the bond vector and
+                    // distance as by Steinhardt.
+                    ylm.compute(m_vectors[bond], distances[bond]);
+                    std::copy(ylm.getYlm(0), ylm.getYlm(0) + num_ms, &m_harmonics[bond * num_ms]);
+                }
+            });
+        });
+        m_has_harmonics = true;
+    }
+    return m_harmonics;
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,112 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef BOND_GEOMETRY_H
+#define BOND_GEOMETRY_H
+
+#include <complex>
+#include <mutex>
+
+#include "ManagedArray.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file BondGeometry.h
+    \brief Per-bond directions and spherical harmonics shared by computes.
+*/
+
+namespace freud { namespace locality {
+
+//! Directions and spherical harmonics of the bonds of a NeighborList.
+/*! Computes of bond orientational order, such as Steinhardt, SolidLiquid,
+ *  LocalDescriptors and BondOrder, all evaluate the directions of the same
+ *  bonds when they analyze the same frame, and the first three also
+ *  evaluate the same spherical harmonics. A BondGeometry stores these
+ *  quantities for the bonds of a NeighborList so that every compute given
+ *  it reads them instead of evaluating them again.
+ *
+ *  The bond vectors are stored on construction. The unit vectors, the angles
+ *  and the harmonics are each computed in parallel on first use and kept
+ *  for later computes. Bonds of zero length are treated as pointing along
+ *  z, as by util::SphericalHarmonics. It is safe to use from multiple
+ *  threads.
+ */
+class BondGeometry
+{
+public:
+    //! Constructor
+    /*! \param nlist The NeighborList, which must outlive this object and not be modified.
+     *  \param neighbor_query The points of the bonds.
+     *  \param query_points The query points of the bonds.
+     *  \param l_max Largest l of the spherical harmonics.
+     */
+    BondGeometry(const NeighborList* nlist, const NeighborQuery* neighbor_query,
+                 const vec3<float>* query_points, unsigned int l_max);
+
+    //! Get the NeighborList of the bonds.
+    const NeighborList* getNeighborList() const
+    {
+        return m_nlist;
+    }
+
+    //! Get the number of bonds.
+    unsigned int getNumBonds() const
+    {
+        return m_nlist->getNumBonds();
+    }
+
+    //! Get the largest l of the spherical harmonics.
+    unsigned int getLMax() const
+    {
+        return m_l_max;
+    }
+
+    //! Throw an invalid_argument if the bonds of a compute are not those of this object.
+    /*! \param nlist The NeighborList the compute loops over.
+     *  \param l_max Largest l of the harmonics the compute reads.
+     */
+    void validate(const NeighborList* nlist, unsigned int l_max = 0) const;
+
+    //! Get the vector of each bond, from the query point to the point.
+    const util::ManagedArray<vec3<float>>& getVectors() const
+    {
+        return m_vectors;
+    }
+
+    //! Get the unit vector of each bond.
+    const util::ManagedArray<vec3<float>>& getUnitVectors();
+
+    //! Get the azimuthal angle of each bond in [0, 2 PI).
+    const util::ManagedArray<float>& getTheta();
+
+    //! Get the polar angle of each bond in [0, PI].
+    const util::ManagedArray<float>& getPhi();
+
+    //! Get the spherical harmonics of each bond.
+    /*! Each row holds the harmonics of a bond for all l up to l_max, in the
+     *  order of util::SphericalHarmonics: the 2l+1 values of each l start
+     *  at column l*l and are ordered as m = 0, 1, ..., l, -1, ..., -l.
+     */
+    const util::ManagedArray<std::complex<float>>& getHarmonics();
+
+private:
+    //! Compute the angles of the bonds if they have not been computed.
+    void computeAngles();
+
+    const NeighborList* m_nlist;                         //!< NeighborList of the bonds.
+    unsigned int m_l_max;                                //!< Largest l of the harmonics.
+    util::ManagedArray<vec3<float>> m_vectors;           //!< Bond vectors.
+    util::ManagedArray<vec3<float>> m_unit_vectors;      //!< Bond unit vectors.
+    util::ManagedArray<float> m_theta;                   //!< Azimuthal angles of the bonds.
+    util::ManagedArray<float> m_phi;                     //!< Polar angles of the bonds.
+    util::ManagedArray<std::complex<float>> m_harmonics; //!< Spherical harmonics of the bonds.
+    bool m_has_unit_vectors;                             //!< Whether the unit vectors are computed.
+    bool m_has_angles;                                   //!< Whether the angles are computed.
+    bool m_has_harmonics;                                //!< Whether the harmonics are computed.
+    std::mutex m_mutex;                                  //!< Serializes the computation of each quantity.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // BOND_GEOMETRY_H
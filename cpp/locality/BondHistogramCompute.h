@@ -1,10 +1,15 @@
 #ifndef HISTOGRAM_COMPUTE_H
 #define HISTOGRAM_COMPUTE_H
 
+#include <cstdint>
+#include <string>
+
 #include "Box.h"
 #include "Histogram.h"
 #include "NeighborComputeFunctional.h"
 #include "NeighborQuery.h"
+#include "Serialization.h"
+#include "Trajectory.h"
 
 namespace freud { namespace locality {
 
@@ -21,8 +26,9 @@ class BondHistogramCompute
 public:
     //! Default constructor
     BondHistogramCompute()
-        : m_box(box::Box()), m_frame_counter(0), m_n_points(0), m_n_query_points(0), m_reduce(true),
-          m_histogram(), m_local_histograms()
+        : m_box(box::Box()), m_frame_counter(0), m_n_points(0), m_n_query_points(0), m_same_types(true),
+          m_reduce(true), m_strategy(util::accumulate_auto), m_parallel_frames(false), m_histogram(),
+          m_local_histograms()
     {}
 
     //! Destructor
@@ -39,6 +45,20 @@ public:
     //! Reduce thread-local arrays onto the primary data arrays.
     virtual void reduce() = 0;
 
+    //! Set how bonds are accumulated in parallel, resetting the histogram.
+    virtual void setAccumulationStrategy(util::AccumulationStrategy strategy)
+    {
+        m_strategy = strategy;
+        m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram, strategy);
+        reset();
+    }
+
+    //! Get how bonds are accumulated in parallel.
+    util::AccumulationStrategy getAccumulationStrategy() const
+    {
+        return m_strategy;
+    }
+
     //! Get the simulation box
     const box::Box& getBox() const
     {
@@ -90,6 +110,58 @@ public:
         return m_histogram.getAxisSizes();
     }
 
+    //! Record the system of a frame before its bonds are accumulated.
+    /*! This is called by accumulateGeneral, and by NeighborPipeline stages
+     *  that accumulate bonds found by a shared traversal.
+     */
+    void startFrame(const locality::NeighborQuery* neighbor_query, unsigned int n_query_points)
+    {
+        if (m_parallel_frames)
+        {
+            return;
+        }
+        m_box = neighbor_query->getBox();
+        m_n_points = neighbor_query->getNPoints();
+        m_n_query_points = n_query_points;
+        m_same_types = true;
+    }
+
+    //! Record the system of a frame whose bonds are found by a query that may be filtered by type.
+    /*! The numbers of points and query points are those of the queried
+     *  types, so that the bonds are normalized by the density of the points
+     *  of the queried type. Queries of points and query points filtered to
+     *  different types find no bonds of points with themselves, which is
+     *  recorded in m_same_types.
+     */
+    void startFrame(const locality::NeighborQuery* neighbor_query, unsigned int n_query_points,
+                    const locality::QueryArgs& qargs)
+    {
+        startFrame(neighbor_query, n_query_points);
+        if (!m_parallel_frames && locality::isTypedQuery(qargs))
+        {
+            m_n_points = neighbor_query->getNPointsOfType(qargs.point_type);
+            if (qargs.query_point_type != locality::QueryArgs::ANY_TYPE)
+            {
+                m_n_query_points = neighbor_query->getNPointsOfType(qargs.query_point_type);
+            }
+            m_same_types = (qargs.point_type == qargs.query_point_type);
+        }
+    }
+
+    //! Mark a frame as accumulated after all of its bonds have been added.
+    /*! This also counts any bonds that were buffered for binning in batches.
+     */
+    void finishFrame()
+    {
+        if (m_parallel_frames)
+        {
+            return;
+        }
+        m_local_histograms.flush();
+        m_frame_counter++;
+        m_reduce = true;
+    }
+
     //! \internal
     // Wrapper to do accumulation.
     /*! \param neighbor_query NeighborQuery object to iterate over
@@ -105,20 +177,246 @@ public:
                            unsigned int n_query_points, const locality::NeighborList* nlist,
                            locality::QueryArgs qargs, Func cf)
     {
-        m_box = neighbor_query->getBox();
-        locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf);
-        m_frame_counter++;
-        m_n_points = neighbor_query->getNPoints();
-        m_n_query_points = n_query_points;
-        m_reduce = true;
+        util::profiling::ScopedTimer timer("BondHistogramCompute::accumulate");
+        startFrame(neighbor_query, n_query_points, (nlist == nullptr) ? qargs : locality::QueryArgs());
+        locality::loopOverNeighbors(neighbor_query, query_points, n_query_points, qargs, nlist, cf,
+                                    !m_parallel_frames);
+        finishFrame();
+    }
+
+    //! \internal
+    // Wrapper to do accumulation over blocks of bonds.
+    /*! This is a variant of accumulateGeneral for computes that accumulate
+        each block of bonds of the parallel loop through privatized storage,
+        such as a ThreadLocalHistogram::LocalBlock.
+        \param neighbor_query NeighborQuery object to iterate over
+        \param query_points Query points
+        \param n_query_points Number of query_points
+        \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query
+           appropriately with given qargs.
+        \param qargs Query arguments
+        \param make_block A function returning an object with operator()(NeighborBond) and finish().
+    */
+    template<typename BlockFactory>
+    void accumulateBlocks(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                          unsigned int n_query_points, const locality::NeighborList* nlist,
+                          locality::QueryArgs qargs, const BlockFactory& make_block)
+    {
+        util::profiling::ScopedTimer timer("BondHistogramCompute::accumulate");
+        startFrame(neighbor_query, n_query_points, (nlist == nullptr) ? qargs : locality::QueryArgs());
+        locality::loopOverNeighborBlocks(neighbor_query, query_points, n_query_points, qargs, nlist,
+                                         make_block, !m_parallel_frames);
+        finishFrame();
+    }
+
+    //! \internal
+    // Accumulate all frames of a trajectory, using the points of each frame as query points.
+    /*! By default, frames are accumulated one at a time in parallel over
+        their points, as by Trajectory::forEachFrame. If parallel_frames is
+        true, frames are instead accumulated concurrently, each by a single
+        thread with its own NeighborQuery. This saturates many threads even
+        for small systems, where parallelizing over the points of one frame
+        is dominated by the cost of scheduling tasks. The results are the
+        same in both cases, up to floating point rounding.
+        \param trajectory The frames to accumulate.
+        \param parallel_frames Whether to accumulate frames concurrently.
+        \param accumulate_frame A function with signature void(const NeighborQuery*, unsigned int frame)
+           that accumulates the bonds of a frame through accumulateGeneral or accumulateBlocks.
+    */
+    template<typename Func>
+    void accumulateFrames(const locality::Trajectory& trajectory, bool parallel_frames,
+                          const Func& accumulate_frame)
+    {
+        if (!parallel_frames)
+        {
+            trajectory.forEachFrame(accumulate_frame);
+            return;
+        }
+
+        // Per-frame bookkeeping is skipped while frames are accumulated
+        // concurrently, and the bonds buffered by each thread are binned once
+        // all frames are done.
+        m_parallel_frames = true;
+        try
+        {
+            util::forLoopWrapper(0, trajectory.getNFrames(), [&](size_t begin, size_t end) {
+                for (size_t frame = begin; frame < end; ++frame)
+                {
+                    std::unique_ptr<NeighborQuery> neighbor_query(trajectory.makeNeighborQuery(frame));
+                    accumulate_frame(neighbor_query.get(), frame);
+                }
+            });
+        }
+        catch (...)
+        {
+            m_parallel_frames = false;
+            throw;
+        }
+        m_parallel_frames = false;
+
+        if (trajectory.getNFrames() > 0)
+        {
+            // Normalize by the system of the last frame, as when frames are
+            // accumulated one at a time.
+            m_box = trajectory.getBox(trajectory.getNFrames() - 1);
+            m_n_points = trajectory.getNPoints();
+            m_n_query_points = trajectory.getNPoints();
+            m_same_types = true;
+            m_local_histograms.flush();
+            m_frame_counter += trajectory.getNFrames();
+            m_reduce = true;
+        }
+    }
+
+    //! Return the name identifying the class of the compute in serialized states.
+    virtual std::string getStateName() const = 0;
+
+    //! Serialize the accumulated state into a compact binary buffer.
+    /*! The state consists of the raw bin counts of all frames accumulated
+     *  since the last reset, the counters that normalize them (the number of
+     *  frames, and the box and numbers of points of the last frame), and the
+     *  raw sums of any other accumulated arrays. Points are not stored. The
+     *  bins are stored to check that states are only combined with
+     *  compatible computes.
+     */
+    std::string serialize()
+    {
+        util::BinaryWriter writer;
+        writer.write(uint32_t(STATE_MAGIC));
+        writer.write(uint32_t(STATE_VERSION));
+        writer.writeString(getStateName());
+        saveState(writer);
+        return writer.getData();
+    }
+
+    //! Restore or merge a state returned by serialize.
+    /*! \param data A state serialized by a compute of the same class with the same bins.
+     *  \param merge If true, add the state to the accumulated state, as if
+     *         the frames of both had been accumulated by this compute.
+     *         Otherwise, replace the accumulated state.
+     *
+     *  If the state is invalid, an invalid_argument is thrown and the
+     *  accumulated state is left unchanged.
+     */
+    void deserialize(const std::string& data, bool merge)
+    {
+        util::BinaryReader reader(data);
+        readStateHeader(reader);
+
+        // Partial states are rolled back from a copy of the current state.
+        const std::string previous = serialize();
+        try
+        {
+            if (!merge)
+            {
+                reset();
+            }
+            loadState(reader);
+            reader.finish();
+        }
+        catch (...)
+        {
+            reset();
+            util::BinaryReader previous_reader(previous);
+            readStateHeader(previous_reader);
+            loadState(previous_reader);
+            throw;
+        }
+    }
+
+    //! Add the accumulated state of another compute of the same class with the same bins.
+    void merge(BondHistogramCompute& other)
+    {
+        deserialize(other.serialize(), true);
     }
 
 protected:
+    //! Write the accumulated state after the header written by serialize.
+    /*! Subclasses with other accumulated arrays extend this and loadState,
+     *  writing their arrays after those of the parent.
+     */
+    virtual void saveState(util::BinaryWriter& writer)
+    {
+        const std::vector<size_t> sizes = getAxisSizes();
+        writer.writeArray(std::vector<uint64_t>(sizes.begin(), sizes.end()));
+        std::vector<float> bounds;
+        for (const auto& bound : getBounds())
+        {
+            bounds.push_back(bound.first);
+            bounds.push_back(bound.second);
+        }
+        writer.writeArray(bounds);
+
+        writer.write<uint32_t>(m_frame_counter);
+        writer.write<uint32_t>(m_n_points);
+        writer.write<uint32_t>(m_n_query_points);
+        writer.write<uint8_t>(m_same_types);
+        const float box_parameters[] = {m_box.getLx(),           m_box.getLy(),
+                                        m_box.getLz(),           m_box.getTiltFactorXY(),
+                                        m_box.getTiltFactorXZ(), m_box.getTiltFactorYZ()};
+        writer.writeArray(box_parameters, 6);
+        const uint8_t box_flags[] = {m_box.is2D(), m_box.getPeriodicX(), m_box.getPeriodicY(),
+                                     m_box.getPeriodicZ()};
+        writer.writeArray(box_flags, 4);
+
+        util::ManagedArray<unsigned int> bin_counts(m_histogram.shape());
+        m_local_histograms.reduceInto(bin_counts);
+        writer.writeArray(bin_counts.get(), bin_counts.size());
+    }
+
+    //! Add the accumulated state written by saveState to the accumulated state.
+    /*! The system of the state replaces the current one if the state has
+     *  frames, so that merged states are normalized by the system of the last
+     *  merged frame, as when frames are accumulated one at a time.
+     */
+    virtual void loadState(util::BinaryReader& reader)
+    {
+        const std::vector<size_t> sizes = getAxisSizes();
+        std::vector<float> bounds;
+        for (const auto& bound : getBounds())
+        {
+            bounds.push_back(bound.first);
+            bounds.push_back(bound.second);
+        }
+        if (reader.readArray<uint64_t>() != std::vector<uint64_t>(sizes.begin(), sizes.end())
+            || reader.readArray<float>() != bounds)
+        {
+            throw std::invalid_argument("The serialized state has different bins than this compute.");
+        }
+
+        const unsigned int frame_counter = reader.read<uint32_t>();
+        const unsigned int n_points = reader.read<uint32_t>();
+        const unsigned int n_query_points = reader.read<uint32_t>();
+        const bool same_types = reader.read<uint8_t>() != 0;
+        float box_parameters[6];
+        reader.readArray(box_parameters, 6);
+        uint8_t box_flags[4];
+        reader.readArray(box_flags, 4);
+        util::ManagedArray<unsigned int> bin_counts(m_histogram.shape());
+        reader.readArray(bin_counts.get(), bin_counts.size());
+
+        m_local_histograms.add(bin_counts.get());
+        m_frame_counter += frame_counter;
+        if (frame_counter > 0)
+        {
+            m_box = box::Box(box_parameters[0], box_parameters[1], box_parameters[2], box_parameters[3],
+                             box_parameters[4], box_parameters[5], box_flags[0] != 0);
+            m_box.setPeriodic(box_flags[1] != 0, box_flags[2] != 0, box_flags[3] != 0);
+            m_n_points = n_points;
+            m_n_query_points = n_query_points;
+            m_same_types = same_types;
+        }
+        m_reduce = true;
+    }
+
     box::Box m_box;
-    unsigned int m_frame_counter;  //!< Number of frames calculated.
-    unsigned int m_n_points;       //!< The number of points.
-    unsigned int m_n_query_points; //!< The number of query points.
-    bool m_reduce;                 //!< Whether or not the histogram needs to be reduced.
+    unsigned int m_frame_counter;          //!< Number of frames calculated.
+    unsigned int m_n_points;               //!< The number of points.
+    unsigned int m_n_query_points;         //!< The number of query points.
+    bool m_same_types;                     //!< Whether points and query points have the same types.
+    bool m_reduce;                         //!< Whether or not the histogram needs to be reduced.
+    util::AccumulationStrategy m_strategy; //!< How bonds are accumulated in parallel.
+    bool m_parallel_frames;                //!< Whether frames are being accumulated concurrently.
 
     util::Histogram<unsigned int> m_histogram; //!< Histogram of interparticle distances (bond lengths).
     util::Histogram<unsigned int>::ThreadLocalHistogram
@@ -126,6 +424,33 @@ protected:
 
     typedef util::Histogram<unsigned int> BondHistogram;
     typedef typename BondHistogram::Axes BHAxes;
+
+private:
+    static const uint32_t STATE_MAGIC = 0x66726564; //!< First value of serialized states.
+    static const uint32_t STATE_VERSION = 2;        //!< Version of the layout of serialized states.
+
+    //! Read and check the header written by serialize.
+    void readStateHeader(util::BinaryReader& reader) const
+    {
+        const uint32_t magic = reader.read<uint32_t>();
+        if (magic == ((STATE_MAGIC >> 24) | ((STATE_MAGIC >> 8) & 0xff00) | ((STATE_MAGIC << 8) & 0xff0000)
+                      | (STATE_MAGIC << 24)))
+        {
+            throw std::invalid_argument("The state was serialized on a machine with a different byte order.");
+        }
+        if (magic != STATE_MAGIC)
+        {
+            throw std::invalid_argument("The data is not a serialized state of a freud compute.");
+        }
+        if (reader.read<uint32_t>() != STATE_VERSION)
+        {
+            throw std::invalid_argument("The state was serialized by an incompatible version of freud.");
+        }
+        if (reader.readString() != getStateName())
+        {
+            throw std::invalid_argument("The state was serialized by a different class of compute.");
+        }
+    }
 };
 
 }; }; // namespace freud::locality
@@ -0,0 +1,205 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+
+#include "CompressedNeighborList.h"
+#include "utils.h"
+
+/*! \file CompressedNeighborList.cc
+    \brief Compact storage of the bonds of NeighborLists.
+*/
+
+namespace freud { namespace locality {
+
+namespace {
+
+//! Zigzag encode the difference between two indices, so that small differences of either sign are small.
+inline uint64_t zigzagDelta(unsigned int index, int64_t previous)
+{
+    const int64_t delta = int64_t(index) - previous;
+    return (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+}
+
+//! Number of bytes of the LEB128 encoding of a value.
+inline size_t encodedSize(uint64_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80)
+    {
+        value >>= 7;
+        ++size;
+    }
+    return size;
+}
+
+//! Largest value of the quantized distances.
+const float QUANTIZED_DISTANCE_MAX = float(std::numeric_limits<uint16_t>::max());
+
+}; // end anonymous namespace
+
+CompressedNeighborList::CompressedNeighborList()
+    : m_num_query_points(0), m_num_points(0), m_half(false), m_distance_storage(distances_full),
+      m_segments(1, 0), m_byte_offsets(1, 0), m_distance_scale(0), m_uniform_weight(1)
+{}
+
+CompressedNeighborList::CompressedNeighborList(const NeighborList& nlist, DistanceStorage distance_storage)
+    : m_num_query_points(nlist.getNumQueryPoints()), m_num_points(nlist.getNumPoints()),
+      m_half(nlist.isHalf()), m_distance_storage(distance_storage), m_segments(m_num_query_points + 1, 0),
+      m_byte_offsets(m_num_query_points + 1, 0), m_distance_scale(0), m_uniform_weight(1)
+{
+    const size_t num_bonds = nlist.getNumBonds();
+    const unsigned int* counts = nlist.getCounts().get();
+    for (unsigned int i = 0; i < m_num_query_points; ++i)
+    {
+        m_segments[i + 1] = m_segments[i] + counts[i];
+    }
+    // The bonds are sorted by query point exactly when the bonds of each
+    // query point form one run, in order, so that the counts add up to the
+    // number of bonds and each run starts after the previous one.
+    const size_t* segments = nlist.getSegments().get();
+    bool sorted = (m_segments[m_num_query_points] == num_bonds);
+    for (unsigned int i = 0; sorted && i < m_num_query_points; ++i)
+    {
+        sorted = (counts[i] == 0 || segments[i] == m_segments[i]);
+    }
+    if (!sorted)
+    {
+        throw std::invalid_argument(
+            "The bonds of a compressed NeighborList must be sorted by query point index.");
+    }
+
+    const unsigned int* point_indices = nlist.getPointIndices().get();
+    const float* distances = nlist.getDistances().get();
+    const float* weights = nlist.getWeights().get();
+    if (num_bonds > 0)
+    {
+        m_uniform_weight = weights[0];
+    }
+
+    // Measure the encoded point indices of each query point, the largest
+    // distance, and whether all weights are equal.
+    std::vector<size_t> num_bytes(m_num_query_points, 0);
+    tbb::enumerable_thread_specific<float> max_distances(0.0f);
+    tbb::enumerable_thread_specific<char> uniform_weights(true);
+    util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
+        float& max_distance = max_distances.local();
+        char& uniform = uniform_weights.local();
+        for (size_t i = begin; i < end; ++i)
+        {
+            int64_t previous = static_cast<int64_t>(i);
+            size_t size = 0;
+            for (size_t bond = m_segments[i]; bond < m_segments[i + 1]; ++bond)
+            {
+                size += encodedSize(zigzagDelta(point_indices[bond], previous));
+                previous = point_indices[bond];
+                max_distance = std::max(max_distance, distances[bond]);
+                uniform = uniform && (weights[bond] == m_uniform_weight);
+            }
+            num_bytes[i] = size;
+        }
+    });
+    const float max_distance = max_distances.combine([](float a, float b) { return std::max(a, b); });
+    const bool uniform = uniform_weights.combine([](char a, char b) { return char(a && b); }) != 0;
+    for (unsigned int i = 0; i < m_num_query_points; ++i)
+    {
+        m_byte_offsets[i + 1] = m_byte_offsets[i] + num_bytes[i];
+    }
+
+    m_point_deltas.resize(m_byte_offsets[m_num_query_points]);
+    if (m_distance_storage == distances_full)
+    {
+        m_distances.assign(distances, distances + num_bonds);
+    }
+    else if (m_distance_storage == distances_quantized)
+    {
+        m_quantized_distances.resize(num_bonds);
+        m_distance_scale = max_distance / QUANTIZED_DISTANCE_MAX;
+    }
+    if (!uniform)
+    {
+        m_weights.assign(weights, weights + num_bonds);
+    }
+
+    util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            uint8_t* data = m_point_deltas.data() + m_byte_offsets[i];
+            int64_t previous = static_cast<int64_t>(i);
+            for (size_t bond = m_segments[i]; bond < m_segments[i + 1]; ++bond)
+            {
+                uint64_t value = zigzagDelta(point_indices[bond], previous);
+                previous = point_indices[bond];
+                while (value >= 0x80)
+                {
+                    *data++ = static_cast<uint8_t>(value | 0x80);
+                    value >>= 7;
+                }
+                *data++ = static_cast<uint8_t>(value);
+
+                if (m_distance_storage == distances_quantized)
+                {
+                    const float units = (m_distance_scale > 0) ? distances[bond] / m_distance_scale : 0;
+                    m_quantized_distances[bond]
+                        = static_cast<uint16_t>(std::min(std::round(units), QUANTIZED_DISTANCE_MAX));
+                }
+            }
+        }
+    });
+}
+
+size_t CompressedNeighborList::getNumBytes() const
+{
+    return (m_segments.size() + m_byte_offsets.size()) * sizeof(size_t) + m_point_deltas.size()
+        + (m_distances.size() + m_weights.size()) * sizeof(float)
+        + m_quantized_distances.size() * sizeof(uint16_t);
+}
+
+void CompressedNeighborList::validate(const NeighborQuery* nq, unsigned int num_query_points) const
+{
+    if (num_query_points != m_num_query_points || (nq != nullptr && nq->getNPoints() != m_num_points))
+    {
+        throw std::invalid_argument(
+            "The numbers of points and query points must match those of the compressed NeighborList.");
+    }
+    if (nq == nullptr && m_distance_storage == distances_none)
+    {
+        throw std::invalid_argument(
+            "The points are required to decompress a NeighborList that does not store distances.");
+    }
+}
+
+NeighborList* CompressedNeighborList::toNeighborList(const NeighborQuery* nq,
+                                                     const vec3<float>* query_points) const
+{
+    validate(nq, m_num_query_points);
+    NeighborList* nl = new NeighborList();
+    nl->setNumBonds(getNumBonds(), m_num_query_points, m_num_points);
+    nl->setHasVectors(nq != nullptr);
+    nl->setHalf(m_half);
+    util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            size_t bond = m_segments[i];
+            forEachBond(static_cast<unsigned int>(i), nq, query_points, [&](const NeighborBond& nb) {
+                nl->getQueryPointIndices()[bond] = nb.query_point_idx;
+                nl->getPointIndices()[bond] = nb.point_idx;
+                nl->getDistances()[bond] = nb.distance;
+                nl->getWeights()[bond] = nb.weight;
+                if (nq != nullptr)
+                {
+                    nl->getVectors()[bond] = nb.vector;
+                }
+                ++bond;
+            });
+        }
+    });
+    nl->updateSegmentCounts();
+    return nl;
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,182 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef COMPRESSED_NEIGHBOR_LIST_H
+#define COMPRESSED_NEIGHBOR_LIST_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "NeighborBond.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file CompressedNeighborList.h
+    \brief Compact storage of the bonds of NeighborLists.
+*/
+
+namespace freud { namespace locality {
+
+//! Store the bonds of a NeighborList in a compressed form.
+/*! A NeighborList stores 16 bytes per bond. A CompressedNeighborList stores:
+ *
+ *  - no query point indices, which are implicit from the segment of the
+ *    bonds of each query point,
+ *  - the point indices as variable length (LEB128) zigzag encoded
+ *    differences from the previous point index of the segment, or from the
+ *    query point index for the first bond, which are one or two bytes for
+ *    lists sorted by point index,
+ *  - the distances as floats, as 16-bit fractions of the largest distance,
+ *    or not at all, in which case they are recomputed from the points when
+ *    the bonds are decompressed,
+ *  - the weights only if they are not all equal.
+ *
+ *  Bond vectors are not stored, and are recomputed from the points when
+ *  they are needed. The bonds of each query point can be decompressed
+ *  independently with forEachBond, so that loops over the bonds (see
+ *  loopOverNeighbors) decompress the query points in parallel while
+ *  streaming over the compressed data.
+ */
+class CompressedNeighborList
+{
+public:
+    //! How the distances of the bonds are stored.
+    enum DistanceStorage
+    {
+        distances_full,      //!< Store the distances.
+        distances_quantized, //!< Store the distances rounded to 16-bit fractions of the largest distance.
+        distances_none       //!< Recompute the distances from the points.
+    };
+
+    //! Create an empty CompressedNeighborList.
+    CompressedNeighborList();
+
+    //! Compress the bonds of a NeighborList.
+    /*! \param nlist The NeighborList, whose bonds must be sorted by query point index.
+     *  \param distance_storage How to store the distances.
+     */
+    explicit CompressedNeighborList(const NeighborList& nlist,
+                                    DistanceStorage distance_storage = distances_full);
+
+    //! Return the number of bonds.
+    size_t getNumBonds() const
+    {
+        return m_segments.back();
+    }
+
+    //! Return the number of query points.
+    unsigned int getNumQueryPoints() const
+    {
+        return m_num_query_points;
+    }
+
+    //! Return the number of points.
+    unsigned int getNumPoints() const
+    {
+        return m_num_points;
+    }
+
+    //! Return whether this is a half list (see NeighborList::isHalf).
+    bool isHalf() const
+    {
+        return m_half;
+    }
+
+    //! Return how the distances are stored.
+    DistanceStorage getDistanceStorage() const
+    {
+        return m_distance_storage;
+    }
+
+    //! Return the number of bonds of a query point.
+    unsigned int getCount(unsigned int query_point_idx) const
+    {
+        return static_cast<unsigned int>(m_segments[query_point_idx + 1] - m_segments[query_point_idx]);
+    }
+
+    //! Return the number of bytes used to store the bonds.
+    size_t getNumBytes() const;
+
+    //! Call a visitor on every bond of a query point, in the order of the NeighborList.
+    /*! \param query_point_idx Index of the query point.
+     *  \param nq NeighborQuery of the points, used to compute bond vectors and
+     *         distances that are not stored. May be NULL unless the distances
+     *         are not stored.
+     *  \param query_points The query points, used with nq.
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void forEachBond(unsigned int query_point_idx, const NeighborQuery* nq, const vec3<float>* query_points,
+                     const Visitor& visitor) const
+    {
+        const uint8_t* data = m_point_deltas.data() + m_byte_offsets[query_point_idx];
+        int64_t point_idx = query_point_idx;
+        for (size_t bond = m_segments[query_point_idx]; bond < m_segments[query_point_idx + 1]; ++bond)
+        {
+            uint64_t zigzag = 0;
+            for (unsigned int shift = 0;; shift += 7)
+            {
+                const uint8_t byte = *data++;
+                zigzag |= uint64_t(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    break;
+                }
+            }
+            point_idx += static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+
+            NeighborBond nb(query_point_idx, static_cast<unsigned int>(point_idx), 0,
+                            m_weights.empty() ? m_uniform_weight : m_weights[bond]);
+            if (nq != nullptr)
+            {
+                nb.vector = nq->getBox().wrap((*nq)[nb.point_idx] - query_points[query_point_idx]);
+            }
+            if (m_distance_storage == distances_full)
+            {
+                nb.distance = m_distances[bond];
+            }
+            else if (m_distance_storage == distances_quantized)
+            {
+                nb.distance = float(m_quantized_distances[bond]) * m_distance_scale;
+            }
+            else
+            {
+                nb.distance = std::sqrt(dot(nb.vector, nb.vector));
+            }
+            visitor(nb);
+        }
+    }
+
+    //! Decompress the bonds into a new NeighborList, with bond vectors if nq is not NULL.
+    /*! The caller is responsible for deleting the returned NeighborList.
+     *
+     *  \param nq NeighborQuery of the points, required if the distances are not stored.
+     *  \param query_points The query points, used with nq.
+     */
+    NeighborList* toNeighborList(const NeighborQuery* nq = nullptr,
+                                 const vec3<float>* query_points = nullptr) const;
+
+    //! Throw an invalid_argument if the bonds cannot be decompressed for these points.
+    void validate(const NeighborQuery* nq, unsigned int num_query_points) const;
+
+private:
+    unsigned int m_num_query_points;             //!< Number of query points.
+    unsigned int m_num_points;                   //!< Number of points.
+    bool m_half;                                 //!< Whether each pair of points is stored once.
+    DistanceStorage m_distance_storage;          //!< How the distances are stored.
+    std::vector<size_t> m_segments;              //!< First bond of each query point, and the number of bonds.
+    std::vector<size_t> m_byte_offsets;          //!< First byte of the point indices of each query point.
+    std::vector<uint8_t> m_point_deltas;         //!< Encoded differences of the point indices.
+    std::vector<float> m_distances;              //!< Distances, if stored in full.
+    std::vector<uint16_t> m_quantized_distances; //!< Distances in units of m_distance_scale, if quantized.
+    float m_distance_scale;                      //!< Distance of one unit of the quantized distances.
+    std::vector<float> m_weights;                //!< Weights, empty if they are all equal.
+    float m_uniform_weight;                      //!< Weight of every bond, if they are all equal.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // COMPRESSED_NEIGHBOR_LIST_H
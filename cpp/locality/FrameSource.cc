@@ -0,0 +1,292 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <ios>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FrameSource.h"
+
+/*! \file FrameSource.cc
+    \brief Sources of the frames of trajectories read from files.
+*/
+
+namespace freud { namespace locality {
+
+MappedFile::MappedFile(const std::string& filename) : m_data(nullptr), m_size(0), m_mapped(false)
+{
+#ifndef _WIN32
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::ios_base::failure("Could not open " + filename + ".");
+    }
+    struct stat status;
+    if (fstat(fd, &status) == 0 && status.st_size > 0)
+    {
+        m_size = static_cast<size_t>(status.st_size);
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            m_data = static_cast<const char*>(data);
+            m_mapped = true;
+        }
+    }
+    close(fd);
+    if (m_mapped)
+    {
+        return;
+    }
+#endif
+    // Read files that cannot be mapped into a buffer.
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        throw std::ios_base::failure("Could not open " + filename + ".");
+    }
+    m_buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(m_buffer.data(), m_buffer.size());
+    if (!file)
+    {
+        throw std::ios_base::failure("Could not read " + filename + ".");
+    }
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (m_mapped)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+#endif
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const
+{
+#ifndef _WIN32
+    if (!m_mapped || offset >= m_size)
+    {
+        return;
+    }
+    // The advice must start at a page boundary.
+    const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = offset - offset % page_size;
+    const size_t end = std::min(offset + length, m_size);
+    posix_madvise(const_cast<char*>(m_data) + begin, end - begin, POSIX_MADV_WILLNEED);
+#endif
+}
+
+namespace {
+
+//! Header of GSD files.
+struct GSDHeader
+{
+    uint64_t magic;
+    uint64_t index_location;
+    uint64_t index_allocated_entries;
+    uint64_t namelist_location;
+    uint64_t namelist_allocated_entries;
+    uint32_t schema_version;
+    uint32_t gsd_version;
+    char application[64];
+    char schema[64];
+    char reserved[80];
+};
+
+//! Entry of the index of the chunks of GSD files.
+struct GSDIndexEntry
+{
+    uint64_t frame;
+    uint64_t N;
+    int64_t location;
+    uint32_t M;
+    uint16_t id;
+    uint8_t type;
+    uint8_t flags;
+};
+
+//! Magic number at the start of GSD files.
+const uint64_t GSD_MAGIC = 0x65DF65DF65DF65DF;
+const size_t GSD_NAME_SIZE = 64;        //!< Size of the names of chunks in version 1 files.
+const uint8_t GSD_TYPE_UINT8 = 1;       //!< Type id of unsigned 8-bit integers.
+const uint8_t GSD_TYPE_FLOAT = 9;       //!< Type id of 32-bit floats.
+const uint64_t NO_CHUNK = ~uint64_t(0); //!< Offset of chunks missing from a frame.
+
+}; // end anonymous namespace
+
+GSDFrameSource::GSDFrameSource(const std::string& filename)
+    : m_file(filename), m_n_points(0), m_is2D(false)
+{
+    const char* data = m_file.data();
+    const size_t size = m_file.size();
+    GSDHeader header;
+    if (size < sizeof(header))
+    {
+        throw std::invalid_argument(filename + " is not a GSD file.");
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != GSD_MAGIC)
+    {
+        throw std::invalid_argument(filename + " is not a GSD file.");
+    }
+    // Version 1 files store names in fixed size entries, while later versions
+    // pack null-terminated names into a buffer of the allocated size.
+    const bool fixed_names = (header.gsd_version >> 16) < 2;
+    const uint64_t namelist_size = header.namelist_allocated_entries * (fixed_names ? GSD_NAME_SIZE : 1);
+    if ((header.gsd_version >> 16) > 2 || header.index_location > size
+        || header.index_allocated_entries > (size - header.index_location) / sizeof(GSDIndexEntry)
+        || header.namelist_location > size || namelist_size > size - header.namelist_location)
+    {
+        throw std::invalid_argument(filename + " is not a supported GSD file.");
+    }
+
+    // Find the ids of the chunks of the HOOMD schema that are used.
+    int position_id = -1;
+    int box_id = -1;
+    int dimensions_id = -1;
+    const char* names = data + header.namelist_location;
+    uint64_t name_offset = 0;
+    for (int id = 0; name_offset < namelist_size; ++id)
+    {
+        const char* name = names + name_offset;
+        const size_t max_length = fixed_names ? GSD_NAME_SIZE : namelist_size - name_offset;
+        const std::string entry(name, strnlen(name, max_length));
+        if (entry.empty())
+        {
+            break;
+        }
+        name_offset += fixed_names ? GSD_NAME_SIZE : entry.size() + 1;
+        if (entry == "particles/position")
+        {
+            position_id = id;
+        }
+        else if (entry == "configuration/box")
+        {
+            box_id = id;
+        }
+        else if (entry == "configuration/dimensions")
+        {
+            dimensions_id = id;
+        }
+    }
+    if (position_id < 0 || box_id < 0)
+    {
+        throw std::invalid_argument(filename + " has no particles/position or configuration/box chunks.");
+    }
+
+    uint8_t dimensions = 3;
+    std::vector<uint64_t> box_offsets;
+    std::vector<uint64_t> point_counts;
+    for (uint64_t i = 0; i < header.index_allocated_entries; ++i)
+    {
+        GSDIndexEntry entry;
+        std::memcpy(&entry, data + header.index_location + i * sizeof(entry), sizeof(entry));
+        // Unused entries are zero.
+        if (entry.location <= 0
+            || (entry.id != position_id && entry.id != box_id && entry.id != dimensions_id))
+        {
+            continue;
+        }
+        const uint64_t location = static_cast<uint64_t>(entry.location);
+        const uint64_t type_size = (entry.type == GSD_TYPE_UINT8) ? 1 : 4;
+        if ((entry.type != GSD_TYPE_UINT8 && entry.type != GSD_TYPE_FLOAT) || location > size
+            || entry.N * entry.M > (size - location) / type_size)
+        {
+            throw std::invalid_argument(filename + " has corrupt or unsupported chunks.");
+        }
+        if (entry.frame >= m_offsets.size())
+        {
+            m_offsets.resize(entry.frame + 1, NO_CHUNK);
+            point_counts.resize(entry.frame + 1, 0);
+            box_offsets.resize(entry.frame + 1, NO_CHUNK);
+        }
+
+        if (entry.id == position_id)
+        {
+            if (entry.type != GSD_TYPE_FLOAT || entry.M != 3)
+            {
+                throw std::invalid_argument("The particles/position chunks of " + filename
+                                            + " must contain 32-bit floats.");
+            }
+            m_offsets[entry.frame] = location;
+            point_counts[entry.frame] = entry.N;
+        }
+        else if (entry.id == box_id)
+        {
+            if (entry.type != GSD_TYPE_FLOAT || entry.N * entry.M != 6)
+            {
+                throw std::invalid_argument("The configuration/box chunks of " + filename
+                                            + " must contain 6 32-bit floats.");
+            }
+            box_offsets[entry.frame] = location;
+        }
+        else if (entry.frame == 0 && entry.type == GSD_TYPE_UINT8 && entry.N * entry.M == 1)
+        {
+            dimensions = static_cast<uint8_t>(data[location]);
+        }
+    }
+    if (m_offsets.empty() || m_offsets[0] == NO_CHUNK || box_offsets[0] == NO_CHUNK)
+    {
+        throw std::invalid_argument("The first frame of " + filename
+                                    + " has no particles/position or configuration/box chunks.");
+    }
+    m_n_points = static_cast<unsigned int>(point_counts[0]);
+    m_is2D = (dimensions == 2);
+
+    // Chunks missing from a frame take the value of the first frame.
+    const size_t n_frames = m_offsets.size();
+    m_box_params.resize(6 * n_frames);
+    for (size_t frame = 0; frame < n_frames; ++frame)
+    {
+        if (m_offsets[frame] == NO_CHUNK)
+        {
+            m_offsets[frame] = m_offsets[0];
+        }
+        else if (point_counts[frame] != m_n_points)
+        {
+            throw std::invalid_argument("Every frame of " + filename
+                                        + " must have the same number of particles.");
+        }
+        const uint64_t box_offset = box_offsets[(box_offsets[frame] == NO_CHUNK) ? 0 : frame];
+        std::memcpy(&m_box_params[6 * frame], data + box_offset, 6 * sizeof(float));
+    }
+
+    // GSD does not align chunks, so the positions of frames stored after
+    // chunks of bytes may not be aligned to floats. These are copied.
+    m_points.resize(n_frames);
+    for (size_t frame = 0; frame < n_frames; ++frame)
+    {
+        const char* points = data + m_offsets[frame];
+        if (m_offsets[frame] % alignof(float) != 0)
+        {
+            m_copies.emplace_back(m_n_points);
+            std::memcpy(static_cast<void*>(m_copies.back().data()), points,
+                        size_t(m_n_points) * sizeof(vec3<float>));
+            points = reinterpret_cast<const char*>(m_copies.back().data());
+        }
+        m_points[frame] = reinterpret_cast<const vec3<float>*>(points);
+    }
+}
+
+void GSDFrameSource::prefetch(unsigned int frame) const
+{
+    if (frame < getNFrames())
+    {
+        m_file.prefetch(m_offsets[frame], size_t(m_n_points) * sizeof(vec3<float>));
+    }
+}
+
+}; }; // end namespace freud::locality
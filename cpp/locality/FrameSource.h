@@ -0,0 +1,148 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef FRAME_SOURCE_H
+#define FRAME_SOURCE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Box.h"
+#include "VectorMath.h"
+
+/*! \file FrameSource.h
+    \brief Sources of the frames of trajectories read from files.
+*/
+
+namespace freud { namespace locality {
+
+//! Read-only view of a whole file in memory.
+/*! The file is mapped into memory where supported, so that its pages are only
+ *  read from disk when they are accessed, and otherwise read into a buffer.
+ */
+class MappedFile
+{
+public:
+    //! Map a file.
+    /*! \param filename Path of the file.
+     */
+    explicit MappedFile(const std::string& filename);
+
+    //! Unmap the file.
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    //! Get the contents of the file.
+    const char* data() const
+    {
+        return m_data;
+    }
+
+    //! Get the size of the file in bytes.
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    //! Ask the operating system to read a range of the file ahead of its use.
+    /*! \param offset First byte of the range.
+     *  \param length Number of bytes of the range.
+     */
+    void prefetch(size_t offset, size_t length) const;
+
+private:
+    const char* m_data;         //!< Contents of the file.
+    size_t m_size;              //!< Size of the file in bytes.
+    bool m_mapped;              //!< Whether the contents are mapped, rather than buffered.
+    std::vector<char> m_buffer; //!< Contents of the file, if it could not be mapped.
+};
+
+//! Frames of points in periodic boxes, stored outside of freud.
+/*! Sources give views of the points and box parameters of each frame, which
+ *  remain valid as long as the source exists, so that computes read the
+ *  frames without copying them. Every frame has the same number of points.
+ */
+class FrameSource
+{
+public:
+    //! Destructor
+    virtual ~FrameSource() {}
+
+    //! Get the number of frames.
+    virtual unsigned int getNFrames() const = 0;
+
+    //! Get the number of points in each frame.
+    virtual unsigned int getNPoints() const = 0;
+
+    //! Get whether the boxes are two-dimensional.
+    virtual bool is2D() const = 0;
+
+    //! Get the points of a frame.
+    virtual const vec3<float>* getPoints(unsigned int frame) const = 0;
+
+    //! Get the box parameters (Lx, Ly, Lz, xy, xz, yz) of a frame.
+    virtual const float* getBoxParams(unsigned int frame) const = 0;
+
+    //! Start reading a frame in the background, ahead of its use.
+    virtual void prefetch(unsigned int frame) const {}
+};
+
+//! Frames of a HOOMD-blue GSD file.
+/*! The file is mapped into memory, and the points of each frame are views of
+ *  its particles/position chunk, so frames are not copied unless their chunk
+ *  is not aligned to floats. As in the HOOMD schema, frames without a
+ *  particles/position or configuration/box chunk use the chunk of the first
+ *  frame. The positions must be 32-bit floats, and every frame must have the
+ *  same number of particles.
+ */
+class GSDFrameSource : public FrameSource
+{
+public:
+    //! Open a GSD file.
+    /*! \param filename Path of the file.
+     */
+    explicit GSDFrameSource(const std::string& filename);
+
+    virtual unsigned int getNFrames() const
+    {
+        return static_cast<unsigned int>(m_points.size());
+    }
+
+    virtual unsigned int getNPoints() const
+    {
+        return m_n_points;
+    }
+
+    virtual bool is2D() const
+    {
+        return m_is2D;
+    }
+
+    virtual const vec3<float>* getPoints(unsigned int frame) const
+    {
+        return m_points[frame];
+    }
+
+    virtual const float* getBoxParams(unsigned int frame) const
+    {
+        return &m_box_params[6 * size_t(frame)];
+    }
+
+    virtual void prefetch(unsigned int frame) const;
+
+private:
+    MappedFile m_file;                              //!< Contents of the file.
+    std::vector<uint64_t> m_offsets;                //!< Offset of the positions of each frame.
+    std::vector<const vec3<float>*> m_points;       //!< Positions of each frame.
+    std::vector<std::vector<vec3<float>>> m_copies; //!< Copies of the positions that are not aligned.
+    std::vector<float> m_box_params;                //!< Box parameters of each frame.
+    unsigned int m_n_points;                        //!< Number of points in each frame.
+    bool m_is2D;                                    //!< Whether the boxes are two-dimensional.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // FRAME_SOURCE_H
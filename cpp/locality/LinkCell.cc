@@ -2,10 +2,13 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
 #include <stdexcept>
 
 #include "LinkCell.h"
+#include "NearestNeighborHeap.h"
 
 /*! \file LinkCell.cc
     \brief Build a cell list from a set of points.
@@ -202,10 +205,14 @@ void IteratorCellShell::reset(unsigned int range)
  ********************/
 
 // Default constructor
-LinkCell::LinkCell() : NeighborQuery(), m_n_points(0), m_cell_width(0), m_celldim(0, 0, 0) {}
-
-LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width)
-    : NeighborQuery(box, points, n_points), m_n_points(0), m_cell_width(cell_width), m_celldim(0, 0, 0)
+LinkCell::LinkCell()
+    : NeighborQuery(), m_n_points(0), m_cell_width(0), m_celldim(0, 0, 0), m_copy_points(true)
+{}
+
+LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width,
+                   bool copy_points, bool spatial_sort)
+    : NeighborQuery(box, points, n_points), m_n_points(0), m_cell_width(cell_width), m_celldim(0, 0, 0),
+      m_copy_points(copy_points)
 {
     // If no cell width is provided, we calculate the system density and
     // estimate the number of cells that would lead to 10 particles per cell.
@@ -241,7 +248,15 @@ LinkCell::LinkCell(const box::Box& box, const vec3<float>* points, unsigned int
         throw std::runtime_error("At least one cell must be present.");
     }
 
+    util::profiling::ScopedTimer timer("LinkCell::build");
     computeCellList(points, n_points);
+
+    // The cell list is already stored in cell order, which is spatially
+    // local, so sorting only determines the traversal order of query points.
+    if (spatial_sort)
+    {
+        computeSpatialOrder();
+    }
 }
 
 unsigned int LinkCell::getCellIndex(const vec3<int> cellCoord) const
@@ -297,21 +312,95 @@ void LinkCell::computeCellList(const vec3<float>* points, unsigned int n_points)
     // determine the number of cells and allocate memory
     unsigned int Nc = getNumCells();
     m_cell_list.prepare(n_points + Nc);
+    m_cell_start.prepare(Nc + 1);
+    m_cell_points.prepare(n_points);
     m_n_points = n_points;
     m_Nc = Nc;
 
-    // initialize memory
-    for (unsigned int cell = 0; cell < Nc; cell++)
+    // The cell list is built with a parallel counting sort: compute the cell
+    // of every point, histogram the number of points per cell, prefix sum the
+    // counts into cell offsets, and scatter the point indices.
+    std::vector<unsigned int> point_cells(n_points);
+    std::unique_ptr<std::atomic<unsigned int>[]> cell_counts(new std::atomic<unsigned int>[Nc]);
+    util::forLoopWrapper(0, Nc, [&](size_t begin, size_t end) {
+        for (size_t cell = begin; cell < end; ++cell)
+        {
+            cell_counts[cell] = 0;
+        }
+    });
+
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            point_cells[i] = getCell(points[i]);
+            cell_counts[point_cells[i]].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // The prefix sum is cheap relative to the other passes since there are
+    // far fewer cells than points.
+    m_cell_start[0] = 0;
+    for (unsigned int cell = 0; cell < Nc; ++cell)
+    {
+        m_cell_start[cell + 1] = m_cell_start[cell] + cell_counts[cell];
+        cell_counts[cell] = m_cell_start[cell];
+    }
+
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_cell_points[cell_counts[point_cells[i]].fetch_add(1, std::memory_order_relaxed)] = i;
+        }
+    });
+
+    // The scatter order within a cell depends on thread scheduling, so we
+    // sort each cell to make the output deterministic. Each cell then lists
+    // its points in increasing order, which we also use to build the linked
+    // list so that it matches the order of a serial construction.
+    util::forLoopWrapper(0, Nc, [&](size_t begin, size_t end) {
+        unsigned int* cell_points = m_cell_points.get();
+        for (size_t cell = begin; cell < end; ++cell)
+        {
+            const unsigned int cell_begin = m_cell_start[cell];
+            const unsigned int cell_end = m_cell_start[cell + 1];
+            std::sort(cell_points + cell_begin, cell_points + cell_end);
+
+            unsigned int* link = &m_cell_list[n_points + cell];
+            for (unsigned int k = cell_begin; k < cell_end; ++k)
+            {
+                *link = cell_points[k];
+                link = &m_cell_list[cell_points[k]];
+            }
+            *link = LINK_CELL_TERMINATOR;
+        }
+    });
+
+    // Copy the points in cell order so that searching a cell reads
+    // contiguous memory.
+    if (m_copy_points)
+    {
+        m_cell_ordered_points.prepare(n_points);
+        util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k)
+            {
+                m_cell_ordered_points[k] = points[m_cell_points[k]];
+            }
+        });
+    }
+    else
     {
-        m_cell_list[n_points + cell] = LINK_CELL_TERMINATOR;
+        m_cell_ordered_points.prepare(0);
     }
+}
 
-    // generate the cell list
-    for (int i = n_points - 1; i >= 0; i--)
+void LinkCell::update(const vec3<float>* points)
+{
+    validatePoints(points);
+    m_points = points;
+    computeCellList(m_points, m_n_points);
+    if (hasPointTypes())
     {
-        unsigned int cell = getCell(points[i]);
-        m_cell_list[i] = m_cell_list[n_points + cell];
-        m_cell_list[n_points + cell] = i;
+        updateTypeQueries();
     }
 }
 
@@ -458,7 +547,7 @@ LinkCell::querySingle(const vec3<float> query_point, unsigned int query_point_id
     if (args.mode == QueryArgs::ball)
     {
         return std::make_shared<LinkCellQueryBallIterator>(this, query_point, query_point_idx, args.r_max,
-                                                           args.r_min, args.exclude_ii);
+                                                           args.r_min, args.exclude_ii, args.half);
     }
     else if (args.mode == QueryArgs::nearest)
     {
@@ -471,6 +560,245 @@ LinkCell::querySingle(const vec3<float> query_point, unsigned int query_point_id
     }
 }
 
+LinkCell::BallStencil LinkCell::computeBallStencil(float r_max) const
+{
+    // The ball iterator searches every shell whose closest point of approach
+    // is within r_max, plus one extra shell unless r_max is exactly the cell
+    // width. Searching all shells up to that range is a cube of offsets.
+    const int extra_search_width = (r_max == m_cell_width) ? 0 : 1;
+    int range = extra_search_width;
+    while ((range + 1 - extra_search_width) * m_cell_width <= r_max)
+    {
+        ++range;
+    }
+
+    // In each dimension, offsets that differ by a multiple of the number of
+    // cells wrap to the same cell, so we only keep distinct residues.
+    auto make_offsets = [range](unsigned int num_cells) {
+        std::vector<int> offsets;
+        if (2 * range + 1 >= static_cast<int>(num_cells))
+        {
+            for (unsigned int i = 0; i < num_cells; ++i)
+            {
+                offsets.push_back(static_cast<int>(i));
+            }
+        }
+        else
+        {
+            for (int i = -range; i <= range; ++i)
+            {
+                offsets.push_back(i);
+            }
+        }
+        return offsets;
+    };
+
+    BallStencil stencil;
+    stencil.x = make_offsets(m_celldim.x);
+    stencil.y = make_offsets(m_celldim.y);
+    stencil.z = m_box.is2D() ? std::vector<int> {0} : make_offsets(m_celldim.z);
+    return stencil;
+}
+
+void LinkCell::sortByCell(const vec3<float>* query_points, unsigned int n_query_points,
+                          std::vector<unsigned int>& cells, std::vector<unsigned int>& order) const
+{
+    cells.resize(n_query_points);
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            cells[i] = getCell(query_points[i]);
+        }
+    });
+
+    // Counting sort of the query points by cell, which keeps the points of
+    // each cell in increasing index order.
+    std::vector<unsigned int> cell_offsets(m_size + 1, 0);
+    for (unsigned int i = 0; i < n_query_points; ++i)
+    {
+        ++cell_offsets[cells[i] + 1];
+    }
+    for (unsigned int cell = 0; cell < m_size; ++cell)
+    {
+        cell_offsets[cell + 1] += cell_offsets[cell];
+    }
+    order.resize(n_query_points);
+    for (unsigned int i = 0; i < n_query_points; ++i)
+    {
+        order[cell_offsets[cells[i]]++] = i;
+    }
+}
+
+unsigned int LinkCell::countBall(const BallStencil& stencil, const vec3<float>& query_point,
+                                 unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                                 bool half, unsigned int max_count) const
+{
+    unsigned int count = 0;
+    box::dispatchBoxTraits(m_box, BallCount {*this, stencil, query_point, query_point_idx, r_max, r_min,
+                                             exclude_ii, half, max_count, count});
+    return count;
+}
+
+template<typename BoxType>
+unsigned int LinkCell::countBallInBox(const BoxType& box, const BallStencil& stencil,
+                                      const vec3<float>& query_point, unsigned int query_point_idx,
+                                      float r_max, float r_min, bool exclude_ii, bool half,
+                                      unsigned int max_count) const
+{
+    if (max_count == 0)
+    {
+        return 0;
+    }
+
+    const float r_max_sq = r_max * r_max;
+    const float r_min_sq = r_min * r_min;
+    const unsigned int* cell_start = m_cell_start.get();
+    const unsigned int* cell_points = m_cell_points.get();
+    const bool use_copy = m_cell_ordered_points.size() != 0;
+    const vec3<float>* cell_ordered_points = m_cell_ordered_points.get();
+    const vec3<unsigned int> point_cell(getCellCoord(query_point));
+
+    util::profiling::LocalCounter cells_scanned(util::profiling::counter_cells_scanned);
+    unsigned int count = 0;
+    for (const int dz : stencil.z)
+    {
+        for (const int dy : stencil.y)
+        {
+            for (const int dx : stencil.x)
+            {
+                const unsigned int cell = getCellIndex(
+                    vec3<int>(point_cell.x + dx, point_cell.y + dy, point_cell.z + dz));
+                cells_scanned.add();
+                const unsigned int* cell_end = cell_points + cell_start[cell + 1];
+                unsigned int k = cell_start[cell];
+                if (half)
+                {
+                    k = static_cast<unsigned int>(
+                        std::upper_bound(cell_points + k, cell_end, query_point_idx) - cell_points);
+                }
+                for (; k != cell_start[cell + 1]; ++k)
+                {
+                    const unsigned int j = cell_points[k];
+                    if (exclude_ii && query_point_idx == j)
+                    {
+                        continue;
+                    }
+
+                    const vec3<float> point(use_copy ? cell_ordered_points[k] : m_points[j]);
+                    const vec3<float> r_ij(box.wrap(point - query_point));
+                    const float r_sq(dot(r_ij, r_ij));
+                    if (r_sq < r_max_sq && r_sq >= r_min_sq && ++count == max_count)
+                    {
+                        return count;
+                    }
+                }
+            }
+        }
+    }
+    return count;
+}
+
+template<typename BoxType>
+void LinkCell::findNearestInBox(const BoxType& box, const vec3<float>& query_point,
+                                unsigned int query_point_idx, unsigned int num_neighbors, float r_max,
+                                float r_min, bool exclude_ii, std::vector<NeighborBond>& neighbors) const
+{
+    neighbors.clear();
+    if (num_neighbors == 0)
+    {
+        return;
+    }
+
+    const float r_max_sq = r_max * r_max;
+    const float r_min_sq = r_min * r_min;
+    const unsigned int* cell_start = m_cell_start.get();
+    const unsigned int* cell_points = m_cell_points.get();
+    const bool use_copy = m_cell_ordered_points.size() != 0;
+    const vec3<float>* cell_ordered_points = m_cell_ordered_points.get();
+    const vec3<unsigned int> point_cell(getCellCoord(query_point));
+
+    // Offsets in [lower, upper] along a dimension of n cells map to distinct
+    // cells, and each is the offset of smallest magnitude reaching its cell.
+    const vec3<int> upper(m_celldim.x / 2, m_celldim.y / 2, m_celldim.z / 2);
+    const vec3<int> lower(-static_cast<int>((m_celldim.x - 1) / 2), -static_cast<int>((m_celldim.y - 1) / 2),
+                          -static_cast<int>((m_celldim.z - 1) / 2));
+    const int max_range = std::max(std::max(upper.x, -lower.x), std::max(std::max(upper.y, -lower.y),
+                                                                          std::max(upper.z, -lower.z)));
+
+    NearestNeighborHeap heap(num_neighbors);
+    util::profiling::LocalCounter cells_scanned(util::profiling::counter_cells_scanned);
+    auto search_cell = [&](int dx, int dy, int dz) {
+        const unsigned int cell
+            = getCellIndex(vec3<int>(point_cell.x + dx, point_cell.y + dy, point_cell.z + dz));
+        cells_scanned.add();
+        for (unsigned int k = cell_start[cell]; k != cell_start[cell + 1]; ++k)
+        {
+            const unsigned int j = cell_points[k];
+            if (exclude_ii && query_point_idx == j)
+            {
+                continue;
+            }
+
+            const vec3<float> point(use_copy ? cell_ordered_points[k] : m_points[j]);
+            const vec3<float> r_ij(box.wrap(point - query_point));
+            const float r_sq(dot(r_ij, r_ij));
+            if (r_sq < r_max_sq && r_sq >= r_min_sq)
+            {
+                const float distance = std::sqrt(r_sq);
+                if (heap.accepts(distance, j))
+                {
+                    heap.push(NeighborBond(query_point_idx, j, distance, 1, r_ij));
+                }
+            }
+        }
+    };
+
+    for (int range = 0; range <= max_range; ++range)
+    {
+        // Points in this shell are at least (range - 1) cell widths away.
+        const float shell_distance = static_cast<float>(range - 1) * m_cell_width;
+        if (range > 1 && (shell_distance > r_max || heap.excludes(shell_distance)))
+        {
+            break;
+        }
+
+        // Visit the cells whose largest offset component is exactly range.
+        for (int dz = std::max(lower.z, -range); dz <= std::min(upper.z, range); ++dz)
+        {
+            for (int dy = std::max(lower.y, -range); dy <= std::min(upper.y, range); ++dy)
+            {
+                if (std::abs(dz) == range || std::abs(dy) == range)
+                {
+                    for (int dx = std::max(lower.x, -range); dx <= std::min(upper.x, range); ++dx)
+                    {
+                        search_cell(dx, dy, dz);
+                    }
+                }
+                else
+                {
+                    if (-range >= lower.x)
+                    {
+                        search_cell(-range, dy, dz);
+                    }
+                    if (range <= upper.x)
+                    {
+                        search_cell(range, dy, dz);
+                    }
+                }
+            }
+        }
+    }
+    heap.extractSorted(neighbors);
+}
+
+void LinkCell::findNearest(const vec3<float>& query_point, unsigned int query_point_idx,
+                           unsigned int num_neighbors, float r_max, float r_min, bool exclude_ii,
+                           std::vector<NeighborBond>& neighbors) const
+{
+    box::dispatchBoxTraits(m_box, NearestSearch {*this, query_point, query_point_idx, num_neighbors, r_max,
+                                                 r_min, exclude_ii, neighbors});
+}
+
 NeighborBond LinkCellQueryBallIterator::next()
 {
     float r_max_sq = m_r_max * m_r_max;
@@ -489,8 +817,8 @@ NeighborBond LinkCellQueryBallIterator::next()
         // track between calls to next.
         for (unsigned int j = m_cell_iter.next(); !m_cell_iter.atEnd(); j = m_cell_iter.next())
         {
-            // Skip ii matches immediately if requested.
-            if (m_exclude_ii && m_query_point_idx == j)
+            // Skip ii matches (or all j <= i for half queries) immediately if requested.
+            if (skipPoint(j))
             {
                 continue;
             }
@@ -500,7 +828,7 @@ NeighborBond LinkCellQueryBallIterator::next()
 
             if (r_sq < r_max_sq && r_sq >= r_min_sq)
             {
-                return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq));
+                return NeighborBond(m_query_point_idx, j, std::sqrt(r_sq), 1, r_ij);
             }
         }
 
@@ -545,96 +873,19 @@ NeighborBond LinkCellQueryBallIterator::next()
 
 NeighborBond LinkCellQueryIterator::next()
 {
-    float r_max_sq = m_r_max * m_r_max;
-    float r_min_sq = m_r_min * m_r_min;
-
-    vec3<float> plane_distance = m_neighbor_query->getBox().getNearestPlaneDistance();
-    float min_plane_distance = std::min(plane_distance.x, plane_distance.y);
-    if (!m_neighbor_query->getBox().is2D())
+    // The nearest neighbors are only known once the whole search is
+    // complete, so they are found and cached the first time next is called
+    // and then returned one-by-one.
+    if (!m_searched)
     {
-        min_plane_distance = std::min(min_plane_distance, plane_distance.z);
+        m_linkcell->findNearest(m_query_point, m_query_point_idx, m_num_neighbors, m_r_max, m_r_min,
+                                m_exclude_ii, m_current_neighbors);
+        m_searched = true;
     }
-    unsigned int max_range = std::ceil(min_plane_distance / (2 * m_linkcell->getCellWidth())) + 1;
-
-    vec3<unsigned int> point_cell(m_linkcell->getCellCoord(m_query_point));
-    const unsigned int point_cell_index = m_linkcell->getCellIndex(
-        vec3<int>(point_cell.x, point_cell.y, point_cell.z) + (*m_neigh_cell_iter));
-    m_searched_cells.insert(point_cell_index);
 
-    // Loop over cell list neighbor shells relative to this point's cell.
-    if (!m_current_neighbors.size())
+    if (m_count < m_current_neighbors.size())
     {
-        // Expand search cell radius until termination conditions are met.
-        while (m_neigh_cell_iter != IteratorCellShell(max_range, m_neighbor_query->getBox().is2D()))
-        {
-            // Iterate over the particles in that cell. Using a local counter
-            // variable is safe, because the IteratorLinkCell object is keeping
-            // track between calls to next. However, we have to add an extra
-            // check outside to proof ourselves against returning after
-            // previous calls to next that have not yet reset the iterator.
-            if (!m_cell_iter.atEnd())
-            {
-                for (unsigned int j = m_cell_iter.next(); !m_cell_iter.atEnd(); j = m_cell_iter.next())
-                {
-                    // Skip ii matches immediately if requested.
-                    if (m_exclude_ii && m_query_point_idx == j)
-                    {
-                        continue;
-                    }
-                    const vec3<float> r_ij(m_neighbor_query->getBox().wrap((*m_linkcell)[j] - m_query_point));
-                    const float r_sq(dot(r_ij, r_ij));
-                    if (r_sq < r_max_sq && r_sq >= r_min_sq)
-                        m_current_neighbors.emplace_back(m_query_point_idx, j, std::sqrt(r_sq));
-                }
-            }
-
-            while (true)
-            {
-                ++m_neigh_cell_iter;
-
-                if (m_neigh_cell_iter == IteratorCellShell(max_range, m_neighbor_query->getBox().is2D()))
-                {
-                    break;
-                }
-
-                const unsigned int neighbor_cell_index = m_linkcell->getCellIndex(
-                    vec3<int>(point_cell.x, point_cell.y, point_cell.z) + (*m_neigh_cell_iter));
-                // Insertion to an unordered set returns a pair, the second
-                // element indicates insertion success or failure (if it
-                // already exists)
-                if (m_searched_cells.insert(neighbor_cell_index).second)
-                {
-                    // This cell has not been searched yet, so we will
-                    // iterate over its contents. Otherwise, we loop back,
-                    // increment the cell shell iterator, and try the next
-                    // one.
-                    m_cell_iter = m_linkcell->itercell(neighbor_cell_index);
-                    break;
-                }
-            }
-
-            // We can terminate early if we determine when we reach a shell
-            // such that we already have k neighbors closer than the
-            // closest possible neighbor in the new shell.
-            std::sort(m_current_neighbors.begin(), m_current_neighbors.end());
-            if ((m_current_neighbors.size() >= m_num_neighbors)
-                && (m_current_neighbors[m_num_neighbors - 1].distance
-                    < (m_neigh_cell_iter.getRange() - 1) * m_linkcell->getCellWidth()))
-            {
-                break;
-            }
-        }
-    }
-
-    while ((m_count < m_num_neighbors) && (m_count < m_current_neighbors.size()))
-    {
-        m_count++;
-        if (m_current_neighbors[m_count - 1].distance > m_r_max)
-        {
-            m_finished = true;
-            return NeighborQueryIterator::ITERATOR_TERMINATOR;
-        }
-        return m_current_neighbors[m_count - 1];
+        return m_current_neighbors[m_count++];
     }
 
     m_finished = true;
@@ -4,14 +4,18 @@
 #ifndef LINKCELL_H
 #define LINKCELL_H
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
 #include <tbb/concurrent_hash_map.h>
 #include <unordered_set>
 #include <vector>
 
 #include "Box.h"
+#include "BoxTraits.h"
 #include "NeighborList.h"
 #include "NeighborQuery.h"
+#include "Profiling.h"
 
 /*! \file LinkCell.h
     \brief Build a cell list from a set of points.
@@ -165,8 +169,15 @@ private:
  *  an arbitrary point.
 
  *  <b>Data structures:</b><br>
- *  The internal data structure used in LinkCell is a linked list of particle
- *  indices. See IteratorLinkCell for information on how to iterate through these.
+ *  The cell list is built in parallel with a counting sort and stored in a
+ *  compressed sparse row layout: the indices of the points in cell c are
+ *  getCellPoints()[getCellStart()[c]] through
+ *  getCellPoints()[getCellStart()[c + 1] - 1], in increasing order. By
+ *  default, the point coordinates are also copied in this order (see
+ *  getCellOrderedPoints()) so that searching a cell reads contiguous memory.
+ *  For compatibility, the same information is also stored as a linked list of
+ *  particle indices. See IteratorLinkCell for information on how to iterate
+ *  through these.
 
  *  <b>2D:</b><br>
  *  LinkCell properly handles 2D boxes. When a 2D box is handed to LinkCell,
@@ -185,7 +196,17 @@ public:
     LinkCell();
 
     //! Constructor
-    LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width = 0);
+    /*! \param box Simulation box.
+     *  \param points Point coordinates.
+     *  \param n_points Number of points.
+     *  \param cell_width Minimum cell width. If 0, a width giving roughly 10 points per cell is used.
+     *  \param copy_points Whether to store a copy of the points in cell order.
+     *  \param spatial_sort If true, also compute a space-filling curve order
+     *         of the points that is used to traverse query points (see
+     *         NeighborQuery::getSpatialOrder).
+     */
+    LinkCell(const box::Box& box, const vec3<float>* points, unsigned int n_points, float cell_width = 0,
+             bool copy_points = true, bool spatial_sort = false);
 
     //! Compute LinkCell dimensions
     const vec3<unsigned int> computeDimensions(const box::Box& box, float cell_width) const;
@@ -227,12 +248,40 @@ public:
         return iteratorcell(m_cell_list, m_n_points, getNumCells(), cell);
     }
 
+    //! Get the offset of each cell's points in getCellPoints(), followed by the number of points
+    const util::ManagedArray<unsigned int>& getCellStart() const
+    {
+        return m_cell_start;
+    }
+
+    //! Get the point indices sorted by cell
+    const util::ManagedArray<unsigned int>& getCellPoints() const
+    {
+        return m_cell_points;
+    }
+
+    //! Get the point coordinates sorted by cell (empty if copy_points was false)
+    const util::ManagedArray<vec3<float>>& getCellOrderedPoints() const
+    {
+        return m_cell_ordered_points;
+    }
+
     //! Get a list of neighbors to a cell
     const std::vector<unsigned int>& getCellNeighbors(unsigned int cell) const;
 
     //! Compute the cell list
     void computeCellList(const vec3<float>* points, unsigned int n_points);
 
+    //! Update the point positions and rebin them into the existing cells.
+    /*! The cell dimensions are unchanged, so this avoids recomputing the
+     *  cell geometry and reallocating any memory. The same number of points
+     *  must be provided, and the new points must remain valid for as long
+     *  as this object is used.
+     *
+     *  \param points The new point coordinates.
+     */
+    void update(const vec3<float>* points);
+
     //! Implementation of per-particle query for LinkCell (see NeighborQuery.h for documentation).
     /*! \param query_point The point to find neighbors for.
      *  \param n_query_points The number of query points.
@@ -241,7 +290,347 @@ public:
     virtual std::shared_ptr<NeighborQueryPerPointIterator>
     querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const;
 
+    //! Offsets of all cells that must be searched for a ball query.
+    /*! The offsets are stored separately for each dimension, and the full
+     *  stencil is their outer product. Offsets that would map to the same
+     *  cell after periodic wrapping are removed, so no cell is visited twice
+     *  even when the stencil is wider than the cell list.
+     */
+    struct BallStencil
+    {
+        std::vector<int> x; //!< Cell offsets along x.
+        std::vector<int> y; //!< Cell offsets along y.
+        std::vector<int> z; //!< Cell offsets along z.
+    };
+
+    //! Compute the cell stencil covering all points within r_max of a cell.
+    /*! The stencil matches the cell shells searched by
+     *  LinkCellQueryBallIterator, so both paths find the same neighbors.
+     *
+     *  \param r_max The query distance.
+     */
+    BallStencil computeBallStencil(float r_max) const;
+
+    //! Call a visitor on all neighbors of a point within a ball.
+    /*! This is the allocation-free counterpart to LinkCellQueryBallIterator.
+     *  Instead of returning bonds one at a time through a virtual next() call,
+     *  all neighbors of the query point are found in a single pass over the
+     *  contiguous storage of the cells in the provided stencil and passed to
+     *  the visitor. The bonds are wrapped with the box::BoxTraits matching
+     *  the box, so the shape of the box is only checked once per call.
+     *
+     *  The points of each cell are stored in increasing order, so half
+     *  queries start reading each cell after the query point index and
+     *  never load the positions of the skipped points.
+     *
+     *  \param stencil Cell offsets to search, from computeBallStencil.
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx (see skipPair).
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void visitBall(const BallStencil& stencil, const vec3<float>& query_point, unsigned int query_point_idx,
+                   float r_max, float r_min, bool exclude_ii, bool half, const Visitor& visitor) const
+    {
+        box::dispatchBoxTraits(m_box, BallVisit<Visitor> {*this, stencil, query_point, query_point_idx, r_max,
+                                                         r_min, exclude_ii, half, visitor});
+    }
+
+    //! Count the neighbors of a point within a ball, stopping once max_count are found.
+    /*! This is the counterpart to visitBall for count and exists queries.
+     *  The same points are tested, but no bonds are created and the search
+     *  returns as soon as max_count neighbors have been found.
+     *
+     *  \param stencil Cell offsets to search, from computeBallStencil.
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param half Whether to skip bonds where point_idx <= query_point_idx (see skipPair).
+     *  \param max_count Number of neighbors after which to stop searching.
+     *  \returns The number of neighbors found, at most max_count.
+     */
+    unsigned int countBall(const BallStencil& stencil, const vec3<float>& query_point,
+                           unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii, bool half,
+                           unsigned int max_count) const;
+
+    //! Maximum number of query points searching the cells together in visitBallPacket.
+    static const unsigned int PACKET_SIZE = 16;
+
+    //! Call a visitor on all neighbors of a packet of points in the same cell within a ball.
+    /*! Query points in the same cell search the same stencil of cells, so
+     *  the points of each cell of the stencil are loaded once and tested
+     *  against the whole packet instead of once per query point. This pays
+     *  off for many query points per cell, such as a fine grid of probes.
+     *
+     *  The bonds found are the same as those of visitBall, and the bonds of
+     *  each query point are visited in the same order, but the bonds of
+     *  different query points of the packet are interleaved. Half queries
+     *  are not supported.
+     *
+     *  \param stencil Cell offsets to search, from computeBallStencil.
+     *  \param query_points Query point coordinates.
+     *  \param query_point_indices Indices of the query points of the packet, which must all be in one cell.
+     *  \param num_query_points Number of query points in the packet, at most PACKET_SIZE.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void visitBallPacket(const BallStencil& stencil, const vec3<float>* query_points,
+                         const unsigned int* query_point_indices, unsigned int num_query_points, float r_max,
+                         float r_min, bool exclude_ii, const Visitor& visitor) const
+    {
+        box::dispatchBoxTraits(m_box, BallPacketVisit<Visitor> {*this, stencil, query_points,
+                                                               query_point_indices, num_query_points, r_max,
+                                                               r_min, exclude_ii, visitor});
+    }
+
+    //! Order query points by the cell containing them.
+    /*! \param query_points Query point coordinates.
+     *  \param n_query_points Number of query points.
+     *  \param cells Filled with the cell of each query point.
+     *  \param order Filled with the query point indices sorted by cell, in
+     *         increasing index order within each cell.
+     */
+    void sortByCell(const vec3<float>* query_points, unsigned int n_query_points,
+                    std::vector<unsigned int>& cells, std::vector<unsigned int>& order) const;
+
+    //! Find the nearest neighbors of a point by searching cells in shells of increasing distance.
+    /*! Each cell is searched at most once, using the offset of smallest
+     *  magnitude that maps to it, and a bounded max-heap keeps the nearest
+     *  points found so far. The search stops before the first shell whose
+     *  closest point of approach is farther than the farthest neighbor kept
+     *  or than r_max.
+     *
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param num_neighbors The number of neighbors to find.
+     *  \param r_max The maximum distance of neighbors.
+     *  \param r_min The minimum distance of neighbors.
+     *  \param exclude_ii Whether to skip bonds where query_point_idx == point_idx.
+     *  \param neighbors Vector filled with the bonds found, sorted by distance.
+     */
+    void findNearest(const vec3<float>& query_point, unsigned int query_point_idx, unsigned int num_neighbors,
+                     float r_max, float r_min, bool exclude_ii, std::vector<NeighborBond>& neighbors) const;
+
+protected:
+    //! Build a LinkCell with the same cells over the points of one type, see setPointTypes.
+    virtual std::shared_ptr<NeighborQuery> makeTypeQuery(const vec3<float>* points,
+                                                         unsigned int n_points) const
+    {
+        return std::make_shared<LinkCell>(m_box, points, n_points, m_cell_width, m_copy_points,
+                                          m_spatial_order.size() != 0);
+    }
+
 private:
+    //! Forwards visitBall to visitBallInBox with the traits of the box.
+    template<typename Visitor> struct BallVisit
+    {
+        const LinkCell& cell_list;
+        const BallStencil& stencil;
+        const vec3<float>& query_point;
+        unsigned int query_point_idx;
+        float r_max;
+        float r_min;
+        bool exclude_ii;
+        bool half;
+        const Visitor& visitor;
+
+        template<typename BoxType> void operator()(const BoxType& box) const
+        {
+            cell_list.visitBallInBox(box, stencil, query_point, query_point_idx, r_max, r_min, exclude_ii,
+                                     half, visitor);
+        }
+    };
+
+    //! Implementation of visitBall for a box shape known at compile time.
+    template<typename BoxType, typename Visitor>
+    void visitBallInBox(const BoxType& box, const BallStencil& stencil, const vec3<float>& query_point,
+                        unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii, bool half,
+                        const Visitor& visitor) const
+    {
+        const float r_max_sq = r_max * r_max;
+        const float r_min_sq = r_min * r_min;
+        const unsigned int* cell_start = m_cell_start.get();
+        const unsigned int* cell_points = m_cell_points.get();
+        const bool use_copy = m_cell_ordered_points.size() != 0;
+        const vec3<float>* cell_ordered_points = m_cell_ordered_points.get();
+        const vec3<unsigned int> point_cell(getCellCoord(query_point));
+        util::profiling::LocalCounter cells_scanned(util::profiling::counter_cells_scanned);
+
+        for (const int dz : stencil.z)
+        {
+            for (const int dy : stencil.y)
+            {
+                for (const int dx : stencil.x)
+                {
+                    const unsigned int cell = getCellIndex(vec3<int>(point_cell.x + dx, point_cell.y + dy,
+                                                                     point_cell.z + dz));
+                    cells_scanned.add();
+                    const unsigned int* cell_end = cell_points + cell_start[cell + 1];
+                    unsigned int k = cell_start[cell];
+                    if (half)
+                    {
+                        k = static_cast<unsigned int>(
+                            std::upper_bound(cell_points + k, cell_end, query_point_idx) - cell_points);
+                    }
+                    for (; k != cell_start[cell + 1]; ++k)
+                    {
+                        const unsigned int j = cell_points[k];
+                        if (exclude_ii && query_point_idx == j)
+                        {
+                            continue;
+                        }
+
+                        const vec3<float> point(use_copy ? cell_ordered_points[k] : m_points[j]);
+                        const vec3<float> r_ij(box.wrap(point - query_point));
+                        const float r_sq(dot(r_ij, r_ij));
+
+                        if (r_sq < r_max_sq && r_sq >= r_min_sq)
+                        {
+                            visitor(NeighborBond(query_point_idx, j, std::sqrt(r_sq), 1, r_ij));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //! Forwards visitBallPacket to visitBallPacketInBox with the traits of the box.
+    template<typename Visitor> struct BallPacketVisit
+    {
+        const LinkCell& cell_list;
+        const BallStencil& stencil;
+        const vec3<float>* query_points;
+        const unsigned int* query_point_indices;
+        unsigned int num_query_points;
+        float r_max;
+        float r_min;
+        bool exclude_ii;
+        const Visitor& visitor;
+
+        template<typename BoxType> void operator()(const BoxType& box) const
+        {
+            cell_list.visitBallPacketInBox(box, stencil, query_points, query_point_indices, num_query_points,
+                                           r_max, r_min, exclude_ii, visitor);
+        }
+    };
+
+    //! Implementation of visitBallPacket for a box shape known at compile time.
+    template<typename BoxType, typename Visitor>
+    void visitBallPacketInBox(const BoxType& box, const BallStencil& stencil, const vec3<float>* query_points,
+                              const unsigned int* query_point_indices, unsigned int num_query_points,
+                              float r_max, float r_min, bool exclude_ii, const Visitor& visitor) const
+    {
+        const float r_max_sq = r_max * r_max;
+        const float r_min_sq = r_min * r_min;
+        const unsigned int* cell_start = m_cell_start.get();
+        const unsigned int* cell_points = m_cell_points.get();
+        const bool use_copy = m_cell_ordered_points.size() != 0;
+        const vec3<float>* cell_ordered_points = m_cell_ordered_points.get();
+        const vec3<unsigned int> point_cell(getCellCoord(query_points[query_point_indices[0]]));
+
+        vec3<float> packet_points[PACKET_SIZE];
+        for (unsigned int p = 0; p < num_query_points; ++p)
+        {
+            packet_points[p] = query_points[query_point_indices[p]];
+        }
+        util::profiling::LocalCounter cells_scanned(util::profiling::counter_cells_scanned);
+
+        for (const int dz : stencil.z)
+        {
+            for (const int dy : stencil.y)
+            {
+                for (const int dx : stencil.x)
+                {
+                    const unsigned int cell = getCellIndex(vec3<int>(point_cell.x + dx, point_cell.y + dy,
+                                                                     point_cell.z + dz));
+                    cells_scanned.add();
+                    for (unsigned int k = cell_start[cell]; k != cell_start[cell + 1]; ++k)
+                    {
+                        const unsigned int j = cell_points[k];
+                        const vec3<float> point(use_copy ? cell_ordered_points[k] : m_points[j]);
+                        for (unsigned int p = 0; p < num_query_points; ++p)
+                        {
+                            const unsigned int i = query_point_indices[p];
+                            if (exclude_ii && i == j)
+                            {
+                                continue;
+                            }
+
+                            const vec3<float> r_ij(box.wrap(point - packet_points[p]));
+                            const float r_sq(dot(r_ij, r_ij));
+
+                            if (r_sq < r_max_sq && r_sq >= r_min_sq)
+                            {
+                                visitor(NeighborBond(i, j, std::sqrt(r_sq), 1, r_ij));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //! Forwards countBall to countBallInBox with the traits of the box.
+    struct BallCount
+    {
+        const LinkCell& cell_list;
+        const BallStencil& stencil;
+        const vec3<float>& query_point;
+        unsigned int query_point_idx;
+        float r_max;
+        float r_min;
+        bool exclude_ii;
+        bool half;
+        unsigned int max_count;
+        unsigned int& count;
+
+        template<typename BoxType> void operator()(const BoxType& box) const
+        {
+            count = cell_list.countBallInBox(box, stencil, query_point, query_point_idx, r_max, r_min,
+                                             exclude_ii, half, max_count);
+        }
+    };
+
+    //! Implementation of countBall for a box shape known at compile time.
+    template<typename BoxType>
+    unsigned int countBallInBox(const BoxType& box, const BallStencil& stencil, const vec3<float>& query_point,
+                                unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                                bool half, unsigned int max_count) const;
+
+    //! Forwards findNearest to findNearestInBox with the traits of the box.
+    struct NearestSearch
+    {
+        const LinkCell& cell_list;
+        const vec3<float>& query_point;
+        unsigned int query_point_idx;
+        unsigned int num_neighbors;
+        float r_max;
+        float r_min;
+        bool exclude_ii;
+        std::vector<NeighborBond>& neighbors;
+
+        template<typename BoxType> void operator()(const BoxType& box) const
+        {
+            cell_list.findNearestInBox(box, query_point, query_point_idx, num_neighbors, r_max, r_min,
+                                       exclude_ii, neighbors);
+        }
+    };
+
+    //! Implementation of findNearest for a box shape known at compile time.
+    template<typename BoxType>
+    void findNearestInBox(const BoxType& box, const vec3<float>& query_point, unsigned int query_point_idx,
+                          unsigned int num_neighbors, float r_max, float r_min, bool exclude_ii,
+                          std::vector<NeighborBond>& neighbors) const;
+
     //! Helper function to compute cell neighbors
     const std::vector<unsigned int>& computeCellNeighbors(unsigned int cell) const;
 
@@ -251,7 +640,12 @@ private:
     vec3<unsigned int> m_celldim; //!< Cell dimensions
     unsigned int m_size;          //!< The size of cell list.
 
-    util::ManagedArray<unsigned int> m_cell_list; //!< The cell list last computed
+    bool m_copy_points;           //!< Whether to store the points in cell order.
+
+    util::ManagedArray<unsigned int> m_cell_list;         //!< The cell list last computed
+    util::ManagedArray<unsigned int> m_cell_start;        //!< Offset of each cell in m_cell_points
+    util::ManagedArray<unsigned int> m_cell_points;       //!< Point indices sorted by cell
+    util::ManagedArray<vec3<float>> m_cell_ordered_points; //!< Point coordinates sorted by cell
     typedef tbb::concurrent_hash_map<unsigned int, std::vector<unsigned int>> CellNeighbors;
     mutable CellNeighbors m_cell_neighbors; //!< Hash map of cell neighbors for each cell
 };
@@ -265,9 +659,10 @@ public:
      *  iterate outwards from there.
      */
     LinkCellIterator(const LinkCell* neighbor_query, const vec3<float> query_point,
-                     unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii)
+                     unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                     bool half = false)
         : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, r_max, r_min,
-                                        exclude_ii),
+                                        exclude_ii, half),
           m_linkcell(neighbor_query), m_neigh_cell_iter(0, neighbor_query->getBox().is2D()),
           m_cell_iter(m_linkcell->itercell(m_linkcell->getCell(m_query_point)))
     {}
@@ -286,6 +681,9 @@ protected:
 };
 
 //! Iterator that gets specified numbers of nearest neighbors from LinkCell tree structures.
+/*! The neighbors are found all at once by LinkCell::findNearest the first
+ *  time next() is called, and then returned one at a time.
+ */
 class LinkCellQueryIterator : public LinkCellIterator
 {
 public:
@@ -294,7 +692,7 @@ public:
                           unsigned int query_point_idx, unsigned int num_neighbors, float r_max, float r_min,
                           bool exclude_ii)
         : LinkCellIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii),
-          m_count(0), m_num_neighbors(num_neighbors)
+          m_count(0), m_num_neighbors(num_neighbors), m_searched(false)
     {}
 
     //! Empty Destructor
@@ -306,6 +704,7 @@ public:
 protected:
     unsigned int m_count;                          //!< Number of neighbors returned for the current point.
     unsigned int m_num_neighbors;                  //!< Number of nearest neighbors to find
+    bool m_searched;                               //!< Whether the neighbors have been found yet.
     std::vector<NeighborBond> m_current_neighbors; //!< The current set of found neighbors.
 };
 
@@ -315,8 +714,9 @@ class LinkCellQueryBallIterator : public LinkCellIterator
 public:
     //! Constructor
     LinkCellQueryBallIterator(const LinkCell* neighbor_query, const vec3<float> query_point,
-                              unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii)
-        : LinkCellIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii)
+                              unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                              bool half = false)
+        : LinkCellIterator(neighbor_query, query_point, query_point_idx, r_max, r_min, exclude_ii, half)
     {
         // Upon querying, if the search radius is equal to the cell width, we
         // can guarantee that we don't need to search the cell shell past the
@@ -0,0 +1,175 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEAREST_NEIGHBOR_HEAP_H
+#define NEAREST_NEIGHBOR_HEAP_H
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "NeighborBond.h"
+
+/*! \file NearestNeighborHeap.h
+    \brief Bounded priority queue of the nearest neighbors found by a search.
+*/
+
+namespace freud { namespace locality {
+
+//! Fixed-capacity max-heap holding the nearest bonds found so far.
+/*! k-nearest-neighbor searches insert candidate bonds as they are found. Once
+ *  the heap is full, the farthest bond is at the top and is replaced by any
+ *  closer candidate, so the heap never grows beyond the number of neighbors
+ *  requested and its top gives the pruning distance for the search. Bonds
+ *  are ordered by distance, with ties broken by point index so that results
+ *  do not depend on the order in which candidates are found.
+ */
+class NearestNeighborHeap
+{
+public:
+    //! Constructor
+    /*! \param capacity Number of nearest neighbors to keep.
+     */
+    explicit NearestNeighborHeap(unsigned int capacity) : m_capacity(capacity)
+    {
+        m_bonds.reserve(capacity + 1);
+    }
+
+    //! Whether the heap holds the requested number of neighbors.
+    bool full() const
+    {
+        return m_bonds.size() >= m_capacity;
+    }
+
+    //! The farthest bond kept. Only valid if the heap is not empty.
+    const NeighborBond& top() const
+    {
+        return m_bonds.front();
+    }
+
+    //! Whether all bonds kept are closer than a given distance.
+    bool allCloserThan(float distance) const
+    {
+        return m_bonds.empty() || top().distance < distance;
+    }
+
+    //! Whether a candidate bond would be kept if inserted now.
+    bool accepts(float distance, unsigned int point_idx) const
+    {
+        return !full() || (m_capacity != 0 && closer(distance, point_idx, top()));
+    }
+
+    //! Whether no point farther than a given distance can be kept.
+    /*! Used to stop searching regions whose closest point of approach is at
+     *  least this distance away.
+     */
+    bool excludes(float distance) const
+    {
+        return full() && (m_capacity == 0 || top().distance < distance);
+    }
+
+    //! Squared distance at or beyond which no point can be kept.
+    /*! This avoids a square root for every region tested. The bound keeps a
+     *  small relative margin, so points whose rounded distance ties with the
+     *  farthest bond kept are never excluded. It is infinite until the heap
+     *  is full.
+     */
+    float pruneDistanceSquared() const
+    {
+        if (!full())
+        {
+            return std::numeric_limits<float>::infinity();
+        }
+        return (m_capacity == 0) ? 0 : top().distance * top().distance * SQUARED_MARGIN;
+    }
+
+    //! Insert a bond, evicting the farthest bond if the heap is full.
+    /*! The bond must be accepted, see accepts().
+     */
+    void push(const NeighborBond& bond)
+    {
+        if (!full())
+        {
+            m_bonds.push_back(bond);
+            std::push_heap(m_bonds.begin(), m_bonds.end(), Closer());
+            return;
+        }
+
+        // Replace the farthest bond and sift the new bond down to its place.
+        const size_t size = m_bonds.size();
+        size_t i = 0;
+        for (size_t child = 1; child < size; child = 2 * i + 1)
+        {
+            if (child + 1 < size && Closer()(m_bonds[child], m_bonds[child + 1]))
+            {
+                ++child;
+            }
+            if (!Closer()(bond, m_bonds[child]))
+            {
+                break;
+            }
+            m_bonds[i] = m_bonds[child];
+            i = child;
+        }
+        m_bonds[i] = bond;
+    }
+
+    //! Insert a bond, keeping only the closest bond to each point.
+    /*! Searches over several periodic images can find the same point more
+     *  than once. The heap is small, so a linear scan for the point is
+     *  cheaper than any lookup structure. The bond must be accepted, see
+     *  accepts().
+     */
+    void pushUnique(const NeighborBond& bond)
+    {
+        for (auto it = m_bonds.begin(); it != m_bonds.end(); ++it)
+        {
+            if (it->point_idx == bond.point_idx)
+            {
+                if (Closer()(bond, *it))
+                {
+                    *it = bond;
+                    std::make_heap(m_bonds.begin(), m_bonds.end(), Closer());
+                }
+                return;
+            }
+        }
+        push(bond);
+    }
+
+    //! Move the bonds kept into a vector, sorted from nearest to farthest.
+    /*! The heap is left empty.
+     */
+    void extractSorted(std::vector<NeighborBond>& bonds)
+    {
+        std::sort_heap(m_bonds.begin(), m_bonds.end(), Closer());
+        bonds.swap(m_bonds);
+        m_bonds.clear();
+    }
+
+private:
+    //! Relative margin of pruneDistanceSquared, well above the rounding error of squaring the distance.
+    static constexpr float SQUARED_MARGIN = 1.00001f;
+
+    //! Whether a candidate is closer than a bond.
+    static bool closer(float distance, unsigned int point_idx, const NeighborBond& bond)
+    {
+        return distance < bond.distance || (distance == bond.distance && point_idx < bond.point_idx);
+    }
+
+    //! Heap ordering of bonds by distance, then point index.
+    struct Closer
+    {
+        bool operator()(const NeighborBond& a, const NeighborBond& b) const
+        {
+            return closer(a.distance, a.point_idx, b);
+        }
+    };
+
+    unsigned int m_capacity;           //!< Number of nearest neighbors to keep.
+    std::vector<NeighborBond> m_bonds; //!< Heap of the nearest bonds found so far.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // NEAREST_NEIGHBOR_HEAP_H
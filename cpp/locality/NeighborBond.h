@@ -1,6 +1,8 @@
 #ifndef NEIGHBOR_BOND_H
 #define NEIGHBOR_BOND_H
 
+#include "VectorMath.h"
+
 namespace freud { namespace locality {
 
 //! Simple data structure encoding neighboring points.
@@ -8,14 +10,19 @@ namespace freud { namespace locality {
  *  than a simple std::pair, which is hard to interpret. Additionally, this
  *  class defines the less than operator according to distance, making it
  *  possible to sort.
+ *
+ *  Bonds found by a NeighborQuery also carry the bond vector, which points
+ *  from the query point to the point (point - query_point) and is wrapped
+ *  into the box, so that computes do not need to recompute it.
  */
 struct NeighborBond
 {
     // For now, id = query_point_idx and ref_id = point_idx (into the NeighborQuery).
-    NeighborBond() : query_point_idx(0), point_idx(0), distance(0), weight(0) {}
+    NeighborBond() : query_point_idx(0), point_idx(0), distance(0), weight(0), vector() {}
 
-    NeighborBond(unsigned int query_point_idx, unsigned int point_idx, float d = 0, float w = 1)
-        : query_point_idx(query_point_idx), point_idx(point_idx), distance(d), weight(w)
+    NeighborBond(unsigned int query_point_idx, unsigned int point_idx, float d = 0, float w = 1,
+                 const vec3<float>& v = vec3<float>())
+        : query_point_idx(query_point_idx), point_idx(point_idx), distance(d), weight(w), vector(v)
     {}
 
     //! Equality checks both query_point_idx and distance.
@@ -91,6 +98,7 @@ struct NeighborBond
     unsigned int point_idx;       //! The reference point index.
     float distance;               //! The distance between the points.
     float weight;                 //! The weight of this bond.
+    vec3<float> vector;           //! The wrapped vector from the query point to the point.
 };
 
 }; }; // end namespace freud::locality
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <tbb/enumerable_thread_specific.h>
+
 #include "NeighborComputeFunctional.h"
 
 /*! \file NeighborComputeFunctional.h
@@ -20,4 +23,113 @@ NeighborList makeDefaultNlist(const NeighborQuery* nq, const NeighborList* nlist
     return new_nlist;
 }
 
+float estimateBondsPerQueryPoint(const NeighborQuery* nq, QueryArgs qargs)
+{
+    qargs = nq->resolveQueryArgs(qargs);
+    validateBondQuery(qargs);
+    const float num_points = float(nq->getNPoints());
+    const float density = num_points / nq->getBox().getVolume();
+    auto ball_bonds = [&](float r_max) {
+        const float r_min = std::max(qargs.r_min, float(0));
+        const float measure = nq->getBox().is2D()
+            ? float(M_PI) * (r_max * r_max - r_min * r_min)
+            : float(4 * M_PI / 3) * (r_max * r_max * r_max - r_min * r_min * r_min);
+        return density * measure;
+    };
+
+    float bonds = num_points;
+    if (qargs.mode == QueryArgs::nearest)
+    {
+        bonds = std::min(float(qargs.num_neighbors), num_points - (qargs.exclude_ii ? 1 : 0));
+        if (qargs.r_max > 0)
+        {
+            bonds = std::min(bonds, ball_bonds(qargs.r_max));
+        }
+    }
+    else if (qargs.mode == QueryArgs::ball)
+    {
+        bonds = ball_bonds(qargs.r_max);
+    }
+    if (qargs.half)
+    {
+        bonds /= 2;
+    }
+    return std::max(std::min(bonds, num_points), float(0));
+}
+
+size_t estimateNeighborListBytes(const NeighborQuery* nq, unsigned int n_query_points, QueryArgs qargs)
+{
+    const double bonds = double(estimateBondsPerQueryPoint(nq, qargs)) * n_query_points;
+    return static_cast<size_t>(std::ceil(bonds)) * NEIGHBOR_LIST_BOND_BYTES
+        + size_t(n_query_points) * NEIGHBOR_LIST_QUERY_POINT_BYTES;
+}
+
+NeighborList* queryNeighborListChunk(const DirectNeighborQuery& query, unsigned int n_query_points,
+                                     unsigned int n_points, const std::vector<unsigned int>& indices)
+{
+    util::profiling::ScopedTimer timer("NeighborQuery::toNeighborListChunk");
+
+    // Bonds found for one block of the query points of the chunk, grouped by
+    // query point in the order of the chunk and sorted within each.
+    struct BondBlock
+    {
+        size_t begin;                    //!< First position of the block in the chunk.
+        size_t end;                      //!< Position past the end of the block.
+        std::vector<NeighborBond> bonds; //!< Grouped bonds.
+    };
+    tbb::enumerable_thread_specific<std::vector<BondBlock>> blocks;
+    std::vector<size_t> offsets(indices.size() + 1, 0);
+    util::forLoopWrapper(0, indices.size(), [&](size_t begin, size_t end) {
+        BondBlock block {begin, end, std::vector<NeighborBond>()};
+        for (size_t k = begin; k < end; ++k)
+        {
+            const size_t first = block.bonds.size();
+            query.visit(indices[k], NeighborBondAppender(block.bonds));
+            std::sort(block.bonds.begin() + first, block.bonds.end(), compareNeighborBond);
+            offsets[k + 1] = block.bonds.size() - first;
+        }
+        util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+        bonds_visited.add(block.bonds.size());
+        blocks.local().push_back(std::move(block));
+    });
+    for (size_t k = 0; k < indices.size(); ++k)
+    {
+        offsets[k + 1] += offsets[k];
+    }
+
+    NeighborList* nl = new NeighborList();
+    nl->setNumBonds(offsets.back(), n_query_points, n_points);
+    nl->setHasVectors(true);
+    nl->setHalf(query.getQueryArgs().half);
+
+    std::vector<const BondBlock*> all_blocks;
+    for (const std::vector<BondBlock>& local_blocks : blocks)
+    {
+        for (const BondBlock& block : local_blocks)
+        {
+            all_blocks.push_back(&block);
+        }
+    }
+    util::forLoopWrapper(0, all_blocks.size(), [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const BondBlock& block = *all_blocks[b];
+            size_t bond = offsets[block.begin];
+            for (const NeighborBond& nb : block.bonds)
+            {
+                nl->getQueryPointIndices()[bond] = nb.query_point_idx;
+                nl->getPointIndices()[bond] = nb.point_idx;
+                nl->getDistances()[bond] = nb.distance;
+                nl->getWeights()[bond] = float(1.0);
+                nl->getVectors()[bond] = nb.vector;
+                ++bond;
+            }
+        }
+    });
+    nl->updateSegmentCounts();
+
+    return nl;
+}
+
+
 }; }; // end namespace freud::locality
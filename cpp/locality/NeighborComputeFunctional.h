@@ -1,12 +1,18 @@
 #ifndef NEIGHBOR_COMPUTE_FUNCTIONAL_H
 #define NEIGHBOR_COMPUTE_FUNCTIONAL_H
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "AABBQuery.h"
+#include "CompressedNeighborList.h"
+#include "LinkCell.h"
 #include "NeighborList.h"
 #include "NeighborPerPointIterator.h"
 #include "NeighborQuery.h"
+#include "Profiling.h"
+#include "RawPoints.h"
 #include "utils.h"
 
 /*! \file NeighborComputeFunctional.h
@@ -35,24 +41,60 @@ inline vec3<float> bondVector(const NeighborBond& nb, const NeighborQuery* nq,
     return nq->getBox().wrap((*nq)[nb.point_idx] - query_points[nb.query_point_idx]);
 }
 
+//! Get the vector corresponding to a bond in a NeighborList.
+/*! The bond vector stored in the NeighborList is returned if there is one.
+ *  Otherwise, the vector is computed from the provided points as in
+ *  bondVector(const NeighborBond&, const NeighborQuery*, const vec3<float>*).
+ */
+inline vec3<float> bondVector(const NeighborList* nlist, size_t bond, const NeighborQuery* nq,
+                              const vec3<float>* query_points)
+{
+    if (nlist->hasVectors())
+    {
+        return nlist->getVectors()[bond];
+    }
+    return nq->getBox().wrap((*nq)[nlist->getPointIndices()[bond]]
+                             - query_points[nlist->getQueryPointIndices()[bond]]);
+}
+
+//! Whether the bonds of a loop over neighbors form a half list.
+/*! Half lists hold each pair of points once, as the bond from the smaller
+ *  index to the larger (see QueryArgs::half and NeighborList::isHalf).
+ *  Computes of quantities that are symmetric under the exchange of the
+ *  points of a bond accumulate the contributions of both directions of a
+ *  pair when visiting its bond.
+ *
+ *  \param nlist The NeighborList of the loop, may be NULL.
+ *  \param qargs The query arguments of the loop, used if nlist is NULL.
+ */
+inline bool isHalfNeighbors(const NeighborList* nlist, const QueryArgs& qargs)
+{
+    return (nlist != nullptr) ? nlist->isHalf() : qargs.half;
+}
+
 //! Implementation of per-point finding logic for NeighborList objects.
 /*! This class provides a concrete implementation of the per-point neighbor
  *  finding interface specified by the NeighborPerPointIterator. In particular,
  *  it includes the logic for finding neighbors within a NeighborList by using
  *  the find_first_index method to initialize a start index and looping over all
  *  neighbors in the NeighborList.
+ *
+ *  If a NeighborQuery and query points are provided, the returned bonds
+ *  include the bond vectors, read from the NeighborList when it stores them
+ *  and computed otherwise.
  */
 class NeighborListPerPointIterator : public NeighborPerPointIterator
 {
 public:
-    NeighborListPerPointIterator(const NeighborList* nlist, size_t point_index)
-        : NeighborPerPointIterator(point_index), m_nlist(nlist)
+    NeighborListPerPointIterator(const NeighborList* nlist, size_t point_index,
+                                 const NeighborQuery* nq = nullptr, const vec3<float>* query_points = nullptr)
+        : NeighborPerPointIterator(point_index), m_nlist(nlist), m_nq(nq), m_query_points(query_points)
     {
         m_current_index = m_nlist->find_first_index(point_index);
         m_finished = m_current_index == m_nlist->getNumBonds();
         if (!m_finished)
         {
-            m_returned_point_index = m_nlist->getNeighbors()(m_current_index, 0);
+            m_returned_point_index = m_nlist->getQueryPointIndices()[m_current_index];
         }
     }
 
@@ -67,8 +109,12 @@ public:
         }
 
         NeighborBond nb = NeighborBond(
-            m_nlist->getNeighbors()(m_current_index, 0), m_nlist->getNeighbors()(m_current_index, 1),
+            m_nlist->getQueryPointIndices()[m_current_index], m_nlist->getPointIndices()[m_current_index],
             m_nlist->getDistances()[m_current_index], m_nlist->getWeights()[m_current_index]);
+        if (m_nq != nullptr)
+        {
+            nb.vector = bondVector(m_nlist, m_current_index, m_nq, m_query_points);
+        }
         ++m_current_index;
         m_returned_point_index = nb.query_point_idx;
         return nb;
@@ -81,11 +127,514 @@ public:
 
 private:
     const NeighborList* m_nlist;
+    const NeighborQuery* m_nq;
+    const vec3<float>* m_query_points;
     size_t m_current_index;
     size_t m_returned_point_index;
     bool m_finished;
 };
 
+//! Visitor appending bonds to a vector.
+class NeighborBondAppender
+{
+public:
+    explicit NeighborBondAppender(std::vector<NeighborBond>& bonds) : m_bonds(bonds) {}
+
+    void operator()(const NeighborBond& nb) const
+    {
+        m_bonds.push_back(nb);
+    }
+
+private:
+    std::vector<NeighborBond>& m_bonds; //!< The vector to append to.
+};
+
+//! Per-point iterator that replays a precomputed set of bonds.
+/*! This iterator allows the allocation-free DirectNeighborQuery to be used
+ *  by code written against the NeighborPerPointIterator interface. The bonds
+ *  for one query point are gathered into a buffer, and a single instance of
+ *  this class can be reset and reused for every query point handled by a
+ *  thread. The same bonds can be replayed several times with rewind().
+ */
+class NeighborVectorPerPointIterator : public NeighborPerPointIterator
+{
+public:
+    NeighborVectorPerPointIterator()
+        : NeighborPerPointIterator(0), m_current_index(0), m_r_max(0), m_finished(false)
+    {}
+
+    ~NeighborVectorPerPointIterator() {}
+
+    //! Clear the stored bonds and prepare to gather bonds for a new query point.
+    void reset(unsigned int query_point_idx)
+    {
+        m_query_point_idx = query_point_idx;
+        m_bonds.clear();
+        rewind();
+    }
+
+    //! Return to the first stored bond.
+    /*! \param r_max If positive, only bonds shorter than r_max are returned.
+     */
+    void rewind(float r_max = 0)
+    {
+        m_current_index = 0;
+        m_r_max = r_max;
+        m_finished = false;
+    }
+
+    //! Access the buffer holding the bonds of the current query point.
+    std::vector<NeighborBond>& getBonds()
+    {
+        return m_bonds;
+    }
+
+    virtual NeighborBond next()
+    {
+        if (m_r_max > 0)
+        {
+            while (m_current_index != m_bonds.size() && m_bonds[m_current_index].distance >= m_r_max)
+            {
+                ++m_current_index;
+            }
+        }
+        if (m_current_index == m_bonds.size())
+        {
+            m_finished = true;
+            return ITERATOR_TERMINATOR;
+        }
+        return m_bonds[m_current_index++];
+    }
+
+    virtual bool end()
+    {
+        return m_finished;
+    }
+
+private:
+    std::vector<NeighborBond> m_bonds; //!< The bonds of the current query point.
+    size_t m_current_index;            //!< The next bond to return.
+    float m_r_max;                     //!< If positive, bonds at least this long are skipped.
+    bool m_finished;                   //!< Whether all bonds have been returned.
+};
+
+//! Allocation-free neighbor finding on a NeighborQuery.
+/*! The standard query interface creates a heap-allocated per-point iterator
+ *  for every query point and makes a virtual call for every bond. This class
+ *  instead resolves the concrete NeighborQuery type once, precomputes any
+ *  state that is shared by all query points (cell stencils or periodic
+ *  images), and then calls a templated visitor for every bond found. Queries
+ *  on LinkCell and AABBQuery objects (including the AABBQuery built by
+ *  RawPoints) use the specialized visitBall and findNearest kernels of those
+ *  classes. All other queries fall back to the per-point iterators. Nearest
+ *  neighbors are visited in order of increasing distance.
+ *
+ *  Queries filtered by the type of the points (see QueryArgs::point_type)
+ *  search the data structure of the points of that type, with the indices
+ *  of its bonds translated back to the points, and queries filtered by the
+ *  type of the query points skip query points of other types.
+ *
+ *  When the query points are the points of a NeighborQuery that was
+ *  spatially sorted (see NeighborQuery::getSpatialOrder), loops should
+ *  visit the query point getQueryPointIndex(k) at step k, so that
+ *  consecutive queries touch nearby memory. The set of bonds found is
+ *  unchanged.
+ *
+ *  An instance is safe to use from multiple threads as long as each thread
+ *  visits different query points.
+ */
+class DirectNeighborQuery
+{
+public:
+    //! Constructor
+    /*! \param neighbor_query NeighborQuery object to find neighbors in.
+     *  \param query_points Query points to find neighbors for.
+     *  \param n_query_points Number of query_points.
+     *  \param qargs Query arguments.
+     */
+    DirectNeighborQuery(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                        unsigned int n_query_points, QueryArgs qargs)
+        : m_query_points(query_points), m_neighbor_query(neighbor_query), m_linkcell(nullptr),
+          m_aabbquery(nullptr), m_query_order(nullptr), m_typed_query(nullptr), m_type_indices(nullptr)
+    {
+        util::profiling::ScopedTimer timer("NeighborQuery::setup");
+        m_qargs = neighbor_query->resolveQueryArgs(qargs);
+        neighbor_query->validateHalfQuery(m_qargs, query_points, n_query_points);
+        neighbor_query->validateTypeQuery(m_qargs, n_query_points);
+        validateBondQuery(m_qargs);
+
+        // Queries filtered by point type search the points of the type.
+        const NeighborQuery* order_query = neighbor_query;
+        if (isTypedQuery(m_qargs))
+        {
+            m_typed_query = neighbor_query;
+            if (m_qargs.point_type != QueryArgs::ANY_TYPE)
+            {
+                m_type_indices = neighbor_query->getTypeIndices(m_qargs.point_type);
+                m_neighbor_query = neighbor_query->getTypeQuery(m_qargs.point_type);
+                if (m_neighbor_query == nullptr)
+                {
+                    return;
+                }
+            }
+        }
+
+        // RawPoints objects delegate all queries to an internal AABBQuery or LinkCell.
+        const RawPoints* raw_points = dynamic_cast<const RawPoints*>(neighbor_query);
+        if (raw_points != nullptr)
+        {
+            m_neighbor_query = order_query = raw_points->getQueryObject(m_qargs);
+        }
+
+        // Traverse the query points in spatial order if they are the points
+        // that were sorted.
+        const util::ManagedArray<unsigned int>& order = order_query->getSpatialOrder();
+        if (order.size() != 0 && query_points == neighbor_query->getPoints()
+            && n_query_points == neighbor_query->getNPoints())
+        {
+            m_query_order = order.get();
+        }
+
+        m_linkcell = dynamic_cast<const LinkCell*>(m_neighbor_query);
+        m_aabbquery = dynamic_cast<const AABBQuery*>(m_neighbor_query);
+        if (m_qargs.mode == QueryArgs::ball)
+        {
+            if (m_linkcell != nullptr)
+            {
+                m_stencil = m_linkcell->computeBallStencil(m_qargs.r_max);
+
+                // With several query points per cell, the query points of a
+                // cell are searched together (see visitSteps), so they are
+                // traversed cell by cell unless they are spatially sorted.
+                if (!m_qargs.half && m_typed_query == nullptr
+                    && n_query_points >= 2 * m_linkcell->getNumCells())
+                {
+                    m_linkcell->sortByCell(query_points, n_query_points, m_query_cells, m_cell_order);
+                    if (m_query_order == nullptr)
+                    {
+                        m_query_order = m_cell_order.data();
+                    }
+                }
+            }
+            else if (m_aabbquery != nullptr)
+            {
+                m_images = m_aabbquery->computeImageList(m_qargs.r_max, true, query_points, n_query_points);
+            }
+        }
+        else if (m_qargs.mode == QueryArgs::nearest && m_aabbquery != nullptr)
+        {
+            // Nearest neighbors may be farther than half the box, so all
+            // images are searched.
+            m_images = m_aabbquery->computeImageList(m_qargs.r_max, false, query_points, n_query_points);
+        }
+    }
+
+    //! Call the visitor on every neighbor of query point i.
+    /*! All bonds of a query point are visited sequentially by the calling
+     *  thread.
+     *
+     *  \param i Index of the query point.
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor> void visit(unsigned int i, const Visitor& visitor) const
+    {
+        if (m_typed_query == nullptr)
+        {
+            visitPoint(i, i, visitor);
+        }
+        else if (m_neighbor_query != nullptr && acceptsQueryPoint(i))
+        {
+            visitPoint(i, getTypeQueryPointIndex(i), [this, i, &visitor](const NeighborBond& nb) {
+                NeighborBond bond(nb);
+                bond.query_point_idx = i;
+                if (m_type_indices != nullptr)
+                {
+                    bond.point_idx = m_type_indices[nb.point_idx];
+                }
+                visitor(bond);
+            });
+        }
+    }
+
+    //! Call the visitor on every neighbor of the query points of steps [begin, end) of a loop.
+    /*! This is equivalent to calling visit(getQueryPointIndex(k), visitor)
+     *  for every step k, except that ball queries on an AABBQuery group
+     *  consecutive query points into packets that traverse the tree
+     *  together (see AABBQuery::visitBallPacket), as long as the points of
+     *  a packet lie within a cube whose side is twice r_max. Consecutive
+     *  query points are usually nearby only if they are spatially sorted.
+     *  Ball queries on a LinkCell with several query points per cell group
+     *  the consecutive query points of each cell into packets that search
+     *  the cells together (see LinkCell::visitBallPacket).
+     *  The bonds of each query point are visited in the same order, but the
+     *  bonds of query points in the same packet are interleaved.
+     *
+     *  \param begin First step of the loop.
+     *  \param end One past the last step of the loop.
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor> void visitSteps(size_t begin, size_t end, const Visitor& visitor) const
+    {
+        if (!m_query_cells.empty())
+        {
+            visitCellPackets(begin, end, visitor);
+            return;
+        }
+        if (m_qargs.mode != QueryArgs::ball || m_aabbquery == nullptr || m_typed_query != nullptr)
+        {
+            for (size_t k = begin; k != end; ++k)
+            {
+                visit(getQueryPointIndex(k), visitor);
+            }
+            return;
+        }
+
+        const float max_extent = 2 * m_qargs.r_max;
+        unsigned int packet[AABBQuery::PACKET_SIZE];
+        size_t k = begin;
+        while (k != end)
+        {
+            // Grow the packet while its query points fit in a cube whose side
+            // is the diameter of the query ball.
+            unsigned int packet_size = 0;
+            packet[packet_size++] = getQueryPointIndex(k++);
+            vec3<float> lower(m_query_points[packet[0]]);
+            vec3<float> upper(lower);
+            while (packet_size < AABBQuery::PACKET_SIZE && k != end)
+            {
+                const unsigned int i = getQueryPointIndex(k);
+                const vec3<float>& point = m_query_points[i];
+                const vec3<float> new_lower(std::min(lower.x, point.x), std::min(lower.y, point.y),
+                                            std::min(lower.z, point.z));
+                const vec3<float> new_upper(std::max(upper.x, point.x), std::max(upper.y, point.y),
+                                            std::max(upper.z, point.z));
+                if (new_upper.x - new_lower.x > max_extent || new_upper.y - new_lower.y > max_extent
+                    || new_upper.z - new_lower.z > max_extent)
+                {
+                    break;
+                }
+                lower = new_lower;
+                upper = new_upper;
+                packet[packet_size++] = i;
+                ++k;
+            }
+
+            if (packet_size == 1)
+            {
+                m_aabbquery->visitBall(m_images, m_query_points[packet[0]], packet[0], m_qargs.r_max,
+                                       m_qargs.r_min, m_qargs.exclude_ii, m_qargs.half, visitor);
+            }
+            else
+            {
+                m_aabbquery->visitBallPacket(m_images, m_query_points, packet, packet_size, m_qargs.r_max,
+                                             m_qargs.r_min, m_qargs.exclude_ii, m_qargs.half, visitor);
+            }
+        }
+    }
+
+    //! Count the neighbors of query point i in a ball query, stopping once max_count are found.
+    /*! This uses the countBall kernels of LinkCell and AABBQuery, and stops
+     *  the per-point iterators of other objects early.
+     *
+     *  \param i Index of the query point.
+     *  \param max_count Number of neighbors after which to stop searching.
+     *  \returns The number of neighbors found, at most max_count.
+     */
+    unsigned int count(unsigned int i, unsigned int max_count) const
+    {
+        unsigned int query_point_idx = i;
+        if (m_typed_query != nullptr)
+        {
+            if (m_neighbor_query == nullptr || !acceptsQueryPoint(i))
+            {
+                return 0;
+            }
+            query_point_idx = getTypeQueryPointIndex(i);
+        }
+        if (m_linkcell != nullptr)
+        {
+            return m_linkcell->countBall(m_stencil, m_query_points[i], query_point_idx, m_qargs.r_max,
+                                         m_qargs.r_min, m_qargs.exclude_ii, m_qargs.half, max_count);
+        }
+        if (m_aabbquery != nullptr)
+        {
+            return m_aabbquery->countBall(m_images, m_query_points[i], query_point_idx, m_qargs.r_max,
+                                          m_qargs.r_min, m_qargs.exclude_ii, m_qargs.half, max_count);
+        }
+        unsigned int count = 0;
+        std::shared_ptr<NeighborQueryPerPointIterator> it
+            = m_neighbor_query->querySingle(m_query_points[i], query_point_idx, untypedQueryArgs());
+        while (count < max_count)
+        {
+            it->next();
+            if (it->end())
+            {
+                break;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    //! Get the index of the query point to visit at step k of a loop over all query points.
+    unsigned int getQueryPointIndex(size_t k) const
+    {
+        return (m_query_order != nullptr) ? m_query_order[k] : static_cast<unsigned int>(k);
+    }
+
+    //! Get the resolved query arguments.
+    const QueryArgs& getQueryArgs() const
+    {
+        return m_qargs;
+    }
+
+private:
+    //! Call the visitor on every neighbor of query point i, found with the given query point index.
+    /*! \param i Index of the query point.
+     *  \param query_point_idx Index of the query point passed to the kernels,
+     *         which is different from i for queries filtered by point type.
+     *  \param visitor An object with operator()(const NeighborBond&).
+     */
+    template<typename Visitor>
+    void visitPoint(unsigned int i, unsigned int query_point_idx, const Visitor& visitor) const
+    {
+        if (m_qargs.mode == QueryArgs::nearest && (m_linkcell != nullptr || m_aabbquery != nullptr))
+        {
+            std::vector<NeighborBond> neighbors;
+            if (m_linkcell != nullptr)
+            {
+                m_linkcell->findNearest(m_query_points[i], query_point_idx, m_qargs.num_neighbors,
+                                        m_qargs.r_max, m_qargs.r_min, m_qargs.exclude_ii, neighbors);
+            }
+            else
+            {
+                m_aabbquery->findNearest(m_images, m_query_points[i], query_point_idx, m_qargs.num_neighbors,
+                                         m_qargs.r_max, m_qargs.r_min, m_qargs.exclude_ii, neighbors);
+            }
+            for (const NeighborBond& nb : neighbors)
+            {
+                visitor(nb);
+            }
+        }
+        else if (m_linkcell != nullptr)
+        {
+            m_linkcell->visitBall(m_stencil, m_query_points[i], query_point_idx, m_qargs.r_max, m_qargs.r_min,
+                                  m_qargs.exclude_ii, m_qargs.half, visitor);
+        }
+        else if (m_aabbquery != nullptr)
+        {
+            m_aabbquery->visitBall(m_images, m_query_points[i], query_point_idx, m_qargs.r_max, m_qargs.r_min,
+                                   m_qargs.exclude_ii, m_qargs.half, visitor);
+        }
+        else
+        {
+            std::shared_ptr<NeighborQueryPerPointIterator> it
+                = m_neighbor_query->querySingle(m_query_points[i], query_point_idx, untypedQueryArgs());
+            for (NeighborBond nb = it->next(); !it->end(); nb = it->next())
+            {
+                visitor(nb);
+            }
+        }
+    }
+
+    //! Whether query point i is visited by a query filtered by the type of the query points.
+    bool acceptsQueryPoint(unsigned int i) const
+    {
+        return m_qargs.query_point_type == QueryArgs::ANY_TYPE
+            || m_typed_query->getPointTypes()[i] == m_qargs.query_point_type;
+    }
+
+    //! Get the index of query point i in queries of the data structure of the queried point type.
+    unsigned int getTypeQueryPointIndex(unsigned int i) const
+    {
+        return (m_type_indices == nullptr) ? i : m_typed_query->getIndexInType(i, m_qargs.point_type);
+    }
+
+    //! Get the query arguments without type filters, for queries of the data structure of one type.
+    QueryArgs untypedQueryArgs() const
+    {
+        QueryArgs args(m_qargs);
+        args.point_type = QueryArgs::ANY_TYPE;
+        args.query_point_type = QueryArgs::ANY_TYPE;
+        return args;
+    }
+
+    //! Visit steps [begin, end) of a LinkCell ball query in packets of consecutive query points per cell.
+    template<typename Visitor> void visitCellPackets(size_t begin, size_t end, const Visitor& visitor) const
+    {
+        unsigned int packet[LinkCell::PACKET_SIZE];
+        size_t k = begin;
+        while (k != end)
+        {
+            unsigned int packet_size = 0;
+            packet[packet_size++] = getQueryPointIndex(k++);
+            const unsigned int cell = m_query_cells[packet[0]];
+            while (packet_size < LinkCell::PACKET_SIZE && k != end
+                   && m_query_cells[getQueryPointIndex(k)] == cell)
+            {
+                packet[packet_size++] = getQueryPointIndex(k++);
+            }
+
+            if (packet_size == 1)
+            {
+                m_linkcell->visitBall(m_stencil, m_query_points[packet[0]], packet[0], m_qargs.r_max,
+                                      m_qargs.r_min, m_qargs.exclude_ii, false, visitor);
+            }
+            else
+            {
+                m_linkcell->visitBallPacket(m_stencil, m_query_points, packet, packet_size, m_qargs.r_max,
+                                            m_qargs.r_min, m_qargs.exclude_ii, visitor);
+            }
+        }
+    }
+
+    const vec3<float>* m_query_points;       //!< Coordinates of the query points.
+    const NeighborQuery* m_neighbor_query;   //!< The NeighborQuery performing the fallback queries.
+    QueryArgs m_qargs;                       //!< The resolved query arguments.
+    const LinkCell* m_linkcell;              //!< Set if the specialized LinkCell kernels are used.
+    const AABBQuery* m_aabbquery;            //!< Set if the specialized AABBQuery kernels are used.
+    LinkCell::BallStencil m_stencil;         //!< Cell stencil for LinkCell ball queries.
+    AABBQuery::ImageList m_images;           //!< Periodic images for AABBQuery queries.
+    const unsigned int* m_query_order;       //!< Traversal order of the query points, if any.
+    std::vector<unsigned int> m_query_cells; //!< LinkCell cell of each query point, if packets are used.
+    std::vector<unsigned int> m_cell_order;  //!< Query point indices sorted by LinkCell cell.
+    const NeighborQuery* m_typed_query;      //!< The NeighborQuery with point types, if filtered by type.
+    const unsigned int* m_type_indices;      //!< Indices of the points of the queried type, if any.
+};
+
+//! Call a visitor on every bond found by a query.
+/*! This is the visitor-style counterpart to NeighborQuery::query. Query
+ *  points are processed in parallel, and all bonds of a given query point are
+ *  visited sequentially by one thread, so the visitor must be thread-safe
+ *  across query points. The bonds of nearby query points may be interleaved
+ *  (see DirectNeighborQuery::visitSteps).
+ *
+ *  \param neighbor_query NeighborQuery object to iterate over.
+ *  \param query_points Query points to perform computation on.
+ *  \param n_query_points Number of query_points.
+ *  \param qargs Query arguments.
+ *  \param visitor An object with operator()(const NeighborBond&).
+ *  \param parallel If true, process query points in parallel.
+ */
+template<typename Visitor>
+void forEachNeighbor(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                     unsigned int n_query_points, QueryArgs qargs, const Visitor& visitor,
+                     bool parallel = true)
+{
+    util::profiling::ScopedTimer timer("NeighborQuery::forEachNeighbor");
+    const DirectNeighborQuery query(neighbor_query, query_points, n_query_points, qargs);
+    util::forLoopWrapper(
+        0, n_query_points,
+        [&query, &visitor](size_t begin, size_t end) {
+            util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+            query.visitSteps(begin, end, [&bonds_visited, &visitor](const NeighborBond& nb) {
+                bonds_visited.add();
+                visitor(nb);
+            });
+        },
+        parallel);
+}
+
 //! Wrapper iterating looping over NeighborQuery or NeighborList.
 /*! This function dynamically determines whether or not the provided
  *  NeighborList is valid. If it is, it applies the provide compute function to
@@ -102,6 +651,9 @@ private:
  *  both a query_point index and a NeighborPerPointIterator that provides the
  *  neighbors of that query_point.
  *
+ *  As in loopOverNeighbors, the bonds returned by the iterator include the
+ *  bond vector.
+ *
  *  \param neighbor_query NeighborQuery object to iterate over.
  *  \param query_points Query points to perform computation on.
  *  \param n_query_points Number of query_points.
@@ -109,43 +661,59 @@ private:
  *  \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query appropriately with
  * given qargs. \param cf An object with operator(size_t point_index, std::shared_ptr<NeighborIterator>) as
  * input. It should implement iteration logic over the iterator.
+ *  \param parallel If true, process query points in parallel.
+ *  \param schedule How to split the query points among threads. The balanced
+ *         partitioner uses the neighbor counts of the NeighborList as the cost
+ *         of each query point.
  */
 template<typename ComputePairType>
 void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
                                unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist,
-                               const ComputePairType& cf, bool parallel = true)
+                               const ComputePairType& cf, bool parallel = true,
+                               const util::LoopSchedule& schedule = util::LoopSchedule())
 {
     // check if nlist exists
     if (nlist != NULL)
     {
+        util::profiling::ScopedTimer timer("NeighborList::forEachPoint");
+        util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+        bonds_visited.add(nlist->getNumBonds());
         util::forLoopWrapper(
             0, n_query_points,
             [=](size_t begin, size_t end) {
                 for (size_t i = begin; i != end; ++i)
                 {
                     std::shared_ptr<NeighborListPerPointIterator> niter
-                        = std::make_shared<NeighborListPerPointIterator>(nlist, i);
+                        = std::make_shared<NeighborListPerPointIterator>(nlist, i, neighbor_query,
+                                                                         query_points);
                     cf(i, niter);
                 }
             },
-            parallel);
+            schedule, parallel, nlist->getCounts().get());
     }
     else
     {
-        std::shared_ptr<NeighborQueryIterator> iter
-            = neighbor_query->query(query_points, n_query_points, qargs);
+        util::profiling::ScopedTimer timer("NeighborQuery::forEachPoint");
+        const DirectNeighborQuery query(neighbor_query, query_points, n_query_points, qargs);
 
-        // iterate over the query object in parallel
+        // iterate over the query object in parallel, gathering the bonds of
+        // each point into a per-chunk iterator that is reused for all points
         util::forLoopWrapper(
             0, n_query_points,
-            [=](size_t begin, size_t end) {
-                for (size_t i = begin; i != end; ++i)
+            [&query, &cf](size_t begin, size_t end) {
+                std::shared_ptr<NeighborVectorPerPointIterator> it
+                    = std::make_shared<NeighborVectorPerPointIterator>();
+                util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+                for (size_t k = begin; k != end; ++k)
                 {
-                    std::shared_ptr<NeighborQueryPerPointIterator> it = iter->query(i);
+                    const unsigned int i = query.getQueryPointIndex(k);
+                    it->reset(i);
+                    query.visit(i, NeighborBondAppender(it->getBonds()));
+                    bonds_visited.add(it->getBonds().size());
                     cf(i, it);
                 }
             },
-            parallel);
+            schedule, parallel);
     }
 }
 
@@ -163,6 +731,9 @@ void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<f
  *  for the NeighborList vs NeighborQuery code paths are handled in helper
  *  functions.
  *
+ *  The bonds passed to the compute function always include the bond vector,
+ *  so computes should use NeighborBond::vector rather than recomputing it.
+ *
  *  \param neighbor_query NeighborQuery object to iterate over.
  *  \param query_points Query points to perform computation on.
  *  \param n_query_points Number of query_points.
@@ -178,13 +749,18 @@ void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* q
     // check if nlist exists
     if (nlist != NULL)
     {
+        util::profiling::ScopedTimer timer("NeighborList::forEachBond");
+        util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+        bonds_visited.add(nlist->getNumBonds());
         util::forLoopWrapper(
             0, nlist->getNumBonds(),
             [=](size_t begin, size_t end) {
                 for (size_t bond = begin; bond != end; ++bond)
                 {
-                    const NeighborBond nb(nlist->getNeighbors()(bond, 0), nlist->getNeighbors()(bond, 1),
-                                          nlist->getDistances()[bond], nlist->getWeights()[bond]);
+                    const NeighborBond nb(nlist->getQueryPointIndices()[bond],
+                                          nlist->getPointIndices()[bond], nlist->getDistances()[bond],
+                                          nlist->getWeights()[bond],
+                                          bondVector(nlist, bond, neighbor_query, query_points));
                     cf(nb);
                 }
             },
@@ -192,29 +768,248 @@ void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* q
     }
     else
     {
-        std::shared_ptr<NeighborQueryIterator> iter
-            = neighbor_query->query(query_points, n_query_points, qargs);
+        forEachNeighbor(neighbor_query, query_points, n_query_points, qargs, cf, parallel);
+    }
+}
+
+//! Wrapper looping over the bonds of a CompressedNeighborList.
+/*! This is the counterpart of loopOverNeighbors for compressed lists. The
+ *  bonds of the query points are decompressed in parallel as they are
+ *  visited, so the list is never expanded into a NeighborList. The bonds of
+ *  each query point are visited sequentially by one thread, and include the
+ *  bond vector, computed from the points.
+ *
+ *  \param neighbor_query NeighborQuery of the points of the list.
+ *  \param query_points Query points of the list.
+ *  \param n_query_points Number of query_points.
+ *  \param nlist The compressed NeighborList.
+ *  \param cf An object with operator(NeighborBond) as input.
+ *  \param parallel If true, process query points in parallel.
+ */
+template<typename ComputePairType>
+void loopOverNeighbors(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                       unsigned int n_query_points, const CompressedNeighborList& nlist,
+                       const ComputePairType& cf, bool parallel = true)
+{
+    nlist.validate(neighbor_query, n_query_points);
+    util::profiling::ScopedTimer timer("CompressedNeighborList::forEachBond");
+    util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+    bonds_visited.add(nlist.getNumBonds());
+    util::forLoopWrapper(
+        0, n_query_points,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i != end; ++i)
+            {
+                nlist.forEachBond(static_cast<unsigned int>(i), neighbor_query, query_points, cf);
+            }
+        },
+        parallel);
+}
 
-        // iterate over the query object in parallel
+//! Wrapper iterating over the bonds of each query point of a CompressedNeighborList.
+/*! This is the counterpart of loopOverNeighborsIterator for compressed
+ *  lists. The bonds of each query point are decompressed into the buffer of
+ *  a NeighborVectorPerPointIterator that is reused for all query points of a
+ *  block, so the compute function sees the same interface as for
+ *  NeighborLists.
+ *
+ *  \param neighbor_query NeighborQuery of the points of the list.
+ *  \param query_points Query points of the list.
+ *  \param n_query_points Number of query_points.
+ *  \param nlist The compressed NeighborList.
+ *  \param cf An object with operator(size_t point_index, std::shared_ptr<NeighborPerPointIterator>).
+ *  \param parallel If true, process query points in parallel.
+ */
+template<typename ComputePairType>
+void loopOverNeighborsIterator(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                               unsigned int n_query_points, const CompressedNeighborList& nlist,
+                               const ComputePairType& cf, bool parallel = true)
+{
+    nlist.validate(neighbor_query, n_query_points);
+    util::profiling::ScopedTimer timer("CompressedNeighborList::forEachPoint");
+    util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+    bonds_visited.add(nlist.getNumBonds());
+    util::forLoopWrapper(
+        0, n_query_points,
+        [&](size_t begin, size_t end) {
+            std::shared_ptr<NeighborVectorPerPointIterator> it
+                = std::make_shared<NeighborVectorPerPointIterator>();
+            for (size_t i = begin; i != end; ++i)
+            {
+                it->reset(static_cast<unsigned int>(i));
+                nlist.forEachBond(static_cast<unsigned int>(i), neighbor_query, query_points,
+                                  NeighborBondAppender(it->getBonds()));
+                cf(i, it);
+            }
+        },
+        parallel);
+}
+
+//! Wrapper looping over blocks of bonds from a NeighborQuery or NeighborList.
+/*! This function is a variant of loopOverNeighbors for computes that keep
+ *  state for each block of work of the parallel loop, such as privatized
+ *  copies of their outputs. For each block, make_block is called on the
+ *  thread processing the block to create a block object, which is called for
+ *  every bond of the block. Its finish method is called once all bonds of the
+ *  block have been processed.
+ *
+ *  \param neighbor_query NeighborQuery object to iterate over.
+ *  \param query_points Query points to perform computation on.
+ *  \param n_query_points Number of query_points.
+ *  \param qargs Query arguments.
+ *  \param nlist Neighbor List. If not NULL, loop over it. Otherwise, use neighbor_query appropriately with
+ * given qargs. \param make_block A function returning an object with operator()(const NeighborBond&) and
+ * finish().
+ */
+template<typename BlockFactory>
+void loopOverNeighborBlocks(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                            unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist,
+                            const BlockFactory& make_block, bool parallel = true)
+{
+    // check if nlist exists
+    if (nlist != NULL)
+    {
+        util::profiling::ScopedTimer timer("NeighborList::forEachBond");
+        util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+        bonds_visited.add(nlist->getNumBonds());
         util::forLoopWrapper(
-            0, n_query_points,
-            [&iter, &cf](size_t begin, size_t end) {
-                NeighborBond nb;
-                for (size_t i = begin; i != end; ++i)
+            0, nlist->getNumBonds(),
+            [=, &make_block](size_t begin, size_t end) {
+                auto block = make_block();
+                for (size_t bond = begin; bond != end; ++bond)
                 {
-                    std::shared_ptr<NeighborQueryPerPointIterator> it = iter->query(i);
-                    nb = it->next();
-                    while (!it->end())
-                    {
-                        cf(nb);
-                        nb = it->next();
-                    }
+                    const NeighborBond nb(nlist->getQueryPointIndices()[bond],
+                                          nlist->getPointIndices()[bond], nlist->getDistances()[bond],
+                                          nlist->getWeights()[bond],
+                                          bondVector(nlist, bond, neighbor_query, query_points));
+                    block(nb);
                 }
+                block.finish();
+            },
+            parallel);
+    }
+    else
+    {
+        util::profiling::ScopedTimer timer("NeighborQuery::forEachNeighbor");
+        const DirectNeighborQuery query(neighbor_query, query_points, n_query_points, qargs);
+        util::forLoopWrapper(
+            0, n_query_points,
+            [&query, &make_block](size_t begin, size_t end) {
+                auto block = make_block();
+                util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+                query.visitSteps(begin, end, [&bonds_visited, &block](const NeighborBond& nb) {
+                    bonds_visited.add();
+                    block(nb);
+                });
+                block.finish();
             },
             parallel);
     }
 }
 
+//! Bytes of a NeighborList per bond: the indices, the distance, the weight and the vector.
+const size_t NEIGHBOR_LIST_BOND_BYTES = 2 * sizeof(unsigned int) + 2 * sizeof(float) + sizeof(vec3<float>);
+
+//! Bytes of a NeighborList per query point: the segment and the neighbor count.
+const size_t NEIGHBOR_LIST_QUERY_POINT_BYTES = sizeof(size_t) + sizeof(unsigned int);
+
+//! Estimate the mean number of bonds of each query point found by a query.
+/*! Ball queries are assumed to find the points of the volume between r_min
+ *  and r_max at the mean density of the points in the box, and nearest
+ *  neighbor queries are assumed to find num_neighbors points unless fewer
+ *  are expected within r_max. The estimate is halved for half queries and
+ *  is at most the number of points.
+ *
+ *  \param nq NeighborQuery object to query.
+ *  \param qargs Query arguments.
+ */
+float estimateBondsPerQueryPoint(const NeighborQuery* nq, QueryArgs qargs);
+
+//! Estimate the number of bytes of the NeighborList found by a query.
+/*! \param nq NeighborQuery object to query.
+ *  \param n_query_points Number of query points.
+ *  \param qargs Query arguments.
+ */
+size_t estimateNeighborListBytes(const NeighborQuery* nq, unsigned int n_query_points, QueryArgs qargs);
+
+//! Find the NeighborList of a subset of the query points of a query.
+/*! The bonds are found in parallel and sorted as by
+ *  NeighborQueryIterator::toNeighborList. Query point indices are those of
+ *  all query points of the query, and the NeighborList has the number of
+ *  query points of the query, so points outside the subset have no bonds.
+ *
+ *  \param query The query.
+ *  \param n_query_points Number of query points of the query.
+ *  \param n_points Number of points of the query.
+ *  \param indices Indices of the query points of the subset, in increasing order.
+ *  \return A new NeighborList owned by the caller.
+ */
+NeighborList* queryNeighborListChunk(const DirectNeighborQuery& query, unsigned int n_query_points,
+                                     unsigned int n_points, const std::vector<unsigned int>& indices);
+
+//! Loop over the neighbors of chunks of query points within a memory budget.
+/*! Computes that need the bonds of their query points as a NeighborList can
+ *  call this function to build, consume and discard the NeighborLists of
+ *  chunks of query points one at a time, instead of building the
+ *  NeighborList of all query points. The query points are traversed in the
+ *  order of the steps of a DirectNeighborQuery, which is spatial when the
+ *  points are spatially sorted or the query searches cells, so the bonds of
+ *  a chunk touch nearby points.
+ *
+ *  The number of query points of each chunk is chosen so that the
+ *  NeighborList of the chunk, and the bonds it is built from, fit in the
+ *  memory budget at the number of bonds per query point estimated by
+ *  estimateBondsPerQueryPoint for the first chunk and measured so far for
+ *  later chunks. Each chunk has at least one query point, so the budget is
+ *  exceeded when a single query point has too many bonds.
+ *
+ *  \param nq NeighborQuery object to query.
+ *  \param query_points Query points to find neighbors for.
+ *  \param n_query_points Number of query_points.
+ *  \param qargs Query arguments.
+ *  \param memory_budget Bytes available for the NeighborList of a chunk.
+ *  \param func An object with operator()(const NeighborList&, const
+ *         std::vector<unsigned int>&) called with the NeighborList and the
+ *         sorted query point indices of each chunk, in sequence.
+ */
+template<typename ChunkFunc>
+void forEachNeighborListChunk(const NeighborQuery* nq, const vec3<float>* query_points,
+                              unsigned int n_query_points, QueryArgs qargs, size_t memory_budget,
+                              const ChunkFunc& func)
+{
+    const DirectNeighborQuery query(nq, query_points, n_query_points, qargs);
+
+    // The segments and counts of each chunk span all query points.
+    const size_t fixed_bytes = size_t(n_query_points) * NEIGHBOR_LIST_QUERY_POINT_BYTES;
+    const size_t chunk_budget = (memory_budget > fixed_bytes) ? memory_budget - fixed_bytes : 0;
+    auto chunk_size = [&](double bonds_per_query_point) {
+        const double bytes = bonds_per_query_point * (sizeof(NeighborBond) + NEIGHBOR_LIST_BOND_BYTES)
+            + sizeof(unsigned int);
+        return static_cast<size_t>(
+            std::max(std::min(chunk_budget / bytes, double(n_query_points)), double(1)));
+    };
+
+    std::vector<unsigned int> indices;
+    size_t size = chunk_size(estimateBondsPerQueryPoint(nq, qargs));
+    size_t num_bonds = 0;
+    for (size_t begin = 0, end = 0; begin < n_query_points; begin = end)
+    {
+        end = std::min(begin + size, size_t(n_query_points));
+        indices.resize(end - begin);
+        for (size_t k = begin; k < end; ++k)
+        {
+            indices[k - begin] = query.getQueryPointIndex(k);
+        }
+        std::sort(indices.begin(), indices.end());
+
+        std::unique_ptr<NeighborList> nlist(
+            queryNeighborListChunk(query, n_query_points, nq->getNPoints(), indices));
+        func(*nlist, indices);
+        num_bonds += nlist->getNumBonds();
+        size = chunk_size(double(num_bonds) / double(end));
+    }
+}
+
 }; }; // end namespace freud::locality
 
 #endif // NEIGHBOR_COMPUTE_FUNCTIONAL_H
@@ -1,36 +1,95 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
 #include "NeighborList.h"
+#include "utils.h"
 
 namespace freud { namespace locality {
 
+namespace {
+
+//! Number of fixed blocks of the parallel passes over bonds and query points.
+const size_t SCAN_BLOCKS = 256;
+
+//! Call body(block, begin, end) in parallel for SCAN_BLOCKS contiguous blocks of n items.
+template<typename Body> void forEachScanBlock(size_t n, const Body& body)
+{
+    const size_t block_size = (n + SCAN_BLOCKS - 1) / SCAN_BLOCKS;
+    util::forLoopWrapper(0, SCAN_BLOCKS, [&](size_t begin, size_t end) {
+        for (size_t block = begin; block < end; ++block)
+        {
+            body(block, std::min(n, block * block_size), std::min(n, (block + 1) * block_size));
+        }
+    });
+}
+
+//! Copy the elements of the source array whose keep flag is set, in order, into destination.
+/*! \param offsets The exclusive prefix sum of the numbers of kept elements in each scan block.
+ */
+template<typename T, typename Keep>
+void scatterKept(const util::ManagedArray<T>& source, util::ManagedArray<T>& destination, const Keep& keep,
+                 const std::vector<size_t>& offsets)
+{
+    const T* source_data = source.get();
+    T* destination_data = destination.get();
+    forEachScanBlock(source.size(), [&](size_t block, size_t begin, size_t end) {
+        size_t kept = offsets[block];
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            if (keep(bond))
+            {
+                destination_data[kept++] = source_data[bond];
+            }
+        }
+    });
+}
+
+//! Allocate an array without zeroing it, for data that is completely overwritten.
+template<typename T> util::ManagedArray<T> uninitializedArray(size_t size)
+{
+    util::ManagedArray<T> array;
+    array.prepareForOverwrite({size}, true);
+    return array;
+}
+
+}; // end anonymous namespace
+
 NeighborList::NeighborList()
-    : m_num_query_points(0), m_num_points(0), m_neighbors({0, 2}), m_distances(0), m_weights(0),
-      m_segments_counts_updated(false)
+    : m_num_query_points(0), m_num_points(0), m_query_point_indices(0), m_point_indices(0), m_distances(0),
+      m_weights(0), m_vectors(0), m_has_vectors(false), m_half(false), m_segments_counts_updated(false),
+      m_neighbors_updated(false), m_neighbors({0, 2})
 {}
 
-NeighborList::NeighborList(unsigned int num_bonds)
-    : m_num_query_points(0), m_num_points(0), m_neighbors({num_bonds, 2}), m_distances(num_bonds),
-      m_weights(num_bonds), m_segments_counts_updated(false)
+NeighborList::NeighborList(size_t num_bonds)
+    : m_num_query_points(0), m_num_points(0), m_query_point_indices(num_bonds), m_point_indices(num_bonds),
+      m_distances(num_bonds), m_weights(num_bonds), m_vectors(0), m_has_vectors(false), m_half(false),
+      m_segments_counts_updated(false), m_neighbors_updated(false), m_neighbors({0, 2})
 {}
 
 NeighborList::NeighborList(const NeighborList& other)
-    : m_num_query_points(other.m_num_query_points), m_num_points(other.m_num_points),
-      m_segments_counts_updated(false)
+    : m_num_query_points(other.m_num_query_points), m_num_points(other.m_num_points), m_has_vectors(false),
+      m_half(false), m_segments_counts_updated(false), m_neighbors_updated(false)
 {
     copy(other);
 }
 
-NeighborList::NeighborList(unsigned int num_bonds, const unsigned int* query_point_index,
+NeighborList::NeighborList(size_t num_bonds, const unsigned int* query_point_index,
                            unsigned int num_query_points, const unsigned int* point_index,
                            unsigned int num_points, const float* distances, const float* weights)
-    : m_num_query_points(num_query_points), m_num_points(num_points), m_neighbors({num_bonds, 2}),
-      m_distances(num_bonds), m_weights(num_bonds), m_segments_counts_updated(false)
+    : m_num_query_points(num_query_points), m_num_points(num_points), m_query_point_indices(num_bonds),
+      m_point_indices(num_bonds), m_distances(num_bonds), m_weights(num_bonds), m_vectors(0),
+      m_has_vectors(false), m_half(false), m_segments_counts_updated(false), m_neighbors_updated(false),
+      m_neighbors({0, 2})
 {
     unsigned int last_index(0);
     unsigned int index(0);
-    for (unsigned int i = 0; i < num_bonds; i++)
+    for (size_t i = 0; i < num_bonds; i++)
     {
         index = query_point_index[i];
         if (index < last_index)
@@ -40,17 +99,18 @@ NeighborList::NeighborList(unsigned int num_bonds, const unsigned int* query_poi
                 "NeighborList query_point_index values must be less than num_query_points.");
         if (point_index[i] >= m_num_points)
             throw std::runtime_error("NeighborList point_index values must be less than num_points.");
-        m_neighbors(i, 0) = index;
-        m_neighbors(i, 1) = point_index[i];
+        m_query_point_indices[i] = index;
+        m_point_indices[i] = point_index[i];
         m_weights[i] = weights[i];
         m_distances[i] = distances[i];
         last_index = index;
     }
+    updateSegmentCounts();
 }
 
-unsigned int NeighborList::getNumBonds() const
+size_t NeighborList::getNumBonds() const
 {
-    return m_neighbors.shape()[0];
+    return m_query_point_indices.size();
 }
 
 unsigned int NeighborList::getNumQueryPoints() const
@@ -63,12 +123,12 @@ unsigned int NeighborList::getNumPoints() const
     return m_num_points;
 }
 
-void NeighborList::setNumBonds(unsigned int num_bonds, unsigned int num_query_points, unsigned int num_points)
+void NeighborList::setNumBonds(size_t num_bonds, unsigned int num_query_points, unsigned int num_points)
 {
     resize(num_bonds);
     m_num_query_points = num_query_points;
     m_num_points = num_points;
-    m_segments_counts_updated = false;
+    invalidateDerivedArrays();
 }
 
 void NeighborList::updateSegmentCounts() const
@@ -77,106 +137,206 @@ void NeighborList::updateSegmentCounts() const
     {
         m_counts.prepare(m_num_query_points);
         m_segments.prepare(m_num_query_points);
-        int index(-1);
-        int last_index(-1);
-        unsigned int counter(0);
-        for (unsigned int i = 0; i < getNumBonds(); i++)
-        {
-            index = m_neighbors(i, 0);
-            if (index != last_index)
+        const size_t num_bonds = getNumBonds();
+        const unsigned int* query_point_indices = m_query_point_indices.get();
+        unsigned int* counts = m_counts.get();
+        size_t* segments = m_segments.get();
+
+        // Each query point's bonds form one contiguous run, which is measured
+        // by the block containing its first bond.
+        std::atomic<bool> sorted(true);
+        std::atomic<bool> in_range(true);
+        forEachScanBlock(num_bonds, [&](size_t, size_t begin, size_t end) {
+            for (size_t bond = begin; bond < end; ++bond)
             {
-                m_segments[index] = i;
-                if (index > 0)
+                const unsigned int index = query_point_indices[bond];
+                if (bond != 0 && query_point_indices[bond - 1] == index)
+                {
+                    continue;
+                }
+                if (index >= m_num_query_points)
+                {
+                    in_range.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                if (bond != 0 && query_point_indices[bond - 1] > index)
+                {
+                    sorted.store(false, std::memory_order_relaxed);
+                }
+                size_t run_end = bond + 1;
+                while (run_end < num_bonds && query_point_indices[run_end] == index)
                 {
-                    if (last_index >= 0)
-                    {
-                        m_counts[last_index] = counter;
-                    }
-                    counter = 0;
+                    ++run_end;
                 }
+                segments[index] = bond;
+                counts[index] = static_cast<unsigned int>(run_end - bond);
             }
-            last_index = index;
-            counter++;
+        });
+
+        if (!in_range.load())
+        {
+            throw std::invalid_argument(
+                "NeighborList query point indices must be less than the number of query points.");
         }
-        if (last_index >= 0)
+
+        // When the runs are sorted, the segments are the prefix sums of the
+        // counts, which also gives query points without bonds the index
+        // where their bonds would be.
+        if (sorted.load())
         {
-            m_counts[last_index] = counter;
+            std::vector<size_t> block_sums(SCAN_BLOCKS + 1, 0);
+            forEachScanBlock(m_num_query_points, [&](size_t block, size_t begin, size_t end) {
+                block_sums[block + 1] = std::accumulate(counts + begin, counts + end, size_t(0));
+            });
+            std::partial_sum(block_sums.begin(), block_sums.end(), block_sums.begin());
+            forEachScanBlock(m_num_query_points, [&](size_t block, size_t begin, size_t end) {
+                size_t sum = block_sums[block];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    segments[i] = sum;
+                    sum += counts[i];
+                }
+            });
         }
         m_segments_counts_updated = true;
     }
 }
 
-unsigned int NeighborList::filter(const bool* filt)
+const util::ManagedArray<unsigned int>& NeighborList::getNeighbors() const
 {
-    // number of good (unfiltered-out) elements so far
-    unsigned int num_good(0);
-    const unsigned int old_size(getNumBonds());
-
-    for (unsigned int i(0); i < old_size; ++i)
+    if (!m_neighbors_updated || m_neighbors.shape()[0] != getNumBonds())
     {
-        if (filt[i])
+        const size_t num_bonds = getNumBonds();
+        m_neighbors.prepare({num_bonds, 2});
+        for (size_t i = 0; i < num_bonds; ++i)
         {
-            m_neighbors(num_good, 0) = m_neighbors(i, 0);
-            m_neighbors(num_good, 1) = m_neighbors(i, 1);
-            m_weights[num_good] = m_weights[i];
-            m_distances[num_good] = m_distances[i];
-            ++num_good;
+            m_neighbors(i, 0) = m_query_point_indices[i];
+            m_neighbors(i, 1) = m_point_indices[i];
         }
+        m_neighbors_updated = true;
     }
-    resize(num_good);
-    return old_size - num_good;
+    return m_neighbors;
 }
 
-unsigned int NeighborList::filter_r(float r_max, float r_min)
+void NeighborList::setHasVectors(bool has_vectors)
 {
-    // Can't use vector<bool> because that is specialized for compact storage
-    std::unique_ptr<bool[]> dist_filter(new bool[getNumBonds()]);
-    for (unsigned int i(0); i < getNumBonds(); ++i)
+    m_has_vectors = has_vectors;
+    m_vectors = util::ManagedArray<vec3<float>>(has_vectors ? getNumBonds() : 0);
+}
+
+template<typename Keep> size_t NeighborList::filterBonds(const Keep& keep)
+{
+    const size_t old_size(getNumBonds());
+
+    // Count the kept bonds of each block, then copy them to the offsets given
+    // by the prefix sum of the counts.
+    std::vector<size_t> offsets(SCAN_BLOCKS + 1, 0);
+    forEachScanBlock(old_size, [&](size_t block, size_t begin, size_t end) {
+        size_t kept = 0;
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            kept += keep(bond) ? 1 : 0;
+        }
+        offsets[block + 1] = kept;
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    const size_t num_good = offsets[SCAN_BLOCKS];
+    if (num_good == old_size)
     {
-        dist_filter[i] = (m_distances[i] >= r_min && m_distances[i] < r_max);
+        return 0;
     }
-    return filter(dist_filter.get());
+
+    // The kept bonds are written to new arrays, since blocks would otherwise
+    // overwrite bonds of earlier blocks that have not been read yet.
+    auto new_query_point_indices = uninitializedArray<unsigned int>(num_good);
+    auto new_point_indices = uninitializedArray<unsigned int>(num_good);
+    auto new_distances = uninitializedArray<float>(num_good);
+    auto new_weights = uninitializedArray<float>(num_good);
+    auto new_vectors = uninitializedArray<vec3<float>>(m_has_vectors ? num_good : 0);
+    scatterKept(m_query_point_indices, new_query_point_indices, keep, offsets);
+    scatterKept(m_point_indices, new_point_indices, keep, offsets);
+    scatterKept(m_distances, new_distances, keep, offsets);
+    scatterKept(m_weights, new_weights, keep, offsets);
+    if (m_has_vectors)
+    {
+        scatterKept(m_vectors, new_vectors, keep, offsets);
+    }
+
+    m_query_point_indices = new_query_point_indices;
+    m_point_indices = new_point_indices;
+    m_distances = new_distances;
+    m_weights = new_weights;
+    m_vectors = new_vectors;
+    invalidateDerivedArrays();
+    updateSegmentCounts();
+    return old_size - num_good;
 }
 
-unsigned int NeighborList::find_first_index(unsigned int i) const
+size_t NeighborList::filter(const bool* filt)
 {
-    if (getNumBonds())
-        return bisection_search(i, 0, getNumBonds()) + (i > m_neighbors(0, 0));
-    else
-        return 0;
+    return filterBonds([filt](size_t bond) { return filt[bond]; });
 }
 
-void NeighborList::resize(unsigned int num_bonds)
+size_t NeighborList::filter_r(float r_max, float r_min)
 {
-    auto new_neighbors = util::ManagedArray<unsigned int>({num_bonds, 2});
-    auto new_distances = util::ManagedArray<float>(num_bonds);
-    auto new_weights = util::ManagedArray<float>(num_bonds);
+    const float* distances = m_distances.get();
+    return filterBonds([distances, r_max, r_min](size_t bond) {
+        return distances[bond] >= r_min && distances[bond] < r_max;
+    });
+}
 
-    // On shrinking resizes, keep existing data.
+size_t NeighborList::find_first_index(unsigned int i) const
+{
+    if (i >= m_num_query_points)
+    {
+        return getNumBonds();
+    }
+    if (m_segments_counts_updated)
+    {
+        return m_segments.get()[i];
+    }
+    // Search without updating the segments, which may be called concurrently.
+    const unsigned int* query_point_indices = m_query_point_indices.get();
+    return std::lower_bound(query_point_indices, query_point_indices + getNumBonds(), i)
+        - query_point_indices;
+}
+
+void NeighborList::resize(size_t num_bonds)
+{
+    // On shrinking resizes, keep existing data in place.
     if (num_bonds <= getNumBonds())
     {
-        for (unsigned int i = 0; i < num_bonds; i++)
+        m_query_point_indices.shrink(num_bonds);
+        m_point_indices.shrink(num_bonds);
+        m_distances.shrink(num_bonds);
+        m_weights.shrink(num_bonds);
+        if (m_has_vectors)
         {
-            new_neighbors(i, 0) = m_neighbors(i, 0);
-            new_neighbors(i, 1) = m_neighbors(i, 1);
-            new_distances[i] = m_distances[i];
-            new_weights[i] = m_weights[i];
+            m_vectors.shrink(num_bonds);
         }
     }
-
-    m_neighbors = new_neighbors;
-    m_distances = new_distances;
-    m_weights = new_weights;
-    m_segments_counts_updated = false;
+    else
+    {
+        m_query_point_indices = util::ManagedArray<unsigned int>(num_bonds);
+        m_point_indices = util::ManagedArray<unsigned int>(num_bonds);
+        m_distances = util::ManagedArray<float>(num_bonds);
+        m_weights = util::ManagedArray<float>(num_bonds);
+        m_vectors = util::ManagedArray<vec3<float>>(m_has_vectors ? num_bonds : 0);
+    }
+    invalidateDerivedArrays();
 }
 
 void NeighborList::copy(const NeighborList& other)
 {
+    m_has_vectors = other.m_has_vectors;
+    m_half = other.m_half;
     setNumBonds(other.getNumBonds(), other.getNumQueryPoints(), other.getNumPoints());
-    m_neighbors = other.m_neighbors.copy();
+    m_query_point_indices = other.m_query_point_indices.copy();
+    m_point_indices = other.m_point_indices.copy();
     m_weights = other.m_weights.copy();
     m_distances = other.m_distances.copy();
-    m_segments_counts_updated = false;
+    m_vectors = other.m_vectors.copy();
+    updateSegmentCounts();
 }
 
 void NeighborList::validate(unsigned int num_query_points, unsigned int num_points) const
@@ -187,19 +347,6 @@ void NeighborList::validate(unsigned int num_query_points, unsigned int num_poin
         throw std::runtime_error("NeighborList found inconsistent array sizes.");
 }
 
-unsigned int NeighborList::bisection_search(unsigned int val, unsigned int left, unsigned int right) const
-{
-    if (left + 1 >= right)
-        return left;
-
-    unsigned int middle((left + right) / 2);
-
-    if (m_neighbors(middle, 0) < val)
-        return bisection_search(val, middle, right);
-    else
-        return bisection_search(val, left, middle);
-}
-
 bool compareNeighborBond(const NeighborBond& left, const NeighborBond& right)
 {
     return left.less_as_tuple(right);
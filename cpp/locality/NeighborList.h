@@ -4,6 +4,7 @@
 #ifndef NEIGHBOR_LIST_H
 #define NEIGHBOR_LIST_H
 
+#include <cstddef>
 #include <vector>
 
 #include "Box.h"
@@ -21,132 +22,271 @@ namespace freud { namespace locality {
 
     <b>Data structures:</b>
 
-    Query point and point indices are stored in a 2D array m_neighbors of shape
-    (n_bonds, 2). The distances and weights arrays are flat per-bond arrays.
+    The bonds are stored as a structure of arrays: the query point indices,
+    point indices, distances, and weights are each stored in a separate flat
+    per-bond array, so per-bond kernels can stream over exactly the data they
+    need. Optionally, the bond vectors (the minimum image vectors from each
+    query point to its neighbor point) can also be stored. Bond counts and
+    offsets are stored as size_t so that lists with more than 2^32 bonds are
+    supported.
+
+    For backwards compatibility, an interleaved array of shape (n_bonds, 2)
+    holding the query point and point indices can be obtained with
+    getNeighbors(). This array is generated on demand and regenerated after
+    the bond indices are accessed for writing.
  */
 class NeighborList
 {
 public:
     //! Default constructor
     NeighborList();
+
     //! Create a NeighborList that can hold up to the given number of bonds
-    NeighborList(unsigned int max_bonds);
+    NeighborList(size_t max_bonds);
+
     //! Copy constructor (makes a deep copy)
     NeighborList(const NeighborList& other);
+
     //! Construct from arrays
-    NeighborList(unsigned int num_bonds, const unsigned int* query_point_index, unsigned int num_query_points,
+    NeighborList(size_t num_bonds, const unsigned int* query_point_index, unsigned int num_query_points,
                  const unsigned int* point_index, unsigned int num_points, const float* distances,
                  const float* weights);
 
     //! Return the number of bonds stored in this NeighborList
-    unsigned int getNumBonds() const;
+    size_t getNumBonds() const;
+
     //! Return the number of query points this NeighborList was built with
     unsigned int getNumQueryPoints() const;
+
     //! Return the number of points this NeighborList was built with
     unsigned int getNumPoints() const;
 
     //! Set the number of bonds, query points, and points for this NeighborList object
-    void setNumBonds(unsigned int num_bonds, unsigned int num_query_points, unsigned int num_points);
+    void setNumBonds(size_t num_bonds, unsigned int num_query_points, unsigned int num_points);
+
     //! Update the arrays of neighbor counts and segments
+    /*! Segments and counts are computed when a NeighborList is constructed
+     *  from arrays, copied, or filtered. Code that fills the bond arrays
+     *  directly after calling setNumBonds should call this function once all
+     *  bonds have been set.
+     */
     void updateSegmentCounts() const;
 
-    //! Access the neighbors array for reading and writing
-    util::ManagedArray<unsigned int>& getNeighbors()
+    //! Access the query point index of each bond for reading and writing
+    util::ManagedArray<unsigned int>& getQueryPointIndices()
     {
-        return m_neighbors;
+        invalidateNeighbors();
+        return m_query_point_indices;
     }
+
+    //! Access the point index of each bond for reading and writing
+    util::ManagedArray<unsigned int>& getPointIndices()
+    {
+        invalidateNeighbors();
+        return m_point_indices;
+    }
+
     //! Access the distances array for reading and writing
     util::ManagedArray<float>& getDistances()
     {
         return m_distances;
     }
+
     //! Access the weights array for reading and writing
     util::ManagedArray<float>& getWeights()
     {
         return m_weights;
     }
+
+    //! Access the bond vectors array for reading and writing (empty unless hasVectors())
+    util::ManagedArray<vec3<float>>& getVectors()
+    {
+        return m_vectors;
+    }
+
     //! Access the counts array for reading
     util::ManagedArray<unsigned int>& getCounts()
     {
         updateSegmentCounts();
         return m_counts;
     }
+
     //! Access the segments array for reading
-    util::ManagedArray<unsigned int>& getSegments()
+    util::ManagedArray<size_t>& getSegments()
     {
         updateSegmentCounts();
         return m_segments;
     }
 
-    //! Access the neighbors array for reading
-    const util::ManagedArray<unsigned int>& getNeighbors() const
+    //! Access the query point index of each bond for reading
+    const util::ManagedArray<unsigned int>& getQueryPointIndices() const
     {
-        return m_neighbors;
+        return m_query_point_indices;
     }
+
+    //! Access the point index of each bond for reading
+    const util::ManagedArray<unsigned int>& getPointIndices() const
+    {
+        return m_point_indices;
+    }
+
+    //! Access an interleaved (n_bonds, 2) array of query point and point indices for reading
+    const util::ManagedArray<unsigned int>& getNeighbors() const;
+
     //! Access the distances array for reading
     const util::ManagedArray<float>& getDistances() const
     {
         return m_distances;
     }
+
     //! Access the weights array for reading
     const util::ManagedArray<float>& getWeights() const
     {
         return m_weights;
     }
+
+    //! Access the bond vectors array for reading (empty unless hasVectors())
+    const util::ManagedArray<vec3<float>>& getVectors() const
+    {
+        return m_vectors;
+    }
+
     //! Access the counts array for reading
     const util::ManagedArray<unsigned int>& getCounts() const
     {
         updateSegmentCounts();
         return m_counts;
     }
+
     //! Access the segments array for reading
-    const util::ManagedArray<unsigned int>& getSegments() const
+    const util::ManagedArray<size_t>& getSegments() const
     {
         updateSegmentCounts();
         return m_segments;
     }
 
+    //! Whether bond vectors are stored in this NeighborList
+    bool hasVectors() const
+    {
+        return m_has_vectors;
+    }
+
+    //! Whether this is a half NeighborList
+    /*! Half lists hold each pair of points once, as the bond from the
+     *  smaller index to the larger, and are found by half queries (see
+     *  QueryArgs::half).
+     */
+    bool isHalf() const
+    {
+        return m_half;
+    }
+
+    //! Mark this NeighborList as a half list, or not.
+    void setHalf(bool half)
+    {
+        m_half = half;
+    }
+
+    //! Enable or disable storage of bond vectors.
+    /*! Enabling bond vectors allocates a zeroed array that must be filled by
+     *  the caller. Disabling them frees the array.
+     */
+    void setHasVectors(bool has_vectors);
+
     //! Remove bonds in this object based on an array of boolean values. The
     //  array must be at least as long as the number of neighbor bonds.
     //  Returns the number of bonds removed.
-    unsigned int filter(const bool* filt);
+    size_t filter(const bool* filt);
+
     //! Remove bonds in this object based on minimum and maximum distance
     //  constraints. Returns the number of bonds removed.
-    unsigned int filter_r(float r_max, float r_min = 0);
+    size_t filter_r(float r_max, float r_min = 0);
 
     //! Return the first bond index corresponding to point i
-    unsigned int find_first_index(unsigned int i) const;
+    /*! This is the number of bonds of query points before i, so it is also
+     *  defined for query points without bonds. It is read from the segments
+     *  array once that is up to date.
+     */
+    size_t find_first_index(unsigned int i) const;
 
     //! Resize member arrays to a different size
-    void resize(unsigned int num_bonds);
+    /*! Shrinking keeps the first num_bonds bonds, in place unless the arrays
+     *  are shared with other references. Growing discards all bonds.
+     */
+    void resize(size_t num_bonds);
 
     //! Copy the bonds from another NeighborList object
     void copy(const NeighborList& other);
+
     //! Throw a runtime_error if num_points and num_query_points do not match
     //  the stored value
     void validate(unsigned int num_points, unsigned int num_query_points) const;
 
 private:
-    //! Helper method for bisection search of the neighbor list, used in find_first_index
-    unsigned int bisection_search(unsigned int val, unsigned int left, unsigned int right) const;
+    //! Remove the bonds for which keep(bond) is false, in parallel.
+    template<typename Keep> size_t filterBonds(const Keep& keep);
+
+    //! Mark the interleaved neighbors array as out of date
+    /*! This is called by the accessors that allow writing bond indices. The
+     *  flag is only written when it is set, so bonds can be filled in parallel
+     *  once the array is out of date.
+     */
+    void invalidateNeighbors()
+    {
+        if (m_neighbors_updated)
+        {
+            m_neighbors_updated = false;
+        }
+    }
+
+    //! Mark the arrays derived from the bond indices as out of date
+    void invalidateDerivedArrays()
+    {
+        m_segments_counts_updated = false;
+        m_neighbors_updated = false;
+    }
 
     //! Number of query points
     unsigned int m_num_query_points;
+
     //! Number of points
     unsigned int m_num_points;
-    //! Neighbor list indices array
-    util::ManagedArray<unsigned int> m_neighbors;
+
+    //! Neighbor list per-bond query point index array
+    util::ManagedArray<unsigned int> m_query_point_indices;
+
+    //! Neighbor list per-bond point index array
+    util::ManagedArray<unsigned int> m_point_indices;
+
     //! Neighbor list per-bond distance array
     util::ManagedArray<float> m_distances;
+
     //! Neighbor list per-bond weight array
     util::ManagedArray<float> m_weights;
 
+    //! Neighbor list per-bond vector array
+    util::ManagedArray<vec3<float>> m_vectors;
+
+    //! Whether bond vectors are stored
+    bool m_has_vectors;
+
+    //! Whether each pair of points is stored once
+    bool m_half;
+
     //! Track whether segments and counts are up to date
     mutable bool m_segments_counts_updated;
+
     //! Neighbor counts for each query point
     mutable util::ManagedArray<unsigned int> m_counts;
+
     //! Neighbor segments for each query point
-    mutable util::ManagedArray<unsigned int> m_segments;
+    mutable util::ManagedArray<size_t> m_segments;
+
+    //! Track whether the interleaved neighbors array is up to date
+    mutable bool m_neighbors_updated;
+
+    //! Interleaved (n_bonds, 2) array of bond indices, generated on demand
+    mutable util::ManagedArray<unsigned int> m_neighbors;
 };
 
 bool compareNeighborBond(const NeighborBond& left, const NeighborBond& right);
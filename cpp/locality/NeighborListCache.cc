@@ -0,0 +1,196 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "NeighborListCache.h"
+#include "utils.h"
+
+/*! \file NeighborListCache.cc
+    \brief Memoizes the NeighborLists of queries of a NeighborQuery's points.
+*/
+
+namespace freud { namespace locality {
+
+namespace {
+//! Whether two resolved query arguments describe the same bonds.
+bool sameNeighbors(const QueryArgs& a, const QueryArgs& b)
+{
+    // The r_guess and scale arguments do not affect the bonds found.
+    return a.mode == b.mode && a.r_max == b.r_max && a.r_min == b.r_min && a.exclude_ii == b.exclude_ii
+        && a.half == b.half && (a.mode != QueryArgs::nearest || a.num_neighbors == b.num_neighbors)
+        && a.point_type == b.point_type && a.query_point_type == b.query_point_type;
+}
+}; // end anonymous namespace
+
+bool canDeriveNeighbors(const QueryArgs& source, const QueryArgs& target)
+{
+    if (source.exclude_ii != target.exclude_ii || source.half != target.half
+        || source.point_type != target.point_type || source.query_point_type != target.query_point_type)
+    {
+        return false;
+    }
+    const bool contains_range = source.r_max >= target.r_max && source.r_min <= target.r_min;
+    if (target.mode == QueryArgs::ball)
+    {
+        return source.mode == QueryArgs::ball && contains_range;
+    }
+    if (target.mode == QueryArgs::nearest)
+    {
+        if (source.mode == QueryArgs::ball)
+        {
+            return contains_range;
+        }
+        // Bonds closer than a larger r_min of the target would have taken
+        // the places of nearest neighbors in the source.
+        return source.mode == QueryArgs::nearest && source.num_neighbors >= target.num_neighbors
+            && source.r_max >= target.r_max && source.r_min == target.r_min;
+    }
+    return false;
+}
+
+NeighborList* deriveNeighborList(const NeighborList& source, const QueryArgs& target)
+{
+    // The distance tests of the queries use squared bond vectors.
+    const float r_max_sq = target.r_max * target.r_max;
+    const float r_min_sq = target.r_min * target.r_min;
+    const auto in_range = [&source, r_max_sq, r_min_sq](size_t bond) {
+        float r_sq;
+        if (source.hasVectors())
+        {
+            r_sq = dot(source.getVectors()[bond], source.getVectors()[bond]);
+        }
+        else
+        {
+            r_sq = source.getDistances()[bond] * source.getDistances()[bond];
+        }
+        return r_sq < r_max_sq && r_sq >= r_min_sq;
+    };
+
+    std::unique_ptr<bool[]> keep(new bool[source.getNumBonds()]);
+    if (target.mode == QueryArgs::ball)
+    {
+        util::forLoopWrapper(0, source.getNumBonds(), [&](size_t begin, size_t end) {
+            for (size_t bond = begin; bond < end; ++bond)
+            {
+                keep[bond] = in_range(bond);
+            }
+        });
+    }
+    else
+    {
+        // Keep the nearest bonds in range of each query point, breaking ties
+        // by point index like NearestNeighborHeap.
+        const float* distances = source.getDistances().get();
+        const unsigned int* point_indices = source.getPointIndices().get();
+        const auto closer = [distances, point_indices](size_t a, size_t b) {
+            return distances[a] < distances[b]
+                || (distances[a] == distances[b] && point_indices[a] < point_indices[b]);
+        };
+        const size_t* segments = source.getSegments().get();
+        const unsigned int* counts = source.getCounts().get();
+        util::forLoopWrapper(0, source.getNumQueryPoints(), [&](size_t begin, size_t end) {
+            std::vector<size_t> candidates;
+            for (size_t i = begin; i < end; ++i)
+            {
+                candidates.clear();
+                for (size_t bond = segments[i]; bond < segments[i] + counts[i]; ++bond)
+                {
+                    keep[bond] = false;
+                    if (in_range(bond))
+                    {
+                        candidates.push_back(bond);
+                    }
+                }
+                const size_t num_kept = std::min<size_t>(candidates.size(), target.num_neighbors);
+                if (num_kept < candidates.size())
+                {
+                    std::nth_element(candidates.begin(), candidates.begin() + num_kept, candidates.end(),
+                                     closer);
+                }
+                for (size_t k = 0; k < num_kept; ++k)
+                {
+                    keep[candidates[k]] = true;
+                }
+            }
+        });
+    }
+
+    NeighborList* nlist = new NeighborList(source);
+    nlist->filter(keep.get());
+    return nlist;
+}
+
+NeighborListCache::NeighborListCache(const NeighborQuery* nq, unsigned int max_size)
+    : m_nq(nq), m_max_size(max_size), m_num_hits(0), m_num_derived(0), m_num_queries(0)
+{
+    if (max_size == 0)
+    {
+        throw std::invalid_argument("NeighborListCache requires a max_size of at least 1.");
+    }
+}
+
+std::shared_ptr<NeighborList> NeighborListCache::get(QueryArgs qargs)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    qargs = m_nq->resolveQueryArgs(qargs);
+
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it)
+    {
+        if (sameNeighbors(it->qargs, qargs))
+        {
+            ++m_num_hits;
+            std::rotate(it, it + 1, m_entries.end());
+            return m_entries.back().nlist;
+        }
+    }
+
+    // Select from the smallest cached list that contains the bonds.
+    const Entry* source = nullptr;
+    for (const Entry& entry : m_entries)
+    {
+        if (canDeriveNeighbors(entry.qargs, qargs)
+            && (source == nullptr || entry.nlist->getNumBonds() < source->nlist->getNumBonds()))
+        {
+            source = &entry;
+        }
+    }
+
+    std::shared_ptr<NeighborList> nlist;
+    if (source != nullptr)
+    {
+        nlist.reset(deriveNeighborList(*source->nlist, qargs));
+        ++m_num_derived;
+    }
+    else
+    {
+        nlist.reset(m_nq->query(m_nq->getPoints(), m_nq->getNPoints(), qargs)->toNeighborList());
+        ++m_num_queries;
+    }
+    insert(qargs, nlist);
+    return nlist;
+}
+
+void NeighborListCache::insert(const QueryArgs& qargs, const std::shared_ptr<NeighborList>& nlist)
+{
+    if (m_entries.size() >= m_max_size)
+    {
+        m_entries.erase(m_entries.begin());
+    }
+    m_entries.push_back(Entry {qargs, nlist});
+}
+
+void NeighborListCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+}
+
+unsigned int NeighborListCache::getSize() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<unsigned int>(m_entries.size());
+}
+
+}; }; // end namespace freud::locality
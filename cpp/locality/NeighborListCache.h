@@ -0,0 +1,129 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEIGHBOR_LIST_CACHE_H
+#define NEIGHBOR_LIST_CACHE_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+
+/*! \file NeighborListCache.h
+    \brief Memoizes the NeighborLists of queries of a NeighborQuery's points.
+*/
+
+namespace freud { namespace locality {
+
+//! Whether the bonds of a query can be selected from the bonds of another query.
+/*! This is the case if both queries have the same exclude_ii and half flags
+ *  and type filters, and either
+ *    - both are ball queries, and the target distance range is within the
+ *      source distance range, or
+ *    - the target is a nearest neighbor query within a distance range that
+ *      the source contains all bonds of, either because the source is a
+ *      ball query of a larger range or because the source is a nearest
+ *      neighbor query of at least as many neighbors with the same r_min and
+ *      an r_max at least as large.
+ *
+ *  \param source The resolved query arguments of the available bonds (see
+ *         NeighborQuery::resolveQueryArgs).
+ *  \param target The resolved query arguments of the requested bonds.
+ */
+bool canDeriveNeighbors(const QueryArgs& source, const QueryArgs& target);
+
+//! Select the bonds of a query from a NeighborList containing them.
+/*! Bonds are selected with the same distance tests as the queries, and the
+ *  ties between nearest neighbors are broken by point index, so the
+ *  result holds the same bonds in the same order as a NeighborList built by
+ *  querying with the target arguments.
+ *
+ *  \param source A NeighborList of a query whose arguments can derive target.
+ *  \param target The query arguments of the requested bonds.
+ *  \returns A new NeighborList owned by the caller.
+ */
+NeighborList* deriveNeighborList(const NeighborList& source, const QueryArgs& target);
+
+//! Cache of the NeighborLists of queries of a NeighborQuery's points against themselves.
+/*! Analyses that run many computes on the same points with the same query
+ *  arguments would otherwise repeat the same neighbor search for every
+ *  compute. The cache keeps the most recently used NeighborLists, keyed by
+ *  their query arguments. A request that is not cached is derived from a
+ *  cached list of a larger query if possible (see canDeriveNeighbors), for
+ *  example bonds within a smaller r_max or fewer nearest neighbors, and the
+ *  points are only queried if not.
+ *
+ *  The cache does not observe the points, so it must be cleared when the
+ *  points of the NeighborQuery change. It is safe to use from multiple
+ *  threads.
+ */
+class NeighborListCache
+{
+public:
+    //! Constructor
+    /*! \param nq The NeighborQuery whose points are queried.
+     *  \param max_size Maximum number of NeighborLists kept.
+     */
+    NeighborListCache(const NeighborQuery* nq, unsigned int max_size);
+
+    //! Get the NeighborList of a query of the points against themselves.
+    /*! \param qargs The query arguments.
+     *  \returns A NeighborList shared with the cache, which must not be modified.
+     */
+    std::shared_ptr<NeighborList> get(QueryArgs qargs);
+
+    //! Remove all NeighborLists.
+    void clear();
+
+    //! Get the maximum number of NeighborLists kept.
+    unsigned int getMaxSize() const
+    {
+        return m_max_size;
+    }
+
+    //! Get the number of NeighborLists kept.
+    unsigned int getSize() const;
+
+    //! Get the number of requests answered by a cached NeighborList.
+    unsigned int getNumHits() const
+    {
+        return m_num_hits;
+    }
+
+    //! Get the number of requests answered by selecting bonds from a cached NeighborList.
+    unsigned int getNumDerived() const
+    {
+        return m_num_derived;
+    }
+
+    //! Get the number of requests answered by querying the points.
+    unsigned int getNumQueries() const
+    {
+        return m_num_queries;
+    }
+
+private:
+    //! A cached NeighborList and the resolved arguments of its query.
+    struct Entry
+    {
+        QueryArgs qargs;                     //!< Resolved query arguments.
+        std::shared_ptr<NeighborList> nlist; //!< Bonds of the query.
+    };
+
+    //! Add a NeighborList as the most recently used, evicting the least recently used if full.
+    void insert(const QueryArgs& qargs, const std::shared_ptr<NeighborList>& nlist);
+
+    const NeighborQuery* m_nq;    //!< NeighborQuery whose points are queried.
+    unsigned int m_max_size;      //!< Maximum number of NeighborLists kept.
+    std::vector<Entry> m_entries; //!< Cached NeighborLists, from least to most recently used.
+    unsigned int m_num_hits;      //!< Number of requests answered by a cached NeighborList.
+    unsigned int m_num_derived;   //!< Number of requests answered by selecting bonds.
+    unsigned int m_num_queries;   //!< Number of requests answered by querying.
+    mutable std::mutex m_mutex;   //!< Serializes access to the entries.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // NEIGHBOR_LIST_CACHE_H
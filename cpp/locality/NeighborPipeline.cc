@@ -0,0 +1,96 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <limits>
+#include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+
+#include "NeighborComputeFunctional.h"
+#include "NeighborPipeline.h"
+
+/*! \file NeighborPipeline.cc
+    \brief Runs several computes on the bonds found by a single neighbor traversal.
+*/
+
+namespace freud { namespace locality {
+
+void NeighborPipeline::compute(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                               unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist)
+{
+    if (nlist == NULL)
+    {
+        const QueryArgs resolved_qargs = neighbor_query->resolveQueryArgs(qargs);
+        if (resolved_qargs.mode == QueryArgs::ball)
+        {
+            // Cutoffs derived from the same parameters may be rounded
+            // differently by the caller, so allow a relative error of one ulp.
+            const float r_max_limit = resolved_qargs.r_max * (1 + std::numeric_limits<float>::epsilon());
+            for (const auto& stage : m_stages)
+            {
+                if (stage->getRMax() > r_max_limit)
+                {
+                    throw std::invalid_argument("NeighborPipeline requires r_max to be at least as large as "
+                                                "the r_max of every stage.");
+                }
+            }
+        }
+    }
+    else
+    {
+        nlist->validate(n_query_points, neighbor_query->getNPoints());
+    }
+
+    for (const auto& stage : m_stages)
+    {
+        stage->begin(neighbor_query, query_points, n_query_points);
+    }
+
+    // The bonds of each query point are gathered once into a thread-local
+    // buffer and then replayed to every stage.
+    tbb::enumerable_thread_specific<NeighborVectorPerPointIterator> buffers;
+    const auto visit_stages = [this](unsigned int i, NeighborVectorPerPointIterator& buffer) {
+        for (const auto& stage : m_stages)
+        {
+            buffer.rewind(stage->getRMax());
+            stage->visitPoint(i, buffer);
+        }
+    };
+
+    if (nlist != NULL)
+    {
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            NeighborVectorPerPointIterator& buffer = buffers.local();
+            for (size_t i = begin; i != end; ++i)
+            {
+                buffer.reset(i);
+                NeighborListPerPointIterator nlist_iter(nlist, i, neighbor_query, query_points);
+                for (NeighborBond nb = nlist_iter.next(); !nlist_iter.end(); nb = nlist_iter.next())
+                {
+                    buffer.getBonds().push_back(nb);
+                }
+                visit_stages(i, buffer);
+            }
+        });
+    }
+    else
+    {
+        const DirectNeighborQuery query(neighbor_query, query_points, n_query_points, qargs);
+        util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+            NeighborVectorPerPointIterator& buffer = buffers.local();
+            for (size_t k = begin; k != end; ++k)
+            {
+                const unsigned int i = query.getQueryPointIndex(k);
+                buffer.reset(i);
+                query.visit(i, NeighborBondAppender(buffer.getBonds()));
+                visit_stages(i, buffer);
+            }
+        });
+    }
+
+    for (const auto& stage : m_stages)
+    {
+        stage->end();
+    }
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,102 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEIGHBOR_PIPELINE_H
+#define NEIGHBOR_PIPELINE_H
+
+#include <memory>
+#include <vector>
+
+#include "NeighborList.h"
+#include "NeighborPerPointIterator.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file NeighborPipeline.h
+    \brief Runs several computes on the bonds found by a single neighbor traversal.
+*/
+
+namespace freud { namespace locality {
+
+//! A compute that can consume the bonds of a shared neighbor traversal.
+/*! Stages are driven by a NeighborPipeline. begin() is called once before
+ *  the traversal, visitPoint() is called once for every query point with an
+ *  iterator over the bonds of that query point, and end() is called once
+ *  after the traversal. Calls to visitPoint() for different query points may
+ *  happen concurrently, so a stage must only write per-query-point or
+ *  thread-local data there.
+ */
+class NeighborPipelineStage
+{
+public:
+    //! Empty destructor
+    virtual ~NeighborPipelineStage() {}
+
+    //! Largest bond distance used by this stage, or 0 if it uses every bond.
+    /*! Bonds at least this long are not passed to visitPoint().
+     */
+    virtual float getRMax() const
+    {
+        return 0;
+    }
+
+    //! Prepare to receive the bonds of one traversal.
+    virtual void begin(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                       unsigned int n_query_points)
+        = 0;
+
+    //! Process the bonds of one query point.
+    virtual void visitPoint(size_t query_point_idx, NeighborPerPointIterator& ppiter) = 0;
+
+    //! Finish the computation after all bonds have been visited.
+    virtual void end() = 0;
+};
+
+//! Share one neighbor traversal between several computes.
+/*! Running several analyses on the same system with separate computes finds
+ *  the neighbors of every query point once per compute. A NeighborPipeline
+ *  instead finds the bonds of each query point once, including their bond
+ *  vectors, and passes them to every stage in turn while they are still in
+ *  cache. Each stage only sees the bonds shorter than its getRMax().
+ */
+class NeighborPipeline
+{
+public:
+    //! Constructor
+    NeighborPipeline() : m_stages() {}
+
+    //! Append a stage to the pipeline.
+    void addStage(std::shared_ptr<NeighborPipelineStage> stage)
+    {
+        m_stages.push_back(stage);
+    }
+
+    //! Remove all stages from the pipeline.
+    void clearStages()
+    {
+        m_stages.clear();
+    }
+
+    //! Get the number of stages in the pipeline.
+    unsigned int getNumStages() const
+    {
+        return m_stages.size();
+    }
+
+    //! Run all stages on the bonds of one traversal.
+    /*! \param neighbor_query NeighborQuery object to find neighbors in.
+     *  \param query_points Query points to find neighbors for.
+     *  \param n_query_points Number of query_points.
+     *  \param qargs Query arguments, used if nlist is NULL.
+     *  \param nlist NeighborList to use instead of querying, may be NULL.
+     */
+    void compute(const NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                 unsigned int n_query_points, QueryArgs qargs, const NeighborList* nlist);
+
+private:
+    std::vector<std::shared_ptr<NeighborPipelineStage>> m_stages; //!< The stages run on each traversal.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // NEIGHBOR_PIPELINE_H
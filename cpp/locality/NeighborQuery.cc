@@ -1,6 +1,13 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include "NeighborComputeFunctional.h"
 #include "NeighborQuery.h"
 
 namespace freud { namespace locality {
@@ -14,4 +21,339 @@ const float QueryArgs::DEFAULT_R_MIN(0);
 const float QueryArgs::DEFAULT_R_GUESS(-1.0);
 const float QueryArgs::DEFAULT_SCALE(-1.0);
 const bool QueryArgs::DEFAULT_EXCLUDE_II(false);
+const bool QueryArgs::DEFAULT_HALF(false);
+const unsigned int QueryArgs::ANY_TYPE(0xffffffff);
+
+namespace {
+//! Spread the lowest 21 bits of x so that there are two zero bits between each.
+inline uint64_t spreadBits3(uint64_t x)
+{
+    x &= 0x1fffff;
+    x = (x | x << 32) & 0x1f00000000ffff;
+    x = (x | x << 16) & 0x1f0000ff0000ff;
+    x = (x | x << 8) & 0x100f00f00f00f00f;
+    x = (x | x << 4) & 0x10c30c30c30c30c3;
+    x = (x | x << 2) & 0x1249249249249249;
+    return x;
+}
+
+//! Spread the lowest 32 bits of x so that there is one zero bit between each.
+inline uint64_t spreadBits2(uint64_t x)
+{
+    x &= 0xffffffff;
+    x = (x | x << 16) & 0x0000ffff0000ffff;
+    x = (x | x << 8) & 0x00ff00ff00ff00ff;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+    x = (x | x << 2) & 0x3333333333333333;
+    x = (x | x << 1) & 0x5555555555555555;
+    return x;
+}
+
+//! Discretize a fractional coordinate into an integer grid with the given number of bits.
+inline uint64_t discretize(float alpha, unsigned int bits)
+{
+    // Points slightly outside the box are clamped to the boundary.
+    const float max_value = static_cast<float>((uint64_t(1) << bits) - 1);
+    const float value = std::min(std::max(alpha, float(0)), float(1)) * max_value;
+    return static_cast<uint64_t>(value);
+}
+}; // namespace
+
+void NeighborQuery::computeSpatialOrder()
+{
+    const bool is2D = m_box.is2D();
+    std::vector<std::pair<uint64_t, unsigned int>> codes(m_n_points);
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const vec3<float> alpha = m_box.makeFractional(m_box.wrap(m_points[i]));
+            uint64_t code;
+            if (is2D)
+            {
+                code = spreadBits2(discretize(alpha.x, 21)) | (spreadBits2(discretize(alpha.y, 21)) << 1);
+            }
+            else
+            {
+                code = spreadBits3(discretize(alpha.x, 21)) | (spreadBits3(discretize(alpha.y, 21)) << 1)
+                    | (spreadBits3(discretize(alpha.z, 21)) << 2);
+            }
+            codes[i] = std::make_pair(code, static_cast<unsigned int>(i));
+        }
+    });
+
+    // Ties are broken by index, so the order is deterministic.
+    tbb::parallel_sort(codes.begin(), codes.end());
+
+    m_spatial_order.prepare(m_n_points);
+    util::forLoopWrapper(0, m_n_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            m_spatial_order[i] = codes[i].second;
+        }
+    });
+}
+
+void NeighborQuery::validateTypeQuery(const QueryArgs& args, unsigned int n_query_points) const
+{
+    if (!isTypedQuery(args))
+    {
+        return;
+    }
+    if (!hasPointTypes())
+    {
+        throw std::invalid_argument("Queries filtered by type require a NeighborQuery with point types.");
+    }
+    if (args.half)
+    {
+        throw std::invalid_argument("Half neighbor queries cannot be filtered by type.");
+    }
+    if (args.query_point_type != QueryArgs::ANY_TYPE && n_query_points != m_n_points)
+    {
+        throw std::invalid_argument(
+            "Queries filtered by the type of the query points require the query points to be the points.");
+    }
+}
+
+void NeighborQuery::setPointTypes(const unsigned int* types)
+{
+    m_point_types.assign(types, types + m_n_points);
+    m_types = m_point_types;
+    std::sort(m_types.begin(), m_types.end());
+    m_types.erase(std::unique(m_types.begin(), m_types.end()), m_types.end());
+    if (!m_types.empty() && m_types.back() == QueryArgs::ANY_TYPE)
+    {
+        throw std::invalid_argument("The point types must be less than 4294967295.");
+    }
+
+    // The points of each type keep their relative order.
+    m_type_indices.assign(m_types.size(), std::vector<unsigned int>());
+    m_index_in_type.resize(m_n_points);
+    for (unsigned int i = 0; i < m_n_points; ++i)
+    {
+        std::vector<unsigned int>& indices = m_type_indices[findType(m_point_types[i])];
+        m_index_in_type[i] = static_cast<unsigned int>(indices.size());
+        indices.push_back(i);
+    }
+    updateTypeQueries();
+}
+
+void NeighborQuery::updateTypeQueries()
+{
+    m_type_points.resize(m_types.size());
+    m_type_queries.resize(m_types.size());
+    for (size_t slot = 0; slot < m_types.size(); ++slot)
+    {
+        const std::vector<unsigned int>& indices = m_type_indices[slot];
+        std::vector<vec3<float>>& points = m_type_points[slot];
+        points.resize(indices.size());
+        util::forLoopWrapper(0, indices.size(), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                points[i] = m_points[indices[i]];
+            }
+        });
+        m_type_queries[slot] = makeTypeQuery(points.data(), static_cast<unsigned int>(points.size()));
+    }
+}
+
+void NeighborQuery::queryCounts(const vec3<float>* query_points, unsigned int n_query_points,
+                                QueryArgs query_args, unsigned int* counts) const
+{
+    query_args = resolveQueryArgs(query_args);
+    if (query_args.mode == QueryArgs::nearest)
+    {
+        throw std::invalid_argument("Neighbors can only be counted by count, exists, and ball queries.");
+    }
+    const unsigned int max_count
+        = (query_args.mode == QueryArgs::exists) ? 1 : std::numeric_limits<unsigned int>::max();
+
+    // The points tested are those of a ball query.
+    query_args.mode = QueryArgs::ball;
+    const DirectNeighborQuery query(this, query_points, n_query_points, query_args);
+    util::forLoopWrapper(0, n_query_points, [&](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k)
+        {
+            const unsigned int i = query.getQueryPointIndex(k);
+            counts[i] = query.count(i, max_count);
+        }
+    });
+}
+
+TypedPerPointIterator::TypedPerPointIterator(const NeighborQuery* neighbor_query,
+                                             const vec3<float> query_point, unsigned int query_point_idx,
+                                             QueryArgs args)
+    : NeighborQueryPerPointIterator(neighbor_query, query_point, query_point_idx, args.r_max, args.r_min,
+                                    args.exclude_ii, args.half),
+      m_type_indices(neighbor_query->getTypeIndices(args.point_type))
+{
+    const NeighborQuery* type_query
+        = (args.point_type == QueryArgs::ANY_TYPE) ? neighbor_query
+                                                   : neighbor_query->getTypeQuery(args.point_type);
+    if (type_query == nullptr
+        || (args.query_point_type != QueryArgs::ANY_TYPE
+            && neighbor_query->getPointTypes()[query_point_idx] != args.query_point_type))
+    {
+        m_finished = true;
+        return;
+    }
+    const unsigned int type_query_point_idx = (args.point_type == QueryArgs::ANY_TYPE)
+        ? query_point_idx
+        : neighbor_query->getIndexInType(query_point_idx, args.point_type);
+    args.point_type = QueryArgs::ANY_TYPE;
+    args.query_point_type = QueryArgs::ANY_TYPE;
+    m_iter = type_query->querySingle(query_point, type_query_point_idx, args);
+}
+
+NeighborBond TypedPerPointIterator::next()
+{
+    while (!m_finished && !m_iter->end())
+    {
+        NeighborBond nb = m_iter->next();
+        if (nb != NeighborQueryIterator::ITERATOR_TERMINATOR)
+        {
+            nb.query_point_idx = m_query_point_idx;
+            if (m_type_indices != nullptr)
+            {
+                nb.point_idx = m_type_indices[nb.point_idx];
+            }
+            return nb;
+        }
+    }
+    m_finished = true;
+    return NeighborQueryIterator::ITERATOR_TERMINATOR;
+}
+
+NeighborList* NeighborQueryIterator::toNeighborList(bool sort_by_distance)
+{
+    return toNeighborList(sort_by_distance, 0, m_num_query_points);
+}
+
+NeighborList* NeighborQueryIterator::toNeighborList(bool sort_by_distance, unsigned int begin_query_point,
+                                                    unsigned int end_query_point)
+{
+    util::profiling::ScopedTimer timer("NeighborQuery::toNeighborList");
+    if (begin_query_point > end_query_point || end_query_point > m_num_query_points)
+    {
+        throw std::invalid_argument("The range of query points must be within the query points.");
+    }
+
+    // Bonds found for one block of steps of the parallel loop, grouped by
+    // query point in step order and sorted within each query point.
+    struct BondBlock
+    {
+        size_t begin;                    //!< First step of the block.
+        size_t end;                      //!< Step past the end of the block.
+        std::vector<NeighborBond> bonds; //!< Grouped bonds.
+    };
+    typedef tbb::enumerable_thread_specific<std::vector<BondBlock>> BlockVector;
+    BlockVector blocks;
+    bool (*compare)(const NeighborBond&, const NeighborBond&)
+        = sort_by_distance ? compareNeighborDistance : compareNeighborBond;
+
+    // The whole range of query points is visited in the steps of the query,
+    // which may be spatially sorted and use packet traversals, while
+    // subranges visit their query points in order. The counts and offsets
+    // are indexed relative to the first query point of the range.
+    const DirectNeighborQuery query(m_neighbor_query, m_query_points, m_num_query_points, m_qargs);
+    const bool all_query_points = (begin_query_point == 0 && end_query_point == m_num_query_points);
+    const unsigned int n_steps = end_query_point - begin_query_point;
+    auto step_index = [&](size_t k) {
+        return all_query_points ? query.getQueryPointIndex(k)
+                                : begin_query_point + static_cast<unsigned int>(k);
+    };
+
+    // Every query point is visited by exactly one block, so the blocks write
+    // disjoint entries of the counts.
+    std::vector<unsigned int> counts(n_steps, 0);
+    std::vector<size_t> offsets(n_steps + 1, 0);
+    util::forLoopWrapper(0, n_steps, [&](size_t begin, size_t end) {
+        // Bonds of different query points may be interleaved, for example by
+        // packet traversals, so they are grouped with a counting sort.
+        std::vector<NeighborBond> found;
+        if (all_query_points)
+        {
+            query.visitSteps(begin, end, NeighborBondAppender(found));
+        }
+        else
+        {
+            for (size_t k = begin; k < end; ++k)
+            {
+                query.visit(step_index(k), NeighborBondAppender(found));
+            }
+        }
+        util::profiling::LocalCounter bonds_visited(util::profiling::counter_bonds_visited);
+        bonds_visited.add(found.size());
+        for (const NeighborBond& nb : found)
+        {
+            ++counts[nb.query_point_idx - begin_query_point];
+        }
+        size_t offset = 0;
+        for (size_t k = begin; k < end; ++k)
+        {
+            const unsigned int i = step_index(k) - begin_query_point;
+            offsets[i] = offset;
+            offset += counts[i];
+        }
+
+        BondBlock block {begin, end, std::vector<NeighborBond>(found.size())};
+        for (const NeighborBond& nb : found)
+        {
+            block.bonds[offsets[nb.query_point_idx - begin_query_point]++] = nb;
+        }
+        std::vector<NeighborBond>().swap(found);
+        for (size_t k = begin; k < end; ++k)
+        {
+            const unsigned int i = step_index(k) - begin_query_point;
+            std::sort(block.bonds.begin() + (offsets[i] - counts[i]), block.bonds.begin() + offsets[i],
+                      compare);
+        }
+        blocks.local().push_back(std::move(block));
+    });
+
+    // The segment of each query point starts after the bonds of all lower
+    // query points, which is where a global sort would place them.
+    offsets[0] = 0;
+    for (unsigned int i = 0; i < n_steps; ++i)
+    {
+        offsets[i + 1] = offsets[i] + counts[i];
+    }
+    const size_t num_bonds = offsets[n_steps];
+
+    NeighborList* nl = new NeighborList();
+    nl->setNumBonds(num_bonds, m_num_query_points, m_neighbor_query->getNPoints());
+    nl->setHasVectors(true);
+    nl->setHalf(m_qargs.half);
+
+    std::vector<const BondBlock*> all_blocks;
+    for (const std::vector<BondBlock>& local_blocks : blocks)
+    {
+        for (const BondBlock& block : local_blocks)
+        {
+            all_blocks.push_back(&block);
+        }
+    }
+    util::forLoopWrapper(0, all_blocks.size(), [&](size_t begin, size_t end) {
+        for (size_t b = begin; b < end; ++b)
+        {
+            const BondBlock& block = *all_blocks[b];
+            const NeighborBond* source = block.bonds.data();
+            for (size_t k = block.begin; k < block.end; ++k)
+            {
+                const unsigned int i = step_index(k) - begin_query_point;
+                for (size_t bond = offsets[i]; bond < offsets[i + 1]; ++bond, ++source)
+                {
+                    nl->getQueryPointIndices()[bond] = source->query_point_idx;
+                    nl->getPointIndices()[bond] = source->point_idx;
+                    nl->getDistances()[bond] = source->distance;
+                    nl->getWeights()[bond] = float(1.0);
+                    nl->getVectors()[bond] = source->vector;
+                }
+            }
+        }
+    });
+    nl->updateSegmentCounts();
+
+    return nl;
+}
+
 }; }; // end namespace freud::locality
@@ -4,14 +4,17 @@
 #ifndef NEIGHBOR_QUERY_H
 #define NEIGHBOR_QUERY_H
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
+#include <vector>
 #include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_sort.h>
 
 #include "Box.h"
 #include "NeighborBond.h"
 #include "NeighborList.h"
+#include "ManagedArray.h"
 #include "NeighborPerPointIterator.h"
 #include "utils.h"
 
@@ -35,7 +38,8 @@ struct QueryArgs
      */
     QueryArgs()
         : mode(DEFAULT_MODE), num_neighbors(DEFAULT_NUM_NEIGHBORS), r_max(DEFAULT_R_MAX),
-          r_min(DEFAULT_R_MIN), r_guess(DEFAULT_R_GUESS), scale(DEFAULT_SCALE), exclude_ii(DEFAULT_EXCLUDE_II)
+          r_min(DEFAULT_R_MIN), r_guess(DEFAULT_R_GUESS), scale(DEFAULT_SCALE),
+          exclude_ii(DEFAULT_EXCLUDE_II), half(DEFAULT_HALF), point_type(ANY_TYPE), query_point_type(ANY_TYPE)
     {}
 
     //! Enumeration for types of queries.
@@ -44,17 +48,22 @@ struct QueryArgs
         none,    //! Default query type to avoid implicit default types.
         ball,    //! Query based on distance cutoff.
         nearest, //! Query based on number of requested neighbors.
+        count,   //! Count the neighbors within a distance cutoff, see NeighborQuery::queryCounts.
+        exists,  //! Find whether any neighbor is within a distance cutoff, see NeighborQuery::queryCounts.
     };
 
     QueryType mode;             //! Whether to perform a ball or k-nearest neighbor query.
     unsigned int num_neighbors; //! The number of nearest neighbors to find.
     float r_max;                //! The cutoff distance within which to find neighbors.
     float r_min;                //! The minimum distance beyond which to find neighbors.
-    float r_guess; //! The initial distance for finding neighbors, used by some algorithms to initialize a
-                   //! number of neighbors query.
-    float scale; //! The scale factor to use when performing repeated ball queries to find a specified number
-                 //! of nearest neighbors.
+    float r_guess; //! The initial distance for finding neighbors. Kept for compatibility, the built-in
+                   //! nearest neighbor queries do not use it.
+    float scale; //! The scale factor of repeated ball queries for nearest neighbors. Kept for compatibility,
+                 //! the built-in nearest neighbor queries do not use it.
     bool exclude_ii; //! If true, exclude self-neighbors.
+    bool half; //! If true, only find points with larger indices than the query point, see skipPair.
+    unsigned int point_type;       //! If not ANY_TYPE, only find points of this type, see setPointTypes.
+    unsigned int query_point_type; //! If not ANY_TYPE, only find neighbors of query points of this type.
 
     static const QueryType DEFAULT_MODE;             //!< Default mode.
     static const unsigned int DEFAULT_NUM_NEIGHBORS; //!< Default number of neighbors.
@@ -63,8 +72,49 @@ struct QueryArgs
     static const float DEFAULT_R_GUESS;              //!< Default guess query distance.
     static const float DEFAULT_SCALE;     //!< Default scaling parameter for AABB nearest neighbor queries.
     static const bool DEFAULT_EXCLUDE_II; //!< Default for whether or not to include self-neighbors.
+    static const bool DEFAULT_HALF;       //!< Default for whether to find half neighbor lists.
+    static const unsigned int ANY_TYPE;   //!< Type of queries that are not filtered by type.
 };
 
+//! Whether a query is filtered by the types of the points or query points.
+inline bool isTypedQuery(const QueryArgs& args)
+{
+    return args.point_type != QueryArgs::ANY_TYPE || args.query_point_type != QueryArgs::ANY_TYPE;
+}
+
+//! Whether a query skips the pair of a query point and a point without computing their distance.
+/*! Half queries of a set of points against itself find every pair of
+ *  points within the ball once, as the bond from the smaller index to the
+ *  larger, instead of once in each direction. They are only valid for
+ *  ball queries, since the nearest neighbor relation is not symmetric.
+ *
+ *  \param query_point_idx The index of the query point.
+ *  \param point_idx The index of the point.
+ *  \param exclude_ii Whether self-neighbors are excluded.
+ *  \param half Whether only points with larger indices than the query point are found.
+ */
+inline bool skipPair(unsigned int query_point_idx, unsigned int point_idx, bool exclude_ii, bool half)
+{
+    return half ? point_idx <= query_point_idx : (exclude_ii && point_idx == query_point_idx);
+}
+
+//! Whether a query only counts neighbors instead of finding bonds.
+inline bool isCountingQuery(const QueryArgs& args)
+{
+    return args.mode == QueryArgs::count || args.mode == QueryArgs::exists;
+}
+
+//! Check that a query finds bonds.
+/*! \param args The query arguments.
+ */
+inline void validateBondQuery(const QueryArgs& args)
+{
+    if (isCountingQuery(args))
+    {
+        throw std::invalid_argument("Count and exists queries do not find bonds, use queryCounts instead.");
+    }
+}
+
 // Forward declare the iterators
 class NeighborQueryIterator;
 class NeighborQueryPerPointIterator;
@@ -92,17 +142,7 @@ public:
             throw std::invalid_argument("Cannot create a NeighborQuery with 0 particles.");
         }
 
-        // For 2D systems, check if any z-coordinates are outside some tolerance of z=0
-        if (m_box.is2D())
-        {
-            for (unsigned int i(0); i < n_points; i++)
-            {
-                if (std::abs(m_points[i].z) > 1e-6)
-                {
-                    throw std::invalid_argument("A point with z != 0 was provided in a 2D box.");
-                }
-            }
-        }
+        validatePoints(points);
     }
 
     //! Empty Destructor
@@ -129,9 +169,27 @@ public:
             std::domain_error("Cannot execute pair queries in a non-periodic box");
 
         this->validateQueryArgs(query_args);
+        this->validateHalfQuery(query_args, query_points, n_query_points);
+        this->validateTypeQuery(query_args, n_query_points);
         return std::make_shared<NeighborQueryIterator>(this, query_points, n_query_points, query_args);
     }
 
+    //! Count the neighbors of each query point within a ball.
+    /*! This performs a count or exists query. No bonds are created, and the
+     *  search around each query point stops once its result is known: at
+     *  the first neighbor for exists queries. Ball queries are treated as
+     *  count queries.
+     *
+     *  \param query_points The points to count neighbors of.
+     *  \param n_query_points The number of query points.
+     *  \param query_args The query arguments, with an r_max and no num_neighbors.
+     *  \param counts Output with one entry per query point: the number of
+     *         neighbors for count queries, or 1 if a neighbor exists and 0
+     *         otherwise for exists queries.
+     */
+    void queryCounts(const vec3<float>* query_points, unsigned int n_query_points, QueryArgs query_args,
+                     unsigned int* counts) const;
+
     //! Perform a per-particle query based on a set of query parameters.
     /*! This function is the primary interface by which subclasses provide
      *  logic for finding neighbors. All such logic should be contained in
@@ -145,6 +203,112 @@ public:
     virtual std::shared_ptr<NeighborQueryPerPointIterator>
     querySingle(const vec3<float> query_point, unsigned int query_point_idx, QueryArgs args) const = 0;
 
+    //! Validate query arguments and return the fully specified version.
+    /*! This function allows callers that bypass query() to apply the same
+     *  mode inference and validation that query() would.
+     *
+     *  \param args The query arguments to validate.
+     */
+    QueryArgs resolveQueryArgs(QueryArgs args) const
+    {
+        this->validateQueryArgs(args);
+        return args;
+    }
+
+    //! Check that a half query is a query of the points against themselves.
+    /*! Half queries keep one direction of each pair, which is only
+     *  meaningful if the query points are the points. Query points with the
+     *  same number of elements are compared by value, since the points may
+     *  be a copy of the array the query points are read from.
+     *
+     *  \param args The query arguments.
+     *  \param query_points The query points.
+     *  \param n_query_points The number of query points.
+     */
+    void validateHalfQuery(const QueryArgs& args, const vec3<float>* query_points,
+                           unsigned int n_query_points) const
+    {
+        if (args.half
+            && (n_query_points != m_n_points
+                || (query_points != m_points && !std::equal(m_points, m_points + m_n_points, query_points))))
+        {
+            throw std::invalid_argument("Half neighbor queries require the query points to be the points.");
+        }
+    }
+
+    //! Check that the points have types if a query is filtered by type.
+    /*! Queries filtered by the type of the query points read the types of
+     *  the points, so they require the query points to be the points.
+     *
+     *  \param args The query arguments.
+     *  \param n_query_points The number of query points.
+     */
+    void validateTypeQuery(const QueryArgs& args, unsigned int n_query_points) const;
+
+    //! Set the types of the points, so that queries can be filtered by type.
+    /*! The points of each type are indexed by a separate data structure of
+     *  the same kind, built with the same parameters, so that queries
+     *  filtered by the type of the points (see QueryArgs::point_type) never
+     *  visit points of other types. The data structures are rebuilt when
+     *  the points are updated.
+     *
+     *  \param types The type of each point.
+     */
+    void setPointTypes(const unsigned int* types);
+
+    //! Whether the points have types, see setPointTypes.
+    bool hasPointTypes() const
+    {
+        return !m_point_types.empty();
+    }
+
+    //! Get the type of each point, empty if the points have no types.
+    const std::vector<unsigned int>& getPointTypes() const
+    {
+        return m_point_types;
+    }
+
+    //! Get the number of points of a type, or of all points for QueryArgs::ANY_TYPE.
+    unsigned int getNPointsOfType(unsigned int type) const
+    {
+        if (type == QueryArgs::ANY_TYPE)
+        {
+            return m_n_points;
+        }
+        const int slot = findType(type);
+        return (slot < 0) ? 0 : static_cast<unsigned int>(m_type_indices[slot].size());
+    }
+
+    //! Get the data structure of the points of a type, or nullptr if there are none.
+    const NeighborQuery* getTypeQuery(unsigned int type) const
+    {
+        const int slot = findType(type);
+        return (slot < 0) ? nullptr : m_type_queries[slot].get();
+    }
+
+    //! Get the indices of the points of a type, in the order of the points of getTypeQuery.
+    const unsigned int* getTypeIndices(unsigned int type) const
+    {
+        const int slot = findType(type);
+        return (slot < 0) ? nullptr : m_type_indices[slot].data();
+    }
+
+    //! Get the index of a query point to use in queries of getTypeQuery.
+    /*! Query points that are points of the type get their index among the
+     *  points of the type, and other query points get an index that no
+     *  point of the type has, so that self-neighbors are excluded exactly
+     *  as they would be in an unfiltered query.
+     *
+     *  \param query_point_idx The index of the query point.
+     *  \param type The type of the points to query.
+     */
+    unsigned int getIndexInType(unsigned int query_point_idx, unsigned int type) const
+    {
+        return (query_point_idx < m_n_points && m_point_types[query_point_idx] == type)
+            ? m_index_in_type[query_point_idx]
+            : getNPointsOfType(type);
+    }
+
     //! Get the simulation box
     const box::Box& getBox() const
     {
@@ -163,6 +327,16 @@ public:
         return m_n_points;
     }
 
+    //! Get the order in which points should be traversed for locality.
+    /*! If spatial sorting was requested when the object was constructed,
+     *  this array holds the point indices sorted along a Morton (Z-order)
+     *  space-filling curve. Otherwise, it is empty.
+     */
+    const util::ManagedArray<unsigned int>& getSpatialOrder() const
+    {
+        return m_spatial_order;
+    }
+
     //! Get a point's coordinates using index operator notation
     /*! \param index The point index to return.
      */
@@ -187,7 +361,7 @@ protected:
     {
         inferMode(args);
         // Validate remaining arguments.
-        if (args.mode == QueryArgs::ball)
+        if (args.mode == QueryArgs::ball || isCountingQuery(args))
         {
             if (args.r_max == QueryArgs::DEFAULT_R_MAX)
                 throw std::runtime_error(
@@ -198,6 +372,8 @@ protected:
         }
         else if (args.mode == QueryArgs::nearest)
         {
+            if (args.half)
+                throw std::runtime_error("Half neighbor queries are only supported for ball queries.");
             if (args.num_neighbors == QueryArgs::DEFAULT_NUM_NEIGHBORS)
                 throw std::runtime_error("You must set num_neighbors in the query arguments when performing "
                                          "number of neighbor queries.");
@@ -234,9 +410,56 @@ protected:
         }
     }
 
+    //! Check that a set of m_n_points points is valid for this box.
+    void validatePoints(const vec3<float>* points) const
+    {
+        // For 2D systems, check if any z-coordinates are outside some tolerance of z=0
+        if (m_box.is2D())
+        {
+            for (unsigned int i(0); i < m_n_points; i++)
+            {
+                if (std::abs(points[i].z) > 1e-6)
+                {
+                    throw std::invalid_argument("A point with z != 0 was provided in a 2D box.");
+                }
+            }
+        }
+    }
+
+    //! Sort the points along a Morton curve and store the result in m_spatial_order.
+    void computeSpatialOrder();
+
+    //! Build a data structure of the same kind over the points of one type, see setPointTypes.
+    /*! \param points The points of the type, which outlive the result.
+     *  \param n_points The number of points of the type.
+     */
+    virtual std::shared_ptr<NeighborQuery> makeTypeQuery(const vec3<float>* points,
+                                                         unsigned int n_points) const
+    {
+        throw std::invalid_argument("This NeighborQuery does not support point types.");
+    }
+
+    //! Gather the points of each type and rebuild their data structures, see setPointTypes.
+    void updateTypeQueries();
+
+    //! Get the position of a type in m_types, or -1 if no point has the type.
+    int findType(unsigned int type) const
+    {
+        const auto it = std::lower_bound(m_types.begin(), m_types.end(), type);
+        return (it == m_types.end() || *it != type) ? -1 : static_cast<int>(it - m_types.begin());
+    }
+
     const box::Box m_box;        //!< Simulation box where the particles belong.
     const vec3<float>* m_points; //!< Point coordinates.
     unsigned int m_n_points;     //!< Number of points.
+    util::ManagedArray<unsigned int> m_spatial_order; //!< Point indices in space-filling curve order.
+
+    std::vector<unsigned int> m_point_types;                    //!< Type of each point, if set.
+    std::vector<unsigned int> m_index_in_type;                  //!< Index of each point among its type.
+    std::vector<unsigned int> m_types;                          //!< Sorted types of the points.
+    std::vector<std::vector<unsigned int>> m_type_indices;      //!< Indices of the points of each type.
+    std::vector<std::vector<vec3<float>>> m_type_points;        //!< Points of each type.
+    std::vector<std::shared_ptr<NeighborQuery>> m_type_queries; //!< Data structure of each type.
 };
 
 //! Implementation of per-point finding logic for NeighborQuery objects.
@@ -256,10 +479,11 @@ public:
 
     //! Constructor
     NeighborQueryPerPointIterator(const NeighborQuery* neighbor_query, const vec3<float> query_point,
-                                  unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii)
+                                  unsigned int query_point_idx, float r_max, float r_min, bool exclude_ii,
+                                  bool half = false)
         : NeighborPerPointIterator(query_point_idx), m_neighbor_query(neighbor_query),
           m_query_point(query_point), m_finished(false), m_r_max(r_max), m_r_min(r_min),
-          m_exclude_ii(exclude_ii)
+          m_exclude_ii(exclude_ii), m_half(half)
     {}
 
     //! Empty Destructor
@@ -277,12 +501,46 @@ public:
     static const NeighborBond ITERATOR_TERMINATOR; //!< The object returned when iteration is complete.
 
 protected:
+    //! Whether the point j is skipped without computing its distance, see skipPair.
+    bool skipPoint(unsigned int j) const
+    {
+        return skipPair(m_query_point_idx, j, m_exclude_ii, m_half);
+    }
+
     const NeighborQuery* m_neighbor_query; //!< Link to the NeighborQuery object.
     const vec3<float> m_query_point;       //!< Coordinates of the query point.
     bool m_finished; //!< Flag to indicate that iteration is complete (must be set by next() on termination).
     float m_r_max;   //!< Cutoff distance for neighbors.
     float m_r_min;   //!< Minimum distance for neighbors.
     bool m_exclude_ii; //!< Flag to indicate whether or not to include self bonds.
+    bool m_half;       //!< Flag to indicate whether only points with larger indices are found.
+};
+
+//! Per-point iterator of a query filtered by type.
+/*! The neighbors are found by an iterator of the data structure of the
+ *  points of the queried type (see NeighborQuery::getTypeQuery), and the
+ *  indices of its bonds are translated back to the query point and points.
+ *  Query points of other types than QueryArgs::query_point_type have no
+ *  neighbors.
+ */
+class TypedPerPointIterator : public NeighborQueryPerPointIterator
+{
+public:
+    //! Constructor
+    /*! \param neighbor_query NeighborQuery whose points have types.
+     *  \param query_point The point to find neighbors for.
+     *  \param query_point_idx The index of the query point.
+     *  \param args The query arguments.
+     */
+    TypedPerPointIterator(const NeighborQuery* neighbor_query, const vec3<float> query_point,
+                          unsigned int query_point_idx, QueryArgs args);
+
+    //! Get the next element.
+    virtual NeighborBond next();
+
+private:
+    std::shared_ptr<NeighborQueryPerPointIterator> m_iter; //!< Iterator of the data structure of the type.
+    const unsigned int* m_type_indices;                    //!< Indices of the points of the type.
 };
 
 //! The iterator class for neighbor queries on NeighborQuery objects.
@@ -309,6 +567,7 @@ public:
         : m_neighbor_query(neighbor_query), m_query_points(query_points),
           m_num_query_points(num_query_points), m_qargs(qargs), m_finished(false), m_cur_p(0)
     {
+        validateBondQuery(m_qargs);
         m_iter = this->query(m_cur_p);
     }
 
@@ -324,6 +583,10 @@ public:
     //! Get an iterator for a specific query point by index.
     std::shared_ptr<NeighborQueryPerPointIterator> query(unsigned int i)
     {
+        if (isTypedQuery(m_qargs))
+        {
+            return std::make_shared<TypedPerPointIterator>(m_neighbor_query, m_query_points[i], i, m_qargs);
+        }
         return m_neighbor_query->querySingle(m_query_points[i], i, m_qargs);
     }
 
@@ -355,7 +618,8 @@ public:
 
     //! Generate a NeighborList from query.
     /*! This function exploits parallelism by finding the neighbors for
-     *  each query point in parallel and adding them to a list, which is
+     *  each query point in parallel (using the allocation-free
+     *  DirectNeighborQuery when possible) and adding them to a list, which is
      *  then sorted in parallel as well before being added to the
      *  NeighborList object. Right now this won't be backwards compatible
      *  because the kn query is not symmetric, so even if we reverse the
@@ -366,52 +630,17 @@ public:
      *  the primary use-case is to have this object be managed by instances
      *  of the Cython NeighborList class.
      */
-    NeighborList* toNeighborList(bool sort_by_distance = false)
-    {
-        typedef tbb::enumerable_thread_specific<std::vector<NeighborBond>> BondVector;
-        BondVector bonds;
-        util::forLoopWrapper(0, m_num_query_points, [&](size_t begin, size_t end) {
-            BondVector::reference local_bonds(bonds.local());
-            NeighborBond nb;
-            for (size_t i = begin; i < end; ++i)
-            {
-                std::shared_ptr<NeighborQueryPerPointIterator> it = this->query(i);
-                while (!it->end())
-                {
-                    nb = it->next();
-                    // If we're excluding ii bonds, we have to check before adding.
-                    if (nb != ITERATOR_TERMINATOR)
-                    {
-                        local_bonds.emplace_back(nb.query_point_idx, nb.point_idx, nb.distance);
-                    }
-                }
-            }
-        });
-
-        tbb::flattened2d<BondVector> flat_bonds = tbb::flatten2d(bonds);
-        std::vector<NeighborBond> linear_bonds(flat_bonds.begin(), flat_bonds.end());
-        if (sort_by_distance)
-            tbb::parallel_sort(linear_bonds.begin(), linear_bonds.end(), compareNeighborDistance);
-        else
-            tbb::parallel_sort(linear_bonds.begin(), linear_bonds.end(), compareNeighborBond);
-
-        unsigned int num_bonds = linear_bonds.size();
-
-        NeighborList* nl = new NeighborList();
-        nl->setNumBonds(num_bonds, m_num_query_points, m_neighbor_query->getNPoints());
-
-        util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
-            for (size_t bond = begin; bond < end; ++bond)
-            {
-                nl->getNeighbors()(bond, 0) = linear_bonds[bond].query_point_idx;
-                nl->getNeighbors()(bond, 1) = linear_bonds[bond].point_idx;
-                nl->getDistances()[bond] = linear_bonds[bond].distance;
-                nl->getWeights()[bond] = float(1.0);
-            }
-        });
-
-        return nl;
-    }
+    NeighborList* toNeighborList(bool sort_by_distance = false);
+
+    //! Generate a NeighborList of the bonds of a range of query points.
+    /*! The NeighborList has the same number of query points as the query,
+     *  but only contains the bonds of the query points in
+     *  [begin_query_point, end_query_point), so that the bonds of all query
+     *  points can be converted in chunks of bounded size. The bonds of each
+     *  range are ordered as in the NeighborList of all query points.
+     */
+    NeighborList* toNeighborList(bool sort_by_distance, unsigned int begin_query_point,
+                                 unsigned int end_query_point);
 
     static const NeighborBond ITERATOR_TERMINATOR; //!< The object returned when iteration is complete.
 
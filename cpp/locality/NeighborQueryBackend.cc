@@ -0,0 +1,194 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "AABBQuery.h"
+#include "LinkCell.h"
+#include "NeighborQueryBackend.h"
+
+/*! \file NeighborQueryBackend.cc
+    \brief Chooses the NeighborQuery that RawPoints builds to answer queries.
+*/
+
+namespace freud { namespace locality {
+
+namespace {
+//! How RawPoints objects choose their data structure.
+std::atomic<int> backend_selection(selection_aabb);
+
+//! Kind of system that a calibration applies to.
+typedef std::tuple<int, bool, int, int> CalibrationKey;
+
+//! Data structures chosen by calibration.
+std::map<CalibrationKey, NeighborQueryBackend> calibrations;
+
+//! Serializes access to the calibrations.
+std::mutex calibration_mutex;
+
+//! Number of query points timed by a calibration.
+const unsigned int calibration_sample_size = 1024;
+
+//! Integer base 2 logarithm, with 0 for values below 1.
+int log2Bucket(float x)
+{
+    return (x >= 1) ? static_cast<int>(std::log2(x)) : 0;
+}
+
+//! Expected number of neighbors of each query point.
+float expectedNeighbors(const box::Box& box, unsigned int n_points, const QueryArgs& qargs)
+{
+    if (qargs.mode == QueryArgs::nearest)
+    {
+        return static_cast<float>(qargs.num_neighbors);
+    }
+    const float density = static_cast<float>(n_points) / box.getVolume();
+    const float r_max = qargs.r_max;
+    const float volume = box.is2D() ? static_cast<float>(M_PI) * r_max * r_max
+                                    : static_cast<float>(4.0 / 3.0 * M_PI) * r_max * r_max * r_max;
+    return density * volume;
+}
+
+//! Whether all points are within the box, which LinkCell requires.
+bool pointsInBox(const box::Box& box, const vec3<float>* points, unsigned int n_points)
+{
+    for (unsigned int i = 0; i < n_points; ++i)
+    {
+        const vec3<float> f = box.makeFractional(points[i]);
+        if (f.x < 0 || f.x >= 1 || f.y < 0 || f.y >= 1 || (!box.is2D() && (f.z < 0 || f.z >= 1)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Whether cells of a width fit in the box twice along every dimension.
+bool cellWidthFits(const box::Box& box, float cell_width)
+{
+    const vec3<float> nearest_plane_distance = box.getNearestPlaneDistance();
+    return cell_width * 2 <= nearest_plane_distance.x && cell_width * 2 <= nearest_plane_distance.y
+        && (box.is2D() || cell_width * 2 <= nearest_plane_distance.z);
+}
+
+//! Default LinkCell cell width, giving roughly 10 points per cell (see LinkCell::LinkCell).
+float defaultCellWidth(const box::Box& box, unsigned int n_points)
+{
+    const unsigned int desired_num_cells = std::max(n_points / 10, 1u);
+    return std::cbrt(box.getVolume() / static_cast<float>(desired_num_cells));
+}
+
+//! Seconds taken to build a data structure and query a sample of the points with it.
+double timeBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                   const std::vector<vec3<float>>& sample, const QueryArgs& qargs,
+                   NeighborQueryBackend backend)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<NeighborQuery> nq(makeBackend(box, points, n_points, qargs, backend, false));
+    const auto built = std::chrono::steady_clock::now();
+    QueryArgs sample_args(qargs);
+    sample_args.half = false;
+    std::unique_ptr<NeighborList> nlist(
+        nq->query(sample.data(), static_cast<unsigned int>(sample.size()), sample_args)->toNeighborList());
+    const auto end = std::chrono::steady_clock::now();
+
+    // Scale the query time of the sample to all points.
+    const double build_time = std::chrono::duration<double>(built - start).count();
+    const double query_time = std::chrono::duration<double>(end - built).count();
+    return build_time + query_time * n_points / static_cast<double>(sample.size());
+}
+}; // end anonymous namespace
+
+void setBackendSelection(BackendSelection selection)
+{
+    backend_selection = selection;
+}
+
+BackendSelection getBackendSelection()
+{
+    return static_cast<BackendSelection>(backend_selection.load());
+}
+
+float linkCellWidthForQuery(const box::Box& box, unsigned int n_points, const QueryArgs& qargs)
+{
+    if (qargs.mode == QueryArgs::ball && cellWidthFits(box, qargs.r_max))
+    {
+        return qargs.r_max;
+    }
+    return defaultCellWidth(box, n_points);
+}
+
+NeighborQueryBackend selectBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                   const QueryArgs& qargs, BackendSelection selection)
+{
+    if (selection == selection_aabb || n_points == 0)
+    {
+        return backend_aabb;
+    }
+
+    // Only ball queries are always answered faster by AABBQuery, so other
+    // queries are checked against the LinkCell requirements first.
+    const bool large_nearest_query = qargs.mode == QueryArgs::nearest
+        && static_cast<unsigned long>(qargs.num_neighbors) * 8 > n_points;
+    if (selection == selection_auto && !large_nearest_query)
+    {
+        return backend_aabb;
+    }
+    if (!cellWidthFits(box, linkCellWidthForQuery(box, n_points, qargs))
+        || !pointsInBox(box, points, n_points))
+    {
+        return backend_aabb;
+    }
+    if (selection == selection_auto)
+    {
+        return backend_linkcell;
+    }
+    return calibrateBackend(box, points, n_points, qargs);
+}
+
+NeighborQueryBackend calibrateBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                      const QueryArgs& qargs)
+{
+    const CalibrationKey key(static_cast<int>(qargs.mode), box.is2D(), log2Bucket(n_points),
+                             log2Bucket(expectedNeighbors(box, n_points, qargs)));
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    const auto cached = calibrations.find(key);
+    if (cached != calibrations.end())
+    {
+        return cached->second;
+    }
+
+    // Query an evenly strided sample of the points.
+    const unsigned int sample_size = std::min(n_points, calibration_sample_size);
+    std::vector<vec3<float>> sample(sample_size);
+    for (unsigned int i = 0; i < sample_size; ++i)
+    {
+        sample[i] = points[static_cast<unsigned long>(i) * n_points / sample_size];
+    }
+
+    const double aabb_time = timeBackend(box, points, n_points, sample, qargs, backend_aabb);
+    const double linkcell_time = timeBackend(box, points, n_points, sample, qargs, backend_linkcell);
+    const NeighborQueryBackend backend = (linkcell_time < aabb_time) ? backend_linkcell : backend_aabb;
+    calibrations[key] = backend;
+    return backend;
+}
+
+NeighborQuery* makeBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                           const QueryArgs& qargs, NeighborQueryBackend backend, bool spatial_sort)
+{
+    if (backend == backend_linkcell)
+    {
+        return new LinkCell(box, points, n_points, linkCellWidthForQuery(box, n_points, qargs), true,
+                            spatial_sort);
+    }
+    return new AABBQuery(box, points, n_points, spatial_sort);
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,91 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef NEIGHBOR_QUERY_BACKEND_H
+#define NEIGHBOR_QUERY_BACKEND_H
+
+#include <memory>
+
+#include "Box.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file NeighborQueryBackend.h
+    \brief Chooses the NeighborQuery that RawPoints builds to answer queries.
+*/
+
+namespace freud { namespace locality {
+
+//! Data structures that can answer the queries of RawPoints.
+enum NeighborQueryBackend
+{
+    backend_aabb,    //!< An AABBQuery.
+    backend_linkcell //!< A LinkCell with cells sized for the query.
+};
+
+//! How RawPoints chooses the data structure it builds.
+enum BackendSelection
+{
+    selection_aabb,      //!< Always build an AABBQuery.
+    selection_auto,      //!< Choose from the number of points and the query (see selectBackend).
+    selection_calibrated //!< Time both data structures once per kind of system (see calibrateBackend).
+};
+
+//! Set how RawPoints objects choose the data structure they build, for the whole process.
+void setBackendSelection(BackendSelection selection);
+
+//! Get how RawPoints objects choose the data structure they build.
+BackendSelection getBackendSelection();
+
+//! Choose the data structure for a query of a set of points.
+/*! AABBQuery is faster than LinkCell for ball queries over the whole range
+ *  of system sizes, densities, and numbers of neighbors we measured,
+ *  including the cost of building each structure. LinkCell is faster for
+ *  nearest neighbor queries of a large fraction of a small system, where
+ *  the AABBQuery traverses most of its tree for every query point, so it
+ *  is chosen if num_neighbors is more than an eighth of the points.
+ *
+ *  LinkCell is never chosen for points outside of the box, which it does
+ *  not bin correctly, or if its cells would be wider than half the box.
+ *
+ *  \param box Simulation box.
+ *  \param points Point coordinates.
+ *  \param n_points Number of points.
+ *  \param qargs Resolved query arguments of the first query.
+ *  \param selection How to choose.
+ */
+NeighborQueryBackend selectBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                   const QueryArgs& qargs, BackendSelection selection);
+
+//! Choose the data structure with a micro-benchmark.
+/*! Both data structures are built on the points and queried with a sample
+ *  of them. The faster one, with the query time scaled to all points, is
+ *  cached for all later systems of the same kind: the same query mode and
+ *  dimensions, and numbers of points and expected neighbors within the
+ *  same powers of two.
+ */
+NeighborQueryBackend calibrateBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                                      const QueryArgs& qargs);
+
+//! Get the cell width of a LinkCell for a query.
+/*! Ball queries use cells of width r_max, so that only the neighboring
+ *  cells are searched. Nearest neighbor queries use the default width of
+ *  roughly 10 points per cell.
+ */
+float linkCellWidthForQuery(const box::Box& box, unsigned int n_points, const QueryArgs& qargs);
+
+//! Build the data structure chosen for a query.
+/*! \param box Simulation box.
+ *  \param points Point coordinates.
+ *  \param n_points Number of points.
+ *  \param qargs Resolved query arguments of the first query.
+ *  \param backend The data structure to build.
+ *  \param spatial_sort Whether the points are spatially sorted.
+ *  \returns A new NeighborQuery owned by the caller.
+ */
+NeighborQuery* makeBackend(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+                           const QueryArgs& qargs, NeighborQueryBackend backend, bool spatial_sort);
+
+}; }; // end namespace freud::locality
+
+#endif // NEIGHBOR_QUERY_BACKEND_H
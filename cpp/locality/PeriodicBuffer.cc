@@ -2,8 +2,10 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <stdexcept>
+#include <vector>
 
 #include "PeriodicBuffer.h"
+#include "utils.h"
 
 /*! \file PeriodicBuffer.cc
     \brief Replicates points across periodic boundaries.
@@ -11,6 +13,130 @@
 
 namespace freud { namespace locality {
 
+namespace {
+
+//! Finds the images of points that belong in a periodic buffer.
+/*! Images are found in the order of their image indices. When using a buffer
+ *  "skin distance," images are tested against the buffer box coordinate by
+ *  coordinate. The fractional z coordinate of an image only depends on its z
+ *  image index, and the fractional y coordinate only on its y and z image
+ *  indices, so most images are rejected from a few tests per point without
+ *  computing all of their fractional coordinates. In a box without tilt,
+ *  this tests only the images of points near faces of the box.
+ */
+class ImageFinder
+{
+public:
+    ImageFinder(const NeighborQuery* neighbor_query, const box::Box& box, const box::Box& buffer_box,
+                const vec3<int>& images, bool use_images)
+        : m_neighbor_query(neighbor_query), m_box(box), m_buffer_box(buffer_box), m_images(images),
+          m_first_image(use_images ? vec3<int>(0, 0, 0) : -images), m_use_images(use_images),
+          m_num_j(images.y - m_first_image.y + 1), m_num_k(images.z - m_first_image.z + 1),
+          m_inside_k(m_num_k), m_inside_jk(m_num_j * m_num_k), m_lattice_x(box.getLatticeVector(0)),
+          m_lattice_y(box.getLatticeVector(1)),
+          m_lattice_z(box.is2D() ? vec3<float>() : box.getLatticeVector(2))
+    {}
+
+    //! Call a function with the position of each image of a point in the buffer.
+    template<typename Func> void forEachImage(unsigned int point_id, const Func& f)
+    {
+        const vec3<float> point = (*m_neighbor_query)[point_id];
+        if (!m_use_images)
+        {
+            for (int k = m_first_image.z; k <= m_images.z; k++)
+            {
+                const float frac = m_buffer_box.makeFractional(imagePosition(point, 0, 0, k)).z;
+                m_inside_k[k - m_first_image.z] = m_box.is2D() || (0 <= frac && frac < 1);
+            }
+            for (int j = m_first_image.y; j <= m_images.y; j++)
+            {
+                for (int k = m_first_image.z; k <= m_images.z; k++)
+                {
+                    bool inside = m_inside_k[k - m_first_image.z];
+                    if (inside)
+                    {
+                        const float frac = m_buffer_box.makeFractional(imagePosition(point, 0, j, k)).y;
+                        inside = 0 <= frac && frac < 1;
+                    }
+                    m_inside_jk[(j - m_first_image.y) * m_num_k + k - m_first_image.z] = inside;
+                }
+            }
+        }
+
+        for (int i = m_first_image.x; i <= m_images.x; i++)
+        {
+            for (int j = m_first_image.y; j <= m_images.y; j++)
+            {
+                for (int k = m_first_image.z; k <= m_images.z; k++)
+                {
+                    // Skip the origin image
+                    if (i == 0 && j == 0 && k == 0)
+                    {
+                        continue;
+                    }
+
+                    // Compute the new position for the buffer point,
+                    // shifted by images.
+                    const vec3<float> point_image = imagePosition(point, i, j, k);
+
+                    if (m_use_images)
+                    {
+                        // Wrap the positions back into the buffer box and
+                        // always append them if a number of images was
+                        // specified. Performing the check this way ensures we
+                        // have the correct number of points instead of
+                        // relying on the floating point precision of the
+                        // fractional check below.
+                        f(m_buffer_box.wrap(point_image));
+                    }
+                    else if (m_inside_jk[(j - m_first_image.y) * m_num_k + k - m_first_image.z])
+                    {
+                        // When using a buffer "skin distance," we check the
+                        // fractional coordinates to see if the points are
+                        // inside the buffer box. Unexpected results may occur
+                        // due to numerical imprecision in this check!
+                        const float frac = m_buffer_box.makeFractional(point_image).x;
+                        if (0 <= frac && frac < 1)
+                        {
+                            f(point_image);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    //! Compute the position of an image of a point.
+    vec3<float> imagePosition(const vec3<float>& point, int i, int j, int k) const
+    {
+        vec3<float> point_image = point;
+        point_image += float(i) * m_lattice_x;
+        point_image += float(j) * m_lattice_y;
+        if (!m_box.is2D())
+        {
+            point_image += float(k) * m_lattice_z;
+        }
+        return point_image;
+    }
+
+    const NeighborQuery* m_neighbor_query; //!< The original points.
+    const box::Box& m_box;                 //!< Simulation box of the original points.
+    const box::Box& m_buffer_box;          //!< Simulation box of the replicated points.
+    vec3<int> m_images;                    //!< Largest image index along each axis.
+    vec3<int> m_first_image;               //!< Smallest image index along each axis.
+    bool m_use_images;                     //!< Whether all images are in the buffer.
+    int m_num_j;                           //!< Number of image indices along y.
+    int m_num_k;                           //!< Number of image indices along z.
+    std::vector<char> m_inside_k;          //!< Whether images are inside the buffer box in z.
+    std::vector<char> m_inside_jk;         //!< Whether images are inside the buffer box in y and z.
+    vec3<float> m_lattice_x;               //!< First lattice vector of the box.
+    vec3<float> m_lattice_y;               //!< Second lattice vector of the box.
+    vec3<float> m_lattice_z;               //!< Third lattice vector of the box.
+};
+
+}; // end anonymous namespace
+
 void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_query, const vec3<float> buff,
                              const bool use_images)
 {
@@ -45,69 +171,57 @@ void PeriodicBuffer::compute(const freud::locality::NeighborQuery* neighbor_quer
 
     if (is2D)
     {
-        L.z = 0;
-        xz = 0;
-        yz = 0;
         images.z = 0;
     }
 
-    m_buffer_points.clear();
-    m_buffer_ids.clear();
+    const unsigned int n_points = neighbor_query->getNPoints();
 
-    // for each point
-    for (unsigned int point_id = 0; point_id < neighbor_query->getNPoints(); point_id++)
+    // Count the images of each point, so the images can be written in
+    // parallel into preallocated arrays in the same order as they are found.
+    std::vector<size_t> offsets(n_points + 1, 0);
+    if (use_images)
     {
-        for (int i = use_images ? 0 : -images.x; i <= images.x; i++)
+        const size_t num_images = size_t(images.x + 1) * size_t(images.y + 1) * size_t(images.z + 1) - 1;
+        for (unsigned int point_id = 0; point_id <= n_points; point_id++)
         {
-            for (int j = use_images ? 0 : -images.y; j <= images.y; j++)
+            offsets[point_id] = point_id * num_images;
+        }
+    }
+    else
+    {
+        util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+            ImageFinder finder(neighbor_query, m_box, m_buffer_box, images, use_images);
+            for (size_t point_id = begin; point_id < end; ++point_id)
             {
-                for (int k = use_images ? 0 : -images.z; k <= images.z; k++)
-                {
-                    // Skip the origin image
-                    if (i == 0 && j == 0 && k == 0)
-                    {
-                        continue;
-                    }
-
-                    // Compute the new position for the buffer point,
-                    // shifted by images.
-                    vec3<float> point_image = (*neighbor_query)[point_id];
-                    point_image += float(i) * m_box.getLatticeVector(0);
-                    point_image += float(j) * m_box.getLatticeVector(1);
-                    if (!is2D)
-                    {
-                        point_image += float(k) * m_box.getLatticeVector(2);
-                    }
-
-                    if (use_images)
-                    {
-                        // Wrap the positions back into the buffer box and
-                        // always append them if a number of images was
-                        // specified. Performing the check this way ensures we
-                        // have the correct number of points instead of
-                        // relying on the floating point precision of the
-                        // fractional check below.
-                        m_buffer_points.push_back(m_buffer_box.wrap(point_image));
-                        m_buffer_ids.push_back(point_id);
-                    }
-                    else
-                    {
-                        // When using a buffer "skin distance," we check the
-                        // fractional coordinates to see if the points are
-                        // inside the buffer box. Unexpected results may occur
-                        // due to numerical imprecision in this check!
-                        vec3<float> buff_frac = m_buffer_box.makeFractional(point_image);
-                        if (0 <= buff_frac.x && buff_frac.x < 1 && 0 <= buff_frac.y && buff_frac.y < 1
-                            && (is2D || (0 <= buff_frac.z && buff_frac.z < 1)))
-                        {
-                            m_buffer_points.push_back(point_image);
-                            m_buffer_ids.push_back(point_id);
-                        }
-                    }
-                }
+                size_t count = 0;
+                finder.forEachImage(point_id, [&count](const vec3<float>&) { ++count; });
+                offsets[point_id + 1] = count;
             }
+        });
+        for (unsigned int point_id = 0; point_id < n_points; point_id++)
+        {
+            offsets[point_id + 1] += offsets[point_id];
         }
     }
+
+    m_buffer_points.resize(offsets[n_points]);
+    m_buffer_ids.resize(offsets[n_points]);
+    util::forLoopWrapper(0, n_points, [&](size_t begin, size_t end) {
+        ImageFinder finder(neighbor_query, m_box, m_buffer_box, images, use_images);
+        for (size_t point_id = begin; point_id < end; ++point_id)
+        {
+            size_t index = offsets[point_id];
+            if (index == offsets[point_id + 1])
+            {
+                continue;
+            }
+            finder.forEachImage(point_id, [&](const vec3<float>& point_image) {
+                m_buffer_points[index] = point_image;
+                m_buffer_ids[index] = point_id;
+                ++index;
+            });
+        }
+    });
 }
 
 }; }; // end namespace freud::locality
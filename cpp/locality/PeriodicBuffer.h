@@ -16,6 +16,11 @@
 
 namespace freud { namespace locality {
 
+//! Replicates points across periodic boundaries.
+/*! The images of the points are counted in parallel, and then written in
+ *  parallel into preallocated arrays at offsets given by a prefix sum of the
+ *  counts, in the same order as a serial loop over points and images.
+ */
 class PeriodicBuffer
 {
 public:
@@ -6,12 +6,12 @@
 
 #include <stdexcept>
 
-#include "AABBQuery.h"
 #include "NeighborQuery.h"
+#include "NeighborQueryBackend.h"
 
 /*! \file RawPoints.h
     \brief Defines a simplest NeighborQuery object that actually farms out
-           querying logic to an AABBQuery.
+           querying logic to an AABBQuery or a LinkCell.
 */
 
 namespace freud { namespace locality {
@@ -23,20 +23,31 @@ namespace freud { namespace locality {
  *  indication that the function needs to compute its own NeighborQuery. That
  *  logic, which is primary encapsulated in the NeighborComputeFunctional.h
  *  file, helps provide a nice Python API as well.
+ *
+ *  The data structure is built on the first query, and is chosen for that
+ *  query's arguments as set by setBackendSelection when the object was
+ *  constructed (see selectBackend).
  */
 class RawPoints : public NeighborQuery
 {
 public:
-    RawPoints() {}
+    RawPoints() : m_spatial_sort(false), m_selection(selection_aabb) {}
 
-    RawPoints(const box::Box& box, const vec3<float>* points, unsigned int n_points)
-        : NeighborQuery(box, points, n_points)
+    //! Constructor
+    /*! \param spatial_sort Passed to the underlying data structure (see AABBQuery::AABBQuery).
+     *  \param selection How to choose the data structure. The default is
+     *         read when the object is constructed, since each freud module
+     *         keeps its own copy of the setting of setBackendSelection.
+     */
+    RawPoints(const box::Box& box, const vec3<float>* points, unsigned int n_points,
+              bool spatial_sort = false, BackendSelection selection = getBackendSelection())
+        : NeighborQuery(box, points, n_points), m_spatial_sort(spatial_sort), m_selection(selection)
     {}
 
     ~RawPoints() {}
 
     //! Perform a query based on a set of query parameters.
-    /*! Shadow parent function to ensure that the underlying AABBQuery is
+    /*! Shadow parent function to ensure that the underlying data structure is
      * only constructed when this object is actually queried. Note that unlike
      * the parent function it is not const since it does modify the object.
      *
@@ -47,12 +58,9 @@ public:
     virtual std::shared_ptr<NeighborQueryIterator>
     query(const vec3<float>* query_points, unsigned int n_query_points, QueryArgs query_args) const
     {
-        if (!aq)
-        {
-            aq = std::unique_ptr<AABBQuery>(new AABBQuery(m_box, m_points, m_n_points));
-        }
-
         this->validateQueryArgs(query_args);
+        this->validateTypeQuery(query_args, n_query_points);
+        getQueryObject(query_args);
         return std::make_shared<NeighborQueryIterator>(this, query_points, n_query_points, query_args);
     }
 
@@ -62,15 +70,33 @@ public:
     {
         if (!aq)
         {
-            throw std::runtime_error("The underlying AABBQuery object has not yet been initialized. Please "
-                                     "report this error.");
+            throw std::runtime_error("The underlying NeighborQuery object has not yet been initialized. "
+                                     "Please report this error.");
         }
 
         return aq->querySingle(query_point, query_point_idx, qargs);
     }
 
+    //! Get the NeighborQuery used to perform queries, constructing it if necessary.
+    /*! \param qargs The resolved query arguments used to choose the data
+     *         structure if it is constructed.
+     */
+    const NeighborQuery* getQueryObject(const QueryArgs& qargs) const
+    {
+        if (!aq)
+        {
+            const NeighborQueryBackend backend
+                = selectBackend(m_box, m_points, m_n_points, qargs, m_selection);
+            aq = std::unique_ptr<NeighborQuery>(
+                makeBackend(m_box, m_points, m_n_points, qargs, backend, m_spatial_sort));
+        }
+        return aq.get();
+    }
+
 private:
-    mutable std::unique_ptr<AABBQuery> aq; //!< The AABBQuery object that will be used to perform queries.
+    bool m_spatial_sort;                       //!< Whether the data structure spatially sorts the points.
+    BackendSelection m_selection;              //!< How to choose the data structure.
+    mutable std::unique_ptr<NeighborQuery> aq; //!< The data structure that will be used to perform queries.
 };
 
 }; }; // end namespace freud::locality
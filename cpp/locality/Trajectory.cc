@@ -0,0 +1,44 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+
+#include "AABBQuery.h"
+#include "Trajectory.h"
+
+/*! \file Trajectory.cc
+    \brief Streams the frames of a trajectory to computes that accumulate them.
+*/
+
+namespace freud { namespace locality {
+
+Trajectory::Trajectory(const vec3<float>* points, const float* box_params, unsigned int n_frames,
+                       unsigned int n_points, unsigned int n_boxes, bool is2D)
+    : m_points(points), m_box_params(box_params), m_n_frames(n_frames), m_n_points(n_points),
+      m_n_boxes(n_boxes), m_is2D(is2D)
+{
+    if (n_boxes != 1 && n_boxes != n_frames)
+    {
+        throw std::invalid_argument("A trajectory must have one box or one box per frame.");
+    }
+}
+
+Trajectory::Trajectory(std::shared_ptr<const FrameSource> source)
+    : m_points(nullptr), m_box_params(nullptr), m_n_frames(source->getNFrames()),
+      m_n_points(source->getNPoints()), m_n_boxes(source->getNFrames()), m_is2D(source->is2D()),
+      m_source(source)
+{}
+
+box::Box Trajectory::getBox(unsigned int frame) const
+{
+    const float* params = m_source ? m_source->getBoxParams(frame)
+                                   : m_box_params + 6 * size_t(m_n_boxes == 1 ? 0 : frame);
+    return box::Box(params[0], params[1], params[2], params[3], params[4], params[5], m_is2D);
+}
+
+std::unique_ptr<NeighborQuery> Trajectory::makeNeighborQuery(unsigned int frame) const
+{
+    return std::unique_ptr<NeighborQuery>(new AABBQuery(getBox(frame), getPoints(frame), m_n_points));
+}
+
+}; }; // end namespace freud::locality
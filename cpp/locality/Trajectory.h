@@ -0,0 +1,126 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <memory>
+#include <tbb/task_group.h>
+
+#include "Box.h"
+#include "FrameSource.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file Trajectory.h
+    \brief Streams the frames of a trajectory to computes that accumulate them.
+*/
+
+namespace freud { namespace locality {
+
+//! Frames of points in periodic boxes, such as a memory-mapped trajectory.
+/*! The points of all frames are stored contiguously, with shape
+ *  (n_frames, n_points, 3). The box of each frame is given by its parameters
+ *  (Lx, Ly, Lz, xy, xz, yz), either once per frame or once for all frames.
+ *  The arrays are not copied and must remain valid while the trajectory is
+ *  used, so they may be views of files mapped into memory. Alternatively,
+ *  the frames are read from a FrameSource, which is kept alive by the
+ *  trajectory.
+ *
+ *  forEachFrame builds the NeighborQuery of the next frame while the current
+ *  frame is accumulated. Building the query reads all points of the frame, so
+ *  reading a memory-mapped file overlaps with computation, and the source is
+ *  asked to prefetch the frame after the next one.
+ */
+class Trajectory
+{
+public:
+    //! Constructor
+    /*! \param points Points of all frames, of shape (n_frames, n_points, 3).
+     *  \param box_params Parameters (Lx, Ly, Lz, xy, xz, yz) of the box of
+     *         each frame, or of all frames if n_boxes is 1.
+     *  \param n_frames Number of frames.
+     *  \param n_points Number of points in each frame.
+     *  \param n_boxes Number of boxes, either 1 or n_frames.
+     *  \param is2D Whether the boxes are two-dimensional.
+     */
+    Trajectory(const vec3<float>* points, const float* box_params, unsigned int n_frames,
+               unsigned int n_points, unsigned int n_boxes, bool is2D);
+
+    //! Constructor
+    /*! \param source Source of the frames.
+     */
+    explicit Trajectory(std::shared_ptr<const FrameSource> source);
+
+    //! Get the number of frames
+    unsigned int getNFrames() const
+    {
+        return m_n_frames;
+    }
+
+    //! Get the number of points in each frame
+    unsigned int getNPoints() const
+    {
+        return m_n_points;
+    }
+
+    //! Get the points of a frame
+    const vec3<float>* getPoints(unsigned int frame) const
+    {
+        if (m_source)
+        {
+            return m_source->getPoints(frame);
+        }
+        return m_points + size_t(frame) * m_n_points;
+    }
+
+    //! Get the box of a frame
+    box::Box getBox(unsigned int frame) const;
+
+    //! Build the NeighborQuery of a frame.
+    std::unique_ptr<NeighborQuery> makeNeighborQuery(unsigned int frame) const;
+
+    //! Call a function for each frame in order.
+    /*! \param accumulate_frame A function with signature
+     *         void(const NeighborQuery*, unsigned int frame). It is called
+     *         from the calling thread, one frame at a time, so it may
+     *         accumulate into a compute that is not thread safe.
+     */
+    template<typename Func> void forEachFrame(Func accumulate_frame) const
+    {
+        if (m_n_frames == 0)
+        {
+            return;
+        }
+        std::unique_ptr<NeighborQuery> current(makeNeighborQuery(0));
+        for (unsigned int frame = 0; frame < m_n_frames; ++frame)
+        {
+            std::unique_ptr<NeighborQuery> next;
+            tbb::task_group prefetch;
+            if (frame + 1 < m_n_frames)
+            {
+                if (m_source)
+                {
+                    m_source->prefetch(frame + 2);
+                }
+                prefetch.run([this, frame, &next]() { next = makeNeighborQuery(frame + 1); });
+            }
+            accumulate_frame(current.get(), frame);
+            prefetch.wait();
+            current = std::move(next);
+        }
+    }
+
+private:
+    const vec3<float>* m_points;                 //!< Points of all frames.
+    const float* m_box_params;                   //!< Box parameters of each frame.
+    unsigned int m_n_frames;                     //!< Number of frames.
+    unsigned int m_n_points;                     //!< Number of points in each frame.
+    unsigned int m_n_boxes;                      //!< Number of boxes, either 1 or m_n_frames.
+    bool m_is2D;                                 //!< Whether the boxes are two-dimensional.
+    std::shared_ptr<const FrameSource> m_source; //!< Source of the frames, if any.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // TRAJECTORY_H
@@ -0,0 +1,106 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+
+#include "VerletList.h"
+
+/*! \file VerletList.cc
+    \brief Reuses neighbor lists across trajectory frames with a skin distance.
+*/
+
+namespace freud { namespace locality {
+
+VerletList::VerletList(float r_max, float skin, float r_min, bool exclude_ii)
+    : m_r_max(r_max), m_skin(skin), m_r_min(r_min), m_exclude_ii(exclude_ii),
+      m_neighbor_list(std::make_shared<NeighborList>()), m_num_builds(0)
+{
+    if (r_max <= 0)
+        throw std::invalid_argument("VerletList requires r_max to be positive.");
+    if (skin < 0)
+        throw std::invalid_argument("VerletList requires skin to be non-negative.");
+    if (r_min < 0)
+        throw std::invalid_argument("VerletList requires r_min to be non-negative.");
+    if (r_max <= r_min)
+        throw std::invalid_argument("VerletList requires that r_max must be greater than r_min.");
+}
+
+float VerletList::maxDisplacementSquared(const vec3<float>* points,
+                                         const std::vector<vec3<float>>& ref_points) const
+{
+    tbb::enumerable_thread_specific<float> local_max(0);
+    util::forLoopWrapper(0, ref_points.size(), [&](size_t begin, size_t end) {
+        float& thread_max = local_max.local();
+        for (size_t i = begin; i < end; ++i)
+        {
+            const vec3<float> delta(m_box.wrap(points[i] - ref_points[i]));
+            thread_max = std::max(thread_max, dot(delta, delta));
+        }
+    });
+    return local_max.combine([](float a, float b) { return std::max(a, b); });
+}
+
+bool VerletList::needsRebuild(const NeighborQuery* nq, const vec3<float>* query_points,
+                              unsigned int n_query_points) const
+{
+    if (!m_padded_nlist || nq->getBox() != m_box || nq->getNPoints() != m_ref_points.size()
+        || n_query_points != m_ref_query_points.size())
+    {
+        return true;
+    }
+
+    // Bonds can only have entered the ball of radius r_max if the sum of the
+    // displacements of the two points exceeds the skin.
+    const float max_displacement = m_skin / float(2.0);
+    const float max_displacement_sq = max_displacement * max_displacement;
+    return (maxDisplacementSquared(nq->getPoints(), m_ref_points) > max_displacement_sq)
+        || (maxDisplacementSquared(query_points, m_ref_query_points) > max_displacement_sq);
+}
+
+void VerletList::compute(const NeighborQuery* nq, const vec3<float>* query_points,
+                         unsigned int n_query_points)
+{
+    if (needsRebuild(nq, query_points, n_query_points))
+    {
+        m_box = nq->getBox();
+        m_ref_points.assign(nq->getPoints(), nq->getPoints() + nq->getNPoints());
+        m_ref_query_points.assign(query_points, query_points + n_query_points);
+
+        QueryArgs qargs;
+        qargs.mode = QueryArgs::ball;
+        qargs.r_max = m_r_max + m_skin;
+        // Pairs closer than r_min may also move past it before the next rebuild.
+        qargs.r_min = std::max(float(0), m_r_min - m_skin);
+        qargs.exclude_ii = m_exclude_ii;
+        m_padded_nlist = std::shared_ptr<NeighborList>(
+            nq->query(query_points, n_query_points, qargs)->toNeighborList());
+        ++m_num_builds;
+    }
+
+    // Recompute the distances and vectors of all padded bonds for the current positions
+    // and keep the ones within the query distance.
+    // The same NeighborList object is reused so that references to it held
+    // by callers stay valid.
+    std::shared_ptr<NeighborList> nlist = m_neighbor_list;
+    nlist->copy(*m_padded_nlist);
+    const vec3<float>* points = nq->getPoints();
+    util::forLoopWrapper(0, nlist->getNumBonds(), [&](size_t begin, size_t end) {
+        for (size_t bond = begin; bond < end; ++bond)
+        {
+            const unsigned int i = nlist->getQueryPointIndices()[bond];
+            const unsigned int j = nlist->getPointIndices()[bond];
+            const vec3<float> r_ij(m_box.wrap(points[j] - query_points[i]));
+            nlist->getDistances()[bond] = std::sqrt(dot(r_ij, r_ij));
+            if (nlist->hasVectors())
+            {
+                nlist->getVectors()[bond] = r_ij;
+            }
+        }
+    });
+    nlist->filter_r(m_r_max, m_r_min);
+}
+
+}; }; // end namespace freud::locality
@@ -0,0 +1,102 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef VERLET_LIST_H
+#define VERLET_LIST_H
+
+#include <memory>
+#include <vector>
+
+#include "Box.h"
+#include "NeighborList.h"
+#include "NeighborQuery.h"
+#include "VectorMath.h"
+
+/*! \file VerletList.h
+    \brief Reuses neighbor lists across trajectory frames with a skin distance.
+*/
+
+namespace freud { namespace locality {
+
+//! Neighbor list that is only rebuilt when points have moved far enough.
+/*! On each call to compute, ball query neighbors within r_max are found.
+ *  When the list is built, neighbors are found from r_min - skin out to
+ *  r_max + skin and the positions of all points are stored. On subsequent
+ *  calls, if no point (or query point) has moved farther than half of the
+ *  skin since the last build, every pair now between r_min and r_max must
+ *  already be in the padded list, so the result is obtained by recomputing
+ *  the distances of the padded bonds and filtering them. Otherwise, the
+ *  padded list is rebuilt.
+ *
+ *  The result matches a direct ball query with the same arguments, except
+ *  possibly for bonds whose length is within floating point rounding of
+ *  r_max or r_min.
+ */
+class VerletList
+{
+public:
+    //! Constructor
+    /*! \param r_max Distance within which neighbors are found.
+     *  \param skin Extra distance included when building the padded list.
+     *  \param r_min Minimum distance of neighbors.
+     *  \param exclude_ii Whether to exclude bonds where the point and query point indices are equal.
+     */
+    VerletList(float r_max, float skin, float r_min = 0, bool exclude_ii = false);
+
+    //! Compute the neighbor list, reusing the padded list if possible.
+    void compute(const NeighborQuery* nq, const vec3<float>* query_points, unsigned int n_query_points);
+
+    //! Force the padded list to be rebuilt on the next call to compute.
+    void reset()
+    {
+        m_padded_nlist.reset();
+    }
+
+    //! Get the neighbor list computed on the last call to compute.
+    std::shared_ptr<NeighborList> getNeighborList() const
+    {
+        return m_neighbor_list;
+    }
+
+    //! Get the number of times the padded list has been built.
+    unsigned int getNumBuilds() const
+    {
+        return m_num_builds;
+    }
+
+    //! Get the query distance.
+    float getRMax() const
+    {
+        return m_r_max;
+    }
+
+    //! Get the skin distance.
+    float getSkin() const
+    {
+        return m_skin;
+    }
+
+private:
+    //! Determine whether the padded list is invalid for the provided points.
+    bool needsRebuild(const NeighborQuery* nq, const vec3<float>* query_points,
+                      unsigned int n_query_points) const;
+
+    //! Compute the maximum squared displacement between two sets of points.
+    float maxDisplacementSquared(const vec3<float>* points, const std::vector<vec3<float>>& ref_points) const;
+
+    float m_r_max;     //!< Distance within which neighbors are found.
+    float m_skin;      //!< Extra distance included in the padded list.
+    float m_r_min;     //!< Minimum distance of neighbors.
+    bool m_exclude_ii; //!< Whether to exclude ii bonds.
+
+    box::Box m_box;                                //!< Box used when the padded list was built.
+    std::vector<vec3<float>> m_ref_points;         //!< Points when the padded list was built.
+    std::vector<vec3<float>> m_ref_query_points;   //!< Query points when the padded list was built.
+    std::shared_ptr<NeighborList> m_padded_nlist;  //!< Neighbors within r_max + skin at the last build.
+    std::shared_ptr<NeighborList> m_neighbor_list; //!< Neighbors within r_max for the current points.
+    unsigned int m_num_builds;                     //!< Number of times the padded list was built.
+};
+
+}; }; // end namespace freud::locality
+
+#endif // VERLET_LIST_H
@@ -1,7 +1,10 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <cmath>
+#include <memory>
+#include <tbb/enumerable_thread_specific.h>
 #include <tbb/parallel_sort.h>
 #include <vector>
 
@@ -14,14 +17,59 @@
 
 namespace freud { namespace locality {
 
+namespace {
+
+//! Cell computation state and computed cells of one thread.
+struct VoronoiWorker
+{
+    //! Scratch space of cell computations, which voro++ keeps in the container
+    //! for its own loops and so cannot be shared between threads.
+    std::unique_ptr<voro::voro_compute<voro::container_periodic>> compute;
+    voro::voronoicell_neighbor cell;
+    std::vector<double> face_areas;
+    std::vector<int> neighbors;
+    std::vector<double> normals;
+    std::vector<double> vertices;
+    std::vector<vec3<double>> relative_vertices;
+
+    std::vector<NeighborBond> bonds;             //!< Bonds of the computed cells.
+    std::vector<unsigned int> point_ids;         //!< Point of each computed cell.
+    std::vector<size_t> vertex_offsets;          //!< Offset of the vertices of each computed cell.
+    std::vector<vec3<double>> polytope_vertices; //!< Vertices of the computed cells.
+};
+
+}; // namespace
+
+std::vector<std::vector<vec3<double>>> Voronoi::getPolytopes() const
+{
+    const size_t n_points = (m_polytope_offsets.size() == 0) ? 0 : m_polytope_offsets.size() - 1;
+    std::vector<std::vector<vec3<double>>> polytopes(n_points);
+    for (size_t i = 0; i < n_points; ++i)
+    {
+        polytopes[i].assign(m_polytope_vertices.get() + m_polytope_offsets[i],
+                            m_polytope_vertices.get() + m_polytope_offsets[i + 1]);
+    }
+    return polytopes;
+}
+
 // Voronoi calculations should be kept in double precision.
 void Voronoi::compute(const freud::locality::NeighborQuery* nq)
 {
     auto box = nq->getBox();
     auto n_points = nq->getNPoints();
+    const bool compute_volumes = m_outputs != voronoi_neighbors;
+    const bool compute_polytopes = m_outputs == voronoi_polytopes;
 
-    m_polytopes.resize(n_points);
-    m_volumes.prepare(n_points);
+    // Outputs that are not computed are left empty rather than holding the
+    // results of a previous compute.
+    if (compute_volumes)
+    {
+        m_volumes.prepare(n_points);
+    }
+    else
+    {
+        m_volumes = util::ManagedArray<double>();
+    }
 
     vec3<float> boxLatticeVectors[3];
     boxLatticeVectors[0] = box.getLatticeVector(0);
@@ -55,130 +103,216 @@ void Voronoi::compute(const freud::locality::NeighborQuery* nq)
         container.put(query_point_id, query_point.x, query_point.y, query_point.z);
     }
 
-    voro::voronoicell_neighbor cell;
-    voro::c_loop_all_periodic voronoi_loop(container);
-    std::vector<double> face_areas;
-    std::vector<int> face_vertices;
-    std::vector<int> neighbors;
-    std::vector<double> normals;
-    std::vector<double> vertices;
-    std::vector<NeighborBond> bonds;
+    // The container creates periodic images of blocks on demand while cells
+    // are computed. Creating all of them first leaves the container unchanged
+    // by cell computations, so cells of different blocks can be computed
+    // concurrently.
+    container.create_all_images();
 
-    if (voronoi_loop.start())
-    {
-        do
+    // Blocks of the primary domain have indices i in [0, nx), j in [ey, wy),
+    // and k in [ez, wz) of the container's grid, which includes the blocks of
+    // periodic images.
+    const size_t num_blocks_x = container.nx;
+    const size_t num_blocks_y = container.wy - container.ey;
+    const size_t num_blocks_z = container.wz - container.ez;
+
+    tbb::enumerable_thread_specific<VoronoiWorker> workers;
+    util::forLoopWrapper(0, num_blocks_x * num_blocks_y * num_blocks_z, [&](size_t begin, size_t end) {
+        VoronoiWorker& worker = workers.local();
+        if (!worker.compute)
         {
-            container.compute_cell(cell, voronoi_loop);
-
-            // Get id and position of current particle
-            const int query_point_id(voronoi_loop.pid());
-            vec3<double> query_point(voronoi_loop.x(), voronoi_loop.y(), voronoi_loop.z());
-
-            // Get Voronoi cell properties
-            cell.face_areas(face_areas);
-            cell.face_vertices(face_vertices);
-            cell.neighbors(neighbors);
-            cell.normals(normals);
-            cell.vertices(query_point.x, query_point.y, query_point.z, vertices);
-
-            // Compute polytope vertices in relative coordinates
-            std::vector<vec3<double>> relative_vertices;
-            auto vertex_iterator = vertices.begin();
-            while (vertex_iterator != vertices.end())
+            // These image extents match the container's own voro_compute.
+            worker.compute.reset(new voro::voro_compute<voro::container_periodic>(
+                container, 2 * container.nx + 1, 2 * container.ey + 1, 2 * container.ez + 1));
+        }
+        voro::voronoicell_neighbor& cell = worker.cell;
+
+        for (size_t block = begin; block < end; ++block)
+        {
+            const int i = block % num_blocks_x;
+            const int j = (block / num_blocks_x) % num_blocks_y + container.ey;
+            const int k = block / (num_blocks_x * num_blocks_y) + container.ez;
+            const int ijk = i + container.nx * (j + container.oy * k);
+
+            for (int q = 0; q < container.co[ijk]; ++q)
             {
-                double vert_x = *vertex_iterator;
-                vertex_iterator++;
-                double vert_y = *vertex_iterator;
-                vertex_iterator++;
-                double vert_z = *vertex_iterator;
-                vertex_iterator++;
-
-                // In 2D systems, only use vertices from the upper plane
-                // to prevent double-counting, and set z=0 manually
+                if (!worker.compute->compute_cell(cell, ijk, q, i, j, k))
+                {
+                    continue;
+                }
+
+                // Get id and position of current particle
+                const int query_point_id(container.id[ijk][q]);
+                const double* position = container.p[ijk] + container.ps * q;
+                vec3<double> query_point(position[0], position[1], position[2]);
+
+                // Get Voronoi cell properties. Normals are only needed to
+                // find the faces between the planes of 2D systems.
+                cell.face_areas(worker.face_areas);
+                cell.neighbors(worker.neighbors);
                 if (box.is2D())
                 {
-                    if (vert_z < 0)
+                    cell.normals(worker.normals);
+                }
+                const vec3<double> query_point_system_coords((*nq)[query_point_id]);
+
+                if (compute_polytopes)
+                {
+                    cell.vertices(query_point.x, query_point.y, query_point.z, worker.vertices);
+
+                    // Compute polytope vertices in relative coordinates
+                    std::vector<vec3<double>>& relative_vertices = worker.relative_vertices;
+                    relative_vertices.clear();
+                    auto vertex_iterator = worker.vertices.begin();
+                    while (vertex_iterator != worker.vertices.end())
+                    {
+                        double vert_x = *vertex_iterator;
+                        vertex_iterator++;
+                        double vert_y = *vertex_iterator;
+                        vertex_iterator++;
+                        double vert_z = *vertex_iterator;
+                        vertex_iterator++;
+
+                        // In 2D systems, only use vertices from the upper plane
+                        // to prevent double-counting, and set z=0 manually
+                        if (box.is2D())
+                        {
+                            if (vert_z < 0)
+                            {
+                                continue;
+                            }
+                            vert_z = 0;
+                        }
+                        vec3<double> delta = vec3<double>(vert_x, vert_y, vert_z) - query_point;
+                        relative_vertices.push_back(delta);
+                    }
+
+                    // Sort relative vertices by their angle in 2D systems
+                    if (box.is2D())
+                    {
+                        std::sort(relative_vertices.begin(), relative_vertices.end(),
+                                  [](const vec3<double> a, const vec3<double> b) {
+                                      return std::atan2(a.y, a.x) < std::atan2(b.y, b.x);
+                                  });
+                    }
+
+                    // Save polytope vertices in system coordinates
+                    worker.point_ids.push_back(query_point_id);
+                    worker.vertex_offsets.push_back(worker.polytope_vertices.size());
+                    for (const vec3<double>& relative_vertex : relative_vertices)
+                    {
+                        worker.polytope_vertices.push_back(relative_vertex + query_point_system_coords);
+                    }
+                }
+
+                // Save cell volume
+                if (compute_volumes)
+                {
+                    m_volumes[query_point_id] = cell.volume();
+                }
+
+                // Compute cell neighbors
+                size_t neighbor_counter(0);
+                for (auto neighbor_iterator = worker.neighbors.begin();
+                     neighbor_iterator != worker.neighbors.end(); neighbor_iterator++, neighbor_counter++)
+                {
+                    // Ignore bonds in 2D systems that point up or down. This
+                    // check should only be dealing with bonds whose normal
+                    // vectors' z components are -1, 0, or +1 (within some
+                    // tolerance).
+                    if (box.is2D() && std::abs(worker.normals[3 * neighbor_counter + 2]) > 0.5)
                     {
                         continue;
                     }
-                    vert_z = 0;
+
+                    // Fetch neighbor information
+                    const int point_id = *neighbor_iterator;
+                    const float weight(worker.face_areas[neighbor_counter]);
+                    const vec3<double> point_system_coords((*nq)[point_id]);
+
+                    // Compute the distance from query_point to point.
+                    const vec3<float> rij = box.wrap(point_system_coords - query_point_system_coords);
+                    const float distance(std::sqrt(dot(rij, rij)));
+
+                    worker.bonds.push_back(NeighborBond(query_point_id, point_id, distance, weight, rij));
                 }
-                vec3<double> delta = vec3<double>(vert_x, vert_y, vert_z) - query_point;
-                relative_vertices.push_back(delta);
             }
+        }
+    });
 
-            // Sort relative vertices by their angle in 2D systems
-            if (box.is2D())
-            {
-                std::sort(relative_vertices.begin(), relative_vertices.end(),
-                          [](const vec3<double> a, const vec3<double> b) {
-                              return std::atan2(a.y, a.x) < std::atan2(b.y, b.x);
-                          });
-            }
+    std::vector<VoronoiWorker*> worker_list;
+    size_t num_bonds = 0;
+    for (auto worker = workers.begin(); worker != workers.end(); ++worker)
+    {
+        worker->vertex_offsets.push_back(worker->polytope_vertices.size());
+        worker_list.push_back(&(*worker));
+        num_bonds += worker->bonds.size();
+    }
 
-            // Save polytope vertices in system coordinates
-            std::vector<vec3<double>> system_vertices;
-            const vec3<double> query_point_system_coords((*nq)[query_point_id]);
-            for (auto vertex_iter = relative_vertices.begin(); vertex_iter != relative_vertices.end();
-                 vertex_iter++)
+    // Gather the polytopes of all threads into the flat vertex array, in the
+    // order of points.
+    if (compute_polytopes)
+    {
+        m_polytope_offsets.prepare(n_points + 1);
+        for (const VoronoiWorker* worker : worker_list)
+        {
+            for (size_t c = 0; c < worker->point_ids.size(); ++c)
             {
-                system_vertices.push_back((*vertex_iter) + query_point_system_coords);
+                m_polytope_offsets[worker->point_ids[c] + 1]
+                    = worker->vertex_offsets[c + 1] - worker->vertex_offsets[c];
             }
-            m_polytopes[query_point_id] = system_vertices;
-
-            // Save cell volume
-            m_volumes[query_point_id] = cell.volume();
+        }
+        for (size_t i = 0; i < n_points; ++i)
+        {
+            m_polytope_offsets[i + 1] += m_polytope_offsets[i];
+        }
 
-            // Compute cell neighbors
-            size_t neighbor_counter(0);
-            for (auto neighbor_iterator = neighbors.begin(); neighbor_iterator != neighbors.end();
-                 neighbor_iterator++, neighbor_counter++)
-            {
-                // Get the normal to the current face
-                const vec3<double> normal(normals[3 * neighbor_counter], normals[3 * neighbor_counter + 1],
-                                          normals[3 * neighbor_counter + 2]);
-
-                // Ignore bonds in 2D systems that point up or down. This check
-                // should only be dealing with bonds whose normal vectors' z
-                // components are -1, 0, or +1 (within some tolerance).
-                if (box.is2D() && std::abs(normal.z) > 0.5)
+        m_polytope_vertices.prepare(m_polytope_offsets[n_points]);
+        for (const VoronoiWorker* worker : worker_list)
+        {
+            util::forLoopWrapper(0, worker->point_ids.size(), [&](size_t begin, size_t end) {
+                for (size_t c = begin; c < end; ++c)
                 {
-                    continue;
+                    std::copy(worker->polytope_vertices.begin() + worker->vertex_offsets[c],
+                              worker->polytope_vertices.begin() + worker->vertex_offsets[c + 1],
+                              m_polytope_vertices.get() + m_polytope_offsets[worker->point_ids[c]]);
                 }
+            });
+        }
+    }
+    else
+    {
+        m_polytope_offsets = util::ManagedArray<size_t>();
+        m_polytope_vertices = util::ManagedArray<vec3<double>>();
+    }
 
-                // Fetch neighbor information
-                const int point_id = *neighbor_iterator;
-                const float weight(face_areas[neighbor_counter]);
-                const vec3<double> point_system_coords((*nq)[point_id]);
-
-                // Compute the distance from query_point to point.
-                const vec3<float> rij = box.wrap(point_system_coords - query_point_system_coords);
-                const float distance(std::sqrt(dot(rij, rij)));
-
-                bonds.push_back(NeighborBond(query_point_id, point_id, distance, weight));
-            }
-
-        } while (voronoi_loop.inc());
+    std::vector<NeighborBond> bonds(num_bonds);
+    size_t bond_offset = 0;
+    for (const VoronoiWorker* worker : worker_list)
+    {
+        std::copy(worker->bonds.begin(), worker->bonds.end(), bonds.begin() + bond_offset);
+        bond_offset += worker->bonds.size();
     }
 
     tbb::parallel_sort(bonds.begin(), bonds.end(), [](const NeighborBond& n1, const NeighborBond& n2) {
         return n1.less_id_ref_weight(n2);
     });
 
-    unsigned int num_bonds = bonds.size();
-
     m_neighbor_list->resize(num_bonds);
     m_neighbor_list->setNumBonds(num_bonds, n_points, n_points);
+    m_neighbor_list->setHasVectors(true);
 
-    util::forLoopWrapper(0, num_bonds, [=](size_t begin, size_t end) {
+    util::forLoopWrapper(0, num_bonds, [&](size_t begin, size_t end) {
         for (size_t bond = begin; bond != end; ++bond)
         {
-            m_neighbor_list->getNeighbors()(bond, 0) = bonds[bond].query_point_idx;
-            m_neighbor_list->getNeighbors()(bond, 1) = bonds[bond].point_idx;
+            m_neighbor_list->getQueryPointIndices()[bond] = bonds[bond].query_point_idx;
+            m_neighbor_list->getPointIndices()[bond] = bonds[bond].point_idx;
             m_neighbor_list->getDistances()[bond] = bonds[bond].distance;
             m_neighbor_list->getWeights()[bond] = bonds[bond].weight;
+            m_neighbor_list->getVectors()[bond] = bonds[bond].vector;
         }
     });
+    m_neighbor_list->updateSegmentCounts();
 }
 
 }; }; // end namespace freud::locality
@@ -13,11 +13,42 @@
 
 namespace freud { namespace locality {
 
+//! Outputs computed by Voronoi, each including the previous ones.
+enum VoronoiOutputs
+{
+    voronoi_neighbors, //!< Only the neighbor list, weighted by face areas (lengths in 2D).
+    voronoi_volumes,   //!< The neighbor list and cell volumes (areas in 2D).
+    voronoi_polytopes  //!< The neighbor list, cell volumes, and polytope vertices.
+};
+
+//! Computes the Voronoi diagram of a set of points with voro++.
+/*! The points are stored in a single periodic voro++ container, and the cells
+ *  of its blocks are computed in parallel. Each thread computes cells with
+ *  its own voro++ cell computation state and stores them in its own buffers,
+ *  which are gathered once all cells are computed.
+ *
+ *  The vertices of all polytopes are stored in one flat array, where the
+ *  vertices of the polytope of point i are those between offsets i and i + 1.
+ *
+ *  Outputs other than the neighbor list can be skipped, which avoids
+ *  querying voro++ for the cell vertices and volumes and allocating them.
+ *  Arrays of outputs that were not computed are empty.
+ */
 class Voronoi
 {
 public:
-    // default constructor
-    Voronoi() : m_neighbor_list(std::make_shared<NeighborList>()) {}
+    //! Constructor
+    /*! \param outputs Outputs to compute.
+     */
+    explicit Voronoi(VoronoiOutputs outputs = voronoi_polytopes)
+        : m_outputs(outputs), m_neighbor_list(std::make_shared<NeighborList>())
+    {}
+
+    //! Get the outputs to compute.
+    VoronoiOutputs getOutputs() const
+    {
+        return m_outputs;
+    }
 
     void compute(const freud::locality::NeighborQuery* nq);
 
@@ -26,9 +57,19 @@ public:
         return m_neighbor_list;
     }
 
-    const std::vector<std::vector<vec3<double>>> getPolytopes() const
+    //! Get the vertices of each polytope, built from the flat vertex array.
+    std::vector<std::vector<vec3<double>>> getPolytopes() const;
+
+    //! Get the vertices of all polytopes in system coordinates.
+    const util::ManagedArray<vec3<double>>& getPolytopeVertices() const
+    {
+        return m_polytope_vertices;
+    }
+
+    //! Get the offset of the vertices of each polytope, with a final entry for the number of vertices.
+    const util::ManagedArray<size_t>& getPolytopeOffsets() const
     {
-        return m_polytopes;
+        return m_polytope_offsets;
     }
 
     const util::ManagedArray<double>& getVolumes() const
@@ -38,9 +79,11 @@ public:
 
 private:
     box::Box m_box;
-    std::shared_ptr<NeighborList> m_neighbor_list;      //!< Stored neighbor list
-    std::vector<std::vector<vec3<double>>> m_polytopes; //!< Voronoi polytopes
-    util::ManagedArray<double> m_volumes;               //!< Voronoi cell volumes
+    VoronoiOutputs m_outputs;                             //!< Outputs to compute
+    std::shared_ptr<NeighborList> m_neighbor_list;        //!< Stored neighbor list
+    util::ManagedArray<vec3<double>> m_polytope_vertices; //!< Vertices of all Voronoi polytopes
+    util::ManagedArray<size_t> m_polytope_offsets;        //!< Offset of the vertices of each polytope
+    util::ManagedArray<double> m_volumes;                 //!< Voronoi cell volumes
 };
 }; }; // end namespace freud::locality
 
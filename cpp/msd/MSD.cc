@@ -0,0 +1,279 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "MSD.h"
+#include "ParallelAccumulator.h"
+#include "utils.h"
+
+/*! \file MSD.cc
+    \brief Computes mean squared displacements of particles over trajectories.
+*/
+
+namespace freud { namespace msd {
+
+namespace {
+
+//! Get a component of a vector by index.
+inline double component(const vec3<double>& v, unsigned int i)
+{
+    return (i == 0) ? v.x : ((i == 1) ? v.y : v.z);
+}
+
+}; // namespace
+
+MSD::MSD(const box::Box& box, MSDMode mode)
+    : m_box(box), m_mode(mode), m_n_frames(0), m_n_particles(0), m_reduce_msd(true),
+      m_reduce_particle_msd(true)
+{}
+
+void MSD::reset()
+{
+    m_n_frames = 0;
+    m_n_particles = 0;
+    m_particle_msd_data.clear();
+    m_msd_sum.clear();
+    m_reduce_msd = true;
+    m_reduce_particle_msd = true;
+}
+
+void MSD::readPositions(const vec3<float>* positions, const vec3<int>* images, size_t frame_stride,
+                        vec3<double>* result) const
+{
+    const vec3<double> lattice_vectors[3]
+        = {vec3<double>(m_box.getLatticeVector(0)), vec3<double>(m_box.getLatticeVector(1)),
+           m_box.is2D() ? vec3<double>() : vec3<double>(m_box.getLatticeVector(2))};
+
+    // The MSD does not depend on the origin, and positions relative to the
+    // first frame keep their precision for large unwrapped coordinates.
+    vec3<double> origin;
+    for (size_t frame = 0; frame < m_n_frames; ++frame)
+    {
+        vec3<double> r(positions[frame * frame_stride]);
+        if (images != nullptr)
+        {
+            const vec3<int>& image = images[frame * frame_stride];
+            r += lattice_vectors[0] * double(image.x) + lattice_vectors[1] * double(image.y)
+                + lattice_vectors[2] * double(image.z);
+        }
+        if (frame == 0)
+        {
+            origin = r;
+        }
+        result[frame] = r - origin;
+    }
+}
+
+void MSD::computeWindowPair(PairBuffers& buffers, unsigned int n_pair, float* const particle_msd[2]) const
+{
+    const size_t n_frames = m_n_frames;
+    const size_t padded_n = m_fft->size();
+
+    // The six coordinate sequences of the pair are packed in order into the
+    // real and imaginary parts of three zero-padded complex sequences.
+    buffers.transforms.assign(3 * padded_n, std::complex<double>(0));
+    for (unsigned int sequence = 0; sequence < 3 * n_pair; ++sequence)
+    {
+        const std::vector<vec3<double>>& positions = buffers.positions[sequence / 3];
+        std::complex<double>* transform = &buffers.transforms[(sequence / 2) * padded_n];
+        for (size_t frame = 0; frame < n_frames; ++frame)
+        {
+            const double value = component(positions[frame], sequence % 3);
+            if (sequence % 2 == 0)
+            {
+                transform[frame].real(value);
+            }
+            else
+            {
+                transform[frame].imag(value);
+            }
+        }
+    }
+    for (unsigned int t = 0; t < 3; ++t)
+    {
+        m_fft->transform(&buffers.transforms[t * padded_n], 1, false, buffers.work);
+    }
+
+    // The transforms X and Y of the real and imaginary parts of a packed
+    // sequence Z are X_k = (Z_k + conj(Z_-k)) / 2 and
+    // Y_k = (Z_k - conj(Z_-k)) / 2i. The power spectra of the two particles
+    // are packed into one sequence, whose inverse transform holds their
+    // autocorrelations in its real and imaginary parts.
+    buffers.spectra.assign(padded_n, std::complex<double>(0));
+    for (unsigned int t = 0; t < 3; ++t)
+    {
+        const std::complex<double>* transform = &buffers.transforms[t * padded_n];
+        for (size_t k = 0; k < padded_n; ++k)
+        {
+            const std::complex<double> z = transform[k];
+            const std::complex<double> z_conj = std::conj(transform[(padded_n - k) % padded_n]);
+            const double power_real = 0.25 * std::norm(z + z_conj);
+            const double power_imag = 0.25 * std::norm(z - z_conj);
+            const double power[2] = {power_real, power_imag};
+            double spectrum[2] = {0, 0};
+            for (unsigned int part = 0; part < 2; ++part)
+            {
+                spectrum[(2 * t + part) / 3] += power[part];
+            }
+            buffers.spectra[k] += std::complex<double>(spectrum[0], spectrum[1]);
+        }
+    }
+    m_fft->transform(buffers.spectra.data(), 1, true, buffers.work);
+
+    // MSD(m) = (sum_k r^2(k + m) + r^2(k) - 2 r(k) . r(k + m)) / (N - m),
+    // where the first two terms form a running sum over the window start.
+    for (unsigned int p = 0; p < n_pair; ++p)
+    {
+        const std::vector<vec3<double>>& positions = buffers.positions[p];
+        double sum_sq = 0;
+        for (size_t frame = 0; frame < n_frames; ++frame)
+        {
+            sum_sq += dot(positions[frame], positions[frame]);
+        }
+        sum_sq *= 2;
+        for (size_t m = 0; m < n_frames; ++m)
+        {
+            if (m > 0)
+            {
+                sum_sq -= dot(positions[m - 1], positions[m - 1])
+                    + dot(positions[n_frames - m], positions[n_frames - m]);
+            }
+            const double autocorrelation
+                = (p == 0) ? buffers.spectra[m].real() : buffers.spectra[m].imag();
+            particle_msd[p][m] = static_cast<float>((sum_sq - 2 * autocorrelation) / double(n_frames - m));
+        }
+    }
+}
+
+void MSD::accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                     unsigned int n_particles, size_t frame_stride)
+{
+    if (n_frames == 0)
+    {
+        throw std::invalid_argument("MSD requires at least one frame.");
+    }
+    if (n_particles == 0)
+    {
+        throw std::invalid_argument("MSD requires at least one particle.");
+    }
+    if (m_n_particles > 0 && n_frames != m_n_frames)
+    {
+        throw std::invalid_argument(
+            "MSD requires the same number of frames for all particles accumulated since the last reset.");
+    }
+
+    // Zero padding to at least 2N - 1 values makes the circular
+    // autocorrelation of the transforms equal to the linear one.
+    if (m_mode == msd_window)
+    {
+        size_t padded_n = 1;
+        while (padded_n < 2 * size_t(n_frames) - 1)
+        {
+            padded_n <<= 1;
+        }
+        if (!m_fft || m_fft->size() != padded_n)
+        {
+            m_fft.reset(new util::FFT(padded_n));
+        }
+    }
+    m_n_frames = n_frames;
+
+    const size_t offset = m_particle_msd_data.size();
+    m_particle_msd_data.resize(offset + size_t(n_particles) * n_frames);
+    float* particle_msd_data = m_particle_msd_data.data() + offset;
+
+    util::ParallelAccumulator<double> local_msd_sum(n_frames);
+    util::forLoopWrapper(0, (size_t(n_particles) + 1) / 2, [&](size_t begin, size_t end) {
+        PairBuffers& buffers = m_local_buffers.local();
+        buffers.msd_sum.assign(n_frames, 0);
+        for (size_t pair = begin; pair < end; ++pair)
+        {
+            const size_t first = 2 * pair;
+            const unsigned int n_pair = std::min(2u, static_cast<unsigned int>(n_particles - first));
+            float* const particle_msd[2]
+                = {particle_msd_data + first * n_frames,
+                   (n_pair == 2) ? particle_msd_data + (first + 1) * n_frames : nullptr};
+
+            for (unsigned int p = 0; p < n_pair; ++p)
+            {
+                buffers.positions[p].resize(n_frames);
+                readPositions(positions + first + p, (images != nullptr) ? images + first + p : nullptr,
+                              frame_stride, buffers.positions[p].data());
+            }
+
+            if (m_mode == msd_window)
+            {
+                computeWindowPair(buffers, n_pair, particle_msd);
+            }
+            else
+            {
+                for (unsigned int p = 0; p < n_pair; ++p)
+                {
+                    for (size_t frame = 0; frame < n_frames; ++frame)
+                    {
+                        const vec3<double>& r = buffers.positions[p][frame];
+                        particle_msd[p][frame] = static_cast<float>(dot(r, r));
+                    }
+                }
+            }
+
+            for (unsigned int p = 0; p < n_pair; ++p)
+            {
+                for (size_t frame = 0; frame < n_frames; ++frame)
+                {
+                    buffers.msd_sum[frame] += particle_msd[p][frame];
+                }
+            }
+        }
+        local_msd_sum.add(buffers.msd_sum.data());
+    });
+
+    util::ManagedArray<double> msd_sum(n_frames);
+    local_msd_sum.reduceInto(msd_sum);
+    m_msd_sum.resize(n_frames, 0);
+    for (size_t frame = 0; frame < n_frames; ++frame)
+    {
+        m_msd_sum[frame] += msd_sum[frame];
+    }
+
+    m_n_particles += n_particles;
+    m_reduce_msd = true;
+    m_reduce_particle_msd = true;
+}
+
+const util::ManagedArray<float>& MSD::getMSD()
+{
+    if (m_reduce_msd)
+    {
+        m_msd.prepare(m_n_frames);
+        for (size_t frame = 0; frame < m_n_frames; ++frame)
+        {
+            m_msd[frame] = static_cast<float>(m_msd_sum[frame] / m_n_particles);
+        }
+        m_reduce_msd = false;
+    }
+    return m_msd;
+}
+
+const util::ManagedArray<float>& MSD::getParticleMSD()
+{
+    if (m_reduce_particle_msd)
+    {
+        m_particle_msd.prepare({m_n_frames, m_n_particles});
+        util::forLoopWrapper(0, m_n_particles, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p)
+            {
+                for (size_t frame = 0; frame < m_n_frames; ++frame)
+                {
+                    m_particle_msd(frame, p) = m_particle_msd_data[p * m_n_frames + frame];
+                }
+            }
+        });
+        m_reduce_particle_msd = false;
+    }
+    return m_particle_msd;
+}
+
+}; }; // end namespace freud::msd
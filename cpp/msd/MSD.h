@@ -0,0 +1,140 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef MSD_H
+#define MSD_H
+
+#include <complex>
+#include <memory>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
+
+#include "Box.h"
+#include "FFT.h"
+#include "ManagedArray.h"
+#include "VectorMath.h"
+
+/*! \file MSD.h
+    \brief Computes mean squared displacements of particles over trajectories.
+*/
+
+namespace freud { namespace msd {
+
+//! Definitions of the mean squared displacement.
+enum MSDMode
+{
+    msd_window, //!< Average over all windows of each length in the trajectory.
+    msd_direct  //!< Displacement from the first frame.
+};
+
+//! Computes the mean squared displacement of particles over a trajectory.
+/*! In window mode, the MSD of each particle is computed with the algorithm of
+ *  Calandrini et al.: the sum of r^2(k + m) + r^2(k) over windows is a
+ *  running sum, and the sum of r(k) . r(k + m) is an autocorrelation computed
+ *  with zero-padded Fourier transforms. The real coordinates of two
+ *  particles are packed into the real and imaginary parts of complex
+ *  transforms, so each particle costs two transforms of twice the
+ *  trajectory length.
+ *
+ *  Particles are processed in parallel in pairs, reading their positions
+ *  directly from a strided (n_frames, n_particles, 3) array and unwrapping
+ *  them into per-thread buffers, so the positions are never copied as a
+ *  whole. Accumulation is split over particles: every call must provide all
+ *  frames of a subset of the particles, and the per-particle results of
+ *  successive calls are concatenated.
+ */
+class MSD
+{
+public:
+    //! Constructor
+    /*! \param box The box used to unwrap positions with images.
+     *  \param mode The definition of the MSD.
+     */
+    MSD(const box::Box& box, MSDMode mode);
+
+    // Destructor
+    ~MSD() {}
+
+    //! Reset the accumulated particles.
+    void reset();
+
+    //! Add the MSD of a set of particles over all frames.
+    /*! \param positions Positions, with the position of particle p in frame
+     *         f at index f * frame_stride + p.
+     *  \param images Images of the positions with the same layout, or
+     *         nullptr if the positions are already unwrapped.
+     *  \param n_frames Number of frames, which must be the same for all
+     *         calls since the last reset.
+     *  \param n_particles Number of particles.
+     *  \param frame_stride Distance between the positions of a particle in
+     *         consecutive frames.
+     */
+    void accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                    unsigned int n_particles, size_t frame_stride);
+
+    //! Get the MSD averaged over all accumulated particles.
+    const util::ManagedArray<float>& getMSD();
+
+    //! Get the MSD of each accumulated particle, with shape (n_frames, n_particles).
+    const util::ManagedArray<float>& getParticleMSD();
+
+    //! Get the box
+    const box::Box& getBox() const
+    {
+        return m_box;
+    }
+
+    //! Get the mode
+    MSDMode getMode() const
+    {
+        return m_mode;
+    }
+
+    //! Get the number of frames
+    unsigned int getNFrames() const
+    {
+        return m_n_frames;
+    }
+
+    //! Get the number of accumulated particles
+    unsigned int getNParticles() const
+    {
+        return m_n_particles;
+    }
+
+private:
+    //! Per-thread buffers for the MSD of a pair of particles.
+    struct PairBuffers
+    {
+        std::vector<vec3<double>> positions[2];       //!< Unwrapped positions relative to the first frame.
+        std::vector<std::complex<double>> transforms; //!< Packed coordinates and their transforms.
+        std::vector<std::complex<double>> spectra;    //!< Packed power spectra and autocorrelations.
+        std::vector<std::complex<double>> work;       //!< Work buffer of the transforms.
+        std::vector<double> msd_sum;                  //!< Sum of the MSD of the pair.
+    };
+
+    //! Read the unwrapped positions of a particle relative to its first frame.
+    void readPositions(const vec3<float>* positions, const vec3<int>* images, size_t frame_stride,
+                       vec3<double>* result) const;
+
+    //! Compute the window MSD of one or two particles from the positions in the buffers.
+    void computeWindowPair(PairBuffers& buffers, unsigned int n_pair, float* const particle_msd[2]) const;
+
+    box::Box m_box;             //!< The box used to unwrap positions.
+    MSDMode m_mode;             //!< The definition of the MSD.
+    unsigned int m_n_frames;    //!< Number of frames of the accumulated particles.
+    unsigned int m_n_particles; //!< Number of accumulated particles.
+    bool m_reduce_msd;          //!< Whether the average MSD needs to be recomputed.
+    bool m_reduce_particle_msd; //!< Whether the per-particle MSD needs to be recomputed.
+
+    std::unique_ptr<util::FFT> m_fft; //!< Transform of the zero-padded trajectory length.
+    tbb::enumerable_thread_specific<PairBuffers> m_local_buffers; //!< Per-thread buffers.
+    std::vector<float> m_particle_msd_data;   //!< MSD of each particle, stored particle by particle.
+    std::vector<double> m_msd_sum;            //!< Sum of the MSD over all particles.
+    util::ManagedArray<float> m_msd;          //!< Average MSD.
+    util::ManagedArray<float> m_particle_msd; //!< MSD of each particle.
+};
+
+}; }; // end namespace freud::msd
+
+#endif // MSD_H
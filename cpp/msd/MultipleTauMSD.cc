@@ -0,0 +1,106 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <stdexcept>
+
+#include "MultipleTauMSD.h"
+#include "utils.h"
+
+/*! \file MultipleTauMSD.cc
+    \brief Computes mean squared displacements at logarithmically spaced lags.
+*/
+
+namespace freud { namespace msd {
+
+MultipleTauMSD::MultipleTauMSD(const box::Box& box, unsigned int points_per_level, unsigned int decimation)
+    : m_box(box), m_reduce(true), m_correlator(points_per_level, decimation)
+{}
+
+void MultipleTauMSD::reset()
+{
+    m_correlator.reset(0);
+    m_origin.clear();
+    m_reduce = true;
+}
+
+void MultipleTauMSD::accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                                unsigned int n_particles)
+{
+    if (n_particles == 0)
+    {
+        throw std::invalid_argument("MultipleTauMSD requires at least one particle.");
+    }
+    if (m_correlator.getNumFrames() == 0)
+    {
+        m_correlator.reset(n_particles);
+    }
+    else if (n_particles != m_correlator.getNumChannels())
+    {
+        throw std::invalid_argument(
+            "MultipleTauMSD requires the same number of particles in all frames since the last reset.");
+    }
+
+    const vec3<double> lattice_vectors[3]
+        = {vec3<double>(m_box.getLatticeVector(0)), vec3<double>(m_box.getLatticeVector(1)),
+           m_box.is2D() ? vec3<double>() : vec3<double>(m_box.getLatticeVector(2))};
+    const auto squared_displacement = [](const vec3<double>& earlier, const vec3<double>& later) {
+        const vec3<double> delta = later - earlier;
+        return dot(delta, delta);
+    };
+
+    m_frame.resize(n_particles);
+    for (unsigned int frame = 0; frame < n_frames; ++frame)
+    {
+        const size_t offset = size_t(frame) * n_particles;
+        const bool first_frame = m_origin.empty();
+        if (first_frame)
+        {
+            m_origin.resize(n_particles);
+        }
+
+        // As in MSD, positions relative to the first frame keep their
+        // precision for large unwrapped coordinates.
+        util::forLoopWrapper(0, n_particles, [&](size_t begin, size_t end) {
+            for (size_t p = begin; p < end; ++p)
+            {
+                vec3<double> r(positions[offset + p]);
+                if (images != nullptr)
+                {
+                    const vec3<int>& image = images[offset + p];
+                    r += lattice_vectors[0] * double(image.x) + lattice_vectors[1] * double(image.y)
+                        + lattice_vectors[2] * double(image.z);
+                }
+                if (first_frame)
+                {
+                    m_origin[p] = r;
+                }
+                m_frame[p] = r - m_origin[p];
+            }
+        });
+        m_correlator.push(m_frame.data(), squared_displacement);
+    }
+    m_reduce = true;
+}
+
+void MultipleTauMSD::reduce()
+{
+    if (m_reduce)
+    {
+        m_correlator.reduce(m_msd, &m_particle_msd);
+        m_reduce = false;
+    }
+}
+
+const util::ManagedArray<float>& MultipleTauMSD::getMSD()
+{
+    reduce();
+    return m_msd;
+}
+
+const util::ManagedArray<float>& MultipleTauMSD::getParticleMSD()
+{
+    reduce();
+    return m_particle_msd;
+}
+
+}; }; // end namespace freud::msd
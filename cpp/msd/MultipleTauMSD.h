@@ -0,0 +1,116 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef MULTIPLE_TAU_MSD_H
+#define MULTIPLE_TAU_MSD_H
+
+#include <vector>
+
+#include "Box.h"
+#include "ManagedArray.h"
+#include "MultipleTauCorrelator.h"
+#include "VectorMath.h"
+
+/*! \file MultipleTauMSD.h
+    \brief Computes mean squared displacements at logarithmically spaced lags.
+*/
+
+namespace freud { namespace msd {
+
+//! Computes the window mean squared displacement of a trajectory frame by frame.
+/*! Unlike MSD, which needs all frames of a particle at once, frames are
+ *  added one at a time to a multiple-tau correlator of the unwrapped
+ *  positions. Only O(log T) positions are kept per particle for a trajectory
+ *  of T frames, and the MSD is computed at logarithmically spaced lags: all
+ *  lags below points_per_level frames, and then points_per_level -
+ *  points_per_level / decimation lags per factor of decimation. At each lag
+ *  the MSD is the average over the windows starting at multiples of the
+ *  sampling interval of its level.
+ */
+class MultipleTauMSD
+{
+public:
+    //! Constructor
+    /*! \param box The box used to unwrap positions with images.
+     *  \param points_per_level Number of frames kept per level.
+     *  \param decimation Ratio of the sampling intervals of consecutive levels.
+     */
+    MultipleTauMSD(const box::Box& box, unsigned int points_per_level = 16, unsigned int decimation = 2);
+
+    // Destructor
+    ~MultipleTauMSD() {}
+
+    //! Reset the accumulated frames.
+    void reset();
+
+    //! Add consecutive frames of the trajectory.
+    /*! \param positions Positions, with the position of particle p in frame
+     *         f at index f * n_particles + p.
+     *  \param images Images of the positions with the same layout, or
+     *         nullptr if the positions are already unwrapped.
+     *  \param n_frames Number of frames.
+     *  \param n_particles Number of particles, which must be the same for
+     *         all frames since the last reset.
+     */
+    void accumulate(const vec3<float>* positions, const vec3<int>* images, unsigned int n_frames,
+                    unsigned int n_particles);
+
+    //! Get the lags, in frames, at which the MSD is computed.
+    std::vector<size_t> getLags() const
+    {
+        return m_correlator.getLags();
+    }
+
+    //! Get the MSD averaged over all particles at each lag.
+    const util::ManagedArray<float>& getMSD();
+
+    //! Get the MSD of each particle, with shape (number of lags, n_particles).
+    const util::ManagedArray<float>& getParticleMSD();
+
+    //! Get the box
+    const box::Box& getBox() const
+    {
+        return m_box;
+    }
+
+    //! Get the number of frames accumulated since the last reset
+    size_t getNFrames() const
+    {
+        return m_correlator.getNumFrames();
+    }
+
+    //! Get the number of particles
+    unsigned int getNParticles() const
+    {
+        return m_correlator.getNumChannels();
+    }
+
+    //! Get the number of frames kept per level
+    unsigned int getPointsPerLevel() const
+    {
+        return m_correlator.getPointsPerLevel();
+    }
+
+    //! Get the ratio of the sampling intervals of consecutive levels
+    unsigned int getDecimation() const
+    {
+        return m_correlator.getDecimation();
+    }
+
+private:
+    //! Compute the outputs if frames were added since they were last computed.
+    void reduce();
+
+    box::Box m_box; //!< The box used to unwrap positions.
+    bool m_reduce;  //!< Whether the outputs need to be recomputed.
+
+    util::MultipleTauCorrelator<vec3<double>> m_correlator; //!< Correlator of the unwrapped positions.
+    std::vector<vec3<double>> m_frame;                      //!< Unwrapped positions of the current frame.
+    std::vector<vec3<double>> m_origin;                     //!< Unwrapped positions of the first frame.
+    util::ManagedArray<float> m_msd;                        //!< Average MSD at each lag.
+    util::ManagedArray<float> m_particle_msd;               //!< MSD of each particle at each lag.
+};
+
+}; }; // end namespace freud::msd
+
+#endif // MULTIPLE_TAU_MSD_H
@@ -1,13 +1,15 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
-#include <functional>
+#include <limits>
 #include <stdexcept>
-#include <tbb/parallel_for.h>
-#include <tbb/blocked_range.h>
+#include <vector>
 
 #include "Cubatic.h"
+#include "ParallelAccumulator.h"
 #include "utils.h"
 
 /*! \file Cubatic.h
@@ -133,6 +135,146 @@ tensor4 genR4Tensor()
     return r4;
 }
 
+namespace {
+
+//! Number of independent components of a symmetric 4th order tensor in 3D.
+const unsigned int N_SYMMETRIC = 15;
+
+//! Number of the 81 index combinations sharing each independent component.
+const float SYMMETRIC_MULTIPLICITIES[N_SYMMETRIC] = {1, 4, 4, 6, 12, 6, 4, 12, 12, 4, 1, 4, 6, 4, 1};
+
+//! Number of annealing steps taken by each replicate between pruning checks.
+const unsigned int ANNEALING_ROUND = 256;
+
+//! Maximum number of annealing steps of a replicate, to prevent infinite loops.
+const unsigned int MAX_ANNEALING_STEPS = 10000;
+
+//! Largest rotation angle of an annealing step.
+const float ANNEALING_STEP_ANGLE = 0.1;
+
+//! Compute the independent components of the 4th tensor power of a vector.
+/*! The components are the monomials x^p y^q z^r with p + q + r = 4, ordered
+ *  by decreasing p and then decreasing q.
+ */
+inline void symmetricPowers(const vec3<float>& v, float* powers)
+{
+    const float xx = v.x * v.x;
+    const float yy = v.y * v.y;
+    const float zz = v.z * v.z;
+    powers[0] = xx * xx;
+    powers[1] = xx * v.x * v.y;
+    powers[2] = xx * v.x * v.z;
+    powers[3] = xx * yy;
+    powers[4] = xx * v.y * v.z;
+    powers[5] = xx * zz;
+    powers[6] = v.x * yy * v.y;
+    powers[7] = v.x * yy * v.z;
+    powers[8] = v.x * v.y * zz;
+    powers[9] = v.x * zz * v.z;
+    powers[10] = yy * yy;
+    powers[11] = yy * v.y * v.z;
+    powers[12] = yy * zz;
+    powers[13] = v.y * zz * v.z;
+    powers[14] = zz * zz;
+}
+
+//! Get the independent component of a symmetric tensor holding an element of tensor4.
+unsigned int symmetricComponent(unsigned int index)
+{
+    unsigned int counts[3] = {0, 0, 0};
+    for (unsigned int n = 0; n < 4; ++n)
+    {
+        ++counts[index % 3];
+        index /= 3;
+    }
+    return (4 - counts[0]) * (5 - counts[0]) / 2 + (4 - counts[0] - counts[1]);
+}
+
+//! Evaluates the cubatic order parameter of orientations against a fixed global tensor.
+/*! The cubatic tensor of an orientation is M = 2 sum_j v_j^(4) - r4 for the
+ *  rotated basis vectors v_j, and its norm does not depend on the
+ *  orientation. Expanding |G - M|^2 in eq. 22, the order parameter only
+ *  requires the contraction of the symmetric global tensor G with the three
+ *  v_j^(4), which uses the 15 independent components of G.
+ */
+class CubaticOrderEvaluator
+{
+public:
+    CubaticOrderEvaluator(const tensor4& global_tensor, const tensor4& r4_tensor,
+                          const tensor4& unit_cubatic_tensor, const vec3<float>* system_vectors)
+        : m_system_vectors(system_vectors)
+    {
+        for (unsigned int index = 0; index < 81; ++index)
+        {
+            const unsigned int component = symmetricComponent(index);
+            m_weights[component] = SYMMETRIC_MULTIPLICITIES[component] * global_tensor.data[index];
+        }
+        const float global_norm_sq = dot(global_tensor, global_tensor);
+        const float cubatic_norm_sq = dot(unit_cubatic_tensor, unit_cubatic_tensor);
+        m_offset = global_norm_sq + 2 * dot(global_tensor, r4_tensor) + cubatic_norm_sq;
+        m_inv_cubatic_norm_sq = 1 / cubatic_norm_sq;
+
+        // By the Cauchy-Schwarz inequality, G . M <= |G| |M|.
+        const float global_norm = std::sqrt(global_norm_sq);
+        const float cubatic_norm = std::sqrt(cubatic_norm_sq);
+        m_upper_bound = 1 - (global_norm - cubatic_norm) * (global_norm - cubatic_norm) / cubatic_norm_sq;
+
+        // Rotating the basis by an angle theta moves each v_j by at most
+        // theta, which changes G . v_j^(4) by at most 4 |G| theta.
+        m_max_slope = 48 * global_norm / cubatic_norm_sq;
+    }
+
+    //! Compute the cubatic order parameter of an orientation.
+    float operator()(const quat<float>& orientation) const
+    {
+        float contraction = 0;
+        float powers[N_SYMMETRIC];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            symmetricPowers(rotate(orientation, m_system_vectors[j]), powers);
+            for (unsigned int n = 0; n < N_SYMMETRIC; ++n)
+            {
+                contraction += m_weights[n] * powers[n];
+            }
+        }
+        return 1 - (m_offset - 4 * contraction) * m_inv_cubatic_norm_sq;
+    }
+
+    //! Upper bound of the order parameter over all orientations.
+    float getUpperBound() const
+    {
+        return m_upper_bound;
+    }
+
+    //! Largest change of the order parameter per radian of rotation.
+    float getMaxSlope() const
+    {
+        return m_max_slope;
+    }
+
+private:
+    const vec3<float>* m_system_vectors; //!< The global coordinate system.
+    float m_weights[N_SYMMETRIC];        //!< Independent components of G times their multiplicities.
+    float m_offset;                      //!< |G|^2 + 2 G . r4 + |M|^2.
+    float m_inv_cubatic_norm_sq;         //!< 1 / |M|^2.
+    float m_upper_bound;                 //!< Upper bound of the order parameter.
+    float m_max_slope;                   //!< Lipschitz constant of the order parameter.
+};
+
+//! State of a simulated annealing replicate.
+struct AnnealingReplicate
+{
+    std::mt19937 rng;        //!< Random number generator of the replicate.
+    quat<float> orientation; //!< Current orientation.
+    float order_parameter;   //!< Order parameter of the current orientation.
+    float temperature;       //!< Current temperature.
+    unsigned int n_steps;    //!< Number of steps taken.
+    bool active;             //!< Whether the replicate is still annealing.
+    bool pruned;             //!< Whether the replicate was stopped because it cannot be the best.
+};
+
+}; // namespace
+
 Cubatic::Cubatic(float t_initial, float t_final, float scale, unsigned int n_replicates, unsigned int seed)
     : m_t_initial(t_initial), m_t_final(t_final), m_scale(scale), m_n_replicates(n_replicates),
       m_seed(seed), m_n(0)
@@ -162,12 +304,6 @@ tensor4 Cubatic::calcCubaticTensor(quat<float>& orientation)
     return calculated_tensor * float(2.0) - m_gen_r4_tensor;
 }
 
-float Cubatic::calcCubaticOrderParameter(const tensor4& cubatic_tensor, const tensor4& global_tensor) const
-{
-    tensor4 diff = global_tensor - cubatic_tensor;
-    return float(1.0) - dot(diff, diff) / dot(cubatic_tensor, cubatic_tensor);
-}
-
 template<typename T> quat<float> Cubatic::calcRandomQuaternion(T& dist, float angle_multiplier) const
 {
     float theta = 2.0 * M_PI * dist();
@@ -180,56 +316,38 @@ template<typename T> quat<float> Cubatic::calcRandomQuaternion(T& dist, float an
     return quat<float>::fromAxisAngle(axis, angle);
 }
 
-util::ManagedArray<tensor4> Cubatic::calculatePerParticleTensor(const quat<float>* orientations) const
+tensor4 Cubatic::calculateGlobalTensor(const quat<float>* orientations) const
 {
-    util::ManagedArray<tensor4> particle_tensor(m_n);
-
-    // calculate per-particle tensor
-    util::forLoopWrapper(0, m_n, [=, &particle_tensor](size_t begin, size_t end) {
+    // The global tensor is symmetric, so only its independent components are
+    // accumulated over the rotated basis vectors of all particles.
+    util::ParallelAccumulator<double> component_sums(N_SYMMETRIC);
+    util::forLoopWrapper(0, m_n, [&](size_t begin, size_t end) {
+        double local_sums[N_SYMMETRIC] = {};
+        float powers[N_SYMMETRIC];
         for (size_t i = begin; i < end; ++i)
         {
-            tensor4 l_mbar = tensor4();
             for (unsigned int j = 0; j < 3; ++j)
             {
-                // Calculate the homogeneous tensor H for each vector then add
-                // to the per-particle value.
-                vec3<float> v_r = rotate(orientations[i], m_system_vectors[j]);
-                tensor4 r4_tensor(v_r);
-                l_mbar += r4_tensor;
+                symmetricPowers(rotate(orientations[i], m_system_vectors[j]), powers);
+                for (unsigned int n = 0; n < N_SYMMETRIC; ++n)
+                {
+                    local_sums[n] += powers[n];
+                }
             }
-
-            // Apply the prefactor from the sum in equation 27 before assigning.
-            particle_tensor[i] = l_mbar * 2.0;
         }
+        component_sums.add(local_sums);
     });
-    return particle_tensor;
-}
+    util::ManagedArray<double> components(N_SYMMETRIC);
+    component_sums.reduceInto(components);
 
-tensor4 Cubatic::calculateGlobalTensor(quat<float>* orientations) const
-{
+    // Note that in the third equation in eq. 27, the prefactor of the sum is
+    // 2/N, which includes the factor of 2 of the first equation.
     tensor4 global_tensor = tensor4();
-    util::ManagedArray<tensor4> particle_tensor = calculatePerParticleTensor(orientations);
-
-    // now calculate the global tensor
-    float n_inv = 1.0 / (float) m_n;
-
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, 81),
-                      [=, &global_tensor, &n_inv, &particle_tensor](const tbb::blocked_range<size_t>& r) {
-                          for (size_t i = r.begin(); i != r.end(); i++)
-                          {
-                              float tensor_value = 0;
-                              for (unsigned int j = 0; j < m_n; j++)
-                              {
-                                  tensor_value += particle_tensor[j][i];
-                              }
-                              // Note that in the third equation in eq. 27, the prefactor of the
-                              // sum is 2/N, but the factor of 2 is already accounted for in the
-                              // calculation of per particle calculation in
-                              // calculatePerParticleTensor, so here we just need to apply the
-                              // 1/N scaling.
-                              global_tensor[i] = tensor_value * n_inv;
-                          }
-                      });
+    const double prefactor = 2.0 / m_n;
+    for (unsigned int index = 0; index < 81; ++index)
+    {
+        global_tensor[index] = static_cast<float>(prefactor * components[symmetricComponent(index)]);
+    }
     return global_tensor - m_gen_r4_tensor;
 }
 
@@ -238,114 +356,147 @@ void Cubatic::compute(quat<float>* orientations, unsigned int num_orientations)
     m_n = num_orientations;
     m_particle_order_parameter.prepare(m_n);
 
-    // Calculate the per-particle tensor
+    // Calculate the global tensor
     tensor4 global_tensor = calculateGlobalTensor(orientations);
     m_global_tensor.prepare({3, 3, 3, 3});
     global_tensor.copyToManagedArray(m_global_tensor);
 
+    quat<float> unit_orientation;
+    const CubaticOrderEvaluator order_parameter(global_tensor, m_gen_r4_tensor,
+                                                calcCubaticTensor(unit_orientation), m_system_vectors);
+
     // The paper recommends using a Newton-Raphson scheme to optimize the order
     // parameter, but in practice we find that simulated annealing performs
     // much better, so we perform replicates of the process and choose the best
-    // one.
-    util::ManagedArray<tensor4> p_cubatic_tensor(m_n_replicates);
-    util::ManagedArray<float> p_cubatic_order_parameter(m_n_replicates);
-    util::ManagedArray<quat<float>> p_cubatic_orientation(m_n_replicates);
-
-    tbb::parallel_for(
-        tbb::blocked_range<size_t>(0, m_n_replicates),
-        [=, &p_cubatic_orientation, &p_cubatic_order_parameter,
-         &p_cubatic_tensor](const tbb::blocked_range<size_t>& r) {
-            // create thread-specific rng
-            unsigned int thread_start = (unsigned int) r.begin();
-
-            std::vector<unsigned int> seed_seq(3);
-            seed_seq[0] = m_seed;
-            seed_seq[1] = thread_start;
-            seed_seq[2] = 0xffaabb;
-            std::seed_seq seed(seed_seq.begin(), seed_seq.end());
-            std::mt19937 rng(seed);
-            std::uniform_real_distribution<float> base_dist(0, 1);
-            auto dist = std::bind(base_dist, rng);
-
-            for (size_t i = r.begin(); i != r.end(); i++)
+    // one. Each replicate has its own random number generator seeded by its
+    // index, so the result does not depend on the number of threads.
+    std::uniform_real_distribution<float> base_dist(0, 1);
+    std::vector<AnnealingReplicate> replicates(m_n_replicates);
+    for (unsigned int i = 0; i < m_n_replicates; ++i)
+    {
+        AnnealingReplicate& replicate = replicates[i];
+        std::seed_seq seed({m_seed, i, 0xffaabbu});
+        replicate.rng.seed(seed);
+        auto dist = [&]() { return base_dist(replicate.rng); };
+        replicate.orientation = calcRandomQuaternion(dist);
+        replicate.order_parameter = order_parameter(replicate.orientation);
+        replicate.temperature = m_t_initial;
+        replicate.n_steps = 0;
+        replicate.active = true;
+        replicate.pruned = false;
+    }
+
+    // A replicate only moves when a step is accepted, by an angle below
+    // ANNEALING_STEP_ANGLE, and the temperature decreases with each accepted
+    // step. This bounds how much its final order parameter can still differ
+    // from its current one.
+    const auto max_change = [&](const AnnealingReplicate& replicate) {
+        unsigned int n_moves = 0;
+        if (replicate.active)
+        {
+            float temperature = replicate.temperature;
+            while (temperature > m_t_final && n_moves < MAX_ANNEALING_STEPS - replicate.n_steps)
+            {
+                temperature *= m_scale;
+                ++n_moves;
+            }
+        }
+        return order_parameter.getMaxSlope() * ANNEALING_STEP_ANGLE * n_moves;
+    };
+
+    // Replicates anneal in parallel in rounds of steps. Between rounds,
+    // replicates that cannot end above the lowest possible final order
+    // parameter of another replicate are pruned, and replicates that have
+    // reached the upper bound of the order parameter stop.
+    bool any_active = (m_n_replicates > 0);
+    while (any_active)
+    {
+        util::forLoopWrapper(0, m_n_replicates, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
             {
-                // need to generate random orientation
-                quat<float> cubatic_orientation = calcRandomQuaternion(dist);
-                quat<float> new_orientation = cubatic_orientation;
-
-                // now calculate the cubatic tensor
-                tensor4 cubatic_tensor = calcCubaticTensor(cubatic_orientation);
-                float cubatic_order_parameter = calcCubaticOrderParameter(cubatic_tensor, global_tensor);
-                float new_order_parameter = cubatic_order_parameter;
-
-                // set initial temperature and count
-                float t_current = m_t_initial;
-                unsigned int loop_count = 0;
-                // simulated annealing loop; loop counter to prevent inf loops
-                while ((t_current > m_t_final) && (loop_count < 10000))
+                AnnealingReplicate& replicate = replicates[i];
+                auto dist = [&]() { return base_dist(replicate.rng); };
+                for (unsigned int step = 0; replicate.active && step < ANNEALING_ROUND; ++step)
                 {
-                    ++loop_count;
-                    new_orientation = calcRandomQuaternion(dist, 0.1) * (cubatic_orientation);
-                    // now calculate the cubatic tensor
-                    tensor4 new_cubatic_tensor = calcCubaticTensor(new_orientation);
-                    new_order_parameter = calcCubaticOrderParameter(new_cubatic_tensor, global_tensor);
-                    if (new_order_parameter > cubatic_order_parameter)
+                    if (!((replicate.temperature > m_t_final) && (replicate.n_steps < MAX_ANNEALING_STEPS)))
                     {
-                        cubatic_tensor = new_cubatic_tensor;
-                        cubatic_order_parameter = new_order_parameter;
-                        cubatic_orientation = new_orientation;
+                        replicate.active = false;
+                        break;
                     }
-                    else
+                    ++replicate.n_steps;
+                    const quat<float> new_orientation
+                        = calcRandomQuaternion(dist, ANNEALING_STEP_ANGLE) * replicate.orientation;
+                    const float new_order_parameter = order_parameter(new_orientation);
+                    if (new_order_parameter <= replicate.order_parameter)
                     {
-                        float boltzmann_factor
-                            = std::exp(-(cubatic_order_parameter - new_order_parameter) / t_current);
-                        if (boltzmann_factor >= dist())
-                        {
-                            cubatic_tensor = new_cubatic_tensor;
-                            cubatic_order_parameter = new_order_parameter;
-                            cubatic_orientation = new_orientation;
-                        }
-                        else
+                        const float boltzmann_factor = std::exp(
+                            -(replicate.order_parameter - new_order_parameter) / replicate.temperature);
+                        if (boltzmann_factor < dist())
                         {
                             continue;
                         }
                     }
-                    t_current *= m_scale;
+                    replicate.order_parameter = new_order_parameter;
+                    replicate.orientation = new_orientation;
+                    replicate.temperature *= m_scale;
+                }
+                if (replicate.order_parameter >= order_parameter.getUpperBound())
+                {
+                    replicate.active = false;
                 }
-                // set values
-                p_cubatic_tensor[i] = cubatic_tensor;
-                p_cubatic_orientation[i].s = cubatic_orientation.s;
-                p_cubatic_orientation[i].v = cubatic_orientation.v;
-                p_cubatic_order_parameter[i] = cubatic_order_parameter;
             }
         });
 
-    // Loop over threads and choose the replicate that found the highest order.
+        float best_lower_bound = -std::numeric_limits<float>::infinity();
+        for (const AnnealingReplicate& replicate : replicates)
+        {
+            if (!replicate.pruned)
+            {
+                best_lower_bound
+                    = std::max(best_lower_bound, replicate.order_parameter - max_change(replicate));
+            }
+        }
+        any_active = false;
+        for (AnnealingReplicate& replicate : replicates)
+        {
+            if (replicate.active)
+            {
+                const float upper_bound = std::min(replicate.order_parameter + max_change(replicate),
+                                                   order_parameter.getUpperBound());
+                if (upper_bound < best_lower_bound)
+                {
+                    replicate.active = false;
+                    replicate.pruned = true;
+                }
+                any_active = any_active || replicate.active;
+            }
+        }
+    }
+
+    // Choose the replicate that found the highest order.
     unsigned int max_idx = 0;
-    float max_cubatic_order_parameter = p_cubatic_order_parameter[max_idx];
     for (unsigned int i = 1; i < m_n_replicates; ++i)
     {
-        if (p_cubatic_order_parameter[i] > max_cubatic_order_parameter)
+        if (!replicates[i].pruned
+            && (replicates[max_idx].pruned
+                || replicates[i].order_parameter > replicates[max_idx].order_parameter))
         {
             max_idx = i;
-            max_cubatic_order_parameter = p_cubatic_order_parameter[i];
         }
     }
 
+    m_cubatic_orientation = replicates[max_idx].orientation;
+    m_cubatic_order_parameter = replicates[max_idx].order_parameter;
     m_cubatic_tensor.prepare({3, 3, 3, 3});
-    p_cubatic_tensor[max_idx].copyToManagedArray(m_cubatic_tensor);
-    m_cubatic_orientation = p_cubatic_orientation[max_idx];
-    m_cubatic_order_parameter = p_cubatic_order_parameter[max_idx];
+    calcCubaticTensor(m_cubatic_orientation).copyToManagedArray(m_cubatic_tensor);
 
-    // Now calculate the per-particle order parameters
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, m_n), [=](const tbb::blocked_range<size_t>& r) {
-        for (size_t i = r.begin(); i != r.end(); i++)
+    // The per-particle order parameter is defined as the value of the cubatic
+    // order parameter if the global orientation was the particle orientation,
+    // so we can reuse the same machinery.
+    util::forLoopWrapper(0, m_n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
         {
-            // The per-particle order parameter is defined as the value of the
-            // cubatic order parameter if the global orientation was the
-            // particle orientation, so we can reuse the same machinery.
-            m_particle_order_parameter[i]
-                = calcCubaticOrderParameter(calcCubaticTensor(orientations[i]), global_tensor);
+            m_particle_order_parameter[i] = order_parameter(orientations[i]);
         }
     });
 }
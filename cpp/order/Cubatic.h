@@ -133,29 +133,12 @@ private:
      */
     tensor4 calcCubaticTensor(quat<float>& orientation);
 
-    //! Calculate the scalar cubatic order parameter.
-    /*! Implements eq. 22.
-     *
-     *  \param cubatic_tensor The cubatic tensor M_{\omega}.
-     *  \param global_tensor The tensor encoding the average system orientation (denoted \bar{M}).
-     *
-     *  \return The value of the cubatic order parameter.
-     */
-    float calcCubaticOrderParameter(const tensor4& cubatic_tensor, const tensor4& global_tensor) const;
-
-    //! Calculate the per-particle tensor.
-    /*! Implements the first line of eq. 27, the calculation of M.
-     *
-     *  \param orientations The per-particle orientations.
-     *
-     *  \return The per-particle cubatic tensors value M^{ijkl}.
-     */
-    util::ManagedArray<tensor4> calculatePerParticleTensor(const quat<float>* orientations) const;
-
     //! Calculate the global tensor for the system.
-    /*! Implements the third line of eq. 27, the calculation of \bar{M}.
+    /*! Implements the first and third lines of eq. 27, the calculation of
+     *  \bar{M}. The per-particle tensors M are symmetric, so only their 15
+     *  independent components are summed, without storing them.
      */
-    tensor4 calculateGlobalTensor(quat<float>* orientations) const;
+    tensor4 calculateGlobalTensor(const quat<float>* orientations) const;
 
     //! Calculate a random quaternion.
     /*! To calculate a random quaternion in a way that obeys the right
@@ -1,10 +1,52 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+
 #include "HexaticTranslational.h"
 
 namespace freud { namespace order {
 
+namespace {
+
+//! Multiply two complex numbers.
+/*! This skips the checks for infinite and NaN results of std::complex
+ *  multiplication, which are not needed for products of unit numbers.
+ */
+inline std::complex<float> multiply(const std::complex<float>& a, const std::complex<float>& b)
+{
+    return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(),
+                               a.real() * b.imag() + a.imag() * b.real());
+}
+
+//! Get the unit complex number e^{i phi} of the angle phi of a 2D bond.
+inline std::complex<float> unitBond(const vec3<float>& delta)
+{
+    const float r = std::sqrt(delta.x * delta.x + delta.y * delta.y);
+    // A zero bond has the angle atan2(0, 0) = 0.
+    return (r > 0) ? std::complex<float>(delta.x / r, delta.y / r) : std::complex<float>(1, 0);
+}
+
+//! Raise a complex number to an integer power by repeated squaring.
+inline std::complex<float> integerPower(std::complex<float> z, unsigned int k)
+{
+    std::complex<float> result(1, 0);
+    for (; k > 0; k >>= 1)
+    {
+        if (k & 1)
+        {
+            result = multiply(result, z);
+        }
+        z = multiply(z, z);
+    }
+    return result;
+}
+
+}; // namespace
+
 //! Compute the order parameter
 template<typename T>
 template<typename Func>
@@ -23,12 +65,10 @@ void HexaticTranslational<T>::computeGeneral(Func func, const freud::locality::N
         points, points->getPoints(), Np, qargs, nlist,
         [=](size_t i, std::shared_ptr<freud::locality::NeighborPerPointIterator> ppiter) {
             float total_weight(0);
-            const vec3<float> ref((*points)[i]);
-
             for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
             {
-                // Compute vector from query_point to point
-                const vec3<float> delta = box.wrap((*points)[nb.point_idx] - ref);
+                // Vector from query_point to point
+                const vec3<float> delta = nb.vector;
                 const float weight(m_weighted ? nb.weight : 1.0);
 
                 // Compute psi for this vector
@@ -52,10 +92,7 @@ void Hexatic::compute(const freud::locality::NeighborList* nlist,
                       const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
 {
     computeGeneral(
-        [this](const vec3<float>& delta) {
-            const float theta_ij = std::atan2(delta.y, delta.x);
-            return std::exp(std::complex<float>(0, m_k * theta_ij));
-        },
+        [this](const vec3<float>& delta) { return integerPower(unitBond(delta), m_k); },
         nlist, points, qargs);
 }
 
@@ -70,4 +107,71 @@ void Translational::compute(const freud::locality::NeighborList* nlist,
                    points, qargs);
 }
 
+HexaticTranslationalOrder::HexaticTranslationalOrder(std::vector<unsigned int> k, float translational_k,
+                                                     bool weighted)
+    : m_k(k), m_k_order(k.size()), m_translational_k(translational_k), m_weighted(weighted)
+{
+    if (m_k.empty())
+    {
+        throw std::invalid_argument("HexaticTranslationalOrder requires at least one value of k.");
+    }
+    std::iota(m_k_order.begin(), m_k_order.end(), 0);
+    std::sort(m_k_order.begin(), m_k_order.end(),
+              [this](unsigned int a, unsigned int b) { return m_k[a] < m_k[b]; });
+}
+
+void HexaticTranslationalOrder::compute(const freud::locality::NeighborList* nlist,
+                                        const freud::locality::NeighborQuery* points,
+                                        freud::locality::QueryArgs qargs)
+{
+    const auto box = points->getBox();
+    box.enforce2D();
+
+    const unsigned int Np = points->getNPoints();
+    const size_t n_k = m_k.size();
+
+    m_psi_array.prepare({Np, n_k});
+    m_translational_array.prepare(Np);
+
+    // Per-thread sums of the k-atic terms of the bonds of one point.
+    tbb::enumerable_thread_specific<std::vector<std::complex<float>>> local_sums(
+        [n_k]() { return std::vector<std::complex<float>>(n_k); });
+
+    freud::locality::loopOverNeighborsIterator(
+        points, points->getPoints(), Np, qargs, nlist,
+        [&](size_t i, std::shared_ptr<freud::locality::NeighborPerPointIterator> ppiter) {
+            std::vector<std::complex<float>>& sums = local_sums.local();
+            std::fill(sums.begin(), sums.end(), std::complex<float>(0));
+            std::complex<float> translational(0);
+            float total_weight(0);
+            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
+            {
+                const vec3<float> delta = nb.vector;
+                const float weight(m_weighted ? nb.weight : 1.0);
+                translational += weight * std::complex<float>(delta.x, delta.y);
+                total_weight += weight;
+
+                // Step through the symmetries in increasing order, multiplying
+                // the power of the unit bond by the power of the difference.
+                const std::complex<float> z = unitBond(delta);
+                std::complex<float> power(1, 0);
+                unsigned int current_k = 0;
+                for (const unsigned int index : m_k_order)
+                {
+                    const unsigned int step = m_k[index] - current_k;
+                    power = (step == 1) ? multiply(power, z) : multiply(power, integerPower(z, step));
+                    current_k = m_k[index];
+                    sums[index] += weight * power;
+                }
+            }
+            for (size_t k_index = 0; k_index < n_k; ++k_index)
+            {
+                const float norm = m_weighted ? total_weight : static_cast<float>(m_k[k_index]);
+                m_psi_array(i, k_index) = sums[k_index] / std::complex<float>(norm);
+            }
+            m_translational_array[i]
+                = translational / std::complex<float>(m_weighted ? total_weight : m_translational_k);
+        });
+}
+
 }; }; // namespace freud::order
@@ -5,6 +5,7 @@
 #define HEXATIC_TRANSLATIONAL_H
 
 #include <complex>
+#include <vector>
 
 #include "Box.h"
 #include "ManagedArray.h"
@@ -92,6 +93,67 @@ public:
                  freud::locality::QueryArgs qargs);
 };
 
+//! Compute several k-atic order parameters and the translational order parameter in one pass
+/*! Each bond is visited once, and its k-fold symmetric terms are obtained by
+ *  multiplying powers of the unit bond vector in the complex plane, so the
+ *  cost per bond is a few complex multiplications rather than a
+ *  trigonometric evaluation for each k. The values are identical (up to
+ *  rounding) to those of Hexatic and Translational, whose normalizations
+ *  they use.
+ */
+class HexaticTranslationalOrder
+{
+public:
+    //! Constructor
+    /*! \param k Symmetries of the k-atic order parameters.
+     *  \param translational_k Normalization of the translational order parameter.
+     *  \param weighted Whether to use neighbor weights for all order parameters.
+     */
+    HexaticTranslationalOrder(std::vector<unsigned int> k, float translational_k = 6, bool weighted = false);
+
+    //! Destructor
+    ~HexaticTranslationalOrder() {}
+
+    //! Compute the order parameters
+    void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
+                 freud::locality::QueryArgs qargs);
+
+    const std::vector<unsigned int>& getK() const
+    {
+        return m_k;
+    }
+
+    float getTranslationalK() const
+    {
+        return m_translational_k;
+    }
+
+    bool isWeighted() const
+    {
+        return m_weighted;
+    }
+
+    //! Get the k-atic order parameters, with shape (number of points, number of k)
+    const util::ManagedArray<std::complex<float>>& getOrder() const
+    {
+        return m_psi_array;
+    }
+
+    //! Get the translational order parameters
+    const util::ManagedArray<std::complex<float>>& getTranslationalOrder() const
+    {
+        return m_translational_array;
+    }
+
+private:
+    const std::vector<unsigned int> m_k;                           //!< k-atic symmetries
+    std::vector<unsigned int> m_k_order;                           //!< Indices of m_k by increasing k
+    const float m_translational_k;                                 //!< Translational normalization
+    const bool m_weighted;                                         //!< Whether to use neighbor weights
+    util::ManagedArray<std::complex<float>> m_psi_array;           //!< k-atic order parameters
+    util::ManagedArray<std::complex<float>> m_translational_array; //!< Translational order parameters
+};
+
 }; }; // end namespace freud::order
 
 #endif // HEXATIC_TRANSLATIONAL_H
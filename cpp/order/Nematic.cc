@@ -1,10 +1,13 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "Nematic.h"
+#include "ParallelAccumulator.h"
 #include "diagonalize.h"
+#include "utils.h"
 
 /*! \file Nematic.h
     \brief Compute the nematic order parameter for each particle
@@ -13,7 +16,7 @@
 namespace freud { namespace order {
 
 // m_u is the molecular axis, normalized to a unit vector
-Nematic::Nematic(vec3<float> u) : m_n(0), m_u(u / std::sqrt(dot(u, u))), m_nematic_tensor_local({3, 3}) {}
+Nematic::Nematic(vec3<float> u) : m_n(0), m_u(u / std::sqrt(dot(u, u))) {}
 
 float Nematic::getNematicOrderParameter() const
 {
@@ -45,59 +48,144 @@ vec3<float> Nematic::getU() const
     return m_u;
 }
 
-void Nematic::compute(quat<float>* orientations, unsigned int n)
+void Nematic::accumulateAxes(const quat<float>* orientations, size_t n, double* sums,
+                            float* particle_tensor) const
 {
-    m_n = n;
-    m_particle_tensor.prepare({m_n, 3, 3});
-    m_nematic_tensor_local.reset();
-
-    // calculate per-particle tensor
-    util::forLoopWrapper(0, n, [=](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+    // The rotated axes of a block are computed into arrays in one loop, then
+    // summed with independent partial sums so that both loops vectorize.
+    const size_t block_size = 64;
+    const size_t n_lanes = 8;
+    float products[6][block_size];
+    for (size_t block_begin = 0; block_begin < n; block_begin += block_size)
+    {
+        const size_t count = std::min(block_size, n - block_begin);
+        for (size_t i = 0; i < count; ++i)
         {
             // get the director of the particle
-            quat<float> q = orientations[i];
-            vec3<float> u_i = rotate(q, m_u);
-
-            util::ManagedArray<float> Q_ab({3, 3});
-
-            Q_ab(0, 0) = 1.5f * u_i.x * u_i.x - 0.5f;
-            Q_ab(0, 1) = 1.5f * u_i.x * u_i.y;
-            Q_ab(0, 2) = 1.5f * u_i.x * u_i.z;
-            Q_ab(1, 0) = 1.5f * u_i.y * u_i.x;
-            Q_ab(1, 1) = 1.5f * u_i.y * u_i.y - 0.5f;
-            Q_ab(1, 2) = 1.5f * u_i.y * u_i.z;
-            Q_ab(2, 0) = 1.5f * u_i.z * u_i.x;
-            Q_ab(2, 1) = 1.5f * u_i.z * u_i.y;
-            Q_ab(2, 2) = 1.5f * u_i.z * u_i.z - 0.5f;
-
-            // Set the values. The nematic tensor is reduced later.
-            for (unsigned int j = 0; j < 3; j++)
+            const vec3<float> u_i = rotate(orientations[block_begin + i], m_u);
+            products[0][i] = u_i.x * u_i.x;
+            products[1][i] = u_i.x * u_i.y;
+            products[2][i] = u_i.x * u_i.z;
+            products[3][i] = u_i.y * u_i.y;
+            products[4][i] = u_i.y * u_i.z;
+            products[5][i] = u_i.z * u_i.z;
+        }
+        for (size_t i = count; i < block_size; ++i)
+        {
+            for (unsigned int c = 0; c < 6; ++c)
             {
-                for (unsigned int k = 0; k < 3; k++)
+                products[c][i] = 0;
+            }
+        }
+        for (unsigned int c = 0; c < 6; ++c)
+        {
+            float lanes[n_lanes] = {};
+            for (size_t i = 0; i < block_size; i += n_lanes)
+            {
+                for (size_t lane = 0; lane < n_lanes; ++lane)
                 {
-                    m_particle_tensor(i, j, k) += Q_ab(j, k);
-                    m_nematic_tensor_local.local()(j, k) += Q_ab(j, k);
+                    lanes[lane] += products[c][i + lane];
                 }
             }
+            for (size_t lane = 0; lane < n_lanes; ++lane)
+            {
+                sums[c] += lanes[lane];
+            }
         }
-    });
 
-    // Now calculate the sum of Q_ab's
-    m_nematic_tensor.prepare({3, 3});
-    m_nematic_tensor_local.reduceInto(m_nematic_tensor);
+        if (particle_tensor != nullptr)
+        {
+            // Q_ab = 3/2 u_a u_b - 1/2 delta_ab
+            static const unsigned int components[9] = {0, 1, 2, 1, 3, 4, 2, 4, 5};
+            for (size_t i = 0; i < count; ++i)
+            {
+                float* Q_ab = particle_tensor + 9 * (block_begin + i);
+                for (unsigned int j = 0; j < 9; ++j)
+                {
+                    Q_ab[j] = 1.5f * products[components[j]][i] - ((j % 4 == 0) ? 0.5f : 0.0f);
+                }
+            }
+        }
+    }
+}
 
+float Nematic::diagonalizeNematicTensor(const double* sums, unsigned int n, float* nematic_tensor,
+                                        vec3<float>& director) const
+{
     // Normalize by the number of particles
-    for (unsigned int i = 0; i < m_nematic_tensor.size(); ++i)
-        m_nematic_tensor[i] /= m_n;
+    static const unsigned int components[9] = {0, 1, 2, 1, 3, 4, 2, 4, 5};
+    util::ManagedArray<float> Q({3, 3});
+    for (unsigned int j = 0; j < 9; ++j)
+    {
+        Q[j] = static_cast<float>(1.5 * sums[components[j]] / n - ((j % 4 == 0) ? 0.5 : 0.0));
+        nematic_tensor[j] = Q[j];
+    }
 
     // the order parameter is the eigenvector belonging to the largest eigenvalue
     util::ManagedArray<float> eval = util::ManagedArray<float>(3);
     util::ManagedArray<float> evec = util::ManagedArray<float>({3, 3});
 
-    freud::util::diagonalize33SymmetricMatrix(m_nematic_tensor, eval, evec);
-    m_nematic_director = vec3<float>(evec(2, 0), evec(2, 1), evec(2, 2));
-    m_nematic_order_parameter = eval[2];
+    freud::util::diagonalize33SymmetricMatrix(Q, eval, evec);
+    director = vec3<float>(evec(2, 0), evec(2, 1), evec(2, 2));
+    return eval[2];
+}
+
+void Nematic::compute(quat<float>* orientations, unsigned int n)
+{
+    m_n = n;
+    m_particle_tensor.prepare({m_n, 3, 3});
+
+    // calculate per-particle tensor, and sum the products of the axes.
+    util::ParallelAccumulator<double> local_sums(6);
+    util::forLoopWrapper(0, n, [&](size_t begin, size_t end) {
+        double sums[6] = {};
+        accumulateAxes(orientations + begin, end - begin, sums, m_particle_tensor.get() + 9 * begin);
+        local_sums.add(sums);
+    });
+    util::ManagedArray<double> sums(6);
+    local_sums.reduceInto(sums);
+
+    m_nematic_tensor.prepare({3, 3});
+    m_nematic_order_parameter
+        = diagonalizeNematicTensor(sums.get(), m_n, m_nematic_tensor.get(), m_nematic_director);
+}
+
+void Nematic::computeFrames(const quat<float>* orientations, unsigned int n_frames, unsigned int n)
+{
+    m_n = n;
+
+    // Frames and blocks of particles are processed in parallel, and only the
+    // sums of the products of the axes of each frame are kept.
+    util::ParallelAccumulator<double> local_sums(6 * size_t(n_frames));
+    util::forLoopWrapper2D(
+        0, n_frames, 0, n, [&](size_t begin_frame, size_t end_frame, size_t begin, size_t end) {
+            for (size_t frame = begin_frame; frame < end_frame; ++frame)
+            {
+                double sums[6] = {};
+                accumulateAxes(orientations + frame * n + begin, end - begin, sums, nullptr);
+                for (unsigned int c = 0; c < 6; ++c)
+                {
+                    local_sums.add(6 * frame + c, sums[c]);
+                }
+            }
+        });
+    util::ManagedArray<double> sums(6 * size_t(n_frames));
+    local_sums.reduceInto(sums);
+
+    m_frame_order_parameters.prepare(n_frames);
+    m_frame_directors.prepare({n_frames, 3});
+    m_frame_nematic_tensors.prepare({n_frames, 3, 3});
+    util::forLoopWrapper(0, n_frames, [&](size_t begin, size_t end) {
+        for (size_t frame = begin; frame < end; ++frame)
+        {
+            vec3<float> director;
+            m_frame_order_parameters[frame] = diagonalizeNematicTensor(
+                sums.get() + 6 * frame, n, m_frame_nematic_tensors.get() + 9 * frame, director);
+            m_frame_directors(frame, 0) = director.x;
+            m_frame_directors(frame, 1) = director.y;
+            m_frame_directors(frame, 2) = director.z;
+        }
+    });
 }
 
 }; }; // end namespace freud::order
@@ -8,7 +8,6 @@
 
 #include "Box.h"
 #include "ManagedArray.h"
-#include "ThreadStorage.h"
 #include "VectorMath.h"
 
 /*! \file Nematic.h
@@ -17,7 +16,11 @@
 
 namespace freud { namespace order {
 //! Compute the nematic order parameter for a set of points
-/*!
+/*! The nematic tensor is Q = 3/2 <u u^T> - 1/2 I for the rotated molecular
+ *  axes u, so only the six independent components of u u^T are accumulated,
+ *  over blocks of particles in loops that the compiler can vectorize. Many
+ *  frames can be computed at once with computeFrames, which never stores the
+ *  per-particle tensors.
  */
 class Nematic
 {
@@ -31,6 +34,32 @@ public:
     //! Compute the nematic order parameter
     void compute(quat<float>* orientations, unsigned int n);
 
+    //! Compute the nematic order parameter of many frames.
+    /*! \param orientations Orientations, with the orientation of particle i
+     *         in frame f at index f * n + i.
+     *  \param n_frames Number of frames.
+     *  \param n Number of particles per frame.
+     */
+    void computeFrames(const quat<float>* orientations, unsigned int n_frames, unsigned int n);
+
+    //! Get the order parameter of each frame of the last call to computeFrames
+    const util::ManagedArray<float>& getFrameOrderParameters() const
+    {
+        return m_frame_order_parameters;
+    }
+
+    //! Get the director of each frame of the last call to computeFrames, with shape (n_frames, 3)
+    const util::ManagedArray<float>& getFrameDirectors() const
+    {
+        return m_frame_directors;
+    }
+
+    //! Get the nematic tensor of each frame of the last call to computeFrames, with shape (n_frames, 3, 3)
+    const util::ManagedArray<float>& getFrameNematicTensors() const
+    {
+        return m_frame_nematic_tensors;
+    }
+
     //! Get the value of the last computed nematic order parameter
     float getNematicOrderParameter() const;
 
@@ -45,14 +74,29 @@ public:
     vec3<float> getU() const;
 
 private:
+    //! Sum the independent components of u u^T over the rotated molecular axes of particles.
+    /*! \param orientations The orientations of the particles.
+     *  \param n Number of particles.
+     *  \param sums The six sums of xx, xy, xz, yy, yz, and zz, which are incremented.
+     *  \param particle_tensor If not nullptr, filled with the n per-particle tensors.
+     */
+    void accumulateAxes(const quat<float>* orientations, size_t n, double* sums,
+                        float* particle_tensor) const;
+
+    //! Build the nematic tensor from the sums of accumulateAxes and diagonalize it.
+    float diagonalizeNematicTensor(const double* sums, unsigned int n, float* nematic_tensor,
+                                   vec3<float>& director) const;
+
     unsigned int m_n;                //!< Last number of points computed
     vec3<float> m_u;                 //!< The molecular axis
     float m_nematic_order_parameter; //!< Current value of the order parameter
     vec3<float> m_nematic_director;  //!< The director (eigenvector corresponding to the OP)
 
-    util::ManagedArray<float> m_nematic_tensor;        //!< The computed nematic tensor.
-    util::ThreadStorage<float> m_nematic_tensor_local; //!< Thread-specific nematic tensor.
-    util::ManagedArray<float> m_particle_tensor;       //!< The per-particle tensor that is summed up to Q.
+    util::ManagedArray<float> m_nematic_tensor;         //!< The computed nematic tensor.
+    util::ManagedArray<float> m_particle_tensor;        //!< The per-particle tensor that is summed up to Q.
+    util::ManagedArray<float> m_frame_order_parameters; //!< The order parameter of each frame.
+    util::ManagedArray<float> m_frame_directors;        //!< The director of each frame.
+    util::ManagedArray<float> m_frame_nematic_tensors;  //!< The nematic tensor of each frame.
 };
 
 }; }; // end namespace freud::order
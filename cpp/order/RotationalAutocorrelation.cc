@@ -3,8 +3,11 @@
 
 #include "RotationalAutocorrelation.h"
 
+#include "ParallelAccumulator.h"
 #include "utils.h"
+#include <algorithm>
 #include <math.h>
+#include <stdexcept>
 
 /*! \file RotationalAutocorrelation.cc
     \brief Implements the RotationalAutocorrelation class.
@@ -12,6 +15,13 @@
 
 namespace freud { namespace order {
 
+namespace {
+
+//! Number of rotations whose power tables are evaluated together.
+const size_t HARMONIC_BLOCK = 64;
+
+}; // namespace
+
 // This function wraps exponentiation for complex numbers to avoid
 // the case where pow((0,0), 0) returns (nan, nan). Additionally, it
 // serves as a micro-optimization since std::pow can be slow. We can take the
@@ -35,7 +45,7 @@ inline std::complex<float> cpow(std::complex<float> base, unsigned int p)
 inline std::complex<float> RotationalAutocorrelation::hypersphere_harmonic(const std::complex<float> xi,
                                                                            std::complex<float> zeta,
                                                                            const unsigned int a,
-                                                                           const unsigned int b)
+                                                                           const unsigned int b) const
 {
     const std::complex<float> xi_conj = std::conj(xi);
     const std::complex<float> zeta_conj = std::conj(zeta);
@@ -52,52 +62,150 @@ inline std::complex<float> RotationalAutocorrelation::hypersphere_harmonic(const
     return sum_tracker;
 }
 
-void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, const quat<float>* orientations,
-                                        unsigned int N)
+RotationalAutocorrelation::RotationalAutocorrelation(unsigned int l, unsigned int points_per_level,
+                                                     unsigned int decimation)
+    : m_l(l), m_Ft(0), m_reduce_time_correlation(true), m_correlator(points_per_level, decimation)
 {
-    m_RA_array.prepare(N);
+    // For efficiency, we precompute all required factorials for use during
+    // the construction of the terms below.
+    m_factorials.prepare(m_l + 1);
+    m_factorials[0] = 1;
+    for (unsigned int i = 1; i <= m_l; i++)
+    {
+        m_factorials[i] = i * m_factorials[i - 1];
+    }
 
-    // Precompute the hyperspherical harmonics for the unit quaternion. The
-    // default quaternion constructor gives a unit quaternion. We will assume
-    // the same iteration order here as in the loop below to save ourselves
-    // from having to use a more expensive process (i.e. a map).
-    std::complex<float> xi = std::complex<float>(0, 0);
-    std::complex<float> zeta = std::complex<float>(0, 1);
-    std::vector<std::complex<float>> unit_harmonics;
-    std::vector<std::vector<float>> prefactors(m_l + 1, std::vector<float>(m_l + 1, float(0)));
+    // Each pair (a, b) of quantum numbers contributes the hyperspherical
+    // harmonic of the relative rotation, weighted by a prefactor and by the
+    // conjugate harmonic of the unit quaternion (xi, zeta) = (0, i). The
+    // latter vanishes unless a + b = l, so only those pairs are expanded into
+    // terms of the sum over k in hypersphere_harmonic.
+    const std::complex<float> xi = std::complex<float>(0, 0);
+    const std::complex<float> zeta = std::complex<float>(0, 1);
     for (unsigned int a = 0; a <= m_l; a++)
     {
         for (unsigned int b = 0; b <= m_l; b++)
         {
-            unit_harmonics.push_back(std::conj(hypersphere_harmonic(xi, zeta, a, b)));
-            prefactors[a][b] = m_factorials[a] * m_factorials[m_l - a] * m_factorials[b]
-                * m_factorials[m_l - b] / (float(m_l) + 1);
+            const std::complex<double> unit_harmonic(std::conj(hypersphere_harmonic(xi, zeta, a, b)));
+            if (unit_harmonic == std::complex<double>(0, 0))
+            {
+                continue;
+            }
+            const double prefactor = m_factorials[a] * m_factorials[m_l - a] * m_factorials[b]
+                * m_factorials[m_l - b] / (double(m_l) + 1);
+            for (unsigned int k = (a + b < m_l ? 0 : a + b - m_l); k <= std::min(a, b); k++)
+            {
+                const double fact_product = m_factorials[k] * m_factorials[m_l + k - a - b]
+                    * m_factorials[a - k] * m_factorials[b - k];
+                const std::complex<double> coefficient = prefactor * unit_harmonic / fact_product;
+                m_terms.push_back({static_cast<float>(coefficient.real()),
+                                   static_cast<float>(coefficient.imag()), k, b - k, a - k,
+                                   m_l + k - a - b});
+            }
         }
     }
+}
 
-    // Parallel loop is over orientations (technically (ref_or, or) pairs).
-    util::forLoopWrapper(0, N, [=](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+void RotationalAutocorrelation::evaluate(const quat<float>* ref_orientations, const quat<float>* orientations,
+                                         size_t n, std::complex<float>* result) const
+{
+    // The powers 0 to l of the four bases conj(xi), zeta, conj(zeta), and -xi
+    // are stored for a block of rotations, with row (base * (l + 1) + power).
+    const size_t n_powers = m_l + 1;
+    HarmonicWorkspace& workspace = m_local_workspaces.local();
+    workspace.power_real.resize(4 * n_powers * HARMONIC_BLOCK);
+    workspace.power_imag.resize(4 * n_powers * HARMONIC_BLOCK);
+    float* const power_real = workspace.power_real.data();
+    float* const power_imag = workspace.power_imag.data();
+
+    for (size_t block_begin = 0; block_begin < n; block_begin += HARMONIC_BLOCK)
+    {
+        const size_t count = std::min(HARMONIC_BLOCK, n - block_begin);
+        for (size_t i = 0; i < count; ++i)
         {
             // Transform the orientation quaternions into Xi/Zeta coordinates;
-            quat<float> qq_1 = conj(ref_orientations[i]) * orientations[i];
-            std::complex<float> xi = std::complex<float>(qq_1.v.x, qq_1.v.y);
-            std::complex<float> zeta = std::complex<float>(qq_1.v.z, qq_1.s);
-
-            // Loop through the valid quantum numbers.
-            m_RA_array[i] = std::complex<float>(0, 0);
-            unsigned int uh_index = 0;
-            for (unsigned int a = 0; a <= m_l; a++)
+            const quat<float> qq_1
+                = conj(ref_orientations[block_begin + i]) * orientations[block_begin + i];
+            const float base_real[4] = {qq_1.v.x, qq_1.v.z, qq_1.v.z, -qq_1.v.x};
+            const float base_imag[4] = {-qq_1.v.y, qq_1.s, -qq_1.s, -qq_1.v.y};
+            for (unsigned int base = 0; base < 4; ++base)
             {
-                for (unsigned int b = 0; b <= m_l; b++)
+                power_real[base * n_powers * HARMONIC_BLOCK + i] = 1;
+                power_imag[base * n_powers * HARMONIC_BLOCK + i] = 0;
+                if (n_powers > 1)
                 {
-                    std::complex<float> combined_value
-                        = unit_harmonics[uh_index] * hypersphere_harmonic(xi, zeta, a, b);
-                    m_RA_array[i] += prefactors[a][b] * combined_value;
-                    uh_index += 1;
+                    power_real[(base * n_powers + 1) * HARMONIC_BLOCK + i] = base_real[base];
+                    power_imag[(base * n_powers + 1) * HARMONIC_BLOCK + i] = base_imag[base];
                 }
             }
         }
+        for (unsigned int base = 0; base < 4; ++base)
+        {
+            const float* base_real = power_real + (base * n_powers + 1) * HARMONIC_BLOCK;
+            const float* base_imag = power_imag + (base * n_powers + 1) * HARMONIC_BLOCK;
+            for (size_t power = 2; power < n_powers; ++power)
+            {
+                const float* previous_real = power_real + (base * n_powers + power - 1) * HARMONIC_BLOCK;
+                const float* previous_imag = power_imag + (base * n_powers + power - 1) * HARMONIC_BLOCK;
+                float* current_real = power_real + (base * n_powers + power) * HARMONIC_BLOCK;
+                float* current_imag = power_imag + (base * n_powers + power) * HARMONIC_BLOCK;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    current_real[i] = previous_real[i] * base_real[i] - previous_imag[i] * base_imag[i];
+                    current_imag[i] = previous_real[i] * base_imag[i] + previous_imag[i] * base_real[i];
+                }
+            }
+        }
+
+        float sum_real[HARMONIC_BLOCK] = {};
+        float sum_imag[HARMONIC_BLOCK] = {};
+        for (const HarmonicTerm& term : m_terms)
+        {
+            const size_t rows[4] = {term.power_xi_conj, n_powers + term.power_zeta,
+                                    2 * n_powers + term.power_zeta_conj, 3 * n_powers + term.power_neg_xi};
+            const float* real_0 = power_real + rows[0] * HARMONIC_BLOCK;
+            const float* imag_0 = power_imag + rows[0] * HARMONIC_BLOCK;
+            const float* real_1 = power_real + rows[1] * HARMONIC_BLOCK;
+            const float* imag_1 = power_imag + rows[1] * HARMONIC_BLOCK;
+            const float* real_2 = power_real + rows[2] * HARMONIC_BLOCK;
+            const float* imag_2 = power_imag + rows[2] * HARMONIC_BLOCK;
+            const float* real_3 = power_real + rows[3] * HARMONIC_BLOCK;
+            const float* imag_3 = power_imag + rows[3] * HARMONIC_BLOCK;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float real_01 = real_0[i] * real_1[i] - imag_0[i] * imag_1[i];
+                const float imag_01 = real_0[i] * imag_1[i] + imag_0[i] * real_1[i];
+                const float real_23 = real_2[i] * real_3[i] - imag_2[i] * imag_3[i];
+                const float imag_23 = real_2[i] * imag_3[i] + imag_2[i] * real_3[i];
+                const float real_monomial = real_01 * real_23 - imag_01 * imag_23;
+                const float imag_monomial = real_01 * imag_23 + imag_01 * real_23;
+                sum_real[i] += term.coefficient_real * real_monomial - term.coefficient_imag * imag_monomial;
+                sum_imag[i] += term.coefficient_real * imag_monomial + term.coefficient_imag * real_monomial;
+            }
+        }
+        for (size_t i = 0; i < count; ++i)
+        {
+            result[block_begin + i] = std::complex<float>(sum_real[i], sum_imag[i]);
+        }
+    }
+}
+
+std::complex<float> RotationalAutocorrelation::correlate(const quat<float>& ref_orientation,
+                                                         const quat<float>& orientation) const
+{
+    std::complex<float> value;
+    evaluate(&ref_orientation, &orientation, 1, &value);
+    return value;
+}
+
+void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, const quat<float>* orientations,
+                                        unsigned int N)
+{
+    m_RA_array.prepare(N);
+
+    // Parallel loop is over orientations (technically (ref_or, or) pairs).
+    util::forLoopWrapper(0, N, [=](size_t begin, size_t end) {
+        evaluate(ref_orientations + begin, orientations + begin, end - begin, m_RA_array.get() + begin);
     });
 
     float RA_sum(0);
@@ -108,4 +216,69 @@ void RotationalAutocorrelation::compute(const quat<float>* ref_orientations, con
     m_Ft = RA_sum / N;
 };
 
+void RotationalAutocorrelation::computeFrames(const quat<float>* ref_orientations,
+                                              const quat<float>* orientations, unsigned int n_frames,
+                                              unsigned int N)
+{
+    util::ParallelAccumulator<double> frame_sums(n_frames);
+    util::forLoopWrapper2D(
+        0, n_frames, 0, N, [&](size_t begin_frame, size_t end_frame, size_t begin, size_t end) {
+            std::vector<std::complex<float>>& particles = m_local_workspaces.local().particles;
+            particles.resize(end - begin);
+            for (size_t frame = begin_frame; frame < end_frame; ++frame)
+            {
+                evaluate(ref_orientations + begin, orientations + frame * N + begin, end - begin,
+                         particles.data());
+                double sum = 0;
+                for (const std::complex<float>& value : particles)
+                {
+                    sum += std::real(value);
+                }
+                frame_sums.add(frame, sum);
+            }
+        });
+
+    util::ManagedArray<double> frame_sum(n_frames);
+    frame_sums.reduceInto(frame_sum);
+    m_frame_Ft.prepare(n_frames);
+    for (unsigned int frame = 0; frame < n_frames; ++frame)
+    {
+        m_frame_Ft[frame] = static_cast<float>(frame_sum[frame] / N);
+    }
+}
+
+void RotationalAutocorrelation::accumulateFrames(const quat<float>* orientations, unsigned int n_frames,
+                                                 unsigned int N)
+{
+    if (m_correlator.getNumFrames() == 0)
+    {
+        m_correlator.reset(N);
+    }
+    else if (N != m_correlator.getNumChannels())
+    {
+        throw std::invalid_argument("RotationalAutocorrelation requires the same number of orientations "
+                                    "in all frames accumulated since the last reset.");
+    }
+
+    // The system autocorrelation is the average of the real parts.
+    const auto real_correlation = [this](const quat<float>& ref_orientation, const quat<float>& orientation) {
+        return double(std::real(correlate(ref_orientation, orientation)));
+    };
+    for (unsigned int frame = 0; frame < n_frames; ++frame)
+    {
+        m_correlator.push(orientations + size_t(frame) * N, real_correlation);
+    }
+    m_reduce_time_correlation = true;
+}
+
+const util::ManagedArray<float>& RotationalAutocorrelation::getTimeCorrelation()
+{
+    if (m_reduce_time_correlation)
+    {
+        m_correlator.reduce(m_time_correlation);
+        m_reduce_time_correlation = false;
+    }
+    return m_time_correlation;
+}
+
 }; }; // end namespace freud::order
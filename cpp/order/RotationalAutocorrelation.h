@@ -5,8 +5,11 @@
 #define ROTATIONAL_AUTOCORRELATION_H
 
 #include <complex>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
 
 #include "ManagedArray.h"
+#include "MultipleTauCorrelator.h"
 #include "VectorMath.h"
 
 /*! \file RotationalAutocorrelation.h
@@ -40,6 +43,18 @@ std::pair<std::complex<float>, std::complex<float>> quat_to_greek(const quat<flo
  *  representation of the rotations. For details, see "Design rules for
  *  engineering colloidal plastic crystals of hard polyhedra – phase behavior
  *  and directional entropic forces" by Karas et al. (currently in preparation).
+ *
+ *  The sum over quantum numbers is expanded at construction into a table of
+ *  monomials of the complex coordinates of a rotation with precomputed
+ *  coefficients, keeping only the terms whose unit-quaternion harmonic is
+ *  nonzero. Autocorrelations are evaluated over blocks of particles from
+ *  tables of powers of the coordinates, in loops over the particles of a
+ *  block that the compiler can vectorize.
+ *
+ *  Besides comparing a single pair of frames, the class can accumulate a
+ *  trajectory frame by frame into a multiple-tau correlator, giving the
+ *  autocorrelation as a function of time at logarithmically spaced lags
+ *  while only keeping O(log T) orientations per particle.
  */
 class RotationalAutocorrelation
 {
@@ -49,18 +64,11 @@ public:
 
     //! Constructor
     /*! \param l The order of the spherical harmonic.
+     *  \param points_per_level Number of frames kept per level of the time correlation.
+     *  \param decimation Ratio of the sampling intervals of consecutive levels of the time correlation.
      */
-    RotationalAutocorrelation(unsigned int l) : m_l(l), m_Ft(0)
-    {
-        // For efficiency, we precompute all required factorials for use during
-        // the per-particle computation.
-        m_factorials.prepare(m_l + 1);
-        m_factorials[0] = 1;
-        for (unsigned int i = 1; i <= m_l; i++)
-        {
-            m_factorials[i] = i * m_factorials[i - 1];
-        }
-    }
+    RotationalAutocorrelation(unsigned int l, unsigned int points_per_level = 16,
+                              unsigned int decimation = 2);
 
     //! Destructor
     ~RotationalAutocorrelation() {}
@@ -98,7 +106,100 @@ public:
      */
     void compute(const quat<float>* ref_orientations, const quat<float>* orientations, unsigned int N);
 
+    //! Compute the rotational autocorrelation of many frames against one reference.
+    /*! \param ref_orientations Quaternions in initial frame.
+     *  \param orientations Quaternions, with the orientation of particle i
+     *         in frame f at index f * N + i.
+     *  \param n_frames The number of frames.
+     *  \param N The number of orientations.
+     *
+     *  The system autocorrelation of each frame is the same as compute would
+     *  give for that frame alone. Frames and particles are processed in
+     *  parallel in a single pass.
+     */
+    void computeFrames(const quat<float>* ref_orientations, const quat<float>* orientations,
+                       unsigned int n_frames, unsigned int N);
+
+    //! Get the system autocorrelation of each frame of the last call to computeFrames.
+    const util::ManagedArray<float>& getFrameAutocorrelations() const
+    {
+        return m_frame_Ft;
+    }
+
+    //! Reset the accumulated time correlation.
+    void resetTimeCorrelation()
+    {
+        m_correlator.reset(0);
+        m_reduce_time_correlation = true;
+    }
+
+    //! Add frames of a trajectory to the time correlation.
+    /*! \param orientations Quaternions, with the orientation of particle i
+     *         in frame f at index f * N + i.
+     *  \param n_frames The number of frames.
+     *  \param N The number of orientations, which must be the same for all
+     *         frames since the last reset.
+     *
+     *  Each frame is correlated with earlier frames at logarithmically spaced
+     *  lags, using the same inner product of hyperspherical harmonics as
+     *  compute.
+     */
+    void accumulateFrames(const quat<float>* orientations, unsigned int n_frames, unsigned int N);
+
+    //! Get the lags, in frames, of the time correlation.
+    std::vector<size_t> getLags() const
+    {
+        return m_correlator.getLags();
+    }
+
+    //! Get the rotational autocorrelation at each lag.
+    const util::ManagedArray<float>& getTimeCorrelation();
+
+    //! Get the number of frames accumulated since the last reset.
+    size_t getNumFrames() const
+    {
+        return m_correlator.getNumFrames();
+    }
+
+    //! Get the number of frames kept per level of the time correlation.
+    unsigned int getPointsPerLevel() const
+    {
+        return m_correlator.getPointsPerLevel();
+    }
+
+    //! Get the ratio of the sampling intervals of consecutive levels of the time correlation.
+    unsigned int getDecimation() const
+    {
+        return m_correlator.getDecimation();
+    }
+
 private:
+    //! A term of the autocorrelation, as a monomial of the coordinates of the relative rotation.
+    struct HarmonicTerm
+    {
+        float coefficient_real;       //!< Real part of the coefficient.
+        float coefficient_imag;       //!< Imaginary part of the coefficient.
+        unsigned int power_xi_conj;   //!< Power of conj(xi).
+        unsigned int power_zeta;      //!< Power of zeta.
+        unsigned int power_zeta_conj; //!< Power of conj(zeta).
+        unsigned int power_neg_xi;    //!< Power of -xi.
+    };
+
+    //! Per-thread tables of powers of the coordinates of a block of rotations.
+    struct HarmonicWorkspace
+    {
+        std::vector<float> power_real;              //!< Real parts of the powers.
+        std::vector<float> power_imag;              //!< Imaginary parts of the powers.
+        std::vector<std::complex<float>> particles; //!< Autocorrelation of each particle of a block.
+    };
+
+    //! Compute the autocorrelation of n pairs of orientations.
+    void evaluate(const quat<float>* ref_orientations, const quat<float>* orientations, size_t n,
+                  std::complex<float>* result) const;
+
+    //! Compute the autocorrelation of a pair of orientations.
+    std::complex<float> correlate(const quat<float>& ref_orientation, const quat<float>& orientation) const;
+
     //! Compute a hyperspherical harmonic.
     /*! \param xi The first complex number coordinate.
      *  \param zeta The second complex number coordinate.
@@ -115,13 +216,20 @@ private:
      *  m_l.
      */
     std::complex<float> hypersphere_harmonic(const std::complex<float> xi, std::complex<float> zeta,
-                                             const unsigned int m1, const unsigned int m2);
+                                             const unsigned int m1, const unsigned int m2) const;
+
+    unsigned int m_l;               //!< Order of the hyperspherical harmonic.
+    float m_Ft;                     //!< Real value of calculated RA function.
+    bool m_reduce_time_correlation; //!< Whether the time correlation needs to be recomputed.
 
-    unsigned int m_l; //!< Order of the hyperspherical harmonic.
-    float m_Ft;       //!< Real value of calculated RA function.
+    util::ManagedArray<std::complex<float>> m_RA_array;    //!< Array of RA values per particle
+    util::ManagedArray<float> m_frame_Ft;                  //!< RA of each frame of computeFrames
+    util::ManagedArray<double> m_factorials;               //!< Array of cached factorials
+    std::vector<HarmonicTerm> m_terms;                     //!< Nonzero terms of the autocorrelation
+    util::MultipleTauCorrelator<quat<float>> m_correlator; //!< Correlator of the orientations over time
+    util::ManagedArray<float> m_time_correlation;          //!< RA at each lag
 
-    util::ManagedArray<std::complex<float>> m_RA_array; //!< Array of RA values per particle
-    util::ManagedArray<unsigned int> m_factorials;      //!< Array of cached factorials
+    mutable tbb::enumerable_thread_specific<HarmonicWorkspace> m_local_workspaces; //!< Power tables
 };
 
 }; }; // end namespace freud::order
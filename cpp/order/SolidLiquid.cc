@@ -2,6 +2,7 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <stdexcept>
+#include <vector>
 
 #include "NeighborComputeFunctional.h"
 #include "SolidLiquid.h"
@@ -10,7 +11,7 @@ namespace freud { namespace order {
 
 SolidLiquid::SolidLiquid(unsigned int l, float q_threshold, unsigned int solid_threshold, bool normalize_q)
     : m_l(l), m_num_ms(2 * l + 1), m_q_threshold(q_threshold), m_solid_threshold(solid_threshold),
-      m_normalize_q(normalize_q), m_steinhardt(l), m_cluster()
+      m_normalize_q(normalize_q), m_memory_budget(0), m_steinhardt(l), m_cluster()
 {
     if (m_q_threshold < 0.0)
     {
@@ -20,84 +21,140 @@ SolidLiquid::SolidLiquid(unsigned int l, float q_threshold, unsigned int solid_t
 }
 
 void SolidLiquid::compute(const freud::locality::NeighborList* nlist,
-                          const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
+                          const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
+                          freud::locality::BondGeometry* geometry)
 {
+    if (geometry != nullptr)
+    {
+        geometry->validate(nlist, m_l);
+    }
+
+    const unsigned int num_points(points->getNPoints());
+    const float normalizationfactor = float(4 * M_PI / m_num_ms);
+    m_number_of_connections.prepare(num_points);
+
+    // Bonds are solid-like if the (normalized) dot product of the qlm of
+    // their points is above the threshold.
+    auto bond_ql_ij = [&](unsigned int i, unsigned int j) {
+        const auto& qlm = m_steinhardt.getQlm();
+        const auto& ql = m_steinhardt.getQl();
+
+        // Accumulate the dot product over m of qlmi and qlmj vectors
+        std::complex<float> ql_ij = 0;
+        for (unsigned int k = 0; k < m_num_ms; k++)
+        {
+            ql_ij += qlm(i, k) * std::conj(qlm(j, k));
+        }
+
+        // Optionally normalize dot products by points' ql values,
+        // accounting for the normalization of ql values
+        if (m_normalize_q)
+        {
+            ql_ij *= normalizationfactor / (ql[i] * ql[j]);
+        }
+        return ql_ij.real();
+    };
+    auto is_solid = [&](unsigned int i, unsigned int j) {
+        return m_number_of_connections[i] >= m_solid_threshold
+            && m_number_of_connections[j] >= m_solid_threshold;
+    };
+
+    if (nlist == nullptr && m_memory_budget != 0
+        && locality::estimateNeighborListBytes(points, num_points, qargs) > m_memory_budget)
+    {
+        // The bonds are found for chunks of points that fit in the memory
+        // budget, once to count the solid-like bonds of each point and once
+        // to cluster them, and are not stored.
+        m_nlist = locality::NeighborList();
+        m_ql_ij = util::ManagedArray<float>();
+        m_steinhardt.compute(nullptr, points, qargs);
+        locality::forEachNeighborListChunk(
+            points, points->getPoints(), num_points, qargs, m_memory_budget,
+            [&](const locality::NeighborList& chunk, const std::vector<unsigned int>& indices) {
+                const auto& segments = chunk.getSegments();
+                const auto& counts = chunk.getCounts();
+                util::forLoopWrapper(0, indices.size(), [&](size_t begin, size_t end) {
+                    for (size_t k = begin; k != end; ++k)
+                    {
+                        const unsigned int i(indices[k]);
+                        unsigned int num_solid_bonds(0);
+                        for (size_t bond = segments[i]; bond < segments[i] + counts[i]; ++bond)
+                        {
+                            if (bond_ql_ij(i, chunk.getPointIndices()[bond]) > m_q_threshold)
+                            {
+                                ++num_solid_bonds;
+                            }
+                        }
+                        m_number_of_connections[i] = num_solid_bonds;
+                    }
+                });
+            });
+        m_cluster.computeUnited(num_points, [&](cluster::ConcurrentUnionFind& sets) {
+            locality::forEachNeighborListChunk(
+                points, points->getPoints(), num_points, qargs, m_memory_budget,
+                [&](const locality::NeighborList& chunk, const std::vector<unsigned int>&) {
+                    const unsigned int* query_point_indices = chunk.getQueryPointIndices().get();
+                    const unsigned int* point_indices = chunk.getPointIndices().get();
+                    util::forLoopWrapper(0, chunk.getNumBonds(), [&](size_t begin, size_t end) {
+                        for (size_t bond = begin; bond < end; ++bond)
+                        {
+                            const unsigned int i(query_point_indices[bond]);
+                            const unsigned int j(point_indices[bond]);
+                            if (is_solid(i, j) && bond_ql_ij(i, j) > m_q_threshold)
+                            {
+                                sets.unite(i, j);
+                            }
+                        }
+                    });
+                });
+        });
+        return;
+    }
+
     // This function requires a NeighborList object, so we always make one and store it locally.
-    m_nlist = locality::makeDefaultNlist(points, nlist, points->getPoints(), points->getNPoints(), qargs);
+    m_nlist = locality::makeDefaultNlist(points, nlist, points->getPoints(), num_points, qargs);
 
     const unsigned int num_query_points(m_nlist.getNumQueryPoints());
 
-    // Compute Steinhardt using neighbor list (also gets ql for normalization)
-    m_steinhardt.compute(&m_nlist, points, qargs);
-    const auto& qlm = m_steinhardt.getQlm();
-    const auto& ql = m_steinhardt.getQl();
-
-    // Compute (normalized) dot products for each bond in the neighbor list
-    const float normalizationfactor = float(4 * M_PI / m_num_ms);
-    const unsigned int num_bonds(m_nlist.getNumBonds());
+    // Compute Steinhardt using neighbor list (also gets ql for normalization).
+    // The bond geometry is keyed to the provided NeighborList, which holds
+    // the same bonds as the local copy.
+    m_steinhardt.compute((geometry != nullptr) ? nlist : &m_nlist, points, qargs, geometry);
+
+    // Compute the bond parameters of each bond in the neighbor list and
+    // count the solid-like bonds of each query point. Bonds are sorted by
+    // query point, so each query point is handled by a single thread.
+    const size_t num_bonds(m_nlist.getNumBonds());
+    const auto& segments = m_nlist.getSegments();
+    const auto& counts = m_nlist.getCounts();
     m_ql_ij.prepare(num_bonds);
 
-    util::forLoopWrapper(
-        0, num_query_points,
-        [=](size_t begin, size_t end) {
-            for (unsigned int i = begin; i != end; ++i)
+    util::forLoopWrapper(0, num_query_points, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i != end; ++i)
+        {
+            const size_t first_bond(segments[i]);
+            const size_t last_bond(first_bond + counts[i]);
+            unsigned int num_solid_bonds(0);
+            for (size_t bond = first_bond; bond < last_bond; ++bond)
             {
-                unsigned int bond(m_nlist.find_first_index(i));
-                for (; bond < num_bonds && m_nlist.getNeighbors()(bond, 0) == i; ++bond)
+                m_ql_ij[bond] = bond_ql_ij(i, m_nlist.getPointIndices()[bond]);
+                if (m_ql_ij[bond] > m_q_threshold)
                 {
-                    const unsigned int j(m_nlist.getNeighbors()(bond, 1));
-
-                    // Accumulate the dot product over m of qlmi and qlmj vectors
-                    std::complex<float> bond_ql_ij = 0;
-                    for (unsigned int k = 0; k < m_num_ms; k++)
-                    {
-                        bond_ql_ij += qlm(i, k) * std::conj(qlm(j, k));
-                    }
-
-                    // Optionally normalize dot products by points' ql values,
-                    // accounting for the normalization of ql values
-                    if (m_normalize_q)
-                    {
-                        bond_ql_ij *= normalizationfactor / (ql[i] * ql[j]);
-                    }
-                    m_ql_ij[bond] = bond_ql_ij.real();
+                    ++num_solid_bonds;
                 }
             }
-        },
-        true);
-
-    // Filter neighbors to contain only solid-like bonds
-    std::unique_ptr<bool[]> solid_filter(new bool[num_bonds]);
-    for (unsigned int bond(0); bond < num_bonds; bond++)
-    {
-        solid_filter[bond] = (m_ql_ij[bond] > m_q_threshold);
-    }
-    freud::locality::NeighborList solid_nlist(m_nlist);
-    solid_nlist.filter(solid_filter.get());
-
-    // Save the neighbor counts of solid-like bonds for each query point
-    m_number_of_connections.prepare(num_query_points);
-    for (unsigned int i(0); i < num_query_points; i++)
-    {
-        m_number_of_connections[i] = solid_nlist.getCounts()[i];
-    }
-
-    // Filter nlist to only bonds between solid-like particles
-    // (particles with more than solid_threshold solid-like bonds)
-    const unsigned int num_solid_bonds(solid_nlist.getNumBonds());
-    std::unique_ptr<bool[]> neighbor_count_filter(new bool[num_solid_bonds]);
-    for (unsigned int bond(0); bond < num_solid_bonds; bond++)
-    {
-        const unsigned int i(solid_nlist.getNeighbors()(bond, 0));
-        const unsigned int j(solid_nlist.getNeighbors()(bond, 1));
-        neighbor_count_filter[bond] = (m_number_of_connections[i] >= m_solid_threshold
-                                       && m_number_of_connections[j] >= m_solid_threshold);
-    }
-    freud::locality::NeighborList solid_neighbor_nlist(solid_nlist);
-    solid_neighbor_nlist.filter(neighbor_count_filter.get());
-
-    // Find clusters of solid-like particles
-    m_cluster.compute(points, &solid_neighbor_nlist, qargs);
+            m_number_of_connections[i] = num_solid_bonds;
+        }
+    });
+
+    // Find clusters of solid-like particles, connected by solid-like bonds
+    // between particles with at least solid_threshold solid-like bonds. The
+    // bonds are selected while clustering, without filtered NeighborList copies.
+    const unsigned int* query_point_indices = m_nlist.getQueryPointIndices().get();
+    const unsigned int* point_indices = m_nlist.getPointIndices().get();
+    m_cluster.computeFiltered(num_points, &m_nlist, [&](size_t bond) {
+        return m_ql_ij[bond] > m_q_threshold && is_solid(query_point_indices[bond], point_indices[bond]);
+    });
 }
 
 }; }; // end namespace freud::order
@@ -83,24 +83,49 @@ public:
         return m_normalize_q;
     }
 
+    //! Get the memory budget of the bonds, in bytes, or 0 if the bonds are not chunked.
+    size_t getMemoryBudget() const
+    {
+        return m_memory_budget;
+    }
+
+    //! Set the memory budget of the bonds found by queries of the points.
+    /*! If the NeighborList of a query is estimated to need more bytes than
+     *  the budget (see locality::estimateNeighborListBytes), compute finds
+     *  the bonds in chunks of points that fit in it instead, and the bond
+     *  parameters and the NeighborList are not stored.
+     *
+     *  \param memory_budget The budget in bytes, or 0 to never chunk the bonds.
+     */
+    void setMemoryBudget(size_t memory_budget)
+    {
+        m_memory_budget = memory_budget;
+    }
+
     //! Compute the Solid-Liquid Order Parameter
+    /*! \param nlist The NeighborList of the bonds, or NULL to query the
+     *         points, in chunks if they exceed the memory budget.
+     *  \param points The points.
+     *  \param qargs Query arguments, used if nlist is NULL.
+     *  \param geometry If not NULL, the bond geometry of nlist, whose
+     *         spherical harmonics are read instead of evaluated.
+     */
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
-                 freud::locality::QueryArgs qargs);
+                 freud::locality::QueryArgs qargs, freud::locality::BondGeometry* geometry = nullptr);
 
     //! Returns largest cluster size.
     unsigned int getLargestClusterSize() const
     {
-        return m_cluster.getClusterKeys()[0].size();
+        return m_cluster.getClusterSize(0);
     }
 
     //! Returns a vector containing the size of all clusters.
     std::vector<unsigned int> getClusterSizes() const
     {
-        std::vector<unsigned int> sizes;
-        auto keys = m_cluster.getClusterKeys();
-        for (auto cluster = keys.begin(); cluster != keys.end(); cluster++)
+        std::vector<unsigned int> sizes(m_cluster.getNumClusters());
+        for (unsigned int cluster = 0; cluster < sizes.size(); ++cluster)
         {
-            sizes.push_back(cluster->size());
+            sizes[cluster] = m_cluster.getClusterSize(cluster);
         }
         return sizes;
     }
@@ -141,6 +166,7 @@ private:
     float m_q_threshold;            //!< Dot product cutoff
     unsigned int m_solid_threshold; //!< Solid-like num connections cutoff
     bool m_normalize_q;             //!< Whether to normalize the qlmi dot products.
+    size_t m_memory_budget;         //!< Bytes of the bonds of a chunk of points, or 0.
     locality::NeighborList m_nlist; //!< The NeighborList used in the last call to compute.
 
     freud::order::Steinhardt m_steinhardt; //!< Steinhardt class used to compute qlm
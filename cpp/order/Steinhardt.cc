@@ -1,6 +1,16 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tbb/task_arena.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "Steinhardt.h"
 #include "NeighborComputeFunctional.h"
 #include "utils.h"
@@ -11,63 +21,182 @@
 
 namespace freud { namespace order {
 
-// Calculating Ylm using fsph module
-void Steinhardt::computeYlm(const float theta, const float phi, std::vector<std::complex<float>>& Ylm)
+Steinhardt::Steinhardt(std::vector<unsigned int> ls, bool average, bool wl, bool weighted,
+                       bool wl_normalize)
+    : m_Np(0), m_ls(ls), m_num_ms(0), m_average(average), m_wl(wl), m_weighted(weighted),
+      m_wl_normalize(wl_normalize), m_norm(ls.size())
 {
-    if (Ylm.size() != m_num_ms)
+    if (m_ls.empty())
     {
-        Ylm.resize(m_num_ms);
+        throw std::invalid_argument("Steinhardt requires at least one value of l.");
     }
-
-    fsph::PointSPHEvaluator<float> sph_eval(m_l);
-
-    unsigned int m_index(0);
-    sph_eval.compute(theta, phi);
-
-    for (typename fsph::PointSPHEvaluator<float>::iterator iter(sph_eval.begin_l(m_l, 0, true));
-         iter != sph_eval.end(); ++iter)
+    for (const unsigned int l : m_ls)
     {
-        // Manually add the Condon-Shortley phase, (-1)^m, to positive odd m
-        float phase = 1;
-        if (m_index <= m_l && m_index % 2 == 1)
-            phase = -1;
-
-        Ylm[m_index] = phase * (*iter);
-        ++m_index;
+        m_qlm_offsets.push_back(m_num_ms);
+        m_num_ms += 2 * l + 1;
+        if (m_wl)
+        {
+            m_w3j.push_back(&getWigner3jTable(l));
+        }
     }
+    m_qlm_local.resize(m_num_ms);
+    m_ylm_local = tbb::enumerable_thread_specific<util::SphericalHarmonics>(
+        util::SphericalHarmonics(*std::max_element(m_ls.begin(), m_ls.end())));
 }
 
 void Steinhardt::reallocateArrays(unsigned int Np)
 {
     m_Np = Np;
+    const unsigned int num_ls = getNumL();
     m_qlmi.prepare({Np, m_num_ms});
     m_qlm.prepare(m_num_ms);
-    m_qli.prepare(Np);
+    m_qli.prepare({Np, num_ls});
     if (m_average)
     {
         m_qlmiAve.prepare({Np, m_num_ms});
-        m_qliAve.prepare(Np);
+        m_qliAve.prepare({Np, num_ls});
     }
     if (m_wl)
     {
-        m_wli.prepare(Np);
+        m_wli.prepare({Np, num_ls});
     }
 }
 
 void Steinhardt::compute(const freud::locality::NeighborList* nlist,
-                         const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
+                         const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
+                         freud::locality::BondGeometry* geometry)
 {
+    util::profiling::ScopedTimer timer("Steinhardt::compute");
     // Allocate and zero out arrays as necessary.
     reallocateArrays(points->getNPoints());
 
+    // Averaging needs the neighbors of every neighbor, so the points are
+    // queried once into a NeighborList that both passes share.
+    std::unique_ptr<locality::NeighborList> query_nlist;
+    if (m_average && nlist == nullptr)
+    {
+        query_nlist.reset(points->query(points->getPoints(), points->getNPoints(), qargs)->toNeighborList());
+        nlist = query_nlist.get();
+    }
+
     // Computes the base qlmi required for each specialized order parameter
-    baseCompute(nlist, points, qargs);
+    baseCompute(nlist, points, qargs, geometry);
 
     if (m_average)
     {
-        computeAve(nlist, points, qargs);
+        computeAve(nlist);
+    }
+
+    finalize();
+}
+
+namespace {
+
+//! Sums over frames of the outputs of a Steinhardt compute.
+struct TrajectorySums
+{
+    TrajectorySums(size_t n_values, size_t num_ls)
+        : particle_order(n_values, 0), particle_counts(n_values, 0), order(num_ls, 0)
+    {}
+
+    std::vector<double> particle_order;        //!< Sum of the per-particle order over frames.
+    std::vector<unsigned int> particle_counts; //!< Number of frames in which each particle has neighbors.
+    std::vector<double> order;                 //!< Sum of the system order over frames.
+};
+
+}; // namespace
+
+void Steinhardt::computeTrajectory(const freud::locality::Trajectory& trajectory,
+                                   freud::locality::QueryArgs qargs, bool parallel_frames)
+{
+    const unsigned int n_frames = trajectory.getNFrames();
+    if (n_frames == 0)
+    {
+        throw std::invalid_argument("A trajectory must contain at least one frame.");
+    }
+    const unsigned int n_points = trajectory.getNPoints();
+    const size_t num_ls = getNumL();
+    const size_t n_values = size_t(n_points) * num_ls;
+
+    tbb::enumerable_thread_specific<TrajectorySums> local_sums(
+        [n_values, num_ls]() { return TrajectorySums(n_values, num_ls); });
+    auto compute_frame = [&](Steinhardt& steinhardt, const freud::locality::NeighborQuery* neighbor_query) {
+        steinhardt.compute(nullptr, neighbor_query, qargs);
+        TrajectorySums& sums = local_sums.local();
+        const util::ManagedArray<float>& particle_order = steinhardt.getParticleOrder();
+        for (size_t i = 0; i < n_values; ++i)
+        {
+            // Particles without neighbors have an order of NaN.
+            if (!std::isnan(particle_order[i]))
+            {
+                sums.particle_order[i] += particle_order[i];
+                ++sums.particle_counts[i];
+            }
+        }
+        for (size_t l_index = 0; l_index < num_ls; ++l_index)
+        {
+            sums.order[l_index] += steinhardt.getOrder()[l_index];
+        }
+    };
+
+    if (parallel_frames)
+    {
+        tbb::enumerable_thread_specific<std::shared_ptr<Steinhardt>> local_computes([this]() {
+            return std::make_shared<Steinhardt>(m_ls, m_average, m_wl, m_weighted, m_wl_normalize);
+        });
+        util::forLoopWrapper(0, n_frames, [&](size_t begin, size_t end) {
+            for (size_t frame = begin; frame < end; ++frame)
+            {
+                std::unique_ptr<freud::locality::NeighborQuery> neighbor_query(
+                    trajectory.makeNeighborQuery(frame));
+                // This object computes the last frame, so that its per-frame
+                // outputs match those of sequential computation.
+                Steinhardt& steinhardt = (frame + 1 == n_frames) ? *this : *local_computes.local();
+                // Isolation prevents this thread from starting another frame,
+                // which would reuse its instance, while it waits for the
+                // parallel loops of this frame.
+                tbb::this_task_arena::isolate([&]() { compute_frame(steinhardt, neighbor_query.get()); });
+            }
+        });
+    }
+    else
+    {
+        trajectory.forEachFrame(
+            [&](const freud::locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                compute_frame(*this, neighbor_query);
+            });
+    }
+
+    TrajectorySums total(n_values, num_ls);
+    for (auto sums = local_sums.begin(); sums != local_sums.end(); ++sums)
+    {
+        for (size_t i = 0; i < n_values; ++i)
+        {
+            total.particle_order[i] += sums->particle_order[i];
+            total.particle_counts[i] += sums->particle_counts[i];
+        }
+        for (size_t l_index = 0; l_index < num_ls; ++l_index)
+        {
+            total.order[l_index] += sums->order[l_index];
+        }
     }
 
+    m_trajectory_particle_order.prepare({n_points, num_ls});
+    for (size_t i = 0; i < n_values; ++i)
+    {
+        m_trajectory_particle_order[i] = (total.particle_counts[i] > 0)
+            ? float(total.particle_order[i] / total.particle_counts[i])
+            : std::numeric_limits<float>::quiet_NaN();
+    }
+    m_trajectory_order.resize(num_ls);
+    for (size_t l_index = 0; l_index < num_ls; ++l_index)
+    {
+        m_trajectory_order[l_index] = float(total.order[l_index] / n_frames);
+    }
+}
+
+void Steinhardt::finalize()
+{
     // Reduce qlm
     m_qlm_local.reduceInto(m_qlm);
 
@@ -82,162 +211,249 @@ void Steinhardt::compute(const freud::locality::NeighborList* nlist,
             aggregatewl(m_wli, m_qlmi, m_qli);
         }
     }
-    m_norm = normalizeSystem();
+    normalizeSystem();
 }
 
 void Steinhardt::baseCompute(const freud::locality::NeighborList* nlist,
-                             const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
+                             const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs,
+                             freud::locality::BondGeometry* geometry)
 {
-    const float normalizationfactor = float(4 * M_PI / m_num_ms);
     // For consistency, this reset is done here regardless of whether the array
     // is populated in baseCompute or computeAve.
     m_qlm_local.reset();
+
+    // The harmonics of the bonds of each point are contiguous rows of the
+    // harmonics of the geometry, starting at the first bond of the point.
+    const std::complex<float>* harmonics = nullptr;
+    const size_t* segments = nullptr;
+    unsigned int num_harmonics = 0;
+    if (geometry != nullptr)
+    {
+        geometry->validate(nlist, *std::max_element(m_ls.begin(), m_ls.end()));
+        harmonics = geometry->getHarmonics().get();
+        segments = nlist->getSegments().get();
+        num_harmonics = (geometry->getLMax() + 1) * (geometry->getLMax() + 1);
+    }
     freud::locality::loopOverNeighborsIterator(
         points, points->getPoints(), m_Np, qargs, nlist,
         [=](size_t i, std::shared_ptr<freud::locality::NeighborPerPointIterator> ppiter) {
-            float total_weight(0);
-            const vec3<float> ref((*points)[i]);
-            for (freud::locality::NeighborBond nb = ppiter->next(); !ppiter->end(); nb = ppiter->next())
-            {
-                const vec3<float> delta = points->getBox().wrap((*points)[nb.point_idx] - ref);
-                const float weight(m_weighted ? nb.weight : 1.0);
-
-                // phi is usually in range 0..2Pi, but
-                // it only appears in Ylm as exp(im\phi),
-                // so range -Pi..Pi will give same results.
-                float phi = std::atan2(delta.y, delta.x); // -Pi..Pi
-
-                // This value must be clamped in cases where the particles are
-                // aligned along z, otherwise due to floating point error we
-                // could get delta.z/nb.distance = -1-eps, which is outside the
-                // valid range of std::acos.
-                float theta = std::acos(util::clamp(delta.z / nb.distance, -1, 1)); // 0..Pi
-
-                // If the points are directly on top of each other,
-                // theta should be zero instead of nan.
-                if (nb.distance == float(0))
-                {
-                    theta = 0;
-                }
+            const std::complex<float>* point_harmonics
+                = (harmonics == nullptr) ? nullptr : harmonics + segments[i] * num_harmonics;
+            computeQlmi(i, *ppiter, point_harmonics, num_harmonics);
+        },
+        true, m_schedule);
+}
 
-                std::vector<std::complex<float>> Ylm(m_num_ms);
-                computeYlm(theta, phi, Ylm); // Fill up Ylm
+void Steinhardt::computeQlmi(size_t i, freud::locality::NeighborPerPointIterator& ppiter,
+                             const std::complex<float>* harmonics, unsigned int num_harmonics)
+{
+    const unsigned int num_ls = getNumL();
+    std::complex<float>* qlmi = &m_qlmi({static_cast<unsigned int>(i), 0});
+    util::SphericalHarmonics& ylm = m_ylm_local.local();
+    float total_weight(0);
+    for (freud::locality::NeighborBond nb = ppiter.next(); !ppiter.end(); nb = ppiter.next())
+    {
+        const float weight(m_weighted ? nb.weight : 1.0);
 
-                for (unsigned int k = 0; k < m_num_ms; ++k)
-                {
-                    m_qlmi({static_cast<unsigned int>(i), k}) += weight * Ylm[k];
-                }
-                total_weight += weight;
-            } // End loop going over neighbor bonds
+        // A single evaluation provides the harmonics of every l. Points
+        // directly on top of each other are treated as aligned along z.
+        const std::complex<float>* bond_harmonics;
+        if (harmonics != nullptr)
+        {
+            bond_harmonics = harmonics;
+            harmonics += num_harmonics;
+        }
+        else
+        {
+            ylm.compute(nb.vector, nb.distance);
+            bond_harmonics = ylm.getYlm(0);
+        }
+        for (unsigned int l_index = 0; l_index < num_ls; ++l_index)
+        {
+            const unsigned int l = m_ls[l_index];
+            const std::complex<float>* Ylm = bond_harmonics + l * l;
+            std::complex<float>* qlmi_l = qlmi + m_qlm_offsets[l_index];
+            for (unsigned int k = 0; k < 2 * l + 1; ++k)
+            {
+                qlmi_l[k] += weight * Ylm[k];
+            }
+        }
+        total_weight += weight;
+    } // End loop going over neighbor bonds
 
-            // Normalize!
-            for (unsigned int k = 0; k < m_num_ms; ++k)
+    // Normalize!
+    for (unsigned int l_index = 0; l_index < num_ls; ++l_index)
+    {
+        const unsigned int l = m_ls[l_index];
+        const float normalizationfactor = float(4 * M_PI / (2 * l + 1));
+        float& qli = m_qli({static_cast<unsigned int>(i), l_index});
+        for (unsigned int k = m_qlm_offsets[l_index]; k < m_qlm_offsets[l_index] + 2 * l + 1; ++k)
+        {
+            qlmi[k] /= total_weight;
+            // Add the norm, which is the (complex) squared magnitude
+            qli += norm(qlmi[k]);
+            // This array gets populated by computeAve in the averaging case.
+            if (!m_average)
             {
-                // Cache the index for efficiency.
-                const unsigned int index = m_qlmi.getIndex({static_cast<unsigned int>(i), k});
-                m_qlmi[index] /= total_weight;
-                // Add the norm, which is the (complex) squared magnitude
-                m_qli[i] += norm(m_qlmi[index]);
-                // This array gets populated by computeAve in the averaging case.
-                if (!m_average)
-                {
-                    m_qlm_local.local()[k] += m_qlmi[index] / float(m_Np);
-                }
+                m_qlm_local.local()[k] += qlmi[k] / float(m_Np);
             }
-            m_qli[i] *= normalizationfactor;
-            m_qli[i] = std::sqrt(m_qli[i]);
-        });
+        }
+        qli *= normalizationfactor;
+        qli = std::sqrt(qli);
+    }
 }
 
-void Steinhardt::computeAve(const freud::locality::NeighborList* nlist,
-                            const freud::locality::NeighborQuery* points, freud::locality::QueryArgs qargs)
+namespace {
+
+//! Add a row of complex values to another, four floats at a time.
+inline void addRow(std::complex<float>* target, const std::complex<float>* source, unsigned int n)
 {
-    std::shared_ptr<locality::NeighborQueryIterator> iter;
-    if (nlist == NULL)
+    float* target_floats = reinterpret_cast<float*>(target);
+    const float* source_floats = reinterpret_cast<const float*>(source);
+    const unsigned int num_floats = 2 * n;
+    unsigned int k = 0;
+#ifdef __SSE2__
+    for (; k + 4 <= num_floats; k += 4)
+    {
+        _mm_storeu_ps(target_floats + k,
+                      _mm_add_ps(_mm_loadu_ps(target_floats + k), _mm_loadu_ps(source_floats + k)));
+    }
+#endif
+    for (; k < num_floats; ++k)
     {
-        iter = points->query(points->getPoints(), points->getNPoints(), qargs);
+        target_floats[k] += source_floats[k];
     }
+}
 
-    const float normalizationfactor = 4 * M_PI / m_num_ms;
+}; // namespace
 
-    freud::locality::loopOverNeighborsIterator(
-        points, points->getPoints(), m_Np, qargs, nlist,
-        [=](size_t i, std::shared_ptr<freud::locality::NeighborPerPointIterator> ppiter) {
-            unsigned int neighborcount(1);
-            for (freud::locality::NeighborBond nb1 = ppiter->next(); !ppiter->end(); nb1 = ppiter->next())
+void Steinhardt::computeAve(const freud::locality::NeighborList* nlist)
+{
+    const unsigned int* point_indices = nlist->getPointIndices().get();
+    const unsigned int* counts = nlist->getCounts().get();
+    const size_t* segments = nlist->getSegments().get();
+
+    // Sum the qlmi of the neighbors of each particle, the product A Q.
+    util::ManagedArray<std::complex<float>> neighbor_qlmi({m_Np, m_num_ms});
+    util::forLoopWrapper(
+        0, m_Np,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
             {
-                // Since we need to find neighbors of neighbors, we need to add some extra logic here to
-                // create the appropriate iterators.
-                std::shared_ptr<freud::locality::NeighborPerPointIterator> ns_neighbors_iter;
-                if (nlist != NULL)
+                std::complex<float>* row = &neighbor_qlmi({static_cast<unsigned int>(i), 0});
+                for (size_t bond = segments[i]; bond < segments[i] + counts[i]; ++bond)
                 {
-                    ns_neighbors_iter
-                        = std::make_shared<locality::NeighborListPerPointIterator>(nlist, nb1.point_idx);
+                    addRow(row, &m_qlmi({point_indices[bond], 0}), m_num_ms);
                 }
-                else
+            }
+        },
+        m_schedule, true, counts);
+
+    // Sum those sums over the neighbors of each particle, the product
+    // A (A Q), and average with the qlmi of the particle itself.
+    util::forLoopWrapper(
+        0, m_Np,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+            {
+                std::complex<float>* row = &m_qlmiAve({static_cast<unsigned int>(i), 0});
+                unsigned int neighborcount(1);
+                for (size_t bond = segments[i]; bond < segments[i] + counts[i]; ++bond)
                 {
-                    ns_neighbors_iter = iter->query(nb1.point_idx);
+                    const unsigned int j = point_indices[bond];
+                    addRow(row, &neighbor_qlmi({j, 0}), m_num_ms);
+                    neighborcount += counts[j];
                 }
 
-                for (freud::locality::NeighborBond nb2 = ns_neighbors_iter->next(); !ns_neighbors_iter->end();
-                     nb2 = ns_neighbors_iter->next())
+                // Normalize!
+                for (unsigned int l_index = 0; l_index < getNumL(); ++l_index)
                 {
-                    for (unsigned int k = 0; k < m_num_ms; ++k)
+                    const unsigned int l = m_ls[l_index];
+                    const float normalizationfactor = float(4 * M_PI / (2 * l + 1));
+                    float& qliAve = m_qliAve({static_cast<unsigned int>(i), l_index});
+                    for (unsigned int k = m_qlm_offsets[l_index]; k < m_qlm_offsets[l_index] + 2 * l + 1;
+                         ++k)
                     {
-                        // Adding all the qlm of the neighbors. We use the
-                        // vector function signature for indexing into the
-                        // arrays for speed.
-                        m_qlmiAve({static_cast<unsigned int>(i), k}) += m_qlmi({nb2.point_idx, k});
+                        // Cache the index for efficiency.
+                        const unsigned int index = m_qlmiAve.getIndex({static_cast<unsigned int>(i), k});
+                        // Adding the qlm of the particle i itself
+                        m_qlmiAve[index] += m_qlmi[index];
+                        m_qlmiAve[index] /= neighborcount;
+                        m_qlm_local.local()[k] += m_qlmiAve[index] / float(m_Np);
+                        // Add the norm, which is the complex squared magnitude
+                        qliAve += norm(m_qlmiAve[index]);
                     }
-                    neighborcount++;
-                } // End loop over particle neighbor's bonds
-            }     // End loop over particle's bonds
-
-            // Normalize!
-            for (unsigned int k = 0; k < m_num_ms; ++k)
-            {
-                // Cache the index for efficiency.
-                const unsigned int index = m_qlmiAve.getIndex({static_cast<unsigned int>(i), k});
-                // Adding the qlm of the particle i itself
-                m_qlmiAve[index] += m_qlmi[index];
-                m_qlmiAve[index] /= neighborcount;
-                m_qlm_local.local()[k] += m_qlmiAve[index] / float(m_Np);
-                // Add the norm, which is the complex squared magnitude
-                m_qliAve[i] += norm(m_qlmiAve[index]);
+                    qliAve *= normalizationfactor;
+                    qliAve = std::sqrt(qliAve);
+                }
             }
-            m_qliAve[i] *= normalizationfactor;
-            m_qliAve[i] = std::sqrt(m_qliAve[i]);
-        });
+        },
+        m_schedule, true, counts);
 }
 
-float Steinhardt::normalizeSystem()
+SteinhardtPipelineStage::SteinhardtPipelineStage(Steinhardt* steinhardt) : m_steinhardt(steinhardt)
 {
-    float calc_norm(0);
-    const float normalizationfactor = 4 * M_PI / m_num_ms;
-    for (unsigned int k = 0; k < m_num_ms; ++k)
+    if (m_steinhardt->isAverage())
     {
-        // Add the norm, which is the complex squared magnitude
-        calc_norm += norm(m_qlm[k]);
+        throw std::invalid_argument(
+            "NeighborPipeline does not support averaged Steinhardt order parameters.");
     }
-    const float ql_system_norm = std::sqrt(calc_norm * normalizationfactor);
+}
 
-    if (m_wl)
+void SteinhardtPipelineStage::begin(const locality::NeighborQuery* neighbor_query,
+                                    const vec3<float>* query_points, unsigned int n_query_points)
+{
+    if (query_points != neighbor_query->getPoints() || n_query_points != neighbor_query->getNPoints())
+    {
+        throw std::invalid_argument("NeighborPipeline requires the query points to be the system points to "
+                                    "compute Steinhardt order parameters.");
+    }
+    m_steinhardt->reallocateArrays(neighbor_query->getNPoints());
+    m_steinhardt->m_qlm_local.reset();
+}
+
+void SteinhardtPipelineStage::visitPoint(size_t query_point_idx, locality::NeighborPerPointIterator& ppiter)
+{
+    m_steinhardt->computeQlmi(query_point_idx, ppiter);
+}
+
+void SteinhardtPipelineStage::end()
+{
+    m_steinhardt->finalize();
+}
+
+void Steinhardt::normalizeSystem()
+{
+    for (unsigned int l_index = 0; l_index < getNumL(); ++l_index)
     {
-        auto wigner3jvalues = getWigner3j(m_l);
-        float wl_system_norm = reduceWigner3j(m_qlm.get(), m_l, wigner3jvalues);
+        const unsigned int l = m_ls[l_index];
+        const std::complex<float>* qlm = &m_qlm[m_qlm_offsets[l_index]];
+        float calc_norm(0);
+        const float normalizationfactor = float(4 * M_PI / (2 * l + 1));
+        for (unsigned int k = 0; k < 2 * l + 1; ++k)
+        {
+            // Add the norm, which is the complex squared magnitude
+            calc_norm += norm(qlm[k]);
+        }
+        const float ql_system_norm = std::sqrt(calc_norm * normalizationfactor);
 
-        // The normalization factor of wl is calculated using qli, which is
-        // equivalent to calculate the normalization factor from qlmi
-        if (m_wl_normalize)
+        if (m_wl)
         {
-            const float wl_normalization = std::sqrt(normalizationfactor) / ql_system_norm;
-            wl_system_norm *= wl_normalization * wl_normalization * wl_normalization;
+            float wl_system_norm = m_w3j[l_index]->reduce(qlm);
+
+            // The normalization factor of wl is calculated using qli, which is
+            // equivalent to calculate the normalization factor from qlmi
+            if (m_wl_normalize)
+            {
+                const float wl_normalization = std::sqrt(normalizationfactor) / ql_system_norm;
+                wl_system_norm *= wl_normalization * wl_normalization * wl_normalization;
+            }
+            m_norm[l_index] = wl_system_norm;
+        }
+        else
+        {
+            m_norm[l_index] = ql_system_norm;
         }
-        return wl_system_norm;
-    }
-    else
-    {
-        return ql_system_norm;
     }
 }
 
@@ -245,16 +461,23 @@ void Steinhardt::aggregatewl(util::ManagedArray<float>& target,
                              util::ManagedArray<std::complex<float>>& source,
                              util::ManagedArray<float>& normalization_source)
 {
-    auto wigner3jvalues = getWigner3j(m_l);
-    const float normalizationfactor = float(4 * M_PI / m_num_ms);
     util::forLoopWrapper(0, m_Np, [&](size_t begin, size_t end) {
-        for (size_t i = begin; i < end; ++i)
+        for (unsigned int l_index = 0; l_index < getNumL(); ++l_index)
         {
-            target[i] = reduceWigner3j(&(source({static_cast<unsigned int>(i), 0})), m_l, wigner3jvalues);
+            // Reduce the particles of the block together, then normalize.
+            m_w3j[l_index]->reduce(&(source({static_cast<unsigned int>(begin), m_qlm_offsets[l_index]})),
+                                   m_num_ms, end - begin,
+                                   &(target({static_cast<unsigned int>(begin), l_index})), getNumL());
             if (m_wl_normalize)
             {
-                const float normalization = std::sqrt(normalizationfactor) / normalization_source[i];
-                target[i] *= normalization * normalization * normalization;
+                const unsigned int l = m_ls[l_index];
+                const float normalizationfactor = float(4 * M_PI / (2 * l + 1));
+                for (size_t i = begin; i < end; ++i)
+                {
+                    const unsigned int index = target.getIndex({static_cast<unsigned int>(i), l_index});
+                    const float normalization = std::sqrt(normalizationfactor) / normalization_source[index];
+                    target[index] *= normalization * normalization * normalization;
+                }
             }
         }
     });
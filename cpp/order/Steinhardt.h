@@ -5,15 +5,22 @@
 #define STEINHARDT_H
 
 #include <complex>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
 
+#include "BondGeometry.h"
 #include "Box.h"
 #include "ManagedArray.h"
 #include "NeighborList.h"
+#include "NeighborPerPointIterator.h"
+#include "NeighborPipeline.h"
 #include "NeighborQuery.h"
+#include "SphericalHarmonics.h"
 #include "ThreadStorage.h"
+#include "Trajectory.h"
 #include "VectorMath.h"
 #include "Wigner3j.h"
-#include "fsph/src/spherical_harmonics.hpp"
+#include "utils.h"
 
 /*! \file Steinhardt.h
     \brief Computes variants of Steinhardt order parameters.
@@ -48,6 +55,10 @@ namespace freud { namespace order {
  * If the flag wl_normalize is set, the third-order invariant wl order parameter
  * will be normalized.
  *
+ * Several values of l may be computed at once. The spherical harmonics of
+ * each bond are then evaluated once for all l, and the per-particle outputs
+ * have one column per l.
+ *
  * For more details see:
  * - PJ Steinhardt (1983) (DOI: 10.1103/PhysRevB.28.784)
  * - Wolfgang Lechner (2008) (DOI: 10.1063/Journal of Chemical Physics 129.114707)
@@ -63,11 +74,15 @@ public:
      */
     Steinhardt(unsigned int l, bool average = false, bool wl = false, bool weighted = false,
                bool wl_normalize = false)
-        : m_Np(0), m_l(l), m_num_ms(2 * l + 1), m_average(average), m_wl(wl), m_weighted(weighted),
-          m_wl_normalize(wl_normalize), m_qlm_local(2 * l + 1)
-
+        : Steinhardt(std::vector<unsigned int> {l}, average, wl, weighted, wl_normalize)
     {}
 
+    //! Constructor computing several values of l in a single pass.
+    /*! \param ls Spherical harmonic numbers l. Must not be empty.
+     */
+    Steinhardt(std::vector<unsigned int> ls, bool average = false, bool wl = false, bool weighted = false,
+               bool wl_normalize = false);
+
     //! Empty destructor
     ~Steinhardt() {};
 
@@ -109,12 +124,24 @@ public:
         return m_qlmi;
     }
 
-    //! Get system-normalized order
-    float getOrder() const
+    //! Get system-normalized order for each l
+    const std::vector<float>& getOrder() const
     {
         return m_norm;
     }
 
+    //! Get the per-particle order averaged over the frames of the last trajectory
+    const util::ManagedArray<float>& getTrajectoryParticleOrder() const
+    {
+        return m_trajectory_particle_order;
+    }
+
+    //! Get the system-normalized order for each l averaged over the frames of the last trajectory
+    const std::vector<float>& getTrajectoryOrder() const
+    {
+        return m_trajectory_order;
+    }
+
     //!< Whether to take a second shell average
     bool isAverage() const
     {
@@ -139,20 +166,61 @@ public:
         return m_wl_normalize;
     }
 
+    //! Set how points are split among threads
+    void setLoopSchedule(const util::LoopSchedule& schedule)
+    {
+        m_schedule = schedule;
+    }
+
+    //! Get how points are split among threads
+    const util::LoopSchedule& getLoopSchedule() const
+    {
+        return m_schedule;
+    }
+
     //! Compute the order parameter
+    /*! \param nlist The NeighborList of the bonds, or NULL to query the points.
+     *  \param points The points.
+     *  \param qargs Query arguments, used if nlist is NULL.
+     *  \param geometry If not NULL, the bond geometry of nlist, whose
+     *         spherical harmonics are read instead of evaluated.
+     */
     void compute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
-                 freud::locality::QueryArgs qargs);
+                 freud::locality::QueryArgs qargs, freud::locality::BondGeometry* geometry = nullptr);
+
+    //! Compute the order parameter of every frame of a trajectory and average it over frames.
+    /*! The per-particle order of a particle is averaged over the frames in
+     *  which it has neighbors. All other outputs hold the values of the last
+     *  frame.
+     *  \param trajectory The frames of points.
+     *  \param qargs Query arguments.
+     *  \param parallel_frames If true, frames are computed concurrently by
+     *         separate Steinhardt instances, one per thread, instead of one
+     *         at a time in parallel over their points.
+     */
+    void computeTrajectory(const freud::locality::Trajectory& trajectory, freud::locality::QueryArgs qargs,
+                           bool parallel_frames = false);
 
-    unsigned int getL() const
+    //! Get the spherical harmonic numbers l
+    const std::vector<unsigned int>& getL() const
     {
-        return m_l;
+        return m_ls;
+    }
+
+    //! Get the number of values of l computed
+    unsigned int getNumL() const
+    {
+        return m_ls.size();
+    }
+
+    //! Get the offset of the values for the l with index l_index in a row of getQlm
+    unsigned int getQlmOffset(unsigned int l_index) const
+    {
+        return m_qlm_offsets[l_index];
     }
 
 private:
-    //! \internal
-    //! Spherical harmonics calculation for Ylm filling a
-    //  std::vector<std::complex<float> > with values for m = -l..l.
-    void computeYlm(const float theta, const float phi, std::vector<std::complex<float>>& Ylm);
+    friend class SteinhardtPipelineStage;
 
     template<typename T> std::shared_ptr<T> makeArray(size_t size);
 
@@ -162,15 +230,33 @@ private:
 
     //! Calculates qlms and the ql order parameter before any further modifications
     void baseCompute(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
-                     freud::locality::QueryArgs qargs);
+                     freud::locality::QueryArgs qargs, freud::locality::BondGeometry* geometry);
+
+    //! Calculates qlmi and qli for the query point i from its neighbors
+    /*! \param i The query point.
+     *  \param ppiter The bonds of i.
+     *  \param harmonics If not NULL, the harmonics of the bonds of i for all
+     *         l up to the largest l, with num_harmonics values per bond.
+     *  \param num_harmonics Number of harmonics of each bond.
+     */
+    void computeQlmi(size_t i, freud::locality::NeighborPerPointIterator& ppiter,
+                     const std::complex<float>* harmonics = nullptr, unsigned int num_harmonics = 0);
+
+    //! Reduces qlm and computes wl and the system normalized order from qlmi
+    void finalize();
 
     //! Calculates the neighbor average ql order parameter
-    void computeAve(const freud::locality::NeighborList* nlist, const freud::locality::NeighborQuery* points,
-                    freud::locality::QueryArgs qargs);
+    /*! The sum of qlmi over the second shell of particle i is row i of
+     *  A (A Q), where A is the adjacency matrix stored by the NeighborList
+     *  in compressed sparse row form and Q is the (N, num_ms) qlmi matrix.
+     *  Both sparse products are computed row by row from the bonds of the
+     *  NeighborList, so no neighbors are queried.
+     */
+    void computeAve(const freud::locality::NeighborList* nlist);
 
-    //! Compute the system-wide order by averaging over particles, then
-    //  reducing over the m values to produce a single scalar.
-    float normalizeSystem();
+    //! Compute the system-wide order for each l by averaging over particles,
+    //  then reducing over the m values to produce a single scalar per l.
+    void normalizeSystem();
 
     //! Sum over Wigner 3j coefficients to compute third-order invariants
     //  wl from second-order invariants ql
@@ -178,9 +264,11 @@ private:
                      util::ManagedArray<float>& normalization_source);
 
     // Member variables used for compute
-    unsigned int m_Np;     //!< Last number of points computed
-    unsigned int m_l;      //!< Spherical harmonic l value.
-    unsigned int m_num_ms; //!< The number of magnetic quantum numbers (2*m_l+1).
+    unsigned int m_Np;                       //!< Last number of points computed
+    std::vector<unsigned int> m_ls;          //!< Spherical harmonic l values.
+    std::vector<unsigned int> m_qlm_offsets; //!< Offset of each l in a row of qlm arrays.
+    unsigned int m_num_ms;                   //!< Total number of magnetic quantum numbers over all l.
+    std::vector<const Wigner3jTable*> m_w3j; //!< Wigner 3j coefficients for each l, if computing wl.
 
     // Flags
     bool m_average;      //!< Whether to take a second shell average (default false)
@@ -188,6 +276,10 @@ private:
     bool m_weighted;     //!< Whether to use neighbor weights in computing qlmi (default false)
     bool m_wl_normalize; //!< Whether to normalize the third-order invariant wl (default false)
 
+    util::LoopSchedule m_schedule; //!< How points are split among threads
+
+    // Per-particle arrays have one column per l, and qlm arrays store the
+    // 2l+1 values of each l contiguously starting at its offset.
     util::ManagedArray<std::complex<float>> m_qlmi;       //!< qlm for each particle i
     util::ManagedArray<std::complex<float>> m_qlm;        //!< Normalized qlm(Ave) for the whole system
     util::ThreadStorage<std::complex<float>> m_qlm_local; //!< Thread-specific m_qlm(Ave)
@@ -196,9 +288,35 @@ private:
     util::ManagedArray<std::complex<float>>
         m_qlmiAve; //!< Averaged qlm with 2nd neighbor shell for each particle i
     util::ManagedArray<std::complex<float>> m_qlmAve; //!< Normalized qlmiAve for the whole system
-    float m_norm;                                     //!< System normalized order parameter
+    std::vector<float> m_norm;                        //!< System normalized order parameter for each l
     util::ManagedArray<float>
         m_wli; //!< wl order parameter for each particle i, also used for wl averaged data
+    util::ManagedArray<float> m_trajectory_particle_order; //!< Per-particle order averaged over frames
+    std::vector<float> m_trajectory_order;                 //!< System order averaged over frames
+
+    //! Thread-specific spherical harmonic evaluators, reused for every bond
+    tbb::enumerable_thread_specific<util::SphericalHarmonics> m_ylm_local;
+};
+
+//! Adapter running a Steinhardt compute as a stage of a NeighborPipeline.
+/*! The query points of the pipeline must be the system points. Averaged
+ *  order parameters need the neighbors of neighbors and are not supported.
+ */
+class SteinhardtPipelineStage : public locality::NeighborPipelineStage
+{
+public:
+    //! Constructor
+    explicit SteinhardtPipelineStage(Steinhardt* steinhardt);
+
+    virtual void begin(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                       unsigned int n_query_points);
+
+    virtual void visitPoint(size_t query_point_idx, locality::NeighborPerPointIterator& ppiter);
+
+    virtual void end();
+
+private:
+    Steinhardt* m_steinhardt; //!< The Steinhardt compute being run.
 };
 
 }; };  // end namespace freud::order
@@ -2,12 +2,20 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
 #include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #include "Wigner3j.h"
 
 /*! \file Wigner3j.cc
- *  \brief Stores and reduces over Wigner 3j coefficients for l from 0 to 20
+ *  \brief Stores, computes, and reduces over Wigner 3j coefficients
  */
 
 namespace freud { namespace order {
@@ -5826,7 +5834,226 @@ std::vector<double> getWigner3j(unsigned int l)
             0.0007342271125681172};
     }
     }
-    throw std::out_of_range("Wigner 3j coefficients are implemented for l <= 20.");
+    return computeWigner3j(l);
+}
+
+std::vector<double> computeWigner3j(unsigned int l_)
+{
+    const int l(l_);
+    const double J = double(l) * (l + 1);
+    // Values beyond this are rescaled during the recursions to avoid overflow.
+    const double max_value = 1e150;
+
+    std::vector<double> wigner3j;
+    wigner3j.reserve((3 * l_ * l_ + 3 * l_ + 1));
+    for (int m1 = -l; m1 <= l; m1++)
+    {
+        // With m3 = -m1 - m2, the recursion in m2 of (l l l; m1 m2 m3) is
+        // C(m2 + 1) f(m2 + 1) + D(m2) f(m2) + C(m2) f(m2 - 1) = 0.
+        const auto C = [l, m1](int m2) {
+            const int m3 = -m1 - m2;
+            return std::sqrt(double(l - m2 + 1) * (l + m2) * (l + m3 + 1) * (l - m3));
+        };
+        const auto D = [J, m1](int m2) { return J + 2.0 * m2 * (-m1 - m2); };
+
+        const int lo = std::max(-l - m1, -l);
+        const int hi = std::min(l - m1, l);
+        const int n = hi - lo + 1;
+        const int mid = n / 2;
+
+        // Forward from lo up to mid + 1 and backward from hi down to mid - 1,
+        // since the coefficients at either end of the range are not zero.
+        std::vector<double> forward(n, 0), backward(n, 0);
+        forward[0] = 1;
+        for (int k = 0; k < std::min(mid + 1, n - 1); k++)
+        {
+            const int m2 = lo + k;
+            forward[k + 1] = -(D(m2) * forward[k] + (k > 0 ? C(m2) * forward[k - 1] : 0)) / C(m2 + 1);
+            if (std::fabs(forward[k + 1]) > max_value)
+            {
+                for (int j = 0; j <= k + 1; j++)
+                {
+                    forward[j] /= max_value;
+                }
+            }
+        }
+        backward[n - 1] = 1;
+        for (int k = n - 1; k > std::max(mid - 1, 0); k--)
+        {
+            const int m2 = lo + k;
+            backward[k - 1] = -(D(m2) * backward[k] + (k < n - 1 ? C(m2 + 1) * backward[k + 1] : 0)) / C(m2);
+            if (std::fabs(backward[k - 1]) > max_value)
+            {
+                for (int j = k - 1; j < n; j++)
+                {
+                    backward[j] /= max_value;
+                }
+            }
+        }
+
+        // Match the two solutions by least squares around mid, since a
+        // single coefficient there may be zero.
+        double forward_backward = 0;
+        double backward_backward = 0;
+        for (int k = std::max(mid - 1, 0); k <= std::min(mid + 1, n - 1); k++)
+        {
+            forward_backward += forward[k] * backward[k];
+            backward_backward += backward[k] * backward[k];
+        }
+        const double scale = forward_backward / backward_backward;
+        std::vector<double> row(n);
+        double sum_squares = 0;
+        for (int k = 0; k < n; k++)
+        {
+            row[k] = (k <= mid) ? forward[k] : backward[k] * scale;
+            sum_squares += row[k] * row[k];
+        }
+
+        // Normalize so that (2l + 1) times the sum of squares is 1, with the
+        // coefficient at m2 = lo having the sign (-1)^(l + m1).
+        double normalization = 1 / std::sqrt(sum_squares * (2 * l + 1));
+        if ((l + m1) % 2 != 0)
+        {
+            normalization = -normalization;
+        }
+        for (int k = 0; k < n; k++)
+        {
+            wigner3j.push_back(row[k] * normalization);
+        }
+    }
+    return wigner3j;
+}
+
+Wigner3jTable::Wigner3jTable(unsigned int l_) : m_l(l_)
+{
+    if (2 * l_ + 1 > 65535)
+    {
+        throw std::invalid_argument("Wigner3jTable requires l < 32768.");
+    }
+    const int l(l_);
+    const std::vector<double> wigner3j = getWigner3j(l_);
+
+    // Sum the coefficients of orderings of the same multiset of m values,
+    // keyed by the sorted m values.
+    std::map<std::vector<int>, double> terms;
+    unsigned int counter = 0;
+    for (int m1 = -l; m1 <= l; m1++)
+    {
+        for (int m2 = std::max(-l - m1, -l); m2 <= std::min(l - m1, l); m2++)
+        {
+            std::vector<int> ms = {m1, m2, -m1 - m2};
+            std::sort(ms.begin(), ms.end());
+            terms[ms] += wigner3j[counter];
+            counter++;
+        }
+    }
+
+    for (const auto& term : terms)
+    {
+        // Odd permutations change the sign of the coefficients of odd l, so
+        // their sums cancel up to round off.
+        if (std::fabs(term.second) < 1e-12)
+        {
+            continue;
+        }
+        m_coefficients.push_back(float(term.second));
+        m_indices_1.push_back(uint16_t(lmIndex(l, term.first[0])));
+        m_indices_2.push_back(uint16_t(lmIndex(l, term.first[1])));
+        m_indices_3.push_back(uint16_t(lmIndex(l, term.first[2])));
+    }
+}
+
+float Wigner3jTable::reduce(const std::complex<float>* source) const
+{
+    float result = 0;
+    for (size_t t = 0; t < m_coefficients.size(); t++)
+    {
+        result += m_coefficients[t]
+            * (source[m_indices_1[t]] * source[m_indices_2[t]] * source[m_indices_3[t]]).real();
+    }
+    return result;
+}
+
+void Wigner3jTable::reduce(const std::complex<float>* sources, size_t source_stride, size_t n,
+                           float* results, size_t result_stride) const
+{
+    // Number of arrays reduced together, the width of an SSE register.
+    constexpr size_t block_size = 4;
+    const size_t num_ms = 2 * m_l + 1;
+    const size_t num_terms = m_coefficients.size();
+
+    // The real and imaginary parts of a block, with the arrays of each m value adjacent.
+    std::vector<float> real(num_ms * block_size);
+    std::vector<float> imag(num_ms * block_size);
+    for (size_t begin = 0; begin < n; begin += block_size)
+    {
+        const size_t count = std::min(block_size, n - begin);
+        for (size_t k = 0; k < num_ms; k++)
+        {
+            for (size_t p = 0; p < block_size; p++)
+            {
+                // Pad the last block with zeros.
+                const std::complex<float> value
+                    = (p < count) ? sources[(begin + p) * source_stride + k] : std::complex<float>(0);
+                real[k * block_size + p] = value.real();
+                imag[k * block_size + p] = value.imag();
+            }
+        }
+
+        float block_results[block_size];
+#ifdef __SSE2__
+        __m128 sum = _mm_setzero_ps();
+        for (size_t t = 0; t < num_terms; t++)
+        {
+            const __m128 real_1 = _mm_loadu_ps(&real[m_indices_1[t] * block_size]);
+            const __m128 imag_1 = _mm_loadu_ps(&imag[m_indices_1[t] * block_size]);
+            const __m128 real_2 = _mm_loadu_ps(&real[m_indices_2[t] * block_size]);
+            const __m128 imag_2 = _mm_loadu_ps(&imag[m_indices_2[t] * block_size]);
+            const __m128 real_3 = _mm_loadu_ps(&real[m_indices_3[t] * block_size]);
+            const __m128 imag_3 = _mm_loadu_ps(&imag[m_indices_3[t] * block_size]);
+            const __m128 real_12 = _mm_sub_ps(_mm_mul_ps(real_1, real_2), _mm_mul_ps(imag_1, imag_2));
+            const __m128 imag_12 = _mm_add_ps(_mm_mul_ps(real_1, imag_2), _mm_mul_ps(imag_1, real_2));
+            const __m128 real_123 = _mm_sub_ps(_mm_mul_ps(real_12, real_3), _mm_mul_ps(imag_12, imag_3));
+            sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(m_coefficients[t]), real_123));
+        }
+        _mm_storeu_ps(block_results, sum);
+#else
+        std::fill(block_results, block_results + block_size, 0.0f);
+        for (size_t t = 0; t < num_terms; t++)
+        {
+            const float* real_1 = &real[m_indices_1[t] * block_size];
+            const float* imag_1 = &imag[m_indices_1[t] * block_size];
+            const float* real_2 = &real[m_indices_2[t] * block_size];
+            const float* imag_2 = &imag[m_indices_2[t] * block_size];
+            const float* real_3 = &real[m_indices_3[t] * block_size];
+            const float* imag_3 = &imag[m_indices_3[t] * block_size];
+            for (size_t p = 0; p < block_size; p++)
+            {
+                const float real_12 = real_1[p] * real_2[p] - imag_1[p] * imag_2[p];
+                const float imag_12 = real_1[p] * imag_2[p] + imag_1[p] * real_2[p];
+                block_results[p] += m_coefficients[t] * (real_12 * real_3[p] - imag_12 * imag_3[p]);
+            }
+        }
+#endif
+        for (size_t p = 0; p < count; p++)
+        {
+            results[(begin + p) * result_stride] = block_results[p];
+        }
+    }
+}
+
+const Wigner3jTable& getWigner3jTable(unsigned int l)
+{
+    static std::mutex mutex;
+    static std::map<unsigned int, std::unique_ptr<const Wigner3jTable>> tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<const Wigner3jTable>& table = tables[l];
+    if (!table)
+    {
+        table.reset(new Wigner3jTable(l));
+    }
+    return *table;
 }
 
 }; }; // end namespace freud::order
@@ -5,10 +5,12 @@
 #define WIGNER3J_H
 
 #include <complex>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 /*! \file Wigner3j.h
- *  \brief Stores and reduces over Wigner 3j coefficients for l from 0 to 20
+ *  \brief Stores, computes, and reduces over Wigner 3j coefficients
  */
 
 namespace freud { namespace order {
@@ -22,7 +24,79 @@ int lmIndex(int l, int m);
 //  source array must be indexed by m, like [0, 1, ..., l, -1, -2, ..., -l].
 float reduceWigner3j(const std::complex<float>* source, unsigned int l_, const std::vector<double>& wigner3j);
 
+//! Get the Wigner 3j coefficients (l l l; m1 m2 m3) in the order used by
+//  reduceWigner3j. Coefficients for l <= 20 are tabulated, others are computed
+//  by computeWigner3j.
 std::vector<double> getWigner3j(unsigned int l);
+
+//! Compute the Wigner 3j coefficients (l l l; m1 m2 m3) in the order used by
+//  reduceWigner3j, for any l.
+/*! For each m1, the coefficients are computed over m2 with the three-term
+ *  recursion of Schulten and Gordon (J. Math. Phys. 16, 1961 (1975)), run
+ *  forward and backward and matched in the middle of the range. Each row is
+ *  normalized by the orthogonality relation and its sign is fixed by the
+ *  convention (l l l; m1 m2 m3) > 0 for m1 = -l, with rows alternating in sign.
+ */
+std::vector<double> computeWigner3j(unsigned int l);
+
+//! Compact Wigner 3j coefficients of one l for reducing many arrays at once.
+/*! Since the product source[m1] * source[m2] * source[m3] does not depend on
+ *  the order of the m values, the coefficients of all orderings of each
+ *  multiset {m1, m2, m3} are summed into one term and zero terms are dropped.
+ *  This leaves about a sixth of the terms of reduceWigner3j (and none for odd
+ *  l, whose invariants vanish). The coefficients are stored in single
+ *  precision with the array indices of the m values as separate arrays.
+ */
+class Wigner3jTable
+{
+public:
+    //! Constructor
+    /*! \param l Spherical harmonic l.
+     */
+    explicit Wigner3jTable(unsigned int l);
+
+    //! Get the spherical harmonic l.
+    unsigned int getL() const
+    {
+        return m_l;
+    }
+
+    //! Get the number of terms of the reduction.
+    size_t getNumTerms() const
+    {
+        return m_coefficients.size();
+    }
+
+    //! Reduce an array indexed like [0, 1, ..., l, -1, -2, ..., -l], like reduceWigner3j.
+    float reduce(const std::complex<float>* source) const;
+
+    //! Reduce many arrays.
+    /*! The arrays are processed in blocks that are transposed so that the
+     *  terms of a block are summed for several arrays at once with SIMD
+     *  instructions.
+     *
+     *  \param sources The first array, with the others following at source_stride.
+     *  \param source_stride Distance between consecutive arrays.
+     *  \param n Number of arrays.
+     *  \param results Output of the first array, with the others following at result_stride.
+     *  \param result_stride Distance between consecutive results.
+     */
+    void reduce(const std::complex<float>* sources, size_t source_stride, size_t n, float* results,
+                size_t result_stride) const;
+
+private:
+    unsigned int m_l;                   //!< Spherical harmonic l.
+    std::vector<float> m_coefficients;  //!< Summed coefficient of each term.
+    std::vector<uint16_t> m_indices_1;  //!< Array index of the first m value of each term.
+    std::vector<uint16_t> m_indices_2;  //!< Array index of the second m value of each term.
+    std::vector<uint16_t> m_indices_3;  //!< Array index of the third m value of each term.
+};
+
+//! Get the shared Wigner3jTable of an l, creating it on first use.
+/*! Tables are kept for the lifetime of the program and may be used from
+ *  multiple threads.
+ */
+const Wigner3jTable& getWigner3jTable(unsigned int l);
 // All Wigner 3j coefficients created using sympy
 /*
 
@@ -1,6 +1,15 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tbb/global_control.h>
+#ifdef FREUD_TBB_NUMA_SUPPORT
+#include <tbb/info.h>
+#endif
+
 #include "tbb_config.h"
 
 /*! \file tbb_config.cc
@@ -9,26 +18,69 @@
 
 namespace freud { namespace parallel {
 
-tbb::task_scheduler_init* ts = NULL;
+std::unique_ptr<tbb::global_control> thread_limit;
 
 /*! \param N Number of threads to use for TBB computations
 
-    You do not need to call setTBBNumThreads. The default is to use the number of threads in the system. Use
-   \a N=0 to set back to the default.
+    You do not need to call setNumThreads. The default is to use the number of threads in the system. Use
+    \a N=0 to set back to the default. The limit applies to all TBB arenas of the process.
 
-    \note setTBBNumThreads should only be called from the main thread.
+    \note setNumThreads should only be called from the main thread.
 */
 void setNumThreads(unsigned int N)
 {
-    tbb::task_scheduler_init* old_ts(ts);
+    // Release the previous limit before creating the new one, since
+    // overlapping limits resolve to the smallest.
+    thread_limit.reset();
+    if (N != 0)
+    {
+        thread_limit.reset(new tbb::global_control(tbb::global_control::max_allowed_parallelism, N));
+    }
+}
 
-    if (N == 0)
-        N = tbb::task_scheduler_init::automatic;
+std::vector<int> getNumaNodes()
+{
+    std::vector<int> nodes;
+#ifdef FREUD_TBB_NUMA_SUPPORT
+    // Without topology information, TBB reports a single automatic node.
+    for (const tbb::numa_node_id node : tbb::info::numa_nodes())
+    {
+        if (node >= 0)
+        {
+            nodes.push_back(node);
+        }
+    }
+#endif
+    return nodes;
+}
 
-    delete old_ts;
+Arena::Arena(unsigned int num_threads, int numa_node)
+    : m_num_threads(0), m_numa_node(numa_node < 0 ? -1 : numa_node)
+{
+    const int max_concurrency
+        = (num_threads == 0) ? static_cast<int>(tbb::task_arena::automatic) : static_cast<int>(num_threads);
+    if (m_numa_node >= 0)
+    {
+        const std::vector<int> nodes = getNumaNodes();
+        if (std::find(nodes.begin(), nodes.end(), m_numa_node) == nodes.end())
+        {
+            throw std::invalid_argument("NUMA node " + std::to_string(m_numa_node)
+                                        + " is not one of the NUMA nodes detected by TBB.");
+        }
+#ifdef FREUD_TBB_NUMA_SUPPORT
+        m_arena.initialize(tbb::task_arena::constraints(m_numa_node, max_concurrency));
+#endif
+    }
+    else
+    {
+        m_arena.initialize(max_concurrency);
+    }
+    m_num_threads = static_cast<unsigned int>(m_arena.max_concurrency());
+}
 
-    // then recreate it
-    ts = new tbb::task_scheduler_init(N);
+void Arena::executeCallback(void (*callback)(void*), void* data)
+{
+    m_arena.execute([callback, data]() { callback(data); });
 }
 
 }; }; // end namespace freud::parallel
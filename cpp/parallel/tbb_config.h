@@ -4,17 +4,75 @@
 #ifndef TBB_CONFIG_H
 #define TBB_CONFIG_H
 
-#include <tbb/task_scheduler_init.h>
+#include <tbb/task_arena.h>
+#include <vector>
 
 /*! \file tbb_config.h
     \brief Helper functions to configure tbb
 */
 
+// Task arenas can be constrained to NUMA nodes since oneTBB 2021.
+#if TBB_INTERFACE_VERSION >= 12000
+#define FREUD_TBB_NUMA_SUPPORT
+#endif
+
 namespace freud { namespace parallel {
 
 //! Set the number of TBB threads
 void setNumThreads(unsigned int N);
 
+//! Get the indices of the NUMA nodes of the system
+/*! \returns The NUMA node indices that can be given to Arena, which are
+ *           empty if the TBB library cannot determine the NUMA topology.
+ */
+std::vector<int> getNumaNodes();
+
+//! Task arena with its own set of TBB threads
+/*! Parallel loops started by a function executed in the arena, including all
+ *  freud computes called by it, only use the threads of the arena. Arenas can
+ *  isolate freud from other TBB users in the same process, run concurrent
+ *  computes on separate sets of threads, or keep the threads of a compute
+ *  (and the thread local memory that they first touch) on one NUMA node.
+ */
+class Arena
+{
+public:
+    //! Constructor
+    /*! \param num_threads Maximum number of threads in the arena, including
+     *         the thread executing a function in it. If 0, use all threads of
+     *         the NUMA node, or of the system if numa_node is negative.
+     *  \param numa_node Index of the NUMA node whose cores the threads are
+     *         bound to, or a negative number to not bind threads.
+     */
+    Arena(unsigned int num_threads, int numa_node);
+
+    //! Get the maximum number of threads in the arena.
+    unsigned int getNumThreads() const
+    {
+        return m_num_threads;
+    }
+
+    //! Get the NUMA node of the arena, negative if threads are not bound.
+    int getNumaNode() const
+    {
+        return m_numa_node;
+    }
+
+    //! Execute a function in the arena and wait for it to finish.
+    template<typename Function> void execute(const Function& function)
+    {
+        m_arena.execute(function);
+    }
+
+    //! Execute a callback with a data pointer in the arena, used by Cython.
+    void executeCallback(void (*callback)(void*), void* data);
+
+private:
+    tbb::task_arena m_arena;    //!< The TBB arena.
+    unsigned int m_num_threads; //!< Maximum number of threads in the arena.
+    int m_numa_node;            //!< NUMA node of the threads, or negative.
+};
+
 }; }; // end namespace freud::parallel
 
 #endif // TBB_CONFIG_H
@@ -0,0 +1,222 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <algorithm>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "PMFT.h"
+
+/*! \file PMFT.cc
+    \brief Routines shared by all PMFT classes.
+*/
+
+namespace freud { namespace pmft {
+
+namespace {
+
+const float TAN_PI_8 = 0.414213562f; //!< Bound of the reduced argument of the arctangent.
+const float PI_4 = 0.785398163f;     //!< pi/4
+const float PI_2 = 1.570796327f;     //!< pi/2
+const float PI = 3.141592654f;       //!< pi
+
+//! Coefficients of the polynomial approximating the arctangent in [0, tan(pi/8)] (from Cephes).
+const float ATAN_C0 = -3.33329491539e-1f;
+const float ATAN_C1 = 1.99777106478e-1f;
+const float ATAN_C2 = -1.38776856032e-1f;
+const float ATAN_C3 = 8.05374449538e-2f;
+
+//! Compute atan2(y, x) with the same operations as the vectorized version.
+inline float bondAngle(float y, float x)
+{
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float hi = std::max(ax, ay);
+    float t = (hi > 0.0f) ? std::min(ax, ay) / hi : 0.0f;
+    // atan(t) = pi/4 + atan((t - 1) / (t + 1))
+    const bool reduce = t > TAN_PI_8;
+    t = reduce ? (t - 1.0f) / (t + 1.0f) : t;
+    const float z = t * t;
+    const float p = ((ATAN_C3 * z + ATAN_C2) * z + ATAN_C1) * z + ATAN_C0;
+    float angle = (p * z * t + t) + (reduce ? PI_4 : 0.0f);
+    angle = (ay > ax) ? PI_2 - angle : angle;
+    angle = std::signbit(x) ? PI - angle : angle;
+    return std::copysign(angle, y);
+}
+
+#ifdef __SSE2__
+//! Select the elements of a where mask is set and of b elsewhere.
+inline __m128 select(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+//! Compute atan2(y, x) for four vectors.
+inline __m128 bondAngle(__m128 y, __m128 x)
+{
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 ax = _mm_andnot_ps(sign, x);
+    const __m128 ay = _mm_andnot_ps(sign, y);
+    const __m128 hi = _mm_max_ps(ax, ay);
+    // The mask zeros the NaNs of vectors of zero length.
+    __m128 t = _mm_and_ps(_mm_div_ps(_mm_min_ps(ax, ay), hi), _mm_cmpgt_ps(hi, _mm_setzero_ps()));
+    const __m128 reduce = _mm_cmpgt_ps(t, _mm_set1_ps(TAN_PI_8));
+    t = select(reduce, _mm_div_ps(_mm_sub_ps(t, one), _mm_add_ps(t, one)), t);
+    const __m128 z = _mm_mul_ps(t, t);
+    __m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ATAN_C3), z), _mm_set1_ps(ATAN_C2));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(ATAN_C1));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(ATAN_C0));
+    __m128 angle = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), t), t),
+                              _mm_and_ps(reduce, _mm_set1_ps(PI_4)));
+    angle = select(_mm_cmpgt_ps(ay, ax), _mm_sub_ps(_mm_set1_ps(PI_2), angle), angle);
+    const __m128 negative_x = _mm_castsi128_ps(_mm_srai_epi32(_mm_castps_si128(x), 31));
+    angle = select(negative_x, _mm_sub_ps(_mm_set1_ps(PI), angle), angle);
+    return _mm_or_ps(angle, _mm_and_ps(sign, y));
+}
+#endif
+
+//! Call a function on the linear index of every bin of a cell of a histogram.
+/*! \param lower First bin of the cell along each axis.
+ *  \param upper One past the last bin of the cell along each axis.
+ *  \param shape The shape of the histogram.
+ *  \param f A function with signature (size_t bin).
+ */
+template<typename BinFunction>
+void forEachBinInCell(const std::vector<size_t>& lower, const std::vector<size_t>& upper,
+                      const std::vector<size_t>& shape, const BinFunction& f)
+{
+    const size_t num_axes = shape.size();
+    std::vector<size_t> strides(num_axes);
+    size_t stride = 1;
+    for (size_t axis = num_axes; axis > 0; --axis)
+    {
+        strides[axis - 1] = stride;
+        stride *= shape[axis - 1];
+    }
+
+    std::vector<size_t> index(lower);
+    while (true)
+    {
+        size_t bin = 0;
+        for (size_t axis = 0; axis < num_axes; ++axis)
+        {
+            bin += index[axis] * strides[axis];
+        }
+        f(bin);
+
+        // Advance the multi-index with the last axis varying fastest.
+        size_t axis = num_axes;
+        while (axis > 0)
+        {
+            --axis;
+            if (++index[axis] < upper[axis])
+            {
+                break;
+            }
+            index[axis] = lower[axis];
+            if (axis == 0)
+            {
+                return;
+            }
+        }
+    }
+}
+
+}; // namespace
+
+void bondAngles(const float* x, const float* y, float* angles, size_t n)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(angles + i, bondAngle(_mm_loadu_ps(y + i), _mm_loadu_ps(x + i)));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        angles[i] = bondAngle(y[i], x[i]);
+    }
+}
+
+void PMFT::reduce()
+{
+    util::profiling::ScopedTimer timer("PMFT::reduce");
+    m_pcf_array.prepare(m_histogram.shape());
+    m_histogram.prepare(m_histogram.shape());
+
+    const float prefactor = getPCFPrefactor();
+
+    m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor](size_t i) {
+        m_pcf_array[i] = m_histogram[i] * prefactor * getInverseJacobian(i);
+    });
+}
+
+const util::ManagedArray<float>& PMFT::getAdaptivePCF(unsigned int min_count)
+{
+    // Reduce the bin counts if they are out of date.
+    reduceAndReturn(m_pcf_array);
+
+    const std::vector<size_t> shape = m_histogram.shape();
+    m_adaptive_pcf_array.prepare(shape);
+    refineAdaptivePCF(std::vector<size_t>(shape.size(), 0), shape, min_count, getPCFPrefactor());
+    return m_adaptive_pcf_array;
+}
+
+void PMFT::refineAdaptivePCF(const std::vector<size_t>& lower, const std::vector<size_t>& upper,
+                             unsigned int min_count, float prefactor)
+{
+    const std::vector<size_t> shape = m_histogram.shape();
+
+    // Count the bonds in the cell and sum the volumes of its bins.
+    size_t count = 0;
+    double volume = 0;
+    forEachBinInCell(lower, upper, shape, [this, &count, &volume](size_t bin) {
+        count += m_histogram[bin];
+        volume += 1.0 / getInverseJacobian(bin);
+    });
+
+    bool can_subdivide = false;
+    for (size_t axis = 0; axis < shape.size(); ++axis)
+    {
+        can_subdivide = can_subdivide || (upper[axis] - lower[axis] > 1);
+    }
+
+    if (!can_subdivide || count < min_count)
+    {
+        const float pcf = float(count / volume) * prefactor;
+        forEachBinInCell(lower, upper, shape, [this, pcf](size_t bin) { m_adaptive_pcf_array[bin] = pcf; });
+        return;
+    }
+
+    // Visit all children of the cell, halving every axis with more than one bin.
+    const size_t num_axes = shape.size();
+    std::vector<size_t> child_lower(lower), child_upper(upper);
+    for (unsigned int child = 0; child < (1u << num_axes); ++child)
+    {
+        bool valid_child = true;
+        for (size_t axis = 0; axis < num_axes; ++axis)
+        {
+            const size_t middle = (lower[axis] + upper[axis] + 1) / 2;
+            const bool upper_half = (child >> axis) & 1;
+            if (upper[axis] - lower[axis] > 1)
+            {
+                child_lower[axis] = upper_half ? middle : lower[axis];
+                child_upper[axis] = upper_half ? upper[axis] : middle;
+            }
+            else
+            {
+                // Axes of a single bin are not split, so only their lower child exists.
+                valid_child = valid_child && !upper_half;
+            }
+        }
+        if (valid_child)
+        {
+            refineAdaptivePCF(child_lower, child_upper, min_count, prefactor);
+        }
+    }
+}
+
+}; }; // end namespace freud::pmft
@@ -4,12 +4,16 @@
 #ifndef PMFT_H
 #define PMFT_H
 
+#include <cmath>
+#include <limits>
 #include <tbb/tbb.h>
+#include <vector>
 
 #include "BondHistogramCompute.h"
 #include "Box.h"
 #include "Histogram.h"
 #include "ManagedArray.h"
+#include "Trajectory.h"
 #include "VectorMath.h"
 
 /*! \internal
@@ -19,6 +23,50 @@
 
 namespace freud { namespace pmft {
 
+//! Compute the angles of a batch of two-dimensional vectors.
+/*! Each angle is atan2(y[i], x[i]), in [-pi, pi], with signed zeros treated
+ *  as by std::atan2. The arctangent is evaluated by a polynomial after
+ *  reducing its argument to [0, tan(pi/8)], which is accurate to a few units
+ *  in the last place, far below the width of any angular bin. Where SSE2 is
+ *  available, four angles are computed at once without branches.
+ *
+ *  \param x The x components of the vectors.
+ *  \param y The y components of the vectors.
+ *  \param angles Output array of the n angles.
+ *  \param n Number of vectors.
+ */
+void bondAngles(const float* x, const float* y, float* angles, size_t n);
+
+//! Wrap an angle into [0, 2*pi) without calls to std::fmod.
+inline float wrapAngle(float angle)
+{
+    float wrapped = angle - constants::TWO_PI * std::floor(angle * (1.0f / constants::TWO_PI));
+    // Rounding may leave the result just outside of the range.
+    wrapped = (wrapped < 0.0f) ? wrapped + constants::TWO_PI : wrapped;
+    return (wrapped >= constants::TWO_PI) ? wrapped - constants::TWO_PI : wrapped;
+}
+
+//! Check whether an approximate angle may fall in another bin than the exact angle.
+/*! Angles computed by bondAngles and wrapped by wrapAngle differ from those
+ *  computed by std::atan2 and util::modulusPositive by rounding errors of the
+ *  order of the float epsilon times the magnitude of the angles they are
+ *  computed from. Angles within a tolerance much larger than that of an edge
+ *  of the bins must be computed exactly to be binned identically.
+ *
+ *  \param angle An approximate angle in [0, 2*pi).
+ *  \param bin_scale The number of bins in [0, 2*pi) divided by 2*pi.
+ *  \param magnitude The largest magnitude of the angles the angle was computed from.
+ */
+inline bool nearAngularBinEdge(float angle, float bin_scale, float magnitude)
+{
+    const float tolerance = float(32.0) * std::numeric_limits<float>::epsilon()
+        * (magnitude + constants::TWO_PI) * bin_scale;
+    const float scaled = angle * bin_scale;
+    const float fraction = scaled - std::floor(scaled);
+    // The comparisons are false for NaNs, which are also computed exactly.
+    return !(fraction > tolerance && fraction < float(1.0) - tolerance);
+}
+
 //! Computes the PMFT for a given set of points
 /*! The PMFT class is an abstract class providing the basis for all classes calculating PMFTs for specific
  *  dimensional cases. The PMFT class defines some of the key interfaces required for all PMFT classes, such
@@ -41,6 +89,21 @@ public:
         return reduceAndReturn(m_pcf_array);
     }
 
+    //! Compute the PCF with a resolution adapted to the number of bonds in each region.
+    /*! The histogram is treated as the finest level of a binary space
+     *  partitioning tree (a quadtree or octree for two- or three-dimensional
+     *  histograms). Starting from the cell containing all bins, a cell is
+     *  subdivided by halving each of its axes while it contains at least
+     *  min_count bonds. The PCF of each resulting cell is the ratio of its
+     *  bond count to its volume, so sparsely populated regions are averaged
+     *  over larger cells while populated regions keep the full resolution.
+     *  The result has the same shape as getPCF, with every bin set to the
+     *  PCF of the cell containing it.
+     *
+     *  \param min_count Minimum number of bonds in a cell that is subdivided.
+     */
+    const util::ManagedArray<float>& getAdaptivePCF(unsigned int min_count);
+
 protected:
     //! Reduce the thread local histogram into the total pair correlation function.
     /*! The pair correlation function is computed by reducing the bin counts in
@@ -49,34 +112,44 @@ protected:
      * to the RDF except for the volume normalization. In the RDF, the volume
      * normalization is simply V_shell/V_total, but in the PFMT the
      * normalization depends on the volume element in the relevant coordinate
-     * system. This method accepts a function jf that returns the volume
-     * element corresponding to a given bin in the histogram.
+     * system. Subclasses implement getInverseJacobian, which returns the
+     * inverse of the volume element corresponding to a given bin in the
+     * histogram.
      *
      *  **IMPORTANT NOTE**: The inv_num_dens factor in the calculation in this
      *  function is just volume / Np, so it does not include volume elements in
      *  the orientational degrees of freedom. This means that the corresponding
-     *  normalization factors *should not* be applied to the Jacobian factor
-     *  argument. For instance, any full-dimensional PMFT in 2D must contain at
-     *  least one angular term, but that term should not contain a factor of
-     *  2*PI since that factor is effectively divided out of the volume here.
-     *
-     *  \param JacobFactor A function with one parameter (the histogram bin index) that returns the volume of the element in the histogram bin corresponding to the index.
+     *  normalization factors *should not* be applied to the Jacobian factor.
+     *  For instance, any full-dimensional PMFT in 2D must contain at least one
+     *  angular term, but that term should not contain a factor of 2*PI since
+     *  that factor is effectively divided out of the volume here.
      */
-    template<typename JacobFactor> void reduce(JacobFactor jf)
-    {
-        m_pcf_array.prepare(m_histogram.shape());
-        m_histogram.prepare(m_histogram.shape());
+    virtual void reduce();
+
+    //! Get the inverse of the volume element of a bin.
+    /*! \param bin The linear index of the bin in the histogram.
+     */
+    virtual float getInverseJacobian(size_t bin) const = 0;
 
+    //! Get the factor converting the bin counts divided by the volume element into the PCF.
+    float getPCFPrefactor() const
+    {
         float inv_num_dens = m_box.getVolume() / (float) m_n_query_points;
         float norm_factor = (float) 1.0 / ((float) m_frame_counter * (float) m_n_points);
-        float prefactor = inv_num_dens * norm_factor;
-
-        m_histogram.reduceOverThreadsPerBin(m_local_histograms, [this, &prefactor, &jf](size_t i) {
-            m_pcf_array[i] = m_histogram[i] * prefactor * jf(i);
-        });
+        return inv_num_dens * norm_factor;
     }
 
-    util::ManagedArray<float> m_pcf_array; //!< Array of computed pair correlation function.
+    //! Set the adaptive PCF in a cell, subdividing it if it contains enough bonds.
+    /*! \param lower First bin of the cell along each axis.
+     *  \param upper One past the last bin of the cell along each axis.
+     *  \param min_count Minimum number of bonds in a cell that is subdivided.
+     *  \param prefactor The result of getPCFPrefactor.
+     */
+    void refineAdaptivePCF(const std::vector<size_t>& lower, const std::vector<size_t>& upper,
+                           unsigned int min_count, float prefactor);
+
+    util::ManagedArray<float> m_pcf_array;          //!< Array of computed pair correlation function.
+    util::ManagedArray<float> m_adaptive_pcf_array; //!< Array of the last computed adaptive PCF.
 };
 
 }; }; // end namespace freud::pmft
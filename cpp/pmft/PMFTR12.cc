@@ -12,6 +12,88 @@
 
 namespace freud { namespace pmft {
 
+namespace {
+
+//! Accumulates the bonds of one block of work into the PMFTR12 histogram.
+/*! The bonds are buffered as a structure of arrays, with the orientations of
+ *  both points. When the buffer is full, the angles of all buffered bonds
+ *  are computed by bondAngles and their coordinates are binned. The angle of
+ *  the bond seen from the query point is the angle of the bond plus pi, so
+ *  only one angle is computed for each bond. Bonds whose approximate angles
+ *  are close to a bin edge are binned from angles computed by std::atan2, so
+ *  that the bin counts are identical to those of the exact computation.
+ */
+class PMFTR12Block
+{
+public:
+    //! Number of bonds whose angles are computed together.
+    static const unsigned int BOND_BUFFER_SIZE = 64;
+
+    PMFTR12Block(util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms,
+                 const float* orientations, const float* query_orientations, unsigned int n_t1,
+                 unsigned int n_t2)
+        : m_block(local_histograms), m_orientations(orientations), m_query_orientations(query_orientations),
+          m_t1_scale(float(n_t1) / constants::TWO_PI), m_t2_scale(float(n_t2) / constants::TWO_PI),
+          m_num_bonds(0)
+    {}
+
+    void operator()(const locality::NeighborBond& neighbor_bond)
+    {
+        m_x[m_num_bonds] = neighbor_bond.vector.x;
+        m_y[m_num_bonds] = neighbor_bond.vector.y;
+        m_distances[m_num_bonds] = neighbor_bond.distance;
+        m_point_orientations[m_num_bonds] = m_orientations[neighbor_bond.point_idx];
+        m_query_point_orientations[m_num_bonds] = m_query_orientations[neighbor_bond.query_point_idx];
+        if (++m_num_bonds == BOND_BUFFER_SIZE)
+        {
+            flushBonds();
+        }
+    }
+
+    void finish()
+    {
+        flushBonds();
+        m_block.finish();
+    }
+
+private:
+    //! Compute the angles of the buffered bonds and bin them.
+    void flushBonds()
+    {
+        float angles[BOND_BUFFER_SIZE];
+        bondAngles(m_x, m_y, angles, m_num_bonds);
+        for (unsigned int i = 0; i < m_num_bonds; ++i)
+        {
+            float t1 = wrapAngle(m_point_orientations[i] - angles[i]);
+            float t2 = wrapAngle(m_query_point_orientations[i] - angles[i] - 0.5f * constants::TWO_PI);
+            if (nearAngularBinEdge(t1, m_t1_scale, std::fabs(m_point_orientations[i]))
+                || nearAngularBinEdge(t2, m_t2_scale, std::fabs(m_query_point_orientations[i])))
+            {
+                t1 = util::modulusPositive(m_point_orientations[i] - std::atan2(m_y[i], m_x[i]),
+                                           constants::TWO_PI);
+                t2 = util::modulusPositive(m_query_point_orientations[i] - std::atan2(-m_y[i], -m_x[i]),
+                                           constants::TWO_PI);
+            }
+            m_block.buffer(m_distances[i], t1, t2);
+        }
+        m_num_bonds = 0;
+    }
+
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_block; //!< Privatized bin counts.
+    const float* m_orientations;                        //!< Orientations of the points.
+    const float* m_query_orientations;                  //!< Orientations of the query points.
+    float m_t1_scale;                                   //!< Number of bins in T1 divided by 2*pi.
+    float m_t2_scale;                                   //!< Number of bins in T2 divided by 2*pi.
+    float m_x[BOND_BUFFER_SIZE];                        //!< x components of the buffered bonds.
+    float m_y[BOND_BUFFER_SIZE];                        //!< y components of the buffered bonds.
+    float m_distances[BOND_BUFFER_SIZE];                //!< Lengths of the buffered bonds.
+    float m_point_orientations[BOND_BUFFER_SIZE];       //!< Orientations of the points of the bonds.
+    float m_query_point_orientations[BOND_BUFFER_SIZE]; //!< Orientations of the query points of the bonds.
+    unsigned int m_num_bonds;                           //!< Number of buffered bonds.
+};
+
+}; // end anonymous namespace
+
 PMFTR12::PMFTR12(float r_max, unsigned int n_r, unsigned int n_t1, unsigned int n_t2) : PMFT()
 {
     if (n_r < 1)
@@ -62,29 +144,28 @@ PMFTR12::PMFTR12(float r_max, unsigned int n_r, unsigned int n_t1, unsigned int
     m_pcf_array.prepare({n_r, n_t1, n_t2});
 }
 
-void PMFTR12::reduce()
+void PMFTR12::accumulate(const locality::NeighborQuery* neighbor_query, const float* orientations,
+                         const vec3<float>* query_points, const float* query_orientations,
+                         unsigned int n_p, const locality::NeighborList* nlist,
+                         freud::locality::QueryArgs qargs)
 {
-    PMFT::reduce([this](size_t i) { return m_inv_jacobian_array[i]; });
+    neighbor_query->getBox().enforce2D();
+    accumulateBlocks(neighbor_query, query_points, n_p, nlist, qargs, [=]() {
+        return PMFTR12Block(m_local_histograms, orientations, query_orientations, getAxisSizes()[1],
+                            getAxisSizes()[2]);
+    });
 }
 
-void PMFTR12::accumulate(const locality::NeighborQuery* neighbor_query, float* orientations,
-                         vec3<float>* query_points, float* query_orientations, unsigned int n_p,
-                         const locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+void PMFTR12::accumulateTrajectory(const locality::Trajectory& trajectory, const float* orientations,
+                                  freud::locality::QueryArgs qargs, bool parallel_frames)
 {
-    neighbor_query->getBox().enforce2D();
-    accumulateGeneral(neighbor_query, query_points, n_p, nlist, qargs,
-                      [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
-                          // calculate angles
-                          float d_theta1 = std::atan2(delta.y, delta.x);
-                          float d_theta2 = std::atan2(-delta.y, -delta.x);
-                          float t1 = orientations[neighbor_bond.point_idx] - d_theta1;
-                          float t2 = query_orientations[neighbor_bond.query_point_idx] - d_theta2;
-                          // make sure that t1, t2 are bounded between 0 and 2PI
-                          t1 = util::modulusPositive(t1, constants::TWO_PI);
-                          t2 = util::modulusPositive(t2, constants::TWO_PI);
-                          m_local_histograms(neighbor_bond.distance, t1, t2);
-                      });
+    const unsigned int n_points = trajectory.getNPoints();
+    accumulateFrames(trajectory, parallel_frames,
+                     [&](const locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                         const float* frame_orientations = orientations + size_t(frame) * n_points;
+                         accumulate(neighbor_query, frame_orientations, trajectory.getPoints(frame),
+                                    frame_orientations, n_points, nullptr, qargs);
+                     });
 }
 
 }; }; // end namespace freud::pmft
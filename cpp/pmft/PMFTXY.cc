@@ -42,20 +42,14 @@ PMFTXY::PMFTXY(float x_max, float y_max, unsigned int n_x, unsigned int n_y) : P
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
 }
 
-void PMFTXY::reduce()
-{
-    float jacobian_factor = (float) 1.0 / m_jacobian;
-    PMFT::reduce([jacobian_factor](size_t i) { return jacobian_factor; });
-}
-
-void PMFTXY::accumulate(const locality::NeighborQuery* neighbor_query, float* query_orientations,
-                        vec3<float>* query_points, unsigned int n_query_points,
+void PMFTXY::accumulate(const locality::NeighborQuery* neighbor_query, const float* query_orientations,
+                        const vec3<float>* query_points, unsigned int n_query_points,
                         const locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
 {
     neighbor_query->getBox().enforce2D();
     accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
                       [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
+                          vec3<float> delta(neighbor_bond.vector);
 
                           // rotate interparticle vector
                           vec2<float> myVec(delta.x, delta.y);
@@ -63,8 +57,19 @@ void PMFTXY::accumulate(const locality::NeighborQuery* neighbor_query, float* qu
                               = rotmat2<float>::fromAngle(-query_orientations[neighbor_bond.query_point_idx]);
                           vec2<float> rotVec = myMat * myVec;
 
-                          m_local_histograms(rotVec.x, rotVec.y);
+                          m_local_histograms.buffer(rotVec.x, rotVec.y);
                       });
 }
 
+void PMFTXY::accumulateTrajectory(const locality::Trajectory& trajectory, const float* query_orientations,
+                                  freud::locality::QueryArgs qargs, bool parallel_frames)
+{
+    const unsigned int n_points = trajectory.getNPoints();
+    accumulateFrames(trajectory, parallel_frames,
+                     [&](const locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                         accumulate(neighbor_query, query_orientations + size_t(frame) * n_points,
+                                    trajectory.getPoints(frame), n_points, nullptr, qargs);
+                     });
+}
+
 }; }; // end namespace freud::pmft
@@ -1,6 +1,7 @@
 // Copyright (c) 2010-2020 The Regents of the University of Michigan
 // This file is from the freud project, released under the BSD 3-Clause License.
 
+#include <limits>
 #include <stdexcept>
 
 #include "PMFTXYT.h"
@@ -12,6 +13,91 @@
 
 namespace freud { namespace pmft {
 
+namespace {
+
+//! Accumulates the bonds of one block of work into the PMFTXYT histogram.
+/*! The rotation into the frame of the query point is computed once for each
+ *  query point rather than for each bond. The rotated bonds are buffered as
+ *  a structure of arrays, and when the buffer is full the angles of all
+ *  buffered bonds are computed by bondAngles and their coordinates are
+ *  binned. Bonds whose approximate angles are close to a bin edge are
+ *  binned from angles computed by std::atan2, so that the bin counts are
+ *  identical to those of the exact computation.
+ */
+class PMFTXYTBlock
+{
+public:
+    //! Number of bonds whose angles are computed together.
+    static const unsigned int BOND_BUFFER_SIZE = 64;
+
+    PMFTXYTBlock(util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms,
+                 const float* orientations, const float* query_orientations, unsigned int n_t)
+        : m_block(local_histograms), m_orientations(orientations), m_query_orientations(query_orientations),
+          m_t_scale(float(n_t) / constants::TWO_PI),
+          m_query_point_idx(std::numeric_limits<unsigned int>::max()), m_num_bonds(0)
+    {}
+
+    void operator()(const locality::NeighborBond& neighbor_bond)
+    {
+        if (neighbor_bond.query_point_idx != m_query_point_idx)
+        {
+            m_query_point_idx = neighbor_bond.query_point_idx;
+            m_rotation = rotmat2<float>::fromAngle(-m_query_orientations[m_query_point_idx]);
+        }
+        const vec2<float> rotated = m_rotation * vec2<float>(neighbor_bond.vector.x, neighbor_bond.vector.y);
+        m_rotated_x[m_num_bonds] = rotated.x;
+        m_rotated_y[m_num_bonds] = rotated.y;
+        // The angle is of the bond seen from the point.
+        m_x[m_num_bonds] = -neighbor_bond.vector.x;
+        m_y[m_num_bonds] = -neighbor_bond.vector.y;
+        m_point_orientations[m_num_bonds] = m_orientations[neighbor_bond.point_idx];
+        if (++m_num_bonds == BOND_BUFFER_SIZE)
+        {
+            flushBonds();
+        }
+    }
+
+    void finish()
+    {
+        flushBonds();
+        m_block.finish();
+    }
+
+private:
+    //! Compute the angles of the buffered bonds and bin them.
+    void flushBonds()
+    {
+        float angles[BOND_BUFFER_SIZE];
+        bondAngles(m_x, m_y, angles, m_num_bonds);
+        for (unsigned int i = 0; i < m_num_bonds; ++i)
+        {
+            float t = wrapAngle(m_point_orientations[i] - angles[i]);
+            if (nearAngularBinEdge(t, m_t_scale, std::fabs(m_point_orientations[i])))
+            {
+                t = util::modulusPositive(m_point_orientations[i] - std::atan2(m_y[i], m_x[i]),
+                                          constants::TWO_PI);
+            }
+            m_block.buffer(m_rotated_x[i], m_rotated_y[i], t);
+        }
+        m_num_bonds = 0;
+    }
+
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_block; //!< Privatized bin counts.
+    const float* m_orientations;                  //!< Orientations of the points.
+    const float* m_query_orientations;            //!< Orientations of the query points.
+    float m_t_scale;                              //!< Number of bins in T divided by 2*pi.
+    unsigned int m_query_point_idx;               //!< Query point of the current rotation.
+    rotmat2<float> m_rotation;                    //!< Rotation into the frame of the query point.
+    float m_rotated_x[BOND_BUFFER_SIZE];          //!< Rotated x components of the buffered bonds.
+    float m_rotated_y[BOND_BUFFER_SIZE];          //!< Rotated y components of the buffered bonds.
+    float m_x[BOND_BUFFER_SIZE];                  //!< x components of the reversed buffered bonds.
+    float m_y[BOND_BUFFER_SIZE];                  //!< y components of the reversed buffered bonds.
+    float m_point_orientations[BOND_BUFFER_SIZE]; //!< Orientations of the points of the bonds.
+    unsigned int m_num_bonds;                     //!< Number of buffered bonds.
+};
+
+}; // end anonymous namespace
+
 PMFTXYT::PMFTXYT(float x_max, float y_max, unsigned int n_x, unsigned int n_y, unsigned int n_t) : PMFT()
 {
     if (n_x < 1)
@@ -47,32 +133,27 @@ PMFTXYT::PMFTXYT(float x_max, float y_max, unsigned int n_x, unsigned int n_y, u
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
 }
 
-void PMFTXYT::reduce()
+void PMFTXYT::accumulate(const locality::NeighborQuery* neighbor_query, const float* orientations,
+                         const vec3<float>* query_points, const float* query_orientations,
+                         unsigned int n_query_points, const locality::NeighborList* nlist,
+                         freud::locality::QueryArgs qargs)
 {
-    float jacobian_factor = (float) 1.0 / m_jacobian;
-    PMFT::reduce([jacobian_factor](size_t i) { return jacobian_factor; });
+    neighbor_query->getBox().enforce2D();
+    accumulateBlocks(neighbor_query, query_points, n_query_points, nlist, qargs, [=]() {
+        return PMFTXYTBlock(m_local_histograms, orientations, query_orientations, getAxisSizes()[2]);
+    });
 }
 
-void PMFTXYT::accumulate(const locality::NeighborQuery* neighbor_query, float* orientations,
-                         vec3<float>* query_points, float* query_orientations, unsigned int n_query_points,
-                         const locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
+void PMFTXYT::accumulateTrajectory(const locality::Trajectory& trajectory, const float* orientations,
+                                  freud::locality::QueryArgs qargs, bool parallel_frames)
 {
-    neighbor_query->getBox().enforce2D();
-    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
-                      [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
-
-                          // rotate interparticle vector
-                          vec2<float> myVec(delta.x, delta.y);
-                          rotmat2<float> myMat
-                              = rotmat2<float>::fromAngle(-query_orientations[neighbor_bond.query_point_idx]);
-                          vec2<float> rotVec = myMat * myVec;
-                          // calculate angle
-                          float d_theta = std::atan2(-delta.y, -delta.x);
-                          float t = orientations[neighbor_bond.point_idx] - d_theta;
-                          // make sure that t is bounded between 0 and 2PI
-                          t = util::modulusPositive(t, constants::TWO_PI);
-                          m_local_histograms(rotVec.x, rotVec.y, t);
-                      });
+    const unsigned int n_points = trajectory.getNPoints();
+    accumulateFrames(trajectory, parallel_frames,
+                     [&](const locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                         const float* frame_orientations = orientations + size_t(frame) * n_points;
+                         accumulate(neighbor_query, frame_orientations, trajectory.getPoints(frame),
+                                    frame_orientations, n_points, nullptr, qargs);
+                     });
 }
+
 }; }; // end namespace freud::pmft
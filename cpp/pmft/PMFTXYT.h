@@ -21,14 +21,33 @@ public:
     /*! Compute the PCF for the passed in set of points. The function will be added to previous values
         of the PCF
     */
-    void accumulate(const locality::NeighborQuery* neighbor_query, float* orientations,
-                    vec3<float>* query_points, float* query_orientations, unsigned int n_query_points,
-                    const locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
+    void accumulate(const locality::NeighborQuery* neighbor_query, const float* orientations,
+                    const vec3<float>* query_points, const float* query_orientations,
+                    unsigned int n_query_points, const locality::NeighborList* nlist,
+                    freud::locality::QueryArgs qargs);
+
+    //! Accumulate all frames of a trajectory, using the points of each frame as query points.
+    /*! \param trajectory The frames of points.
+     *  \param orientations Angles of the points, of shape (n_frames, n_points).
+     *  \param qargs Query arguments.
+     *  \param parallel_frames Whether to accumulate frames concurrently, see
+     *         BondHistogramCompute::accumulateFrames.
+     */
+    void accumulateTrajectory(const locality::Trajectory& trajectory, const float* orientations,
+                              freud::locality::QueryArgs qargs, bool parallel_frames = false);
+
+    //! Return the name identifying PMFTXYTs in serialized states.
+    virtual std::string getStateName() const
+    {
+        return "PMFTXYT";
+    }
 
 protected:
-    //! \internal
-    //! helper function to reduce the thread specific arrays into one array
-    virtual void reduce();
+    //! Get the inverse of the volume element of a bin, see PMFT::reduce.
+    virtual float getInverseJacobian(size_t bin) const
+    {
+        return float(1.0) / m_jacobian;
+    }
 
     float m_jacobian;
 };
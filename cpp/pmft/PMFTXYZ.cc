@@ -2,7 +2,9 @@
 // This file is from the freud project, released under the BSD 3-Clause License.
 
 #include "PMFTXYZ.h"
+#include <limits>
 #include <stdexcept>
+#include <vector>
 
 /*! \file PMFTXYZ.cc
     \brief Routines for computing 3D potential of mean force in XYZ coordinates
@@ -61,36 +63,181 @@ PMFTXYZ::PMFTXYZ(float x_max, float y_max, float z_max, unsigned int n_x, unsign
     m_local_histograms = BondHistogram::ThreadLocalHistogram(m_histogram);
 }
 
-void PMFTXYZ::reduce()
+//! Accumulates the bonds of one block of work into the PMFTXYZ histogram.
+/*! For each query point, the rotations into the frame of the query point
+ *  and then by each equivalent orientation are combined into one matrix per
+ *  equivalent orientation. Consecutive bonds of the same query point are
+ *  buffered as a structure of arrays, and each combined rotation is applied
+ *  to the whole buffer in a loop that the compiler can vectorize.
+ */
+class PMFTXYZBlock
 {
-    float jacobian_factor = (float) 1.0 / m_jacobian;
-    PMFT::reduce([jacobian_factor](size_t i) { return jacobian_factor; });
-}
+public:
+    //! Number of bonds of a query point that are rotated together.
+    static const unsigned int BOND_BUFFER_SIZE = 64;
+
+    PMFTXYZBlock(util::Histogram<unsigned int>::ThreadLocalHistogram& local_histograms,
+                 const quat<float>* query_orientations, const std::vector<rotmat3<float>>& equiv_rotations)
+        : m_block(local_histograms), m_query_orientations(query_orientations),
+          m_equiv_rotations(equiv_rotations), m_rotations(equiv_rotations.size()),
+          m_query_point_idx(std::numeric_limits<unsigned int>::max()), m_num_bonds(0)
+    {}
+
+    void operator()(const locality::NeighborBond& neighbor_bond)
+    {
+        if (neighbor_bond.query_point_idx != m_query_point_idx)
+        {
+            flushBonds();
+            m_query_point_idx = neighbor_bond.query_point_idx;
+            const rotmat3<float> to_query_frame(conj(m_query_orientations[m_query_point_idx]));
+            for (size_t k = 0; k < m_rotations.size(); ++k)
+            {
+                m_rotations[k] = m_equiv_rotations[k] * to_query_frame;
+            }
+        }
+        m_x[m_num_bonds] = neighbor_bond.vector.x;
+        m_y[m_num_bonds] = neighbor_bond.vector.y;
+        m_z[m_num_bonds] = neighbor_bond.vector.z;
+        if (++m_num_bonds == BOND_BUFFER_SIZE)
+        {
+            flushBonds();
+        }
+    }
+
+    void finish()
+    {
+        flushBonds();
+        m_block.finish();
+    }
 
-void PMFTXYZ::accumulate(const locality::NeighborQuery* neighbor_query, quat<float>* query_orientations,
-                         vec3<float>* query_points, unsigned int n_query_points,
-                         quat<float>* equiv_orientations, unsigned int num_equiv_orientations,
+private:
+    //! Rotate the buffered bonds by every combined rotation and bin them.
+    void flushBonds()
+    {
+        for (const rotmat3<float>& r : m_rotations)
+        {
+            float rotated_x[BOND_BUFFER_SIZE], rotated_y[BOND_BUFFER_SIZE], rotated_z[BOND_BUFFER_SIZE];
+            for (unsigned int i = 0; i < m_num_bonds; ++i)
+            {
+                rotated_x[i] = r.row0.x * m_x[i] + r.row0.y * m_y[i] + r.row0.z * m_z[i];
+                rotated_y[i] = r.row1.x * m_x[i] + r.row1.y * m_y[i] + r.row1.z * m_z[i];
+                rotated_z[i] = r.row2.x * m_x[i] + r.row2.y * m_y[i] + r.row2.z * m_z[i];
+            }
+            for (unsigned int i = 0; i < m_num_bonds; ++i)
+            {
+                m_block.buffer(rotated_x[i], rotated_y[i], rotated_z[i]);
+            }
+        }
+        m_num_bonds = 0;
+    }
+
+    util::Histogram<unsigned int>::ThreadLocalHistogram::LocalBlock m_block; //!< Privatized bin counts.
+    const quat<float>* m_query_orientations;            //!< Orientations of the query points.
+    const std::vector<rotmat3<float>>& m_equiv_rotations; //!< Rotations of the equivalent orientations.
+    std::vector<rotmat3<float>> m_rotations; //!< Combined rotations for the current query point.
+    unsigned int m_query_point_idx;          //!< Query point of the buffered bonds.
+    unsigned int m_num_bonds;                //!< Number of buffered bonds.
+    float m_x[BOND_BUFFER_SIZE];             //!< x components of the buffered bond vectors.
+    float m_y[BOND_BUFFER_SIZE];             //!< y components of the buffered bond vectors.
+    float m_z[BOND_BUFFER_SIZE];             //!< z components of the buffered bond vectors.
+};
+
+void PMFTXYZ::accumulate(const locality::NeighborQuery* neighbor_query, const quat<float>* query_orientations,
+                         const vec3<float>* query_points, unsigned int n_query_points,
+                         const quat<float>* equiv_orientations, unsigned int num_equiv_orientations,
                          const locality::NeighborList* nlist, freud::locality::QueryArgs qargs)
 {
     neighbor_query->getBox().enforce3D();
-    accumulateGeneral(neighbor_query, query_points, n_query_points, nlist, qargs,
-                      [=](const freud::locality::NeighborBond& neighbor_bond) {
-                          // create the reference point quaternion
-                          quat<float> ref_q(query_orientations[neighbor_bond.query_point_idx]);
-                          // make sure that the particles are wrapped into the box
-                          vec3<float> delta(bondVector(neighbor_bond, neighbor_query, query_points));
-
-                          for (unsigned int k = 0; k < num_equiv_orientations; k++)
-                          {
-                              // create point vector
-                              vec3<float> v(delta);
-                              // rotate the vector
-                              v = rotate(conj(ref_q), v);
-                              v = rotate(equiv_orientations[k], v);
-
-                              m_local_histograms(v.x, v.y, v.z);
-                          }
-                      });
+
+    std::vector<rotmat3<float>> equiv_rotations;
+    equiv_rotations.reserve(num_equiv_orientations);
+    for (unsigned int k = 0; k < num_equiv_orientations; k++)
+    {
+        equiv_rotations.push_back(rotmat3<float>(equiv_orientations[k]));
+    }
+
+    accumulateBlocks(neighbor_query, query_points, n_query_points, nlist, qargs,
+                     [this, query_orientations, &equiv_rotations]() {
+                         return PMFTXYZBlock(m_local_histograms, query_orientations, equiv_rotations);
+                     });
+}
+
+void PMFTXYZ::accumulateTrajectory(const locality::Trajectory& trajectory,
+                                   const quat<float>* query_orientations,
+                                   const quat<float>* equiv_orientations,
+                                   unsigned int num_equiv_orientations, freud::locality::QueryArgs qargs,
+                                   bool parallel_frames)
+{
+    const unsigned int n_points = trajectory.getNPoints();
+    accumulateFrames(trajectory, parallel_frames,
+                     [&](const locality::NeighborQuery* neighbor_query, unsigned int frame) {
+                         // Each frame has its own shifted points, since frames may be
+                         // accumulated concurrently.
+                         const vec3<float>* points = trajectory.getPoints(frame);
+                         std::vector<vec3<float>> shifted_points(n_points);
+                         for (unsigned int i = 0; i < n_points; ++i)
+                         {
+                             shifted_points[i] = points[i] - m_shiftvec;
+                         }
+                         accumulate(neighbor_query, query_orientations + size_t(frame) * n_points,
+                                    shifted_points.data(), n_points, equiv_orientations,
+                                    num_equiv_orientations, nullptr, qargs);
+                     });
+}
+
+void PMFTXYZ::accumulateBond(const locality::NeighborBond& neighbor_bond,
+                             const quat<float>* query_orientations, const quat<float>* equiv_orientations,
+                             unsigned int num_equiv_orientations)
+{
+    // create the reference point quaternion
+    quat<float> ref_q(query_orientations[neighbor_bond.query_point_idx]);
+    vec3<float> delta(neighbor_bond.vector);
+
+    for (unsigned int k = 0; k < num_equiv_orientations; k++)
+    {
+        // create point vector
+        vec3<float> v(delta);
+        // rotate the vector
+        v = rotate(conj(ref_q), v);
+        v = rotate(equiv_orientations[k], v);
+
+        m_local_histograms.buffer(v.x, v.y, v.z);
+    }
+}
+
+PMFTXYZPipelineStage::PMFTXYZPipelineStage(PMFTXYZ* pmft, const quat<float>* query_orientations,
+                                           const quat<float>* equiv_orientations,
+                                           unsigned int num_equiv_orientations)
+    : m_pmft(pmft), m_query_orientations(query_orientations), m_equiv_orientations(equiv_orientations),
+      m_num_equiv_orientations(num_equiv_orientations), m_r_max(0)
+{
+    // Any bond that can fall into the histogram is shorter than the distance
+    // to a corner of the histogram.
+    for (const auto& bound : m_pmft->getBounds())
+    {
+        m_r_max += bound.second * bound.second;
+    }
+    m_r_max = std::sqrt(m_r_max);
+}
+
+void PMFTXYZPipelineStage::begin(const locality::NeighborQuery* neighbor_query,
+                                 const vec3<float>* query_points, unsigned int n_query_points)
+{
+    neighbor_query->getBox().enforce3D();
+    m_pmft->startFrame(neighbor_query, n_query_points);
+}
+
+void PMFTXYZPipelineStage::visitPoint(size_t query_point_idx, locality::NeighborPerPointIterator& ppiter)
+{
+    for (locality::NeighborBond nb = ppiter.next(); !ppiter.end(); nb = ppiter.next())
+    {
+        m_pmft->accumulateBond(nb, m_query_orientations, m_equiv_orientations, m_num_equiv_orientations);
+    }
+}
+
+void PMFTXYZPipelineStage::end()
+{
+    m_pmft->finishFrame();
 }
 
 }; }; // end namespace freud::pmft
@@ -4,6 +4,7 @@
 #ifndef PMFTXYZ_H
 #define PMFTXYZ_H
 
+#include "NeighborPipeline.h"
 #include "PMFT.h"
 
 /*! \file PMFTXYZ.h
@@ -22,20 +23,78 @@ public:
     /*! Compute the PCF for the passed in set of points. The function will be added to previous values
         of the pcf
     */
-    void accumulate(const locality::NeighborQuery* neighbor_query, quat<float>* query_orientations,
-                    vec3<float>* query_points, unsigned int n_query_points, quat<float>* equiv_orientations,
-                    unsigned int num_equiv_orientations, const locality::NeighborList* nlist,
-                    freud::locality::QueryArgs qargs);
+    void accumulate(const locality::NeighborQuery* neighbor_query, const quat<float>* query_orientations,
+                    const vec3<float>* query_points, unsigned int n_query_points,
+                    const quat<float>* equiv_orientations, unsigned int num_equiv_orientations,
+                    const locality::NeighborList* nlist, freud::locality::QueryArgs qargs);
+
+    //! Accumulate all frames of a trajectory, using the points of each frame as query points.
+    /*! The query points are shifted by the shift vector, as in the Python compute.
+     *  \param trajectory The frames of points.
+     *  \param query_orientations Orientations of the points, of shape (n_frames, n_points).
+     *  \param equiv_orientations Orientations treated as equivalent.
+     *  \param num_equiv_orientations Number of equivalent orientations.
+     *  \param qargs Query arguments.
+     *  \param parallel_frames Whether to accumulate frames concurrently, see
+     *         BondHistogramCompute::accumulateFrames.
+     */
+    void accumulateTrajectory(const locality::Trajectory& trajectory, const quat<float>* query_orientations,
+                              const quat<float>* equiv_orientations, unsigned int num_equiv_orientations,
+                              freud::locality::QueryArgs qargs, bool parallel_frames = false);
+
+    //! Add a single bond to the histogram.
+    void accumulateBond(const locality::NeighborBond& neighbor_bond, const quat<float>* query_orientations,
+                        const quat<float>* equiv_orientations, unsigned int num_equiv_orientations);
+
+    //! Return the name identifying PMFTXYZs in serialized states.
+    virtual std::string getStateName() const
+    {
+        return "PMFTXYZ";
+    }
 
 protected:
-    //! \internal
-    //! helper function to reduce the thread specific arrays into one array
-    virtual void reduce();
+    //! Get the inverse of the volume element of a bin, see PMFT::reduce.
+    virtual float getInverseJacobian(size_t bin) const
+    {
+        return float(1.0) / m_jacobian;
+    }
 
     float m_jacobian;
     vec3<float> m_shiftvec; //!< vector that points from [0,0,0] to the origin of the pmft
 };
 
+//! Adapter running a PMFTXYZ as a stage of a NeighborPipeline.
+/*! Each traversal accumulates one frame. The orientation arrays must stay
+ *  valid while the pipeline is computed. The query points are used without
+ *  applying the PMFT's shift vector.
+ */
+class PMFTXYZPipelineStage : public locality::NeighborPipelineStage
+{
+public:
+    //! Constructor
+    PMFTXYZPipelineStage(PMFTXYZ* pmft, const quat<float>* query_orientations,
+                         const quat<float>* equiv_orientations, unsigned int num_equiv_orientations);
+
+    virtual float getRMax() const
+    {
+        return m_r_max;
+    }
+
+    virtual void begin(const locality::NeighborQuery* neighbor_query, const vec3<float>* query_points,
+                       unsigned int n_query_points);
+
+    virtual void visitPoint(size_t query_point_idx, locality::NeighborPerPointIterator& ppiter);
+
+    virtual void end();
+
+private:
+    PMFTXYZ* m_pmft;                         //!< The PMFT accumulating the bonds.
+    const quat<float>* m_query_orientations; //!< Orientations of the query points.
+    const quat<float>* m_equiv_orientations; //!< Orientations treated as equivalent.
+    unsigned int m_num_equiv_orientations;   //!< Number of equivalent orientations.
+    float m_r_max;                           //!< Longest bond that can fall into the histogram.
+};
+
 }; }; // end namespace freud::pmft
 
 #endif // PMFTXYZ_H
@@ -0,0 +1,169 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef ARRAY_REDUCTION_H
+#define ARRAY_REDUCTION_H
+
+#include <algorithm>
+#include <complex>
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/task_arena.h>
+#include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "utils.h"
+
+/*! \file ArrayReduction.h
+    \brief Sum the thread local copies of an array into one array.
+*/
+
+namespace freud { namespace util {
+
+//! Number of bytes of the tiles of a blocked reduction.
+/*! A tile of the result stays in the L1 cache while the same tile of every
+ *  source is added to it, and each source tile is read contiguously.
+ */
+const size_t REDUCTION_TILE_BYTES = 8192;
+
+//! Minimum number of sources for which arrays with too few tiles are reduced with a tree.
+const size_t TREE_REDUCTION_MIN_SOURCES = 8;
+
+//! Add n elements of src to dst elementwise.
+template<typename T> inline void addArray(T* dst, const T* src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        dst[i] += src[i];
+    }
+}
+
+#ifdef __SSE2__
+template<> inline void addArray<float>(float* dst, const float* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+    }
+    for (; i < n; ++i)
+    {
+        dst[i] += src[i];
+    }
+}
+
+template<> inline void addArray<double>(double* dst, const double* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    }
+    for (; i < n; ++i)
+    {
+        dst[i] += src[i];
+    }
+}
+
+template<> inline void addArray<unsigned int>(unsigned int* dst, const unsigned int* src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128i* dst_v = reinterpret_cast<__m128i*>(dst + i);
+        const __m128i* src_v = reinterpret_cast<const __m128i*>(src + i);
+        _mm_storeu_si128(dst_v, _mm_add_epi32(_mm_loadu_si128(dst_v), _mm_loadu_si128(src_v)));
+    }
+    for (; i < n; ++i)
+    {
+        dst[i] += src[i];
+    }
+}
+#endif
+
+// std::complex is layout compatible with an array of its two components.
+template<> inline void addArray<std::complex<float>>(std::complex<float>* dst, const std::complex<float>* src,
+                                                     size_t n)
+{
+    addArray(reinterpret_cast<float*>(dst), reinterpret_cast<const float*>(src), 2 * n);
+}
+
+template<> inline void addArray<std::complex<double>>(std::complex<double>* dst,
+                                                      const std::complex<double>* src, size_t n)
+{
+    addArray(reinterpret_cast<double*>(dst), reinterpret_cast<const double*>(src), 2 * n);
+}
+
+//! Add the elementwise sum of arrays to a result array.
+/*! Adding every source to each element in turn strides across all sources
+ *  at every element. Instead, the result is split into tiles of
+ *  REDUCTION_TILE_BYTES, reduced in parallel, and the tile of each source is
+ *  added to the tile of the result in turn with SIMD additions.
+ *
+ *  Arrays with fewer tiles than threads leave most threads idle. If there
+ *  are at least TREE_REDUCTION_MIN_SOURCES sources, such arrays are instead
+ *  reduced with a parallel tree: groups of sources are summed into
+ *  temporary arrays, which are summed pairwise.
+ *
+ *  \param sources Pointers to the source arrays, each of size elements.
+ *  \param result Array of size elements that the sum is added to.
+ *  \param size Number of elements of each array.
+ */
+template<typename T> void reduceArrays(const std::vector<const T*>& sources, T* result, size_t size)
+{
+    if (sources.empty() || size == 0)
+    {
+        return;
+    }
+
+    const size_t tile_size = std::max(REDUCTION_TILE_BYTES / sizeof(T), size_t(1));
+    const size_t num_tiles = (size + tile_size - 1) / tile_size;
+    const size_t num_threads = tbb::this_task_arena::max_concurrency();
+    if (num_tiles < num_threads && sources.size() >= TREE_REDUCTION_MIN_SOURCES)
+    {
+        const std::vector<T> sum = tbb::parallel_reduce(
+            tbb::blocked_range<size_t>(0, sources.size()), std::vector<T>(),
+            [&sources, size](const tbb::blocked_range<size_t>& r, std::vector<T> partial) {
+                if (partial.empty())
+                {
+                    partial.assign(size, T(0));
+                }
+                for (size_t s = r.begin(); s != r.end(); ++s)
+                {
+                    addArray(partial.data(), sources[s], size);
+                }
+                return partial;
+            },
+            [size](std::vector<T> left, const std::vector<T>& right) {
+                if (left.empty())
+                {
+                    return right;
+                }
+                if (!right.empty())
+                {
+                    addArray(left.data(), right.data(), size);
+                }
+                return left;
+            });
+        addArray(result, sum.data(), size);
+        return;
+    }
+
+    forLoopWrapper(0, num_tiles, [&sources, result, size, tile_size](size_t begin, size_t end) {
+        for (size_t tile = begin; tile != end; ++tile)
+        {
+            const size_t offset = tile * tile_size;
+            const size_t n = std::min(tile_size, size - offset);
+            for (const T* source : sources)
+            {
+                addArray(result + offset, source + offset, n);
+            }
+        }
+    });
+}
+
+}; }; // end namespace freud::util
+
+#endif // ARRAY_REDUCTION_H
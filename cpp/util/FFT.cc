@@ -0,0 +1,167 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "FFT.h"
+#include "utils.h"
+
+/*! \file FFT.cc
+    \brief Discrete Fourier transforms of sequences and grids of any size.
+*/
+
+namespace freud { namespace util {
+
+namespace {
+
+//! Forward radix-2 transform of n values in place, n a power of two.
+void radix2(std::complex<double>* data, size_t n, const std::vector<std::complex<double>>& twiddles)
+{
+    // Reorder the values by bit-reversed index.
+    for (size_t i = 1, j = 0; i < n; ++i)
+    {
+        size_t bit = n >> 1;
+        for (; (j & bit) != 0; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            std::swap(data[i], data[j]);
+        }
+    }
+
+    for (size_t length = 2; length <= n; length <<= 1)
+    {
+        const size_t half = length / 2;
+        const size_t step = n / length;
+        for (size_t start = 0; start < n; start += length)
+        {
+            for (size_t k = 0; k < half; ++k)
+            {
+                const std::complex<double> t = twiddles[k * step] * data[start + k + half];
+                data[start + k + half] = data[start + k] - t;
+                data[start + k] += t;
+            }
+        }
+    }
+}
+
+//! Inverse radix-2 transform of n values in place, including the factor 1/n.
+void inverseRadix2(std::complex<double>* data, size_t n, const std::vector<std::complex<double>>& twiddles)
+{
+    for (size_t i = 0; i < n; ++i)
+    {
+        data[i] = std::conj(data[i]);
+    }
+    radix2(data, n, twiddles);
+    const double scale = 1.0 / double(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        data[i] = std::conj(data[i]) * scale;
+    }
+}
+
+}; // namespace
+
+FFT::FFT(size_t n) : m_n(n), m_padded_n(1), m_bluestein(false)
+{
+    if (n == 0)
+    {
+        throw std::invalid_argument("FFT requires a positive length.");
+    }
+
+    m_bluestein = (n & (n - 1)) != 0;
+    // Bluestein's algorithm expresses the transform as a circular
+    // convolution, which needs at least 2n - 1 values to avoid aliasing.
+    const size_t min_padded_n = m_bluestein ? 2 * n - 1 : n;
+    while (m_padded_n < min_padded_n)
+    {
+        m_padded_n <<= 1;
+    }
+
+    m_twiddles.resize(m_padded_n / 2);
+    for (size_t k = 0; k < m_twiddles.size(); ++k)
+    {
+        m_twiddles[k] = std::polar(1.0, -2 * M_PI * double(k) / double(m_padded_n));
+    }
+
+    if (m_bluestein)
+    {
+        // The chirp angle is periodic in k^2 with period 2n, which keeps the
+        // argument small for long sequences.
+        m_chirp.resize(n);
+        for (size_t k = 0; k < n; ++k)
+        {
+            const size_t k_sq = (k * k) % (2 * n);
+            m_chirp[k] = std::polar(1.0, -M_PI * double(k_sq) / double(n));
+        }
+
+        m_chirp_fft.assign(m_padded_n, std::complex<double>(0));
+        m_chirp_fft[0] = std::conj(m_chirp[0]);
+        for (size_t k = 1; k < n; ++k)
+        {
+            m_chirp_fft[k] = std::conj(m_chirp[k]);
+            m_chirp_fft[m_padded_n - k] = std::conj(m_chirp[k]);
+        }
+        radix2(m_chirp_fft.data(), m_padded_n, m_twiddles);
+    }
+}
+
+void FFT::transformWork(std::complex<double>* work, bool inverse) const
+{
+    // The inverse transform is the conjugate of the forward transform of the
+    // conjugated values, divided by n.
+    if (inverse)
+    {
+        for (size_t i = 0; i < m_n; ++i)
+        {
+            work[i] = std::conj(work[i]);
+        }
+    }
+
+    if (!m_bluestein)
+    {
+        radix2(work, m_n, m_twiddles);
+    }
+    else
+    {
+        for (size_t i = 0; i < m_n; ++i)
+        {
+            work[i] *= m_chirp[i];
+        }
+        for (size_t i = m_n; i < m_padded_n; ++i)
+        {
+            work[i] = 0;
+        }
+        radix2(work, m_padded_n, m_twiddles);
+        for (size_t i = 0; i < m_padded_n; ++i)
+        {
+            work[i] *= m_chirp_fft[i];
+        }
+        inverseRadix2(work, m_padded_n, m_twiddles);
+        for (size_t i = 0; i < m_n; ++i)
+        {
+            work[i] *= m_chirp[i];
+        }
+    }
+
+    if (inverse)
+    {
+        const double scale = 1.0 / double(m_n);
+        for (size_t i = 0; i < m_n; ++i)
+        {
+            work[i] = std::conj(work[i]) * scale;
+        }
+    }
+}
+
+void transformGrid(std::complex<float>* data, const vec3<unsigned int>& shape, bool inverse)
+{
+    GridFFT(shape).transform(data, inverse);
+}
+
+}; }; // end namespace freud::util
@@ -0,0 +1,159 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <tbb/enumerable_thread_specific.h>
+#include <vector>
+
+#include "VectorMath.h"
+#include "utils.h"
+
+/*! \file FFT.h
+    \brief Discrete Fourier transforms of sequences and grids of any size.
+*/
+
+namespace freud { namespace util {
+
+//! Computes discrete Fourier transforms of complex sequences of a fixed length.
+/*! Lengths that are powers of two use an iterative radix-2 transform, and
+ *  all other lengths are mapped to a power of two transform with Bluestein's
+ *  algorithm, so every length costs O(n log n). Transforms are evaluated in
+ *  double precision regardless of the type of the data.
+ *
+ *  The forward transform is \f$ X_k = \sum_j x_j e^{-2 \pi i j k / n} \f$ and
+ *  the inverse transform includes the factor \f$1/n\f$, so that applying both
+ *  returns the original data. An instance only holds precomputed tables and
+ *  may be shared by many threads, each passing its own work buffer.
+ */
+class FFT
+{
+public:
+    //! Default constructor
+    FFT() : FFT(1) {}
+
+    //! Constructor
+    /*! \param n Length of the transformed sequences.
+     */
+    explicit FFT(size_t n);
+
+    //! Get the length of the transformed sequences
+    size_t size() const
+    {
+        return m_n;
+    }
+
+    //! Transform a sequence in place.
+    /*! \param data First value of the sequence.
+     *  \param stride Distance between consecutive values of the sequence.
+     *  \param inverse Whether to compute the inverse transform.
+     *  \param work Buffer reused across calls, resized as needed.
+     */
+    template<typename T>
+    void transform(std::complex<T>* data, size_t stride, bool inverse,
+                   std::vector<std::complex<double>>& work) const
+    {
+        work.resize(m_bluestein ? m_padded_n : m_n);
+        for (size_t i = 0; i < m_n; ++i)
+        {
+            work[i] = std::complex<double>(data[i * stride]);
+        }
+        transformWork(work.data(), inverse);
+        for (size_t i = 0; i < m_n; ++i)
+        {
+            data[i * stride] = std::complex<T>(work[i]);
+        }
+    }
+
+private:
+    //! Transform the first m_n values of a work buffer in place.
+    void transformWork(std::complex<double>* work, bool inverse) const;
+
+    size_t m_n;                                    //!< Length of the transformed sequences.
+    size_t m_padded_n;                             //!< Length of the radix-2 transform.
+    bool m_bluestein;                              //!< Whether m_n is not a power of two.
+    std::vector<std::complex<double>> m_twiddles;  //!< Roots of unity of the radix-2 transform.
+    std::vector<std::complex<double>> m_chirp;     //!< Bluestein chirp exp(-pi i k^2 / m_n).
+    std::vector<std::complex<double>> m_chirp_fft; //!< Transform of the padded conjugate chirp.
+};
+
+//! Computes discrete Fourier transforms of row-major grids of a fixed shape.
+/*! The transforms of each axis and the per-thread work buffers are kept
+ *  between calls, so an instance should be reused for many grids of the same
+ *  shape. Lines of the grid along each axis are transformed in parallel.
+ */
+class GridFFT
+{
+public:
+    //! Default constructor
+    GridFFT() : GridFFT(vec3<unsigned int>(1, 1, 1)) {}
+
+    //! Constructor
+    /*! \param shape The number of grid points along each axis.
+     */
+    explicit GridFFT(const vec3<unsigned int>& shape)
+        : m_shape(shape), m_ffts{FFT(shape.x), FFT(shape.y), FFT(shape.z)}
+    {}
+
+    //! Get the shape of the transformed grids
+    const vec3<unsigned int>& getShape() const
+    {
+        return m_shape;
+    }
+
+    //! Transform a grid in place along all axes longer than one.
+    /*! \param data The shape.x * shape.y * shape.z values of the grid, with
+     *         the value of (i, j, k) at index (i * shape.y + j) * shape.z + k.
+     *  \param inverse Whether to compute the inverse transform.
+     */
+    template<typename T> void transform(std::complex<T>* data, bool inverse)
+    {
+        const size_t lengths[3] = {m_shape.x, m_shape.y, m_shape.z};
+        const size_t strides[3] = {size_t(m_shape.y) * m_shape.z, m_shape.z, 1};
+
+        for (unsigned int axis = 0; axis < 3; ++axis)
+        {
+            if (lengths[axis] < 2)
+            {
+                continue;
+            }
+
+            // Lines along the axis are indexed by the two other grid indices,
+            // with the index of the faster varying axis changing fastest.
+            const unsigned int outer_axis = (axis == 0) ? 1 : 0;
+            const unsigned int inner_axis = (axis == 2) ? 1 : 2;
+            const size_t n_lines = lengths[outer_axis] * lengths[inner_axis];
+            const FFT& fft = m_ffts[axis];
+
+            util::forLoopWrapper(0, n_lines, [&](size_t begin, size_t end) {
+                std::vector<std::complex<double>>& work = m_local_work.local();
+                for (size_t line = begin; line < end; ++line)
+                {
+                    const size_t outer = line / lengths[inner_axis];
+                    const size_t inner = line % lengths[inner_axis];
+                    fft.transform(data + outer * strides[outer_axis] + inner * strides[inner_axis],
+                                  strides[axis], inverse, work);
+                }
+            });
+        }
+    }
+
+private:
+    vec3<unsigned int> m_shape; //!< The number of grid points along each axis.
+    FFT m_ffts[3];              //!< Transform of each axis.
+    tbb::enumerable_thread_specific<std::vector<std::complex<double>>> m_local_work; //!< Work buffers.
+};
+
+//! Transform a row-major grid in place along all axes longer than one.
+/*! \param data The shape.x * shape.y * shape.z values of the grid, with the
+ *         value of (i, j, k) at index (i * shape.y + j) * shape.z + k.
+ *  \param shape The number of grid points along each axis.
+ *  \param inverse Whether to compute the inverse transform.
+ */
+void transformGrid(std::complex<float>* data, const vec3<unsigned int>& shape, bool inverse);
+
+}; }; // end namespace freud::util
+
+#endif // FFT_H
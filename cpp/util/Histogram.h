@@ -1,6 +1,7 @@
 #ifndef HISTOGRAM_H
 #define HISTOGRAM_H
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 #ifdef __SSE2__
@@ -11,6 +12,8 @@
 #include <utility>
 
 #include "ManagedArray.h"
+#include "ParallelAccumulator.h"
+#include "Profiling.h"
 #include "utils.h"
 
 namespace freud { namespace util {
@@ -163,6 +166,12 @@ public:
             return bin;
     }
 
+    //! Return the inverse of the bin width.
+    float getInverseBinWidth() const
+    {
+        return m_inverse_bin_width;
+    }
+
 protected:
     float m_bin_width;          //!< Bin width
     float m_inverse_bin_width;  //!< Inverse of bin width
@@ -181,108 +190,45 @@ protected:
 template<typename T> class Histogram
 {
 public:
-    //! A container for thread-local copies of a provided histogram.
-    /*! This container implements the simplest method of enabling parallel-safe
-     * accumulation, namely the creation of separate instances on each thread.
-     * Thread local histograms can be accumulated later using the
-     * reduceOverThreads functions in the Histogram class.
-     *
-     * To simplify the implementation and avoid unnecessary copies, the thread
-     * local copies all share the same axes (because the axes are stored as
-     * arrays of shared_ptrs in the Histogram class). This should cause no
-     * problems, but can be refactored if needed.
-     */
-    class ThreadLocalHistogram
-    {
-    public:
-        ThreadLocalHistogram() {}
-
-        ThreadLocalHistogram(Histogram histogram)
-            : m_local_histograms([histogram]() { return Histogram(histogram.m_axes); })
-        {}
-
-        typedef typename tbb::enumerable_thread_specific<Histogram>::const_iterator const_iterator;
-        typedef typename tbb::enumerable_thread_specific<Histogram>::iterator iterator;
-        typedef typename tbb::enumerable_thread_specific<Histogram>::reference reference;
-
-        const_iterator begin() const
-        {
-            return m_local_histograms.begin();
-        }
-
-        iterator begin()
-        {
-            return m_local_histograms.begin();
-        }
-
-        const_iterator end() const
-        {
-            return m_local_histograms.end();
-        }
-
-        iterator end()
-        {
-            return m_local_histograms.end();
-        }
-
-        reference local()
-        {
-            return m_local_histograms.local();
-        }
-
-        void reset()
-        {
-            for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
-            {
-                hist->reset();
-            }
-        }
-
-        //! Dispatch to thread local histogram.
-        template<typename... FloatsOrWeight> void operator()(FloatsOrWeight... values)
-        {
-            m_local_histograms.local()(values...);
-        }
-
-        //! Dispatch to thread local histogram.
-        void increment(size_t value_bin, T weight = 1)
-        {
-            m_local_histograms.local().increment(value_bin, weight);
-        }
-
-        // Reduce over histograms into the result array.
-        void reduceInto(ManagedArray<T>& result)
-        {
-            result.reset();
-            util::forLoopWrapper(0, result.size(), [=, &result](size_t begin, size_t end) {
-                for (size_t i = begin; i < end; ++i)
-                {
-                    for (auto hist = m_local_histograms.begin(); hist != m_local_histograms.end(); ++hist)
-                    {
-                        result[i] += hist->m_bin_counts[i];
-                    }
-                }
-            });
-        }
-
-    protected:
-        tbb::enumerable_thread_specific<Histogram<T>>
-            m_local_histograms; //!< The thread-local copies of m_histogram.
-    };
+    //! Parallel-safe accumulation of values into a copy of a histogram.
+    class ThreadLocalHistogram;
 
     typedef std::vector<std::shared_ptr<Axis>> Axes;
     typedef Axes::const_iterator AxisIterator;
 
     //! Default constructor
-    Histogram() {}
+    Histogram() : m_all_regular(false) {}
 
     //! Constructor
-    Histogram(std::vector<std::shared_ptr<Axis>> axes) : m_axes(axes)
+    Histogram(std::vector<std::shared_ptr<Axis>> axes) : m_axes(axes), m_all_regular(true)
     {
         std::vector<size_t> sizes;
         for (AxisIterator it = m_axes.begin(); it != m_axes.end(); it++)
             sizes.push_back((*it)->size());
         m_bin_counts = ManagedArray<T>(sizes);
+
+        // Cache the parameters of regular axes so that batches of values
+        // can be binned without virtual calls.
+        m_axis_strides.resize(m_axes.size());
+        size_t stride = 1;
+        for (int ax_idx = static_cast<int>(m_axes.size()) - 1; ax_idx >= 0; --ax_idx)
+        {
+            m_axis_strides[ax_idx] = stride;
+            stride *= m_axes[ax_idx]->size();
+        }
+        for (AxisIterator it = m_axes.begin(); it != m_axes.end(); it++)
+        {
+            const RegularAxis* regular_axis = dynamic_cast<const RegularAxis*>(it->get());
+            if (regular_axis == nullptr)
+            {
+                m_all_regular = false;
+                break;
+            }
+            m_axis_mins.push_back(regular_axis->getMin());
+            m_axis_maxs.push_back(regular_axis->getMax());
+            m_axis_inverse_bin_widths.push_back(regular_axis->getInverseBinWidth());
+            m_axis_last_bins.push_back(static_cast<int>(regular_axis->size()) - 1);
+        }
     }
 
     //! Simple convenience for 1D arrays that calls through to the shape based `prepare` function.
@@ -358,6 +304,56 @@ public:
         return m_bin_counts.getIndex(ax_bins);
     }
 
+    //! Find the bins of a batch of values.
+    /*! When all axes are instances of RegularAxis, histograms of up to three
+     *  dimensions are binned by a loop specialized on the number of
+     *  dimensions, which avoids virtual calls and contains no branches so that
+     *  it can be vectorized by the compiler.
+     *
+     *  \param values Array of n * D values, where D is the number of axes,
+     *         with the D values of each point stored contiguously.
+     *  \param n Number of points to bin.
+     *  \param bins Output array of n linear bin indices, set to
+     *         Axis::OVERFLOW_BIN for points outside the histogram.
+     */
+    void bin(const float* values, size_t n, size_t* bins) const
+    {
+        if (m_all_regular)
+        {
+            switch (m_axes.size())
+            {
+            case 1:
+                binRegular<1>(values, n, bins);
+                return;
+            case 2:
+                binRegular<2>(values, n, bins);
+                return;
+            case 3:
+                binRegular<3>(values, n, bins);
+                return;
+            default:
+                break;
+            }
+        }
+
+        const size_t num_axes = m_axes.size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t index = 0;
+            for (size_t ax_idx = 0; ax_idx < num_axes; ++ax_idx)
+            {
+                const size_t bin_i = m_axes[ax_idx]->bin(values[i * num_axes + ax_idx]);
+                if (bin_i == Axis::OVERFLOW_BIN)
+                {
+                    index = Axis::OVERFLOW_BIN;
+                    break;
+                }
+                index += bin_i * m_axis_strides[ax_idx];
+            }
+            bins[i] = index;
+        }
+    }
+
     //! Get the computed histogram.
     const ManagedArray<T>& getBinCounts() const
     {
@@ -435,6 +431,7 @@ public:
     template<typename ComputeFunction>
     void reduceOverThreadsPerBin(ThreadLocalHistogram& local_histograms, const ComputeFunction& cf)
     {
+        profiling::ScopedTimer timer("Histogram::reduceOverThreadsPerBin");
         local_histograms.reduceInto(m_bin_counts);
         util::forLoopWrapper(0, m_bin_counts.size(), [=](size_t begin, size_t end) {
             for (size_t i = begin; i < end; ++i)
@@ -480,6 +477,47 @@ protected:
     std::vector<std::shared_ptr<Axis>> m_axes; //!< The axes.
     ManagedArray<T> m_bin_counts;              //!< Counts for each bin
 
+    bool m_all_regular;                           //!< Whether all axes are instances of RegularAxis.
+    std::vector<size_t> m_axis_strides;           //!< Stride of each axis in the linear bin index.
+    std::vector<float> m_axis_mins;               //!< Lower bound of each regular axis.
+    std::vector<float> m_axis_maxs;               //!< Upper bound of each regular axis.
+    std::vector<float> m_axis_inverse_bin_widths; //!< Inverse bin width of each regular axis.
+    std::vector<int> m_axis_last_bins;            //!< Index of the last bin of each regular axis.
+
+    //! Bin a batch of values on D regular axes (see the public bin function).
+    template<unsigned int D> void binRegular(const float* values, size_t n, size_t* bins) const
+    {
+        float mins[D], maxs[D], inverse_bin_widths[D];
+        int last_bins[D];
+        size_t strides[D];
+        for (unsigned int d = 0; d < D; ++d)
+        {
+            mins[d] = m_axis_mins[d];
+            maxs[d] = m_axis_maxs[d];
+            inverse_bin_widths[d] = m_axis_inverse_bin_widths[d];
+            last_bins[d] = m_axis_last_bins[d];
+            strides[d] = m_axis_strides[d];
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            bool in_range = true;
+            size_t index = 0;
+            for (unsigned int d = 0; d < D; ++d)
+            {
+                const float value = values[i * D + d];
+                const bool axis_in_range = (value >= mins[d]) & (value < maxs[d]);
+                // Out of range values are scaled to zero so the truncation is always defined.
+                const float scaled = axis_in_range ? (value - mins[d]) * inverse_bin_widths[d] : float(0);
+                // Avoid rounding leading to overflow.
+                const int axis_bin = std::min(static_cast<int>(scaled), last_bins[d]);
+                index += static_cast<size_t>(axis_bin) * strides[d];
+                in_range &= axis_in_range;
+            }
+            bins[i] = in_range ? index : Axis::OVERFLOW_BIN;
+        }
+    }
+
     //! The base case for type float when constructing a vector of values provided to operator().
     /*! This function and the accompanying recursive function below employ
      * variadic templating to accept an arbitrary set of float values and
@@ -519,6 +557,250 @@ protected:
     }
 };
 
+//! A container for parallel-safe accumulation into a provided histogram.
+/*! Values are binned with the axes of the provided histogram and accumulated
+ * with a ParallelAccumulator, which by default keeps a separate copy of the
+ * bin counts on each thread. Large histograms may select an accumulation
+ * strategy that does not copy the bin counts per thread. The accumulated
+ * counts can be reduced later using the reduceOverThreads functions in the
+ * Histogram class.
+ *
+ * Unweighted values may also be buffered on each thread and binned in
+ * batches of BUFFER_SIZE, which is substantially faster than binning them
+ * one at a time. Buffered values are only counted after a call to flush.
+ * Parallel loops over blocks of work can instead accumulate through a
+ * LocalBlock, which avoids looking up thread-local storage for every value.
+ */
+template<typename T> class Histogram<T>::ThreadLocalHistogram
+{
+public:
+    //! Privatized accumulation for one block of work on a single thread.
+    class LocalBlock;
+
+    ThreadLocalHistogram() {}
+
+    //! Number of buffered values per thread that are binned together.
+    static const size_t BUFFER_SIZE = 256;
+
+    //! Number of sub-histograms per thread used by a LocalBlock.
+    static const unsigned int NUM_SUB_HISTOGRAMS = 4;
+
+    //! Largest number of bins for which a LocalBlock uses sub-histograms.
+    static const size_t MAX_PRIVATIZED_BINS = 4096;
+
+    ThreadLocalHistogram(Histogram histogram, AccumulationStrategy strategy = accumulate_auto)
+        : m_histogram(histogram), m_accumulator(histogram.size(), strategy)
+    {
+        const size_t num_axes = histogram.m_axes.size();
+        m_buffers = tbb::enumerable_thread_specific<ValueBuffer>(
+            [num_axes]() { return ValueBuffer(num_axes); });
+    }
+
+    //! Get the accumulation strategy in use.
+    AccumulationStrategy getStrategy() const
+    {
+        return m_accumulator.getStrategy();
+    }
+
+    void reset()
+    {
+        m_accumulator.reset();
+        for (auto buffer = m_buffers.begin(); buffer != m_buffers.end(); ++buffer)
+        {
+            buffer->num_values = 0;
+            std::fill(buffer->sub_counts.begin(), buffer->sub_counts.end(), T(0));
+        }
+    }
+
+    //! Bin values and increment the bin (with a weight if one is provided).
+    template<typename... FloatsOrWeight> void operator()(FloatsOrWeight... values)
+    {
+        std::pair<std::vector<float>, Weight<T>> value_vector = m_histogram.getValueVector(values...);
+        increment(m_histogram.bin(value_vector.first), value_vector.second.value);
+    }
+
+    //! Increment specified linear bin (with a specified weight if desired).
+    void increment(size_t value_bin, T weight = 1)
+    {
+        // Check for sentinel to avoid overflow.
+        if (value_bin != Axis::OVERFLOW_BIN)
+        {
+            m_accumulator.add(value_bin, weight);
+        }
+    }
+
+    //! Buffer values to be binned with a count of one in the next batch of this thread.
+    /*! \param values One value for each axis of the histogram.
+     */
+    template<typename... Floats> void buffer(Floats... values)
+    {
+        ValueBuffer& buffer = m_buffers.local();
+        const float value_array[] = {static_cast<float>(values)...};
+        std::copy(value_array, value_array + sizeof...(Floats),
+                  buffer.values.begin() + buffer.num_values * sizeof...(Floats));
+        if (++buffer.num_values == BUFFER_SIZE)
+        {
+            flushBuffer(buffer);
+        }
+    }
+
+    //! Bin and count the buffered values of all threads.
+    /*! This must be called after the parallel loop that buffers values and
+     *  before the histogram is reduced.
+     */
+    void flush()
+    {
+        for (auto buffer = m_buffers.begin(); buffer != m_buffers.end(); ++buffer)
+        {
+            flushBuffer(*buffer);
+        }
+    }
+
+    //! Add an array of size() counts to the counts of this thread, such as the counts of another histogram.
+    void add(const T* counts)
+    {
+        m_accumulator.add(counts);
+    }
+
+    // Reduce over histograms into the result array.
+    void reduceInto(ManagedArray<T>& result)
+    {
+        m_accumulator.reduceInto(result);
+    }
+
+    //! Get the number of bins.
+    size_t size() const
+    {
+        return m_accumulator.size();
+    }
+
+protected:
+    //! Values buffered on a thread and storage for their bins.
+    struct ValueBuffer
+    {
+        ValueBuffer() : ValueBuffer(0) {}
+
+        explicit ValueBuffer(size_t num_axes)
+            : values(BUFFER_SIZE * num_axes), bins(BUFFER_SIZE), num_values(0)
+        {}
+
+        std::vector<float> values; //!< Buffered values, with the values of each point contiguous.
+        std::vector<size_t> bins;  //!< Linear bins of the buffered values.
+        size_t num_values;         //!< Number of buffered points.
+        std::vector<T> sub_counts; //!< Sub-histograms of a LocalBlock, allocated on first use.
+    };
+
+    //! Bin and count the values in a buffer and empty it.
+    void flushBuffer(ValueBuffer& buffer)
+    {
+        m_histogram.bin(buffer.values.data(), buffer.num_values, buffer.bins.data());
+        m_accumulator.add(buffer.bins.data(), buffer.num_values, T(1));
+        buffer.num_values = 0;
+    }
+
+    Histogram m_histogram;                                  //!< The histogram whose axes bin values.
+    ParallelAccumulator<T> m_accumulator;                   //!< The accumulated bin counts.
+    tbb::enumerable_thread_specific<ValueBuffer> m_buffers; //!< Buffered values on each thread.
+};
+
+//! Privatized accumulation into a ThreadLocalHistogram for one block of work.
+/*! A LocalBlock looks up the thread-local storage of its histogram once, when
+ *  it is constructed, so it must only be used by the thread that created it,
+ *  typically for one range of a parallel loop. For histograms with at most
+ *  MAX_PRIVATIZED_BINS bins, consecutive increments are distributed over
+ *  NUM_SUB_HISTOGRAMS sub-histograms so that repeated increments of the same
+ *  bin do not depend on each other. The sub-histograms are merged into the
+ *  histogram by finish, which must be called at the end of the block.
+ */
+template<typename T> class Histogram<T>::ThreadLocalHistogram::LocalBlock
+{
+public:
+    //! Constructor
+    /*! \param histogram The histogram to accumulate into.
+     */
+    explicit LocalBlock(ThreadLocalHistogram& histogram)
+        : m_histogram(&histogram), m_buffer(&histogram.m_buffers.local()), m_num_bins(histogram.size()),
+          m_privatized(m_num_bins <= MAX_PRIVATIZED_BINS), m_next_sub_histogram(0)
+    {
+        if (m_privatized && m_buffer->sub_counts.empty())
+        {
+            m_buffer->sub_counts.resize(NUM_SUB_HISTOGRAMS * m_num_bins, T(0));
+        }
+    }
+
+    //! Increment specified linear bin (with a specified weight if desired).
+    void increment(size_t value_bin, T weight = 1)
+    {
+        // Check for sentinel to avoid overflow.
+        if (value_bin == Axis::OVERFLOW_BIN)
+        {
+            return;
+        }
+        if (m_privatized)
+        {
+            const unsigned int sub_histogram = m_next_sub_histogram++ % NUM_SUB_HISTOGRAMS;
+            m_buffer->sub_counts[sub_histogram * m_num_bins + value_bin] += weight;
+        }
+        else
+        {
+            m_histogram->m_accumulator.add(value_bin, weight);
+        }
+    }
+
+    //! Buffer values to be binned with a count of one in the next batch.
+    /*! \param values One value for each axis of the histogram.
+     */
+    template<typename... Floats> void buffer(Floats... values)
+    {
+        const float value_array[] = {static_cast<float>(values)...};
+        std::copy(value_array, value_array + sizeof...(Floats),
+                  m_buffer->values.begin() + m_buffer->num_values * sizeof...(Floats));
+        if (++m_buffer->num_values == BUFFER_SIZE)
+        {
+            flushBuffer();
+        }
+    }
+
+    //! Count the buffered values and merge the sub-histograms into the histogram.
+    void finish()
+    {
+        flushBuffer();
+        if (m_privatized)
+        {
+            std::vector<T>& sub_counts = m_buffer->sub_counts;
+            for (unsigned int sub_histogram = 1; sub_histogram < NUM_SUB_HISTOGRAMS; ++sub_histogram)
+            {
+                T* counts = sub_counts.data() + sub_histogram * m_num_bins;
+                for (size_t i = 0; i < m_num_bins; ++i)
+                {
+                    sub_counts[i] += counts[i];
+                    counts[i] = T(0);
+                }
+            }
+            m_histogram->m_accumulator.add(sub_counts.data());
+            std::fill(sub_counts.begin(), sub_counts.begin() + m_num_bins, T(0));
+        }
+    }
+
+private:
+    //! Bin and count the buffered values.
+    void flushBuffer()
+    {
+        m_histogram->m_histogram.bin(m_buffer->values.data(), m_buffer->num_values, m_buffer->bins.data());
+        for (size_t i = 0; i < m_buffer->num_values; ++i)
+        {
+            increment(m_buffer->bins[i]);
+        }
+        m_buffer->num_values = 0;
+    }
+
+    ThreadLocalHistogram* m_histogram; //!< The histogram accumulated into.
+    ValueBuffer* m_buffer;             //!< The storage of the thread of this block.
+    size_t m_num_bins;                 //!< Number of bins of the histogram.
+    bool m_privatized;                 //!< Whether increments go to sub-histograms.
+    unsigned int m_next_sub_histogram; //!< Counter distributing increments over sub-histograms.
+};
+
 }; }; // namespace freud::util
 
 #endif
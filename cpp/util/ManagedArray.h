@@ -1,10 +1,18 @@
 #ifndef MANAGED_ARRAY_H
 #define MANAGED_ARRAY_H
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <new>
 #include <sstream>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 /*! \file ManagedArray.h
     \brief Defines the standard array class to be used throughout freud.
@@ -32,6 +40,11 @@ namespace freud { namespace util {
  *  the original array alive if the original ManagedArray instances become
  *  decoupled from it.
  *
+ *  Instead of allocating its own data, an array can also be given a buffer
+ *  owned by the caller with setBuffer, such as the memory of a NumPy array
+ *  provided by a Python user. Computes then write their results directly into
+ *  that buffer on every call to prepare, which never reallocates it.
+ *
  *  Performance notes:
  *      1. The variadic indexers may be a bottleneck if used in
  *         performance-critical code paths. In such cases, directly calling the
@@ -39,6 +52,9 @@ namespace freud { namespace util {
  *      2. In situations where multiple identically shaped arrays are being
  *         indexed into, the index may be computed once using the getIndex
  *         function and reused to avoid recomputing it each time.
+ *      3. On Linux, arrays of at least LARGE_ARRAY_BYTES are aligned to huge
+ *         pages and the kernel is advised to back them with transparent huge
+ *         pages, which reduces TLB misses on large grids.
  */
 template<typename T> class ManagedArray
 {
@@ -49,7 +65,7 @@ public:
      *
      *  \param shape Shape of the array to allocate.
      */
-    ManagedArray(std::vector<size_t> shape = {0})
+    ManagedArray(std::vector<size_t> shape = {0}) : m_external(false)
     {
         prepare(shape, true);
     }
@@ -84,22 +100,113 @@ public:
      */
     void prepare(std::vector<size_t> new_shape, bool force = false)
     {
-        // If we resized, or if there are outstanding references, we create a new array. No matter what,
-        // reset.
+        prepareForOverwrite(new_shape, force);
+        reset();
+    }
+
+    //! Prepare for writing new data that will overwrite every element.
+    /*! This function is the same as prepare, except that the data is not
+     *  reset, which avoids zeroing arrays a compute fills completely.
+     *
+     *  \param new_shape Shape of the array to allocate.
+     *  \param force Reallocate regardless of whether anything changed or needs to be persisted.
+     */
+    void prepareForOverwrite(std::vector<size_t> new_shape, bool force = false)
+    {
+        // Caller-owned buffers are always written in place.
+        if (m_external)
+        {
+            if (new_shape != shape())
+            {
+                std::ostringstream msg;
+                msg << "The output buffer has shape (";
+                for (size_t i = 0; i < shape().size(); ++i)
+                {
+                    msg << (i == 0 ? "" : ", ") << shape()[i];
+                }
+                msg << "), but an array of shape (";
+                for (size_t i = 0; i < new_shape.size(); ++i)
+                {
+                    msg << (i == 0 ? "" : ", ") << new_shape[i];
+                }
+                msg << ") is required." << std::endl;
+                throw std::invalid_argument(msg.str());
+            }
+            return;
+        }
+
+        // If we resized, or if there are outstanding references, we create a new array.
         if (force || (m_data.use_count() > 1) || (new_shape != shape()))
         {
             m_shape = std::make_shared<std::vector<size_t>>(new_shape);
+            m_size = std::make_shared<size_t>(computeSize(new_shape));
+            m_data = std::make_shared<std::shared_ptr<T>>(allocate(size()));
+        }
+    }
 
-            m_size = std::make_shared<size_t>(1);
-            for (int i = m_shape->size() - 1; i >= 0; --i)
-            {
-                (*m_size) *= (*m_shape)[i];
-            }
+    //! Shrink a 1D array to its first new_size elements.
+    /*! The data is kept in place, without reallocating or copying, unless
+     *  other ManagedArrays refer to it (such as NumPy arrays exported to
+     *  Python). In that case, as in prepare, the elements are copied into a new
+     *  array so that the other references are unaffected.
+     *
+     *  \param new_size Number of elements to keep, at most the current size.
+     */
+    void shrink(size_t new_size)
+    {
+        if (m_shape->size() != 1 || new_size > size())
+        {
+            throw std::invalid_argument("Only 1D arrays can be shrunk, to at most their current size.");
+        }
+        if (m_data.use_count() > 1 && !m_external)
+        {
+            std::shared_ptr<T> data = allocate(new_size);
+            std::copy(get(), get() + new_size, data.get());
+            m_data = std::make_shared<std::shared_ptr<T>>(data);
+            m_shape = std::make_shared<std::vector<size_t>>(std::vector<size_t> {new_size});
+            m_size = std::make_shared<size_t>(new_size);
+        }
+        else
+        {
+            *m_shape = std::vector<size_t> {new_size};
+            *m_size = new_size;
+        }
+    }
 
-            m_data = std::shared_ptr<std::shared_ptr<T>>(
-                new std::shared_ptr<T>(new T[size()], std::default_delete<T[]>()));
+    //! Use a caller-owned buffer as the data of this array.
+    /*! Subsequent calls to prepare with the same shape reset and reuse the
+     *  buffer in place, even when other references to it exist, and calls
+     *  with a different shape throw. The caller must keep the buffer alive
+     *  until releaseBuffer is called or the array is destroyed.
+     *
+     *  \param data Buffer holding at least as many elements as the shape.
+     *  \param shape Shape of the array stored in the buffer.
+     */
+    void setBuffer(T* data, std::vector<size_t> shape)
+    {
+        m_shape = std::make_shared<std::vector<size_t>>(shape);
+        m_size = std::make_shared<size_t>(computeSize(shape));
+        m_data = std::make_shared<std::shared_ptr<T>>(data, [](T*) {});
+        m_external = true;
+    }
+
+    //! Stop using a caller-owned buffer.
+    /*! The array is detached from the buffer and empty, and the next call to
+     *  prepare allocates new data owned by the array.
+     */
+    void releaseBuffer()
+    {
+        if (m_external)
+        {
+            m_external = false;
+            prepare(std::vector<size_t> {0}, true);
         }
-        reset();
+    }
+
+    //! Whether the data of this array is a caller-owned buffer, see setBuffer.
+    bool hasBuffer() const
+    {
+        return m_external;
     }
 
     //! Reset the contents of array to be 0.
@@ -327,7 +434,54 @@ public:
         return newarray;
     }
 
+    //! Arrays of at least this many bytes are aligned to huge pages.
+    static constexpr size_t LARGE_ARRAY_BYTES = size_t(4) << 20;
+
+    //! Alignment of large arrays, the size of a transparent huge page on x86-64 Linux.
+    static constexpr size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
 private:
+    //! Get the number of elements of an array of the given shape.
+    static size_t computeSize(const std::vector<size_t>& shape)
+    {
+        size_t size = 1;
+        for (const size_t dimension : shape)
+        {
+            size *= dimension;
+        }
+        return size;
+    }
+
+    //! Allocate data for an array of the given number of elements.
+    /*! On Linux, large arrays of trivially destructible types are aligned to
+     *  huge pages. The elements are default initialized, like new T[size].
+     */
+    static std::shared_ptr<T> allocate(size_t size)
+    {
+#ifdef __linux__
+        const size_t bytes = size * sizeof(T);
+        if (std::is_trivially_destructible<T>::value && bytes >= LARGE_ARRAY_BYTES)
+        {
+            void* memory = nullptr;
+            if (posix_memalign(&memory, HUGE_PAGE_BYTES, bytes) != 0)
+            {
+                throw std::bad_alloc();
+            }
+#ifdef MADV_HUGEPAGE
+            // This is only advice, so failures are ignored.
+            madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+            T* data = static_cast<T*>(memory);
+            for (size_t i = 0; i < size; ++i)
+            {
+                new (data + i) T;
+            }
+            return std::shared_ptr<T>(data, [](T* ptr) { std::free(ptr); });
+        }
+#endif
+        return std::shared_ptr<T>(new T[size], std::default_delete<T[]>());
+    }
+
     //! The base case for building up the index.
     /*! These argument building functions are templated on two types, one that
      *  encapsulates the current object being operated on and the other being
@@ -353,6 +507,7 @@ private:
     std::shared_ptr<std::shared_ptr<T>> m_data;   //!< Pointer to array.
     std::shared_ptr<std::vector<size_t>> m_shape; //!< Shape of array.
     std::shared_ptr<size_t> m_size;               //!< Size of array.
+    bool m_external;                              //!< Whether the data is a caller-owned buffer.
 };
 
 }; }; // end namespace freud::util
@@ -0,0 +1,229 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef MULTIPLE_TAU_CORRELATOR_H
+#define MULTIPLE_TAU_CORRELATOR_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "ManagedArray.h"
+#include "utils.h"
+
+/*! \file MultipleTauCorrelator.h
+    \brief Online time correlation functions at logarithmically spaced lags.
+*/
+
+namespace freud { namespace util {
+
+//! Computes time correlation functions of many channels one frame at a time.
+/*! This is a multiple-tau correlator: level 0 keeps the last
+ *  points_per_level samples of every channel and correlates each new sample
+ *  with all of them, giving the lags 0, ..., points_per_level - 1. Level k
+ *  receives every decimation^k-th frame and gives the lags
+ *  j * decimation^k for j from ceil(points_per_level / decimation) to
+ *  points_per_level - 1. Levels are added as the trajectory grows, so a
+ *  trajectory of T frames only keeps O(log T) samples per channel, and the
+ *  cost per frame is constant.
+ *
+ *  Higher levels subsample the frames instead of averaging them, so that
+ *  any pair function of two samples (such as squared displacements or
+ *  products of rotations) is estimated without bias, from fewer pairs at
+ *  longer lags.
+ */
+template<typename T> class MultipleTauCorrelator
+{
+public:
+    //! Constructor
+    /*! \param points_per_level Number of samples kept per level and channel.
+     *  \param decimation Ratio of the sampling intervals of consecutive levels.
+     */
+    explicit MultipleTauCorrelator(unsigned int points_per_level = 16, unsigned int decimation = 2)
+        : m_points_per_level(points_per_level), m_decimation(decimation), m_n_channels(0), m_n_frames(0)
+    {
+        if (decimation < 2)
+        {
+            throw std::invalid_argument("MultipleTauCorrelator requires a decimation of at least 2.");
+        }
+        if (points_per_level <= decimation)
+        {
+            throw std::invalid_argument(
+                "MultipleTauCorrelator requires more points per level than the decimation.");
+        }
+    }
+
+    //! Discard all frames and set the number of channels.
+    void reset(unsigned int n_channels)
+    {
+        m_n_channels = n_channels;
+        m_n_frames = 0;
+        m_level_counts.clear();
+        m_values.clear();
+        m_sums.clear();
+    }
+
+    //! Add a frame.
+    /*! \param values The value of each channel in the frame.
+     *  \param correlate Function returning the correlation of an earlier and
+     *         a later value of a channel as a double.
+     */
+    template<typename Correlate> void push(const T* values, const Correlate& correlate)
+    {
+        // Level k receives the frame if the frame index is a multiple of
+        // decimation^k. A level is added when the index first reaches its
+        // interval, and starts with the sample of frame 0, which is still in
+        // the buffer of the previous level since points_per_level > decimation.
+        unsigned int n_receiving = 1;
+        for (size_t interval = m_decimation; m_n_frames > 0 && m_n_frames % interval == 0;
+             interval *= m_decimation)
+        {
+            ++n_receiving;
+        }
+        const unsigned int n_old_levels = static_cast<unsigned int>(m_level_counts.size());
+        while (m_level_counts.size() < n_receiving)
+        {
+            m_level_counts.push_back(m_level_counts.empty() ? 0 : 1);
+            m_values.emplace_back(size_t(m_n_channels) * m_points_per_level);
+            m_sums.emplace_back(size_t(m_n_channels) * m_points_per_level, 0.0);
+        }
+
+        const size_t p = m_points_per_level;
+        util::forLoopWrapper(0, m_n_channels, [&](size_t begin, size_t end) {
+            for (size_t channel = begin; channel < end; ++channel)
+            {
+                const T& value = values[channel];
+                for (unsigned int level = 0; level < n_receiving; ++level)
+                {
+                    T* level_values = &m_values[level][channel * p];
+                    double* level_sums = &m_sums[level][channel * p];
+                    if (level >= n_old_levels && level > 0 && n_old_levels > 0)
+                    {
+                        level_values[0] = m_values[level - 1][channel * p];
+                    }
+                    const size_t sample = m_level_counts[level];
+                    level_values[sample % p] = value;
+                    const size_t max_lag = std::min(sample, p - 1);
+                    for (size_t j = firstLagIndex(level); j <= max_lag; ++j)
+                    {
+                        level_sums[j] += correlate(level_values[(sample - j) % p], value);
+                    }
+                }
+            }
+        });
+
+        for (unsigned int level = 0; level < n_receiving; ++level)
+        {
+            ++m_level_counts[level];
+        }
+        ++m_n_frames;
+    }
+
+    //! Get the lags, in frames, for which at least one pair of frames has been correlated.
+    std::vector<size_t> getLags() const
+    {
+        std::vector<size_t> lags;
+        size_t interval = 1;
+        for (unsigned int level = 0; level < m_level_counts.size(); ++level)
+        {
+            for (size_t j = firstLagIndex(level); j < m_points_per_level; ++j)
+            {
+                if (numPairs(level, j) > 0)
+                {
+                    lags.push_back(j * interval);
+                }
+            }
+            interval *= m_decimation;
+        }
+        return lags;
+    }
+
+    //! Compute the correlation at each lag of getLags().
+    /*! \param correlation Filled with the average correlation over channels.
+     *  \param channel_correlation If not nullptr, filled with the correlation
+     *         of each channel, with shape (number of lags, number of channels).
+     */
+    void reduce(ManagedArray<float>& correlation, ManagedArray<float>* channel_correlation = nullptr) const
+    {
+        const size_t n_lags = getLags().size();
+        correlation.prepare(n_lags);
+        if (channel_correlation != nullptr)
+        {
+            channel_correlation->prepare({n_lags, m_n_channels});
+        }
+
+        size_t lag_index = 0;
+        for (unsigned int level = 0; level < m_level_counts.size(); ++level)
+        {
+            for (size_t j = firstLagIndex(level); j < m_points_per_level; ++j)
+            {
+                const size_t n_pairs = numPairs(level, j);
+                if (n_pairs == 0)
+                {
+                    continue;
+                }
+                double sum = 0;
+                for (size_t channel = 0; channel < m_n_channels; ++channel)
+                {
+                    const double value = m_sums[level][channel * m_points_per_level + j] / double(n_pairs);
+                    sum += value;
+                    if (channel_correlation != nullptr)
+                    {
+                        (*channel_correlation)(lag_index, channel) = static_cast<float>(value);
+                    }
+                }
+                correlation[lag_index] = static_cast<float>(sum / m_n_channels);
+                ++lag_index;
+            }
+        }
+    }
+
+    //! Get the number of channels
+    unsigned int getNumChannels() const
+    {
+        return m_n_channels;
+    }
+
+    //! Get the number of frames added since the last reset
+    size_t getNumFrames() const
+    {
+        return m_n_frames;
+    }
+
+    //! Get the number of samples kept per level and channel
+    unsigned int getPointsPerLevel() const
+    {
+        return m_points_per_level;
+    }
+
+    //! Get the ratio of the sampling intervals of consecutive levels
+    unsigned int getDecimation() const
+    {
+        return m_decimation;
+    }
+
+private:
+    //! Index of the smallest lag of a level that is not covered by the previous level.
+    size_t firstLagIndex(unsigned int level) const
+    {
+        return (level == 0) ? 0 : (m_points_per_level + m_decimation - 1) / m_decimation;
+    }
+
+    //! Number of pairs of samples correlated at lag index j of a level.
+    size_t numPairs(unsigned int level, size_t j) const
+    {
+        return (m_level_counts[level] > j) ? m_level_counts[level] - j : 0;
+    }
+
+    unsigned int m_points_per_level;         //!< Number of samples kept per level and channel.
+    unsigned int m_decimation;               //!< Ratio of the sampling intervals of consecutive levels.
+    unsigned int m_n_channels;               //!< Number of channels.
+    size_t m_n_frames;                       //!< Number of frames added since the last reset.
+    std::vector<size_t> m_level_counts;      //!< Number of samples received by each level.
+    std::vector<std::vector<T>> m_values;    //!< Ring buffers of each level, by channel.
+    std::vector<std::vector<double>> m_sums; //!< Sums of correlations of each level, by channel and lag.
+};
+
+}; }; // end namespace freud::util
+
+#endif // MULTIPLE_TAU_CORRELATOR_H
@@ -0,0 +1,402 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef PARALLEL_ACCUMULATOR_H
+#define PARALLEL_ACCUMULATOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <complex>
+#include <memory>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/task_arena.h>
+#include <unordered_map>
+#include <vector>
+
+#include "ArrayReduction.h"
+#include "ManagedArray.h"
+#include "utils.h"
+
+/*! \file ParallelAccumulator.h
+    \brief Strategies for summing values into a shared array from many threads.
+*/
+
+namespace freud { namespace util {
+
+//! Strategies for accumulating values into an array from many threads.
+enum AccumulationStrategy
+{
+    accumulate_auto,         //!< Choose based on the array size and the number of threads.
+    accumulate_thread_local, //!< A full copy of the array per thread.
+    accumulate_tiled,        //!< Per-thread tiles of the array, allocated when first written.
+    accumulate_atomic,       //!< A single shared array updated with atomic adds.
+    accumulate_sparse        //!< A per-thread hash map of the written indices.
+};
+
+//! Scalar components updated atomically for an accumulated type.
+/*! Complex values are accumulated as two atomic scalars, since atomic
+ *  operations on 16-byte types are not lock-free on all platforms.
+ */
+template<typename T> struct AtomicComponents
+{
+    typedef T type;
+    static const unsigned int count = 1;
+};
+
+template<typename U> struct AtomicComponents<std::complex<U>>
+{
+    typedef U type;
+    static const unsigned int count = 2;
+};
+
+//! Sum values into an array from many threads.
+/*! Giving every thread a full copy of the output (as ThreadStorage does) is
+ *  the fastest strategy for small arrays, but its memory grows with the
+ *  number of threads and becomes prohibitive for large grids. This class
+ *  provides alternatives with the same interface:
+ *
+ *  - accumulate_tiled splits the array into fixed-size tiles, and each
+ *    thread only allocates the tiles it writes to. Threads working on
+ *    spatially compact sets of points touch few tiles.
+ *  - accumulate_atomic uses one shared array and atomic additions, so its
+ *    memory does not depend on the number of threads.
+ *  - accumulate_sparse stores only the written indices of each thread, for
+ *    outputs that are very large but sparsely populated.
+ *
+ *  With accumulate_auto, a full copy per thread is used if all copies fit
+ *  within DENSE_MEMORY_LIMIT bytes and tiles are used otherwise.
+ *
+ *  Thread-local copies and tiles are zeroed lazily. Resetting only starts a
+ *  new generation, and each thread zeroes its copy, or each tile it writes
+ *  to, the first time it adds a value in the new generation, so threads that
+ *  do not take part in a computation never clear their data. Copies and
+ *  tiles not written in the current generation are skipped by reduceInto.
+ *  Copies persist across resets so that computes reusing an accumulator for
+ *  every frame do not reallocate them, while tiles that were not written in
+ *  a whole generation are released to keep the memory of accumulate_tiled
+ *  proportional to the region each thread works on.
+ *
+ *  Copies of an accumulator share the atomic array, similarly to copies of a
+ *  ManagedArray, so an accumulator should not be copied while it is in use.
+ */
+template<typename T> class ParallelAccumulator
+{
+public:
+    //! Total memory of all thread-local copies below which accumulate_auto uses them.
+    static const size_t DENSE_MEMORY_LIMIT = size_t(256) << 20;
+
+    //! Number of array elements per tile, as a power of two.
+    static const unsigned int TILE_BITS = 12;
+
+    //! Default constructor
+    ParallelAccumulator() : ParallelAccumulator(0) {}
+
+    //! Constructor
+    /*! \param size Number of elements of the accumulated array.
+     *  \param strategy How to accumulate in parallel.
+     */
+    explicit ParallelAccumulator(size_t size, AccumulationStrategy strategy = accumulate_auto)
+        : m_size(size), m_strategy(resolveStrategy(strategy, size)), m_num_tiles(0), m_generation(1)
+    {
+        switch (m_strategy)
+        {
+        case accumulate_tiled: {
+            m_num_tiles = (size + (size_t(1) << TILE_BITS) - 1) >> TILE_BITS;
+            const size_t num_tiles = m_num_tiles;
+            m_tiles = tbb::enumerable_thread_specific<LocalTiles>(
+                [num_tiles]() { return LocalTiles(num_tiles); });
+            break;
+        }
+        case accumulate_atomic:
+            m_atomic = std::shared_ptr<std::atomic<Component>>(
+                new std::atomic<Component>[size * NUM_COMPONENTS],
+                std::default_delete<std::atomic<Component>[]>());
+            break;
+        default:
+            break;
+        }
+        reset();
+    }
+
+    //! Resolve accumulate_auto to the strategy used for an array size.
+    static AccumulationStrategy resolveStrategy(AccumulationStrategy strategy, size_t size)
+    {
+        if (strategy != accumulate_auto)
+        {
+            return strategy;
+        }
+        const size_t num_threads = tbb::this_task_arena::max_concurrency();
+        return (size * sizeof(T) * num_threads <= DENSE_MEMORY_LIMIT) ? accumulate_thread_local
+                                                                        : accumulate_tiled;
+    }
+
+    //! Get the strategy in use
+    AccumulationStrategy getStrategy() const
+    {
+        return m_strategy;
+    }
+
+    //! Get the number of elements of the accumulated array
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    //! Add a value to an element. Safe to call from multiple threads.
+    void add(size_t index, T value)
+    {
+        switch (m_strategy)
+        {
+        case accumulate_thread_local:
+            localArray()[index] += value;
+            break;
+        case accumulate_tiled:
+            localTile(m_tiles.local(), index >> TILE_BITS)[index & ((size_t(1) << TILE_BITS) - 1)] += value;
+            break;
+        case accumulate_atomic: {
+            // std::complex is layout compatible with an array of its components.
+            const Component* components = reinterpret_cast<const Component*>(&value);
+            for (unsigned int c = 0; c < NUM_COMPONENTS; ++c)
+            {
+                std::atomic<Component>& target = m_atomic.get()[index * NUM_COMPONENTS + c];
+                Component current = target.load(std::memory_order_relaxed);
+                while (!target.compare_exchange_weak(current, current + components[c],
+                                                     std::memory_order_relaxed))
+                {}
+            }
+            break;
+        }
+        default:
+            m_sparse.local()[index] += value;
+            break;
+        }
+    }
+
+    //! Add a value to many elements. Safe to call from multiple threads.
+    /*! \param indices Array of n element indices. Indices that are not less
+     *         than size() are ignored.
+     *  \param n Number of indices.
+     *  \param value The value added to each element.
+     */
+    void add(const size_t* indices, size_t n, T value)
+    {
+        // Thread-local storage is looked up once for the whole batch.
+        if (m_strategy == accumulate_thread_local)
+        {
+            ManagedArray<T>& array = localArray();
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (indices[i] < m_size)
+                {
+                    array[indices[i]] += value;
+                }
+            }
+            return;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (indices[i] < m_size)
+            {
+                add(indices[i], value);
+            }
+        }
+    }
+
+    //! Add an array of size() values elementwise. Safe to call from multiple threads.
+    void add(const T* values)
+    {
+        if (m_strategy == accumulate_thread_local)
+        {
+            ManagedArray<T>& array = localArray();
+            for (size_t i = 0; i < m_size; ++i)
+            {
+                array[i] += values[i];
+            }
+            return;
+        }
+        // Skip zeros so that no tiles or sparse entries are created for them.
+        for (size_t i = 0; i < m_size; ++i)
+        {
+            if (values[i] != T(0))
+            {
+                add(i, values[i]);
+            }
+        }
+    }
+
+    //! Reset all accumulated values to zero.
+    /*! Thread-local copies and tiles are zeroed lazily (see the class
+     *  documentation), tiles not written since the previous reset are
+     *  released, and sparse entries are released.
+     */
+    void reset()
+    {
+        switch (m_strategy)
+        {
+        case accumulate_tiled:
+            for (auto local = m_tiles.begin(); local != m_tiles.end(); ++local)
+            {
+                for (size_t tile_idx = 0; tile_idx < m_num_tiles; ++tile_idx)
+                {
+                    if (local->generations[tile_idx] != m_generation)
+                    {
+                        std::vector<T>().swap(local->tiles[tile_idx]);
+                    }
+                }
+            }
+            break;
+        case accumulate_atomic:
+            util::forLoopWrapper(0, m_size * NUM_COMPONENTS, [this](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    m_atomic.get()[i].store(Component(0), std::memory_order_relaxed);
+                }
+            });
+            break;
+        default:
+            m_sparse.clear();
+            break;
+        }
+        ++m_generation;
+    }
+
+    //! Store the sum over all threads in result, which must have size() elements.
+    void reduceInto(ManagedArray<T>& result)
+    {
+        result.reset();
+        switch (m_strategy)
+        {
+        case accumulate_thread_local: {
+            std::vector<const T*> sources;
+            for (auto local = m_dense.begin(); local != m_dense.end(); ++local)
+            {
+                if (local->generation == m_generation)
+                {
+                    sources.push_back(local->values.get());
+                }
+            }
+            reduceArrays(sources, result.get(), m_size);
+            break;
+        }
+        case accumulate_tiled:
+            util::forLoopWrapper(0, m_num_tiles, [=, &result](size_t begin, size_t end) {
+                for (auto local = m_tiles.begin(); local != m_tiles.end(); ++local)
+                {
+                    for (size_t tile_idx = begin; tile_idx < end; ++tile_idx)
+                    {
+                        if (local->generations[tile_idx] != m_generation)
+                        {
+                            continue;
+                        }
+                        const std::vector<T>& tile = local->tiles[tile_idx];
+                        addArray(result.get() + (tile_idx << TILE_BITS), tile.data(), tile.size());
+                    }
+                }
+            });
+            break;
+        case accumulate_atomic:
+            util::forLoopWrapper(0, m_size, [=, &result](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    Component* components = reinterpret_cast<Component*>(&result[i]);
+                    for (unsigned int c = 0; c < NUM_COMPONENTS; ++c)
+                    {
+                        components[c]
+                            = m_atomic.get()[i * NUM_COMPONENTS + c].load(std::memory_order_relaxed);
+                    }
+                }
+            });
+            break;
+        default:
+            for (auto map = m_sparse.begin(); map != m_sparse.end(); ++map)
+            {
+                for (const auto& entry : *map)
+                {
+                    result[entry.first] += entry.second;
+                }
+            }
+            break;
+        }
+    }
+
+private:
+    typedef typename AtomicComponents<T>::type Component;
+    static const unsigned int NUM_COMPONENTS = AtomicComponents<T>::count;
+
+    //! Generation of data that has not been written since it was created.
+    static const size_t NEVER_WRITTEN = 0;
+
+    //! Thread-local copy of the array and the generation it was last written in.
+    struct LocalArray
+    {
+        LocalArray() : values(0), generation(NEVER_WRITTEN) {}
+
+        ManagedArray<T> values; //!< Accumulated values, allocated on first use.
+        size_t generation;      //!< Generation of the values.
+    };
+
+    //! Thread-local tiles of the array and the generations they were last written in.
+    struct LocalTiles
+    {
+        LocalTiles() {}
+        explicit LocalTiles(size_t num_tiles) : tiles(num_tiles), generations(num_tiles, NEVER_WRITTEN) {}
+
+        std::vector<std::vector<T>> tiles; //!< Tiles, allocated on first use.
+        std::vector<size_t> generations;   //!< Generation of each tile.
+    };
+
+    //! Get the copy of the array of this thread, zeroing it if it is from a previous generation.
+    ManagedArray<T>& localArray()
+    {
+        LocalArray& local = m_dense.local();
+        if (local.generation != m_generation)
+        {
+            if (local.values.size() != m_size)
+            {
+                local.values = ManagedArray<T>(m_size);
+            }
+            else
+            {
+                local.values.reset();
+            }
+            local.generation = m_generation;
+        }
+        return local.values;
+    }
+
+    //! Get a tile of this thread, allocating or zeroing it if it is from a previous generation.
+    std::vector<T>& localTile(LocalTiles& local, size_t tile_idx)
+    {
+        std::vector<T>& tile = local.tiles[tile_idx];
+        if (local.generations[tile_idx] != m_generation)
+        {
+            tile.assign(tileSize(tile_idx), T(0));
+            local.generations[tile_idx] = m_generation;
+        }
+        return tile;
+    }
+
+    //! Number of elements of a tile, smaller for the last tile.
+    size_t tileSize(size_t tile_idx) const
+    {
+        const size_t offset = tile_idx << TILE_BITS;
+        return std::min(size_t(1) << TILE_BITS, m_size - offset);
+    }
+
+    size_t m_size;                   //!< Number of elements of the accumulated array.
+    AccumulationStrategy m_strategy; //!< Strategy in use, never accumulate_auto.
+    size_t m_num_tiles;              //!< Number of tiles for accumulate_tiled.
+    size_t m_generation;             //!< Generation of the data written since the last reset.
+
+    tbb::enumerable_thread_specific<LocalArray> m_dense;                     //!< Thread-local arrays.
+    tbb::enumerable_thread_specific<LocalTiles> m_tiles;                     //!< Thread-local tiles.
+    std::shared_ptr<std::atomic<Component>> m_atomic;                        //!< Shared atomic array.
+    tbb::enumerable_thread_specific<std::unordered_map<size_t, T>> m_sparse; //!< Thread-local maps.
+};
+
+// Definition of the constant, which is bound to a reference by the std::vector constructor of LocalTiles.
+template<typename T> const size_t ParallelAccumulator<T>::NEVER_WRITTEN;
+
+}; }; // end namespace freud::util
+
+#endif // PARALLEL_ACCUMULATOR_H
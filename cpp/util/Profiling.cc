@@ -0,0 +1,80 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#include "Profiling.h"
+
+/*! \file Profiling.cc
+    \brief Scoped timers and counters of the phases of freud computations.
+*/
+
+namespace freud { namespace util { namespace profiling {
+
+namespace {
+//! Profile of this library, used until another one is attached.
+Profile default_profile;
+
+//! Profile attached by freud.profiling.
+std::atomic<Profile*> attached_profile(nullptr);
+}; // end anonymous namespace
+
+Profile::Profile() : m_enabled(false)
+{
+    for (unsigned int i = 0; i < num_counters; ++i)
+    {
+        m_counts[i] = 0;
+    }
+}
+
+void Profile::addTime(const char* name, double seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TimerRecord& record = m_timers[name];
+    ++record.calls;
+    record.seconds += seconds;
+}
+
+std::map<std::string, TimerRecord> Profile::getTimers() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_timers;
+}
+
+void Profile::reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_timers.clear();
+    for (unsigned int i = 0; i < num_counters; ++i)
+    {
+        m_counts[i] = 0;
+    }
+}
+
+Profile& getProfile()
+{
+    Profile* profile = attached_profile.load(std::memory_order_relaxed);
+    return (profile != nullptr) ? *profile : default_profile;
+}
+
+void attachProfile(Profile* profile)
+{
+    attached_profile = profile;
+}
+
+bool isCompiled()
+{
+#ifdef FREUD_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef FREUD_USE_ITT
+__itt_domain* getIttDomain()
+{
+    static __itt_domain* domain = __itt_domain_create("freud");
+    return domain;
+}
+#endif
+
+}; }; }; // end namespace freud::util::profiling
@@ -0,0 +1,197 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef PROFILING_H
+#define PROFILING_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+#ifdef FREUD_USE_ITT
+#include <ittnotify.h>
+#endif
+
+/*! \file Profiling.h
+    \brief Scoped timers and counters of the phases of freud computations.
+
+    Instrumentation is only compiled in if FREUD_PROFILING is defined (see the
+    --PROFILING option of setup.py). Otherwise ScopedTimer and LocalCounter
+    are empty classes that the compiler removes entirely, so the hot paths
+    they are placed in are unchanged. If FREUD_USE_ITT is also defined, every
+    timed phase is annotated as an ITT task, which shows up in the timelines
+    of profilers like Intel VTune.
+*/
+
+namespace freud { namespace util { namespace profiling {
+
+//! Events counted in hot loops.
+enum Counter
+{
+    counter_bonds_visited, //!< Bonds found by neighbor queries and visited by computes.
+    counter_cells_scanned, //!< LinkCell cells searched for neighbors.
+    counter_nodes_tested,  //!< AABB tree nodes tested for overlap with a query.
+    num_counters
+};
+
+//! Number of calls and total time of a timed phase.
+struct TimerRecord
+{
+    unsigned long calls; //!< Number of times the phase ran.
+    double seconds;      //!< Total wall time of the phase.
+};
+
+//! Timers and counters collected while profiling is enabled.
+/*! Timers are recorded when their scope exits, under a mutex, which is cheap
+ *  since timers only surround whole phases. Counters are atomic, and are
+ *  accumulated locally by LocalCounter and added once per scope.
+ */
+class Profile
+{
+public:
+    //! Constructor, disabled and empty.
+    Profile();
+
+    //! Start or stop recording.
+    void setEnabled(bool enabled)
+    {
+        m_enabled = enabled;
+    }
+
+    //! Whether timers and counters are recorded.
+    bool isEnabled() const
+    {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    //! Add the time of one run of a phase.
+    void addTime(const char* name, double seconds);
+
+    //! Add to a counter.
+    void addCount(Counter counter, unsigned long count)
+    {
+        m_counts[counter].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    //! Get the records of all timed phases, by name.
+    std::map<std::string, TimerRecord> getTimers() const;
+
+    //! Get the value of a counter.
+    unsigned long getCount(Counter counter) const
+    {
+        return m_counts[counter].load();
+    }
+
+    //! Clear all timers and counters.
+    void reset();
+
+private:
+    std::atomic<bool> m_enabled;                       //!< Whether recording is enabled.
+    mutable std::mutex m_mutex;                        //!< Serializes access to the timers.
+    std::map<std::string, TimerRecord> m_timers;       //!< Records of the timed phases.
+    std::atomic<unsigned long> m_counts[num_counters]; //!< Values of the counters.
+};
+
+//! Get the profile that timers and counters are recorded in.
+Profile& getProfile();
+
+//! Record into another profile.
+/*! Every freud Python module is a separate library with its own copy of the
+ *  default profile, so freud.profiling attaches its profile to every module
+ *  when it is imported to collect all of them in one place.
+ *
+ *  \param profile The profile to record into, or nullptr for the default.
+ */
+void attachProfile(Profile* profile);
+
+//! Whether instrumentation was compiled in.
+bool isCompiled();
+
+#ifdef FREUD_USE_ITT
+//! Get the ITT domain of freud tasks.
+__itt_domain* getIttDomain();
+#endif
+
+//! Timer of the scope it is declared in.
+/*! \param name Name of the phase, which must be a string literal.
+ */
+class ScopedTimer
+{
+public:
+#ifdef FREUD_PROFILING
+    explicit ScopedTimer(const char* name)
+        : m_name(name), m_enabled(getProfile().isEnabled()), m_start(std::chrono::steady_clock::now())
+    {
+#ifdef FREUD_USE_ITT
+        __itt_task_begin(getIttDomain(), __itt_null, __itt_null, __itt_string_handle_create(name));
+#endif
+    }
+
+    ~ScopedTimer()
+    {
+#ifdef FREUD_USE_ITT
+        __itt_task_end(getIttDomain());
+#endif
+        if (m_enabled)
+        {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+            getProfile().addTime(m_name, elapsed.count());
+        }
+    }
+
+private:
+    const char* m_name;                            //!< Name of the phase.
+    bool m_enabled;                                //!< Whether to record the time.
+    std::chrono::steady_clock::time_point m_start; //!< Time the scope was entered.
+#else
+    explicit ScopedTimer(const char* name) {}
+#endif
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+//! Counter of events in the scope it is declared in.
+/*! Increments are kept in a local variable, usually a register, and added to
+ *  the profile when the scope exits.
+ */
+class LocalCounter
+{
+public:
+#ifdef FREUD_PROFILING
+    explicit LocalCounter(Counter counter) : m_counter(counter), m_count(0) {}
+
+    ~LocalCounter()
+    {
+        if (m_count != 0)
+        {
+            Profile& profile = getProfile();
+            if (profile.isEnabled())
+            {
+                profile.addCount(m_counter, m_count);
+            }
+        }
+    }
+
+    //! Count events.
+    void add(unsigned long count = 1)
+    {
+        m_count += count;
+    }
+
+private:
+    Counter m_counter;     //!< Counter to add to.
+    unsigned long m_count; //!< Events counted so far.
+#else
+    explicit LocalCounter(Counter counter) {}
+
+    void add(unsigned long count = 1) {}
+#endif
+    LocalCounter(const LocalCounter&) = delete;
+    LocalCounter& operator=(const LocalCounter&) = delete;
+};
+
+}; }; }; // end namespace freud::util::profiling
+
+#endif // PROFILING_H
@@ -0,0 +1,151 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef SERIALIZATION_H
+#define SERIALIZATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/*! \file Serialization.h
+    \brief Compact binary buffers of values and arrays.
+*/
+
+namespace freud { namespace util {
+
+//! Append values and arrays of trivially copyable types to a binary buffer.
+/*! Values are stored in the byte order of the host, and arrays are stored
+ *  as their number of elements followed by the elements.
+ */
+class BinaryWriter
+{
+public:
+    //! Append a value.
+    template<typename T> void write(const T& value)
+    {
+        m_data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    //! Append a string.
+    void writeString(const std::string& value)
+    {
+        write<uint64_t>(value.size());
+        m_data.append(value);
+    }
+
+    //! Append an array of n values.
+    template<typename T> void writeArray(const T* values, size_t n)
+    {
+        write<uint64_t>(n);
+        m_data.append(reinterpret_cast<const char*>(values), n * sizeof(T));
+    }
+
+    //! Append the values of a vector.
+    template<typename T> void writeArray(const std::vector<T>& values)
+    {
+        writeArray(values.data(), values.size());
+    }
+
+    //! Get the buffer.
+    const std::string& getData() const
+    {
+        return m_data;
+    }
+
+private:
+    std::string m_data; //!< The written bytes.
+};
+
+//! Read the values and arrays of a buffer written by a BinaryWriter, in the same order.
+/*! Reading past the end of the buffer throws an invalid_argument, so
+ *  truncated or corrupted buffers are detected before any value is used.
+ */
+class BinaryReader
+{
+public:
+    //! Read a buffer, which must outlive the reader.
+    explicit BinaryReader(const std::string& data) : m_data(data), m_position(0) {}
+
+    //! Read a value.
+    template<typename T> T read()
+    {
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    //! Read a string.
+    std::string readString()
+    {
+        const size_t n = readSize(1);
+        return std::string(take(n), n);
+    }
+
+    //! Read an array into n values, throwing if the array has a different number of values.
+    template<typename T> void readArray(T* values, size_t n)
+    {
+        if (read<uint64_t>() != n)
+        {
+            throw std::invalid_argument("The size of a serialized array does not match.");
+        }
+        if (n > 0)
+        {
+            std::memcpy(values, take(n * sizeof(T)), n * sizeof(T));
+        }
+    }
+
+    //! Read an array into a vector.
+    template<typename T> std::vector<T> readArray()
+    {
+        std::vector<T> values(readSize(sizeof(T)));
+        if (!values.empty())
+        {
+            std::memcpy(values.data(), take(values.size() * sizeof(T)), values.size() * sizeof(T));
+        }
+        return values;
+    }
+
+    //! Throw an invalid_argument if the buffer has not been read completely.
+    void finish() const
+    {
+        if (m_position != m_data.size())
+        {
+            throw std::invalid_argument("The serialized data has unexpected trailing bytes.");
+        }
+    }
+
+private:
+    //! Read a number of elements of the given size, checking that they fit in the buffer.
+    size_t readSize(size_t element_size)
+    {
+        const uint64_t n = read<uint64_t>();
+        if (n > (m_data.size() - m_position) / element_size)
+        {
+            throw std::invalid_argument("The serialized data is truncated.");
+        }
+        return static_cast<size_t>(n);
+    }
+
+    //! Return the next n bytes and advance past them.
+    const char* take(size_t n)
+    {
+        if (n > m_data.size() - m_position)
+        {
+            throw std::invalid_argument("The serialized data is truncated.");
+        }
+        const char* data = m_data.data() + m_position;
+        m_position += n;
+        return data;
+    }
+
+    const std::string& m_data; //!< The buffer.
+    size_t m_position;         //!< Number of bytes read.
+};
+
+}; }; // end namespace freud::util
+
+#endif // SERIALIZATION_H
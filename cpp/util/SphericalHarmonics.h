@@ -0,0 +1,146 @@
+// Copyright (c) 2010-2020 The Regents of the University of Michigan
+// This file is from the freud project, released under the BSD 3-Clause License.
+
+#ifndef SPHERICAL_HARMONICS_H
+#define SPHERICAL_HARMONICS_H
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include "VectorMath.h"
+#include "utils.h"
+
+/*! \file SphericalHarmonics.h
+    \brief Evaluates spherical harmonics directly from Cartesian vectors.
+*/
+
+namespace freud { namespace util {
+
+//! Evaluates the spherical harmonics of a vector for all l up to l_max.
+/*! The harmonics are orthonormal and include the Condon-Shortley phase, so
+ *  for a unit vector \f$(x, y, z)\f$
+ *  \f$ Y_l^m = \bar{P}_l^m(z) (x + iy)^m \f$ for \f$m \geq 0\f$ and
+ *  \f$ Y_l^{-m} = (-1)^m \overline{Y_l^m} \f$, where \f$\bar{P}_l^m\f$ is a
+ *  normalized associated Legendre function divided by
+ *  \f$\sin^m\theta\f$. It is evaluated with a stable recurrence in l, so no
+ *  trigonometric functions are needed.
+ *
+ *  For each l the 2l+1 values are stored ordered by m as
+ *  [0, 1, ..., l, -1, -2, ..., -l], the order used by reduceWigner3j. An
+ *  instance owns its output buffer and is meant to be reused for many
+ *  vectors, one instance per thread.
+ */
+class SphericalHarmonics
+{
+public:
+    //! Default constructor
+    SphericalHarmonics() : SphericalHarmonics(0) {}
+
+    //! Constructor
+    /*! \param l_max Largest l to evaluate.
+     */
+    explicit SphericalHarmonics(unsigned int l_max)
+        : m_l_max(l_max), m_ylm((l_max + 1) * (l_max + 1)), m_u_powers(l_max + 1),
+          m_a((l_max + 1) * (l_max + 2) / 2), m_b((l_max + 1) * (l_max + 2) / 2), m_pmm(l_max + 1)
+    {
+        // Y_0^0 and the diagonal terms P_m^m, including the Condon-Shortley phase.
+        double pmm = std::sqrt(1 / (4 * M_PI));
+        m_pmm[0] = float(pmm);
+        for (unsigned int m = 1; m <= l_max; ++m)
+        {
+            pmm *= -std::sqrt((2.0 * m + 1) / (2.0 * m));
+            m_pmm[m] = float(pmm);
+        }
+
+        // Coefficients of the recurrence
+        // P_l^m = a_l^m * (z * P_{l-1}^m - b_l^m * P_{l-2}^m).
+        for (unsigned int l = 1; l <= l_max; ++l)
+        {
+            for (unsigned int m = 0; m < l; ++m)
+            {
+                const double l2(double(l) * l), m2(double(m) * m), lm1(double(l) - 1);
+                m_a[triIndex(l, m)] = float(std::sqrt((4 * l2 - 1) / (l2 - m2)));
+                m_b[triIndex(l, m)] = float(std::sqrt((lm1 * lm1 - m2) / (4 * lm1 * lm1 - 1)));
+            }
+        }
+    }
+
+    //! Get the largest l evaluated
+    unsigned int getLMax() const
+    {
+        return m_l_max;
+    }
+
+    //! Evaluate the harmonics of a vector.
+    /*! \param v The vector.
+     *  \param length The length of v. Vectors of zero length are treated as
+     *         pointing along z.
+     */
+    void compute(const vec3<float>& v, float length)
+    {
+        float x(0), y(0), z(1);
+        if (length > 0)
+        {
+            const float inv_length = float(1) / length;
+            x = v.x * inv_length;
+            y = v.y * inv_length;
+            // Clamp to guard against rounding in the normalization.
+            z = util::clamp(v.z * inv_length, -1, 1);
+        }
+
+        const std::complex<float> u(x, y);
+        m_u_powers[0] = 1;
+        for (unsigned int m = 1; m <= m_l_max; ++m)
+        {
+            m_u_powers[m] = m_u_powers[m - 1] * u;
+        }
+
+        for (unsigned int m = 0; m <= m_l_max; ++m)
+        {
+            const float sign = (m % 2) ? -1 : 1;
+            float p_prev(0);
+            float p(m_pmm[m]);
+            for (unsigned int l = m; l <= m_l_max; ++l)
+            {
+                if (l > m)
+                {
+                    const unsigned int index = triIndex(l, m);
+                    const float p_next = m_a[index] * (z * p - m_b[index] * p_prev);
+                    p_prev = p;
+                    p = p_next;
+                }
+                const std::complex<float> ylm = p * m_u_powers[m];
+                m_ylm[l * l + m] = ylm;
+                if (m > 0)
+                {
+                    m_ylm[l * l + l + m] = sign * std::conj(ylm);
+                }
+            }
+        }
+    }
+
+    //! Get the 2l+1 harmonics of degree l from the last call to compute.
+    const std::complex<float>* getYlm(unsigned int l) const
+    {
+        return &m_ylm[l * l];
+    }
+
+private:
+    //! Index of (l, m) with 0 <= m <= l in the triangular coefficient arrays.
+    static unsigned int triIndex(unsigned int l, unsigned int m)
+    {
+        return l * (l + 1) / 2 + m;
+    }
+
+    unsigned int m_l_max;                        //!< Largest l evaluated.
+    std::vector<std::complex<float>> m_ylm;      //!< Harmonics for all l, 2l+1 values starting at l*l.
+    std::vector<std::complex<float>> m_u_powers; //!< Powers (x + iy)^m of the unit vector.
+    std::vector<float> m_a;                      //!< First recurrence coefficient for each (l, m).
+    std::vector<float> m_b;                      //!< Second recurrence coefficient for each (l, m).
+    std::vector<float> m_pmm;                    //!< Diagonal terms P_m^m.
+};
+
+}; }; // end namespace freud::util
+
+#endif // SPHERICAL_HARMONICS_H
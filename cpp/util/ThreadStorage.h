@@ -1,7 +1,9 @@
 #ifndef THREADSTORAGE_H
 #define THREADSTORAGE_H
 
+#include "ArrayReduction.h"
 #include "ManagedArray.h"
+#include "Profiling.h"
 #include <tbb/enumerable_thread_specific.h>
 #include <vector>
 
@@ -9,14 +11,19 @@ namespace freud { namespace util {
 
 //! Wrapper class for enumerable_thread_specific<T*>
 /*! It is expected that default value for T is 0.
+ *
+ *  Thread local arrays are zeroed lazily: reset and resize only start a new
+ *  generation, and each thread zeroes (or reallocates) its array the first
+ *  time it calls local() in that generation. Threads that do not take part
+ *  in a computation never clear their arrays, which are skipped by
+ *  reduceInto, and arrays persist across calls so that they are not
+ *  reallocated for every frame.
  */
 template<typename T> class ThreadStorage
 {
 public:
     //! Default constructor
-    ThreadStorage()
-        : arrays(tbb::enumerable_thread_specific<ManagedArray<T>>([]() { return ManagedArray<T>(); }))
-    {}
+    ThreadStorage() : ThreadStorage(std::vector<size_t> {0}) {}
 
     //! Constructor with specific size for thread local arrays
     /*! \param size Size of the thread local arrays
@@ -26,10 +33,7 @@ public:
     //! Constructor with specific shape for thread local arrays
     /*! \param shape Vector of sizes in each dimension of the thread local arrays
      */
-    ThreadStorage(std::vector<size_t> shape)
-        : arrays(
-            tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); }))
-    {}
+    ThreadStorage(std::vector<size_t> shape) : m_shape(shape), m_generation(1) {}
 
     //! Destructor
     ~ThreadStorage() {}
@@ -43,78 +47,79 @@ public:
     }
 
     //! Update size of the thread local arrays
-    /*! \param size New size of the thread local arrays
+    /*! \param shape New shape of the thread local arrays
      */
     void resize(std::vector<size_t> shape)
     {
-        arrays
-            = tbb::enumerable_thread_specific<ManagedArray<T>>([shape]() { return ManagedArray<T>(shape); });
+        m_shape = shape;
+        ++m_generation;
     }
 
     //! Reset the contents of thread local arrays to be 0
     void reset()
     {
-        for (auto array = arrays.begin(); array != arrays.end(); ++array)
-        {
-            array->reset();
-        }
-    }
-
-    typedef typename tbb::enumerable_thread_specific<ManagedArray<T>>::const_iterator const_iterator;
-    typedef typename tbb::enumerable_thread_specific<ManagedArray<T>>::iterator iterator;
-    typedef typename tbb::enumerable_thread_specific<ManagedArray<T>>::reference reference;
-
-    const_iterator begin() const
-    {
-        return arrays.begin();
-    }
-
-    iterator begin()
-    {
-        return arrays.begin();
-    }
-
-    const_iterator end() const
-    {
-        return arrays.end();
+        ++m_generation;
     }
 
-    iterator end()
-    {
-        return arrays.end();
-    }
+    typedef ManagedArray<T>& reference;
 
+    //! Get the array of the calling thread, zeroed if it has not been used since the last reset.
     reference local()
     {
-        return arrays.local();
+        LocalArray& array = arrays.local();
+        if (array.generation != m_generation)
+        {
+            if (array.values.shape() != m_shape)
+            {
+                array.values = ManagedArray<T>(m_shape);
+            }
+            else
+            {
+                array.values.reset();
+            }
+            array.generation = m_generation;
+        }
+        return array.values;
     }
 
     void reduceInto(ManagedArray<T>& result)
     {
-        if (arrays.size() == 0)
+        profiling::ScopedTimer timer("ThreadStorage::reduceInto");
+        // Reduce over the arrays used since the last reset into the result
+        // array, tile by tile.
+        std::vector<const T*> sources;
+        for (auto array = arrays.begin(); array != arrays.end(); ++array)
+        {
+            if (array->generation == m_generation)
+            {
+                sources.push_back(array->values.get());
+            }
+        }
+        if (sources.empty())
         {
-            // If no local arrays have been created, then no data can be reduced
-            // and an error will occur if we attempt to iterate over arrays.
+            // If no local arrays have been used, then no data can be reduced.
             // We simply reset the result array so it's all zeros.
             result.reset();
         }
         else
         {
-            // Reduce over arrays into the result array.
-            util::forLoopWrapper(0, result.size(), [=, &result](size_t begin, size_t end) {
-                for (size_t i = begin; i < end; ++i)
-                {
-                    for (auto arr = arrays.begin(); arr != arrays.end(); ++arr)
-                    {
-                        result[i] += (*arr)[i];
-                    }
-                }
-            });
+            reduceArrays(sources, result.get(), result.size());
         }
     }
 
 private:
-    tbb::enumerable_thread_specific<ManagedArray<T>> arrays; //!< thread local arrays
+    //! Array of a thread and the generation it was last zeroed in.
+    struct LocalArray
+    {
+        LocalArray() : values(0), generation(0) {}
+
+        ManagedArray<T> values; //!< Values, allocated on first use.
+        size_t generation;      //!< Generation of the values, 0 if never used.
+    };
+
+    tbb::enumerable_thread_specific<LocalArray> arrays; //!< thread local arrays
+    std::vector<size_t> m_shape;                        //!< Shape of the thread local arrays.
+    size_t m_generation;                                //!< Generation of the arrays in use.
 };
 
 }; }; // end namespace freud::util
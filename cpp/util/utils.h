@@ -3,9 +3,17 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
 #include <tbb/blocked_range.h>
 #include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
+#include <vector>
 
 namespace freud { namespace util {
 
@@ -26,6 +34,77 @@ template<class Scalar> inline Scalar modulusPositive(Scalar a, Scalar b)
     return std::fmod(std::fmod(a, b) + b, b);
 }
 
+//! Round a float toward zero.
+inline float truncateFloat(float a)
+{
+    // Floats of magnitude 2^23 or more are integers, which may not fit in an int.
+    return (std::fabs(a) < 8388608.0f) ? static_cast<float>(static_cast<int>(a)) : a;
+}
+
+//! Same as modulusPositive(a, 1.0f), without calls to std::fmod.
+/*! The remainders of divisions by one are computed exactly by subtracting
+ *  the truncated values, and the intermediate sum is rounded the same way,
+ *  so the results are identical.
+ */
+inline float modulusPositiveOne(float a)
+{
+    const float shifted = (a - truncateFloat(a)) + 1.0f;
+    return shifted - truncateFloat(shifted);
+}
+
+//! Convert a float to the bits of the nearest IEEE 754 half precision float.
+/*! Ties are rounded to even, values too large for half precision become
+ *  infinities, and NaNs stay NaNs. The result can be viewed as a NumPy
+ *  float16 array.
+ */
+inline uint16_t floatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    const uint32_t abs_bits = bits & 0x7FFFFFFF;
+
+    if (abs_bits >= 0x7F800000)
+    {
+        // Infinities and NaNs, keeping NaNs quiet.
+        return sign | ((abs_bits > 0x7F800000) ? 0x7E00 : 0x7C00);
+    }
+    if (abs_bits >= 0x477FF000)
+    {
+        // At least 65520, which rounds past the largest half.
+        return sign | 0x7C00;
+    }
+    if (abs_bits < 0x38800000)
+    {
+        // Below 2^-14, the smallest normal half, so the result is subnormal.
+        // Halves of at most 2^-25 round to zero.
+        if (abs_bits <= 0x33000000)
+        {
+            return sign;
+        }
+        const uint32_t mantissa = (abs_bits & 0x7FFFFF) | 0x800000;
+        const uint32_t shift = 126 - (abs_bits >> 23);
+        uint32_t half = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1)))
+        {
+            ++half;
+        }
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    // Normal halves: rebias the exponent and round the mantissa to 10 bits.
+    // A carry out of the mantissa correctly increments the exponent.
+    uint32_t half = (abs_bits - 0x38000000) >> 13;
+    const uint32_t remainder = abs_bits & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+    {
+        ++half;
+    }
+    return sign | static_cast<uint16_t>(half);
+}
+
 //! Wrapper for for-loop to allow the execution in parallel or not.
 /*! \param begin Beginning index.
  *  \param end Ending index.
@@ -46,6 +125,221 @@ inline void forLoopWrapper(size_t begin, size_t end, const Body& body, bool para
     }
 }
 
+//! Convert a strided two-dimensional array to a contiguous array of another type.
+/*! Reads NumPy arrays of any strides and element type without first making
+ *  them contiguous, so that the conversion takes a single pass. The rows
+ *  are converted in parallel blocks of a few thousand elements, which fit
+ *  in the caches of each thread, unless the array is small.
+ *
+ *  \param source Address of the first element.
+ *  \param n_rows Number of rows.
+ *  \param n_cols Number of elements of each row.
+ *  \param row_stride Distance in bytes between consecutive rows.
+ *  \param col_stride Distance in bytes between consecutive elements of a row.
+ *  \param dest Output array of n_rows * n_cols elements, in row-major order.
+ */
+template<typename Source, typename Dest>
+inline void convertStridedArray(const char* source, size_t n_rows, size_t n_cols, ptrdiff_t row_stride,
+                                ptrdiff_t col_stride, Dest* dest)
+{
+    const size_t grain_size = std::max(size_t(1), size_t(4096) / std::max(n_cols, size_t(1)));
+    const auto convert_rows = [=](const tbb::blocked_range<size_t>& r) {
+        for (size_t i = r.begin(); i != r.end(); ++i)
+        {
+            const char* row = source + static_cast<ptrdiff_t>(i) * row_stride;
+            Dest* out = dest + i * n_cols;
+            for (size_t j = 0; j < n_cols; ++j)
+            {
+                // Elements of strided arrays may not be aligned to their type.
+                Source value;
+                std::memcpy(&value, row + static_cast<ptrdiff_t>(j) * col_stride, sizeof(Source));
+                out[j] = static_cast<Dest>(value);
+            }
+        }
+    };
+    if (n_rows < 8 * grain_size)
+    {
+        convert_rows(tbb::blocked_range<size_t>(0, n_rows));
+    }
+    else
+    {
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, n_rows, grain_size), convert_rows);
+    }
+}
+
+//! Ways of splitting the range of a parallel loop into blocks of work.
+enum Partitioner
+{
+    partition_auto,     //!< Split blocks further when threads are idle (TBB's default).
+    partition_simple,   //!< Split until blocks have at most grain size iterations.
+    partition_static,   //!< Split evenly into about one block per thread.
+    partition_affinity, //!< Give each thread the blocks it had in the previous loop.
+    partition_balanced  //!< Split into blocks of equal total cost, from cost hints.
+};
+
+//! How the iterations of a parallel loop are split into blocks of work.
+/*! The default schedule uses TBB's auto partitioner. When the work per
+ *  iteration is very uneven (for example, per-point loops over neighbors in
+ *  dense clusters), the balanced partitioner splits the range using a cost
+ *  hint per iteration, such as the neighbor counts of a NeighborList, and
+ *  runs the most expensive blocks first. Loops without cost hints fall back
+ *  to the auto partitioner.
+ *
+ *  The affinity partitioner remembers which thread processed each block, so
+ *  computes that keep a schedule and run the same loop repeatedly reuse
+ *  cached data. Copies of a schedule share this state.
+ */
+class LoopSchedule
+{
+public:
+    //! Constructor
+    /*! \param partitioner How to split the loop.
+     *  \param grain_size Minimum number of iterations per block, or the
+     *         maximum for the simple partitioner. 0 uses the default of 1.
+     */
+    explicit LoopSchedule(Partitioner partitioner = partition_auto, size_t grain_size = 0)
+        : m_partitioner(partitioner), m_grain_size(grain_size),
+          m_affinity(partitioner == partition_affinity ? std::make_shared<tbb::affinity_partitioner>()
+                                                       : nullptr)
+    {}
+
+    //! Get the partitioner.
+    Partitioner getPartitioner() const
+    {
+        return m_partitioner;
+    }
+
+    //! Get the grain size, 0 for the default.
+    size_t getGrainSize() const
+    {
+        return m_grain_size;
+    }
+
+    //! Get the state of the affinity partitioner.
+    tbb::affinity_partitioner& getAffinityPartitioner() const
+    {
+        return *m_affinity;
+    }
+
+private:
+    Partitioner m_partitioner; //!< How to split the loop.
+    size_t m_grain_size;       //!< Grain size of the blocks.
+    std::shared_ptr<tbb::affinity_partitioner> m_affinity; //!< Affinity partitioner state.
+};
+
+//! Split a range into contiguous blocks of similar total cost.
+/*! Each iteration costs one plus its cost hint. Blocks end once they reach
+ *  the average cost per block, so an iteration costing more than that is a
+ *  block of its own.
+ *
+ *  \param begin Beginning index.
+ *  \param end Ending index.
+ *  \param costs Cost hint of each index, indexed from 0 (not from begin).
+ *  \param num_blocks Number of blocks to aim for.
+ *  \param min_size Minimum number of iterations per block.
+ *  \returns The boundaries of the blocks, from begin to end.
+ */
+template<typename Cost>
+inline std::vector<size_t> balancedBlocks(size_t begin, size_t end, const Cost* costs, size_t num_blocks,
+                                          size_t min_size)
+{
+    double total_cost = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        total_cost += 1.0 + costs[i];
+    }
+    const double block_cost = total_cost / static_cast<double>(std::max<size_t>(num_blocks, 1));
+
+    std::vector<size_t> boundaries(1, begin);
+    double cost = 0;
+    for (size_t i = begin; i < end; ++i)
+    {
+        cost += 1.0 + costs[i];
+        if (cost >= block_cost && i + 1 - boundaries.back() >= min_size && i + 1 < end)
+        {
+            boundaries.push_back(i + 1);
+            cost = 0;
+        }
+    }
+    boundaries.push_back(end);
+    return boundaries;
+}
+
+//! Wrapper for for-loop with a schedule and optional cost hints.
+/*! \param begin Beginning index.
+ *  \param end Ending index.
+ *  \param body An object with operator(size_t begin, size_t end).
+ *  \param schedule How to split the loop into blocks.
+ *  \param parallel If true, run body in parallel.
+ *  \param costs Cost hint of each index (such as a neighbor count), used by
+ *         the balanced partitioner. May be NULL.
+ */
+template<typename Body, typename Cost = unsigned int>
+inline void forLoopWrapper(size_t begin, size_t end, const Body& body, const LoopSchedule& schedule,
+                           bool parallel = true, const Cost* costs = nullptr)
+{
+    if (!parallel)
+    {
+        body(begin, end);
+        return;
+    }
+
+    const size_t grain_size = std::max<size_t>(schedule.getGrainSize(), 1);
+    const tbb::blocked_range<size_t> range(begin, end, grain_size);
+    const auto range_body = [&body](const tbb::blocked_range<size_t>& r) { body(r.begin(), r.end()); };
+    switch (schedule.getPartitioner())
+    {
+    case partition_simple:
+        tbb::parallel_for(range, range_body, tbb::simple_partitioner());
+        break;
+    case partition_static:
+        tbb::parallel_for(range, range_body, tbb::static_partitioner());
+        break;
+    case partition_affinity:
+        tbb::parallel_for(range, range_body, schedule.getAffinityPartitioner());
+        break;
+    case partition_balanced:
+        if (costs != nullptr)
+        {
+            // Oversplit so that threads finishing early can steal blocks.
+            const size_t num_threads = tbb::this_task_arena::max_concurrency();
+            const std::vector<size_t> boundaries
+                = balancedBlocks(begin, end, costs, 8 * num_threads, grain_size);
+            const size_t num_blocks = boundaries.size() - 1;
+
+            // Start the most expensive blocks first, such as blocks of single
+            // iterations costing more than the average block.
+            std::vector<double> block_costs(num_blocks, 0);
+            for (size_t k = 0; k < num_blocks; ++k)
+            {
+                for (size_t i = boundaries[k]; i < boundaries[k + 1]; ++i)
+                {
+                    block_costs[k] += 1.0 + costs[i];
+                }
+            }
+            std::vector<size_t> order(num_blocks);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(),
+                             [&block_costs](size_t a, size_t b) { return block_costs[a] > block_costs[b]; });
+            tbb::parallel_for(
+                tbb::blocked_range<size_t>(0, num_blocks, 1),
+                [&body, &boundaries, &order](const tbb::blocked_range<size_t>& r) {
+                    for (size_t k = r.begin(); k != r.end(); ++k)
+                    {
+                        body(boundaries[order[k]], boundaries[order[k] + 1]);
+                    }
+                },
+                tbb::simple_partitioner());
+            break;
+        }
+        tbb::parallel_for(range, range_body, tbb::auto_partitioner());
+        break;
+    default:
+        tbb::parallel_for(range, range_body, tbb::auto_partitioner());
+        break;
+    }
+}
+
 //! Wrapper for 2D nested for loops to allow the execution in parallel or not.
 /*! \param begin_row Beginning index of outer loop.
  *  \param end_row Ending index of outer loop.
@@ -6,6 +6,7 @@ from . import cluster
 from . import data
 from . import density
 from . import diffraction
+from . import distributed
 from . import environment
 from . import interface
 from . import locality
@@ -13,6 +14,7 @@ from . import msd
 from . import order
 from . import parallel
 from . import pmft
+from . import profiling
 
 from .box import Box
 from .locality import AABBQuery, LinkCell, NeighborList
@@ -31,6 +33,7 @@ __all__ = [
     'data',
     'density',
     'diffraction',
+    'distributed',
     'environment',
     'interface',
     'locality',
@@ -38,6 +41,7 @@ __all__ = [
     'order',
     'parallel',
     'pmft',
+    'profiling',
     'Box',
     'AABBQuery',
     'LinkCell',
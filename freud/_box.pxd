@@ -45,9 +45,9 @@ cdef extern from "Box.h" namespace "freud::box":
         void center(vec3[float]*, size_t, float*) const
         void computeDistances(vec3[float]*, unsigned int,
                               vec3[float]*, unsigned int, float*
-                              ) except +
+                              ) nogil except +
         void computeAllDistances(vec3[float]*, unsigned int,
-                                 vec3[float]*, unsigned int, float*)
+                                 vec3[float]*, unsigned int, float*) nogil
 
         vec3[bool] getPeriodic() const
         bool getPeriodicX() const
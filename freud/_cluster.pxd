@@ -12,7 +12,7 @@ cdef extern from "Cluster.h" namespace "freud::cluster":
         void compute(const freud._locality.NeighborQuery*,
                      const freud._locality.NeighborList*,
                      freud._locality.QueryArgs,
-                     const unsigned int*) except +
+                     const unsigned int*) nogil except +
         unsigned int getNumClusters() const
         const freud.util.ManagedArray[unsigned int] &getClusterIdx() const
         const vector[vector[uint]] getClusterKeys() const
@@ -21,7 +21,30 @@ cdef extern from "ClusterProperties.h" namespace "freud::cluster":
     cdef cppclass ClusterProperties:
         ClusterProperties()
         void compute(const freud._locality.NeighborQuery*,
-                     const unsigned int*) except +
+                     const unsigned int*) nogil except +
         const freud.util.ManagedArray[vec3[float]] &getClusterCenters() const
         const freud.util.ManagedArray[float] &getClusterGyrations() const
+        const freud.util.ManagedArray[float] \
+            &getClusterRadiiOfGyration() const
+        const freud.util.ManagedArray[float] \
+            &getClusterInertiaTensors() const
         const freud.util.ManagedArray[unsigned int] &getClusterSizes() const
+        const freud.util.ManagedArray[unsigned int] \
+            &getClusterSizeHistogram() const
+
+cdef extern from "ClusterTracker.h" namespace "freud::cluster":
+    cdef cppclass ClusterTracker:
+        ClusterTracker(unsigned int) except +
+        void reset()
+        void compute(const freud._locality.NeighborQuery*,
+                     const freud._locality.NeighborList*,
+                     freud._locality.QueryArgs) nogil except +
+        void track(const unsigned int*, unsigned int) nogil except +
+        unsigned int getMinSize() const
+        size_t getNumFrames() const
+        unsigned int getNumIds() const
+        unsigned int getNumClusters() const
+        const freud.util.ManagedArray[unsigned int] &getClusterIdx() const
+        const freud.util.ManagedArray[unsigned int] &getClusterIds() const
+        const freud.util.ManagedArray[unsigned int] &getOverlap() const
+        const freud.util.ManagedArray[unsigned int] &getEvents() const
@@ -4,66 +4,124 @@
 from freud.util cimport vec3
 from freud._locality cimport BondHistogramCompute
 from libcpp cimport bool
+from libcpp.vector cimport vector
 
 cimport freud._box
 cimport freud._locality
+cimport freud._util
 cimport freud.util
 
 ctypedef unsigned int uint
 
+cdef extern from "GaussianDensity.h" namespace "freud::density":
+    ctypedef enum MassAssignment:
+        assignment_cic
+        assignment_tsc
+
 cdef extern from "CorrelationFunction.h" namespace "freud::density":
+    ctypedef enum CorrelationEngine:
+        correlation_direct
+        correlation_fft
+
     cdef cppclass CorrelationFunction[T](BondHistogramCompute):
         CorrelationFunction(float, float) except +
         void accumulate(const freud._locality.NeighborQuery*, const T*,
                         const vec3[float]*,
                         const T*,
                         unsigned int, const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.Trajectory &,
+                                  const T*,
+                                  freud._locality.QueryArgs,
+                                  bool) nogil except +
         const freud.util.ManagedArray[T] &getCorrelation()
+        void setEngine(CorrelationEngine)
+        void setGridWidth(vec3[unsigned int])
+        void setMassAssignment(MassAssignment)
 
 cdef extern from "GaussianDensity.h" namespace "freud::density":
+    ctypedef enum GaussianDensityEngine:
+        gaussian_auto
+        gaussian_direct
+        gaussian_separable
+        gaussian_fft
+
     cdef cppclass GaussianDensity:
         GaussianDensity(vec3[unsigned int], float, float) except +
         const freud._box.Box & getBox() const
         void reset()
-        void compute(const freud._locality.NeighborQuery*) except +
+        void compute(const freud._locality.NeighborQuery*,
+                     float*) nogil except +
         const freud.util.ManagedArray[float] &getDensity() const
         vec3[unsigned int] getWidth() const
         float getSigma() const
         float getRMax() const
+        void setAccumulationStrategy(freud._util.AccumulationStrategy)
+        freud._util.AccumulationStrategy getAccumulationStrategy() const
+        void setEngine(GaussianDensityEngine)
+        GaussianDensityEngine getEngine() const
+        void setMassAssignment(MassAssignment)
+        MassAssignment getMassAssignment() const
 
 cdef extern from "LocalDensity.h" namespace "freud::density":
     cdef cppclass LocalDensity:
-        LocalDensity(float, float)
+        LocalDensity(float, float) except +
+        LocalDensity(const vector[float] &, float) except +
         const freud._box.Box & getBox() const
         void compute(
             const freud._locality.NeighborQuery*,
             const vec3[float]*,
             unsigned int, const freud._locality.NeighborList *,
-            freud._locality.QueryArgs) except +
+            freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float] &getDensity() const
         const freud.util.ManagedArray[float] &getNumNeighbors() const
         float getRMax() const
+        const vector[float] & getRMaxs() const
         float getDiameter() const
+        void setLoopSchedule(const freud._util.LoopSchedule &)
+        const freud._util.LoopSchedule & getLoopSchedule() const
+
+    cdef cppclass LocalDensityPipelineStage(
+            freud._locality.NeighborPipelineStage):
+        LocalDensityPipelineStage(LocalDensity*)
 
 cdef extern from "RDF.h" namespace "freud::density":
     cdef cppclass RDF(BondHistogramCompute):
-        RDF(float, float, float, bool) except +
+        RDF(float, float, float, bool, unsigned int) except +
         const freud._box.Box & getBox() const
         void accumulate(const freud._locality.NeighborQuery*,
                         const vec3[float]*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        void accumulate(const freud._locality.NeighborQuery*,
+                        const unsigned int*,
+                        const vec3[float]*,
+                        const unsigned int*,
+                        unsigned int,
+                        const freud._locality.NeighborList*,
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.Trajectory &,
+                                  freud._locality.QueryArgs,
+                                  bool) nogil except +
         const freud.util.ManagedArray[float] &getRDF()
         const freud.util.ManagedArray[float] &getNr()
+        unsigned int getNumTypes() const
+        const freud.util.ManagedArray[float] &getPartialRDF()
+        const freud.util.ManagedArray[float] &getPartialNr()
+
+    cdef cppclass RDFPipelineStage(freud._locality.NeighborPipelineStage):
+        RDFPipelineStage(RDF*)
 
 cdef extern from "SphereVoxelization.h" namespace "freud::density":
     cdef cppclass SphereVoxelization:
         SphereVoxelization(vec3[unsigned int], float) except +
         const freud._box.Box & getBox() const
         void reset()
-        void compute(const freud._locality.NeighborQuery*) except +
+        void compute(const freud._locality.NeighborQuery*) nogil except +
         const freud.util.ManagedArray[unsigned int] &getVoxels() const
+        const freud.util.ManagedArray[unsigned char] &getPackedVoxels() const
+        void setPacked(bool)
+        bool isPacked() const
         vec3[unsigned int] getWidth() const
         float getRMax() const
@@ -0,0 +1,37 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+from freud.util cimport vec3, quat
+from libcpp cimport bool
+from libcpp.vector cimport vector
+
+cimport freud._box
+cimport freud.util
+
+cdef extern from "DiffractionPattern.h" namespace "freud::diffraction":
+    cdef cppclass DiffractionPattern:
+        DiffractionPattern(unsigned int) except +
+        void reset()
+        void accumulate(const vec3[float]*, unsigned int, const quat[double] &,
+                        const double*, unsigned int, double,
+                        const double*) nogil except +
+        const freud.util.ManagedArray[double] &getDiffraction()
+        unsigned int getOutputSize() const
+        unsigned int getNViews() const
+
+cdef extern from "StaticStructureFactor.h" namespace "freud::diffraction":
+    cdef cppclass StaticStructureFactor:
+        StaticStructureFactor(unsigned int, float, float) except +
+        void reset()
+        void setKVectors(const vec3[float]*, unsigned int)
+        void sampleKVectors(const freud._box.Box &, unsigned int,
+                            unsigned int)
+        void accumulate(const vec3[float]*, unsigned int) nogil except +
+        void computeDebye(const float*, const float*, unsigned int, float,
+                          bool) nogil except +
+        const freud.util.ManagedArray[float] &getStructureFactor()
+        const freud.util.ManagedArray[float] &getKVectorStructureFactor()
+        const freud.util.ManagedArray[vec3[float]] &getKVectors() const
+        vector[float] getBinEdges() const
+        vector[float] getBinCenters() const
+        unsigned int getFrameCounter() const
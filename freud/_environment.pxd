@@ -2,6 +2,7 @@
 # This file is from the freud project, released under the BSD 3-Clause License.
 
 from libcpp cimport bool
+from libc.stdint cimport uint16_t
 from freud.util cimport vec3, quat
 from libcpp.complex cimport complex
 from libcpp.vector cimport vector
@@ -28,7 +29,8 @@ cdef extern from "BondOrder.h" namespace "freud::environment":
             quat[float]*,
             unsigned int,
             const freud._locality.NeighborList*,
-            freud._locality.QueryArgs) except +
+            freud._locality.QueryArgs,
+            freud._locality.BondGeometry*) nogil except +
         const freud.util.ManagedArray[float] &getBondOrder()
         BondOrderMode getMode() const
 
@@ -38,10 +40,16 @@ cdef extern from "LocalDescriptors.h" namespace "freud::environment":
         Global
         ParticleLocal
 
+    ctypedef enum LocalDescriptorReduction:
+        NoReduction
+        ParticleAverage
+        PowerSpectrum
+
     cdef cppclass LocalDescriptors:
         LocalDescriptors(unsigned int,
-                         bool, LocalDescriptorOrientation)
-        unsigned int getNSphs() const
+                         bool, LocalDescriptorOrientation,
+                         LocalDescriptorReduction, bool)
+        size_t getNSphs() const
         unsigned int getLMax() const
         unsigned int getSphWidth() const
         void compute(
@@ -50,11 +58,18 @@ cdef extern from "LocalDescriptors.h" namespace "freud::environment":
             const quat[float]*,
             const freud._locality.NeighborList*,
             freud._locality.QueryArgs,
-            unsigned int) except +
+            unsigned int,
+            freud._locality.BondGeometry*) nogil except +
         const freud.util.ManagedArray[float complex] &getSph() const
+        const freud.util.ManagedArray[float] &getPowerSpectrum() const
+        const freud.util.ManagedArray[uint16_t] &getHalfOutput() const
         freud._locality.NeighborList * getNList()
         LocalDescriptorOrientation getMode() const
+        LocalDescriptorReduction getReduction() const
         bool getNegativeM() const
+        bool getHalfPrecision() const
+        size_t getMemoryBudget() const
+        void setMemoryBudget(size_t)
 
 cdef extern from "MatchEnv.h" namespace "freud::environment":
     map[unsigned int, unsigned int] minimizeRMSD(
@@ -80,7 +95,7 @@ cdef extern from "MatchEnv.h" namespace "freud::environment":
                      const vec3[float]*,
                      unsigned int,
                      float,
-                     bool) except +
+                     bool) nogil except +
         const freud.util.ManagedArray[bool] &getMatches()
 
     cdef cppclass EnvironmentRMSDMinimizer(MatchEnv):
@@ -91,7 +106,7 @@ cdef extern from "MatchEnv.h" namespace "freud::environment":
             freud._locality.QueryArgs,
             const vec3[float]*,
             unsigned int,
-            bool) except +
+            bool) nogil except +
         const freud.util.ManagedArray[float] &getRMSDs()
 
     cdef cppclass EnvironmentCluster(MatchEnv):
@@ -103,7 +118,7 @@ cdef extern from "MatchEnv.h" namespace "freud::environment":
                      freud._locality.QueryArgs,
                      float,
                      bool,
-                     bool) except +
+                     bool) nogil except +
         unsigned int getNumClusters()
         const freud.util.ManagedArray[unsigned int] &getClusters()
         vector[vector[vec3[float]]] &getClusterEnvironments()
@@ -116,7 +131,7 @@ cdef extern from "AngularSeparation.h" namespace "freud::environment":
                      quat[float]*,
                      unsigned int,
                      quat[float]*,
-                     unsigned int) except +
+                     unsigned int) nogil except +
         const freud.util.ManagedArray[float] &getAngles() const
 
     cdef cppclass AngularSeparationNeighbor:
@@ -128,18 +143,23 @@ cdef extern from "AngularSeparation.h" namespace "freud::environment":
             const quat[float]*, unsigned int,
             const quat[float]*, unsigned int,
             const freud._locality.NeighborList*,
-            freud._locality.QueryArgs) except +
+            freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float] &getAngles() const
         freud._locality.NeighborList * getNList()
 
 cdef extern from "LocalBondProjection.h" namespace "freud::environment":
+    ctypedef enum LocalBondProjectionOutputs:
+        local_bond_projection_normed
+        local_bond_projection_all
+
     cdef cppclass LocalBondProjection:
-        LocalBondProjection()
+        LocalBondProjection(LocalBondProjectionOutputs)
+        LocalBondProjectionOutputs getOutputs() const
         void compute(const freud._locality.NeighborQuery*, quat[float]*,
                      vec3[float]*, unsigned int, vec3[float]*, unsigned int,
                      quat[float]*, unsigned int, const
                      freud._locality.NeighborList*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
 
         const freud.util.ManagedArray[float] &getProjections() const
         const freud.util.ManagedArray[float] &getNormedProjections() const
@@ -6,7 +6,9 @@ from freud.util cimport vec3
 from libcpp.memory cimport shared_ptr
 from libcpp.vector cimport vector
 from libcpp.pair cimport pair
+from libcpp.string cimport string
 cimport freud._box
+cimport freud._util
 cimport freud.util
 
 cdef extern from "NeighborBond.h" namespace "freud::locality":
@@ -25,6 +27,8 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         none "freud::locality::QueryArgs::QueryType::none"
         ball "freud::locality::QueryArgs::QueryType::ball"
         nearest "freud::locality::QueryArgs::QueryType::nearest"
+        count "freud::locality::QueryArgs::QueryType::count"
+        exists "freud::locality::QueryArgs::QueryType::exists"
 
     cdef cppclass QueryArgs:
         QueryType mode
@@ -34,6 +38,9 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         float r_guess
         float scale
         bool exclude_ii
+        bool half
+        unsigned int point_type
+        unsigned int query_point_type
 
     cdef cppclass NeighborQuery:
         NeighborQuery() except +
@@ -42,10 +49,14 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
                       unsigned int) except +
         shared_ptr[NeighborQueryIterator] query(
             const vec3[float]*, unsigned int, QueryArgs) except +
+        void queryCounts(const vec3[float]*, unsigned int, QueryArgs,
+                         unsigned int*) nogil except +
         const freud._box.Box & getBox() const
         const vec3[float]* getPoints const
         const unsigned int getNPoints const
         const vec3[float] operator[](unsigned int) const
+        void setPointTypes(const unsigned int*) except +
+        bool hasPointTypes() const
 
     NeighborBond ITERATOR_TERMINATOR \
         "freud::locality::NeighborQueryIterator::ITERATOR_TERMINATOR"
@@ -56,6 +67,17 @@ cdef extern from "NeighborQuery.h" namespace "freud::locality":
         bool end()
         NeighborBond next()
         NeighborList *toNeighborList(bool)
+        NeighborList *toNeighborList(bool, unsigned int,
+                                     unsigned int) except +
+
+cdef extern from "NeighborQueryBackend.h" namespace "freud::locality":
+    ctypedef enum BackendSelection:
+        selection_aabb "freud::locality::selection_aabb"
+        selection_auto "freud::locality::selection_auto"
+        selection_calibrated "freud::locality::selection_calibrated"
+
+    void setBackendSelection(BackendSelection)
+    BackendSelection getBackendSelection()
 
 cdef extern from "RawPoints.h" namespace "freud::locality":
 
@@ -68,45 +90,98 @@ cdef extern from "RawPoints.h" namespace "freud::locality":
 cdef extern from "NeighborList.h" namespace "freud::locality":
     cdef cppclass NeighborList:
         NeighborList()
-        NeighborList(unsigned int)
-        NeighborList(unsigned int, const unsigned int*, unsigned int,
+        NeighborList(size_t)
+        NeighborList(size_t, const unsigned int*, unsigned int,
                      const unsigned int*, unsigned int, const float*,
                      const float*) except +
 
-        freud.util.ManagedArray[unsigned int] &getNeighbors()
+        const freud.util.ManagedArray[unsigned int] &getNeighbors() const
+        freud.util.ManagedArray[unsigned int] &getQueryPointIndices()
+        freud.util.ManagedArray[unsigned int] &getPointIndices()
         freud.util.ManagedArray[float] &getDistances()
         freud.util.ManagedArray[float] &getWeights()
-        freud.util.ManagedArray[float] &getSegments()
-        freud.util.ManagedArray[float] &getCounts()
+        freud.util.ManagedArray[vec3[float]] &getVectors()
+        bool hasVectors() const
+        bool isHalf() const
+        freud.util.ManagedArray[size_t] &getSegments()
+        freud.util.ManagedArray[unsigned int] &getCounts()
 
-        unsigned int getNumBonds() const
+        size_t getNumBonds() const
         unsigned int getNumPoints() const
         unsigned int getNumQueryPoints() const
-        void setNumBonds(unsigned int, unsigned int, unsigned int)
-        unsigned int filter(const bool*) except +
-        unsigned int filter_r(float, float) except +
+        void setNumBonds(size_t, unsigned int, unsigned int)
+        size_t filter(const bool*) except +
+        size_t filter_r(float, float) except +
 
-        unsigned int find_first_index(unsigned int)
+        size_t find_first_index(unsigned int)
 
-        void resize(unsigned int)
+        void resize(size_t)
         void copy(const NeighborList &)
         void validate(unsigned int, unsigned int) except +
 
+cdef extern from "CompressedNeighborList.h" namespace "freud::locality":
+    ctypedef enum DistanceStorage \
+            "freud::locality::CompressedNeighborList::DistanceStorage":
+        distances_full \
+            "freud::locality::CompressedNeighborList::distances_full"
+        distances_quantized \
+            "freud::locality::CompressedNeighborList::distances_quantized"
+        distances_none \
+            "freud::locality::CompressedNeighborList::distances_none"
+
+    cdef cppclass CompressedNeighborList:
+        CompressedNeighborList()
+        CompressedNeighborList(const NeighborList &,
+                               DistanceStorage) except +
+        size_t getNumBonds() const
+        unsigned int getNumQueryPoints() const
+        unsigned int getNumPoints() const
+        bool isHalf() const
+        DistanceStorage getDistanceStorage() const
+        size_t getNumBytes() const
+        NeighborList *toNeighborList(const NeighborQuery*,
+                                     const vec3[float]*) except +
+
+cdef extern from "BondGeometry.h" namespace "freud::locality":
+    cdef cppclass BondGeometry:
+        BondGeometry(const NeighborList*, const NeighborQuery*,
+                     const vec3[float]*, unsigned int) except +
+        unsigned int getNumBonds() const
+        unsigned int getLMax() const
+        const freud.util.ManagedArray[vec3[float]] &getVectors() const
+        const freud.util.ManagedArray[vec3[float]] &getUnitVectors() \
+            except +
+        const freud.util.ManagedArray[float] &getTheta() except +
+        const freud.util.ManagedArray[float] &getPhi() except +
+        const freud.util.ManagedArray[float complex] &getHarmonics() \
+            except +
+
+cdef extern from "NeighborComputeFunctional.h" namespace "freud::locality":
+    size_t estimateNeighborListBytes(const NeighborQuery*, unsigned int,
+                                     QueryArgs) except +
+
 cdef extern from "LinkCell.h" namespace "freud::locality":
     cdef cppclass LinkCell(NeighborQuery):
         LinkCell() except +
         LinkCell(const freud._box.Box &,
                  const vec3[float]*,
                  unsigned int,
-                 float) except +
+                 float,
+                 bool,
+                 bool) except +
         float getCellWidth() const
+        void update(const vec3[float]*) nogil except +
 
 cdef extern from "AABBQuery.h" namespace "freud::locality":
     cdef cppclass AABBQuery(NeighborQuery):
         AABBQuery() except +
         AABBQuery(const freud._box.Box,
                   const vec3[float]*,
-                  unsigned int) except +
+                  unsigned int,
+                  bool,
+                  float) except +
+        void update(const vec3[float]*) nogil except +
+        float getGhostWidth() const
 
 cdef extern from "BondHistogramCompute.h" namespace "freud::locality":
     cdef cppclass BondHistogramCompute:
@@ -119,6 +194,10 @@ cdef extern from "BondHistogramCompute.h" namespace "freud::locality":
         vector[vector[float]] getBinCenters() const
         vector[pair[float, float]] getBounds() const
         vector[size_t] getAxisSizes() const
+        void setAccumulationStrategy(freud._util.AccumulationStrategy)
+        freud._util.AccumulationStrategy getAccumulationStrategy() const
+        string serialize() except +
+        void deserialize(const string &, bool) except +
 
 cdef extern from "PeriodicBuffer.h" namespace "freud::locality":
     cdef cppclass PeriodicBuffer:
@@ -128,14 +207,77 @@ cdef extern from "PeriodicBuffer.h" namespace "freud::locality":
         void compute(
             const NeighborQuery*,
             const vec3[float],
-            const bool) except +
+            const bool) nogil except +
         vector[vec3[float]] getBufferPoints() const
         vector[uint] getBufferIds() const
 
 cdef extern from "Voronoi.h" namespace "freud::locality":
+    ctypedef enum VoronoiOutputs:
+        voronoi_neighbors
+        voronoi_volumes
+        voronoi_polytopes
+
     cdef cppclass Voronoi:
-        Voronoi()
+        Voronoi(VoronoiOutputs)
+        VoronoiOutputs getOutputs() const
         void compute(const NeighborQuery*) nogil except +
         vector[vector[vec3[double]]] getPolytopes() const
+        const freud.util.ManagedArray[vec3[double]] &getPolytopeVertices() \
+            const
+        const freud.util.ManagedArray[size_t] &getPolytopeOffsets() const
         const freud.util.ManagedArray[double] &getVolumes() const
         shared_ptr[NeighborList] getNeighborList() const
+
+cdef extern from "VerletList.h" namespace "freud::locality":
+    cdef cppclass VerletList:
+        VerletList(float, float, float, bool) except +
+        void compute(const NeighborQuery*, const vec3[float]*,
+                     unsigned int) nogil except +
+        void reset()
+        shared_ptr[NeighborList] getNeighborList() const
+        unsigned int getNumBuilds() const
+        float getRMax() const
+        float getSkin() const
+
+cdef extern from "NeighborListCache.h" namespace "freud::locality":
+    cdef cppclass NeighborListCache:
+        NeighborListCache(const NeighborQuery*, unsigned int) except +
+        shared_ptr[NeighborList] get(QueryArgs) nogil except +
+        void clear()
+        unsigned int getMaxSize() const
+        unsigned int getSize() const
+        unsigned int getNumHits() const
+        unsigned int getNumDerived() const
+        unsigned int getNumQueries() const
+
+cdef extern from "FrameSource.h" namespace "freud::locality":
+    cdef cppclass FrameSource:
+        unsigned int getNFrames() const
+        unsigned int getNPoints() const
+        bool is2D() const
+        const vec3[float]* getPoints(unsigned int) const
+        const float* getBoxParams(unsigned int) const
+        void prefetch(unsigned int) const
+
+    cdef cppclass GSDFrameSource(FrameSource):
+        GSDFrameSource(string) except +
+
+cdef extern from "Trajectory.h" namespace "freud::locality":
+    cdef cppclass Trajectory:
+        Trajectory(const vec3[float]*, const float*, unsigned int,
+                   unsigned int, unsigned int, bool) except +
+        Trajectory(shared_ptr[FrameSource]) except +
+        unsigned int getNFrames() const
+        unsigned int getNPoints() const
+
+cdef extern from "NeighborPipeline.h" namespace "freud::locality":
+    cdef cppclass NeighborPipelineStage:
+        float getRMax() const
+
+    cdef cppclass NeighborPipeline:
+        NeighborPipeline()
+        void addStage(shared_ptr[NeighborPipelineStage])
+        void clearStages()
+        unsigned int getNumStages() const
+        void compute(const NeighborQuery*, const vec3[float]*, unsigned int,
+                     QueryArgs, const NeighborList*) nogil except +
@@ -0,0 +1,38 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+from freud.util cimport vec3
+from libcpp.vector cimport vector
+
+cimport freud._box
+cimport freud.util
+
+cdef extern from "MSD.h" namespace "freud::msd":
+    ctypedef enum MSDMode:
+        msd_window
+        msd_direct
+
+    cdef cppclass MSD:
+        MSD(const freud._box.Box &, MSDMode) except +
+        void reset()
+        void accumulate(const vec3[float]*, const vec3[int]*, unsigned int,
+                        unsigned int, size_t) nogil except +
+        const freud.util.ManagedArray[float] &getMSD()
+        const freud.util.ManagedArray[float] &getParticleMSD()
+        unsigned int getNFrames() const
+        unsigned int getNParticles() const
+
+cdef extern from "MultipleTauMSD.h" namespace "freud::msd":
+    cdef cppclass MultipleTauMSD:
+        MultipleTauMSD(const freud._box.Box &, unsigned int,
+                       unsigned int) except +
+        void reset()
+        void accumulate(const vec3[float]*, const vec3[int]*, unsigned int,
+                        unsigned int) nogil except +
+        vector[size_t] getLags() const
+        const freud.util.ManagedArray[float] &getMSD()
+        const freud.util.ManagedArray[float] &getParticleMSD()
+        size_t getNFrames() const
+        unsigned int getNParticles() const
+        unsigned int getPointsPerLevel() const
+        unsigned int getDecimation() const
@@ -8,6 +8,7 @@ from libcpp.vector cimport vector
 
 cimport freud._box
 cimport freud._locality
+cimport freud._util
 cimport freud.util
 
 cdef extern from "Cubatic.h" namespace "freud::order":
@@ -19,7 +20,7 @@ cdef extern from "Cubatic.h" namespace "freud::order":
                 unsigned int) except +
         void reset()
         void compute(quat[float]*,
-                     unsigned int) except +
+                     unsigned int) nogil except +
         unsigned int getNumParticles() const
         float getCubaticOrderParameter() const
         const freud.util.ManagedArray[float] &getParticleOrderParameter() const
@@ -38,7 +39,12 @@ cdef extern from "Nematic.h" namespace "freud::order":
         Nematic(vec3[float])
         void reset()
         void compute(quat[float]*,
-                     unsigned int) except +
+                     unsigned int) nogil except +
+        void computeFrames(const quat[float]*, unsigned int,
+                           unsigned int) nogil except +
+        const freud.util.ManagedArray[float] &getFrameOrderParameters() const
+        const freud.util.ManagedArray[float] &getFrameDirectors() const
+        const freud.util.ManagedArray[float] &getFrameNematicTensors() const
         unsigned int getNumParticles() const
         float getNematicOrderParameter() const
         const freud.util.ManagedArray[float] &getParticleTensor() const
@@ -52,7 +58,7 @@ cdef extern from "HexaticTranslational.h" namespace "freud::order":
         Hexatic(unsigned int, bool)
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float complex] &getOrder()
         unsigned int getK()
         bool isWeighted() const
@@ -61,27 +67,51 @@ cdef extern from "HexaticTranslational.h" namespace "freud::order":
         Translational(float, bool)
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs) nogil except +
         const freud.util.ManagedArray[float complex] &getOrder() const
         float getK() const
         bool isWeighted() const
 
+    cdef cppclass HexaticTranslationalOrder:
+        HexaticTranslationalOrder(vector[unsigned int], float, bool) except +
+        void compute(const freud._locality.NeighborList*,
+                     const freud._locality.NeighborQuery*,
+                     freud._locality.QueryArgs) nogil except +
+        const freud.util.ManagedArray[float complex] &getOrder() const
+        const freud.util.ManagedArray[float complex] \
+            &getTranslationalOrder() const
+        vector[unsigned int] getK() const
+        float getTranslationalK() const
+        bool isWeighted() const
+
 
 cdef extern from "Steinhardt.h" namespace "freud::order":
     cdef cppclass Steinhardt:
-        Steinhardt(unsigned int, bool, bool, bool, bool) except +
+        Steinhardt(vector[unsigned int], bool, bool, bool, bool) except +
         unsigned int getNP() const
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) except +
+                     freud._locality.QueryArgs,
+                     freud._locality.BondGeometry*) nogil except +
         const freud.util.ManagedArray[float] &getQl() const
         const freud.util.ManagedArray[float] &getParticleOrder() const
-        float getOrder() const
+        vector[float] getOrder() const
+        void computeTrajectory(const freud._locality.Trajectory &,
+                               freud._locality.QueryArgs, bool) nogil except +
+        const freud.util.ManagedArray[float] &getTrajectoryParticleOrder() \
+            const
+        vector[float] getTrajectoryOrder() const
         bool isAverage() const
         bool isWl() const
         bool isWeighted() const
         bool isWlNormalized() const
-        unsigned int getL() const
+        vector[unsigned int] getL() const
+        void setLoopSchedule(const freud._util.LoopSchedule &)
+        const freud._util.LoopSchedule & getLoopSchedule() const
+
+    cdef cppclass SteinhardtPipelineStage(
+            freud._locality.NeighborPipelineStage):
+        SteinhardtPipelineStage(Steinhardt*) except +
 
 
 cdef extern from "SolidLiquid.h" namespace "freud::order":
@@ -91,9 +121,12 @@ cdef extern from "SolidLiquid.h" namespace "freud::order":
         float getQThreshold() const
         unsigned int getSolidThreshold() const
         bool getNormalizeQ() const
+        size_t getMemoryBudget() const
+        void setMemoryBudget(size_t)
         void compute(const freud._locality.NeighborList*,
                      const freud._locality.NeighborQuery*,
-                     freud._locality.QueryArgs) nogil except +
+                     freud._locality.QueryArgs,
+                     freud._locality.BondGeometry*) nogil except +
         unsigned int getLargestClusterSize() const
         vector[unsigned int] getClusterSizes() const
         const freud.util.ManagedArray[unsigned int] &getClusterIdx() const
@@ -107,8 +140,20 @@ cdef extern from "SolidLiquid.h" namespace "freud::order":
 cdef extern from "RotationalAutocorrelation.h" namespace "freud::order":
     cdef cppclass RotationalAutocorrelation:
         RotationalAutocorrelation()
-        RotationalAutocorrelation(unsigned int)
+        RotationalAutocorrelation(unsigned int, unsigned int,
+                                  unsigned int) except +
         unsigned int getL() const
         const freud.util.ManagedArray[float complex] &getRAArray() const
         float getRotationalAutocorrelation() const
-        void compute(quat[float]*, quat[float]*, unsigned int) except +
+        void compute(quat[float]*, quat[float]*, unsigned int) nogil except +
+        void computeFrames(const quat[float]*, const quat[float]*,
+                           unsigned int, unsigned int) nogil except +
+        const freud.util.ManagedArray[float] &getFrameAutocorrelations() const
+        void resetTimeCorrelation()
+        void accumulateFrames(const quat[float]*, unsigned int,
+                              unsigned int) nogil except +
+        vector[size_t] getLags() const
+        const freud.util.ManagedArray[float] &getTimeCorrelation()
+        size_t getNumFrames() const
+        unsigned int getPointsPerLevel() const
+        unsigned int getDecimation() const
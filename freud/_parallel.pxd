@@ -1,5 +1,14 @@
 # Copyright (c) 2010-2020 The Regents of the University of Michigan
 # This file is from the freud project, released under the BSD 3-Clause License.
 
+from libcpp.vector cimport vector
+
 cdef extern from "tbb_config.h" namespace "freud::parallel":
     void setNumThreads(unsigned int)
+    vector[int] getNumaNodes()
+
+    cdef cppclass Arena:
+        Arena(unsigned int, int) except +
+        unsigned int getNumThreads() const
+        int getNumaNode() const
+        void executeCallback(void (*)(void*) nogil, void*) nogil except +
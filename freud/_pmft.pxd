@@ -2,6 +2,7 @@
 # This file is from the freud project, released under the BSD 3-Clause License.
 
 from freud.util cimport vec3, quat
+from libcpp cimport bool
 from freud._locality cimport BondHistogramCompute
 
 cimport freud._locality
@@ -11,18 +12,23 @@ cdef extern from "PMFT.h" namespace "freud::pmft":
     cdef cppclass PMFT(BondHistogramCompute):
         PMFT() except +
         const freud.util.ManagedArray[float] &getPCF()
+        const freud.util.ManagedArray[float] &getAdaptivePCF(unsigned int)
 
 cdef extern from "PMFTR12.h" namespace "freud::pmft":
     cdef cppclass PMFTR12(PMFT):
         PMFTR12(float, unsigned int, unsigned int, unsigned int) except +
 
         void accumulate(const freud._locality.NeighborQuery*,
-                        float*,
-                        vec3[float]*,
-                        float*,
+                        const float*,
+                        const vec3[float]*,
+                        const float*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.Trajectory &,
+                                  const float*,
+                                  freud._locality.QueryArgs,
+                                  bool) nogil except +
 
 cdef extern from "PMFTXYT.h" namespace "freud::pmft":
     cdef cppclass PMFTXYT(PMFT):
@@ -30,23 +36,31 @@ cdef extern from "PMFTXYT.h" namespace "freud::pmft":
                 unsigned int, unsigned int, unsigned int) except +
 
         void accumulate(const freud._locality.NeighborQuery*,
-                        float*,
-                        vec3[float]*,
-                        float*,
+                        const float*,
+                        const vec3[float]*,
+                        const float*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.Trajectory &,
+                                  const float*,
+                                  freud._locality.QueryArgs,
+                                  bool) nogil except +
 
 cdef extern from "PMFTXY.h" namespace "freud::pmft":
     cdef cppclass PMFTXY(PMFT):
         PMFTXY(float, float, unsigned int, unsigned int) except +
 
         void accumulate(const freud._locality.NeighborQuery*,
-                        float*,
-                        vec3[float]*,
+                        const float*,
+                        const vec3[float]*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.Trajectory &,
+                                  const float*,
+                                  freud._locality.QueryArgs,
+                                  bool) nogil except +
 
 cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
     cdef cppclass PMFTXYZ(PMFT):
@@ -54,10 +68,20 @@ cdef extern from "PMFTXYZ.h" namespace "freud::pmft":
                 unsigned int, vec3[float]) except +
 
         void accumulate(const freud._locality.NeighborQuery*,
-                        quat[float]*,
-                        vec3[float]*,
+                        const quat[float]*,
+                        const vec3[float]*,
                         unsigned int,
-                        quat[float]*,
+                        const quat[float]*,
                         unsigned int,
                         const freud._locality.NeighborList*,
-                        freud._locality.QueryArgs) except +
+                        freud._locality.QueryArgs) nogil except +
+        void accumulateTrajectory(const freud._locality.Trajectory &,
+                                  const quat[float]*,
+                                  const quat[float]*,
+                                  unsigned int,
+                                  freud._locality.QueryArgs,
+                                  bool) nogil except +
+
+    cdef cppclass PMFTXYZPipelineStage(freud._locality.NeighborPipelineStage):
+        PMFTXYZPipelineStage(PMFTXYZ*, const quat[float]*,
+                             const quat[float]*, unsigned int)
@@ -1,7 +1,10 @@
 # Copyright (c) 2010-2020 The Regents of the University of Michigan
 # This file is from the freud project, released under the BSD 3-Clause License.
 
+from libc.stddef cimport ptrdiff_t
 from libcpp cimport bool
+from libcpp.map cimport map
+from libcpp.string cimport string
 from libcpp.vector cimport vector
 
 cimport numpy
@@ -28,6 +31,51 @@ cdef extern from "ManagedArray.h" namespace "freud::util":
         size_t size() const
         vector[size_t] shape() const
 
+cdef extern from "ParallelAccumulator.h" namespace "freud::util":
+    ctypedef enum AccumulationStrategy:
+        accumulate_auto
+        accumulate_thread_local
+        accumulate_tiled
+        accumulate_atomic
+        accumulate_sparse
+
+cdef extern from "utils.h" namespace "freud::util":
+    ctypedef enum Partitioner:
+        partition_auto
+        partition_simple
+        partition_static
+        partition_affinity
+        partition_balanced
+
+    cdef cppclass LoopSchedule:
+        LoopSchedule(Partitioner, size_t)
+        Partitioner getPartitioner() const
+        size_t getGrainSize() const
+
+    void convertStridedArray[Source, Dest](
+        const char*, size_t, size_t, ptrdiff_t, ptrdiff_t, Dest*) nogil
+
+cdef extern from "Profiling.h" namespace "freud::util::profiling":
+    ctypedef enum Counter:
+        counter_bonds_visited
+        counter_cells_scanned
+        counter_nodes_tested
+
+    cdef cppclass TimerRecord:
+        unsigned long calls
+        double seconds
+
+    cdef cppclass Profile:
+        void setEnabled(bool)
+        bool isEnabled() const
+        map[string, TimerRecord] getTimers() const
+        unsigned long getCount(Counter) const
+        void reset()
+
+    Profile& getProfile()
+    void attachProfile(Profile*)
+    bool isCompiled()
+
 
 cdef extern from "numpy/arrayobject.h":
     cdef int PyArray_SetBaseObject(numpy.ndarray arr, obj)
@@ -188,10 +188,11 @@ cdef class Box:
             :math:`\left(3, \right)` or :math:`\left(N, 3\right)` :class:`numpy.ndarray`:
                 Absolute coordinate vector(s).
         """  # noqa: E501
-        fractions = np.asarray(fractional_coordinates).copy()
+        fractions = np.asarray(fractional_coordinates)
         flatten = fractions.ndim == 1
         fractions = np.atleast_2d(fractions)
-        fractions = freud.util._convert_array(fractions, shape=(None, 3))
+        fractions = freud.util._convert_array(
+            fractions, shape=(None, 3), copy=True)
 
         cdef const float[:, ::1] l_points = fractions
         cdef unsigned int Np = l_points.shape[0]
@@ -210,10 +211,10 @@ cdef class Box:
             :math:`\left(3, \right)` or :math:`\left(N, 3\right)` :class:`numpy.ndarray`:
                 Fractional coordinate vector(s).
         """  # noqa: E501
-        vecs = np.asarray(absolute_coordinates).copy()
+        vecs = np.asarray(absolute_coordinates)
         flatten = vecs.ndim == 1
         vecs = np.atleast_2d(vecs)
-        vecs = freud.util._convert_array(vecs, shape=(None, 3))
+        vecs = freud.util._convert_array(vecs, shape=(None, 3), copy=True)
 
         cdef const float[:, ::1] l_points = vecs
         cdef unsigned int Np = l_points.shape[0]
@@ -296,7 +297,7 @@ cdef class Box:
         vecs = np.asarray(vecs)
         flatten = vecs.ndim == 1
         vecs = np.atleast_2d(vecs)
-        vecs = freud.util._convert_array(vecs, shape=(None, 3)).copy()
+        vecs = freud.util._convert_array(vecs, shape=(None, 3), copy=True)
 
         cdef const float[:, ::1] l_points = vecs
         cdef unsigned int Np = l_points.shape[0]
@@ -326,7 +327,7 @@ cdef class Box:
         if vecs.shape[0] != imgs.shape[0]:
             # Broadcasts (1, 3) to (N, 3) for both arrays
             vecs, imgs = np.broadcast_arrays(vecs, imgs)
-        vecs = freud.util._convert_array(vecs, shape=(None, 3)).copy()
+        vecs = freud.util._convert_array(vecs, shape=(None, 3), copy=True)
         imgs = freud.util._convert_array(imgs, shape=vecs.shape,
                                          dtype=np.int32)
 
@@ -409,7 +410,7 @@ cdef class Box:
             :math:`\left(N, 3\right)` :class:`numpy.ndarray`:
                 Vectors with center of mass subtracted.
         """  # noqa: E501
-        vecs = freud.util._convert_array(vecs, shape=(None, 3)).copy()
+        vecs = freud.util._convert_array(vecs, shape=(None, 3), copy=True)
         cdef const float[:, ::1] l_points = vecs
 
         cdef float* l_masses_ptr = NULL
@@ -452,10 +453,11 @@ cdef class Box:
             float[::1] distances = np.empty(
                 n_query_points, dtype=np.float32)
 
-        self.thisptr.computeDistances(
-            <vec3[float]*> &l_query_points[0, 0], n_query_points,
-            <vec3[float]*> &l_points[0, 0], n_points,
-            <float *> &distances[0])
+        with nogil:
+            self.thisptr.computeDistances(
+                <vec3[float]*> &l_query_points[0, 0], n_query_points,
+                <vec3[float]*> &l_points[0, 0], n_points,
+                <float *> &distances[0])
         return np.asarray(distances)
 
     def compute_all_distances(self, query_points, points):
@@ -487,10 +489,11 @@ cdef class Box:
             float[:, ::1] distances = np.empty(
                 [n_query_points, n_points], dtype=np.float32)
 
-        self.thisptr.computeAllDistances(
-            <vec3[float]*> &l_query_points[0, 0], n_query_points,
-            <vec3[float]*> &l_points[0, 0], n_points,
-            <float *> &distances[0, 0])
+        with nogil:
+            self.thisptr.computeAllDistances(
+                <vec3[float]*> &l_query_points[0, 0], n_query_points,
+                <vec3[float]*> &l_points[0, 0], n_points,
+                <float *> &distances[0, 0])
 
         return np.asarray(distances)
 
@@ -24,6 +24,9 @@ cimport numpy as np
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 cdef class Cluster(_PairCompute):
     """Finds clusters using a network of neighbors.
 
@@ -92,11 +95,12 @@ cdef class Cluster(_PairCompute):
                 keys, shape=(num_query_points, ), dtype=np.uint32)
             l_keys_ptr = &l_keys[0]
 
-        self.thisptr.compute(
-            nq.get_ptr(),
-            nlist.get_ptr(),
-            dereference(qargs.thisptr),
-            l_keys_ptr)
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                nlist.get_ptr(),
+                dereference(qargs.thisptr),
+                l_keys_ptr)
         return self
 
     @_Compute._computed_property
@@ -119,6 +123,9 @@ cdef class Cluster(_PairCompute):
         cluster_keys = self.thisptr.getClusterKeys()
         return cluster_keys
 
+    def _supports_half_neighbors(self):
+        return True
+
     def __repr__(self):
         return "freud.cluster.{cls}()".format(cls=type(self).__name__)
 
@@ -157,12 +164,16 @@ cdef class ClusterProperties(_Compute):
 
      - Center of mass
      - Gyration tensor
+     - Radius of gyration
+     - Moment of inertia tensor
      - Size (number of points)
 
     The center of mass for each cluster (properly handling periodic boundary
     conditions) can be accessed with :code:`centers` attribute.  The :math:`3
     \times 3` symmetric gyration tensors :math:`G` can be accessed with
-    :code:`gyrations` attribute.
+    :code:`gyrations` attribute. All properties are computed in parallel in
+    two passes over the points, and the number of clusters of each size is
+    available as :code:`size_histogram`.
     """
 
     cdef freud._cluster.ClusterProperties * thisptr
@@ -207,9 +218,10 @@ cdef class ClusterProperties(_Compute):
         cluster_idx = freud.util._convert_array(
             cluster_idx, shape=(nq.points.shape[0], ), dtype=np.uint32)
         cdef const unsigned int[::1] l_cluster_idx = cluster_idx
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <unsigned int*> &l_cluster_idx[0])
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <unsigned int*> &l_cluster_idx[0])
         return self
 
     @_Compute._computed_property
@@ -232,7 +244,19 @@ cdef class ClusterProperties(_Compute):
     def radii_of_gyration(self):
         """(:math:`N_{clusters}`,) :class:`numpy.ndarray`: The radius of
         gyration of each cluster."""
-        return np.sqrt(np.trace(self.gyrations, axis1=-2, axis2=-1))
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterRadiiOfGyration(),
+            freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def inertia_tensors(self):
+        R"""(:math:`N_{clusters}`, 3, 3) :class:`numpy.ndarray`: The moment of
+        inertia tensors of the clusters about their centers of mass, for
+        points of unit mass, :math:`I = \sum_i \left(\left|\vec{r}_i
+        \right|^2 \mathbb{1} - \vec{r}_i \otimes \vec{r}_i \right)`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterInertiaTensors(),
+            freud.util.arr_type_t.FLOAT)
 
     @_Compute._computed_property
     def sizes(self):
@@ -241,5 +265,193 @@ cdef class ClusterProperties(_Compute):
             &self.thisptr.getClusterSizes(),
             freud.util.arr_type_t.UNSIGNED_INT)
 
+    @_Compute._computed_property
+    def size_histogram(self):
+        """(:math:`\\max(sizes) + 1`,) :class:`numpy.ndarray`: The number of
+        clusters of each size, starting from size zero."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterSizeHistogram(),
+            freud.util.arr_type_t.UNSIGNED_INT)
+
     def __repr__(self):
         return "freud.cluster.{cls}()".format(cls=type(self).__name__)
+
+
+cdef class ClusterTracker(_PairCompute):
+    R"""Tracks clusters across the frames of a trajectory.
+
+    Each call to :meth:`~.compute` finds the clusters of a frame like
+    :class:`~.Cluster` (or :meth:`~.track` accepts cluster indices computed
+    elsewhere, such as :attr:`freud.order.SolidLiquid.cluster_idx`) and
+    compares them to the clusters of the previous frame with the overlap
+    matrix, the number of points shared by each pair of clusters. Only the
+    nonzero entries of the overlap are counted, in parallel, so tracking is
+    linear in the number of points.
+
+    Each cluster gets a persistent id in :attr:`cluster_ids`. A cluster keeps
+    the id of the previous cluster it shares the most points with, if that
+    cluster also shares the most points with it. All other clusters get new
+    ids. Clusters with fewer than :code:`min_size` points are not tracked and
+    have an id of :code:`-1`.
+
+    The changes between frames are listed in :attr:`events` as rows of
+    (event type, previous id, current id):
+
+     - :attr:`BIRTH`: a cluster sharing no points with the tracked clusters
+       of the previous frame. The previous id is :code:`-1`.
+     - :attr:`DEATH`: a previous cluster sharing no points with the tracked
+       clusters of the frame. The current id is :code:`-1`.
+     - :attr:`MERGE`: one row for each of several previous clusters sharing
+       points with the same cluster.
+     - :attr:`SPLIT`: one row for each of several clusters sharing points
+       with the same previous cluster.
+
+    The number of points must be the same in all frames, and points must be
+    in the same order.
+
+    Args:
+        min_size (unsigned int, optional):
+            Minimum number of points of tracked clusters.
+            (Default value = :code:`1`).
+    """
+    cdef freud._cluster.ClusterTracker * thisptr
+
+    BIRTH = 0
+    DEATH = 1
+    MERGE = 2
+    SPLIT = 3
+
+    def __cinit__(self, min_size=1):
+        self.thisptr = new freud._cluster.ClusterTracker(min_size)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, neighbors=None):
+        R"""Find the clusters of a frame and track them from the previous
+        frame.
+
+        Example::
+            >>> box, points = freud.data.make_random_system(10, 100, seed=0)
+            >>> tracker = freud.cluster.ClusterTracker(min_size=2)
+            >>> tracker.compute((box, points), neighbors={'r_max': 1.0})
+            freud.cluster.ClusterTracker(min_size=2)
+            >>> points += 0.1
+            >>> tracker.compute((box, points), neighbors={'r_max': 1.0})
+            freud.cluster.ClusterTracker(min_size=2)
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+                Either a :class:`NeighborList <freud.locality.NeighborList>` of
+                neighbor pairs to use in the calculation, or a dictionary of
+                `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                (Default value: None).
+        """
+        cdef:
+            freud.locality.NeighborQuery nq
+            freud.locality.NeighborList nlist
+            freud.locality._QueryArgs qargs
+            const float[:, ::1] l_query_points
+            unsigned int num_query_points
+
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, neighbors=neighbors)
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr))
+        return self
+
+    def track(self, cluster_idx):
+        R"""Track the clusters of a frame from given cluster indices.
+
+        Args:
+            cluster_idx ((:math:`N_{points}`,) :class:`numpy.ndarray`):
+                Cluster index of each point, numbered contiguously from zero.
+        """
+        cluster_idx = freud.util._convert_array(
+            cluster_idx, shape=(None, ), dtype=np.uint32)
+        cdef const unsigned int[::1] l_cluster_idx = cluster_idx
+        cdef unsigned int num_points = l_cluster_idx.shape[0]
+        cdef const unsigned int* cluster_idx_ptr = NULL
+        if num_points > 0:
+            cluster_idx_ptr = &l_cluster_idx[0]
+        with nogil:
+            self.thisptr.track(cluster_idx_ptr, num_points)
+        self._called_compute = True
+        return self
+
+    def reset(self):
+        R"""Forget all previous frames and persistent ids."""
+        self.thisptr.reset()
+        self._called_compute = False
+
+    @staticmethod
+    def _signed(array):
+        # Untracked clusters and missing ids are stored as the largest
+        # unsigned integer, and reported as -1.
+        result = np.asarray(array, dtype=np.int64)
+        result[array == np.iinfo(np.uint32).max] = -1
+        return result
+
+    @_Compute._computed_property
+    def num_clusters(self):
+        """int: The number of clusters of the last frame."""
+        return self.thisptr.getNumClusters()
+
+    @_Compute._computed_property
+    def cluster_idx(self):
+        """(:math:`N_{points}`) :class:`numpy.ndarray`: The cluster index of
+        each point in the last frame."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterIdx(),
+            freud.util.arr_type_t.UNSIGNED_INT)
+
+    @_Compute._computed_property
+    def cluster_ids(self):
+        """(:math:`N_{clusters}`) :class:`numpy.ndarray`: The persistent id of
+        each cluster of the last frame, or :code:`-1` for clusters with fewer
+        than :code:`min_size` points."""
+        return self._signed(freud.util.make_managed_numpy_array(
+            &self.thisptr.getClusterIds(),
+            freud.util.arr_type_t.UNSIGNED_INT))
+
+    @_Compute._computed_property
+    def overlap(self):
+        """(:math:`N_{overlaps}`, 3) :class:`numpy.ndarray`: The nonzero
+        entries of the overlap matrix between the tracked clusters of the
+        previous and last frames, as rows of (previous cluster index, cluster
+        index, number of shared points), sorted by previous cluster index."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getOverlap(),
+            freud.util.arr_type_t.UNSIGNED_INT)
+
+    @_Compute._computed_property
+    def events(self):
+        """(:math:`N_{events}`, 3) :class:`numpy.ndarray`: The events of the
+        last frame, as rows of (event type, previous id, current id)."""
+        return self._signed(freud.util.make_managed_numpy_array(
+            &self.thisptr.getEvents(),
+            freud.util.arr_type_t.UNSIGNED_INT))
+
+    @property
+    def num_frames(self):
+        """int: The number of frames tracked since the last reset."""
+        return self.thisptr.getNumFrames()
+
+    @property
+    def num_ids(self):
+        """int: The number of persistent ids assigned since the last reset."""
+        return self.thisptr.getNumIds()
+
+    @property
+    def min_size(self):
+        """unsigned int: Minimum number of points of tracked clusters."""
+        return self.thisptr.getMinSize()
+
+    def __repr__(self):
+        return "freud.cluster.{cls}(min_size={min_size})".format(
+            cls=type(self).__name__, min_size=self.min_size)
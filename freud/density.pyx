@@ -15,10 +15,15 @@ from cython.operator cimport dereference
 from freud.util cimport _Compute
 from freud.locality cimport _PairCompute, _SpatialHistogram1D
 from freud.util cimport vec3
+from libcpp cimport bool as cbool
+from libcpp.memory cimport shared_ptr
+from libcpp.vector cimport vector
 
 from collections.abc import Sequence
 
 cimport freud._density
+cimport freud._locality
+cimport freud._util
 cimport freud.box
 cimport freud.locality
 cimport freud.util
@@ -28,8 +33,25 @@ cimport numpy as np
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 ctypedef unsigned int uint
 
+_GAUSSIAN_DENSITY_ENGINES = {
+    'auto': freud._density.gaussian_auto,
+    'direct': freud._density.gaussian_direct,
+    'separable': freud._density.gaussian_separable,
+    'fft': freud._density.gaussian_fft}
+
+_MASS_ASSIGNMENTS = {
+    'cic': freud._density.assignment_cic,
+    'tsc': freud._density.assignment_tsc}
+
+_CORRELATION_ENGINES = {
+    'direct': freud._density.correlation_direct,
+    'fft': freud._density.correlation_fft}
+
 cdef class CorrelationFunction(_SpatialHistogram1D):
     R"""Computes the complex pairwise correlation function.
 
@@ -54,23 +76,186 @@ cdef class CorrelationFunction(_SpatialHistogram1D):
         :code:`None`, we omit accumulating the self-correlation value in the
         first bin.
 
+    .. note::
+        **Precision:** The values are correlated and accumulated in the type
+        given by :code:`dtype`. Real types are faster and use half the memory
+        of complex types, and single precision types halve them again, at the
+        cost of rounding errors growing with the number of bonds in each bin.
+
+    .. note::
+        **Long-range correlations:** The default :code:`'direct'`
+        :attr:`engine` sums the product of the values of every bond within
+        :code:`r_max`, which becomes prohibitively slow when :code:`r_max` is
+        a large fraction of the box. The :code:`'fft'` engine instead assigns
+        the values and points to a periodic grid of :attr:`grid_width` cells
+        with the scheme selected by :attr:`assignment`, correlates the grids
+        with fast Fourier transforms, and bins the correlation of each offset
+        between cells by its length. The assignment window is divided out,
+        and the pairs of each point with itself are removed when
+        :code:`exclude_ii` is set, so the result matches the direct engine up
+        to errors on the scale of a grid cell. The bin counts are the
+        expected numbers of pairs, rounded to integers. This engine requires
+        a periodic box and ball query arguments without a
+        :class:`NeighborList <freud.locality.NeighborList>`.
+
     Args:
         bins (unsigned int):
             The number of bins in the RDF.
         r_max (float):
             Maximum pointwise distance to include in the calculation.
+        dtype (:class:`numpy.dtype`, optional):
+            Type of the values and of the correlation function, one of
+            :code:`numpy.complex128`, :code:`numpy.complex64`,
+            :code:`numpy.float64`, or :code:`numpy.float32`. Complex values
+            are rejected if the type is real (Default value =
+            :code:`numpy.complex128`).
     """  # noqa E501
     cdef freud._density.CorrelationFunction[np.complex128_t] * thisptr
+    cdef freud._density.CorrelationFunction[np.complex64_t] * complex64ptr
+    cdef freud._density.CorrelationFunction[np.float64_t] * float64ptr
+    cdef freud._density.CorrelationFunction[np.float32_t] * float32ptr
     cdef is_complex
-
-    def __cinit__(self, unsigned int bins, float r_max):
-        self.thisptr = self.histptr = new \
-            freud._density.CorrelationFunction[np.complex128_t](bins, r_max)
+    cdef object _dtype
+    cdef str _engine
+    cdef str _assignment
+    cdef object _grid_width
+
+    def __cinit__(self, unsigned int bins, float r_max, dtype=np.complex128):
+        self._dtype = np.dtype(dtype)
+        if self._dtype == np.complex128:
+            self.thisptr = new \
+                freud._density.CorrelationFunction[np.complex128_t](
+                    bins, r_max)
+            self.histptr = self.thisptr
+        elif self._dtype == np.complex64:
+            self.complex64ptr = new \
+                freud._density.CorrelationFunction[np.complex64_t](
+                    bins, r_max)
+            self.histptr = self.complex64ptr
+        elif self._dtype == np.float64:
+            self.float64ptr = new \
+                freud._density.CorrelationFunction[np.float64_t](bins, r_max)
+            self.histptr = self.float64ptr
+        elif self._dtype == np.float32:
+            self.float32ptr = new \
+                freud._density.CorrelationFunction[np.float32_t](bins, r_max)
+            self.histptr = self.float32ptr
+        else:
+            raise ValueError(
+                "The dtype must be one of complex128, complex64, float64, or "
+                "float32.")
         self.r_max = r_max
         self.is_complex = False
+        self._engine = 'direct'
+        self._assignment = 'cic'
+        self._grid_width = None
 
     def __dealloc__(self):
         del self.thisptr
+        del self.complex64ptr
+        del self.float64ptr
+        del self.float32ptr
+
+    @property
+    def dtype(self):
+        """:class:`numpy.dtype`: Type of the values and of the correlation
+        function."""
+        return self._dtype
+
+    def _set_grid_options(self, engine, grid_width, assignment):
+        cdef freud._density.CorrelationEngine l_engine = \
+            _CORRELATION_ENGINES[engine]
+        cdef freud._density.MassAssignment l_assignment = \
+            _MASS_ASSIGNMENTS[assignment]
+        cdef vec3[uint] l_width
+        if grid_width is not None:
+            l_width = vec3[uint](grid_width[0], grid_width[1], grid_width[2])
+        if self.thisptr != NULL:
+            self.thisptr.setEngine(l_engine)
+            self.thisptr.setGridWidth(l_width)
+            self.thisptr.setMassAssignment(l_assignment)
+        elif self.complex64ptr != NULL:
+            self.complex64ptr.setEngine(l_engine)
+            self.complex64ptr.setGridWidth(l_width)
+            self.complex64ptr.setMassAssignment(l_assignment)
+        elif self.float64ptr != NULL:
+            self.float64ptr.setEngine(l_engine)
+            self.float64ptr.setGridWidth(l_width)
+            self.float64ptr.setMassAssignment(l_assignment)
+        else:
+            self.float32ptr.setEngine(l_engine)
+            self.float32ptr.setGridWidth(l_width)
+            self.float32ptr.setMassAssignment(l_assignment)
+        self._engine = engine
+        self._grid_width = grid_width
+        self._assignment = assignment
+
+    @property
+    def engine(self):
+        """str: The algorithm used to accumulate the correlation function,
+        either :code:`'direct'` (the default), which sums over every bond, or
+        :code:`'fft'`, which correlates values assigned to a grid."""
+        return self._engine
+
+    @engine.setter
+    def engine(self, engine):
+        if engine not in _CORRELATION_ENGINES:
+            raise ValueError(
+                "Unknown engine: {}. Options are {}.".format(
+                    engine, ", ".join(_CORRELATION_ENGINES)))
+        self._set_grid_options(engine, self._grid_width, self._assignment)
+
+    @property
+    def grid_width(self):
+        """tuple or None: The number of grid cells along each axis used by
+        the :code:`'fft'` engine. It may be set to an integer for all axes or
+        a sequence of 2 or 3 integers. If :code:`None` (the default), the
+        grid has one cell per bin width along each axis. The z axis of 2D
+        boxes always has a single cell."""
+        return self._grid_width
+
+    @grid_width.setter
+    def grid_width(self, grid_width):
+        if grid_width is not None:
+            if np.isscalar(grid_width):
+                grid_width = (grid_width, grid_width, grid_width)
+            elif len(grid_width) == 2:
+                grid_width = (grid_width[0], grid_width[1], 1)
+            grid_width = tuple(int(w) for w in grid_width)
+            if len(grid_width) != 3 or any(w < 1 for w in grid_width):
+                raise ValueError("The grid width must be 1, 2, or 3 positive "
+                                 "integers.")
+        self._set_grid_options(self._engine, grid_width, self._assignment)
+
+    @property
+    def assignment(self):
+        """str: The scheme used by the :code:`'fft'` engine to assign values
+        to the grid, either :code:`'cic'` (cloud in cell, the default) or
+        :code:`'tsc'` (triangular shaped cloud), as in
+        :attr:`GaussianDensity.assignment`."""
+        return self._assignment
+
+    @assignment.setter
+    def assignment(self, assignment):
+        if assignment not in _MASS_ASSIGNMENTS:
+            raise ValueError(
+                "Unknown assignment: {}. Options are {}.".format(
+                    assignment, ", ".join(_MASS_ASSIGNMENTS)))
+        self._set_grid_options(self._engine, self._grid_width, assignment)
+
+    def _convert_values(self, values, shape):
+        # Complex values cannot be correlated in a real type, and would
+        # otherwise lose their imaginary parts silently.
+        if self._dtype.kind != 'c' and np.iscomplexobj(values) and \
+                np.any(np.iscomplex(values)):
+            raise ValueError(
+                "Complex values require a complex dtype, but the dtype of "
+                "this CorrelationFunction is {}.".format(self._dtype.name))
+        self.is_complex = self.is_complex or (
+            self._dtype.kind == 'c' and np.any(np.iscomplex(values)))
+        return freud.util._convert_array(
+            np.real(values) if self._dtype.kind != 'c' else values,
+            shape=shape, dtype=self._dtype)
 
     def compute(self, system, values, query_points=None,
                 query_values=None, neighbors=None, reset=True):
@@ -118,42 +303,183 @@ cdef class CorrelationFunction(_SpatialHistogram1D):
             self._preprocess_arguments(system, query_points, neighbors)
 
         # Save if any inputs have been complex so far.
-        self.is_complex = self.is_complex or np.any(np.iscomplex(values)) or \
-            np.any(np.iscomplex(query_values))
-
-        values = freud.util._convert_array(
-            values, shape=(nq.points.shape[0], ), dtype=np.complex128)
+        values = self._convert_values(values, (nq.points.shape[0], ))
         if query_values is None:
             query_values = values
         else:
-            query_values = freud.util._convert_array(
-                query_values, shape=(l_query_points.shape[0], ),
-                dtype=np.complex128)
-
-        cdef np.complex128_t[::1] l_values = values
-        cdef np.complex128_t[::1] l_query_values = query_values
-
-        self.thisptr.accumulate(
-            nq.get_ptr(),
-            <np.complex128_t*> &l_values[0],
-            <vec3[float]*> &l_query_points[0, 0],
-            <np.complex128_t*> &l_query_values[0],
-            num_query_points, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+            query_values = self._convert_values(
+                query_values, (l_query_points.shape[0], ))
+
+        cdef:
+            const np.complex128_t[::1] l_complex128_values
+            const np.complex128_t[::1] l_complex128_query_values
+            const np.complex64_t[::1] l_complex64_values
+            const np.complex64_t[::1] l_complex64_query_values
+            const np.float64_t[::1] l_float64_values
+            const np.float64_t[::1] l_float64_query_values
+            const np.float32_t[::1] l_float32_values
+            const np.float32_t[::1] l_float32_query_values
+
+        if self.thisptr != NULL:
+            l_complex128_values = values
+            l_complex128_query_values = query_values
+            with nogil:
+                self.thisptr.accumulate(
+                    nq.get_ptr(), &l_complex128_values[0],
+                    <vec3[float]*> &l_query_points[0, 0],
+                    &l_complex128_query_values[0], num_query_points,
+                    nlist.get_ptr(), dereference(qargs.thisptr))
+        elif self.complex64ptr != NULL:
+            l_complex64_values = values
+            l_complex64_query_values = query_values
+            with nogil:
+                self.complex64ptr.accumulate(
+                    nq.get_ptr(), &l_complex64_values[0],
+                    <vec3[float]*> &l_query_points[0, 0],
+                    &l_complex64_query_values[0], num_query_points,
+                    nlist.get_ptr(), dereference(qargs.thisptr))
+        elif self.float64ptr != NULL:
+            l_float64_values = values
+            l_float64_query_values = query_values
+            with nogil:
+                self.float64ptr.accumulate(
+                    nq.get_ptr(), &l_float64_values[0],
+                    <vec3[float]*> &l_query_points[0, 0],
+                    &l_float64_query_values[0], num_query_points,
+                    nlist.get_ptr(), dereference(qargs.thisptr))
+        else:
+            l_float32_values = values
+            l_float32_query_values = query_values
+            with nogil:
+                self.float32ptr.accumulate(
+                    nq.get_ptr(), &l_float32_values[0],
+                    <vec3[float]*> &l_query_points[0, 0],
+                    &l_float32_query_values[0], num_query_points,
+                    nlist.get_ptr(), dereference(qargs.thisptr))
+        return self
+
+    def compute_trajectory(self, boxes, points, values, neighbors=None,
+                           reset=True, parallel_frames=False):
+        R"""Calculates the correlation function of all frames of a trajectory
+        and adds them to the current histogram.
+
+        This is equivalent to calling :meth:`~.compute` with
+        :code:`reset=False` for each frame, but all frames are accumulated in
+        a single call, and the neighbor query of each frame is built while
+        the previous frame is accumulated. The values of each frame are
+        correlated with themselves.
+
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame, which are also used as query
+                points. The array is not copied if it contains 32-bit floats,
+                so it may be memory-mapped.
+            values ((:math:`N_{frames}`, :math:`N_{points}`) :class:`numpy.ndarray`):
+                Values associated with the points of each frame.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the bonds of each frame (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            parallel_frames (bool, optional):
+                If True, frames are accumulated concurrently, each by a single
+                thread with its own neighbor query. This is faster for many
+                frames of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa E501
+        if reset:
+            self.is_complex = False
+            self._reset()
+
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        values = self._convert_values(
+            values, (trajectory.n_frames, trajectory.n_points))
+        cdef:
+            const np.complex128_t[:, ::1] l_complex128_values
+            const np.complex64_t[:, ::1] l_complex64_values
+            const np.float64_t[:, ::1] l_float64_values
+            const np.float32_t[:, ::1] l_float32_values
+            bint l_parallel_frames = parallel_frames
+
+        if self.thisptr != NULL:
+            l_complex128_values = values
+            with nogil:
+                self.thisptr.accumulateTrajectory(
+                    dereference(trajectory.thisptr),
+                    &l_complex128_values[0, 0],
+                    dereference(qargs.thisptr), l_parallel_frames)
+        elif self.complex64ptr != NULL:
+            l_complex64_values = values
+            with nogil:
+                self.complex64ptr.accumulateTrajectory(
+                    dereference(trajectory.thisptr),
+                    &l_complex64_values[0, 0],
+                    dereference(qargs.thisptr), l_parallel_frames)
+        elif self.float64ptr != NULL:
+            l_float64_values = values
+            with nogil:
+                self.float64ptr.accumulateTrajectory(
+                    dereference(trajectory.thisptr), &l_float64_values[0, 0],
+                    dereference(qargs.thisptr), l_parallel_frames)
+        else:
+            l_float32_values = values
+            with nogil:
+                self.float32ptr.accumulateTrajectory(
+                    dereference(trajectory.thisptr), &l_float32_values[0, 0],
+                    dereference(qargs.thisptr), l_parallel_frames)
         return self
 
     @_Compute._computed_property
     def correlation(self):
         """(:math:`N_{bins}`) :class:`numpy.ndarray`: Expected (average)
         product of all values at a given radial distance."""
-        output = freud.util.make_managed_numpy_array(
-            &self.thisptr.getCorrelation(),
-            freud.util.arr_type_t.COMPLEX_DOUBLE)
+        if self.thisptr != NULL:
+            output = freud.util.make_managed_numpy_array(
+                &self.thisptr.getCorrelation(),
+                freud.util.arr_type_t.COMPLEX_DOUBLE)
+        elif self.complex64ptr != NULL:
+            output = freud.util.make_managed_numpy_array(
+                &self.complex64ptr.getCorrelation(),
+                freud.util.arr_type_t.COMPLEX_FLOAT)
+        elif self.float64ptr != NULL:
+            return freud.util.make_managed_numpy_array(
+                &self.float64ptr.getCorrelation(),
+                freud.util.arr_type_t.DOUBLE)
+        else:
+            return freud.util.make_managed_numpy_array(
+                &self.float32ptr.getCorrelation(),
+                freud.util.arr_type_t.FLOAT)
         return output if self.is_complex else np.real(output)
 
+    def _load_state(self, data, merge):
+        was_complex = merge and self.is_complex
+        _SpatialHistogram1D._load_state(self, data, merge)
+        # States of complex values are recognized by the imaginary parts of
+        # their correlation.
+        self.is_complex = self._dtype.kind == 'c'
+        self.is_complex = was_complex or (
+            self.is_complex and np.any(np.iscomplex(self.correlation)))
+
+    def _supports_half_neighbors(self):
+        return True
+
     def __repr__(self):
-        return ("freud.density.{cls}(bins={bins}, r_max={r_max})").format(
-            cls=type(self).__name__, bins=self.nbins, r_max=self.r_max)
+        dtype = "" if self._dtype == np.complex128 else \
+            ", dtype='{}'".format(self._dtype.name)
+        return ("freud.density.{cls}(bins={bins}, r_max={r_max}{dtype})"
+                ).format(cls=type(self).__name__, bins=self.nbins,
+                         r_max=self.r_max, dtype=dtype)
 
     def plot(self, ax=None):
         """Plot complex correlation function.
@@ -193,6 +519,17 @@ cdef class GaussianDensity(_Compute):
     dimensions of the grid are set in the constructor, and can either be set
     equally for all dimensions or for each dimension independently.
 
+    The density can be evaluated with several engines, selected with
+    :attr:`engine`. The :code:`'direct'` engine evaluates the Gaussian of each
+    point at every grid cell within :code:`r_max`. The :code:`'separable'`
+    engine gives the same result for boxes without tilt while only evaluating
+    exponentials along each axis. The :code:`'fft'` engine assigns the points
+    to the grid with the scheme selected by :attr:`assignment` and convolves
+    the grid with the Gaussian using fast Fourier transforms, so its cost does
+    not grow with the number of grid cells within :code:`r_max`. It requires
+    a periodic box and approximates each point by its assignment to the
+    nearest grid cells, which smooths the density on the scale of a cell.
+
     Args:
         width (int or Sequence[int]):
             The number of bins to make the grid in each dimension (identical
@@ -203,6 +540,7 @@ cdef class GaussianDensity(_Compute):
             Sigma parameter for Gaussian.
     """  # noqa: E501
     cdef freud._density.GaussianDensity * thisptr
+    cdef object _density_buffer
 
     def __cinit__(self, width, r_max, sigma):
         cdef vec3[uint] width_vector
@@ -228,23 +566,48 @@ cdef class GaussianDensity(_Compute):
         """:class:`freud.box.Box`: Box used in the calculation."""
         return freud.box.BoxFromCPP(self.thisptr.getBox())
 
-    def compute(self, system):
+    def compute(self, system, out=None):
         R"""Calculates the Gaussian blur for the specified points.
 
         Args:
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
+            out (:class:`numpy.ndarray`, optional):
+                C-contiguous, writeable :class:`numpy.float32` array with the
+                shape of :attr:`density`, into which the density is written
+                instead of a newly allocated array. Passing the same array on
+                every frame avoids allocating a new grid for each compute, and
+                a :class:`numpy.memmap` writes the density to a file. The
+                array becomes :attr:`density` (Default value = :code:`None`).
         """
         cdef freud.locality.NeighborQuery nq = \
             freud.locality.NeighborQuery.from_system(system)
-        self.thisptr.compute(nq.get_ptr())
+        cdef float[::1] density_buffer
+        cdef vec3[uint] width = self.thisptr.getWidth()
+        if out is None:
+            self._density_buffer = None
+            with nogil:
+                self.thisptr.compute(nq.get_ptr(), NULL)
+            return self
+
+        shape = (width.x, width.y) if nq.box.is2D else \
+            (width.x, width.y, width.z)
+        out = freud.util._check_output_buffer(out, shape, np.float32)
+        density_buffer = out.reshape(-1)
+        # Keep the buffer alive while the C++ object refers to it.
+        self._density_buffer = out
+        with nogil:
+            self.thisptr.compute(nq.get_ptr(), &density_buffer[0])
         return self
 
     @_Compute._computed_property
     def density(self):
         """(:math:`w_x`, :math:`w_y`, :math:`w_z`) :class:`numpy.ndarray`: The
-        grid with the Gaussian density contributions from each point."""
+        grid with the Gaussian density contributions from each point. This is
+        the output buffer passed to :meth:`compute`, if any."""
+        if self._density_buffer is not None:
+            return self._density_buffer
         if self.box.is2D:
             return np.squeeze(freud.util.make_managed_numpy_array(
                 &self.thisptr.getDensity(), freud.util.arr_type_t.FLOAT))
@@ -269,6 +632,61 @@ cdef class GaussianDensity(_Compute):
         cdef vec3[uint] width = self.thisptr.getWidth()
         return (width.x, width.y, width.z)
 
+    @property
+    def accumulation_strategy(self):
+        """str: How the density is accumulated in parallel, one of
+        :code:`'auto'`, :code:`'thread_local'`, :code:`'tiled'`,
+        :code:`'atomic'` or :code:`'sparse'`. The default :code:`'auto'` keeps
+        a copy of the grid on each thread unless the copies would use too
+        much memory, in which case tiles of the grid are only allocated on
+        the threads that write to them."""
+        return freud.util._accumulation_strategy_name(
+            self.thisptr.getAccumulationStrategy())
+
+    @accumulation_strategy.setter
+    def accumulation_strategy(self, strategy):
+        self.thisptr.setAccumulationStrategy(
+            freud.util._convert_accumulation_strategy(strategy))
+
+    @property
+    def engine(self):
+        """str: The algorithm used to evaluate the density, one of
+        :code:`'auto'`, :code:`'direct'`, :code:`'separable'` or
+        :code:`'fft'`. The default :code:`'auto'` uses :code:`'separable'`
+        for boxes without tilt and :code:`'direct'` otherwise."""
+        for key, value in _GAUSSIAN_DENSITY_ENGINES.items():
+            if value == self.thisptr.getEngine():
+                return key
+
+    @engine.setter
+    def engine(self, engine):
+        try:
+            self.thisptr.setEngine(_GAUSSIAN_DENSITY_ENGINES[engine])
+        except KeyError:
+            raise ValueError(
+                "Unknown engine: {}. Options are {}.".format(
+                    engine, ", ".join(_GAUSSIAN_DENSITY_ENGINES)))
+
+    @property
+    def assignment(self):
+        """str: The scheme used by the :code:`'fft'` engine to assign points
+        to the grid, either :code:`'cic'` (cloud in cell, the default), which
+        spreads each point over the 2 nearest cells along each axis, or
+        :code:`'tsc'` (triangular shaped cloud), which spreads each point
+        smoothly over the 3 nearest cells."""
+        for key, value in _MASS_ASSIGNMENTS.items():
+            if value == self.thisptr.getMassAssignment():
+                return key
+
+    @assignment.setter
+    def assignment(self, assignment):
+        try:
+            self.thisptr.setMassAssignment(_MASS_ASSIGNMENTS[assignment])
+        except KeyError:
+            raise ValueError(
+                "Unknown assignment: {}. Options are {}.".format(
+                    assignment, ", ".join(_MASS_ASSIGNMENTS)))
+
     def __repr__(self):
         return ("freud.density.{cls}({width}, "
                 "{r_max}, {sigma})").format(cls=type(self).__name__,
@@ -310,6 +728,10 @@ cdef class SphereVoxelization(_Compute):
     either be set equally for all dimensions or for each dimension
     independently.
 
+    Large grids can be stored with one bit per voxel by setting
+    :attr:`packed` to :code:`True` before computing, which is available as
+    :attr:`packed_voxels` without ever allocating the unpacked grid.
+
     Args:
         width (int or Sequence[int]):
             The number of bins to make the grid in each dimension (identical
@@ -353,13 +775,21 @@ cdef class SphereVoxelization(_Compute):
         """
         cdef freud.locality.NeighborQuery nq = \
             freud.locality.NeighborQuery.from_system(system)
-        self.thisptr.compute(nq.get_ptr())
+        with nogil:
+            self.thisptr.compute(nq.get_ptr())
         return self
 
     @_Compute._computed_property
     def voxels(self):
         """(:math:`w_x`, :math:`w_y`, :math:`w_z`) :class:`numpy.ndarray`: The
-        voxel grid indicating overlap with the computed spheres."""
+        voxel grid indicating overlap with the computed spheres. In packed
+        mode, this unpacks a copy of :attr:`packed_voxels`."""
+        # Only the array of the mode used by the last compute is allocated.
+        if self.thisptr.getPackedVoxels().size() > 0:
+            width = self.width
+            count = width[1] if self.box.is2D else width[2]
+            return np.unpackbits(self.packed_voxels, axis=-1)[
+                ..., :count].astype(np.uint32)
         data = freud.util.make_managed_numpy_array(
             &self.thisptr.getVoxels(), freud.util.arr_type_t.UNSIGNED_INT)
         if self.box.is2D:
@@ -367,6 +797,29 @@ cdef class SphereVoxelization(_Compute):
         else:
             return data
 
+    @_Compute._computed_property
+    def packed_voxels(self):
+        """:class:`numpy.ndarray`: The voxel grid with eight voxels per byte,
+        packed along the last axis of :attr:`voxels` in the layout of
+        :func:`numpy.packbits`. If :attr:`packed` was :code:`False` during the
+        last compute, this packs a copy of :attr:`voxels`."""
+        if self.thisptr.getPackedVoxels().size() == 0:
+            return np.packbits(self.voxels.astype(np.uint8), axis=-1)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPackedVoxels(),
+            freud.util.arr_type_t.UNSIGNED_CHAR)
+
+    @property
+    def packed(self):
+        """bool: Whether the voxels are computed and stored with one bit per
+        voxel, using 32 times less memory than the unpacked grid (Default
+        value = :code:`False`)."""
+        return self.thisptr.isPacked()
+
+    @packed.setter
+    def packed(self, packed):
+        self.thisptr.setPacked(packed)
+
     @property
     def r_max(self):
         """float: Sphere radius used for voxelization."""
@@ -436,24 +889,37 @@ cdef class LocalDensity(_PairCompute):
 
     .. image:: images/density.png
 
+    The density can be computed for several values of :code:`r_max` at
+    once by providing a sequence of increasing values, which are all
+    computed from the neighbors within the largest :code:`r_max`. The
+    per-point outputs then have one column per value of :code:`r_max`.
+
     Args:
-        r_max (float):
-            Maximum distance over which to calculate the density.
+        r_max (float or sequence of float):
+            Maximum distance over which to calculate the density, or a
+            sequence of increasing maximum distances.
         diameter (float):
             Diameter of particle circumsphere.
     """
     cdef freud._density.LocalDensity * thisptr
+    cdef cbool _scalar_r_max
 
-    def __cinit__(self, float r_max, float diameter):
-        self.thisptr = new freud._density.LocalDensity(r_max, diameter)
+    def __cinit__(self, r_max, float diameter):
+        self._scalar_r_max = np.ndim(r_max) == 0
+        cdef vector[float] r_max_values = np.atleast_1d(r_max).tolist()
+        self.thisptr = new freud._density.LocalDensity(
+            r_max_values, diameter)
 
     def __dealloc__(self):
         del self.thisptr
 
     @property
     def r_max(self):
-        """float: Maximum distance over which to calculate the density."""
-        return self.thisptr.getRMax()
+        """float or list: Maximum distance over which to calculate the
+        density, or the list of maximum distances if a sequence was
+        provided."""
+        r_max_values = self.thisptr.getRMaxs()
+        return r_max_values[0] if self._scalar_r_max else list(r_max_values)
 
     @property
     def diameter(self):
@@ -500,35 +966,88 @@ cdef class LocalDensity(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, query_points, neighbors)
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <vec3[float]*> &l_query_points[0, 0],
-            num_query_points, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
         return self
 
+    @property
+    def partitioner(self):
+        """str: How query points are split among threads, one of
+        :code:`'auto'`, :code:`'simple'`, :code:`'static'`, :code:`'affinity'`
+        or :code:`'balanced'`. The :code:`'balanced'` partitioner uses the
+        neighbor counts of the :class:`freud.locality.NeighborList` passed to
+        :meth:`compute` to give every block of work a similar number of
+        bonds, which helps when the numbers of neighbors are very uneven.
+        (Default value = :code:`'auto'`)."""
+        return freud.util._partitioner_name(
+            self.thisptr.getLoopSchedule().getPartitioner())
+
+    @partitioner.setter
+    def partitioner(self, partitioner):
+        self.thisptr.setLoopSchedule(freud._util.LoopSchedule(
+            freud.util._convert_partitioner(partitioner),
+            self.thisptr.getLoopSchedule().getGrainSize()))
+
+    @property
+    def grain_size(self):
+        """int: Minimum number of query points in each block of work, or the
+        maximum for the :code:`'simple'` partitioner. (Default value =
+        :code:`1`)."""
+        return max(self.thisptr.getLoopSchedule().getGrainSize(), 1)
+
+    @grain_size.setter
+    def grain_size(self, grain_size):
+        if grain_size < 1:
+            raise ValueError("grain_size must be positive.")
+        self.thisptr.setLoopSchedule(freud._util.LoopSchedule(
+            self.thisptr.getLoopSchedule().getPartitioner(), grain_size))
+
     @property
     def default_query_args(self):
         """The default query arguments are
-        :code:`{'mode': 'ball', 'r_max': self.r_max + 0.5*self.diameter}`."""
+        :code:`{'mode': 'ball', 'r_max': max(self.r_max) +
+        0.5*self.diameter}`."""
         return dict(mode="ball",
-                    r_max=self.r_max + 0.5*self.diameter)
+                    r_max=self.thisptr.getRMax() + 0.5*self.diameter)
+
+    def _expand_r_max(self, array):
+        # A sequence of r_max values has one column per value, even if it
+        # has a single value.
+        if self._scalar_r_max:
+            return array
+        return array.reshape(-1, self.thisptr.getRMaxs().size())
 
     @_Compute._computed_property
     def density(self):
-        """(:math:`N_{points}`) :class:`numpy.ndarray`: Density of points per
-        query point."""
-        return freud.util.make_managed_numpy_array(
+        """(:math:`N_{points}`) or (:math:`N_{points}`, :math:`N_{r\\_max}`)
+        :class:`numpy.ndarray`: Density of points per query point, for each
+        value of :code:`r_max` if a sequence was provided."""
+        return self._expand_r_max(freud.util.make_managed_numpy_array(
             &self.thisptr.getDensity(),
-            freud.util.arr_type_t.FLOAT)
+            freud.util.arr_type_t.FLOAT))
 
     @_Compute._computed_property
     def num_neighbors(self):
-        """(:math:`N_{points}`) :class:`numpy.ndarray`: Number of neighbor
-        points for each query point."""
-        return freud.util.make_managed_numpy_array(
+        """(:math:`N_{points}`) or (:math:`N_{points}`, :math:`N_{r\\_max}`)
+        :class:`numpy.ndarray`: Number of neighbor points for each query
+        point, for each value of :code:`r_max` if a sequence was
+        provided."""
+        return self._expand_r_max(freud.util.make_managed_numpy_array(
             &self.thisptr.getNumNeighbors(),
-            freud.util.arr_type_t.FLOAT)
+            freud.util.arr_type_t.FLOAT))
+
+    cdef void _add_pipeline_stage(
+            self, freud._locality.NeighborPipeline *pipeline,
+            dict stage_arrays) except *:
+        pipeline.addStage(shared_ptr[freud._locality.NeighborPipelineStage](
+            new freud._density.LocalDensityPipelineStage(self.thisptr)))
+
+    def _supports_half_neighbors(self):
+        return True
 
     def __repr__(self):
         return ("freud.density.{cls}(r_max={r_max}, "
@@ -580,15 +1099,28 @@ cdef class RDF(_SpatialHistogram1D):
             arguments are provided to :meth:`~.compute`, specifically if
             :code:`exclude_ii` is set to :code:`False`. This normalization is
             not meaningful in such cases and will simply convolute the data.
-
+            Queries filtered to different ``point_type`` and
+            ``query_point_type`` find no bonds of points with themselves, so
+            their RDFs are not rescaled.
+        n_types (unsigned int, optional):
+            If provided, :meth:`~.compute` also accumulates the partial RDFs
+            of every pair of query point type and point type from the same
+            bonds as the total RDF, which requires the types of the points.
+            With :code:`normalize`, the point of each query point is excluded
+            from its own type. (Default value = :code:`None`).
+
+    Several RDFs with different bins or cutoffs can be computed from a
+    single neighbor traversal at the largest cutoff with a
+    :class:`freud.locality.NeighborPipeline`.
     """
     cdef freud._density.RDF * thisptr
 
     def __cinit__(self, unsigned int bins, float r_max, float r_min=0,
-                  normalize=False):
+                  normalize=False, n_types=None):
+        cdef unsigned int l_n_types = 0 if n_types is None else n_types
         if type(self) == RDF:
             self.thisptr = self.histptr = new freud._density.RDF(
-                bins, r_max, r_min, normalize)
+                bins, r_max, r_min, normalize, l_n_types)
 
             # r_max is left as an attribute rather than a property for now
             # since that change needs to happen at the _SpatialHistogram level
@@ -600,7 +1132,7 @@ cdef class RDF(_SpatialHistogram1D):
             del self.thisptr
 
     def compute(self, system, query_points=None, neighbors=None,
-                reset=True):
+                reset=True, point_types=None, query_point_types=None):
         R"""Calculates the RDF and adds to the current RDF histogram.
 
         Args:
@@ -621,6 +1153,13 @@ cdef class RDF(_SpatialHistogram1D):
                 Whether to erase the previously computed values before adding
                 the new computation; if False, will accumulate data (Default
                 value: True).
+            point_types ((:math:`N_{points}`,) :class:`numpy.ndarray`, optional):
+                Type of each point, from 0 to :code:`n_types - 1`. Required if
+                :code:`n_types` was provided (Default value = :code:`None`).
+            query_point_types ((:math:`N_{query\_points}`,) :class:`numpy.ndarray`, optional):
+                Type of each query point. Uses :code:`point_types` if
+                :code:`query_points` is :code:`None` (Default value =
+                :code:`None`).
         """  # noqa E501
         if reset:
             self._reset()
@@ -631,14 +1170,90 @@ cdef class RDF(_SpatialHistogram1D):
             freud.locality._QueryArgs qargs
             const float[:, ::1] l_query_points
             unsigned int num_query_points
+            const unsigned int[::1] l_point_types
+            const unsigned int[::1] l_query_point_types
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, query_points, neighbors)
 
-        self.thisptr.accumulate(
-            nq.get_ptr(),
-            <vec3[float]*> &l_query_points[0, 0],
-            num_query_points, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        if self.thisptr.getNumTypes() == 0:
+            if point_types is not None or query_point_types is not None:
+                raise ValueError(
+                    "Types can only be provided if n_types was provided.")
+            with nogil:
+                self.thisptr.accumulate(
+                    nq.get_ptr(),
+                    <vec3[float]*> &l_query_points[0, 0],
+                    num_query_points, nlist.get_ptr(),
+                    dereference(qargs.thisptr))
+            return self
+
+        if point_types is None:
+            raise ValueError("point_types must be provided to compute "
+                             "partial RDFs.")
+        if query_point_types is None:
+            if query_points is not None:
+                raise ValueError("query_point_types must be provided to "
+                                 "compute partial RDFs of query_points.")
+            query_point_types = point_types
+        l_point_types = freud.util._convert_array(
+            point_types, shape=(nq.points.shape[0], ), dtype=np.uint32)
+        l_query_point_types = freud.util._convert_array(
+            query_point_types, shape=(num_query_points, ), dtype=np.uint32)
+        with nogil:
+            self.thisptr.accumulate(
+                nq.get_ptr(), &l_point_types[0],
+                <vec3[float]*> &l_query_points[0, 0],
+                &l_query_point_types[0],
+                num_query_points, nlist.get_ptr(),
+                dereference(qargs.thisptr))
+        return self
+
+    def compute_trajectory(self, boxes, points, neighbors=None, reset=True,
+                           parallel_frames=False):
+        R"""Calculates the RDF of all frames of a trajectory and adds them to
+        the current RDF histogram.
+
+        This is equivalent to calling :meth:`~.compute` with
+        :code:`reset=False` for each frame, but all frames are accumulated in
+        a single call, and the neighbor query of each frame is built while
+        the previous frame is accumulated.
+
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame, which are also used as query
+                points. The array is not copied if it contains 32-bit floats,
+                so it may be memory-mapped.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the bonds of each frame (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            parallel_frames (bool, optional):
+                If True, frames are accumulated concurrently, each by a single
+                thread with its own neighbor query. This is faster for many
+                frames of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa E501
+        if reset:
+            self._reset()
+
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        cdef bint l_parallel_frames = parallel_frames
+        with nogil:
+            self.thisptr.accumulateTrajectory(
+                dereference(trajectory.thisptr), dereference(qargs.thisptr),
+                l_parallel_frames)
         return self
 
     @_Compute._computed_property
@@ -660,12 +1275,58 @@ cdef class RDF(_SpatialHistogram1D):
             &self.thisptr.getNr(),
             freud.util.arr_type_t.FLOAT)
 
+    @property
+    def n_types(self):
+        """unsigned int: Number of types of the partial RDFs, or
+        :code:`None` if they are not computed."""
+        n_types = self.thisptr.getNumTypes()
+        return n_types if n_types > 0 else None
+
+    @_Compute._computed_property
+    def partial_rdf(self):
+        """(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`)
+        :class:`numpy.ndarray`: Partial RDFs, indexed by query point type,
+        point type, and bin. Only available if :code:`n_types` was
+        provided."""
+        if self.n_types is None:
+            raise AttributeError(
+                "Partial RDFs are only computed if n_types is provided.")
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPartialRDF(),
+            freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def partial_n_r(self):
+        """(:math:`N_{types}`, :math:`N_{types}`, :math:`N_{bins}`)
+        :class:`numpy.ndarray`: :code:`partial_n_r[a, b, i]` is the average
+        number of points of type :code:`b` within a ball of radius
+        :code:`bin_edges[i+1]` centered at a query point of type
+        :code:`a`. Only available if :code:`n_types` was provided."""
+        if self.n_types is None:
+            raise AttributeError(
+                "Partial RDFs are only computed if n_types is provided.")
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPartialNr(),
+            freud.util.arr_type_t.FLOAT)
+
+    cdef void _add_pipeline_stage(
+            self, freud._locality.NeighborPipeline *pipeline,
+            dict stage_arrays) except *:
+        pipeline.addStage(shared_ptr[freud._locality.NeighborPipelineStage](
+            new freud._density.RDFPipelineStage(self.thisptr)))
+
+    def _supports_half_neighbors(self):
+        return True
+
     def __repr__(self):
+        n_types = ("" if self.n_types is None
+                   else ", n_types={}".format(self.n_types))
         return ("freud.density.{cls}(bins={bins}, r_max={r_max}, "
-                "r_min={r_min})").format(cls=type(self).__name__,
-                                         bins=len(self.bin_centers),
-                                         r_max=self.bounds[1],
-                                         r_min=self.bounds[0])
+                "r_min={r_min}{n_types})").format(cls=type(self).__name__,
+                                                  bins=len(self.bin_centers),
+                                                  r_max=self.bounds[1],
+                                                  r_min=self.bounds[0],
+                                                  n_types=n_types)
 
     def plot(self, ax=None):
         """Plot radial distribution function.
@@ -15,14 +15,20 @@ finalized in a future release.
 import freud.locality
 import logging
 import numpy as np
-import scipy.ndimage
 import rowan
 
+from cython.operator cimport dereference
 from libcpp cimport bool as cbool
-from freud.util cimport _Compute
+from freud.util cimport _Compute, vec3, quat
+cimport freud._diffraction
+cimport freud.box
+cimport freud.locality
 cimport freud.util
 cimport numpy as np
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 
 logger = logging.getLogger(__name__)
 
@@ -44,6 +50,12 @@ cdef class DiffractionPattern(_Compute):
     as a multiplication in Fourier space. The computed diffraction pattern
     can be accessed as a square array of shape ``(output_size, output_size)``.
 
+    The projection, binning, Fourier transform and zoom of the image are
+    computed in parallel in C++, reusing the transforms and buffers between
+    calls with the same grid size. Calling :meth:`~.compute` with
+    :code:`reset=False` averages the diffraction patterns of many view
+    orientations or frames.
+
     This method is based on the implementations in the open-source
     `GIXStapose application <https://github.com/cmelab/GIXStapose>`_ and its
     predecessor, diffractometer :cite:`Jankowski2017`.
@@ -55,22 +67,24 @@ cdef class DiffractionPattern(_Compute):
             Resolution of the output diffraction image, uses ``grid_size`` if
             not provided or ``None`` (Default value = :code:`None`).
     """
+    cdef freud._diffraction.DiffractionPattern * thisptr
     cdef int _grid_size
     cdef int _output_size
     cdef double[:] _k_values_orig
     cdef double[:, :, :] _k_vectors_orig
     cdef double[:] _k_values
     cdef double[:, :, :] _k_vectors
-    cdef double[:, :] _diffraction
     cdef double _box_matrix_scale_factor
     cdef double[:] _view_orientation
     cdef cbool _k_values_cached
     cdef cbool _k_vectors_cached
 
-    def __init__(self, grid_size=512, output_size=None):
+    def __cinit__(self, grid_size=512, output_size=None):
         self._grid_size = int(grid_size)
         self._output_size = int(grid_size) if output_size is None \
             else int(output_size)
+        self.thisptr = new freud._diffraction.DiffractionPattern(
+            self._output_size)
 
         # Cache these because they are system-independent.
         self._k_values_orig = np.empty(self.output_size)
@@ -80,7 +94,9 @@ cdef class DiffractionPattern(_Compute):
         # Store these computed arrays which are exposed as properties.
         self._k_values = np.empty_like(self._k_values_orig)
         self._k_vectors = np.empty_like(self._k_vectors_orig)
-        self._diffraction = np.empty((self.output_size, self.output_size))
+
+    def __dealloc__(self):
+        del self.thisptr
 
     def _calc_proj(self, view_orientation, box):
         """Calculate the inverse shear matrix from finding the projected box
@@ -122,12 +138,14 @@ cdef class DiffractionPattern(_Compute):
         inv_shear = np.linalg.inv(shear)
         return inv_shear
 
-    def _transform(self, img, box, inv_shear, zoom):
-        """Zoom, shear, and scale diffraction intensities.
+    def _transform_matrix(self, grid_size, box, inv_shear, zoom):
+        """Compute the matrix that zooms, shears, and scales diffraction
+        intensities.
 
         Args:
-            img ((``grid_size//zoom, grid_size//zoom``) :class:`numpy.ndarray`):
-                Array of diffraction intensities.
+            grid_size (int):
+                Resolution of the grid of diffraction intensities,
+                ``grid_size//zoom``.
             box (:class:`~.box.Box`):
                 Simulation box.
             inv_shear ((2, 2) :class:`numpy.ndarray`):
@@ -136,17 +154,18 @@ cdef class DiffractionPattern(_Compute):
                 Scaling factor for incident wavevectors.
 
         Returns:
-            (``output_size, output_size``) :class:`numpy.ndarray`:
-                Transformed array of diffraction intensities.
-        """  # noqa: E501
+            (3, 3) :class:`numpy.ndarray`:
+                Matrix in homogeneous coordinates mapping pixels of the output
+                image to coordinates of the grid of diffraction intensities.
+        """
 
         # The adjustments to roll and roll_shift ensure that the peak
         # corresponding to k=0 is located at exactly
         # (output_size//2, output_size//2), regardless of whether the grid_size
         # and output_size are odd or even.
 
-        roll = img.shape[0] / 2
-        if img.shape[0] % 2 == 1:
+        roll = grid_size / 2
+        if grid_size % 2 == 1:
             roll -= 0.5
 
         roll_shift = self.output_size / zoom / 2
@@ -174,16 +193,10 @@ cdef class DiffractionPattern(_Compute):
         # transforms 2D points and adds an offset.
         inverse_transform = np.linalg.inv(
             zoom_matrix @ shear_matrix @ shift_matrix)
+        return inverse_transform
 
-        img = scipy.ndimage.affine_transform(
-            input=img,
-            matrix=inverse_transform,
-            output_shape=(self.output_size, self.output_size),
-            order=1,
-            mode="constant")
-        return img
-
-    def compute(self, system, view_orientation=None, zoom=4, peak_width=1):
+    def compute(self, system, view_orientation=None, zoom=4, peak_width=1,
+                reset=True):
         R"""Computes diffraction pattern.
 
         Args:
@@ -198,8 +211,15 @@ cdef class DiffractionPattern(_Compute):
             peak_width (float):
                 Width of Gaussian convolved with points, in system length units
                 (Default value = 1).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, :attr:`diffraction` is the
+                average over all views computed since the last reset, and
+                :attr:`k_vectors` belong to the last view (Default value =
+                True).
         """
-        system = freud.locality.NeighborQuery.from_system(system)
+        cdef freud.locality.NeighborQuery nq = \
+            freud.locality.NeighborQuery.from_system(system)
 
         if view_orientation is None:
             view_orientation = np.array([1., 0., 0., 0.])
@@ -208,35 +228,34 @@ cdef class DiffractionPattern(_Compute):
 
         grid_size = int(self.grid_size / zoom)
 
-        # Compute the box projection matrix
-        inv_shear = self._calc_proj(view_orientation, system.box)
-
-        # Rotate points by the view quaternion and shear by the box projection
-        xy = rowan.rotate(view_orientation, system.points)[:, 0:2]
-        xy = xy @ inv_shear.T
-
-        # Map positions to [0, 1] and compute a histogram "image"
-        # Use grid_size+1 bin edges so that there are grid_size bins
-        xy += 0.5
-        xy %= 1
-        im, _, _ = np.histogram2d(
-            xy[:, 0], xy[:, 1], bins=np.linspace(0, 1, grid_size+1))
-
-        # Compute FFT and convolve with Gaussian
-        cdef double complex[:, :] diffraction_fft
-        diffraction_fft = np.fft.fft2(im)
-        diffraction_fft = scipy.ndimage.fourier.fourier_gaussian(
-            diffraction_fft, peak_width / zoom)
-        diffraction_fft = np.fft.fftshift(diffraction_fft)
-
-        # Compute the squared modulus of the FFT, which is S(k)
-        self._diffraction = np.real(
-            diffraction_fft * np.conjugate(diffraction_fft))
-
-        # Transform the image (scale, shear, zoom) and normalize S(k) by N^2
-        N = len(system.points)
-        self._diffraction = self._transform(
-            self._diffraction, system.box, inv_shear, zoom) / (N*N)
+        # Compute the box projection matrix, and the matrix that maps the
+        # pixels of the output image to the grid of intensities.
+        inv_shear = self._calc_proj(view_orientation, nq.box)
+        inverse_transform = self._transform_matrix(
+            grid_size, nq.box, inv_shear, zoom)
+
+        cdef const float[:, ::1] l_points = nq.points
+        cdef double[:, ::1] l_inv_shear = np.ascontiguousarray(
+            inv_shear, dtype=np.float64)
+        cdef double[:, ::1] l_inverse_transform = np.ascontiguousarray(
+            inverse_transform, dtype=np.float64)
+        cdef quat[double] l_view_orientation = quat[double](
+            view_orientation[0],
+            vec3[double](view_orientation[1], view_orientation[2],
+                         view_orientation[3]))
+
+        # Rotate and project the points, compute the structure factor of
+        # their binned positions convolved with a Gaussian, and transform the
+        # image (scale, shear, zoom) normalized by N^2.
+        cdef unsigned int l_grid_size = grid_size
+        cdef double l_peak_width = peak_width / zoom
+        if reset:
+            self.thisptr.reset()
+        with nogil:
+            self.thisptr.accumulate(
+                <vec3[float]*> &l_points[0, 0], l_points.shape[0],
+                l_view_orientation, &l_inv_shear[0, 0], l_grid_size,
+                l_peak_width, &l_inverse_transform[0, 0])
 
         # Compute a cached array of k-vectors that can be rotated and scaled
         if not self._called_compute:
@@ -275,7 +294,8 @@ cdef class DiffractionPattern(_Compute):
         (``output_size``, ``output_size``) :class:`numpy.ndarray`:
             diffraction pattern.
         """
-        return np.asarray(self._diffraction)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getDiffraction(), freud.util.arr_type_t.DOUBLE)
 
     @_Compute._computed_property
     def k_values(self):
@@ -355,3 +375,237 @@ cdef class DiffractionPattern(_Compute):
             return freud.plot._ax_to_bytes(self.plot())
         except (AttributeError, ImportError):
             return None
+
+
+cdef class StaticStructureFactor(_Compute):
+    R"""Computes the static structure factor by direct summation.
+
+    The static `structure factor
+    <https://en.wikipedia.org/wiki/Structure_factor>`_ of a set of
+    wavevectors :math:`\vec{k}` is
+
+    .. math::
+
+        S(\vec{k}) = \frac{1}{N} \left| \sum_{j=1}^N
+        e^{i \vec{k} \cdot \vec{r}_j} \right|^2
+
+    This class evaluates the sum directly from the point positions, so unlike
+    :class:`~.DiffractionPattern` it computes the full 3D (or 2D) structure
+    factor and its memory only grows with the number of wavevectors. By
+    default, the wavevectors are the vectors of the reciprocal lattice of
+    the periodic box with magnitudes between ``k_min`` and ``k_max``. Since
+    :math:`S(-\vec{k}) = S(\vec{k})`, only one of each pair of opposite
+    wavevectors is used. For large boxes, bins of :math:`k` containing more
+    than ``max_k_points`` wavevectors keep a random subset of about
+    ``max_k_points`` of them. The sums are computed in parallel over blocks
+    of wavevectors and points.
+
+    The isotropic structure factor :math:`S(k)`, :attr:`S_k`, is the average
+    of :math:`S(\vec{k})` over the wavevectors in each bin of :math:`k` and
+    over all frames computed since the last reset. Bins without any
+    wavevector are NaN.
+
+    At small :math:`k`, where few lattice wavevectors exist, :math:`S(k)`
+    can instead be computed from a radial distribution function with
+    :meth:`~.compute_debye`.
+
+    .. note::
+        Reciprocal lattice vectors are only defined for periodic boxes.
+        Wavevectors passed to :meth:`~.compute` may be arbitrary.
+
+    Args:
+        bins (unsigned int):
+            Number of bins of :math:`k`.
+        k_max (float):
+            Maximum :math:`k` value to include in the calculation.
+        k_min (float, optional):
+            Minimum :math:`k` value to include in the calculation
+            (Default value = 0).
+        max_k_points (unsigned int, optional):
+            Average number of reciprocal lattice wavevectors kept per bin, or
+            :code:`None` to keep all of them (Default value = 10000).
+        seed (unsigned int, optional):
+            Seed of the random selection of wavevectors
+            (Default value = 0).
+    """
+    cdef freud._diffraction.StaticStructureFactor * thisptr
+    cdef unsigned int _bins
+    cdef float _k_max
+    cdef float _k_min
+    cdef unsigned int _max_k_points
+    cdef unsigned int _seed
+
+    def __cinit__(self, bins, k_max, k_min=0, max_k_points=10000, seed=0):
+        self._bins = bins
+        self._k_max = k_max
+        self._k_min = k_min
+        self._max_k_points = 0 if max_k_points is None else max_k_points
+        self._seed = seed
+        self.thisptr = new freud._diffraction.StaticStructureFactor(
+            bins, k_max, k_min)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, k_vectors=None, reset=True):
+        R"""Computes the static structure factor.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            k_vectors ((:math:`N_k`, 3) :class:`numpy.ndarray`, optional):
+                Wavevectors at which to evaluate the structure factor. If
+                provided, they replace the current wavevectors and the
+                previously computed values are erased. If :code:`None`, the
+                reciprocal lattice of the box is sampled when ``reset`` is
+                True or no wavevectors exist yet (Default value =
+                :code:`None`).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, the wavevectors of the
+                previous call are reused and the structure factor is
+                averaged over frames (Default value = True).
+        """
+        cdef freud.locality.NeighborQuery nq = \
+            freud.locality.NeighborQuery.from_system(system)
+        cdef const float[:, ::1] l_points = nq.points
+        cdef const float[:, ::1] l_k_vectors
+        cdef freud.box.Box b = nq.box
+
+        if k_vectors is not None:
+            k_vectors = freud.util._convert_array(k_vectors, shape=(None, 3))
+            if len(k_vectors) == 0:
+                raise ValueError("At least one wavevector is required.")
+            l_k_vectors = k_vectors
+            self.thisptr.setKVectors(
+                <vec3[float]*> &l_k_vectors[0, 0], l_k_vectors.shape[0])
+        elif reset or self.thisptr.getKVectors().size() == 0:
+            self.thisptr.sampleKVectors(
+                dereference(b.thisptr), self._max_k_points, self._seed)
+
+        with nogil:
+            self.thisptr.accumulate(
+                <vec3[float]*> &l_points[0, 0], l_points.shape[0])
+        return self
+
+    def compute_debye(self, rdf, density):
+        R"""Computes :math:`S(k)` from a radial distribution function.
+
+        The Debye formula integrates the total correlation function
+        :math:`h(r) = g(r) - 1` over the bins of ``rdf``. In 3D,
+
+        .. math::
+
+            S(k) = 1 + 4 \pi \rho \int_0^{r_{max}} r^2 h(r)
+            \frac{\sin(kr)}{kr} dr
+
+        and in 2D the kernel is :math:`2 \pi r J_0(kr)`. It is evaluated at
+        the centers of the bins of :math:`k`. The truncation of :math:`g(r)`
+        at ``r_max`` limits the resolution in :math:`k` to about
+        :math:`2 \pi / r_{max}`. The result replaces :attr:`S_k`, and
+        :attr:`k_vectors` and :attr:`S_k_vectors` become empty.
+
+        Args:
+            rdf (:class:`freud.density.RDF`):
+                A computed radial distribution function.
+            density (float):
+                Number density of the points, :math:`N / V`.
+        """
+        cdef const float[::1] l_bin_edges = np.ascontiguousarray(
+            rdf.bin_edges, dtype=np.float32)
+        cdef const float[::1] l_rdf = np.ascontiguousarray(
+            rdf.rdf, dtype=np.float32)
+        cdef float l_density = density
+        cdef cbool l_is2D = rdf.box.is2D
+        with nogil:
+            self.thisptr.computeDebye(
+                &l_bin_edges[0], &l_rdf[0], l_rdf.shape[0], l_density,
+                l_is2D)
+        return self
+
+    @property
+    def bins(self):
+        """int: Number of bins of :math:`k`."""
+        return self._bins
+
+    @property
+    def k_max(self):
+        """float: Maximum :math:`k` value included in the calculation."""
+        return self._k_max
+
+    @property
+    def k_min(self):
+        """float: Minimum :math:`k` value included in the calculation."""
+        return self._k_min
+
+    @property
+    def max_k_points(self):
+        """int: Average number of reciprocal lattice wavevectors kept per bin,
+        or :code:`None` if all of them are kept."""
+        return None if self._max_k_points == 0 else self._max_k_points
+
+    @property
+    def bin_edges(self):
+        """:class:`numpy.ndarray`: The edges of each bin of :math:`k`."""
+        return np.array(self.thisptr.getBinEdges(), copy=True)
+
+    @property
+    def bin_centers(self):
+        """:class:`numpy.ndarray`: The centers of each bin of :math:`k`."""
+        return np.array(self.thisptr.getBinCenters(), copy=True)
+
+    @_Compute._computed_property
+    def S_k(self):
+        """(``bins``,) :class:`numpy.ndarray`: Static structure factor
+        :math:`S(k)` of each bin."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getStructureFactor(), freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def k_vectors(self):
+        """(:math:`N_k`, 3) :class:`numpy.ndarray`: The wavevectors."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getKVectors(), freud.util.arr_type_t.FLOAT, 3)
+
+    @_Compute._computed_property
+    def S_k_vectors(self):
+        R"""(:math:`N_k`,) :class:`numpy.ndarray`: Static structure factor
+        :math:`S(\vec{k})` of each wavevector in :attr:`k_vectors`, averaged
+        over frames."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getKVectorStructureFactor(),
+            freud.util.arr_type_t.FLOAT)
+
+    def __repr__(self):
+        return ("freud.diffraction.{cls}(bins={bins}, k_max={k_max}, "
+                "k_min={k_min}, max_k_points={max_k_points}, "
+                "seed={seed})").format(
+                    cls=type(self).__name__, bins=self.bins,
+                    k_max=self.k_max, k_min=self.k_min,
+                    max_k_points=self.max_k_points, seed=self._seed)
+
+    def plot(self, ax=None):
+        """Plot static structure factor.
+
+        Args:
+            ax (:class:`matplotlib.axes.Axes`, optional): Axis to plot on. If
+                :code:`None`, make a new figure and axis.
+                (Default value = :code:`None`)
+
+        Returns:
+            (:class:`matplotlib.axes.Axes`): Axis with the plot.
+        """
+        import freud.plot
+        return freud.plot.line_plot(self.bin_centers, self.S_k,
+                                    title="Static Structure Factor",
+                                    xlabel=r"$k$",
+                                    ylabel=r"$S(k)$",
+                                    ax=ax)
+
+    def _repr_png_(self):
+        try:
+            import freud.plot
+            return freud.plot._ax_to_bytes(self.plot())
+        except (AttributeError, ImportError):
+            return None
@@ -0,0 +1,672 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+R"""
+The :class:`freud.distributed` module computes on systems that are split
+across the processes of an MPI job, for systems whose points do not fit in the
+memory of a single node.
+
+A :class:`DomainDecomposition` splits the box into a grid of domains, one per
+rank of a communicator, and moves every point to the rank owning the domain it
+lies in. Every rank then receives copies of the points of other domains that
+lie within a cutoff of its own domain, its *ghost* points, and computes on its
+own points and their ghosts with the usual freud classes. Since every rank
+uses the periodic box of the whole system, bonds to ghost points are found
+with the minimum image convention without any image shifts. The partial
+results of all ranks are finally combined: histograms and density grids are
+summed, and the clusters touching several domains are merged.
+
+The communicator is typically an :code:`mpi4py.MPI.Comm`, but any object
+providing the :code:`Get_rank`, :code:`Get_size`, :code:`allgather`,
+:code:`allreduce`, :code:`alltoall`, :code:`gather`, and :code:`scatter`
+methods of mpi4py with the same semantics can be used, so freud does not
+depend on MPI itself.
+
+Example::
+
+    from mpi4py import MPI
+    decomposition = freud.distributed.DomainDecomposition(box, MPI.COMM_WORLD)
+    # Every rank may start with any subset of the points, for example the
+    # frame it read from a file.
+    points = decomposition.distribute(points)
+    rdf = freud.distributed.RDF(decomposition, bins=100, r_max=5)
+    rdf.compute(points)
+
+.. rubric:: Stability
+
+:mod:`freud.distributed` is **unstable**. When upgrading from version 2.x to
+2.y (y > x), existing freud scripts may need to be updated. The API will be
+finalized in a future release.
+"""
+
+import itertools
+import numpy as np
+import freud
+
+
+def _grid_dimensions(size, lengths):
+    """Factor the number of ranks into a grid of domains of the box, choosing
+    the factorization whose domains have the smallest surface."""
+    best = None
+    dimensions = len(lengths)
+    for gx in range(1, size + 1):
+        if size % gx:
+            continue
+        for gy in range(1, size // gx + 1):
+            if (size // gx) % gy:
+                continue
+            gz = size // (gx * gy)
+            if dimensions == 2 and gz != 1:
+                continue
+            grid = (gx, gy, gz)[:dimensions]
+            surface = sum(g / length for g, length in zip(grid, lengths))
+            if best is None or surface < best[0]:
+                best = (surface, grid)
+    return tuple(best[1]) + (1,) * (3 - dimensions)
+
+
+class DomainDecomposition(object):
+    R"""Split a periodic box into a grid of domains, one per rank.
+
+    The domains are the cells of a regular grid in the fractional coordinates
+    of the box, so they are parallelepipeds for triclinic boxes. Ranks are
+    assigned to the cells of the grid in row-major order.
+
+    Args:
+        box:
+            A box-like object (see :meth:`~freud.box.Box.from_box`) containing
+            the whole system.
+        comm:
+            The communicator of the ranks sharing the system.
+        grid (sequence of int, optional):
+            The number of domains along each box vector, whose product must be
+            the number of ranks. By default, the factorization of the number
+            of ranks with the smallest surface of the domains is used
+            (Default value = :code:`None`).
+    """
+    def __init__(self, box, comm, grid=None):
+        self._box = freud.box.Box.from_box(box)
+        self._comm = comm
+        self._rank = comm.Get_rank()
+        self._size = comm.Get_size()
+
+        matrix = self._box.to_matrix()
+        dimensions = self._box.dimensions
+        vectors = [matrix[:, i] for i in range(3)]
+        heights = []
+        if dimensions == 2:
+            area = abs(vectors[0][0] * vectors[1][1])
+            heights = [area / np.linalg.norm(vectors[1][:2]),
+                       area / np.linalg.norm(vectors[0][:2])]
+        else:
+            volume = abs(np.dot(vectors[0], np.cross(vectors[1], vectors[2])))
+            for i in range(3):
+                j, k = (i + 1) % 3, (i + 2) % 3
+                heights.append(
+                    volume / np.linalg.norm(np.cross(vectors[j], vectors[k])))
+        self._heights = np.asarray(heights + [np.inf] * (3 - dimensions))
+
+        if grid is None:
+            grid = _grid_dimensions(self._size, heights)
+        else:
+            grid = tuple(int(g) for g in grid)
+            grid = grid + (1,) * (3 - len(grid))
+            if len(grid) != 3 or (dimensions == 2 and grid[2] != 1):
+                raise ValueError(
+                    "The grid must have one number of domains per dimension.")
+            if int(np.prod(grid)) != self._size:
+                raise ValueError(
+                    "The grid must have one domain per rank, but it has {} "
+                    "domains for {} ranks.".format(int(np.prod(grid)),
+                                                   self._size))
+        self._grid = np.asarray(grid)
+        self._cell = np.asarray(np.unravel_index(self._rank, grid))
+
+    @property
+    def box(self):
+        """:class:`freud.box.Box`: The box of the whole system."""
+        return self._box
+
+    @property
+    def comm(self):
+        """The communicator of the ranks."""
+        return self._comm
+
+    @property
+    def rank(self):
+        """int: The rank of this process."""
+        return self._rank
+
+    @property
+    def size(self):
+        """int: The number of ranks."""
+        return self._size
+
+    @property
+    def grid(self):
+        """tuple: The number of domains along each box vector."""
+        return tuple(int(g) for g in self._grid)
+
+    @property
+    def domain_bounds(self):
+        """tuple: The lower and upper fractional coordinates of the domain of
+        this rank, as two :math:`\\left(3, \\right)` arrays."""
+        return self._cell / self._grid, (self._cell + 1) / self._grid
+
+    def _fractions(self, points):
+        points = np.asarray(points, dtype=np.float32).reshape(-1, 3)
+        if len(points) == 0:
+            return points, np.zeros((0, 3))
+        fractions = np.asarray(
+            self._box.make_fractional(self._box.wrap(points)),
+            dtype=np.float64).reshape(-1, 3) % 1.0
+        if self._box.is2D:
+            fractions[:, 2] = 0
+        return points, fractions
+
+    def _cells(self, fractions):
+        return np.minimum((fractions * self._grid).astype(np.int64),
+                          self._grid - 1)
+
+    def owner(self, points):
+        R"""Get the rank owning the domain of each point.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points in the box.
+
+        Returns:
+            (:math:`N_{points}`) :class:`numpy.ndarray`:
+                The rank of each point.
+        """
+        _, fractions = self._fractions(points)
+        return np.ravel_multi_index(self._cells(fractions).T, self.grid)
+
+    def _send(self, destinations, arrays):
+        """Send the elements of arrays to their destination ranks, and
+        concatenate the elements received from all ranks."""
+        order = np.argsort(destinations, kind='stable')
+        splits = np.searchsorted(destinations[order],
+                                 np.arange(1, self._size))
+        messages = [tuple(array) for array in zip(
+            *[np.split(array[order], splits) for array in arrays])]
+        received = self._comm.alltoall(messages)
+        return [np.concatenate([message[i] for message in received])
+                for i in range(len(arrays))]
+
+    def distribute(self, points, *values):
+        R"""Move points to the ranks owning their domains.
+
+        Every rank passes any subset of the points, possibly none, and gets
+        back the points of its domain from all ranks.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points held by this rank.
+            \*values (:class:`numpy.ndarray`):
+                Arrays of per-point values, such as orientations or types,
+                moved along with the points.
+
+        Returns:
+            :class:`numpy.ndarray` or tuple:
+                The points of this domain, followed by their values if any
+                were given.
+        """
+        points, fractions = self._fractions(points)
+        destinations = np.ravel_multi_index(self._cells(fractions).T,
+                                            self.grid)
+        result = self._send(destinations, [points] + [
+            np.asarray(value) for value in values])
+        return result[0] if not values else tuple(result)
+
+    def ghosts(self, points, r_max, *values):
+        R"""Exchange the points within a distance of the domains of other
+        ranks.
+
+        Every rank passes the points of its own domain, as returned by
+        :meth:`~.distribute`, and gets back all points of other domains
+        within :code:`r_max` of its domain, which include all neighbors
+        within :code:`r_max` of its own points.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points of the domain of this rank.
+            r_max (float):
+                Width of the layer of ghost points around the domain.
+            \*values (:class:`numpy.ndarray`):
+                Arrays of per-point values sent along with the points.
+
+        Returns:
+            :class:`numpy.ndarray` or tuple:
+                The ghost points of this domain, followed by their values if
+                any were given.
+        """
+        points, fractions = self._fractions(points)
+        values = [np.asarray(value) for value in values]
+        # Fractional width of the layer along each box vector, which bounds
+        # the fractional coordinates of any point within r_max of a domain.
+        # Rounding errors are covered by a small tolerance, since additional
+        # ghost points do not change any result.
+        width = r_max / self._heights
+        if np.any(width * 2 >= 1):
+            raise ValueError(
+                "r_max must be less than half the distance between opposite "
+                "faces of the box.")
+        cells = self._cells(fractions)
+        reach = np.ceil(width * self._grid).astype(np.int64)
+        offsets = []
+        for g, r in zip(self._grid, reach):
+            offsets.append(range(-r, r + 1) if 2 * r + 1 < g else range(g))
+
+        indices = []
+        destinations = []
+        for offset in itertools.product(*offsets):
+            destination = (cells + np.asarray(offset)) % self._grid
+            delta = fractions - (destination + 0.5) / self._grid
+            delta -= np.round(delta)
+            distance = np.maximum(np.abs(delta) - 0.5 / self._grid, 0)
+            ranks = np.ravel_multi_index(destination.T, self.grid)
+            selected = np.flatnonzero(
+                np.all(distance <= width * (1 + 1e-5), axis=1) &
+                (ranks != self._rank))
+            indices.append(selected)
+            destinations.append(ranks[selected])
+        indices = np.concatenate(indices).astype(np.int64)
+        destinations = np.concatenate(destinations).astype(np.int64)
+        result = self._send(destinations, [
+            array[indices] for array in [points] + values])
+        return result[0] if not values else tuple(result)
+
+    def allreduce(self, array):
+        R"""Sum an array over all ranks.
+
+        Args:
+            array (:class:`numpy.ndarray`):
+                The partial array of this rank.
+
+        Returns:
+            :class:`numpy.ndarray`: The sum of the arrays of all ranks.
+        """
+        return self._comm.allreduce(np.asarray(array))
+
+    def offset(self, count):
+        R"""Get the number of elements on lower ranks.
+
+        Args:
+            count (int):
+                The number of elements on this rank.
+
+        Returns:
+            tuple: The number of elements on lower ranks, and the total
+            number of elements.
+        """
+        counts = self._comm.allgather(int(count))
+        return sum(counts[:self._rank]), sum(counts)
+
+
+def _neighbors_r_max(neighbors):
+    if not isinstance(neighbors, dict) or 'r_max' not in neighbors:
+        raise ValueError(
+            "The neighbors must be a dictionary of query arguments with an "
+            "r_max, which bounds the width of the ghost layers.")
+    return neighbors['r_max']
+
+
+class RDF(object):
+    R"""Computes the RDF of a distributed system.
+
+    Every rank accumulates the bonds of its own points to its own and ghost
+    points with a :class:`freud.density.RDF`, and the histograms of all ranks
+    are summed and normalized by the number of points of the whole system.
+
+    Args:
+        decomposition (:class:`DomainDecomposition`):
+            The decomposition of the system.
+        bins (unsigned int):
+            The number of bins in the RDF.
+        r_max (float):
+            Maximum interparticle distance to include in the calculation.
+        r_min (float, optional):
+            Minimum interparticle distance to include in the calculation
+            (Default value = :code:`0`).
+        normalize (bool, optional):
+            Scale the RDF values by :math:`\frac{N}{N-1}`, see
+            :class:`freud.density.RDF` (Default value = :code:`False`).
+    """
+    def __init__(self, decomposition, bins, r_max, r_min=0,
+                 normalize=False):
+        self._decomposition = decomposition
+        self._local = freud.density.RDF(bins, r_max, r_min, normalize)
+        self._r_max = r_max
+        self._r_min = r_min
+        self._normalize = normalize
+        self._counts = np.zeros(bins, dtype=np.uint64)
+        self._frames = 0
+        self._num_points = 0
+
+    def compute(self, points, reset=True):
+        R"""Calculates the RDF of the points and adds it to the current RDF
+        histogram.
+
+        This must be called by all ranks.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points of the domain of this rank.
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+        """
+        if reset:
+            self._counts[:] = 0
+            self._frames = 0
+        decomposition = self._decomposition
+        points = np.asarray(points, dtype=np.float32).reshape(-1, 3)
+        ghost_points = decomposition.ghosts(points, self._r_max)
+        counts = np.zeros_like(self._counts)
+        if len(points):
+            self._local.compute(
+                (decomposition.box, np.concatenate([points, ghost_points])),
+                query_points=points,
+                neighbors=dict(r_max=self._r_max, r_min=self._r_min,
+                               exclude_ii=True))
+            counts = self._local.bin_counts.astype(np.uint64)
+        self._counts += decomposition.allreduce(counts).astype(np.uint64)
+        self._num_points = decomposition.offset(len(points))[1]
+        self._frames += 1
+        return self
+
+    @property
+    def bin_edges(self):
+        """:class:`numpy.ndarray`: The edges of the bins of the RDF."""
+        return self._local.bin_edges
+
+    @property
+    def bin_centers(self):
+        """:class:`numpy.ndarray`: The centers of the bins of the RDF."""
+        return self._local.bin_centers
+
+    @property
+    def bin_counts(self):
+        """:class:`numpy.ndarray`: The number of bonds in each bin, summed
+        over all ranks and frames."""
+        return self._counts
+
+    @property
+    def rdf(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Histogram of RDF
+        values of the whole system."""
+        edges = np.asarray(self.bin_edges, dtype=np.float64)
+        if self._decomposition.box.is2D:
+            volumes = np.pi * np.diff(edges**2)
+        else:
+            volumes = 4 / 3 * np.pi * np.diff(edges**3)
+        num_points = float(self._num_points)
+        density = num_points / self._decomposition.box.volume
+        if self._normalize:
+            density *= (num_points - 1) / num_points
+        prefactor = 1 / (num_points * density * self._frames)
+        return (self._counts * prefactor / volumes).astype(np.float32)
+
+    @property
+    def n_r(self):
+        """(:math:`N_{bins}`,) :class:`numpy.ndarray`: Average number of
+        points within a ball of radius :code:`bin_edges[i+1]` of a point of
+        the whole system."""
+        return (np.cumsum(self._counts) / (
+            float(self._num_points) * self._frames)).astype(np.float32)
+
+
+class GaussianDensity(object):
+    R"""Computes the Gaussian blurred density of a distributed system.
+
+    Every rank blurs its own points onto the grid of the whole box with a
+    :class:`freud.density.GaussianDensity`, and the grids of all ranks are
+    summed, so no ghost points are needed.
+
+    Args:
+        decomposition (:class:`DomainDecomposition`):
+            The decomposition of the system.
+        width (int or Sequence[int]):
+            The number of bins to make the grid in each dimension.
+        r_max (float):
+            Distance over which to blur.
+        sigma (float):
+            Sigma parameter for Gaussian.
+    """
+    def __init__(self, decomposition, width, r_max, sigma):
+        self._decomposition = decomposition
+        self._local = freud.density.GaussianDensity(width, r_max, sigma)
+        dimensions = decomposition.box.dimensions
+        self._shape = tuple(np.broadcast_to(
+            np.atleast_1d(width)[:dimensions], (dimensions,)))
+        self._density = None
+
+    def compute(self, points):
+        R"""Calculates the density of the points of all ranks.
+
+        This must be called by all ranks.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points of the domain of this rank.
+        """
+        decomposition = self._decomposition
+        points = np.asarray(points, dtype=np.float32).reshape(-1, 3)
+        density = np.zeros(self._shape, dtype=np.float32)
+        if len(points):
+            density = self._local.compute(
+                (decomposition.box, points)).density
+        self._density = decomposition.allreduce(density)
+        return self
+
+    @property
+    def density(self):
+        """(:math:`w_x`, :math:`w_y`, :math:`w_z`) :class:`numpy.ndarray`: The
+        grid with the Gaussian density of the whole system, on every rank."""
+        return self._density
+
+
+class Steinhardt(object):
+    R"""Computes the Steinhardt order parameters of the points of a
+    distributed system.
+
+    Every rank computes the order parameters of its own and ghost points with
+    a :class:`freud.order.Steinhardt`, keeping the values of its own points,
+    whose neighbors are all among them. With :code:`average=True`, the ghost
+    layer is twice as wide, so that the neighbors of the neighbors of every
+    point are also present.
+
+    Args:
+        decomposition (:class:`DomainDecomposition`):
+            The decomposition of the system.
+        \*args, \*\*kwargs:
+            Arguments of :class:`freud.order.Steinhardt`.
+    """
+    def __init__(self, decomposition, *args, **kwargs):
+        self._decomposition = decomposition
+        self._local = freud.order.Steinhardt(*args, **kwargs)
+        self._particle_order = None
+
+    def compute(self, points, neighbors):
+        R"""Calculates the order parameters of the points of this rank.
+
+        This must be called by all ranks.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points of the domain of this rank.
+            neighbors (dict):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                with an :code:`r_max`, which bounds the distance of the
+                neighbors.
+        """
+        r_max = _neighbors_r_max(neighbors)
+        if self._local.average:
+            r_max *= 2
+        decomposition = self._decomposition
+        points = np.asarray(points, dtype=np.float32).reshape(-1, 3)
+        ghost_points = decomposition.ghosts(points, r_max)
+        self._particle_order = np.zeros(0, dtype=np.float32)
+        if len(points):
+            self._local.compute(
+                (decomposition.box, np.concatenate([points, ghost_points])),
+                neighbors=neighbors)
+            self._particle_order = self._local.particle_order[:len(points)]
+        return self
+
+    @property
+    def particle_order(self):
+        """:math:`\\left(N_{points} \\right)` :class:`numpy.ndarray`: The
+        order parameter of the points of this rank."""
+        return self._particle_order
+
+
+class _UnionFind(object):
+    def __init__(self):
+        self._parent = {}
+
+    def find(self, key):
+        self._parent.setdefault(key, key)
+        root = key
+        while self._parent[root] != root:
+            root = self._parent[root]
+        while self._parent[key] != root:
+            self._parent[key], key = root, self._parent[key]
+        return root
+
+    def union(self, a, b):
+        a, b = self.find(a), self.find(b)
+        if a != b:
+            self._parent[max(a, b)] = min(a, b)
+
+
+class Cluster(object):
+    R"""Finds the clusters of a distributed system.
+
+    Every rank finds the clusters of its own and ghost points with a
+    :class:`freud.cluster.Cluster`. Each ghost point links the cluster it
+    belongs to on the rank it was sent to with the cluster of the same point
+    on the rank owning it, and the clusters linked across ranks are merged on
+    the first rank, which only handles the clusters touching ghost points.
+
+    Clusters are numbered rank by rank, each cluster spanning several domains
+    being numbered by the first rank it has points on. Unlike
+    :class:`freud.cluster.Cluster`, they are not sorted by size.
+
+    Args:
+        decomposition (:class:`DomainDecomposition`):
+            The decomposition of the system.
+    """
+    def __init__(self, decomposition):
+        self._decomposition = decomposition
+        self._local = freud.cluster.Cluster()
+        self._cluster_idx = None
+        self._num_clusters = 0
+
+    def compute(self, points, neighbors):
+        R"""Finds the clusters of the points of all ranks.
+
+        This must be called by all ranks.
+
+        Args:
+            points ((:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                Points of the domain of this rank.
+            neighbors (dict):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                with an :code:`r_max`, which bounds the distance of the
+                bonds.
+        """
+        decomposition = self._decomposition
+        comm = decomposition.comm
+        rank, size = decomposition.rank, decomposition.size
+        points = np.asarray(points, dtype=np.float32).reshape(-1, 3)
+        num_points = len(points)
+
+        # Every ghost point carries the rank and index of its original.
+        ghost_points, ghost_ranks, ghost_indices = decomposition.ghosts(
+            points, _neighbors_r_max(neighbors),
+            np.full(num_points, rank, dtype=np.int64),
+            np.arange(num_points, dtype=np.int64))
+        labels = np.zeros(0, dtype=np.int64)
+        if num_points + len(ghost_points):
+            self._local.compute(
+                (decomposition.box, np.concatenate([points, ghost_points])),
+                neighbors=neighbors)
+            labels = self._local.cluster_idx.astype(np.int64)
+        owned_labels = np.unique(labels[:num_points])
+        ghost_labels = labels[num_points:]
+
+        # Return the cluster of every ghost point to the rank of its
+        # original, which links it to the cluster of the original.
+        order = np.argsort(ghost_ranks, kind='stable')
+        splits = np.searchsorted(ghost_ranks[order], np.arange(1, size))
+        replies = comm.alltoall(list(zip(
+            np.split(ghost_indices[order], splits),
+            np.split(ghost_labels[order], splits))))
+        links = []
+        for source, (indices, source_labels) in enumerate(replies):
+            links.extend(zip(labels[indices].tolist(),
+                             [source] * len(indices),
+                             source_labels.tolist()))
+        linked = set(link[0] for link in links) | set(ghost_labels.tolist())
+        owned = set(owned_labels.tolist())
+        linked_owned = [label for label in linked if label in owned]
+
+        # Merge the linked clusters on the first rank. The root of every
+        # merged cluster is its first cluster with points of its own rank.
+        gathered = comm.gather((links, linked_owned), root=0)
+        roots = None
+        if rank == 0:
+            union = _UnionFind()
+            for source, (source_links, _) in enumerate(gathered):
+                for label, other_rank, other_label in source_links:
+                    union.union((source, label), (other_rank, other_label))
+            first_owned = {}
+            for source, (_, source_owned) in enumerate(gathered):
+                for label in source_owned:
+                    key = (source, label)
+                    root = union.find(key)
+                    first_owned[root] = min(first_owned.get(root, key), key)
+            roots = [{} for _ in range(size)]
+            for key in list(union._parent):
+                roots[key[0]][key[1]] = first_owned[union.find(key)]
+        roots = comm.scatter(roots, root=0)
+
+        # Number the clusters this rank is the root of, then get the numbers
+        # of the other linked clusters from their roots.
+        numbered = [label for label in owned_labels.tolist()
+                    if roots.get(label, (rank, label)) == (rank, label)]
+        offset, self._num_clusters = decomposition.offset(len(numbered))
+        numbers = {label: offset + i for i, label in enumerate(numbered)}
+        remote = [label for label in owned_labels.tolist()
+                  if roots.get(label, (rank, label))[0] != rank]
+        requests = [[] for _ in range(size)]
+        for label in remote:
+            requests[roots[label][0]].append(roots[label][1])
+        answers = comm.alltoall([[numbers[label] for label in request]
+                                 for request in comm.alltoall(requests)])
+        root_numbers = {}
+        for root_rank, (request, answer) in enumerate(zip(requests, answers)):
+            for root_label, number in zip(request, answer):
+                root_numbers[(root_rank, root_label)] = number
+        for label in remote:
+            numbers[label] = root_numbers[roots[label]]
+        self._cluster_idx = np.asarray(
+            [numbers[label] for label in labels[:num_points].tolist()],
+            dtype=np.uint32)
+        return self
+
+    @property
+    def num_clusters(self):
+        """int: The number of clusters of the whole system."""
+        return self._num_clusters
+
+    @property
+    def cluster_idx(self):
+        """(:math:`N_{points}`) :class:`numpy.ndarray`: The cluster index of
+        each point of this rank."""
+        return self._cluster_idx
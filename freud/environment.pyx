@@ -21,6 +21,7 @@ from cython.operator cimport dereference
 
 cimport freud.box
 cimport freud._environment
+cimport freud._locality
 cimport freud.locality
 cimport freud.util
 cimport numpy as np
@@ -29,6 +30,9 @@ cimport numpy as np
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 
 cdef class BondOrder(_SpatialHistogram):
     R"""Compute the bond orientational order diagram for the system of
@@ -152,10 +156,12 @@ cdef class BondOrder(_SpatialHistogram):
                 Query orientations used to calculate bonds. Uses
                 :code:`orientations` if :code:`None`.  (Default
                 value = :code:`None`).
-            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+            neighbors (:class:`freud.locality.NeighborList`, :class:`freud.locality.BondGeometry` or dict, optional):
                 Either a :class:`NeighborList <freud.locality.NeighborList>` of
-                neighbor pairs to use in the calculation, or a dictionary of
-                `query arguments
+                neighbor pairs to use in the calculation, a
+                :class:`~freud.locality.BondGeometry` of the bonds, whose
+                angles are read instead of evaluated in the :code:`'bod'`
+                mode, or a dictionary of `query arguments
                 <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
                 (Default value: None).
             reset (bool):
@@ -187,14 +193,17 @@ cdef class BondOrder(_SpatialHistogram):
 
         cdef const float[:, ::1] l_orientations = orientations
         cdef const float[:, ::1] l_query_orientations = query_orientations
-
-        self.thisptr.accumulate(
-            nq.get_ptr(),
-            <quat[float]*> &l_orientations[0, 0],
-            <vec3[float]*> &l_query_points[0, 0],
-            <quat[float]*> &l_query_orientations[0, 0],
-            num_query_points,
-            nlist.get_ptr(), dereference(qargs.thisptr))
+        cdef freud._locality.BondGeometry * geometry = \
+            freud.locality._bond_geometry_ptr(neighbors)
+
+        with nogil:
+            self.thisptr.accumulate(
+                nq.get_ptr(),
+                <quat[float]*> &l_orientations[0, 0],
+                <vec3[float]*> &l_query_points[0, 0],
+                <quat[float]*> &l_query_orientations[0, 0],
+                num_query_points,
+                nlist.get_ptr(), dereference(qargs.thisptr), geometry)
         return self
 
     @_Compute._computed_property
@@ -252,6 +261,33 @@ cdef class LocalDescriptors(_PairCompute):
             neighborhood, :code:`'particle_local'` to use the given
             particle orientations, or :code:`'global'` to not rotate
             environments (Default value = :code:`'neighborhood'`).
+        reduction (str, optional):
+            Reduction of the bond spherical harmonics computed along with
+            them, either :code:`'none'` to keep the spherical harmonics of
+            every bond, :code:`'average'` to average them over the bonds of
+            each point, or :code:`'power_spectrum'` to compute, for each
+            point and each :math:`l`, the sum over :math:`m` of the squared
+            magnitudes of the averages, :math:`\sum_m |\bar{Y}_{lm}|^2`.
+            The Steinhardt order parameter is
+            :math:`q_l = \sqrt{\frac{4\pi}{2l+1} \sum_m |\bar{Y}_{lm}|^2}`.
+            Reductions avoid storing an array with a row per bond
+            (Default value = :code:`'none'`).
+        half_precision (bool, optional):
+            If True, store :attr:`~.sph` as half precision floats, which
+            halves the size of the output. Since NumPy has no half
+            precision complex type, spherical harmonics then have a last
+            axis of size 2 holding their real and imaginary parts
+            (Default value = :code:`False`).
+        memory_budget (int, optional):
+            Number of bytes available for the bonds found by queries for
+            the :code:`'average'` and :code:`'power_spectrum'` reductions.
+            If the :class:`~freud.locality.NeighborList` of a query is
+            estimated to be larger (see
+            :attr:`freud.locality.NeighborQueryResult.estimated_nbytes`),
+            the bonds are found, consumed and discarded for chunks of query
+            points that fit in the budget, and :attr:`~.nlist` is empty.
+            Bonds given as a :class:`~freud.locality.NeighborList` are never
+            chunked (Default value = :code:`None`, never chunk the bonds).
     """  # noqa: E501
     cdef freud._environment.LocalDescriptors * thisptr
 
@@ -259,16 +295,28 @@ cdef class LocalDescriptors(_PairCompute):
                    'global': freud._environment.Global,
                    'particle_local': freud._environment.ParticleLocal}
 
-    def __cinit__(self, l_max, negative_m=True, mode='neighborhood'):
+    known_reductions = {'none': freud._environment.NoReduction,
+                        'average': freud._environment.ParticleAverage,
+                        'power_spectrum': freud._environment.PowerSpectrum}
+
+    def __cinit__(self, l_max, negative_m=True, mode='neighborhood',
+                  reduction='none', half_precision=False, memory_budget=None):
         cdef freud._environment.LocalDescriptorOrientation l_mode
+        cdef freud._environment.LocalDescriptorReduction l_reduction
         try:
             l_mode = self.known_modes[mode]
         except KeyError:
             raise ValueError(
                 'Unknown LocalDescriptors orientation mode: {}'.format(mode))
+        try:
+            l_reduction = self.known_reductions[reduction]
+        except KeyError:
+            raise ValueError(
+                'Unknown LocalDescriptors reduction: {}'.format(reduction))
 
         self.thisptr = new freud._environment.LocalDescriptors(
-            l_max, negative_m, l_mode)
+            l_max, negative_m, l_mode, l_reduction, half_precision)
+        self.memory_budget = memory_budget
 
     def __dealloc__(self):
         del self.thisptr
@@ -289,10 +337,12 @@ cdef class LocalDescriptors(_PairCompute):
             orientations ((:math:`N_{points}`, 4) :class:`numpy.ndarray`):
                 Orientations associated with system points that are used to
                 calculate bonds.
-            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+            neighbors (:class:`freud.locality.NeighborList`, :class:`freud.locality.BondGeometry` or dict, optional):
                 Either a :class:`NeighborList <freud.locality.NeighborList>` of
-                neighbor pairs to use in the calculation, or a dictionary of
-                `query arguments
+                neighbor pairs to use in the calculation, a
+                :class:`~freud.locality.BondGeometry` of the bonds, whose
+                spherical harmonics are read instead of evaluated in the
+                :code:`'global'` mode, or a dictionary of `query arguments
                 <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
                 (Default value: None).
             max_num_neighbors (unsigned int, optional):
@@ -325,24 +375,43 @@ cdef class LocalDescriptors(_PairCompute):
             l_orientations = orientations
             l_orientations_ptr = <quat[float]*> &l_orientations[0, 0]
 
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <vec3[float]*> &l_query_points[0, 0], num_query_points,
-            l_orientations_ptr,
-            nlist.get_ptr(), dereference(qargs.thisptr),
-            max_num_neighbors)
+        cdef unsigned int l_max_num_neighbors = max_num_neighbors
+        cdef freud._locality.BondGeometry * geometry = \
+            freud.locality._bond_geometry_ptr(neighbors)
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0], num_query_points,
+                l_orientations_ptr,
+                nlist.get_ptr(), dereference(qargs.thisptr),
+                l_max_num_neighbors, geometry)
         return self
 
     @_Compute._computed_property
     def nlist(self):
         """:class:`freud.locality.NeighborList`: The neighbor list from the
-        last compute."""
+        last compute. Empty if the bonds were chunked."""
         return freud.locality._nlist_from_cnlist(self.thisptr.getNList())
 
     @_Compute._computed_property
     def sph(self):
         """:math:`\\left(N_{bonds}, \\text{SphWidth} \\right)`
-        :class:`numpy.ndarray`: The last computed spherical harmonic array."""
+        :class:`numpy.ndarray`: The last computed spherical harmonic array.
+
+        With the :code:`'average'` reduction, this has one row per point
+        instead of one per bond, and with the :code:`'power_spectrum'`
+        reduction it is a real array of shape
+        :math:`\\left(N_{points}, l_{max} + 1 \\right)`. With half precision,
+        it is a :code:`float16` array, and complex values have a last axis of
+        size 2 holding their real and imaginary parts."""
+        if self.half_precision:
+            return freud.util.make_managed_numpy_array(
+                &self.thisptr.getHalfOutput(),
+                freud.util.arr_type_t.HALF)
+        elif self.reduction == 'power_spectrum':
+            return freud.util.make_managed_numpy_array(
+                &self.thisptr.getPowerSpectrum(),
+                freud.util.arr_type_t.FLOAT)
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getSph(),
             freud.util.arr_type_t.COMPLEX_FLOAT)
@@ -380,11 +449,43 @@ cdef class LocalDescriptors(_PairCompute):
             if value == mode:
                 return key
 
+    @property
+    def reduction(self):
+        """str: Reduction of the bond spherical harmonics, either
+        :code:`'none'`, :code:`'average'`, or :code:`'power_spectrum'`."""
+        reduction = self.thisptr.getReduction()
+        for key, value in self.known_reductions.items():
+            if value == reduction:
+                return key
+
+    @property
+    def half_precision(self):
+        """bool: True if :attr:`~.sph` is stored in half precision."""
+        return self.thisptr.getHalfPrecision()
+
+    @property
+    def memory_budget(self):
+        """int: Number of bytes available for the bonds found by queries for
+        reductions, or :code:`None` if the bonds are never chunked."""
+        return freud.locality._get_memory_budget(
+            self.thisptr.getMemoryBudget())
+
+    @memory_budget.setter
+    def memory_budget(self, value):
+        self.thisptr.setMemoryBudget(
+            freud.locality._convert_memory_budget(value))
+
     def __repr__(self):
         return ("freud.environment.{cls}(l_max={l_max}, "
-                "negative_m={negative_m}, mode='{mode}')").format(
+                "negative_m={negative_m}, mode='{mode}', "
+                "reduction='{reduction}', "
+                "half_precision={half_precision}, "
+                "memory_budget={memory_budget})").format(
                     cls=type(self).__name__, l_max=self.l_max,
-                    negative_m=self.negative_m, mode=self.mode)
+                    negative_m=self.negative_m, mode=self.mode,
+                    reduction=self.reduction,
+                    half_precision=self.half_precision,
+                    memory_budget=self.memory_budget)
 
 
 def _minimize_RMSD(box, ref_points, points, registration=False):
@@ -596,12 +697,17 @@ cdef class EnvironmentCluster(_MatchEnv):
 
         if env_neighbors is None:
             env_neighbors = neighbors
-        env_nlist, env_qargs = self._resolve_neighbors(env_neighbors)
-
-        self.thisptr.compute(
-            nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr),
-            env_nlist.get_ptr(), dereference(env_qargs.thisptr), threshold,
-            registration, global_search)
+        env_nlist, env_qargs = self._resolve_cached_neighbors(
+            nq, env_neighbors)
+
+        cdef float l_threshold = threshold
+        cdef bint l_registration = registration
+        cdef bint l_global_search = global_search
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr),
+                env_nlist.get_ptr(), dereference(env_qargs.thisptr),
+                l_threshold, l_registration, l_global_search)
         return self
 
     @_Compute._computed_property
@@ -699,8 +805,9 @@ cdef class EnvironmentMotifMatch(_MatchEnv):
             registration (bool, optional):
                 If True, first use brute force registration to orient one set
                 of environment vectors with respect to the other set such that
-                it minimizes the RMSD between the two sets
-                (Default value = False).
+                it minimizes the RMSD between the two sets. The registration
+                of each point is seeded by its index, so results are
+                reproducible (Default value = False).
         """
         cdef:
             freud.locality.NeighborQuery nq
@@ -716,11 +823,14 @@ cdef class EnvironmentMotifMatch(_MatchEnv):
         cdef const float[:, ::1] l_motif = motif
         cdef unsigned int nRef = l_motif.shape[0]
 
-        self.thisptr.compute(
-            nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr),
-            <vec3[float]*>
-            <vec3[float]*> &l_motif[0, 0], nRef,
-            threshold, registration)
+        cdef float l_threshold = threshold
+        cdef bint l_registration = registration
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr),
+                <vec3[float]*>
+                <vec3[float]*> &l_motif[0, 0], nRef,
+                l_threshold, l_registration)
 
     @_Compute._computed_property
     def matches(self):
@@ -775,8 +885,9 @@ cdef class _EnvironmentRMSDMinimizer(_MatchEnv):
             registration (bool, optional):
                 If True, first use brute force registration to orient one set
                 of environment vectors with respect to the other set such that
-                it minimizes the RMSD between the two sets
-                (Default value = :code:`False`).
+                it minimizes the RMSD between the two sets. The registration
+                of each point is seeded by its index, so results are
+                reproducible (Default value = :code:`False`).
         Returns:
             :math:`\left(N_{particles}\right)` :class:`numpy.ndarray`:
                 Vector of minimal RMSD values, one value per particle.
@@ -796,11 +907,13 @@ cdef class _EnvironmentRMSDMinimizer(_MatchEnv):
         cdef const float[:, ::1] l_motif = motif
         cdef unsigned int nRef = l_motif.shape[0]
 
-        self.thisptr.compute(
-            nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr),
-            <vec3[float]*>
-            <vec3[float]*> &l_motif[0, 0], nRef,
-            registration)
+        cdef bint l_registration = registration
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), nlist.get_ptr(), dereference(qargs.thisptr),
+                <vec3[float]*>
+                <vec3[float]*> &l_motif[0, 0], nRef,
+                l_registration)
 
         return self
 
@@ -893,16 +1006,17 @@ cdef class AngularSeparationNeighbor(_PairCompute):
 
         cdef unsigned int n_equiv_orientations = l_equiv_orientations.shape[0]
 
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <quat[float]*> &l_orientations[0, 0],
-            <vec3[float]*> &l_query_points[0, 0],
-            <quat[float]*> &l_query_orientations[0, 0],
-            num_query_points,
-            <quat[float]*> &l_equiv_orientations[0, 0],
-            n_equiv_orientations,
-            nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <quat[float]*> &l_orientations[0, 0],
+                <vec3[float]*> &l_query_points[0, 0],
+                <quat[float]*> &l_query_orientations[0, 0],
+                num_query_points,
+                <quat[float]*> &l_equiv_orientations[0, 0],
+                n_equiv_orientations,
+                nlist.get_ptr(),
+                dereference(qargs.thisptr))
         return self
 
     @_Compute._computed_property
@@ -976,13 +1090,14 @@ cdef class AngularSeparationGlobal(_Compute):
         cdef unsigned int n_points = l_orientations.shape[0]
         cdef unsigned int n_equiv_orientations = l_equiv_orientations.shape[0]
 
-        self.thisptr.compute(
-            <quat[float]*> &l_global_orientations[0, 0],
-            n_global,
-            <quat[float]*> &l_orientations[0, 0],
-            n_points,
-            <quat[float]*> &l_equiv_orientations[0, 0],
-            n_equiv_orientations)
+        with nogil:
+            self.thisptr.compute(
+                <quat[float]*> &l_global_orientations[0, 0],
+                n_global,
+                <quat[float]*> &l_orientations[0, 0],
+                n_points,
+                <quat[float]*> &l_equiv_orientations[0, 0],
+                n_equiv_orientations)
         return self
 
     @_Compute._computed_property
@@ -1002,13 +1117,35 @@ cdef class LocalBondProjection(_PairCompute):
     R"""Calculates the maximal projection of nearest neighbor bonds for each
     particle onto some set of reference vectors, defined in the particles'
     local reference frame.
+
+    Computing only the :attr:`normed_projections` saves the memory of an
+    array with a row per bond. Accessing an output that was not computed
+    raises an :code:`AttributeError`.
+
+    Args:
+        outputs (str, optional):
+            Outputs to compute, either :code:`'projections'` to compute both
+            :attr:`projections` and :attr:`normed_projections`, or
+            :code:`'normed_projections'` to compute only
+            :attr:`normed_projections` (Default value =
+            :code:`'projections'`).
     """
     cdef freud._environment.LocalBondProjection * thisptr
 
-    def __cinit__(self):
-        self.thisptr = new freud._environment.LocalBondProjection()
+    known_outputs = {
+        'normed_projections': freud._environment.local_bond_projection_normed,
+        'projections': freud._environment.local_bond_projection_all}
 
-    def __init__(self):
+    def __cinit__(self, outputs='projections'):
+        cdef freud._environment.LocalBondProjectionOutputs l_outputs
+        try:
+            l_outputs = self.known_outputs[outputs]
+        except KeyError:
+            raise ValueError(
+                'Unknown LocalBondProjection outputs: {}'.format(outputs))
+        self.thisptr = new freud._environment.LocalBondProjection(l_outputs)
+
+    def __init__(self, outputs='projections'):
         pass
 
     def __dealloc__(self):
@@ -1079,13 +1216,14 @@ cdef class LocalBondProjection(_PairCompute):
         cdef unsigned int n_equiv = l_equiv_orientations.shape[0]
         cdef unsigned int n_proj = l_proj_vecs.shape[0]
 
-        self.thisptr.compute(
-            nq.get_ptr(),
-            <quat[float]*> &l_orientations[0, 0],
-            <vec3[float]*> &l_query_points[0, 0], num_query_points,
-            <vec3[float]*> &l_proj_vecs[0, 0], n_proj,
-            <quat[float]*> &l_equiv_orientations[0, 0], n_equiv,
-            nlist.get_ptr(), dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <quat[float]*> &l_orientations[0, 0],
+                <vec3[float]*> &l_query_points[0, 0], num_query_points,
+                <vec3[float]*> &l_proj_vecs[0, 0], n_proj,
+                <quat[float]*> &l_equiv_orientations[0, 0], n_equiv,
+                nlist.get_ptr(), dereference(qargs.thisptr))
         return self
 
     @_Compute._computed_property
@@ -1099,6 +1237,10 @@ cdef class LocalBondProjection(_PairCompute):
         """:math:`\\left(N_{bonds}, N_{projection\\_vecs} \\right)` :class:`numpy.ndarray`:
         The projection of each bond between query particles and their neighbors
         onto each of the projection vectors."""  # noqa: E501
+        if self.outputs != 'projections':
+            raise AttributeError(
+                "The projections were not computed with outputs='{}'.".format(
+                    self.outputs))
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getProjections(),
             freud.util.arr_type_t.FLOAT)
@@ -1113,5 +1255,15 @@ cdef class LocalBondProjection(_PairCompute):
             &self.thisptr.getNormedProjections(),
             freud.util.arr_type_t.FLOAT)
 
+    @property
+    def outputs(self):
+        """str: The outputs computed, either :code:`'projections'` or
+        :code:`'normed_projections'`."""
+        outputs = self.thisptr.getOutputs()
+        for key, value in self.known_outputs.items():
+            if value == outputs:
+                return key
+
     def __repr__(self):
-        return ("freud.environment.{cls}()").format(cls=type(self).__name__)
+        return ("freud.environment.{cls}(outputs='{outputs}')").format(
+            cls=type(self).__name__, outputs=self.outputs)
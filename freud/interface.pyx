@@ -10,23 +10,36 @@ import numpy as np
 
 from freud.util cimport _Compute
 from freud.locality cimport _PairCompute
+from freud.util cimport vec3
+from cython.operator cimport dereference
 import freud.locality
 
+cimport freud._interface
 cimport freud.locality
+cimport freud.util
 cimport numpy as np
 
 # numpy must be initialized. When using numpy from C or Cython you must
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 cdef class Interface(_PairCompute):
-    R"""Measures the interface between two sets of points."""
-    cdef const unsigned int[::1] _point_ids
-    cdef const unsigned int[::1] _query_point_ids
+    R"""Measures the interface between two sets of points.
+
+    The points and query points at the interface are those with at least one
+    bond to the other set. Bonds are only marked, not stored, so no
+    :class:`~.locality.NeighborList` is built when query arguments are given.
+    """
+    cdef freud._interface.Interface * thisptr
 
-    def __init__(self):
-        self._point_ids = np.empty(0, dtype=np.uint32)
-        self._query_point_ids = np.empty(0, dtype=np.uint32)
+    def __cinit__(self):
+        self.thisptr = new freud._interface.Interface()
+
+    def __dealloc__(self):
+        del self.thisptr
 
     def compute(self, system, query_points, neighbors=None):
         R"""Compute the particles at the interface between two sets of points.
@@ -52,33 +65,44 @@ cdef class Interface(_PairCompute):
             const float[:, ::1] l_query_points
             unsigned int num_query_points
 
-        nlist = freud.locality._make_default_nlist(
-            system, neighbors, query_points)
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, query_points, neighbors)
 
-        self._point_ids = np.unique(nlist.point_indices)
-        self._query_point_ids = np.unique(nlist.query_point_indices)
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(),
+                <vec3[float]*> &l_query_points[0, 0], num_query_points,
+                nlist.get_ptr(), dereference(qargs.thisptr))
         return self
 
+    def _supports_half_neighbors(self):
+        # The bonds of half neighbor lists are marked like any other bonds.
+        return True
+
     @_Compute._computed_property
     def point_count(self):
         """int: Number of particles from :code:`points` on the interface."""
-        return len(self._point_ids)
+        return self.thisptr.getPointIds().size()
 
     @_Compute._computed_property
     def point_ids(self):
         """:class:`np.ndarray`: The particle IDs from :code:`points`."""
-        return np.asarray(self._point_ids)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPointIds(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     @_Compute._computed_property
     def query_point_count(self):
         """int: Number of particles from :code:`query_points` on the
         interface."""
-        return len(self._query_point_ids)
+        return self.thisptr.getQueryPointIds().size()
 
     @_Compute._computed_property
     def query_point_ids(self):
         """:class:`np.ndarray`: The particle IDs from :code:`query_points`."""
-        return np.asarray(self._query_point_ids)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getQueryPointIds(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     def __repr__(self):
         return "freud.interface.{cls}()".format(cls=type(self).__name__)
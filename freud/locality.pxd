@@ -2,6 +2,7 @@
 # This file is from the freud project, released under the BSD 3-Clause License.
 
 from freud.util cimport _Compute
+from libcpp.memory cimport shared_ptr
 
 cimport freud._locality
 cimport freud.box
@@ -35,15 +36,27 @@ cdef class NeighborQueryResult:
 cdef class NeighborQuery:
     cdef freud._locality.NeighborQuery * nqptr
     cdef const float[:, ::1] points
-    cdef freud._locality.NeighborQuery * get_ptr(self)
+    cdef freud._locality.NeighborListCache * _cache
+    cdef object _point_types
+    cdef freud._locality.NeighborQuery * get_ptr(self) nogil
 
 cdef class NeighborList:
     cdef freud._locality.NeighborList * thisptr
     cdef char _managed
+    cdef shared_ptr[freud._locality.NeighborList] _shared
 
-    cdef freud._locality.NeighborList * get_ptr(self)
+    cdef freud._locality.NeighborList * get_ptr(self) nogil
     cdef void copy_c(self, NeighborList other)
 
+cdef class CompressedNeighborList:
+    cdef freud._locality.CompressedNeighborList * thisptr
+
+cdef class BondGeometry:
+    cdef freud._locality.BondGeometry * thisptr
+    cdef NeighborList _nlist
+
+cdef freud._locality.BondGeometry * _bond_geometry_ptr(neighbors)
+
 cdef class LinkCell(NeighborQuery):
     cdef freud._locality.LinkCell * thisptr
 
@@ -57,7 +70,9 @@ cdef class _QueryArgs:
     cdef freud._locality.QueryArgs * thisptr
 
 cdef class _PairCompute(_Compute):
-    pass
+    cdef void _add_pipeline_stage(
+        self, freud._locality.NeighborPipeline *pipeline,
+        dict stage_arrays) except *
 
 cdef class _SpatialHistogram(_PairCompute):
     cdef float r_max
@@ -73,3 +88,23 @@ cdef class Voronoi(_Compute):
     cdef freud._locality.Voronoi * thisptr
     cdef NeighborList _nlist
     cdef freud.box.Box _box
+
+cdef class VerletList(_Compute):
+    cdef freud._locality.VerletList * thisptr
+
+cdef class GSDTrajectory:
+    cdef shared_ptr[freud._locality.FrameSource] thisptr
+    cdef str _filename
+
+cdef class _Trajectory:
+    cdef freud._locality.Trajectory * thisptr
+    cdef const float[:, :, ::1] points
+    cdef const float[:, ::1] box_params
+    cdef GSDTrajectory source
+    cdef dimensions
+    cdef readonly unsigned int n_frames
+    cdef readonly unsigned int n_points
+
+cdef class NeighborPipeline(_PairCompute):
+    cdef freud._locality.NeighborPipeline * thisptr
+    cdef list _computes
@@ -16,15 +16,34 @@ from cython.operator cimport dereference
 from libcpp.memory cimport shared_ptr
 from libcpp.vector cimport vector
 from freud._locality cimport ITERATOR_TERMINATOR
+from freud._util cimport PyArray_SetBaseObject
+from cpython cimport Py_INCREF
 
 cimport freud._locality
 cimport freud.box
+cimport freud.util
 cimport numpy as np
 
 # numpy must be initialized. When using numpy from C or Cython you must
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
+_BACKEND_SELECTIONS = {
+    'aabb': freud._locality.selection_aabb,
+    'auto': freud._locality.selection_auto,
+    'calibrated': freud._locality.selection_calibrated}
+
+# Type of query arguments that match points of every type.
+_ANY_TYPE = np.iinfo(np.uint32).max
+
+_VORONOI_OUTPUTS = {
+    'neighbors': freud._locality.voronoi_neighbors,
+    'volumes': freud._locality.voronoi_volumes,
+    'polytopes': freud._locality.voronoi_polytopes}
+
 cdef class _QueryArgs:
     R"""Container for query arguments.
 
@@ -37,7 +56,8 @@ cdef class _QueryArgs:
 
     def __cinit__(self, mode=None, r_min=None, r_max=None, r_guess=None,
                   num_neighbors=None, exclude_ii=None,
-                  scale=None, **kwargs):
+                  scale=None, half=None, point_type=None,
+                  query_point_type=None, **kwargs):
         if type(self) == _QueryArgs:
             self.thisptr = new freud._locality.QueryArgs()
             self.mode = mode
@@ -53,6 +73,10 @@ cdef class _QueryArgs:
                 self.exclude_ii = exclude_ii
             if scale is not None:
                 self.scale = scale
+            if half is not None:
+                self.half = half
+            self.point_type = point_type
+            self.query_point_type = query_point_type
             if len(kwargs):
                 err_str = ", ".join(
                     "{} = {}".format(k, v) for k, v in kwargs.items())
@@ -87,6 +111,10 @@ cdef class _QueryArgs:
             return 'ball'
         elif self.thisptr.mode == freud._locality.QueryType.nearest:
             return 'nearest'
+        elif self.thisptr.mode == freud._locality.QueryType.count:
+            return 'count'
+        elif self.thisptr.mode == freud._locality.QueryType.exists:
+            return 'exists'
         else:
             raise ValueError("Unknown mode {} set!".format(self.thisptr.mode))
 
@@ -98,6 +126,10 @@ cdef class _QueryArgs:
             self.thisptr.mode = freud._locality.QueryType.ball
         elif value == 'nearest':
             self.thisptr.mode = freud._locality.QueryType.nearest
+        elif value == 'count':
+            self.thisptr.mode = freud._locality.QueryType.count
+        elif value == 'exists':
+            self.thisptr.mode = freud._locality.QueryType.exists
         else:
             raise ValueError("An invalid mode was provided.")
 
@@ -149,15 +181,43 @@ cdef class _QueryArgs:
     def scale(self, value):
         self.thisptr.scale = value
 
+    @property
+    def half(self):
+        return self.thisptr.half
+
+    @half.setter
+    def half(self, value):
+        self.thisptr.half = value
+
+    @property
+    def point_type(self):
+        if self.thisptr.point_type == _ANY_TYPE:
+            return None
+        return self.thisptr.point_type
+
+    @point_type.setter
+    def point_type(self, value):
+        self.thisptr.point_type = _ANY_TYPE if value is None else value
+
+    @property
+    def query_point_type(self):
+        if self.thisptr.query_point_type == _ANY_TYPE:
+            return None
+        return self.thisptr.query_point_type
+
+    @query_point_type.setter
+    def query_point_type(self, value):
+        self.thisptr.query_point_type = _ANY_TYPE if value is None else value
+
     def __repr__(self):
         return ("freud.locality.{cls}(mode={mode}, r_max={r_max}, "
                 "num_neighbors={num_neighbors}, exclude_ii={exclude_ii}, "
-                "scale={scale})").format(
+                "scale={scale}, half={half})").format(
                     cls=type(self).__name__,
                     mode=self.mode, r_max=self.r_max,
                     num_neighbors=self.num_neighbors,
                     exclude_ii=self.exclude_ii,
-                    scale=self.scale)
+                    scale=self.scale, half=self.half)
 
     def __str__(self):
         return repr(self)
@@ -227,6 +287,132 @@ cdef class NeighborQueryResult:
 
         return nl
 
+    def toChunks(self, chunk_size=65536, sort_by_distance=False):
+        R"""Iterate over the bonds of the query result in chunks of arrays.
+
+        The bonds are found in parallel for blocks of consecutive query
+        points, as in :meth:`~.toNeighborList`, and yielded as arrays of
+        :code:`chunk_size` bonds (fewer in the last chunk). This avoids
+        creating a Python object per bond as in iteration over the result,
+        while only storing the bonds of about two chunks at a time instead
+        of all bonds. The concatenated chunks are the bonds of
+        :meth:`~.toNeighborList`, in the same order.
+
+        Example::
+
+            >>> box, points = freud.data.make_random_system(10, 100, seed=0)
+            >>> aq = freud.locality.AABBQuery(box, points)
+            >>> result = aq.query(points, dict(num_neighbors=4))
+            >>> [len(chunk[0]) for chunk in result.toChunks(150)]
+            [150, 150, 100]
+
+        Args:
+            chunk_size (int):
+                Number of bonds of each chunk (Default value = 65536).
+            sort_by_distance (bool):
+                If :code:`True`, sort neighboring bonds of each query point
+                by distance. If :code:`False`, sort them by point index
+                (Default value = :code:`False`).
+
+        Yields:
+            tuple of :class:`numpy.ndarray`: The query point indices, point
+            indices, and distances of the bonds of each chunk.
+        """
+        if chunk_size < 1:
+            raise ValueError("The chunk size must be positive.")
+        cdef const float[:, ::1] l_points = self.points
+        cdef unsigned int n_query_points = self.points.shape[0]
+        if n_query_points == 0:
+            return
+        cdef shared_ptr[freud._locality.NeighborQueryIterator] iterator = \
+            self.nq.nqptr.query(
+                <vec3[float]*> &l_points[0, 0], n_query_points,
+                dereference(self.query_args.thisptr))
+
+        cdef freud._locality.NeighborList *cnlist
+        cdef NeighborList nl
+        cdef unsigned int begin = 0
+        cdef unsigned int end
+        # The number of query points of each block is chosen so that blocks
+        # have about chunk_size bonds at the mean number of bonds per query
+        # point found so far.
+        cdef unsigned int block_size = max(1, chunk_size // 64)
+        cdef size_t n_bonds = 0
+        pending = []
+        cdef size_t n_pending = 0
+        while begin < n_query_points:
+            end = min(n_query_points, begin + block_size)
+            cnlist = dereference(iterator).toNeighborList(
+                sort_by_distance, begin, end)
+            nl = _nlist_from_cnlist(cnlist)
+            nl._managed = True
+            pending.append((nl.query_point_indices, nl.point_indices,
+                            nl.distances))
+            n_pending += len(nl)
+            n_bonds += len(nl)
+            if n_pending >= chunk_size:
+                arrays = [np.concatenate(a) for a in zip(*pending)]
+                start = 0
+                while n_pending - start >= chunk_size:
+                    yield tuple(a[start:start + chunk_size] for a in arrays)
+                    start += chunk_size
+                pending = [tuple(a[start:] for a in arrays)]
+                n_pending -= start
+            begin = end
+            if n_bonds == 0:
+                block_size = min(2 * block_size, n_query_points)
+            else:
+                block_size = max(1, min(
+                    int(chunk_size * begin / n_bonds), n_query_points))
+        if n_pending > 0:
+            yield tuple(np.concatenate(a) for a in zip(*pending))
+
+    @property
+    def estimated_nbytes(self):
+        R"""int: Estimated number of bytes of the :class:`~NeighborList` of
+        the query, computed without finding the bonds.
+
+        Ball queries are assumed to find the points in the volume between
+        :code:`r_min` and :code:`r_max` at the mean density of the points in
+        the box, and nearest neighbor queries to find :code:`num_neighbors`
+        points. Computes with a :code:`memory_budget` find the bonds in
+        chunks of query points if this estimate exceeds their budget.
+        """
+        cdef unsigned int n_query_points = self.points.shape[0]
+        return freud._locality.estimateNeighborListBytes(
+            self.nq.nqptr, n_query_points,
+            dereference(self.query_args.thisptr))
+
+    def toCounts(self):
+        R"""Count the neighbors of each query point without finding the bonds.
+
+        The traversal of each query point stops as soon as its count is
+        known, at the first neighbor for queries with :code:`mode='exists'`.
+        Queries with :code:`mode='count'` or :code:`mode='ball'` count all
+        neighbors within the distance range.
+
+        Returns:
+            :math:`\left(N_{query\_points}\right)` :class:`numpy.ndarray`:
+            The number of neighbors of each query point for count and ball
+            queries, or whether each query point has a neighbor for exists
+            queries.
+        """
+        cdef const float[:, ::1] l_points = self.points
+        cdef unsigned int n_query_points = self.points.shape[0]
+        counts = np.zeros(n_query_points, dtype=np.uint32)
+        cdef unsigned int[::1] l_counts = counts
+        cdef freud._locality.QueryArgs qargs = dereference(
+            self.query_args.thisptr)
+        cdef freud._locality.NeighborQuery * nqptr = self.nq.nqptr
+        if n_query_points > 0:
+            with nogil:
+                nqptr.queryCounts(
+                    <vec3[float]*> &l_points[0, 0], n_query_points, qargs,
+                    &l_counts[0])
+        if self.query_args.mode == 'exists':
+            return counts.astype(bool)
+        return counts
+
 
 cdef class NeighborQuery:
     R"""Class representing a set of points along with the ability to query for
@@ -249,6 +435,11 @@ cdef class NeighborQuery:
     NeighborQuery implement these methods based on the nature of the underlying
     data structure.
 
+    Analyses that call many computes with the same NeighborQuery and query
+    arguments can enable a cache of NeighborLists with
+    :meth:`~NeighborQuery.enable_cache`, so that the neighbors of the points
+    are found once and reused by every compute.
+
     Args:
         box (:class:`freud.box.Box`):
             Simulation box.
@@ -263,6 +454,9 @@ cdef class NeighborQuery:
                 "directly instantiated"
             )
 
+    def __dealloc__(self):
+        del self._cache
+
     @classmethod
     def from_system(cls, system, dimensions=None):
         R"""Create a :class:`~.NeighborQuery` from any system-like object.
@@ -377,6 +571,24 @@ cdef class NeighborQuery:
         """:class:`np.ndarray`: The array of points in this data structure."""
         return np.asarray(self.points)
 
+    @property
+    def point_types(self):
+        """:math:`\\left(N_{points}\\right)` :class:`numpy.ndarray`: The
+        types of the points, or :code:`None` if they have no types."""
+        return self._point_types
+
+    def _set_point_types(self, point_types):
+        """Copy the types of the points and build the data structures of
+        the points of each type."""
+        cdef const unsigned int[::1] l_point_types
+        if point_types is None:
+            return
+        self._point_types = freud.util._convert_array(
+            point_types, shape=(self.points.shape[0], ),
+            dtype=np.uint32, copy=True)
+        l_point_types = self._point_types
+        self.nqptr.setPointTypes(&l_point_types[0])
+
     def query(self, query_points, query_args):
         R"""Query for nearest neighbors of the provided point.
 
@@ -398,10 +610,132 @@ cdef class NeighborQuery:
         cdef _QueryArgs args = _QueryArgs.from_dict(query_args)
         return NeighborQueryResult.init(self, query_points, args)
 
-    cdef freud._locality.NeighborQuery * get_ptr(self):
+    def query_grid(self, width, query_args):
+        R"""Query for the neighbors of the centers of the cells of a grid.
+
+        The box is divided into :code:`width` cells along each box vector,
+        as in :class:`freud.density.GaussianDensity`, and the neighbors of
+        the center of every cell are found. Ball queries of a
+        :class:`~.LinkCell` whose cells contain several grid points search
+        the cells around each cell once for all of its grid points.
+
+        Args:
+            width (int or Sequence[int]):
+                The number of grid cells along each box vector, either as a
+                single number or as a sequence of one number per dimension.
+            query_args (dict):
+                Query arguments determining how to find neighbors. For
+                information on valid query argument, see the `Query API
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_.
+
+        Returns:
+            :class:`~.NeighborQueryResult`: Results object containing the
+            output of this query. The query point indices are the flattened
+            grid indices, with the last box vector varying fastest.
+        """
+        dimensions = 2 if self.box.is2D else 3
+        if isinstance(width, int):
+            width = (width,) * dimensions
+        if len(width) != dimensions or any(w < 1 for w in width):
+            raise ValueError(
+                "The width must be a positive number of cells or a "
+                "sequence of {} positive numbers.".format(dimensions))
+        axes = [(np.arange(w) + 0.5) / w for w in width]
+        fractions = np.zeros((np.prod(width), 3))
+        fractions[:, :dimensions] = np.stack(
+            np.meshgrid(*axes, indexing='ij'), axis=-1).reshape(
+                -1, dimensions)
+        grid_points = self.box.make_absolute(fractions)
+        if self.box.is2D:
+            grid_points[:, 2] = 0
+        return self.query(grid_points, query_args)
+
+    cdef freud._locality.NeighborQuery * get_ptr(self) nogil:
         R"""Returns a pointer to the raw C++ object we are wrapping."""
         return self.nqptr
 
+    def enable_cache(self, unsigned int max_size=8):
+        R"""Cache the NeighborLists of queries of the points against
+        themselves.
+
+        While the cache is enabled, computes given this object and a
+        :code:`dict` of query arguments without :code:`query_points` use a
+        cached :class:`~.NeighborList` of the same query arguments instead
+        of finding the neighbors again. A query that is not cached is
+        answered from a cached list of a larger query if possible, for
+        example a ball query of a smaller :code:`r_max` from a ball query
+        of a larger :code:`r_max`, or the :code:`k` nearest neighbors from
+        a nearest neighbor query of more neighbors or a ball query whose
+        :code:`r_max` is at least that of the nearest neighbor query. The
+        bonds are the same as those found by querying.
+
+        The cache is cleared when the points are updated with
+        :code:`update`. Cached NeighborLists are shared between computes,
+        so they cannot be modified; modify a :meth:`~.NeighborList.copy`
+        instead.
+
+        Args:
+            max_size (unsigned int, optional):
+                Maximum number of NeighborLists kept. The least recently
+                used NeighborList is removed when the cache is full
+                (Default value = 8).
+
+        Returns:
+            :class:`~.NeighborQuery`: This object.
+        """
+        cdef freud._locality.NeighborListCache *cache = \
+            new freud._locality.NeighborListCache(self.nqptr, max_size)
+        del self._cache
+        self._cache = cache
+        return self
+
+    def disable_cache(self):
+        R"""Disable the cache of NeighborLists and remove all cached
+        NeighborLists.
+
+        Returns:
+            :class:`~.NeighborQuery`: This object.
+        """
+        del self._cache
+        self._cache = NULL
+        return self
+
+    def clear_cache(self):
+        R"""Remove all cached NeighborLists, keeping the cache enabled.
+
+        Returns:
+            :class:`~.NeighborQuery`: This object.
+        """
+        if self._cache != NULL:
+            self._cache.clear()
+        return self
+
+    @property
+    def cache_info(self):
+        """dict: The statistics of the cache of NeighborLists, or
+        :code:`None` if it is not enabled. The keys are :code:`size` and
+        :code:`max_size`, the current and maximum numbers of NeighborLists
+        kept, :code:`hits`, the number of requests answered by a cached
+        NeighborList, :code:`derived`, the number of requests answered by
+        selecting bonds from a cached NeighborList of a larger query, and
+        :code:`queries`, the number of requests answered by querying the
+        points."""
+        if self._cache == NULL:
+            return None
+        return dict(size=self._cache.getSize(),
+                    max_size=self._cache.getMaxSize(),
+                    hits=self._cache.getNumHits(),
+                    derived=self._cache.getNumDerived(),
+                    queries=self._cache.getNumQueries())
+
+    def _cached_neighbor_list(self, _QueryArgs qargs):
+        # Get the NeighborList of a query of the points against themselves
+        # from the cache, which must be enabled.
+        cdef shared_ptr[freud._locality.NeighborList] c_nlist
+        with nogil:
+            c_nlist = self._cache.get(dereference(qargs.thisptr))
+        return _nlist_from_shared(c_nlist)
+
     def plot(self, ax=None, title=None, *args, **kwargs):
         """Plot system box and points.
 
@@ -530,7 +864,7 @@ cdef class NeighborList:
         cdef const unsigned int[::1] l_point_indices = point_indices
         cdef const float[::1] l_distances = distances
         cdef const float[::1] l_weights = weights
-        cdef unsigned int l_num_bonds = l_query_point_indices.shape[0]
+        cdef size_t l_num_bonds = l_query_point_indices.shape[0]
         cdef unsigned int l_num_query_points = num_query_points
         cdef unsigned int l_num_points = num_points
 
@@ -555,7 +889,7 @@ cdef class NeighborList:
         if self._managed:
             del self.thisptr
 
-    cdef freud._locality.NeighborList * get_ptr(self):
+    cdef freud._locality.NeighborList * get_ptr(self) nogil:
         R"""Returns a pointer to the raw C++ object we are wrapping."""
         return self.thisptr
 
@@ -574,6 +908,7 @@ cdef class NeighborList:
         """
         if other is not None:
             assert isinstance(other, NeighborList)
+            self._check_modifiable()
             self.copy_c(other)
             return self
         else:
@@ -593,7 +928,9 @@ cdef class NeighborList:
         each bond. This array is read-only to prevent breakage of
         :meth:`~.find_first_index()`. Equivalent to indexing with
         :code:`[:, 0]`."""
-        return self[:, 0]
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getQueryPointIndices(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     @property
     def point_indices(self):
@@ -601,7 +938,9 @@ cdef class NeighborList:
         bond. This array is read-only to prevent breakage of
         :meth:`~.find_first_index()`. Equivalent to indexing with :code:`[:,
         1]`."""
-        return self[:, 1]
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPointIndices(),
+            freud.util.arr_type_t.UNSIGNED_INT)
 
     @property
     def weights(self):
@@ -619,13 +958,36 @@ cdef class NeighborList:
             &self.thisptr.getDistances(),
             freud.util.arr_type_t.FLOAT)
 
+    @property
+    def vectors(self):
+        """(:math:`N_{bonds}`, 3) :class:`np.ndarray`: The vector from each
+        query point to its neighbor point, wrapped into the box, or
+        :code:`None` if this NeighborList does not store bond vectors.
+        NeighborLists created from queries or by
+        :class:`~freud.locality.Voronoi` store bond vectors."""
+        if not self.thisptr.hasVectors():
+            return None
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getVectors(),
+            freud.util.arr_type_t.FLOAT, 3)
+
+    @property
+    def half(self):
+        """bool: Whether this is a half NeighborList, which holds each pair
+        of points once, as the bond from the smaller index to the larger.
+        Half NeighborLists are found by queries with :code:`half=True`, see
+        :ref:`querying`."""
+        return self.thisptr.isHalf()
+
     @property
     def segments(self):
         """(:math:`N_{query\\_points}`) :class:`np.ndarray`: A segment array
-        indicating the first bond index for each query point."""
+        indicating the first bond index for each query point. Query points
+        without bonds have the index where their bonds would be, which is the
+        number of bonds of all previous query points."""
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getSegments(),
-            freud.util.arr_type_t.UNSIGNED_INT)
+            freud.util.arr_type_t.SIZE_T)
 
     @property
     def neighbor_counts(self):
@@ -666,6 +1028,7 @@ cdef class NeighborList:
         filt = np.ascontiguousarray(filt, dtype=np.bool)
         cdef np.ndarray[np.uint8_t, ndim=1, cast=True] filt_c = filt
         cdef cbool * filt_ptr = <cbool*> &filt_c[0]
+        self._check_modifiable()
         self.thisptr.filter(filt_ptr)
         return self
 
@@ -679,9 +1042,17 @@ cdef class NeighborList:
                 Minimum bond distance in the resulting neighbor list
                 (Default value = :code:`0`).
         """
+        self._check_modifiable()
         self.thisptr.filter_r(r_max, r_min)
         return self
 
+    def _check_modifiable(self):
+        if self._shared.get() != NULL:
+            raise ValueError(
+                "This NeighborList is shared by the NeighborList cache of a "
+                "NeighborQuery and cannot be modified. Modify a copy() "
+                "instead.")
+
 
 cdef NeighborList _nlist_from_cnlist(freud._locality.NeighborList *c_nlist):
     """Create a Python NeighborList object that points to an existing C++
@@ -702,6 +1073,259 @@ cdef NeighborList _nlist_from_cnlist(freud._locality.NeighborList *c_nlist):
     return result
 
 
+cdef NeighborList _nlist_from_shared(
+        shared_ptr[freud._locality.NeighborList] c_nlist):
+    """Create a Python NeighborList object that shares ownership of a C++
+    NeighborList object, such as a NeighborList from a
+    :class:`~.NeighborQuery` cache, which cannot be modified."""
+    cdef NeighborList result = _nlist_from_cnlist(c_nlist.get())
+    result._shared = c_nlist
+    return result
+
+
+_DISTANCE_STORAGES = {
+    'full': freud._locality.distances_full,
+    'quantized': freud._locality.distances_quantized,
+    'none': freud._locality.distances_none}
+
+
+cdef class CompressedNeighborList:
+    R"""Compact storage of the bonds of a :class:`~.NeighborList`.
+
+    A :class:`~.NeighborList` stores 16 bytes per bond. A compressed list
+    does not store the query point indices, which are implicit from the
+    bonds of each query point, stores the differences between the
+    consecutive point indices of each query point with one or two bytes for
+    most bonds, and only stores the weights if they are not all equal, so
+    that lists take about 3 to 8 times less memory, depending on how the
+    distances are stored. The bond vectors are not stored.
+
+    Compressed lists can be passed as the :code:`neighbors` of computes,
+    which decompress them for the points being computed.
+
+    Args:
+        nlist (:class:`~.NeighborList`):
+            The NeighborList, whose bonds must be sorted by query point index.
+        distances (str, optional):
+            How to store the distances: :code:`'full'` stores them as floats,
+            :code:`'quantized'` rounds them to 16-bit fractions of the largest
+            distance, and :code:`'none'` does not store them, in which case
+            they are recomputed from the points when the list is
+            decompressed (Default value = :code:`'full'`).
+    """
+
+    def __cinit__(self, NeighborList nlist, distances='full'):
+        if distances not in _DISTANCE_STORAGES:
+            raise ValueError(
+                "distances must be one of {}.".format(
+                    ", ".join("'{}'".format(d) for d in _DISTANCE_STORAGES)))
+        self.thisptr = new freud._locality.CompressedNeighborList(
+            dereference(nlist.get_ptr()), _DISTANCE_STORAGES[distances])
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def __len__(self):
+        return self.thisptr.getNumBonds()
+
+    @property
+    def num_query_points(self):
+        """unsigned int: The number of query points."""
+        return self.thisptr.getNumQueryPoints()
+
+    @property
+    def num_points(self):
+        """unsigned int: The number of points."""
+        return self.thisptr.getNumPoints()
+
+    @property
+    def half(self):
+        """bool: Whether each pair of points is stored once (see
+        :attr:`NeighborList.half`)."""
+        return self.thisptr.isHalf()
+
+    @property
+    def distances(self):
+        """str: How the distances are stored."""
+        storage = self.thisptr.getDistanceStorage()
+        return next(name for name, value in _DISTANCE_STORAGES.items()
+                    if value == storage)
+
+    @property
+    def nbytes(self):
+        """int: The number of bytes used to store the bonds."""
+        return self.thisptr.getNumBytes()
+
+    def to_neighbor_list(self, system=None, query_points=None):
+        R"""Decompress the bonds into a :class:`~.NeighborList`.
+
+        Args:
+            system (:class:`freud.locality.NeighborQuery` or system-like object, optional):
+                The points of the bonds, required if the distances are not
+                stored. If given, the bond vectors of the NeighborList are
+                computed from the points (Default value = :code:`None`).
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                The query points of the bonds. Uses the points of the system
+                if :code:`None` (Default value = :code:`None`).
+
+        Returns:
+            :class:`~.NeighborList`: The decompressed bonds.
+        """  # noqa: E501
+        cdef NeighborQuery nq
+        cdef const float[:, ::1] l_query_points
+        cdef freud._locality.NeighborQuery * nqptr = NULL
+        cdef const vec3[float]* query_points_ptr = NULL
+        cdef freud._locality.NeighborList * cnlist
+        if system is not None:
+            nq = NeighborQuery.from_system(system)
+            if query_points is None:
+                query_points = nq.points
+            else:
+                query_points = freud.util._convert_array(
+                    query_points, shape=(self.num_query_points, 3))
+            l_query_points = query_points
+            nqptr = nq.get_ptr()
+            if l_query_points.shape[0] > 0:
+                query_points_ptr = <vec3[float]*> &l_query_points[0, 0]
+            if l_query_points.shape[0] != self.num_query_points:
+                raise ValueError(
+                    "The number of query points must match the number of "
+                    "query points of the compressed NeighborList.")
+        cnlist = self.thisptr.toNeighborList(nqptr, query_points_ptr)
+        cdef NeighborList nl = _nlist_from_cnlist(cnlist)
+        nl._managed = True
+        return nl
+
+    def __repr__(self):
+        return ("freud.locality.{cls}(num_bonds={num_bonds}, "
+                "distances='{distances}')").format(
+                    cls=type(self).__name__, num_bonds=len(self),
+                    distances=self.distances)
+
+
+cdef class BondGeometry:
+    R"""Directions and spherical harmonics of the bonds of a
+    :class:`~.NeighborList`, shared by computes of the same frame.
+
+    :class:`freud.order.Steinhardt`, :class:`freud.order.SolidLiquid`,
+    :class:`freud.environment.LocalDescriptors` and
+    :class:`freud.environment.BondOrder` all evaluate the directions of the
+    bonds they are given, and the first three also evaluate their spherical
+    harmonics. A bond geometry can be passed as the :code:`neighbors` of these
+    computes, which then use its bonds and read its quantities instead of
+    evaluating them again, so that analyses running several of them on a
+    frame evaluate the spherical harmonics once.
+
+    The unit vectors, the angles and the spherical harmonics are each computed
+    on first use. :class:`~freud.environment.LocalDescriptors` reads the
+    harmonics only in the :code:`'global'` mode and
+    :class:`~freud.environment.BondOrder` reads the angles only in the
+    :code:`'bod'` mode, since other modes rotate the bonds of each point.
+
+    Args:
+        system:
+            Any object that is a valid argument to
+            :class:`freud.locality.NeighborQuery.from_system`.
+        neighbors (:class:`freud.locality.NeighborList` or dict):
+            Either a :class:`NeighborList <freud.locality.NeighborList>` of
+            the bonds, which is copied, or a dictionary of `query arguments
+            <https://freud.readthedocs.io/en/stable/topics/querying.html>`_.
+        l_max (unsigned int, optional):
+            Largest :math:`l` of the spherical harmonics, which must be at
+            least the largest :math:`l` of the computes reading them (Default
+            value = 0).
+        query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+            The query points of the bonds. Uses the points of the system if
+            :code:`None` (Default value = :code:`None`).
+    """  # noqa: E501
+
+    def __cinit__(self, system, neighbors, l_max=0, query_points=None):
+        cdef NeighborQuery nq = NeighborQuery.from_system(system)
+        if type(neighbors) == NeighborList:
+            self._nlist = neighbors.copy()
+        else:
+            self._nlist = _make_default_nlist(nq, neighbors, query_points)
+        if query_points is None:
+            query_points = nq.points
+        query_points = freud.util._convert_array(
+            query_points, shape=(self._nlist.thisptr.getNumQueryPoints(), 3))
+        cdef const float[:, ::1] l_query_points = query_points
+        cdef const vec3[float]* query_points_ptr = NULL
+        if l_query_points.shape[0] > 0:
+            query_points_ptr = <vec3[float]*> &l_query_points[0, 0]
+        self.thisptr = new freud._locality.BondGeometry(
+            self._nlist.get_ptr(), nq.get_ptr(), query_points_ptr, l_max)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def __len__(self):
+        return self.thisptr.getNumBonds()
+
+    @property
+    def nlist(self):
+        """:class:`freud.locality.NeighborList`: The bonds."""
+        return self._nlist
+
+    @property
+    def l_max(self):
+        """unsigned int: Largest :math:`l` of the spherical harmonics."""
+        return self.thisptr.getLMax()
+
+    @property
+    def vectors(self):
+        """(:math:`N_{bonds}`, 3) :class:`numpy.ndarray`: The vector from each
+        query point to its neighbor point, wrapped into the box."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getVectors(), freud.util.arr_type_t.FLOAT, 3)
+
+    @property
+    def unit_vectors(self):
+        """(:math:`N_{bonds}`, 3) :class:`numpy.ndarray`: The unit vector of
+        each bond. Bonds of zero length point along :math:`z`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getUnitVectors(), freud.util.arr_type_t.FLOAT, 3)
+
+    @property
+    def theta(self):
+        """(:math:`N_{bonds}`) :class:`numpy.ndarray`: The azimuthal angle of
+        each bond in :math:`[0, 2\\pi)`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getTheta(), freud.util.arr_type_t.FLOAT)
+
+    @property
+    def phi(self):
+        """(:math:`N_{bonds}`) :class:`numpy.ndarray`: The polar angle of each
+        bond in :math:`[0, \\pi]`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getPhi(), freud.util.arr_type_t.FLOAT)
+
+    @property
+    def harmonics(self):
+        """(:math:`N_{bonds}`, :math:`(l_{max} + 1)^2`) :class:`numpy.ndarray`:
+        The spherical harmonics :math:`Y_l^m` of each bond, including the
+        Condon-Shortley phase, for all :math:`l \\le l_{max}`. The
+        :math:`2l + 1` values of each :math:`l` start at column :math:`l^2`
+        and are ordered as :math:`m = 0, 1, \\ldots, l, -1, \\ldots,
+        -l`."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getHarmonics(),
+            freud.util.arr_type_t.COMPLEX_FLOAT)
+
+    def __repr__(self):
+        return "freud.locality.{cls}(num_bonds={num_bonds}, l_max={l_max})" \
+            .format(cls=type(self).__name__, num_bonds=len(self),
+                    l_max=self.l_max)
+
+
+cdef freud._locality.BondGeometry * _bond_geometry_ptr(neighbors):
+    R"""Return the C++ bond geometry of the neighbors of a compute, or NULL if
+    they are not a :class:`BondGeometry`."""
+    if type(neighbors) == BondGeometry:
+        return (<BondGeometry> neighbors).thisptr
+    return NULL
+
+
 def _make_default_nq(neighbor_query):
     R"""Helper function to return a NeighborQuery object.
 
@@ -768,10 +1392,69 @@ def _make_default_nlist(system, neighbors, query_points=None):
         query_args = neighbors.copy()
         query_args.setdefault('exclude_ii', query_points is None)
         nq = _make_default_nq(system)
+        if query_points is None and nq._cache != NULL:
+            return nq._cached_neighbor_list(_QueryArgs.from_dict(query_args))
         qp = query_points if query_points is not None else nq.points
         return nq.query(qp, query_args).toNeighborList()
 
 
+def _convert_memory_budget(memory_budget):
+    R"""Convert the memory budget of a compute to the value of its C++ object,
+    where 0 means that the bonds are never chunked."""
+    if memory_budget is None:
+        return 0
+    if memory_budget < 1:
+        raise ValueError("The memory budget must be a positive number of "
+                         "bytes or None.")
+    return int(memory_budget)
+
+
+def _get_memory_budget(memory_budget):
+    R"""Convert the memory budget of the C++ object of a compute to that of
+    the compute."""
+    return None if memory_budget == 0 else memory_budget
+
+
+def set_default_backend(selection):
+    R"""Set how neighbors are found when computes are given raw points.
+
+    Computes given a :code:`(box, points)` tuple instead of a
+    :class:`NeighborQuery` build a data structure for the points on the first
+    query. The choice applies to all later computes in the process.
+
+    Args:
+        selection (str):
+            One of :code:`'aabb'`, to always build an :class:`AABBQuery`;
+            :code:`'auto'`, to build a :class:`LinkCell` for nearest
+            neighbor queries of more than an eighth of the points, which it
+            answers faster, and an :class:`AABBQuery` otherwise; or
+            :code:`'calibrated'`, to time both data structures on the first
+            system of each kind (query mode, dimensions, and the powers of
+            two of the number of points and neighbors) and build the faster
+            one for all systems of that kind. A :class:`LinkCell` is only
+            built if all points are inside the box. The neighbors found do
+            not depend on the choice. (Default value = :code:`'aabb'`).
+    """
+    if selection not in _BACKEND_SELECTIONS:
+        raise ValueError(
+            "The selection must be one of {}.".format(
+                sorted(_BACKEND_SELECTIONS)))
+    freud._locality.setBackendSelection(_BACKEND_SELECTIONS[selection])
+
+
+def get_default_backend():
+    R"""Get how neighbors are found when computes are given raw points.
+
+    Returns:
+        str: The selection (see :func:`set_default_backend`).
+    """
+    cdef freud._locality.BackendSelection selection = \
+        freud._locality.getBackendSelection()
+    for name, value in _BACKEND_SELECTIONS.items():
+        if value == selection:
+            return name
+
+
 cdef class _RawPoints(NeighborQuery):
     R"""Class containing :class:`~.box.Box` and points with no spatial data
     structures for accelerating neighbor queries."""
@@ -805,26 +1488,83 @@ cdef class AABBQuery(NeighborQuery):
             Simulation box.
         points ((:math:`N`, 3) :class:`numpy.ndarray`):
             The points to use to build the tree.
+        spatial_sort (bool, optional):
+            If True, the tree is built over a copy of the points sorted along
+            a space-filling (Morton) curve, and neighbor queries over the same
+            points are processed in that order. This improves memory locality
+            for points in arbitrary order without changing any results
+            (Default value = :code:`False`).
+        ghost_width (float, optional):
+            If positive, a second tree is built over the points padded with
+            their periodic images within this distance of the box (ghosts).
+            Queries with :code:`r_max` up to this distance then traverse
+            this tree once instead of traversing the tree once per periodic
+            image, which is faster for small :code:`r_max` at the cost of
+            building and storing the second tree. The neighbors found are
+            the same, but distances may differ by rounding. Ghosts are only
+            used when all query points are in the box, and the width must be
+            less than half the box (Default value = 0).
+        point_types ((:math:`N`) :class:`numpy.ndarray`, optional):
+            Integer type of each point. If provided, queries with the
+            :code:`point_type` and :code:`query_point_type` query arguments
+            only find the neighbors of the given types, using a separate
+            tree over the points of each type that is built and
+            updated with this object (Default value = :code:`None`).
     """
 
-    def __cinit__(self, box, points):
+    def __cinit__(self, box, points, spatial_sort=False, ghost_width=0,
+                  point_types=None):
         cdef const float[:, ::1] l_points
         cdef freud.box.Box b
         if type(self) is AABBQuery:
             # Assume valid set of arguments is passed
             b = freud.util._convert_box(box)
             self.points = freud.util._convert_array(
-                points, shape=(None, 3)).copy()
+                points, shape=(None, 3), copy=True)
             l_points = self.points
             self.thisptr = self.nqptr = new freud._locality.AABBQuery(
                 dereference(b.thisptr),
                 <vec3[float]*> &l_points[0, 0],
-                self.points.shape[0])
+                self.points.shape[0], spatial_sort, ghost_width)
+            self._set_point_types(point_types)
 
     def __dealloc__(self):
         if type(self) is AABBQuery:
             del self.thisptr
 
+    @property
+    def ghost_width(self):
+        """float: The width of the layer of ghosts around the box, zero if
+        there are none."""
+        return self.thisptr.getGhostWidth()
+
+    def update(self, points):
+        R"""Update the point positions without rebuilding from scratch.
+
+        The tree topology is kept and its bounding boxes are refit to the
+        new positions. Queries remain exact, but become slower if points move
+        far from the positions the tree was built with, in which case a new
+        :class:`~.AABBQuery` should be constructed. The number of points must not change.
+        Ghosts, if any, are regenerated, and cached NeighborLists are
+        removed.
+
+        Args:
+            points ((:math:`N`, 3) :class:`numpy.ndarray`):
+                The new point positions.
+
+        Returns:
+            :class:`~.AABBQuery`: This object.
+        """
+        cdef const float[:, ::1] l_points
+        new_points = freud.util._convert_array(
+            points, shape=(self.points.shape[0], 3), copy=True)
+        l_points = new_points
+        with nogil:
+            self.thisptr.update(<vec3[float]*> &l_points[0, 0])
+        self.points = new_points
+        self.clear_cache()
+        return self
+
 
 cdef class LinkCell(NeighborQuery):
     R"""Supports efficiently finding all points in a set within a certain
@@ -841,18 +1581,31 @@ cdef class LinkCell(NeighborQuery):
             Width of cells. If not provided, :class:`~.LinkCell` will
             estimate a cell width based on the number of points and the box
             size, assuming a constant density of points in the box.
+        spatial_sort (bool, optional):
+            If True, neighbor queries over the same points are processed in
+            the order of a space-filling (Morton) curve, which improves memory
+            locality for points in arbitrary order without changing any
+            results (Default value = :code:`False`).
+        point_types ((:math:`N`) :class:`numpy.ndarray`, optional):
+            Integer type of each point. If provided, queries with the
+            :code:`point_type` and :code:`query_point_type` query arguments
+            only find the neighbors of the given types, using a separate
+            cell list over the points of each type that is built and
+            updated with this object (Default value = :code:`None`).
     """
 
-    def __cinit__(self, box, points, cell_width=0):
+    def __cinit__(self, box, points, cell_width=0, spatial_sort=False,
+                  point_types=None):
         cdef freud.box.Box b = freud.util._convert_box(box)
         cdef const float[:, ::1] l_points
         self.points = freud.util._convert_array(
-            points, shape=(None, 3)).copy()
+            points, shape=(None, 3), copy=True)
         l_points = self.points
         self.thisptr = self.nqptr = new freud._locality.LinkCell(
             dereference(b.thisptr),
             <vec3[float]*> &l_points[0, 0],
-            self.points.shape[0], cell_width)
+            self.points.shape[0], cell_width, True, spatial_sort)
+        self._set_point_types(point_types)
 
     def __dealloc__(self):
         del self.thisptr
@@ -862,6 +1615,29 @@ cdef class LinkCell(NeighborQuery):
         """float: Cell width."""
         return self.thisptr.getCellWidth()
 
+    def update(self, points):
+        R"""Update the point positions without rebuilding from scratch.
+
+        The points are rebinned into the existing cells. The number of points must not change.
+        Cached NeighborLists are removed.
+
+        Args:
+            points ((:math:`N`, 3) :class:`numpy.ndarray`):
+                The new point positions.
+
+        Returns:
+            :class:`~.LinkCell`: This object.
+        """
+        cdef const float[:, ::1] l_points
+        new_points = freud.util._convert_array(
+            points, shape=(self.points.shape[0], 3), copy=True)
+        l_points = new_points
+        with nogil:
+            self.thisptr.update(<vec3[float]*> &l_points[0, 0])
+        self.points = new_points
+        self.clear_cache()
+        return self
+
 
 cdef class _PairCompute(_Compute):
     R"""Parent class for all compute classes in freud that depend on finding
@@ -904,7 +1680,8 @@ cdef class _PairCompute(_Compute):
         cdef NeighborList nlist
         cdef _QueryArgs qargs
 
-        nlist, qargs = self._resolve_neighbors(neighbors, query_points)
+        nlist, qargs = self._resolve_cached_neighbors(
+            nq, neighbors, query_points)
 
         if query_points is None:
             query_points = nq.points
@@ -915,7 +1692,17 @@ cdef class _PairCompute(_Compute):
         cdef unsigned int num_query_points = l_query_points.shape[0]
         return (nq, nlist, qargs, l_query_points, num_query_points)
 
+    def _supports_half_neighbors(self):
+        # Computes of quantities that are symmetric under the exchange of the
+        # points of a bond override this method to accept half neighbor
+        # lists, accumulating both directions of each pair.
+        return False
+
     def _resolve_neighbors(self, neighbors, query_points=None):
+        # Bond geometries are resolved to their bonds, and computes that read
+        # their quantities get them from the neighbors argument.
+        if type(neighbors) == BondGeometry:
+            neighbors = neighbors.nlist
         if type(neighbors) == NeighborList:
             nlist = neighbors
             qargs = _QueryArgs()
@@ -934,14 +1721,49 @@ cdef class _PairCompute(_Compute):
         else:
             raise ValueError('An invalid value was provided for neighbors, '
                              'which must be a dict or NeighborList object.')
+        half = nlist.half if type(neighbors) == NeighborList else qargs.half
+        if half and not self._supports_half_neighbors():
+            raise ValueError("{} does not support half neighbor lists.".format(
+                type(self).__name__))
         return nlist, qargs
 
+    def _resolve_cached_neighbors(self, NeighborQuery nq, neighbors,
+                                  query_points=None):
+        # Compressed lists are decompressed for the points being computed.
+        if type(neighbors) == CompressedNeighborList:
+            neighbors = neighbors.to_neighbor_list(nq, query_points)
+        # Self queries of a NeighborQuery with a cache reuse cached bonds.
+        nlist, qargs = self._resolve_neighbors(neighbors, query_points)
+        if (query_points is None and nq._cache != NULL and
+                type(neighbors) not in (NeighborList, BondGeometry)):
+            nlist = nq._cached_neighbor_list(qargs)
+            qargs = _QueryArgs()
+        return nlist, qargs
+
+    def _resolve_trajectory_neighbors(self, neighbors):
+        # A NeighborList only describes the bonds of one frame, so the bonds
+        # of each frame of a trajectory are found using query arguments.
+        if type(neighbors) == NeighborList:
+            raise ValueError("Trajectories must be computed with a dict of "
+                             "query arguments, not a NeighborList.")
+        return self._resolve_neighbors(neighbors)[1]
+
     @property
     def default_query_args(self):
         """No default query arguments."""
         raise NotImplementedError(
             NO_DEFAULT_QUERY_ARGS_MESSAGE.format(type(self).__name__))
 
+    cdef void _add_pipeline_stage(
+            self, freud._locality.NeighborPipeline *pipeline,
+            dict stage_arrays) except *:
+        # Computes that can consume the bonds of a shared traversal override
+        # this method to add their stage to the pipeline. The arrays in
+        # stage_arrays are kept alive by the caller for the whole traversal.
+        raise TypeError(
+            "{} cannot be computed in a NeighborPipeline.".format(
+                type(self).__name__))
+
 
 cdef class _SpatialHistogram(_PairCompute):
     R"""Parent class for all compute classes in freud that perform a spatial
@@ -999,10 +1821,73 @@ cdef class _SpatialHistogram(_PairCompute):
         histogram"""
         return list(self.histptr.getAxisSizes())
 
+    @property
+    def accumulation_strategy(self):
+        """str: How bonds are accumulated into the histogram in parallel, one
+        of :code:`'auto'`, :code:`'thread_local'`, :code:`'tiled'`,
+        :code:`'atomic'` or :code:`'sparse'`. The default :code:`'auto'` keeps
+        a copy of the histogram on each thread unless the copies would use
+        too much memory. Setting the strategy resets the histogram."""
+        return freud.util._accumulation_strategy_name(
+            self.histptr.getAccumulationStrategy())
+
+    @accumulation_strategy.setter
+    def accumulation_strategy(self, strategy):
+        self.histptr.setAccumulationStrategy(
+            freud.util._convert_accumulation_strategy(strategy))
+
     def _reset(self):
         # Resets the values of RDF in memory.
         self.histptr.reset()
 
+    def serialize(self):
+        R"""Serialize the accumulated histogram into a compact binary state.
+
+        The state contains the raw bin counts of all frames accumulated since
+        the last reset and the counters that normalize them: the number of
+        frames, and the box and numbers of points of the last frame. It does
+        not contain any points. A compute of the same class constructed with
+        the same bins can restore the state with :meth:`~.deserialize` or add
+        it to its own with :meth:`~.merge`, so that trajectories split over
+        many jobs can be reduced without computing them again.
+
+        Returns:
+            bytes: The serialized state.
+        """
+        return self.histptr.serialize()
+
+    def deserialize(self, data):
+        R"""Replace the accumulated histogram with a serialized state.
+
+        Args:
+            data (bytes):
+                A state returned by :meth:`~.serialize` of a compute of the
+                same class with the same bins.
+        """
+        self._load_state(bytes(data), False)
+        return self
+
+    def merge(self, other):
+        R"""Add the accumulated histogram of another compute to this one.
+
+        The result is the same as if the frames of both computes had been
+        accumulated by this one, normalized by the system of the last frame
+        of :code:`other`.
+
+        Args:
+            other (compute or bytes):
+                A compute of the same class with the same bins, or a state
+                returned by its :meth:`~.serialize`.
+        """
+        if isinstance(other, _SpatialHistogram):
+            other = other.serialize()
+        self._load_state(bytes(other), True)
+        return self
+
+    def _load_state(self, data, merge):
+        self.histptr.deserialize(data, merge)
+        self._called_compute = True
+
 
 cdef class _SpatialHistogram1D(_SpatialHistogram):
     R"""Subclasses _SpatialHistogram to provide a simplified API for
@@ -1086,7 +1971,9 @@ cdef class PeriodicBuffer(_Compute):
         else:
             raise ValueError('buffer must be a scalar or have length 3.')
 
-        self.thisptr.compute(nq.get_ptr(), buffer_vec, images)
+        cdef cbool l_images = images
+        with nogil:
+            self.thisptr.compute(nq.get_ptr(), buffer_vec, l_images)
         return self
 
     @_Compute._computed_property
@@ -1129,10 +2016,28 @@ cdef class Voronoi(_Compute):
 
     The voro++ library :cite:`Rycroft2009` is used for fast computations of the
     Voronoi diagram.
+
+    Computing only the outputs that are needed saves time and memory for large
+    systems. With :code:`outputs='neighbors'`, only the weighted
+    :attr:`nlist` is computed. With :code:`outputs='volumes'`, the
+    :attr:`volumes` are computed as well, and the default
+    :code:`outputs='polytopes'` also computes the :attr:`polytopes`. Accessing
+    an output that was not computed raises an :class:`AttributeError`.
+
+    Args:
+        outputs (str, optional):
+            Outputs to compute, one of :code:`'neighbors'`, :code:`'volumes'`
+            or :code:`'polytopes'` (Default value = :code:`'polytopes'`).
     """
 
-    def __cinit__(self):
-        self.thisptr = new freud._locality.Voronoi()
+    def __cinit__(self, outputs='polytopes'):
+        try:
+            self.thisptr = new freud._locality.Voronoi(
+                _VORONOI_OUTPUTS[outputs])
+        except KeyError:
+            raise ValueError(
+                "Unknown outputs: {}. Options are {}.".format(
+                    outputs, ", ".join(_VORONOI_OUTPUTS)))
         self._nlist = NeighborList()
 
     def __dealloc__(self):
@@ -1147,7 +2052,8 @@ cdef class Voronoi(_Compute):
                 :class:`freud.locality.NeighborQuery.from_system`.
         """
         cdef NeighborQuery nq = NeighborQuery.from_system(system)
-        self.thisptr.compute(nq.get_ptr())
+        with nogil:
+            self.thisptr.compute(nq.get_ptr())
         self._box = nq.box
         return self
 
@@ -1155,29 +2061,20 @@ cdef class Voronoi(_Compute):
     def polytopes(self):
         """list[:class:`numpy.ndarray`]: A list of :class:`numpy.ndarray`
         defining Voronoi polytope vertices for each cell."""
-        polytopes = []
-        cdef vector[vector[vec3[double]]] raw_polytopes = \
-            self.thisptr.getPolytopes()
-        cdef size_t i
-        cdef size_t j
-        cdef size_t num_verts
-        cdef vector[vec3[double]] raw_vertices
-        cdef double[:, ::1] polytope_vertices
-        for i in range(raw_polytopes.size()):
-            raw_vertices = raw_polytopes[i]
-            num_verts = raw_vertices.size()
-            polytope_vertices = np.empty((num_verts, 3), dtype=np.float64)
-            for j in range(num_verts):
-                polytope_vertices[j, 0] = raw_vertices[j].x
-                polytope_vertices[j, 1] = raw_vertices[j].y
-                polytope_vertices[j, 2] = raw_vertices[j].z
-            polytopes.append(np.asarray(polytope_vertices))
-        return polytopes
+        self._check_output('polytopes')
+        vertices = freud.util.make_managed_numpy_array(
+            &self.thisptr.getPolytopeVertices(),
+            freud.util.arr_type_t.DOUBLE, 3)
+        offsets = freud.util.make_managed_numpy_array(
+            &self.thisptr.getPolytopeOffsets(),
+            freud.util.arr_type_t.SIZE_T)
+        return np.split(vertices, offsets[1:-1])
 
     @_Compute._computed_property
     def volumes(self):
         """:math:`\\left(N_{points} \\right)` :class:`numpy.ndarray`: Returns
         an array of Voronoi cell volumes (areas in 2D)."""
+        self._check_output('volumes')
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getVolumes(),
             freud.util.arr_type_t.DOUBLE)
@@ -1204,9 +2101,24 @@ cdef class Voronoi(_Compute):
         self._nlist = _nlist_from_cnlist(self.thisptr.getNeighborList().get())
         return self._nlist
 
+    @property
+    def outputs(self):
+        """str: The outputs computed, one of :code:`'neighbors'`,
+        :code:`'volumes'` or :code:`'polytopes'`."""
+        for key, value in _VORONOI_OUTPUTS.items():
+            if value == self.thisptr.getOutputs():
+                return key
+
+    def _check_output(self, output):
+        # Outputs are ordered, each including the previous ones.
+        if self.thisptr.getOutputs() < _VORONOI_OUTPUTS[output]:
+            raise AttributeError(
+                "The Voronoi {} were not computed with outputs='{}'.".format(
+                    output, self.outputs))
+
     def __repr__(self):
-        return "freud.locality.{cls}()".format(
-            cls=type(self).__name__)
+        return "freud.locality.{cls}(outputs='{outputs}')".format(
+            cls=type(self).__name__, outputs=self.outputs)
 
     def __str__(self):
         return repr(self)
@@ -1241,3 +2153,424 @@ cdef class Voronoi(_Compute):
             return freud.plot._ax_to_bytes(self.plot())
         except (AttributeError, ImportError):
             return None
+
+
+cdef class VerletList(_Compute):
+    R"""Find neighbors within a distance, reusing results across frames.
+
+    When analyzing a trajectory, particles typically move only a small
+    distance between frames. This class finds all neighbors within
+    :code:`r_max + skin` and stores the positions of all points when it does
+    so. On later calls to :meth:`compute`, if no point or query point has
+    moved farther than half of the skin, the stored bonds are guaranteed to
+    contain all bonds within :code:`r_max`. Their distances are then
+    recomputed for the new positions and filtered, avoiding a new neighbor
+    search. Otherwise, the stored bonds are rebuilt.
+
+    The resulting :class:`~.NeighborList` contains the same bonds as a ball
+    query with the same parameters.
+
+    Args:
+        r_max (float):
+            Distance within which neighbors are found.
+        skin (float):
+            Extra distance searched when the neighbors are rebuilt. Larger
+            values allow more frames to reuse the stored bonds, at the cost of
+            more bonds to check on each frame.
+        r_min (float, optional):
+            Minimum distance of neighbors (Default value = 0).
+        exclude_ii (bool, optional):
+            Whether to exclude bonds between a point and the query point with
+            the same index (Default value = :code:`False`).
+    """
+
+    def __cinit__(self, float r_max, float skin, float r_min=0,
+                  cbool exclude_ii=False):
+        self.thisptr = new freud._locality.VerletList(
+            r_max, skin, r_min, exclude_ii)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, query_points=None):
+        R"""Compute the neighbors for the current positions.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                Query points used to find neighbors. Uses the system's points
+                if :code:`None` (Default value = :code:`None`).
+        """
+        cdef NeighborQuery nq = NeighborQuery.from_system(system)
+        cdef const float[:, ::1] l_query_points
+        if query_points is None:
+            l_query_points = nq.points
+        else:
+            l_query_points = freud.util._convert_array(
+                query_points, shape=(None, 3))
+        cdef unsigned int num_query_points = l_query_points.shape[0]
+        with nogil:
+            self.thisptr.compute(
+                nq.get_ptr(), <vec3[float]*> &l_query_points[0, 0],
+                num_query_points)
+        return self
+
+    def reset(self):
+        R"""Force the stored bonds to be rebuilt on the next call to
+        :meth:`compute`."""
+        self.thisptr.reset()
+
+    @_Compute._computed_property
+    def nlist(self):
+        """:class:`~.locality.NeighborList`: The neighbors found in the last
+        call to :meth:`compute`."""
+        return _nlist_from_cnlist(self.thisptr.getNeighborList().get())
+
+    @property
+    def num_builds(self):
+        """int: The number of times the stored bonds have been rebuilt."""
+        return self.thisptr.getNumBuilds()
+
+    @property
+    def r_max(self):
+        """float: Distance within which neighbors are found."""
+        return self.thisptr.getRMax()
+
+    @property
+    def skin(self):
+        """float: Extra distance searched when the neighbors are rebuilt."""
+        return self.thisptr.getSkin()
+
+    def __repr__(self):
+        return "freud.locality.{cls}(r_max={r_max}, skin={skin})".format(
+            cls=type(self).__name__, r_max=self.r_max, skin=self.skin)
+
+    def __str__(self):
+        return repr(self)
+
+
+cdef class GSDTrajectory:
+    R"""Frames of a HOOMD-blue GSD file, read without copying.
+
+    The file is mapped into memory, and the points of each frame are read
+    directly from its :code:`particles/position` chunk. Passing the trajectory
+    as the :code:`points` of a :code:`compute_trajectory` method streams its
+    frames to the compute, and the operating system is asked to read each
+    frame from disk while the previous frames are accumulated, so that
+    reading the file overlaps with computation.
+
+    As in the HOOMD schema, frames without a :code:`particles/position` or
+    :code:`configuration/box` chunk use the chunk of the first frame. The
+    positions must be 32-bit floats, and every frame must have the same number
+    of particles.
+
+    Args:
+        filename (str):
+            Path of the GSD file.
+    """
+
+    def __cinit__(self, filename):
+        self._filename = str(filename)
+        self.thisptr.reset(new freud._locality.GSDFrameSource(
+            self._filename.encode('utf-8')))
+
+    def __len__(self):
+        return self.thisptr.get().getNFrames()
+
+    @property
+    def filename(self):
+        """str: Path of the GSD file."""
+        return self._filename
+
+    @property
+    def n_points(self):
+        """unsigned int: Number of points in each frame."""
+        return self.thisptr.get().getNPoints()
+
+    def __getitem__(self, frame):
+        """Get the box and the points of a frame.
+
+        The points are a read-only view of the file, which remains open
+        while the array exists.
+
+        Args:
+            frame (int):
+                Index of the frame.
+
+        Returns:
+            tuple (:class:`freud.box.Box`, (:math:`N_{points}`, 3) :class:`numpy.ndarray`):
+                The box and points of the frame.
+        """  # noqa: E501
+        cdef int n_frames = len(self)
+        cdef int index = frame
+        if index < 0:
+            index += n_frames
+        if index < 0 or index >= n_frames:
+            raise IndexError("Frame {} is out of range.".format(frame))
+
+        cdef const float* params = self.thisptr.get().getBoxParams(index)
+        if self.thisptr.get().is2D():
+            box = freud.box.Box(params[0], params[1], 0, params[3],
+                                is2D=True)
+        else:
+            box = freud.box.Box(params[0], params[1], params[2], params[3],
+                                params[4], params[5])
+
+        cdef np.npy_intp shape[2]
+        shape[0] = self.thisptr.get().getNPoints()
+        shape[1] = 3
+        cdef np.ndarray points = np.PyArray_SimpleNewFromData(
+            2, shape, np.NPY_FLOAT32,
+            <void*> self.thisptr.get().getPoints(index))
+        points.setflags(write=False)
+        PyArray_SetBaseObject(points, self)
+        Py_INCREF(self)
+        return box, points
+
+    def __iter__(self):
+        cdef unsigned int frame
+        for frame in range(len(self)):
+            self.thisptr.get().prefetch(frame + 1)
+            yield self[frame]
+
+    def __repr__(self):
+        return "freud.locality.{cls}({filename!r})".format(
+            cls=type(self).__name__, filename=self._filename)
+
+
+def _is_box_sequence(boxes):
+    R"""Check whether an argument is a sequence of box-like objects rather
+    than a single box-like object.
+
+    A single box may itself be given as a sequence, either of its parameters
+    or as the rows of a 3x3 box matrix (see :meth:`freud.box.Box.from_box`).
+
+    Args:
+        boxes (box-like object or sequence of box-like objects):
+            The argument to check.
+
+    Returns:
+        bool: Whether :code:`boxes` is a sequence of box-like objects.
+    """
+    if not isinstance(boxes, (list, tuple, np.ndarray)) or len(boxes) == 0:
+        return False
+    first = boxes[0]
+    if np.isscalar(first):
+        # The parameters of a single box.
+        return False
+    if np.ndim(first) == 0:
+        # Box objects, such as a :class:`freud.box.Box` or a dict.
+        return True
+    # The rows of a single box matrix.
+    return not (len(boxes) == 3
+                and all(np.shape(row) == (3,) for row in boxes))
+
+
+cdef class _Trajectory:
+    R"""Frames of points for computes that accumulate a whole trajectory.
+
+    The points are used without copying if they are a C-contiguous array of
+    32-bit floats, such as a file opened with :func:`numpy.load` and
+    :code:`mmap_mode='r'`, or a :class:`GSDTrajectory`. Frames are then read
+    from the file as they are accumulated.
+
+    Args:
+        boxes (box-like object or sequence of box-like objects):
+            The box of all frames, or a sequence containing the box of each
+            frame. Ignored if :code:`points` is a :class:`GSDTrajectory`.
+        points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`GSDTrajectory`):
+            The points of each frame.
+    """  # noqa: E501
+
+    def __cinit__(self, boxes, points):
+        if isinstance(points, GSDTrajectory):
+            self.source = points
+            self.n_frames = len(self.source)
+            self.n_points = self.source.n_points
+            if self.n_frames == 0 or self.n_points == 0:
+                raise ValueError("A trajectory must contain at least one "
+                                 "frame and one point.")
+            self.thisptr = new freud._locality.Trajectory(self.source.thisptr)
+            return
+
+        self.points = freud.util._convert_array(
+            points, shape=(None, None, 3))
+        self.n_frames = self.points.shape[0]
+        self.n_points = self.points.shape[1]
+        cdef unsigned int n_frames = self.n_frames
+        cdef unsigned int n_points = self.n_points
+        if n_frames == 0 or n_points == 0:
+            raise ValueError("A trajectory must contain at least one frame "
+                             "and one point.")
+
+        if _is_box_sequence(boxes):
+            box_list = [freud.util._convert_box(box) for box in boxes]
+        else:
+            box_list = [freud.util._convert_box(boxes)]
+        if len(box_list) not in (1, n_frames):
+            raise ValueError("The number of boxes ({}) must be 1 or the "
+                             "number of frames ({}).".format(
+                                 len(box_list), n_frames))
+        self.dimensions = box_list[0].dimensions
+        if any(box.dimensions != self.dimensions for box in box_list):
+            raise ValueError("All boxes of a trajectory must have the same "
+                             "dimensions.")
+        self.box_params = np.array(
+            [[box.Lx, box.Ly, box.Lz, box.xy, box.xz, box.yz]
+             for box in box_list], dtype=np.float32)
+
+        self.thisptr = new freud._locality.Trajectory(
+            <vec3[float]*> &self.points[0, 0, 0], &self.box_params[0, 0],
+            n_frames, n_points, len(box_list), self.dimensions == 2)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+
+cdef class NeighborPipeline(_PairCompute):
+    R"""Run several computes on the bonds of a single neighbor traversal.
+
+    Computing several quantities that depend on the same neighbors with
+    separate computes finds the neighbors of every query point once per
+    compute. This class instead finds the neighbors of each query point once
+    and passes them to every compute in turn, so the bonds of a query point
+    are reused while they are still in cache.
+
+    The bonds are found with the union of the computes' query arguments, and
+    each compute only uses the bonds within its own cutoff. Once
+    :meth:`compute` has been called, the results are read from the computes
+    themselves exactly as if each had been computed separately.
+
+    The following computes are supported:
+
+    * :class:`freud.density.LocalDensity`
+    * :class:`freud.density.RDF`
+    * :class:`freud.order.Steinhardt`, without :code:`average`. The query
+      points must be the system's points.
+    * :class:`freud.pmft.PMFTXYZ`, with a zero :code:`shiftvec`.
+
+    Args:
+        computes (sequence):
+            The computes to run on the shared traversal.
+    """
+
+    def __cinit__(self, computes):
+        self.thisptr = new freud._locality.NeighborPipeline()
+        self._computes = list(computes)
+        if len(self._computes) == 0:
+            raise ValueError("NeighborPipeline requires at least one compute.")
+        for compute in self._computes:
+            if not isinstance(compute, _PairCompute):
+                raise TypeError(
+                    "{} cannot be computed in a NeighborPipeline.".format(
+                        type(compute).__name__))
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, query_points=None, neighbors=None,
+                query_orientations=None, equiv_orientations=None,
+                reset=True):
+        R"""Runs all computes on the bonds of one neighbor traversal.
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            query_points ((:math:`N_{query\_points}`, 3) :class:`numpy.ndarray`, optional):
+                Query points used to find neighbors. Uses the system's points
+                if :code:`None` (Default value = :code:`None`).
+            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+                Either a :class:`NeighborList <freud.locality.NeighborList>` of
+                neighbor pairs to use in the calculation, or a dictionary of
+                `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_.
+                Query arguments must find all bonds within the largest cutoff
+                of the computes. Defaults to a ball query with that cutoff
+                (Default value: None).
+            query_orientations ((:math:`N_{query\_points}`, 4) :class:`numpy.ndarray`, optional):
+                Query orientations, required by computes of a
+                :class:`freud.pmft.PMFTXYZ` (Default value = :code:`None`).
+            equiv_orientations ((:math:`N_{faces}`, 4) :class:`numpy.ndarray`, optional):
+                Orientations to be treated as equivalent to account for
+                symmetry of the points in a :class:`freud.pmft.PMFTXYZ`. Uses
+                the identity if :code:`None` (Default value = :code:`None`).
+            reset (bool):
+                Whether to erase the previously accumulated values of computes
+                that accumulate, such as :class:`freud.density.RDF`, before
+                adding the new computation (Default value: True).
+        """  # noqa E501
+        cdef:
+            NeighborQuery nq
+            NeighborList nlist
+            _QueryArgs qargs
+            const float[:, ::1] l_query_points
+            unsigned int num_query_points
+            _PairCompute pair_compute
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, query_points, neighbors)
+
+        if query_orientations is not None:
+            query_orientations = freud.util._convert_array(
+                np.atleast_1d(query_orientations),
+                shape=(num_query_points, 4))
+        if equiv_orientations is None:
+            equiv_orientations = np.array([[1, 0, 0, 0]], dtype=np.float32)
+        else:
+            equiv_orientations = freud.util._convert_array(
+                equiv_orientations, shape=(None, 4))
+        stage_arrays = dict(query_orientations=query_orientations,
+                            equiv_orientations=equiv_orientations)
+
+        if reset:
+            for compute in self._computes:
+                if hasattr(compute, '_reset'):
+                    compute._reset()
+
+        # The stages hold raw pointers to the computes and to the arrays in
+        # stage_arrays, so they are only kept for the duration of the call.
+        try:
+            for compute in self._computes:
+                pair_compute = compute
+                pair_compute._add_pipeline_stage(self.thisptr, stage_arrays)
+            with nogil:
+                self.thisptr.compute(
+                    nq.get_ptr(), <vec3[float]*> &l_query_points[0, 0],
+                    num_query_points, dereference(qargs.thisptr),
+                    nlist.get_ptr())
+        finally:
+            self.thisptr.clearStages()
+
+        for compute in self._computes:
+            pair_compute = compute
+            pair_compute._called_compute = True
+        return self
+
+    @property
+    def default_query_args(self):
+        """The default query arguments are a ball query with the largest of
+        the computes' default cutoffs."""
+        r_max = 0
+        for compute in self._computes:
+            try:
+                query_args = compute.default_query_args
+            except NotImplementedError:
+                raise NotImplementedError(
+                    NO_DEFAULT_QUERY_ARGS_MESSAGE.format(
+                        type(compute).__name__))
+            r_max = max(r_max, query_args['r_max'])
+        return dict(mode="ball", r_max=r_max)
+
+    @property
+    def computes(self):
+        """list: The computes run on the shared traversal."""
+        return list(self._computes)
+
+    def __repr__(self):
+        return "freud.locality.{cls}(computes={computes})".format(
+            cls=type(self).__name__, computes=self._computes)
+
+    def __str__(self):
+        return repr(self)
@@ -7,57 +7,30 @@ mean-squared-displacement (MSD) of particles in periodic systems.
 """
 
 import numpy as np
-import freud.parallel
 import logging
 
-from freud.util cimport _Compute
+from cython.operator cimport dereference
+from freud.util cimport _Compute, vec3
+cimport freud._box
+cimport freud._msd
 cimport freud.box
+cimport freud.util
 cimport numpy as np
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 
 logger = logging.getLogger(__name__)
 
-# Use fastest available fft library
-try:
-    import pyfftw
-    logger.info("Using PyFFTW for FFTs")
-
-    pyfftw.config.NUM_THREADS = min(1, freud.parallel.get_num_threads())
-    logger.info("Setting number of threads to {}".format(
-        freud.parallel.get_num_threads()))
-
-    # Note that currently these functions are defined to match only the parts
-    # of the numpy/scipy API that are actually used below. There is no promise
-    # that other aspects of the API will be preserved.
-    def fft(x, n, axis):
-        a = pyfftw.empty_aligned(x.shape, 'complex64')
-        a[:] = x
-        fft_object = pyfftw.builders.fft(a, n=n, axis=axis)
-        return fft_object()
-
-    def ifft(x, axis):
-        a = pyfftw.empty_aligned(x.shape, 'complex64')
-        a[:] = x
-        fft_object = pyfftw.builders.ifft(a, axis=axis)
-        return fft_object()
-except ImportError:
-    try:
-        from scipy.fftpack import fft, ifft
-        logger.info("Using SciPy's fftpack for FFTs")
-    except ImportError:
-        from numpy.fft import fft, ifft
-        logger.info("Using NumPy for FFTs")
-
-
-def _autocorrelation(x):
-    R"""Compute the autocorrelation of a sequence"""
-    N = x.shape[0]
-    F = fft(x, n=2*N, axis=0)
-    PSD = F * F.conjugate()
-    res = ifft(PSD, axis=0)
-    res = (res[:N]).real
-    n = np.arange(1, N+1)[::-1]  # N to 1
-    return res/n[:, np.newaxis]
+_MSD_MODES = {
+    'window': freud._msd.msd_window,
+    'direct': freud._msd.msd_direct,
+}
+
+# Number of bytes of positions read at once from arrays that must be
+# converted, such as memory-mapped trajectories of double precision.
+_CHUNK_BYTES = 1 << 26
 
 
 cdef class MSD(_Compute):
@@ -91,22 +64,13 @@ cdef class MSD(_Compute):
       :cite:`calandrini2011nmoldyn` as described in `this StackOverflow thread
       <https://stackoverflow.com/questions/34222272/computing-mean-square-displacement-using-python-and-fft>`_.
 
-      .. note::
-          The most intensive part of this calculation is computing an FFT. To
-          maximize performance, freud attempts to use the fastest FFT library
-          available. By default, the order of preference is `pyFFTW
-          <https://github.com/pyFFTW/pyFFTW>`_, SciPy, and then NumPy. If you
-          are experiencing significant slowdowns in calculating the MSD, you
-          may benefit from installing a faster FFT library, which freud will
-          automatically detect. The performance change will be especially
-          noticeable if the length of your trajectory is a number whose prime
-          factorization consists of extremely large prime factors. The
-          standard Cooley-Tukey FFT algorithm performs very poorly in this
-          case, so installing pyFFTW will significantly improve performance.
-
-          Note that while pyFFTW is released under the BSD 3-Clause license,
-          the FFTW library is available under either GPL or a commercial
-          license.
+      The MSD of each particle is computed in parallel in C++, using
+      zero-padded fast Fourier transforms of the real coordinates of pairs of
+      particles packed into complex sequences. Positions are read and
+      unwrapped directly from the provided arrays, so memory-mapped
+      trajectories (e.g. :func:`numpy.load` with :code:`mmap_mode='r'`) of
+      single precision positions are never loaded as a whole. Other arrays
+      are converted in chunks of particles.
 
     * :code:`'direct'`:
       Under some circumstances, however, we may be more interested in
@@ -139,21 +103,25 @@ cdef class MSD(_Compute):
             Mode of calculation. Options are :code:`'window'` and
             :code:`'direct'`.  (Default value = :code:`'window'`).
     """   # noqa: E501
+    cdef freud._msd.MSD * thisptr
     cdef freud.box.Box _box
-    cdef _particle_msd
     cdef str mode
 
     def __cinit__(self, box=None, mode='window'):
+        cdef freud._box.Box l_box
         if box is not None:
             self._box = freud.util._convert_box(box)
+            l_box = dereference(self._box.thisptr)
         else:
             self._box = None
 
-        self._particle_msd = []
-
-        if mode not in ['window', 'direct']:
+        if mode not in _MSD_MODES:
             raise ValueError("Invalid mode")
         self.mode = mode
+        self.thisptr = new freud._msd.MSD(l_box, _MSD_MODES[mode])
+
+    def __dealloc__(self):
+        del self.thisptr
 
     def compute(self, positions, images=None, reset=True):
         """Calculate the MSD for the positions provided.
@@ -174,6 +142,8 @@ cdef class MSD(_Compute):
             positions ((:math:`N_{frames}`, :math:`N_{particles}`, 3) :class:`numpy.ndarray`):
                 The particle positions over a trajectory. If neither box nor images
                 are provided, the positions are assumed to be unwrapped already.
+                Single precision C-contiguous arrays, including memory-mapped
+                arrays, are read without copying.
             images ((:math:`N_{frames}`, :math:`N_{particles}`, 3) :class:`numpy.ndarray`, optional):
                 The particle images to unwrap with if provided. Must be provided
                 along with a simulation box (in the constructor) if particle
@@ -186,48 +156,60 @@ cdef class MSD(_Compute):
                 value: True).
         """  # noqa: E501
         if reset:
-            self._particle_msd = []
+            self.thisptr.reset()
+
+        positions = np.asarray(positions)
+        if positions.ndim != 3 or positions.shape[2] != 3:
+            raise ValueError(
+                "positions must have shape (N_frames, N_particles, 3).")
+        if self._box is None or images is None:
+            images = None
+        else:
+            images = np.asarray(images)
+            if images.shape != positions.shape:
+                raise ValueError("images must have the same shape as "
+                                 "positions.")
+
+        # Arrays that can be read directly are passed whole, and others are
+        # converted in chunks of particles to bound the memory used.
+        direct = (positions.dtype == np.float32
+                  and positions.flags['C_CONTIGUOUS']) and (
+                      images is None or (images.dtype == np.int32
+                                         and images.flags['C_CONTIGUOUS']))
+        n_frames, n_particles = positions.shape[:2]
+        if direct:
+            self._accumulate(positions, images, 0, n_particles)
+        else:
+            chunk_size = max(1, _CHUNK_BYTES // (12 * max(1, n_frames)))
+            for start in range(0, n_particles, chunk_size):
+                end = min(start + chunk_size, n_particles)
+                chunk_images = None
+                if images is not None:
+                    chunk_images = freud.util._convert_array(
+                        images[:, start:end], dtype=np.int32)
+                self._accumulate(
+                    freud.util._convert_array(positions[:, start:end]),
+                    chunk_images, 0, end - start)
 
         self._called_compute = True
+        return self
 
-        positions = freud.util._convert_array(
-            positions, shape=(None, None, 3))
+    def _accumulate(self, positions, images, start, end):
+        """Accumulate the particles from start to end of C-contiguous
+        single precision positions and 32 bit integer images."""
+        cdef const float[:, :, ::1] l_positions = positions
+        cdef const int[:, :, ::1] l_images
+        cdef const vec3[int]* images_ptr = NULL
         if images is not None:
-            images = freud.util._convert_array(
-                images, shape=positions.shape, dtype=np.int32)
-
-        # Make sure we aren't modifying the provided array
-        if self._box is not None and images is not None:
-            unwrapped_positions = positions.copy()
-            for i in range(positions.shape[0]):
-                unwrapped_positions[i, :, :] = self._box.unwrap(
-                    unwrapped_positions[i, :, :], images[i, :, :])
-            positions = unwrapped_positions
-
-        if self.mode == 'window':
-            # First compute the first term r^2(k+m) - r^2(k)
-            N = positions.shape[0]
-            D = np.square(positions).sum(axis=2)
-            D = np.append(D, np.zeros(positions.shape[:2]), axis=0)
-            Q = 2*D.sum(axis=0)
-            S1 = np.zeros(positions.shape[:2])
-            for m in range(N):
-                Q -= (D[m-1, :] + D[N-m, :])
-                S1[m, :] = Q/(N-m)
-
-            # The second term can be computed via autocorrelation
-            corrs = []
-            for i in range(positions.shape[2]):
-                corrs.append(_autocorrelation(positions[:, :, i]))
-            S2 = np.sum(corrs, axis=0)
-
-            self._particle_msd.append(S1 - 2*S2)
-        elif self.mode == 'direct':
-            self._particle_msd.append(
-                np.linalg.norm(
-                    positions - positions[[0], :, :], axis=-1)**2)
-
-        return self
+            l_images = images
+            images_ptr = <const vec3[int]*> &l_images[0, start, 0]
+        cdef const vec3[float]* positions_ptr = \
+            <const vec3[float]*> &l_positions[0, start, 0]
+        cdef unsigned int num_particles = end - start
+        with nogil:
+            self.thisptr.accumulate(
+                positions_ptr, images_ptr, l_positions.shape[0],
+                num_particles, l_positions.shape[1])
 
     @property
     def box(self):
@@ -238,13 +220,15 @@ cdef class MSD(_Compute):
     def msd(self):
         """:math:`\\left(N_{frames}, \\right)` :class:`numpy.ndarray`: The mean
         squared displacement."""
-        return np.concatenate(self._particle_msd, axis=1).mean(axis=-1)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getMSD(), freud.util.arr_type_t.FLOAT)
 
     @_Compute._computed_property
     def particle_msd(self):
         """:math:`\\left(N_{frames}, N_{particles} \\right)` :class:`numpy.ndarray`: The per
         particle based mean squared displacement."""  # noqa: E501
-        return np.concatenate(self._particle_msd, axis=1)
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getParticleMSD(), freud.util.arr_type_t.FLOAT)
 
     def __repr__(self):
         return "freud.msd.{cls}(box={box}, mode={mode})".format(
@@ -278,3 +262,194 @@ cdef class MSD(_Compute):
             return freud.plot._ax_to_bytes(self.plot())
         except (AttributeError, ImportError):
             return None
+
+
+cdef class MultipleTauMSD(_Compute):
+    R"""Compute the mean squared displacement frame by frame at
+    logarithmically spaced lags.
+
+    The windowed MSD of :class:`~.MSD` requires the full trajectory of each
+    particle. This class instead accumulates a trajectory one block of frames
+    at a time into a multiple-tau correlator of the unwrapped positions,
+    keeping only :code:`points_per_level` positions per level and particle,
+    so that the memory used grows with the logarithm of the trajectory
+    length.
+
+    The MSD is computed for all lags smaller than :code:`points_per_level`
+    frames, and for :math:`j \cdot d^k` frames at the level :math:`k > 0`,
+    where :math:`d` is the decimation and :math:`j` ranges from
+    :math:`\lceil p / d \rceil` to :math:`p - 1` for :code:`points_per_level`
+    :math:`p`. Level :math:`k` only stores every :math:`d^k`-th frame, so the
+    MSD at each lag is averaged over the windows starting at these frames,
+    rather than over all windows as in the :code:`'window'` mode of
+    :class:`~.MSD`.
+
+    .. note::
+        The MSD is only well-defined when the box is constant over the
+        course of the simulation. Additionally, the number of particles must be
+        constant over the course of the simulation.
+
+    Args:
+        box (:class:`freud.box.Box`, optional):
+            If not provided, the class will assume that all positions provided
+            in calls to :meth:`~compute` are already unwrapped. (Default value
+            = :code:`None`).
+        points_per_level (int, optional):
+            Number of frames kept per level. Must be larger than
+            :code:`decimation`. (Default value = 16).
+        decimation (int, optional):
+            Ratio of the sampling intervals of consecutive levels. Must be at
+            least 2. (Default value = 2).
+    """
+    cdef freud._msd.MultipleTauMSD * thisptr
+    cdef freud.box.Box _box
+
+    def __cinit__(self, box=None, points_per_level=16, decimation=2):
+        cdef freud._box.Box l_box
+        if box is not None:
+            self._box = freud.util._convert_box(box)
+            l_box = dereference(self._box.thisptr)
+        else:
+            self._box = None
+        self.thisptr = new freud._msd.MultipleTauMSD(
+            l_box, points_per_level, decimation)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, positions, images=None, reset=True):
+        """Accumulate consecutive frames of a trajectory.
+
+        Trajectories too long to keep in memory can be accumulated in
+        consecutive blocks of frames with :code:`reset=False`.
+
+        Args:
+            positions ((:math:`N_{frames}`, :math:`N_{particles}`, 3) or (:math:`N_{particles}`, 3) :class:`numpy.ndarray`):
+                The particle positions of consecutive frames, or of a single
+                frame. If neither box nor images are provided, the positions
+                are assumed to be unwrapped already.
+            images ((:math:`N_{frames}`, :math:`N_{particles}`, 3) or (:math:`N_{particles}`, 3) :class:`numpy.ndarray`, optional):
+                The particle images to unwrap with if provided. Must be provided
+                along with a simulation box (in the constructor) if particle
+                positions need to be unwrapped. (Default value = :code:`None`).
+            reset (bool):
+                Whether to erase the previously accumulated frames before
+                adding these frames (Default value: True).
+        """  # noqa: E501
+        if reset:
+            self.thisptr.reset()
+
+        positions = np.asarray(positions)
+        if positions.ndim == 2:
+            positions = positions[np.newaxis]
+        if positions.ndim != 3 or positions.shape[2] != 3:
+            raise ValueError(
+                "positions must have shape (N_frames, N_particles, 3) or "
+                "(N_particles, 3).")
+        if self._box is None or images is None:
+            images = None
+        else:
+            images = np.asarray(images)
+            if images.ndim == 2:
+                images = images[np.newaxis]
+            if images.shape != positions.shape:
+                raise ValueError("images must have the same shape as "
+                                 "positions.")
+
+        # Frames are converted in chunks to bound the memory used.
+        n_frames, n_particles = positions.shape[:2]
+        chunk_size = max(1, _CHUNK_BYTES // (12 * max(1, n_particles)))
+        for start in range(0, n_frames, chunk_size):
+            end = min(start + chunk_size, n_frames)
+            chunk_images = None
+            if images is not None:
+                chunk_images = freud.util._convert_array(
+                    images[start:end], dtype=np.int32)
+            self._accumulate(
+                freud.util._convert_array(positions[start:end]),
+                chunk_images)
+
+        self._called_compute = True
+        return self
+
+    def _accumulate(self, positions, images):
+        """Accumulate C-contiguous single precision positions and 32 bit
+        integer images of consecutive frames."""
+        cdef const float[:, :, ::1] l_positions = positions
+        cdef const int[:, :, ::1] l_images
+        cdef const vec3[int]* images_ptr = NULL
+        if images is not None:
+            l_images = images
+            images_ptr = <const vec3[int]*> &l_images[0, 0, 0]
+        with nogil:
+            self.thisptr.accumulate(
+                <const vec3[float]*> &l_positions[0, 0, 0], images_ptr,
+                l_positions.shape[0], l_positions.shape[1])
+
+    @property
+    def box(self):
+        """:class:`freud.box.Box`: Box used in the calculation."""
+        return self._box
+
+    @property
+    def points_per_level(self):
+        """int: Number of frames kept per level."""
+        return self.thisptr.getPointsPerLevel()
+
+    @property
+    def decimation(self):
+        """int: Ratio of the sampling intervals of consecutive levels."""
+        return self.thisptr.getDecimation()
+
+    @_Compute._computed_property
+    def lags(self):
+        """:math:`\\left(N_{lags}, \\right)` :class:`numpy.ndarray`: The lags,
+        in frames, at which the MSD is computed."""
+        return np.asarray(self.thisptr.getLags(), dtype=np.int64)
+
+    @_Compute._computed_property
+    def msd(self):
+        """:math:`\\left(N_{lags}, \\right)` :class:`numpy.ndarray`: The mean
+        squared displacement at each lag."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getMSD(), freud.util.arr_type_t.FLOAT)
+
+    @_Compute._computed_property
+    def particle_msd(self):
+        """:math:`\\left(N_{lags}, N_{particles} \\right)` :class:`numpy.ndarray`: The per
+        particle based mean squared displacement at each lag."""  # noqa: E501
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getParticleMSD(), freud.util.arr_type_t.FLOAT)
+
+    def __repr__(self):
+        return ("freud.msd.{cls}(box={box}, "
+                "points_per_level={points_per_level}, "
+                "decimation={decimation})").format(
+                    cls=type(self).__name__, box=self._box,
+                    points_per_level=self.points_per_level,
+                    decimation=self.decimation)
+
+    def plot(self, ax=None):
+        """Plot MSD.
+
+        Args:
+            ax (:class:`matplotlib.axes.Axes`, optional): Axis to plot on. If
+                :code:`None`, make a new figure and axis.
+                (Default value = :code:`None`)
+
+        Returns:
+            (:class:`matplotlib.axes.Axes`): Axis with the plot.
+        """
+        import freud.plot
+        return freud.plot.line_plot(self.lags, self.msd,
+                                    title="MSD",
+                                    xlabel="Lag",
+                                    ylabel="MSD",
+                                    ax=ax)
+
+    def _repr_png_(self):
+        try:
+            import freud.plot
+            return freud.plot._ax_to_bytes(self.plot())
+        except (AttributeError, ImportError):
+            return None
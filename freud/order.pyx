@@ -19,8 +19,13 @@ from freud.util cimport _Compute
 from freud.locality cimport _PairCompute
 from freud.util cimport vec3, quat
 from cython.operator cimport dereference
+from libcpp cimport bool as cbool
+from libcpp.memory cimport shared_ptr
+from libcpp.vector cimport vector
 
+cimport freud._locality
 cimport freud._order
+cimport freud._util
 cimport freud.locality
 cimport freud.util
 cimport numpy as np
@@ -31,10 +36,18 @@ logger = logging.getLogger(__name__)
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 cdef class Cubatic(_Compute):
     R"""Compute the cubatic order parameter :cite:`Haji_Akbari_2015` for a system of
     particles using simulated annealing instead of Newton-Raphson root finding.
 
+    Replicates anneal in parallel, each from its own random number generator
+    seeded by the seed and the replicate index, so results for a given seed
+    do not depend on the number of threads. Replicates whose order parameter
+    provably cannot end above that of another replicate are stopped early.
+
     Args:
         t_initial (float):
             Starting temperature.
@@ -74,8 +87,9 @@ cdef class Cubatic(_Compute):
         cdef const float[:, ::1] l_orientations = orientations
         cdef unsigned int num_particles = l_orientations.shape[0]
 
-        self.thisptr.compute(
-            <quat[float]*> &l_orientations[0, 0], num_particles)
+        with nogil:
+            self.thisptr.compute(
+                <quat[float]*> &l_orientations[0, 0], num_particles)
         return self
 
     @property
@@ -192,10 +206,66 @@ cdef class Nematic(_Compute):
         cdef const float[:, ::1] l_orientations = orientations
         cdef unsigned int num_particles = l_orientations.shape[0]
 
-        self.thisptr.compute(<quat[float]*> &l_orientations[0, 0],
-                             num_particles)
+        with nogil:
+            self.thisptr.compute(<quat[float]*> &l_orientations[0, 0],
+                                 num_particles)
+        return self
+
+    def compute_frames(self, orientations):
+        R"""Calculates the global order parameter of many frames in a single
+        call.
+
+        Per-particle tensors are not stored, so :attr:`~.particle_tensor` is
+        not updated.
+
+        Args:
+            orientations (:math:`\left(N_{frames}, N_{particles}, 4 \right)` :class:`numpy.ndarray`):
+                Orientations of each frame.
+        """   # noqa: E501
+        orientations = freud.util._convert_array(
+            orientations, shape=(None, None, 4))
+
+        cdef const float[:, :, ::1] l_orientations = orientations
+        cdef unsigned int num_frames = l_orientations.shape[0]
+        cdef unsigned int num_particles = l_orientations.shape[1]
+        if num_frames == 0 or num_particles == 0:
+            raise ValueError("orientations must contain at least one frame "
+                             "and one particle.")
+
+        with nogil:
+            self.thisptr.computeFrames(<quat[float]*> &l_orientations[0, 0, 0],
+                                       num_frames, num_particles)
         return self
 
+    cdef _frame_array(self, const freud.util.ManagedArray[float] *array):
+        if array.size() == 0:
+            raise AttributeError(
+                "The frame order parameters have not been computed; call "
+                "compute_frames first.")
+        return freud.util.make_managed_numpy_array(
+            array, freud.util.arr_type_t.FLOAT)
+
+    @property
+    def frame_order(self):
+        """:math:`\left(N_{frames} \right)` :class:`numpy.ndarray`: Nematic
+        order parameter of each frame of the last call to
+        :meth:`~.compute_frames`."""
+        return self._frame_array(&self.thisptr.getFrameOrderParameters())
+
+    @property
+    def frame_director(self):
+        """:math:`\left(N_{frames}, 3 \right)` :class:`numpy.ndarray`: The
+        average nematic director of each frame of the last call to
+        :meth:`~.compute_frames`."""
+        return self._frame_array(&self.thisptr.getFrameDirectors())
+
+    @property
+    def frame_nematic_tensor(self):
+        """:math:`\left(N_{frames}, 3, 3 \right)` :class:`numpy.ndarray`:
+        The nematic tensor of each frame of the last call to
+        :meth:`~.compute_frames`."""
+        return self._frame_array(&self.thisptr.getFrameNematicTensors())
+
     @_Compute._computed_property
     def order(self):
         """float: Nematic order parameter of the system."""
@@ -309,8 +379,9 @@ cdef class Hexatic(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(), dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(), dereference(qargs.thisptr))
         return self
 
     @property
@@ -415,8 +486,9 @@ cdef class Translational(_PairCompute):
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
 
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(), dereference(qargs.thisptr))
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(), dereference(qargs.thisptr))
         return self
 
     @property
@@ -443,6 +515,131 @@ cdef class Translational(_PairCompute):
             cls=type(self).__name__, k=self.k)
 
 
+cdef class HexaticTranslationalOrder(_PairCompute):
+    R"""Compute several :math:`k`-atic order parameters and the translational
+    order parameter in a single pass over the neighbors.
+
+    This computes the same per-particle values as :class:`~.Hexatic` for
+    every symmetry in :code:`k` and as :class:`~.Translational`, but visits
+    each bond only once and evaluates :math:`e^{k i \phi_{ij}}` for all
+    :math:`k` by multiplying powers of the unit bond vector in the complex
+    plane. All order parameters are computed from the same neighbors.
+
+    .. note::
+        **2D:** :class:`freud.order.HexaticTranslationalOrder` is only defined
+        for 2D systems. The points must be passed in as :code:`[x, y, 0]`.
+
+    Args:
+        k (unsigned int or sequence of unsigned int, optional):
+            Symmetries of the :math:`k`-atic order parameters.
+            (Default value = :code:`(4, 6)`).
+        translational_k (float, optional):
+            Normalization of the translational order parameter.
+            (Default value = :code:`6.0`).
+        weighted (bool, optional):
+            Determines whether to use neighbor weights in the computation of
+            all order parameters, as in :class:`~.Hexatic`.
+            (Default value = :code:`False`)
+    """  # noqa: E501
+    cdef freud._order.HexaticTranslationalOrder * thisptr
+    cdef cbool _scalar_k
+
+    def __cinit__(self, k=(4, 6), translational_k=6.0, weighted=False):
+        self._scalar_k = np.ndim(k) == 0
+        cdef vector[unsigned int] k_values = np.atleast_1d(k).tolist()
+        self.thisptr = new freud._order.HexaticTranslationalOrder(
+            k_values, translational_k, weighted)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    def compute(self, system, neighbors=None):
+        R"""Calculates the order parameters.
+
+        Example::
+            >>> box, points = freud.data.make_random_system(
+            ...     box_size=10, num_points=100, is2D=True, seed=0)
+            >>> op = freud.order.HexaticTranslationalOrder(k=[4, 6])
+            >>> op.compute(system=(box, points))
+            freud.order.HexaticTranslationalOrder(...)
+            >>> print(op.particle_order.shape)
+            (100, 2)
+
+        Args:
+            system:
+                Any object that is a valid argument to
+                :class:`freud.locality.NeighborQuery.from_system`.
+            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+                Either a :class:`NeighborList <freud.locality.NeighborList>` of
+                neighbor pairs to use in the calculation, or a dictionary of
+                `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                (Default value: None).
+        """  # noqa: E501
+        cdef:
+            freud.locality.NeighborQuery nq
+            freud.locality.NeighborList nlist
+            freud.locality._QueryArgs qargs
+            const float[:, ::1] l_query_points
+            unsigned int num_query_points
+
+        nq, nlist, qargs, l_query_points, num_query_points = \
+            self._preprocess_arguments(system, neighbors=neighbors)
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(), dereference(qargs.thisptr))
+        return self
+
+    @property
+    def default_query_args(self):
+        """The default query arguments are
+        :code:`{'mode': 'nearest', 'num_neighbors': max(self.k)}`."""
+        return dict(mode="nearest", num_neighbors=int(np.max(self.k)))
+
+    @_Compute._computed_property
+    def particle_order(self):
+        """:math:`\\left(N_{particles}\\right)` or :math:`\\left(N_{particles},
+        N_k\\right)` :class:`numpy.ndarray`: :math:`k`-atic order parameters,
+        with one column per value of :code:`k` unless :code:`k` was a
+        scalar."""
+        array = freud.util.make_managed_numpy_array(
+            &self.thisptr.getOrder(),
+            freud.util.arr_type_t.COMPLEX_FLOAT)
+        return array[:, 0] if self._scalar_k else array
+
+    @_Compute._computed_property
+    def translational_order(self):
+        """:math:`\\left(N_{particles} \\right)` :class:`numpy.ndarray`:
+        Translational order parameter."""
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getTranslationalOrder(),
+            freud.util.arr_type_t.COMPLEX_FLOAT)
+
+    @property
+    def k(self):
+        """unsigned int or list(unsigned int): Symmetries of the
+        :math:`k`-atic order parameters."""
+        cdef vector[unsigned int] k = self.thisptr.getK()
+        return k[0] if self._scalar_k else list(k)
+
+    @property
+    def translational_k(self):
+        """float: Normalization of the translational order parameter."""
+        return self.thisptr.getTranslationalK()
+
+    @property
+    def weighted(self):
+        """bool: Whether neighbor weights were used in the computation."""
+        return self.thisptr.isWeighted()
+
+    def __repr__(self):
+        return ("freud.order.{cls}(k={k}, translational_k={translational_k}, "
+                "weighted={weighted})").format(
+                    cls=type(self).__name__, k=self.k,
+                    translational_k=self.translational_k,
+                    weighted=self.weighted)
+
+
 cdef class Steinhardt(_PairCompute):
     R"""Compute the rotationally invariant Steinhardt order parameter
     :math:`q_l` or :math:`w_l` for a set of points :cite:`Steinhardt:1983aa`.
@@ -478,9 +675,22 @@ cdef class Steinhardt(_PairCompute):
     :math:`q_{lm}` values over all particles before computing the order
     parameter of choice.
 
+    If a sequence of values of :math:`l` is provided, all of them are computed
+    from a single pass over the neighbors and a single evaluation of the
+    spherical harmonics of each bond. The per-particle outputs then have one
+    column per value of :math:`l`, and :attr:`order` has one entry per value
+    of :math:`l`.
+
+    Example::
+        >>> box, points = freud.data.make_random_system(10, 100, seed=0)
+        >>> ql = freud.order.Steinhardt(l=[4, 6, 8])
+        >>> ql.compute((box, points), {'r_max': 3}).particle_order.shape
+        (100, 3)
+
     Args:
-        l (unsigned int):
-            Spherical harmonic quantum number l.
+        l (unsigned int or sequence of unsigned int):
+            Spherical harmonic quantum number l, or a sequence of values of l
+            to compute together.
         average (bool, optional):
             Determines whether to calculate the averaged Steinhardt order
             parameter. (Default value = :code:`False`)
@@ -497,11 +707,14 @@ cdef class Steinhardt(_PairCompute):
             of the Steinhardt order parameter. (Default value = :code:`False`)
     """  # noqa: E501
     cdef freud._order.Steinhardt * thisptr
+    cdef cbool _scalar_l
 
     def __cinit__(self, l, average=False, wl=False, weighted=False,
                   wl_normalize=False):
-        self.thisptr = new freud._order.Steinhardt(l, average, wl, weighted,
-                                                   wl_normalize)
+        self._scalar_l = np.ndim(l) == 0
+        cdef vector[unsigned int] l_values = np.atleast_1d(l).tolist()
+        self.thisptr = new freud._order.Steinhardt(
+            l_values, average, wl, weighted, wl_normalize)
 
     def __dealloc__(self):
         del self.thisptr
@@ -527,35 +740,78 @@ cdef class Steinhardt(_PairCompute):
     def wl_normalize(self):
         return self.thisptr.isWlNormalized()
 
+    @property
+    def partitioner(self):
+        """str: How points are split among threads, one of :code:`'auto'`,
+        :code:`'simple'`, :code:`'static'`, :code:`'affinity'` or
+        :code:`'balanced'`. The :code:`'balanced'` partitioner uses the
+        neighbor counts of the :class:`freud.locality.NeighborList` passed to
+        :meth:`compute` to give every block of work a similar number of
+        bonds, which helps when the numbers of neighbors are very uneven.
+        (Default value = :code:`'auto'`)."""
+        return freud.util._partitioner_name(
+            self.thisptr.getLoopSchedule().getPartitioner())
+
+    @partitioner.setter
+    def partitioner(self, partitioner):
+        self.thisptr.setLoopSchedule(freud._util.LoopSchedule(
+            freud.util._convert_partitioner(partitioner),
+            self.thisptr.getLoopSchedule().getGrainSize()))
+
+    @property
+    def grain_size(self):
+        """int: Minimum number of points in each block of work, or the
+        maximum for the :code:`'simple'` partitioner. (Default value =
+        :code:`1`)."""
+        return max(self.thisptr.getLoopSchedule().getGrainSize(), 1)
+
+    @grain_size.setter
+    def grain_size(self, grain_size):
+        if grain_size < 1:
+            raise ValueError("grain_size must be positive.")
+        self.thisptr.setLoopSchedule(freud._util.LoopSchedule(
+            self.thisptr.getLoopSchedule().getPartitioner(), grain_size))
+
     @property
     def l(self):  # noqa: E743
-        """unsigned int: Spherical harmonic quantum number l."""
-        return self.thisptr.getL()
+        """unsigned int or list: Spherical harmonic quantum number l, or the
+        list of values of l if a sequence was provided."""
+        l_values = self.thisptr.getL()
+        return l_values[0] if self._scalar_l else list(l_values)
 
     @_Compute._computed_property
     def order(self):
-        """float: The system wide normalization of the :math:`q_l` or
-        :math:`w_l` order parameter."""
-        return self.thisptr.getOrder()
+        """float or :math:`\\left(N_l\\right)` :class:`numpy.ndarray`: The
+        system wide normalization of the :math:`q_l` or :math:`w_l` order
+        parameter, for each value of l if a sequence was provided."""
+        order = self.thisptr.getOrder()
+        return order[0] if self._scalar_l else np.array(order)
+
+    def _squeeze_l(self, array):
+        # Per-particle arrays have one column per l. The column axis is
+        # dropped when a single l was provided as a scalar.
+        return array[:, 0] if self._scalar_l else array
 
     @_Compute._computed_property
     def particle_order(self):
-        """:math:`\\left(N_{particles}\\right)` :class:`numpy.ndarray`: Variant
-        of the Steinhardt order parameter for each particle (filled with
-        :code:`nan` for particles with no neighbors)."""
-        return freud.util.make_managed_numpy_array(
+        """:math:`\\left(N_{particles}\\right)` or :math:`\\left(N_{particles},
+        N_l\\right)` :class:`numpy.ndarray`: Variant of the Steinhardt order
+        parameter for each particle (filled with :code:`nan` for particles with
+        no neighbors)."""
+        return self._squeeze_l(freud.util.make_managed_numpy_array(
             &self.thisptr.getParticleOrder(),
-            freud.util.arr_type_t.FLOAT)
+            freud.util.arr_type_t.FLOAT))
 
     @_Compute._computed_property
     def ql(self):
-        """:math:`\\left(N_{particles}\\right)` :class:`numpy.ndarray`:
-        :math:`q_l` Steinhardt order parameter for each particle (filled with
-        :code:`nan` for particles with no neighbors). This is always available,
-        no matter which options are selected."""
-        return freud.util.make_managed_numpy_array(
+        """:math:`\\left(N_{particles}\\right)` or :math:`\\left(N_{particles},
+        N_l\\right)` :class:`numpy.ndarray`: :math:`q_l` Steinhardt order
+        parameter for each particle (filled with :code:`nan` for particles with
+        no neighbors). This is always available, no matter which options are
+        selected."""
+        return self._squeeze_l(freud.util.make_managed_numpy_array(
             &self.thisptr.getQl(),
-            freud.util.arr_type_t.FLOAT)
+            freud.util.arr_type_t.FLOAT))
 
     def compute(self, system, neighbors=None):
         R"""Compute the order parameter.
@@ -570,10 +826,12 @@ cdef class Steinhardt(_PairCompute):
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
-            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+            neighbors (:class:`freud.locality.NeighborList`, :class:`freud.locality.BondGeometry` or dict, optional):
                 Either a :class:`NeighborList <freud.locality.NeighborList>` of
-                neighbor pairs to use in the calculation, or a dictionary of
-                `query arguments
+                neighbor pairs to use in the calculation, a
+                :class:`~freud.locality.BondGeometry` of the bonds, whose
+                spherical harmonics are read instead of evaluated, or a
+                dictionary of `query arguments
                 <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
                 (Default value: None).
         """   # noqa: E501
@@ -586,12 +844,81 @@ cdef class Steinhardt(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
+        cdef freud._locality.BondGeometry * geometry = \
+            freud.locality._bond_geometry_ptr(neighbors)
+
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(),
+                                 dereference(qargs.thisptr),
+                                 geometry)
+        return self
+
+    def compute_trajectory(self, boxes, points, neighbors=None,
+                           parallel_frames=False):
+        R"""Compute the order parameter of all frames of a trajectory and
+        average it over frames.
+
+        The averages are available as :attr:`trajectory_particle_order` and
+        :attr:`trajectory_order`. All other properties hold the values of the
+        last frame.
 
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(),
-                             dereference(qargs.thisptr))
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame. The array is not copied if it
+                contains 32-bit floats, so it may be memory-mapped.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the neighbors in each frame (Default value:
+                None).
+            parallel_frames (bool, optional):
+                If True, frames are computed concurrently, with one order
+                parameter compute per thread. This is faster for many frames
+                of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa: E501
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        cdef bint l_parallel_frames = parallel_frames
+        with nogil:
+            self.thisptr.computeTrajectory(
+                dereference(trajectory.thisptr), dereference(qargs.thisptr),
+                l_parallel_frames)
         return self
 
+    @_Compute._computed_property
+    def trajectory_particle_order(self):
+        """:math:`\\left(N_{particles}\\right)` or :math:`\\left(N_{particles},
+        N_l\\right)` :class:`numpy.ndarray`: The order parameter of each
+        particle averaged over the frames of the last call to
+        :meth:`~.compute_trajectory` in which the particle has neighbors
+        (:code:`nan` if it has no neighbors in any frame)."""
+        return self._squeeze_l(freud.util.make_managed_numpy_array(
+            &self.thisptr.getTrajectoryParticleOrder(),
+            freud.util.arr_type_t.FLOAT))
+
+    @_Compute._computed_property
+    def trajectory_order(self):
+        """float or :math:`\\left(N_l\\right)` :class:`numpy.ndarray`: The
+        system wide normalization of the order parameter averaged over the
+        frames of the last call to :meth:`~.compute_trajectory`."""
+        order = self.thisptr.getTrajectoryOrder()
+        return order[0] if self._scalar_l else np.array(order)
+
+    cdef void _add_pipeline_stage(
+            self, freud._locality.NeighborPipeline *pipeline,
+            dict stage_arrays) except *:
+        pipeline.addStage(shared_ptr[freud._locality.NeighborPipelineStage](
+            new freud._order.SteinhardtPipelineStage(self.thisptr)))
+
     def __repr__(self):
         return ("freud.order.{cls}(l={l}, average={average}, wl={wl}, "
                 "weighted={weighted}, wl_normalize={wl_normalize})").format(
@@ -614,18 +941,23 @@ cdef class Steinhardt(_PairCompute):
             (:class:`matplotlib.axes.Axes`): Axis with the plot.
         """
         import freud.plot
-        xlabel = r"${mode_letter}{prime}_{{{sph_l}{average}}}$".format(
+        ls = np.atleast_1d(self.l)
+        labels = [r"${mode_letter}{prime}_{{{sph_l}{average}}}$".format(
             mode_letter='w' if self.wl else 'q',
             prime='\'' if self.weighted else '',
-            sph_l=self.l,
-            average=',ave' if self.average else '')
+            sph_l=sph_l,
+            average=',ave' if self.average else '') for sph_l in ls]
+        xlabel = ", ".join(labels)
 
-        return freud.plot.histogram_plot(
+        ax = freud.plot.histogram_plot(
             self.particle_order,
             title="Steinhardt Order Parameter " + xlabel,
             xlabel=xlabel,
             ylabel=r"Number of particles",
             ax=ax)
+        if len(ls) > 1:
+            ax.legend(labels)
+        return ax
 
     def _repr_png_(self):
         try:
@@ -672,12 +1004,25 @@ cdef class SolidLiquid(_PairCompute):
         normalize_q (bool):
             Whether to normalize the dot product (Default value =
             :code:`True`).
+        memory_budget (int, optional):
+            Number of bytes available for the bonds found by queries. If the
+            :class:`~freud.locality.NeighborList` of a query is estimated to
+            be larger (see
+            :attr:`freud.locality.NeighborQueryResult.estimated_nbytes`),
+            the bonds are found, consumed and discarded for chunks of points
+            that fit in the budget, and :attr:`~.ql_ij` and :attr:`~.nlist`
+            are empty. The points are queried twice, to count the solid-like
+            bonds and to cluster them. Bonds given as a
+            :class:`~freud.locality.NeighborList` are never chunked
+            (Default value = :code:`None`, never chunk the bonds).
     """  # noqa: E501
     cdef freud._order.SolidLiquid * thisptr
 
-    def __cinit__(self, l, q_threshold, solid_threshold, normalize_q=True):
+    def __cinit__(self, l, q_threshold, solid_threshold, normalize_q=True,
+                  memory_budget=None):
         self.thisptr = new freud._order.SolidLiquid(
             l, q_threshold, solid_threshold, normalize_q)
+        self.memory_budget = memory_budget
 
     def __dealloc__(self):
         del self.thisptr
@@ -689,13 +1034,15 @@ cdef class SolidLiquid(_PairCompute):
             system:
                 Any object that is a valid argument to
                 :class:`freud.locality.NeighborQuery.from_system`.
-            neighbors (:class:`freud.locality.NeighborList` or dict, optional):
+            neighbors (:class:`freud.locality.NeighborList`, :class:`freud.locality.BondGeometry` or dict, optional):
                 Either a :class:`NeighborList <freud.locality.NeighborList>` of
-                neighbor pairs to use in the calculation, or a dictionary of
-                `query arguments
+                neighbor pairs to use in the calculation, a
+                :class:`~freud.locality.BondGeometry` of the bonds, whose
+                spherical harmonics are read instead of evaluated, or a
+                dictionary of `query arguments
                 <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
                 (Default value: None).
-        """
+        """  # noqa: E501
         cdef:
             freud.locality.NeighborQuery nq
             freud.locality.NeighborList nlist
@@ -705,9 +1052,13 @@ cdef class SolidLiquid(_PairCompute):
 
         nq, nlist, qargs, l_query_points, num_query_points = \
             self._preprocess_arguments(system, neighbors=neighbors)
-        self.thisptr.compute(nlist.get_ptr(),
-                             nq.get_ptr(),
-                             dereference(qargs.thisptr))
+        cdef freud._locality.BondGeometry * geometry = \
+            freud.locality._bond_geometry_ptr(neighbors)
+        with nogil:
+            self.thisptr.compute(nlist.get_ptr(),
+                                 nq.get_ptr(),
+                                 dereference(qargs.thisptr),
+                                 geometry)
 
     @property
     def l(self):  # noqa: E743
@@ -729,6 +1080,18 @@ cdef class SolidLiquid(_PairCompute):
         """bool: Whether the dot product is normalized."""
         return self.thisptr.getNormalizeQ()
 
+    @property
+    def memory_budget(self):
+        """int: Number of bytes available for the bonds found by queries, or
+        :code:`None` if the bonds are never chunked."""
+        return freud.locality._get_memory_budget(
+            self.thisptr.getMemoryBudget())
+
+    @memory_budget.setter
+    def memory_budget(self, value):
+        self.thisptr.setMemoryBudget(
+            freud.locality._convert_memory_budget(value))
+
     @_Compute._computed_property
     def cluster_idx(self):
         """:math:`\\left(N_{particles}\\right)` :class:`numpy.ndarray`:
@@ -741,7 +1104,7 @@ cdef class SolidLiquid(_PairCompute):
     def ql_ij(self):
         """:math:`\\left(N_{bonds}\\right)` :class:`numpy.ndarray`: Bond dot
         products :math:`q_l(i, j)`. Indexed by the elements of
-        :code:`self.nlist`."""
+        :code:`self.nlist`. Empty if the bonds were chunked."""
         return freud.util.make_managed_numpy_array(
             &self.thisptr.getQlij(),
             freud.util.arr_type_t.FLOAT)
@@ -760,7 +1123,7 @@ cdef class SolidLiquid(_PairCompute):
     @_Compute._computed_property
     def nlist(self):
         """:class:`freud.locality.NeighborList`: Neighbor list of solid-like
-        bonds."""
+        bonds. Empty if the bonds were chunked."""
         return freud.locality._nlist_from_cnlist(self.thisptr.getNList())
 
     @_Compute._computed_property
@@ -774,12 +1137,14 @@ cdef class SolidLiquid(_PairCompute):
     def __repr__(self):
         return ("freud.order.{cls}(l={sph_l}, q_threshold={q_threshold}, "
                 "solid_threshold={solid_threshold}, "
-                "normalize_q={normalize_q})").format(
+                "normalize_q={normalize_q}, "
+                "memory_budget={memory_budget})").format(
                     cls=type(self).__name__,
                     sph_l=self.l,
                     q_threshold=self.q_threshold,
                     solid_threshold=self.solid_threshold,
-                    normalize_q=self.normalize_q)
+                    normalize_q=self.normalize_q,
+                    memory_budget=self.memory_budget)
 
     def plot(self, ax=None):
         """Plot solid-like cluster distribution.
@@ -831,20 +1196,38 @@ cdef class RotationalAutocorrelation(_Compute):
     correlation with an initial state. As such, the output can be treated as an
     order parameter measuring degrees of rotational (de)correlation. For
     analysis of a trajectory, the compute call needs to be
-    done at each trajectory frame.
+    done at each trajectory frame, or :meth:`~.compute_frames` can compare
+    many frames to the same initial frame in a single call.
+
+    Alternatively, :meth:`~.compute_time_correlation` accumulates the frames
+    of a trajectory into a multiple-tau correlator, which gives the
+    autocorrelation as a function of the lag between frames, averaged over
+    all pairs of frames separated by each lag. The lags are logarithmically
+    spaced: all lags smaller than :code:`points_per_level` frames are
+    computed, and each following level multiplies the sampling interval by
+    :code:`decimation`. Only :code:`points_per_level` orientations per level
+    and particle are kept, so the memory used grows with the logarithm of
+    the trajectory length.
 
     Args:
         l (int):
             Order of the hyperspherical harmonic. Must be a positive, even
             integer.
+        points_per_level (int, optional):
+            Number of frames kept per level of the time correlation. Must be
+            larger than :code:`decimation`. (Default value = 16).
+        decimation (int, optional):
+            Ratio of the sampling intervals of consecutive levels of the time
+            correlation. Must be at least 2. (Default value = 2).
     """
     cdef freud._order.RotationalAutocorrelation * thisptr
 
-    def __cinit__(self, l):
+    def __cinit__(self, l, points_per_level=16, decimation=2):
         if l % 2 or l < 0:
             raise ValueError(
                 "The quantum number must be a positive, even integer.")
-        self.thisptr = new freud._order.RotationalAutocorrelation(l)
+        self.thisptr = new freud._order.RotationalAutocorrelation(
+            l, points_per_level, decimation)
 
     def __dealloc__(self):
         del self.thisptr
@@ -867,12 +1250,114 @@ cdef class RotationalAutocorrelation(_Compute):
         cdef const float[:, ::1] l_orientations = orientations
         cdef unsigned int nP = orientations.shape[0]
 
-        self.thisptr.compute(
-            <quat[float]*> &l_ref_orientations[0, 0],
-            <quat[float]*> &l_orientations[0, 0],
-            nP)
+        with nogil:
+            self.thisptr.compute(
+                <quat[float]*> &l_ref_orientations[0, 0],
+                <quat[float]*> &l_orientations[0, 0],
+                nP)
         return self
 
+    def compute_frames(self, ref_orientations, orientations):
+        """Calculates the rotational autocorrelation of many frames against
+        the same initial frame.
+
+        This gives the same values as calling :meth:`~.compute` for each frame,
+        processing all frames in parallel in a single call.
+
+        Args:
+            ref_orientations ((:math:`N_{orientations}`, 4) :class:`numpy.ndarray`):
+                Orientations for the initial frame.
+            orientations ((:math:`N_{frames}`, :math:`N_{orientations}`, 4) :class:`numpy.ndarray`):
+                Orientations for the frames of interest.
+        """  # noqa: E501
+        ref_orientations = freud.util._convert_array(
+            ref_orientations, shape=(None, 4))
+        orientations = freud.util._convert_array(
+            orientations, shape=(None, ref_orientations.shape[0], 4))
+
+        cdef const float[:, ::1] l_ref_orientations = ref_orientations
+        cdef const float[:, :, ::1] l_orientations = orientations
+        cdef unsigned int n_frames = l_orientations.shape[0]
+        cdef unsigned int nP = l_orientations.shape[1]
+        if n_frames == 0 or nP == 0:
+            raise ValueError("orientations must contain at least one frame "
+                             "and one orientation.")
+
+        with nogil:
+            self.thisptr.computeFrames(
+                <quat[float]*> &l_ref_orientations[0, 0],
+                <quat[float]*> &l_orientations[0, 0, 0],
+                n_frames, nP)
+        return self
+
+    @property
+    def frame_order(self):
+        """(:math:`N_{frames}`) :class:`numpy.ndarray`: Autocorrelation of the
+        system in each frame of the last call to :meth:`~.compute_frames`."""
+        frame_order = freud.util.make_managed_numpy_array(
+            &self.thisptr.getFrameAutocorrelations(),
+            freud.util.arr_type_t.FLOAT)
+        if len(frame_order) == 0:
+            raise AttributeError(
+                "The frame autocorrelations have not been computed; call "
+                "compute_frames first.")
+        return frame_order
+
+    def compute_time_correlation(self, orientations, reset=True):
+        """Accumulates consecutive frames of a trajectory into the time
+        correlation.
+
+        Trajectories too long to keep in memory can be accumulated in
+        consecutive blocks of frames with :code:`reset=False`.
+
+        Args:
+            orientations ((:math:`N_{frames}`, :math:`N_{orientations}`, 4) or (:math:`N_{orientations}`, 4) :class:`numpy.ndarray`):
+                Orientations of consecutive frames, or of a single frame.
+            reset (bool):
+                Whether to erase the previously accumulated frames before
+                adding these frames (Default value: True).
+        """  # noqa: E501
+        if reset:
+            self.thisptr.resetTimeCorrelation()
+
+        orientations = np.asarray(orientations)
+        if orientations.ndim == 2:
+            orientations = orientations[np.newaxis]
+        orientations = freud.util._convert_array(
+            orientations, shape=(None, None, 4))
+
+        cdef const float[:, :, ::1] l_orientations = orientations
+        cdef unsigned int n_frames = l_orientations.shape[0]
+        cdef unsigned int nP = l_orientations.shape[1]
+        if n_frames > 0:
+            with nogil:
+                self.thisptr.accumulateFrames(
+                    <quat[float]*> &l_orientations[0, 0, 0], n_frames, nP)
+        return self
+
+    def _check_time_correlation(self):
+        if self.thisptr.getNumFrames() == 0:
+            raise AttributeError(
+                "The time correlation has not been computed; call "
+                "compute_time_correlation first.")
+
+    @property
+    def lags(self):
+        """(:math:`N_{lags}`) :class:`numpy.ndarray`: Lags, in frames, of
+        the time correlation."""
+        self._check_time_correlation()
+        return np.asarray(self.thisptr.getLags(), dtype=np.int64)
+
+    @property
+    def time_correlation(self):
+        """(:math:`N_{lags}`) :class:`numpy.ndarray`: Autocorrelation of the
+        system at each lag, averaged over all accumulated pairs of frames
+        separated by the lag."""
+        self._check_time_correlation()
+        return freud.util.make_managed_numpy_array(
+            &self.thisptr.getTimeCorrelation(),
+            freud.util.arr_type_t.FLOAT)
+
     @_Compute._computed_property
     def order(self):
         """float: Autocorrelation of the system."""
@@ -892,6 +1377,21 @@ cdef class RotationalAutocorrelation(_Compute):
         hyperspherical harmonic."""
         return self.thisptr.getL()
 
+    @property
+    def points_per_level(self):
+        """int: Number of frames kept per level of the time correlation."""
+        return self.thisptr.getPointsPerLevel()
+
+    @property
+    def decimation(self):
+        """int: Ratio of the sampling intervals of consecutive levels of the
+        time correlation."""
+        return self.thisptr.getDecimation()
+
     def __repr__(self):
-        return "freud.order.{cls}(l={sph_l})".format(cls=type(self).__name__,
-                                                     sph_l=self.l)
+        return ("freud.order.{cls}(l={sph_l}, "
+                "points_per_level={points_per_level}, "
+                "decimation={decimation})").format(
+                    cls=type(self).__name__, sph_l=self.l,
+                    points_per_level=self.points_per_level,
+                    decimation=self.decimation)
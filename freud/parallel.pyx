@@ -5,11 +5,31 @@ R"""
 The :class:`freud.parallel` module controls the parallelization behavior of
 freud, determining how many threads the TBB-enabled parts of freud will use.
 freud uses all available threads for parallelization unless directed otherwise.
+
+The C++ computations of all compute classes release the Python global
+interpreter lock (GIL), so other Python threads, for example threads reading
+or decompressing trajectory frames or running computes on other frames, can
+run at the same time. A single compute or neighbor query object must not be
+used by more than one thread at once.
+
+Threads can also be bound to subsets of the system with a :class:`Arena`.
+Computes called by a function executed in an arena only use the threads of that
+arena, which may be bound to the cores of one NUMA node.
+
+The :code:`compute_async` method of compute classes and :meth:`Arena.submit`
+run computes on worker threads of freud and return
+:class:`concurrent.futures.Future` objects, so a driver can queue several
+computes, or prepare the next frame, while earlier computes run.
 """
 
+import concurrent.futures
+import threading
+
 cimport freud._parallel
 
 _num_threads = 0
+_executor = None
+_executor_lock = threading.Lock()
 
 
 def get_num_threads():
@@ -60,3 +80,195 @@ class NumThreads:
 
     def __exit__(self, *args):
         set_num_threads(self.restore_N)
+
+
+def get_numa_nodes():
+    R"""Get the NUMA nodes of the system.
+
+    NUMA nodes can only be detected by oneTBB 2021 or newer with its hwloc
+    support library (``tbbbind``).
+
+    Returns:
+        list[int]:
+            Indices of the NUMA nodes that can be given to :class:`Arena`,
+            empty if the NUMA topology cannot be detected.
+    """
+    return list(freud._parallel.getNumaNodes())
+
+
+def _get_executor():
+    # The worker threads are started on first use.
+    global _executor
+    with _executor_lock:
+        if _executor is None:
+            _executor = concurrent.futures.ThreadPoolExecutor()
+        return _executor
+
+
+def _submit_after(previous, function, args, kwargs):
+    R"""Call a function on a worker thread once a previous future is done.
+
+    Worker threads are not blocked while waiting for the previous future.
+    The arguments are referenced by the call until it finishes.
+
+    Args:
+        previous (:class:`concurrent.futures.Future`):
+            Future that must be done before the call starts, or
+            :code:`None`.
+        function (callable): Function to call.
+        args (tuple): Positional arguments of the function.
+        kwargs (dict): Keyword arguments of the function.
+
+    Returns:
+        :class:`concurrent.futures.Future`: The result of the call.
+    """
+    future = concurrent.futures.Future()
+
+    def run():
+        if not future.set_running_or_notify_cancel():
+            return
+        try:
+            future.set_result(function(*args, **kwargs))
+        except BaseException as e:
+            future.set_exception(e)
+
+    def start(_=None):
+        _get_executor().submit(run)
+
+    if previous is None:
+        start()
+    else:
+        previous.add_done_callback(start)
+    return future
+
+
+cdef class _ArenaTask:
+    """Function call to run in an arena, keeping its result or exception."""
+    cdef object function
+    cdef object args
+    cdef object kwargs
+    cdef object result
+    cdef object error
+
+    def __cinit__(self, function, args, kwargs):
+        self.function = function
+        self.args = args
+        self.kwargs = kwargs
+
+    def run(self):
+        try:
+            self.result = self.function(*self.args, **self.kwargs)
+        except BaseException as e:
+            self.error = e
+
+
+cdef void _execute_task(void* task) with gil:
+    (<_ArenaTask> task).run()
+
+
+cdef class Arena:
+    R"""Set of threads used by the computes executed in it.
+
+    The threads of an arena are separate from the threads used by other
+    arenas and by computes called outside of any arena, and their number is
+    limited independently of :func:`set_num_threads` (which bounds the total
+    number of threads of all arenas). Arenas can isolate freud from other
+    parts of a program using TBB, or run computes on different frames in
+    separate Python threads without oversubscribing the cores. An arena bound
+    to a NUMA node runs computes on the cores of that node, so that the
+    thread-local arrays of the compute are allocated in memory near them.
+
+    .. code-block:: python
+
+        arenas = [freud.parallel.Arena(numa_node=node)
+                  for node in freud.parallel.get_numa_nodes()]
+
+        def frame_rdf(arena, frame):
+            rdf = freud.density.RDF(bins=50, r_max=5)
+            return arena.execute(rdf.compute, frame).rdf
+
+    Args:
+        num_threads (int, optional):
+            Maximum number of threads of the arena, including the thread
+            executing a function in it. If :code:`None`, use all threads of
+            the NUMA node, or of the system if :code:`numa_node` is
+            :code:`None`. (Default value = :code:`None`).
+        numa_node (int, optional):
+            Index of the NUMA node to bind threads to, one of
+            :func:`get_numa_nodes`. If :code:`None`, threads are not bound.
+            (Default value = :code:`None`).
+    """
+    cdef freud._parallel.Arena * thisptr
+
+    def __cinit__(self, num_threads=None, numa_node=None):
+        if num_threads is not None and num_threads < 1:
+            raise ValueError("num_threads must be positive.")
+        if numa_node is not None and numa_node < 0:
+            raise ValueError("numa_node must be nonnegative.")
+        cdef unsigned int l_num_threads = \
+            0 if num_threads is None else num_threads
+        cdef int l_numa_node = -1 if numa_node is None else numa_node
+        self.thisptr = new freud._parallel.Arena(l_num_threads, l_numa_node)
+
+    def __dealloc__(self):
+        del self.thisptr
+
+    @property
+    def num_threads(self):
+        """int: Maximum number of threads of the arena."""
+        return self.thisptr.getNumThreads()
+
+    @property
+    def numa_node(self):
+        """int: NUMA node of the threads, or :code:`None` if unbound."""
+        cdef int numa_node = self.thisptr.getNumaNode()
+        return None if numa_node < 0 else numa_node
+
+    def execute(self, function, *args, **kwargs):
+        R"""Call a function in the arena and return its result.
+
+        Computes called by the function (for example, a compute method
+        passed as :code:`function`) use the threads of the arena. Several
+        Python threads may execute functions in the same arena at once, in
+        which case they share its threads.
+
+        Args:
+            function (callable): Function to call.
+            \*args: Positional arguments of the function.
+            \*\*kwargs: Keyword arguments of the function.
+
+        Returns:
+            The return value of the function.
+        """
+        cdef _ArenaTask task = _ArenaTask(function, args, kwargs)
+        cdef void* l_task = <void*> task
+        with nogil:
+            self.thisptr.executeCallback(_execute_task, l_task)
+        if task.error is not None:
+            raise task.error
+        return task.result
+
+    def submit(self, function, *args, **kwargs):
+        R"""Call a function in the arena on a worker thread.
+
+        This is the asynchronous variant of :meth:`~.execute`. The arguments
+        are kept alive until the call finishes, but arrays passed to it must
+        not be modified until then. The returned future can be awaited in
+        :mod:`asyncio` with :func:`asyncio.wrap_future`.
+
+        Args:
+            function (callable): Function to call.
+            \*args: Positional arguments of the function.
+            \*\*kwargs: Keyword arguments of the function.
+
+        Returns:
+            :class:`concurrent.futures.Future`:
+                Future of the return value of the function.
+        """
+        return _submit_after(None, self.execute, (function, ) + args, kwargs)
+
+    def __repr__(self):
+        return "freud.parallel.{cls}(num_threads={num_threads}, " \
+            "numa_node={numa_node})".format(
+                cls=type(self).__name__, num_threads=self.num_threads,
+                numa_node=self.numa_node)
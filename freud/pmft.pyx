@@ -46,9 +46,12 @@ from freud.util cimport _Compute
 from freud.locality cimport _SpatialHistogram
 from freud.util cimport vec3, quat
 from cython.operator cimport dereference
+from libcpp.memory cimport shared_ptr
 
+cimport freud._locality
 cimport freud._pmft
 cimport freud.locality
+cimport freud.util
 
 cimport numpy as np
 
@@ -57,6 +60,9 @@ cimport numpy as np
 # _always_ do that, or you will have segfaults
 np.import_array()
 
+# Record the timers and counters of this module in freud.profiling.
+freud.util._attach_profile()
+
 
 def _quat_to_z_angle(orientations, num_points):
     """If orientations are quaternions, convert them to angles.
@@ -94,6 +100,16 @@ def _gen_angle_array(orientations, shape):
         np.asarray(orientations).squeeze(), shape[0])), shape=shape)
 
 
+def _gen_trajectory_angle_array(orientations, shape):
+    """Generates arrays of angles for each frame of a trajectory, converting
+    quaternions of shape (N_frames, N_points, 4) to angles if needed."""
+    orientations = np.asarray(orientations)
+    if orientations.ndim == 3:
+        orientations = _quat_to_z_angle(
+            orientations.reshape(-1, 4), shape[0] * shape[1]).reshape(shape)
+    return freud.util._convert_array(orientations, shape=shape)
+
+
 cdef class _PMFT(_SpatialHistogram):
     R"""Compute the PMFT :cite:`vanAnders:2014aa,van_Anders_2013` for a
     given set of points.
@@ -125,6 +141,40 @@ cdef class _PMFT(_SpatialHistogram):
             &self.pmftptr.getPCF(),
             freud.util.arr_type_t.FLOAT)
 
+    def adaptive_pmft(self, min_count):
+        R"""Compute the PMFT with a resolution adapted to the local number of
+        bonds.
+
+        The bins of the histogram are grouped into the cells of a binary space
+        partitioning tree (a quadtree or octree for two- or three-dimensional
+        histograms). Starting from a single cell containing all bins, each
+        cell is subdivided by halving all of its axes for as long as it
+        contains at least :code:`min_count` bonds. The pair correlation
+        function of each cell is its number of bonds divided by its volume, so
+        sparsely populated regions are averaged over large cells while
+        populated regions keep the full resolution of the histogram.
+
+        Args:
+            min_count (unsigned int):
+                Minimum number of bonds in a cell that is subdivided. A value
+                of 0 reproduces :attr:`pmft`.
+
+        Returns:
+            :class:`np.ndarray`:
+                The PMFT with the same shape as :attr:`pmft`, where each bin
+                holds the value of the cell containing it.
+        """
+        if not self._called_compute:
+            raise AttributeError(
+                "Property not computed. Call compute first.")
+        pcf = freud.util.make_managed_numpy_array(
+            &self.pmftptr.getAdaptivePCF(min_count),
+            freud.util.arr_type_t.FLOAT)
+        with np.warnings.catch_warnings():
+            np.warnings.filterwarnings('ignore')
+            result = -np.log(np.copy(pcf))
+        return result
+
 
 cdef class PMFTR12(_PMFT):
     R"""Computes the PMFT :cite:`vanAnders:2014aa,van_Anders_2013` in a 2D
@@ -217,12 +267,69 @@ cdef class PMFTR12(_PMFT):
         cdef const float[::1] l_orientations = orientations
         cdef const float[::1] l_query_orientations = query_orientations
 
-        self.pmftr12ptr.accumulate(nq.get_ptr(),
-                                   <float*> &l_orientations[0],
-                                   <vec3[float]*> &l_query_points[0, 0],
-                                   <float*> &l_query_orientations[0],
-                                   num_query_points, nlist.get_ptr(),
-                                   dereference(qargs.thisptr))
+        with nogil:
+            self.pmftr12ptr.accumulate(nq.get_ptr(),
+                                       <float*> &l_orientations[0],
+                                       <vec3[float]*> &l_query_points[0, 0],
+                                       <float*> &l_query_orientations[0],
+                                       num_query_points, nlist.get_ptr(),
+                                       dereference(qargs.thisptr))
+        return self
+
+    def compute_trajectory(self, boxes, points, orientations, neighbors=None,
+                           reset=True, parallel_frames=False):
+        R"""Calculates the PMFT of all frames of a trajectory.
+
+        This is equivalent to calling :meth:`~.compute` with
+        :code:`reset=False` for each frame, but all frames are accumulated in
+        a single call, and the neighbor query of each frame is built while
+        the previous frame is accumulated.
+
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame, which are also used as query
+                points. The array is not copied if it contains 32-bit floats,
+                so it may be memory-mapped.
+            orientations ((:math:`N_{frames}`, :math:`N_{points}`) :class:`numpy.ndarray`):
+                Angles of the points of each frame in radians, or
+                quaternions of shape (:math:`N_{frames}`, :math:`N_{points}`,
+                4) representing rotations about the z axis.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the bonds of each frame (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            parallel_frames (bool, optional):
+                If True, frames are accumulated concurrently, each by a single
+                thread with its own neighbor query. This is faster for many
+                frames of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa: E501
+        if reset:
+            self._reset()
+
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        frame_shape = (trajectory.n_frames, trajectory.n_points)
+        orientations = _gen_trajectory_angle_array(orientations, frame_shape)
+        cdef const float[:, ::1] l_orientations = orientations
+
+        cdef bint l_parallel_frames = parallel_frames
+        with nogil:
+            self.pmftr12ptr.accumulateTrajectory(
+                dereference(trajectory.thisptr),
+                <float*> &l_orientations[0, 0],
+                dereference(qargs.thisptr), l_parallel_frames)
         return self
 
     def __repr__(self):
@@ -326,12 +433,69 @@ cdef class PMFTXYT(_PMFT):
         cdef const float[::1] l_orientations = orientations
         cdef const float[::1] l_query_orientations = query_orientations
 
-        self.pmftxytptr.accumulate(nq.get_ptr(),
-                                   <float*> &l_orientations[0],
-                                   <vec3[float]*> &l_query_points[0, 0],
-                                   <float*> &l_query_orientations[0],
-                                   num_query_points, nlist.get_ptr(),
-                                   dereference(qargs.thisptr))
+        with nogil:
+            self.pmftxytptr.accumulate(nq.get_ptr(),
+                                       <float*> &l_orientations[0],
+                                       <vec3[float]*> &l_query_points[0, 0],
+                                       <float*> &l_query_orientations[0],
+                                       num_query_points, nlist.get_ptr(),
+                                       dereference(qargs.thisptr))
+        return self
+
+    def compute_trajectory(self, boxes, points, orientations, neighbors=None,
+                           reset=True, parallel_frames=False):
+        R"""Calculates the PMFT of all frames of a trajectory.
+
+        This is equivalent to calling :meth:`~.compute` with
+        :code:`reset=False` for each frame, but all frames are accumulated in
+        a single call, and the neighbor query of each frame is built while
+        the previous frame is accumulated.
+
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame, which are also used as query
+                points. The array is not copied if it contains 32-bit floats,
+                so it may be memory-mapped.
+            orientations ((:math:`N_{frames}`, :math:`N_{points}`) :class:`numpy.ndarray`):
+                Angles of the points of each frame in radians, or
+                quaternions of shape (:math:`N_{frames}`, :math:`N_{points}`,
+                4) representing rotations about the z axis.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the bonds of each frame (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            parallel_frames (bool, optional):
+                If True, frames are accumulated concurrently, each by a single
+                thread with its own neighbor query. This is faster for many
+                frames of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa: E501
+        if reset:
+            self._reset()
+
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        frame_shape = (trajectory.n_frames, trajectory.n_points)
+        orientations = _gen_trajectory_angle_array(orientations, frame_shape)
+        cdef const float[:, ::1] l_orientations = orientations
+
+        cdef bint l_parallel_frames = parallel_frames
+        with nogil:
+            self.pmftxytptr.accumulateTrajectory(
+                dereference(trajectory.thisptr),
+                <float*> &l_orientations[0, 0],
+                dereference(qargs.thisptr), l_parallel_frames)
         return self
 
     def __repr__(self):
@@ -435,11 +599,70 @@ cdef class PMFTXY(_PMFT):
             query_orientations, shape=(num_query_points, ))
         cdef const float[::1] l_query_orientations = query_orientations
 
-        self.pmftxyptr.accumulate(nq.get_ptr(),
-                                  <float*> &l_query_orientations[0],
-                                  <vec3[float]*> &l_query_points[0, 0],
-                                  num_query_points, nlist.get_ptr(),
-                                  dereference(qargs.thisptr))
+        with nogil:
+            self.pmftxyptr.accumulate(nq.get_ptr(),
+                                      <float*> &l_query_orientations[0],
+                                      <vec3[float]*> &l_query_points[0, 0],
+                                      num_query_points, nlist.get_ptr(),
+                                      dereference(qargs.thisptr))
+        return self
+
+    def compute_trajectory(self, boxes, points, query_orientations,
+                           neighbors=None, reset=True,
+                           parallel_frames=False):
+        R"""Calculates the PMFT of all frames of a trajectory.
+
+        This is equivalent to calling :meth:`~.compute` with
+        :code:`reset=False` for each frame, but all frames are accumulated in
+        a single call, and the neighbor query of each frame is built while
+        the previous frame is accumulated.
+
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame, which are also used as query
+                points. The array is not copied if it contains 32-bit floats,
+                so it may be memory-mapped.
+            query_orientations ((:math:`N_{frames}`, :math:`N_{points}`) :class:`numpy.ndarray`):
+                Angles of the points of each frame in radians, or
+                quaternions of shape (:math:`N_{frames}`, :math:`N_{points}`,
+                4) representing rotations about the z axis.
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the bonds of each frame (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            parallel_frames (bool, optional):
+                If True, frames are accumulated concurrently, each by a single
+                thread with its own neighbor query. This is faster for many
+                frames of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa: E501
+        if reset:
+            self._reset()
+
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        frame_shape = (trajectory.n_frames, trajectory.n_points)
+        query_orientations = _gen_trajectory_angle_array(
+            query_orientations, frame_shape)
+        cdef const float[:, ::1] l_query_orientations = query_orientations
+
+        cdef bint l_parallel_frames = parallel_frames
+        with nogil:
+            self.pmftxyptr.accumulateTrajectory(
+                dereference(trajectory.thisptr),
+                <float*> &l_query_orientations[0, 0],
+                dereference(qargs.thisptr), l_parallel_frames)
         return self
 
     @_Compute._computed_property
@@ -599,16 +822,108 @@ cdef class PMFTXYZ(_PMFT):
         cdef const float[:, ::1] l_equiv_orientations = equiv_orientations
         cdef unsigned int num_equiv_orientations = \
             l_equiv_orientations.shape[0]
-        self.pmftxyzptr.accumulate(
-            nq.get_ptr(),
-            <quat[float]*> &l_query_orientations[0, 0],
-            <vec3[float]*> &l_query_points[0, 0],
-            num_query_points,
-            <quat[float]*> &l_equiv_orientations[0, 0],
-            num_equiv_orientations, nlist.get_ptr(),
-            dereference(qargs.thisptr))
+        with nogil:
+            self.pmftxyzptr.accumulate(
+                nq.get_ptr(),
+                <quat[float]*> &l_query_orientations[0, 0],
+                <vec3[float]*> &l_query_points[0, 0],
+                num_query_points,
+                <quat[float]*> &l_equiv_orientations[0, 0],
+                num_equiv_orientations, nlist.get_ptr(),
+                dereference(qargs.thisptr))
         return self
 
+    def compute_trajectory(self, boxes, points, query_orientations,
+                           equiv_orientations=None, neighbors=None,
+                           reset=True, parallel_frames=False):
+        R"""Calculates the PMFT of all frames of a trajectory.
+
+        This is equivalent to calling :meth:`~.compute` with
+        :code:`reset=False` for each frame, but all frames are accumulated in
+        a single call, and the neighbor query of each frame is built while
+        the previous frame is accumulated.
+
+        Args:
+            boxes (box-like object or sequence of box-like objects):
+                The box of all frames, or a sequence containing the box of
+                each frame. Ignored if :code:`points` is a
+                :class:`freud.locality.GSDTrajectory`.
+            points ((:math:`N_{frames}`, :math:`N_{points}`, 3) :class:`numpy.ndarray` or :class:`freud.locality.GSDTrajectory`):
+                The points of each frame, which are also used as query
+                points. The array is not copied if it contains 32-bit floats,
+                so it may be memory-mapped.
+            query_orientations ((:math:`N_{frames}`, :math:`N_{points}`, 4) :class:`numpy.ndarray`):
+                Orientations of the points of each frame.
+            equiv_orientations ((:math:`N_{faces}`, 4) :class:`numpy.ndarray`, optional):
+                Orientations to be treated as equivalent to account for
+                symmetry of the points, see :meth:`~.compute`. If
+                :code:`None`, a unit quaternion will be used (Default value =
+                :code:`None`).
+            neighbors (dict, optional):
+                A dictionary of `query arguments
+                <https://freud.readthedocs.io/en/stable/topics/querying.html>`_
+                used to find the bonds of each frame (Default value: None).
+            reset (bool):
+                Whether to erase the previously computed values before adding
+                the new computation; if False, will accumulate data (Default
+                value: True).
+            parallel_frames (bool, optional):
+                If True, frames are accumulated concurrently, each by a single
+                thread with its own neighbor query. This is faster for many
+                frames of small systems, whose points are too few to keep all
+                threads busy (Default value = :code:`False`).
+        """  # noqa: E501
+        if reset:
+            self._reset()
+
+        cdef freud.locality._Trajectory trajectory = \
+            freud.locality._Trajectory(boxes, points)
+        cdef freud.locality._QueryArgs qargs = \
+            self._resolve_trajectory_neighbors(neighbors)
+
+        query_orientations = freud.util._convert_array(
+            query_orientations, shape=(trajectory.n_frames,
+                                       trajectory.n_points, 4))
+        cdef const float[:, :, ::1] l_query_orientations = query_orientations
+
+        if equiv_orientations is None:
+            equiv_orientations = np.array([[1, 0, 0, 0]], dtype=np.float32)
+        else:
+            equiv_orientations = freud.util._convert_array(
+                equiv_orientations, shape=(None, 4))
+        cdef const float[:, ::1] l_equiv_orientations = equiv_orientations
+
+        cdef bint l_parallel_frames = parallel_frames
+        with nogil:
+            self.pmftxyzptr.accumulateTrajectory(
+                dereference(trajectory.thisptr),
+                <quat[float]*> &l_query_orientations[0, 0, 0],
+                <quat[float]*> &l_equiv_orientations[0, 0],
+                l_equiv_orientations.shape[0],
+                dereference(qargs.thisptr), l_parallel_frames)
+        return self
+
+
+    cdef void _add_pipeline_stage(
+            self, freud._locality.NeighborPipeline *pipeline,
+            dict stage_arrays) except *:
+        if np.any(self.shiftvec != 0):
+            raise ValueError("A PMFTXYZ with a nonzero shiftvec cannot be "
+                             "computed in a NeighborPipeline.")
+        query_orientations = stage_arrays['query_orientations']
+        if query_orientations is None:
+            raise ValueError("query_orientations are required to compute a "
+                             "PMFTXYZ in a NeighborPipeline.")
+        cdef const float[:, ::1] l_query_orientations = query_orientations
+        cdef const float[:, ::1] l_equiv_orientations = \
+            stage_arrays['equiv_orientations']
+        pipeline.addStage(shared_ptr[freud._locality.NeighborPipelineStage](
+            new freud._pmft.PMFTXYZPipelineStage(
+                self.pmftxyzptr,
+                <quat[float]*> &l_query_orientations[0, 0],
+                <quat[float]*> &l_equiv_orientations[0, 0],
+                l_equiv_orientations.shape[0])))
+
     def __repr__(self):
         bounds = self.bounds
         return ("freud.pmft.{cls}(x_max={x_max}, y_max={y_max}, "
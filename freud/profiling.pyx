@@ -0,0 +1,155 @@
+# Copyright (c) 2010-2020 The Regents of the University of Michigan
+# This file is from the freud project, released under the BSD 3-Clause License.
+
+R"""
+The :class:`freud.profiling` module measures where the C++ code of freud
+spends its time. While profiling is enabled, the phases of computations, such
+as building a :class:`freud.locality.AABBQuery`, finding neighbors, binning
+bonds into histograms, and reducing thread local histograms, record their
+number of calls and total wall time, and hot loops count the bonds they visit,
+the cell list cells they scan, and the tree nodes they test.
+
+Timers are inclusive: the time of a phase includes the time of all phases it
+runs, for example ``NeighborQuery::forEachNeighbor`` includes
+``NeighborQuery::setup``, which includes ``AABBQuery::build`` if the points
+were given as a :code:`(box, points)` tuple. Phases that run concurrently on
+several threads, for example when accumulating frames in parallel, add up
+their times, which may then exceed the wall time.
+
+The instrumentation is compiled out by default, so that it has no cost in the
+hot paths it is placed in. freud must be built with ``python setup.py install
+--PROFILING`` for timers and counters to be recorded, and with ``--ITT`` to
+also annotate the timed phases as tasks of the Instrumentation and Tracing
+Technology (ITT) API, which profilers such as Intel VTune show on their
+timelines. :func:`is_compiled` tells whether the instrumentation is available.
+
+Example::
+
+    with freud.profiling.Profiler() as profiler:
+        pmft.compute((box, points), orientations)
+    print(profiler.report())
+"""
+
+cimport freud._util
+from libcpp.map cimport map
+from libcpp.string cimport string
+from libcpp.utility cimport pair
+
+_COUNTERS = {
+    'bonds_visited': freud._util.counter_bonds_visited,
+    'cells_scanned': freud._util.counter_cells_scanned,
+    'nodes_tested': freud._util.counter_nodes_tested}
+
+
+def _profile_address():
+    """Address of the C++ profile of this module, which other modules attach
+    to (see :code:`freud.util._attach_profile`)."""
+    return <size_t>&freud._util.getProfile()
+
+
+def is_compiled():
+    R"""Whether freud was built with profiling instrumentation.
+
+    Returns:
+        bool: :code:`True` if timers and counters are recorded while enabled.
+    """
+    return freud._util.isCompiled()
+
+
+def enable():
+    R"""Start recording timers and counters."""
+    freud._util.getProfile().setEnabled(True)
+
+
+def disable():
+    R"""Stop recording timers and counters, keeping their values."""
+    freud._util.getProfile().setEnabled(False)
+
+
+def is_enabled():
+    R"""Whether timers and counters are being recorded.
+
+    Returns:
+        bool: :code:`True` if profiling is enabled.
+    """
+    return freud._util.getProfile().isEnabled()
+
+
+def reset():
+    R"""Clear all timers and counters."""
+    freud._util.getProfile().reset()
+
+
+def get_timers():
+    R"""Get the timers of the phases that ran while profiling was enabled.
+
+    Returns:
+        dict: The number of calls and total time in seconds of each phase,
+        as a tuple keyed by the name of the phase.
+    """
+    cdef map[string, freud._util.TimerRecord] timers = \
+        freud._util.getProfile().getTimers()
+    cdef pair[string, freud._util.TimerRecord] timer
+    result = {}
+    for timer in timers:
+        result[timer.first.decode('utf-8')] = (
+            timer.second.calls, timer.second.seconds)
+    return result
+
+
+def get_counters():
+    R"""Get the counters of events in hot loops.
+
+    Returns:
+        dict: The number of bonds visited (:code:`'bonds_visited'`), cell
+        list cells scanned (:code:`'cells_scanned'`), and tree nodes tested
+        (:code:`'nodes_tested'`) while profiling was enabled.
+    """
+    return {name: freud._util.getProfile().getCount(counter)
+            for name, counter in _COUNTERS.items()}
+
+
+class Profiler:
+    R"""Context manager profiling the code it runs.
+
+    Timers and counters are reset when the context is entered, and recorded
+    until the context is exited, when profiling is disabled again.
+
+    Attributes:
+        timers (dict):
+            The timers recorded, see :func:`get_timers`.
+        counters (dict):
+            The counters recorded, see :func:`get_counters`.
+    """
+
+    def __init__(self):
+        self.timers = {}
+        self.counters = {}
+
+    def __enter__(self):
+        reset()
+        enable()
+        return self
+
+    def __exit__(self, *args):
+        disable()
+        self.timers = get_timers()
+        self.counters = get_counters()
+
+    def report(self):
+        R"""Format the recorded timers and counters as a table.
+
+        Phases are sorted by decreasing total time.
+
+        Returns:
+            str: The report.
+        """
+        lines = ['{:40s} {:>8s} {:>12s}'.format(
+            'phase', 'calls', 'time (ms)')]
+        for name, (calls, seconds) in sorted(
+                self.timers.items(), key=lambda item: -item[1][1]):
+            lines.append('{:40s} {:8d} {:12.3f}'.format(
+                name, calls, seconds * 1e3))
+        for name, count in sorted(self.counters.items()):
+            lines.append('{:40s} {:21d}'.format(name, count))
+        return '\n'.join(lines)
@@ -6,14 +6,17 @@
 import numpy as np
 
 from freud._util cimport vec3, quat, ManagedArray, PyArray_SetBaseObject
+from freud._util cimport Profile, attachProfile
 from cpython cimport Py_INCREF
 from libcpp.complex cimport complex
 from cython.operator cimport dereference
 from libcpp cimport bool
+from libc.stdint cimport uint16_t
 
 cimport numpy as np
 
 ctypedef unsigned int uint
+ctypedef unsigned char uchar
 ctypedef float complex fcomplex
 ctypedef double complex dcomplex
 
@@ -23,7 +26,10 @@ ctypedef enum arr_type_t:
     COMPLEX_FLOAT
     COMPLEX_DOUBLE
     UNSIGNED_INT
+    SIZE_T
     BOOL
+    UNSIGNED_CHAR
+    HALF
 
 
 ctypedef union arr_ptr_t:
@@ -33,7 +39,10 @@ ctypedef union arr_ptr_t:
     const ManagedArray[float complex] *complex_float_ptr
     const ManagedArray[double complex] *complex_double_ptr
     const ManagedArray[uint] *uint_ptr
+    const ManagedArray[size_t] *size_t_ptr
     const ManagedArray[bool] *bool_ptr
+    const ManagedArray[unsigned char] *uchar_ptr
+    const ManagedArray[uint16_t] *half_ptr
 
 
 cdef class _ManagedArrayContainer:
@@ -75,11 +84,26 @@ cdef class _ManagedArrayContainer:
                                          element_size)
             obj.thisptr.uint_ptr = new const ManagedArray[uint](
                 dereference(<const ManagedArray[uint] *>array))
+        elif arr_type == arr_type_t.SIZE_T:
+            obj = _ManagedArrayContainer(arr_type, np.NPY_UINT64,
+                                         element_size)
+            obj.thisptr.size_t_ptr = new const ManagedArray[size_t](
+                dereference(<const ManagedArray[size_t] *>array))
         elif arr_type == arr_type_t.BOOL:
             obj = _ManagedArrayContainer(arr_type, np.NPY_BOOL,
                                          element_size)
             obj.thisptr.bool_ptr = new const ManagedArray[bool](
                 dereference(<const ManagedArray[bool] *>array))
+        elif arr_type == arr_type_t.UNSIGNED_CHAR:
+            obj = _ManagedArrayContainer(arr_type, np.NPY_UINT8,
+                                         element_size)
+            obj.thisptr.uchar_ptr = new const ManagedArray[uchar](
+                dereference(<const ManagedArray[uchar] *>array))
+        elif arr_type == arr_type_t.HALF:
+            obj = _ManagedArrayContainer(arr_type, np.NPY_HALF,
+                                         element_size)
+            obj.thisptr.half_ptr = new const ManagedArray[uint16_t](
+                dereference(<const ManagedArray[uint16_t] *>array))
 
         return obj
 
@@ -92,5 +116,15 @@ cdef inline make_managed_numpy_array(
         _ManagedArrayContainer.init(array, arr_type, element_size))
 
 
+
+cdef inline _attach_profile():
+    """Record the timers and counters of the calling module in the profile of
+    :mod:`freud.profiling`, since every module has its own copy of the C++
+    profiling state."""
+    import freud.profiling
+    attachProfile(<Profile*><size_t>freud.profiling._profile_address())
+
+
 cdef class _Compute:
     cdef public bool _called_compute
+    cdef object _async_tail
@@ -3,9 +3,11 @@
 
 import numpy as np
 import freud.box
+import freud.parallel
 
 from functools import wraps
 
+cimport freud._util
 cimport numpy as np
 
 # numpy must be initialized. When using numpy from C or Cython you must
@@ -50,6 +52,8 @@ cdef class _ManagedArrayContainer:
     def shape(self):
         if self.data_type == arr_type_t.UNSIGNED_INT:
             return tuple(self.thisptr.uint_ptr.shape())
+        elif self.data_type == arr_type_t.SIZE_T:
+            return tuple(self.thisptr.size_t_ptr.shape())
         elif self.data_type == arr_type_t.FLOAT:
             return tuple(self.thisptr.float_ptr.shape())
         elif self.data_type == arr_type_t.DOUBLE:
@@ -60,6 +64,10 @@ cdef class _ManagedArrayContainer:
             return tuple(self.thisptr.complex_double_ptr.shape())
         elif self.data_type == arr_type_t.BOOL:
             return tuple(self.thisptr.bool_ptr.shape())
+        elif self.data_type == arr_type_t.UNSIGNED_CHAR:
+            return tuple(self.thisptr.uchar_ptr.shape())
+        elif self.data_type == arr_type_t.HALF:
+            return tuple(self.thisptr.half_ptr.shape())
 
     @property
     def element_size(self):
@@ -68,6 +76,8 @@ cdef class _ManagedArrayContainer:
     def __dealloc__(self):
         if self.data_type == arr_type_t.UNSIGNED_INT:
             del self.thisptr.uint_ptr
+        elif self.data_type == arr_type_t.SIZE_T:
+            del self.thisptr.size_t_ptr
         elif self.data_type == arr_type_t.FLOAT:
             del self.thisptr.float_ptr
         elif self.data_type == arr_type_t.DOUBLE:
@@ -78,6 +88,10 @@ cdef class _ManagedArrayContainer:
             del self.thisptr.complex_double_ptr
         elif self.data_type == arr_type_t.BOOL:
             del self.thisptr.bool_ptr
+        elif self.data_type == arr_type_t.UNSIGNED_CHAR:
+            del self.thisptr.uchar_ptr
+        elif self.data_type == arr_type_t.HALF:
+            del self.thisptr.half_ptr
 
     cdef void set_as_base(self, arr):
         """Sets the base of arr to be this object and increases the
@@ -89,6 +103,8 @@ cdef class _ManagedArrayContainer:
         """Return a constant raw pointer to the underlying data array."""
         if self.data_type == arr_type_t.UNSIGNED_INT:
             return self.thisptr.uint_ptr.get()
+        elif self.data_type == arr_type_t.SIZE_T:
+            return self.thisptr.size_t_ptr.get()
         elif self.data_type == arr_type_t.FLOAT:
             return self.thisptr.float_ptr.get()
         elif self.data_type == arr_type_t.DOUBLE:
@@ -99,6 +115,10 @@ cdef class _ManagedArrayContainer:
             return self.thisptr.complex_double_ptr.get()
         elif self.data_type == arr_type_t.BOOL:
             return self.thisptr.bool_ptr.get()
+        elif self.data_type == arr_type_t.UNSIGNED_CHAR:
+            return self.thisptr.uchar_ptr.get()
+        elif self.data_type == arr_type_t.HALF:
+            return self.thisptr.half_ptr.get()
 
     def __array__(self):
         """Convert the underlying data array into a read-only numpy array.
@@ -154,7 +174,7 @@ cdef class _Compute(object):
         """Compute methods set a flag to indicate that quantities have been
         computed. Compute must be called before plotting."""
         attribute = object.__getattribute__(self, attr)
-        if attr == 'compute':
+        if attr in ('compute', 'compute_trajectory'):
             # Set the attribute *after* computing. This enables
             # self._called_compute to be used in the compute method itself.
             compute = attribute
@@ -191,11 +211,114 @@ cdef class _Compute(object):
             return prop(self, *args, **kwargs)
         return wrapper
 
+    def compute_async(self, *args, **kwargs):
+        R"""Call :code:`compute` on a worker thread and return a future.
+
+        The arguments are the same as those of :code:`compute`, and the
+        result of the future is this object. Asynchronous computes of the
+        same object run one after another in the order they were submitted,
+        so frames can be accumulated with :code:`reset=False`, while computes
+        of different objects may run concurrently. Each compute releases the
+        GIL and uses the threads of the default TBB arena (see
+        :mod:`freud.parallel`).
+
+        The arguments are kept alive until the compute finishes, but arrays
+        passed to it must not be modified until then, and the properties of
+        this object must only be read once the future is done. The future
+        can be awaited in :mod:`asyncio` with :func:`asyncio.wrap_future`.
+
+        .. code-block:: python
+
+            rdf = freud.density.RDF(bins=50, r_max=5)
+            futures = [rdf.compute_async(frame, reset=False)
+                       for frame in frames]
+            rdf = futures[-1].result()
+
+        Returns:
+            :class:`concurrent.futures.Future`: Future of this object.
+        """
+        self._async_tail = freud.parallel._submit_after(
+            self._async_tail, self.compute, args, kwargs)
+        return self._async_tail
+
     def __str__(self):
         return repr(self)
 
 
-def _convert_array(array, shape=None, dtype=np.float32):
+# DLPack device types of arrays in host memory (CPU, CUDA and ROCm pinned
+# memory, and CUDA managed memory), which numpy can read directly.
+_DLPACK_HOST_DEVICES = (1, 3, 11, 13)
+
+
+def _to_host(array):
+    """Copy an array on a GPU to host memory.
+
+    Arrays exposing the CUDA array interface, such as CuPy arrays and the GPU
+    snapshots of HOOMD-blue, are copied with CuPy if it is installed, or with
+    their :code:`get` method otherwise. Arrays exposing the DLPack protocol
+    are read directly by numpy if they are in host memory, and copied with
+    CuPy otherwise. Any other object is returned unchanged.
+
+    Args:
+        array: Array to copy.
+
+    Returns:
+        Array in host memory, or the unchanged object.
+    """
+    if isinstance(array, np.ndarray):
+        return array
+    if hasattr(array, '__cuda_array_interface__'):
+        try:
+            import cupy
+        except ImportError:
+            if hasattr(array, 'get'):
+                return array.get()
+            raise TypeError(
+                "CuPy is required to copy arrays exposing the CUDA array "
+                "interface to the host.")
+        return cupy.asnumpy(cupy.asarray(array))
+    if hasattr(array, '__dlpack__') and hasattr(array, '__dlpack_device__'):
+        if array.__dlpack_device__()[0] in _DLPACK_HOST_DEVICES:
+            # numpy reads DLPack arrays since version 1.22.
+            if hasattr(np, 'from_dlpack'):
+                return np.from_dlpack(array)
+            return array
+        try:
+            import cupy
+        except ImportError:
+            raise TypeError(
+                "CuPy is required to copy DLPack arrays on a GPU to the host.")
+        return cupy.asnumpy(cupy.from_dlpack(array))
+    return array
+
+
+def _convert_float32(array):
+    """Convert a one- or two-dimensional float32 or float64 array of any
+    strides to a C-contiguous float32 array in a single parallel pass
+    (see :code:`convertStridedArray`), which is faster than conversions by
+    NumPy that first make the array contiguous."""
+    cdef np.ndarray source = array
+    result = np.empty(array.shape, dtype=np.float32)
+    if result.size == 0:
+        return result
+    cdef float[::1] l_result = result.reshape(-1)
+    cdef const char* data = <const char*> np.PyArray_DATA(source)
+    cdef size_t n_rows = array.shape[0]
+    cdef size_t n_cols = array.shape[1] if array.ndim == 2 else 1
+    cdef ptrdiff_t row_stride = array.strides[0]
+    cdef ptrdiff_t col_stride = array.strides[1] if array.ndim == 2 else 0
+    if array.dtype == np.float64:
+        with nogil:
+            freud._util.convertStridedArray[double, float](
+                data, n_rows, n_cols, row_stride, col_stride, &l_result[0])
+    else:
+        with nogil:
+            freud._util.convertStridedArray[float, float](
+                data, n_rows, n_cols, row_stride, col_stride, &l_result[0])
+    return result
+
+
+def _convert_array(array, shape=None, dtype=np.float32, copy=False):
     """Function which takes a given array, checks the dimensions and shape,
     and converts to a supplied dtype.
 
@@ -207,12 +330,28 @@ def _convert_array(array, shape=None, dtype=np.float32):
         dtype: :code:`dtype` to convert the array to if :code:`array.dtype`
             is different. If :code:`None`, :code:`dtype` will not be changed
             (Default value = :class:`numpy.float32`).
+        copy (bool): If :code:`True`, the returned array never shares memory
+            with :code:`array`, for callers that store it. Arrays that are
+            converted are not copied again (Default value = :code:`False`).
+
+    Arrays on a GPU, exposing the CUDA array interface or DLPack, are copied
+    to the host first (see :func:`_to_host`). Strided or float64 arrays of
+    one or two dimensions converted to float32 are read directly by a
+    parallel conversion instead of being made contiguous first.
 
     Returns:
         :class:`numpy.ndarray`: Array.
     """
-    array = np.asarray(array)
-    return_arr = np.require(array, dtype=dtype, requirements=['C'])
+    array = np.asarray(_to_host(array))
+    if (dtype is not None and np.dtype(dtype) == np.float32 and
+            array.ndim in (1, 2) and
+            array.dtype in (np.float32, np.float64) and
+            not (array.dtype == np.float32 and array.flags.c_contiguous)):
+        return_arr = _convert_float32(array)
+    else:
+        return_arr = np.require(array, dtype=dtype, requirements=['C'])
+        if copy and np.may_share_memory(return_arr, array):
+            return_arr = return_arr.copy()
     if shape is not None:
         if array.ndim != len(shape):
             raise ValueError("array.ndim = {}; expected ndim = {}".format(
@@ -228,6 +367,37 @@ def _convert_array(array, shape=None, dtype=np.float32):
     return return_arr
 
 
+def _check_output_buffer(out, shape, dtype=np.float32):
+    """Function which checks that an array can be used as an output buffer.
+
+    Computes accepting output buffers write their results directly into
+    caller-owned arrays, which may be reused across frames or be
+    memory-mapped with :class:`numpy.memmap`, instead of allocating new
+    arrays.
+
+    Args:
+        out (:class:`numpy.ndarray`): Array to check.
+        shape (tuple of int): Required shape of the array.
+        dtype: Required :code:`dtype` of the array
+            (Default value = :class:`numpy.float32`).
+
+    Returns:
+        :class:`numpy.ndarray`: Array.
+    """
+    if not isinstance(out, np.ndarray):
+        raise TypeError("The output buffer must be a numpy.ndarray.")
+    if out.dtype != np.dtype(dtype):
+        raise ValueError("out.dtype = {}; expected dtype = {}".format(
+            out.dtype, np.dtype(dtype)))
+    if out.shape != tuple(shape):
+        raise ValueError("out.shape = {}; expected shape = {}".format(
+            out.shape, tuple(shape)))
+    if not out.flags.c_contiguous or not out.flags.writeable:
+        raise ValueError(
+            "The output buffer must be C-contiguous and writeable.")
+    return out
+
+
 def _convert_box(box, dimensions=None):
     """Function which takes a box-like object and attempts to convert it to
     :class:`freud.box.Box`. Existing :class:`freud.box.Box` objects are
@@ -252,3 +422,104 @@ def _convert_box(box, dimensions=None):
         raise ValueError("The box must be {}-dimensional.".format(dimensions))
 
     return box
+
+
+_ACCUMULATION_STRATEGIES = {
+    'auto': freud._util.accumulate_auto,
+    'thread_local': freud._util.accumulate_thread_local,
+    'tiled': freud._util.accumulate_tiled,
+    'atomic': freud._util.accumulate_atomic,
+    'sparse': freud._util.accumulate_sparse}
+
+
+def _convert_accumulation_strategy(strategy):
+    """Function which converts the name of a parallel accumulation strategy to
+    the corresponding C++ value.
+
+    The available strategies are :code:`'thread_local'`, which accumulates
+    into a full copy of the output on each thread, :code:`'tiled'`, which
+    allocates tiles of the output on each thread only when they are written,
+    :code:`'atomic'`, which accumulates into a single shared output with
+    atomic additions, and :code:`'sparse'`, which stores only the written
+    elements on each thread. The default :code:`'auto'` uses
+    :code:`'thread_local'` unless the copies would exceed 256 MiB in total,
+    and :code:`'tiled'` otherwise.
+
+    Args:
+        strategy (str): Name of the strategy.
+
+    Returns:
+        int: The C++ strategy.
+    """
+    try:
+        return _ACCUMULATION_STRATEGIES[strategy]
+    except KeyError:
+        raise ValueError(
+            "Unknown accumulation strategy: {}. Options are {}.".format(
+                strategy, ", ".join(_ACCUMULATION_STRATEGIES)))
+
+
+def _accumulation_strategy_name(strategy):
+    """Function which converts a C++ parallel accumulation strategy to its
+    name.
+
+    Args:
+        strategy (int): The C++ strategy.
+
+    Returns:
+        str: Name of the strategy.
+    """
+    for key, value in _ACCUMULATION_STRATEGIES.items():
+        if value == strategy:
+            return key
+
+
+_PARTITIONERS = {
+    'auto': freud._util.partition_auto,
+    'simple': freud._util.partition_simple,
+    'static': freud._util.partition_static,
+    'affinity': freud._util.partition_affinity,
+    'balanced': freud._util.partition_balanced}
+
+
+def _convert_partitioner(partitioner):
+    """Function which converts the name of a loop partitioner to the
+    corresponding C++ value.
+
+    The available partitioners are :code:`'auto'`, TBB's default, which
+    splits blocks of work further when threads become idle,
+    :code:`'simple'`, which splits the loop into blocks of at most the grain
+    size, :code:`'static'`, which gives each thread one contiguous block,
+    :code:`'affinity'`, which gives each thread the blocks it processed in
+    the previous compute, and :code:`'balanced'`, which splits the loop into
+    blocks with equal total numbers of neighbors of a
+    :class:`freud.locality.NeighborList` and processes the most expensive
+    blocks first. :code:`'balanced'` behaves as :code:`'auto'` when no
+    NeighborList is provided.
+
+    Args:
+        partitioner (str): Name of the partitioner.
+
+    Returns:
+        int: The C++ partitioner.
+    """
+    try:
+        return _PARTITIONERS[partitioner]
+    except KeyError:
+        raise ValueError(
+            "Unknown partitioner: {}. Options are {}.".format(
+                partitioner, ", ".join(_PARTITIONERS)))
+
+
+def _partitioner_name(partitioner):
+    """Function which converts a C++ loop partitioner to its name.
+
+    Args:
+        partitioner (int): The C++ partitioner.
+
+    Returns:
+        str: Name of the partitioner.
+    """
+    for key, value in _PARTITIONERS.items():
+        if value == partitioner:
+            return key
@@ -69,6 +69,8 @@ def stderr_manager(f):
 warnings_str = "--PRINT-WARNINGS"
 coverage_str = "--COVERAGE"
 debug_str = "--DEBUG"
+profiling_str = "--PROFILING"
+itt_str = "--ITT"
 parallel_str = "-j"
 thread_str = "--NTHREAD"
 tbb_root_str = "--TBB-ROOT"
@@ -110,6 +112,21 @@ parser.add_argument(
     dest="gdb_debug",
     help="Enable GDB debug symbols in Cython."
 )
+parser.add_argument(
+    profiling_str,
+    action="store_true",
+    dest="use_profiling",
+    help="Compile the timers and counters of freud.profiling into the C++ "
+         "code. They are compiled out by default."
+)
+parser.add_argument(
+    itt_str,
+    action="store_true",
+    dest="use_itt",
+    help="Annotate the phases timed by freud.profiling as ITT tasks, which "
+         "are shown by profilers such as Intel VTune. Implies --PROFILING "
+         "and requires the ittnotify library."
+)
 parser.add_argument(
     parallel_str,
     type=int,
@@ -203,6 +220,12 @@ if args.use_coverage:
     macros.append(('CYTHON_TRACE', '1'))
     macros.append(('CYTHON_TRACE_NOGIL', '1'))
 
+# Decide whether or not to compile the profiling instrumentation
+if args.use_profiling or args.use_itt:
+    macros.append(('FREUD_PROFILING', '1'))
+if args.use_itt:
+    macros.append(('FREUD_USE_ITT', '1'))
+
 
 # Enable build parallel compile within modules.
 def parallelCCompile(self, sources, output_dir=None, macros=None,
@@ -319,6 +342,8 @@ if tbb_include:
 include_dirs.append(os.path.join(sys.prefix, 'include'))
 
 libraries = ["tbb"]
+if args.use_itt:
+    libraries.append("ittnotify")
 library_dirs = [tbb_link] if tbb_link else []
 
 compile_args = link_args = ["-std=c++11"]
@@ -349,14 +374,27 @@ sources_in_all = [
     os.path.join("cpp", "locality", "NeighborPerPointIterator.cc"),
     os.path.join("cpp", "locality", "NeighborQuery.cc"),
     os.path.join("cpp", "locality", "AABBQuery.cc"),
+    os.path.join("cpp", "locality", "LinkCell.cc"),
     os.path.join("cpp", "locality", "NeighborList.cc"),
+    os.path.join("cpp", "locality", "CompressedNeighborList.cc"),
+    os.path.join("cpp", "locality", "BondGeometry.cc"),
     os.path.join("cpp", "locality", "NeighborComputeFunctional.cc"),
+    os.path.join("cpp", "locality", "NeighborQueryBackend.cc"),
+    os.path.join("cpp", "locality", "Trajectory.cc"),
+    os.path.join("cpp", "locality", "FrameSource.cc"),
+    os.path.join("cpp", "util", "Profiling.cc"),
 ]
 
 # Any source files required only for specific modules.
 # Dict keys should be specified as the module name without
 # "freud.", i.e. not the fully qualified name.
 extra_module_sources = dict(
+    density=[
+        os.path.join("cpp", "util", "FFT.cc"),
+    ],
+    diffraction=[
+        os.path.join("cpp", "util", "FFT.cc"),
+    ],
     environment=[
         os.path.join("cpp", "util", "diagonalize.cc"),
     ],
@@ -372,6 +410,9 @@ extra_module_sources = dict(
         os.path.join("extern", "voro++", "src", "pre_container.cc"),
         os.path.join("extern", "voro++", "src", "container_prd.cc"),
     ],
+    msd=[
+        os.path.join("cpp", "util", "FFT.cc"),
+    ],
     order=[
         os.path.join("cpp", "util", "diagonalize.cc"),
         os.path.join("cpp", "cluster", "Cluster.cc"),
@@ -114,6 +114,40 @@ class TestBox(unittest.TestCase):
         points = np.array(points)
         npt.assert_allclose(box.wrap(points)[0, 0], -2, rtol=1e-6)
 
+    def test_wrap_large_box(self):
+        """Check that wrapping large boxes does not move points inside the
+        box, and shifts other points by exact box vectors."""
+        np.random.seed(0)
+        box = freud.box.Box(3e4, 2e4, 1e4, 0.1, 0.2, 0.3)
+        points = box.wrap(np.random.uniform(
+            -1e5, 1e5, size=(100, 3)).astype(np.float32))
+        npt.assert_array_equal(box.wrap(points), points)
+        shifted = (points + box.to_matrix().dot([2, -1, 1])).astype(
+            np.float32)
+        npt.assert_allclose(box.wrap(shifted), points, atol=5e-2)
+
+    def test_array_methods_match_single_vectors(self):
+        """Check that methods on arrays, which process several vectors at a
+        time, give the same results as on each vector separately."""
+        np.random.seed(0)
+        boxes = [freud.box.Box(10, 12, 9), freud.box.Box(10, 12, 9, 0.3,
+                                                         -0.2, 0.5),
+                 freud.box.Box(10, 12, is2D=True),
+                 freud.box.Box(10, 12, xy=0.3, is2D=True)]
+        for box in boxes:
+            points = np.random.uniform(-40, 40, (23, 3)).astype(np.float32)
+            if box.is2D:
+                points[:, 2] = 0
+            images = np.random.randint(-3, 4, (23, 3))
+            for method, args in [('wrap', ()), ('make_fractional', ()),
+                                 ('make_absolute', ()), ('get_images', ()),
+                                 ('unwrap', (images,))]:
+                result = getattr(box, method)(points, *args)
+                expected = np.array([
+                    getattr(box, method)(points[i], *[a[i] for a in args])
+                    for i in range(len(points))])
+                npt.assert_array_equal(result, expected)
+
     def test_unwrap(self):
         box = freud.box.Box(2, 2, 2, 1, 0, 0)
 
@@ -100,6 +100,15 @@ class TestCluster(unittest.TestCase):
         npt.assert_allclose(
             props.radii_of_gyration, [0, rg_2], rtol=1e-5, atol=1e-5)
 
+        # Inertia tensors of unit masses follow from the gyration tensors
+        for gyration, inertia, size in zip(
+                props.gyrations, props.inertia_tensors, props.sizes):
+            npt.assert_allclose(
+                inertia,
+                size * (np.trace(gyration) * np.eye(3) - gyration),
+                rtol=1e-5, atol=1e-5)
+        npt.assert_equal(props.size_histogram, [0, 0, 2])
+
     def test_cluster_com_periodic(self):
         "Tests center of mass for symmetric, box-spanning clusters."
         box = freud.Box.cube(3)
@@ -114,6 +123,27 @@ class TestCluster(unittest.TestCase):
 
         npt.assert_allclose(clp.centers, [[-1.4, 0, 0]], rtol=1e-5, atol=1e-5)
 
+    def test_cluster_props_many(self):
+        """Compare against NumPy for many clusters in shuffled order."""
+        box, points = freud.data.make_random_system(20, 2000, seed=4)
+        cl = freud.cluster.Cluster()
+        cl.compute((box, points), neighbors={'r_max': 1.0})
+        props = freud.cluster.ClusterProperties()
+        props.compute((box, points), cl.cluster_idx)
+
+        sizes = np.bincount(cl.cluster_idx)
+        npt.assert_equal(props.sizes, sizes)
+        npt.assert_equal(props.size_histogram, np.bincount(sizes))
+        for c in range(cl.num_clusters):
+            delta = box.wrap(points[cl.cluster_idx == c] - props.centers[c])
+            npt.assert_allclose(props.gyrations[c],
+                                delta.T.dot(delta) / sizes[c],
+                                rtol=1e-4, atol=1e-5)
+        npt.assert_allclose(
+            props.radii_of_gyration,
+            np.sqrt(np.trace(props.gyrations, axis1=-2, axis2=-1)),
+            rtol=1e-5, atol=1e-6)
+
     def test_cluster_keys(self):
         Nlattice = 4
         Nrep = 5
@@ -148,6 +178,71 @@ class TestCluster(unittest.TestCase):
 
         self.assertTrue(np.all(ckeys == check_values))
 
+    def test_half(self):
+        box, positions = freud.data.UnitCell.fcc().generate_system(
+            4, sigma_noise=0.1, seed=1)
+        clust = freud.cluster.Cluster()
+        clust.compute((box, positions), neighbors={'r_max': 0.5})
+        cluster_idx = np.copy(clust.cluster_idx)
+        clust.compute((box, positions),
+                      neighbors={'r_max': 0.5, 'half': True})
+        npt.assert_equal(clust.cluster_idx, cluster_idx)
+
+        # Computes that are not symmetric in the points of a bond reject
+        # half neighbor lists.
+        nlist = freud.locality.AABBQuery(box, positions).query(
+            positions, dict(r_max=0.5, exclude_ii=True,
+                            half=True)).toNeighborList()
+        ql = freud.order.Steinhardt(6)
+        with self.assertRaises(ValueError):
+            ql.compute((box, positions), neighbors=nlist)
+        with self.assertRaises(ValueError):
+            ql.compute((box, positions),
+                       neighbors={'r_max': 0.5, 'half': True})
+
+    def test_concurrent_union(self):
+        """Check that clusters united by many threads match a serial
+        union-find."""
+        N = 20000
+        box, positions = freud.data.make_random_system(10, N, seed=0)
+        rng = np.random.RandomState(0)
+        for _ in range(10):
+            # Long chains visited in random order make deep trees whose
+            # paths are split by many threads at once.
+            chain = rng.permutation(N)
+            keep = rng.rand(N - 1) > 0.02
+            bonds = np.stack([chain[:-1][keep], chain[1:][keep]], axis=1)
+            bonds = bonds[rng.permutation(len(bonds))]
+
+            parents = np.arange(N)
+
+            def find(i):
+                while parents[i] != i:
+                    parents[i] = parents[parents[i]]
+                    i = parents[i]
+                return i
+
+            for i, j in bonds:
+                root_i, root_j = find(i), find(j)
+                parents[max(root_i, root_j)] = min(root_i, root_j)
+            roots = np.array([find(i) for i in range(N)])
+
+            # Clusters are numbered by decreasing size, then by their
+            # smallest point index, which is their root.
+            unique_roots, sizes = np.unique(roots, return_counts=True)
+            order = np.lexsort((unique_roots, -sizes))
+            labels = np.empty(N, dtype=np.uint32)
+            labels[unique_roots[order]] = np.arange(len(order))
+
+            order = np.argsort(bonds[:, 0], kind='stable')
+            nlist = freud.locality.NeighborList.from_arrays(
+                N, N, bonds[order, 0], bonds[order, 1], np.ones(len(bonds)))
+            with freud.parallel.NumThreads(8):
+                clust = freud.cluster.Cluster().compute(
+                    (box, positions), neighbors=nlist)
+            self.assertEqual(clust.num_clusters, len(unique_roots))
+            npt.assert_equal(clust.cluster_idx, labels[roots])
+
     def test_repr(self):
         clust = freud.cluster.Cluster()
         self.assertEqual(str(clust), str(eval(repr(clust))))
@@ -170,6 +265,82 @@ class TestCluster(unittest.TestCase):
         clust._repr_png_()
 
 
+class TestClusterTracker(unittest.TestCase):
+    def test_constructor(self):
+        with self.assertRaises(ValueError):
+            freud.cluster.ClusterTracker(min_size=0)
+
+    def test_track(self):
+        tracker = freud.cluster.ClusterTracker(min_size=2)
+
+        # Test protected attribute access
+        with self.assertRaises(AttributeError):
+            tracker.cluster_ids
+
+        # Two tracked clusters are born, and the isolated point is untracked.
+        tracker.track([0, 0, 0, 1, 1, 2])
+        npt.assert_equal(tracker.cluster_ids, [0, 1, -1])
+        self.assertEqual(tracker.overlap.shape, (0, 3))
+        npt.assert_equal(tracker.events, [[tracker.BIRTH, -1, 0],
+                                          [tracker.BIRTH, -1, 1]])
+
+        # Both clusters merge, and the larger one keeps its id.
+        tracker.track([0, 0, 0, 0, 0, 1])
+        npt.assert_equal(tracker.cluster_ids, [0, -1])
+        npt.assert_equal(tracker.overlap, [[0, 0, 3], [1, 0, 2]])
+        npt.assert_equal(tracker.events, [[tracker.MERGE, 0, 0],
+                                          [tracker.MERGE, 1, 0]])
+
+        # The merged cluster splits, and the smaller part gets a new id.
+        tracker.track([0, 0, 0, 1, 1, 1])
+        npt.assert_equal(tracker.cluster_ids, [0, 2])
+        npt.assert_equal(tracker.overlap, [[0, 0, 3], [0, 1, 2]])
+        npt.assert_equal(tracker.events, [[tracker.SPLIT, 0, 0],
+                                          [tracker.SPLIT, 0, 2]])
+
+        # One cluster dies when all its points become isolated.
+        tracker.track([0, 0, 0, 1, 2, 3])
+        npt.assert_equal(tracker.cluster_ids, [0, -1, -1, -1])
+        npt.assert_equal(tracker.events, [[tracker.DEATH, 2, -1]])
+        self.assertEqual(tracker.num_frames, 4)
+        self.assertEqual(tracker.num_ids, 3)
+
+        # The number of points cannot change between frames.
+        with self.assertRaises(ValueError):
+            tracker.track([0, 0, 1])
+
+        tracker.reset()
+        self.assertEqual(tracker.num_frames, 0)
+        tracker.track([0, 0, 1])
+        npt.assert_equal(tracker.cluster_ids, [0, -1])
+
+    def test_compute(self):
+        box = freud.box.Box.cube(10)
+        np.random.seed(0)
+        points = box.wrap(np.random.rand(200, 3)*box.L - box.L/2)
+        tracker = freud.cluster.ClusterTracker()
+        clust = freud.cluster.Cluster()
+
+        tracker.compute((box, points), neighbors={'r_max': 1.0})
+        clust.compute((box, points), neighbors={'r_max': 1.0})
+        npt.assert_equal(tracker.cluster_idx, clust.cluster_idx)
+        npt.assert_equal(tracker.cluster_ids, np.arange(clust.num_clusters))
+        self.assertEqual(len(tracker.events), clust.num_clusters)
+
+        # Clusters of an unchanged frame keep their ids without events.
+        tracker.compute((box, points), neighbors={'r_max': 1.0})
+        npt.assert_equal(tracker.cluster_ids, np.arange(clust.num_clusters))
+        self.assertEqual(len(tracker.events), 0)
+        npt.assert_equal(tracker.overlap[:, 0], tracker.overlap[:, 1])
+        npt.assert_equal(tracker.overlap[:, 2],
+                         np.bincount(clust.cluster_idx))
+        self.assertEqual(tracker.num_ids, clust.num_clusters)
+
+    def test_repr(self):
+        tracker = freud.cluster.ClusterTracker(min_size=3)
+        self.assertEqual(str(tracker), str(eval(repr(tracker))))
+
+
 class TestClusterManagedArray(TestManagedArray, unittest.TestCase):
     def build_object(self):
         self.obj = freud.cluster.Cluster()
@@ -86,6 +86,105 @@ class TestCorrelationFunction(unittest.TestCase):
             npt.assert_allclose(ocf.correlation, correct,
                                 atol=absolute_tolerance)
 
+    def test_accumulation_strategies(self):
+        r_max = 10.0
+        bins = 10
+        num_points = 1000
+        box_size = r_max*3.1
+        box, points = freud.data.make_random_system(
+            box_size, num_points, is2D=True)
+        ang = np.random.random_sample((num_points)).astype(np.float64) \
+            * 2.0 * np.pi
+        comp = np.exp(1j*ang)
+
+        ocf = freud.density.CorrelationFunction(bins, r_max)
+        ocf.compute((box, points), comp)
+        correlation = ocf.correlation
+        bin_counts = ocf.bin_counts
+        for strategy in ['thread_local', 'tiled', 'atomic', 'sparse']:
+            ocf.accumulation_strategy = strategy
+            ocf.compute((box, points), comp)
+            npt.assert_allclose(ocf.correlation, correlation, atol=1e-6)
+            npt.assert_equal(ocf.bin_counts, bin_counts)
+
+    def test_half(self):
+        r_max = 10.0
+        bins = 10
+        num_points = 1000
+        box_size = r_max*3.1
+        box, points = freud.data.make_random_system(
+            box_size, num_points, is2D=True)
+        ang = np.random.random_sample((num_points)).astype(np.float64) \
+            * 2.0 * np.pi
+        comp = np.exp(1j*ang)
+        query_comp = np.exp(2j*ang)
+
+        ocf = freud.density.CorrelationFunction(bins, r_max)
+        ocf.compute((box, points), comp, query_values=query_comp)
+        correlation = ocf.correlation
+        bin_counts = ocf.bin_counts
+
+        # Half lists accumulate the product of each bond in both directions.
+        ocf.compute((box, points), comp, query_values=query_comp,
+                    neighbors=dict(r_max=r_max, half=True))
+        npt.assert_allclose(ocf.correlation, correlation, atol=1e-6)
+        npt.assert_equal(ocf.bin_counts, bin_counts)
+
+    def test_serialize(self):
+        r_max = 3.0
+        bins = 10
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        values = np.exp(1j*np.random.RandomState(0).rand(500)*2*np.pi)
+        ocf = freud.density.CorrelationFunction(bins, r_max)
+        ocf.compute((box, points), values)
+
+        merged = freud.density.CorrelationFunction(bins, r_max)
+        merged.merge(ocf).merge(ocf.serialize())
+        npt.assert_equal(merged.bin_counts, 2 * ocf.bin_counts)
+        npt.assert_allclose(merged.correlation, ocf.correlation, atol=1e-6)
+        self.assertTrue(np.iscomplexobj(merged.correlation))
+
+        # States are only restored by correlation functions of the same type.
+        with self.assertRaises(ValueError):
+            freud.density.CorrelationFunction(
+                bins, r_max, dtype=np.float64).deserialize(ocf.serialize())
+        real_ocf = freud.density.CorrelationFunction(
+            bins, r_max, dtype=np.float32)
+        real_ocf.compute((box, points), np.real(values))
+        restored = freud.density.CorrelationFunction(
+            bins, r_max, dtype=np.float32).deserialize(real_ocf.serialize())
+        npt.assert_equal(restored.correlation, real_ocf.correlation)
+
+    def test_compute_trajectory(self):
+        r_max = 3.0
+        bins = 10
+        num_points = 500
+        boxes = []
+        points = []
+        values = []
+        ocf = freud.density.CorrelationFunction(bins, r_max)
+        for frame in range(3):
+            box, frame_points = freud.data.make_random_system(
+                10 + frame, num_points, is2D=True, seed=frame)
+            frame_values = np.exp(1j*np.random.rand(num_points)*2*np.pi)
+            boxes.append(box)
+            points.append(frame_points)
+            values.append(frame_values)
+            ocf.compute((box, frame_points), frame_values, reset=False)
+
+        trajectory_ocf = freud.density.CorrelationFunction(bins, r_max)
+        trajectory_ocf.compute_trajectory(
+            boxes, np.array(points), np.array(values))
+        npt.assert_equal(trajectory_ocf.bin_counts, ocf.bin_counts)
+        npt.assert_allclose(trajectory_ocf.correlation, ocf.correlation,
+                            atol=1e-6)
+
+        trajectory_ocf.compute_trajectory(
+            boxes, np.array(points), np.array(values), parallel_frames=True)
+        npt.assert_equal(trajectory_ocf.bin_counts, ocf.bin_counts)
+        npt.assert_allclose(trajectory_ocf.correlation, ocf.correlation,
+                            atol=1e-6)
+
     def test_random_points_real(self):
         r_max = 10.0
         bins = 10
@@ -207,6 +306,91 @@ class TestCorrelationFunction(unittest.TestCase):
     def test_repr(self):
         cf = freud.density.CorrelationFunction(1000, 40)
         self.assertEqual(str(cf), str(eval(repr(cf))))
+        cf = freud.density.CorrelationFunction(1000, 40, dtype=np.float32)
+        self.assertEqual(str(cf), str(eval(repr(cf))))
+
+    def test_dtypes(self):
+        """Check that correlations in every type match the default complex
+        double precision."""
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        np.random.seed(0)
+        values = np.random.uniform(-1, 1, len(points))
+        complex_values = np.exp(1j * values)
+        reference = freud.density.CorrelationFunction(20, 3)
+        reference.compute((box, points), values)
+        complex_reference = freud.density.CorrelationFunction(20, 3)
+        complex_reference.compute((box, points), complex_values)
+
+        for dtype in [np.complex128, np.complex64, np.float64, np.float32]:
+            cf = freud.density.CorrelationFunction(20, 3, dtype=dtype)
+            self.assertEqual(cf.dtype, dtype)
+            cf.compute((box, points), values)
+            npt.assert_array_equal(cf.bin_counts, reference.bin_counts)
+            npt.assert_allclose(cf.correlation, reference.correlation,
+                                rtol=1e-4, atol=1e-5)
+            self.assertFalse(np.iscomplexobj(cf.correlation))
+            trajectory = freud.density.CorrelationFunction(20, 3, dtype=dtype)
+            trajectory.compute_trajectory(box, points[np.newaxis],
+                                          values[np.newaxis])
+            npt.assert_allclose(trajectory.correlation, cf.correlation,
+                                rtol=1e-5, atol=1e-6)
+
+            if np.dtype(dtype).kind == 'c':
+                cf.compute((box, points), complex_values)
+                npt.assert_allclose(cf.correlation,
+                                    complex_reference.correlation,
+                                    rtol=1e-4, atol=1e-5)
+            else:
+                with self.assertRaises(ValueError):
+                    cf.compute((box, points), complex_values)
+
+        with self.assertRaises(ValueError):
+            freud.density.CorrelationFunction(20, 3, dtype=np.int32)
+
+    def test_fft_engine(self):
+        """Check that the FFT engine approximates the direct engine for
+        correlations over half of the box."""
+        L = 10
+        r_max = 4.5
+        for is2D in [False, True]:
+            box, points = freud.data.make_random_system(
+                L, 3000, is2D=is2D, seed=0)
+            values = np.exp(2j * np.pi * points[:, 0] / L) + 0.3
+            direct = freud.density.CorrelationFunction(15, r_max)
+            direct.compute((box, points), values)
+            for assignment in ['cic', 'tsc']:
+                cf = freud.density.CorrelationFunction(15, r_max)
+                cf.engine = 'fft'
+                cf.assignment = assignment
+                self.assertEqual(cf.engine, 'fft')
+                cf.compute((box, points), values)
+                npt.assert_allclose(cf.correlation, direct.correlation,
+                                    atol=0.04)
+                npt.assert_allclose(cf.bin_counts, direct.bin_counts,
+                                    rtol=0.05)
+
+                # Without excluding pairs of a point with itself, their
+                # correlation is added near r = 0.
+                cf.compute((box, points), values,
+                           neighbors=dict(r_max=r_max, exclude_ii=False))
+                self.assertGreater(cf.bin_counts[0],
+                                   direct.bin_counts[0] + len(points) / 4)
+
+        cf = freud.density.CorrelationFunction(15, r_max)
+        cf.engine = 'fft'
+        cf.grid_width = 32
+        self.assertEqual(cf.grid_width, (32, 32, 32))
+        cf.compute((box, points), values)
+        npt.assert_allclose(cf.correlation, direct.correlation, atol=0.05)
+        with self.assertRaises(ValueError):
+            cf.compute((box, points), values,
+                       neighbors=dict(num_neighbors=4))
+        with self.assertRaises(ValueError):
+            cf.grid_width = (0, 4, 4)
+        with self.assertRaises(ValueError):
+            cf.engine = 'slow'
+        with self.assertRaises(ValueError):
+            cf.assignment = 'ngp'
 
     def test_repr_png(self):
         r_max = 10.0
@@ -103,6 +103,115 @@ class TestGaussianDensity(unittest.TestCase):
         # This has discretization error as well as single-precision error
         assert np.isclose(np.sum(gd.density), 1, atol=1e-4)
 
+    def test_accumulation_strategies(self):
+        width = 40
+        r_max = 5
+        sigma = 2
+        num_points = 100
+        box_size = width
+        box, points = freud.data.make_random_system(box_size, num_points)
+
+        gd = freud.density.GaussianDensity(width, r_max, sigma)
+        self.assertEqual(gd.accumulation_strategy, 'auto')
+        gd.compute(system=(box, points))
+        density = gd.density
+        for strategy in ['thread_local', 'tiled', 'atomic', 'sparse']:
+            gd.accumulation_strategy = strategy
+            self.assertEqual(gd.accumulation_strategy, strategy)
+            gd.compute(system=(box, points))
+            npt.assert_allclose(gd.density, density, rtol=1e-5, atol=1e-7)
+
+        with self.assertRaises(ValueError):
+            gd.accumulation_strategy = 'invalid'
+
+    def test_engines(self):
+        r_max = 2.5
+        sigma = 0.8
+        for is2D in [True, False]:
+            width = (40, 48) if is2D else (40, 48, 44)
+            box = freud.box.Box(10, 12, 0 if is2D else 11, is2D=is2D)
+            points = box.wrap(np.random.RandomState(0).uniform(
+                -6, 6, (300, 3)).astype(np.float32))
+            if is2D:
+                points[:, 2] = 0
+
+            gd = freud.density.GaussianDensity(width, r_max, sigma)
+            self.assertEqual(gd.engine, 'auto')
+            self.assertEqual(gd.assignment, 'cic')
+            gd.engine = 'direct'
+            gd.compute((box, points))
+            direct = gd.density
+
+            gd.engine = 'separable'
+            gd.compute((box, points))
+            npt.assert_allclose(gd.density, direct, rtol=1e-5, atol=1e-6)
+
+            # Assigning points to the grid smooths the density.
+            for assignment in ['cic', 'tsc']:
+                gd.engine = 'fft'
+                gd.assignment = assignment
+                self.assertEqual(gd.engine, 'fft')
+                self.assertEqual(gd.assignment, assignment)
+                gd.compute((box, points))
+                npt.assert_allclose(gd.density, direct,
+                                    atol=0.05*np.max(direct))
+                npt.assert_allclose(np.sum(gd.density), np.sum(direct),
+                                    rtol=5e-3)
+
+        # The separable engine requires a box without tilt.
+        gd = freud.density.GaussianDensity(40, r_max, sigma)
+        gd.engine = 'separable'
+        tilted_box = freud.box.Box(10, 12, 11, xy=0.1)
+        with self.assertRaises(ValueError):
+            gd.compute((tilted_box, tilted_box.wrap(points)))
+
+        # The FFT engine requires a periodic box.
+        gd = freud.density.GaussianDensity(40, r_max, sigma)
+        gd.engine = 'fft'
+        aperiodic_box = freud.box.Box(10, 12, 11)
+        aperiodic_box.periodic_x = False
+        with self.assertRaises(ValueError):
+            gd.compute((aperiodic_box, points))
+
+        with self.assertRaises(ValueError):
+            gd.engine = 'invalid'
+        with self.assertRaises(ValueError):
+            gd.assignment = 'invalid'
+
+    def test_output_buffer(self):
+        r_max = 2.5
+        sigma = 0.8
+        for is2D in [True, False]:
+            width = (40, 48) if is2D else (40, 48, 44)
+            box, points = freud.data.make_random_system(
+                10, 300, is2D=is2D, seed=0)
+            gd = freud.density.GaussianDensity(width, r_max, sigma)
+            gd.compute((box, points))
+            expected = np.copy(gd.density)
+
+            # The density is written into the buffer on every frame.
+            out = np.full(width, -1, dtype=np.float32)
+            for _ in range(2):
+                gd.compute((box, points), out=out)
+                self.assertIs(gd.density, out)
+                npt.assert_equal(out, expected)
+
+            # Without a buffer, the density is stored in its own array again.
+            gd.compute((box, points))
+            self.assertIsNot(gd.density, out)
+            npt.assert_equal(gd.density, expected)
+
+            with self.assertRaises(ValueError):
+                gd.compute((box, points), out=np.zeros(width))
+            with self.assertRaises(ValueError):
+                gd.compute((box, points),
+                           out=np.zeros(width[:-1], dtype=np.float32))
+            with self.assertRaises(ValueError):
+                gd.compute((box, points),
+                           out=np.zeros(width[::-1], dtype=np.float32).T)
+            with self.assertRaises(TypeError):
+                gd.compute((box, points), out=expected.tolist())
+
     def test_repr(self):
         gd = freud.density.GaussianDensity(100, 10.0, 0.1)
         self.assertEqual(str(gd), str(eval(repr(gd))))
@@ -69,6 +69,58 @@ class TestLD(unittest.TestCase):
         neighbors = self.ld.num_neighbors
         npt.assert_array_less(np.fabs(neighbors - 1130.973355292), 200)
 
+    def test_partitioners(self):
+        nlist = freud.locality.AABBQuery(self.box, self.pos).query(
+            self.pos, dict(r_max=self.r_max + 0.5*self.diameter,
+                           exclude_ii=True)).toNeighborList()
+        self.ld.compute((self.box, self.pos), neighbors=nlist)
+        density = np.copy(self.ld.density)
+        for partitioner in ['simple', 'static', 'affinity', 'balanced']:
+            self.ld.partitioner = partitioner
+            self.ld.grain_size = 32
+            self.ld.compute((self.box, self.pos), neighbors=nlist)
+            npt.assert_allclose(self.ld.density, density, rtol=1e-6)
+
+    def test_half(self):
+        query_args = dict(r_max=self.r_max + 0.5*self.diameter,
+                          exclude_ii=True)
+        self.ld.compute((self.box, self.pos), neighbors=query_args)
+        density = np.copy(self.ld.density)
+        num_neighbors = np.copy(self.ld.num_neighbors)
+
+        # Each bond of a half list is a neighbor of both of its points.
+        query_args['half'] = True
+        self.ld.compute((self.box, self.pos), neighbors=query_args)
+        npt.assert_allclose(self.ld.density, density, rtol=1e-5)
+        npt.assert_allclose(self.ld.num_neighbors, num_neighbors, rtol=1e-5)
+
+    def test_multiple_r_max(self):
+        r_maxs = [1.5, 2, 2.5, 3]
+        ld = freud.density.LocalDensity(r_maxs, self.diameter)
+        self.assertEqual(ld.r_max, r_maxs)
+        ld.compute((self.box, self.pos))
+        self.assertEqual(ld.density.shape, (len(self.pos), len(r_maxs)))
+        self.assertEqual(ld.num_neighbors.shape,
+                         (len(self.pos), len(r_maxs)))
+
+        # Each column matches a separate compute with that r_max.
+        for k, r_max in enumerate(r_maxs):
+            single = freud.density.LocalDensity(r_max, self.diameter)
+            single.compute((self.box, self.pos))
+            npt.assert_allclose(ld.density[:, k], single.density,
+                                rtol=1e-5)
+            npt.assert_allclose(ld.num_neighbors[:, k], single.num_neighbors,
+                                rtol=1e-5)
+
+        ld = freud.density.LocalDensity([self.r_max], self.diameter)
+        ld.compute((self.box, self.pos))
+        self.assertEqual(ld.density.shape, (len(self.pos), 1))
+
+        with self.assertRaises(ValueError):
+            freud.density.LocalDensity([2, 1], self.diameter)
+        with self.assertRaises(ValueError):
+            freud.density.LocalDensity([], self.diameter)
+
     def test_repr(self):
         self.assertEqual(str(self.ld), str(eval(repr(self.ld))))
 
@@ -98,6 +98,222 @@ class TestRDF(unittest.TestCase):
                 npt.assert_allclose(rdf.n_r, np.cumsum(avg_counts),
                                     rtol=tolerance)
 
+    def test_accumulation_strategies(self):
+        r_max = 10.0
+        bins = 10
+        num_points = 1000
+        box_size = r_max*3.1
+        box, points = freud.data.make_random_system(box_size, num_points)
+
+        rdf = freud.density.RDF(bins, r_max)
+        self.assertEqual(rdf.accumulation_strategy, 'auto')
+        rdf.compute((box, points))
+        bin_counts = rdf.bin_counts
+        for strategy in ['thread_local', 'tiled', 'atomic', 'sparse']:
+            rdf.accumulation_strategy = strategy
+            self.assertEqual(rdf.accumulation_strategy, strategy)
+            rdf.compute((box, points))
+            npt.assert_equal(rdf.bin_counts, bin_counts)
+
+            # Changing the strategy resets the accumulated histogram.
+            rdf.compute((box, points), reset=False)
+            rdf.accumulation_strategy = strategy
+            rdf.compute((box, points), reset=False)
+            npt.assert_equal(rdf.bin_counts, bin_counts)
+
+        with self.assertRaises(ValueError):
+            rdf.accumulation_strategy = 'invalid'
+
+    def test_half(self):
+        r_max = 10.0
+        bins = 10
+        num_points = 1000
+        box_size = r_max*3.1
+        box, points = freud.data.make_random_system(box_size, num_points)
+
+        rdf = freud.density.RDF(bins, r_max)
+        rdf.compute((box, points))
+        bin_counts = rdf.bin_counts
+        rdf_values = rdf.rdf
+
+        # Each bond of a half list is counted for both of its points.
+        rdf.compute((box, points), neighbors=dict(r_max=r_max, half=True))
+        npt.assert_equal(rdf.bin_counts, bin_counts)
+        npt.assert_allclose(rdf.rdf, rdf_values, rtol=1e-6)
+
+        nlist = freud.locality.AABBQuery(box, points).query(
+            points, dict(r_max=r_max, exclude_ii=True,
+                         half=True)).toNeighborList()
+        rdf.compute((box, points), neighbors=nlist)
+        npt.assert_equal(rdf.bin_counts, bin_counts)
+
+        # Half queries require the query points to be the points.
+        rdf.compute((box, points), query_points=points.copy(),
+                    neighbors=dict(r_max=r_max, exclude_ii=True, half=True))
+        npt.assert_equal(rdf.bin_counts, bin_counts)
+        _, query_points = freud.data.make_random_system(
+            box_size, num_points, seed=1)
+        with self.assertRaises(ValueError):
+            rdf.compute((box, points), query_points=query_points,
+                        neighbors=dict(r_max=r_max, half=True))
+
+    def test_partial(self):
+        r_max = 3.0
+        bins = 15
+        num_points = 2000
+        n_types = 3
+        box, points = freud.data.make_random_system(10, num_points, seed=1)
+        types = np.random.RandomState(1).randint(n_types, size=num_points)
+
+        rdf = freud.density.RDF(bins, r_max, n_types=n_types)
+        self.assertEqual(rdf.n_types, n_types)
+        rdf.compute((box, points), point_types=types)
+        self.assertEqual(rdf.partial_rdf.shape, (n_types, n_types, bins))
+        self.assertEqual(rdf.partial_n_r.shape, (n_types, n_types, bins))
+
+        # The total RDF is the same as without types.
+        total = freud.density.RDF(bins, r_max).compute((box, points))
+        npt.assert_equal(rdf.bin_counts, total.bin_counts)
+        npt.assert_allclose(rdf.rdf, total.rdf, rtol=1e-6)
+
+        # Each partial RDF matches the RDF of the points of one type around
+        # the points of another.
+        for a in range(n_types):
+            for b in range(n_types):
+                partial = freud.density.RDF(bins, r_max).compute(
+                    (box, points[types == b]), points[types == a],
+                    neighbors=dict(r_max=r_max, exclude_ii=False,
+                                   r_min=1e-6))
+                npt.assert_allclose(rdf.partial_rdf[a, b], partial.rdf,
+                                    rtol=1e-4)
+        type_counts = np.bincount(types, minlength=n_types)
+        npt.assert_allclose(
+            np.einsum('a,abi->i', type_counts, rdf.partial_n_r),
+            num_points * total.n_r, rtol=1e-5)
+
+        # Half queries count each bond for both types.
+        partial_rdf = np.copy(rdf.partial_rdf)
+        rdf.compute((box, points), neighbors=dict(r_max=r_max, half=True),
+                    point_types=types)
+        npt.assert_allclose(rdf.partial_rdf, partial_rdf, rtol=1e-5)
+
+        self.assertEqual(str(rdf), str(eval(repr(rdf))))
+        with self.assertRaises(ValueError):
+            rdf.compute((box, points))
+        with self.assertRaises(ValueError):
+            rdf.compute((box, points), point_types=types + n_types)
+        with self.assertRaises(ValueError):
+            total.compute((box, points), point_types=types)
+        with self.assertRaises(AttributeError):
+            total.partial_rdf
+
+    def test_type_filtered_normalize(self):
+        """Check that normalized RDFs of type filtered queries only exclude
+        self bonds of points of the same type."""
+        r_max = 3.0
+        bins = 15
+        num_points = 100
+        box, points = freud.data.make_random_system(10, num_points, seed=2)
+        types = np.random.RandomState(2).randint(2, size=num_points)
+        aq = freud.locality.AABBQuery(box, points, point_types=types)
+
+        partial = freud.density.RDF(bins, r_max, normalize=True, n_types=2)
+        partial.compute((box, points), point_types=types)
+        for a in range(2):
+            for b in range(2):
+                rdf = freud.density.RDF(bins, r_max, normalize=True).compute(
+                    aq, neighbors=dict(r_max=r_max, exclude_ii=True,
+                                       point_type=b, query_point_type=a))
+                npt.assert_allclose(rdf.rdf, partial.partial_rdf[a, b],
+                                    rtol=1e-4)
+
+    def test_compute_trajectory(self):
+        r_max = 3.0
+        bins = 10
+        num_points = 500
+        boxes = []
+        points = []
+        rdf = freud.density.RDF(bins, r_max)
+        for frame in range(4):
+            box, frame_points = freud.data.make_random_system(
+                10 + frame, num_points, seed=frame)
+            boxes.append(box)
+            points.append(frame_points)
+            rdf.compute((box, frame_points), reset=False)
+
+        trajectory_rdf = freud.density.RDF(bins, r_max)
+        trajectory_rdf.compute_trajectory(boxes, np.array(points))
+        npt.assert_equal(trajectory_rdf.bin_counts, rdf.bin_counts)
+        npt.assert_allclose(trajectory_rdf.rdf, rdf.rdf, rtol=1e-6)
+        npt.assert_allclose(trajectory_rdf.n_r, rdf.n_r, rtol=1e-6)
+
+        # A single box is used for all frames.
+        box = boxes[0]
+        points = [freud.data.make_random_system(box.Lx, num_points, seed=s)[1]
+                  for s in range(4)]
+        trajectory_rdf.compute_trajectory(box, np.array(points))
+        rdf.compute((box, points[0]))
+        for frame_points in points[1:]:
+            rdf.compute((box, frame_points), reset=False)
+        npt.assert_equal(trajectory_rdf.bin_counts, rdf.bin_counts)
+
+        trajectory_rdf.compute_trajectory(box, np.array(points),
+                                          parallel_frames=True)
+        npt.assert_equal(trajectory_rdf.bin_counts, rdf.bin_counts)
+        npt.assert_allclose(trajectory_rdf.rdf, rdf.rdf, rtol=1e-6)
+
+        # A single box matrix is one box, not a sequence of three boxes.
+        for box_like in [box.to_matrix(), box.to_matrix().tolist(),
+                         [box.Lx, box.Ly, box.Lz, box.xy, box.xz, box.yz]]:
+            trajectory_rdf.compute_trajectory(box_like, np.array(points))
+            npt.assert_equal(trajectory_rdf.bin_counts, rdf.bin_counts)
+
+        with self.assertRaises(ValueError):
+            trajectory_rdf.compute_trajectory(boxes[:2], np.array(points))
+
+    def test_serialize(self):
+        r_max = 3.0
+        bins = 10
+        n_types = 2
+        rdf = freud.density.RDF(bins, r_max, n_types=n_types)
+        shards = [freud.density.RDF(bins, r_max, n_types=n_types)
+                  for _ in range(2)]
+        for frame in range(4):
+            box, points = freud.data.make_random_system(
+                10 + frame, 200, seed=frame)
+            types = np.arange(200) % n_types
+            rdf.compute((box, points), reset=False, point_types=types)
+            shards[frame // 2].compute((box, points), reset=False,
+                                       point_types=types)
+
+        # Shards are merged from serialized states or from computes.
+        merged = freud.density.RDF(bins, r_max, n_types=n_types)
+        merged.deserialize(shards[0].serialize()).merge(shards[1])
+        self.assertIsInstance(shards[0].serialize(), bytes)
+        npt.assert_equal(merged.bin_counts, rdf.bin_counts)
+        npt.assert_allclose(merged.rdf, rdf.rdf, rtol=1e-6)
+        npt.assert_allclose(merged.n_r, rdf.n_r, rtol=1e-6)
+        npt.assert_allclose(merged.partial_rdf, rdf.partial_rdf, rtol=1e-6)
+        self.assertEqual(merged.box, rdf.box)
+
+        merged.merge(shards[1].serialize())
+        npt.assert_equal(merged.bin_counts,
+                         rdf.bin_counts + shards[1].bin_counts)
+        merged.deserialize(rdf.serialize())
+        npt.assert_equal(merged.bin_counts, rdf.bin_counts)
+
+        # Invalid states leave the histogram unchanged.
+        state = rdf.serialize()
+        for data in (state[:-1], state + b'0', b'', state[::-1]):
+            with self.assertRaises(ValueError):
+                merged.merge(data)
+        npt.assert_equal(merged.bin_counts, rdf.bin_counts)
+        for other in (freud.density.RDF(bins + 1, r_max, n_types=n_types),
+                      freud.density.RDF(bins, r_max),
+                      freud.density.CorrelationFunction(bins, r_max)):
+            with self.assertRaises(ValueError):
+                other.deserialize(state)
+
     def test_repr(self):
         rdf = freud.density.RDF(r_max=10, bins=100, r_min=0.5)
         self.assertEqual(str(rdf), str(eval(repr(rdf))))
@@ -1,4 +1,5 @@
 import numpy as np
+import numpy.testing as npt
 import freud
 import unittest
 from SphereVoxelization_fft import compute_3d, compute_2d
@@ -92,6 +93,28 @@ class TestSphereVoxelization(unittest.TestCase):
             self.assertGreater(num_ones, 0)
             self.assertEqual(num_zeros + num_ones, np.prod(vox.voxels.shape))
 
+    def test_packed(self):
+        r_max = 2.3
+        for is2D in [True, False]:
+            # Widths that are not multiples of 8 leave partial bytes.
+            width = (37, 29) if is2D else (37, 29, 45)
+            box, points = freud.data.make_random_system(
+                10, 50, is2D=is2D, seed=0)
+            vox = freud.density.SphereVoxelization(width, r_max)
+            self.assertFalse(vox.packed)
+            vox.compute((box, points))
+            voxels = vox.voxels
+            npt.assert_equal(vox.packed_voxels,
+                             np.packbits(voxels.astype(np.uint8), axis=-1))
+
+            vox.packed = True
+            self.assertTrue(vox.packed)
+            vox.compute((box, points))
+            self.assertEqual(vox.packed_voxels.dtype, np.uint8)
+            npt.assert_equal(vox.packed_voxels,
+                             np.packbits(voxels.astype(np.uint8), axis=-1))
+            npt.assert_equal(vox.voxels, voxels)
+
     def test_change_box_dimension(self):
         width = 100
         r_max = 10.0
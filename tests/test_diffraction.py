@@ -4,6 +4,7 @@ import unittest
 import numpy as np
 import numpy.testing as npt
 import rowan
+import util
 matplotlib.use('agg')
 
 
@@ -122,6 +123,46 @@ class TestDiffractionPattern(unittest.TestCase):
                     # by (number of points)**2
                     npt.assert_allclose(dp.diffraction[center_index], 1)
 
+    @util.skipIfMissing('scipy.ndimage')
+    def test_reference(self):
+        """Compare against a histogram and FFT computed with numpy."""
+        import scipy.ndimage
+        grid_size = 64
+        peak_width = 2
+        box, positions = freud.data.make_random_system(10, 200, seed=0)
+        dp = freud.diffraction.DiffractionPattern(grid_size=grid_size)
+        dp.compute((box, positions), zoom=1, peak_width=peak_width)
+
+        xy = positions[:, :2].astype(np.float64) / box.Lx + 0.5
+        xy %= 1
+        im, _, _ = np.histogram2d(
+            xy[:, 0], xy[:, 1], bins=np.linspace(0, 1, grid_size+1))
+        diffraction_fft = scipy.ndimage.fourier_gaussian(
+            np.fft.fft2(im), peak_width)
+        diffraction_fft = np.fft.fftshift(diffraction_fft)
+        reference = np.abs(diffraction_fft)**2 / len(positions)**2
+
+        # For a cubic box without zoom, the output transposes the grid.
+        npt.assert_allclose(dp.diffraction, reference.T, rtol=1e-6,
+                            atol=1e-12)
+
+    def test_accumulate_views(self):
+        box, positions = freud.data.UnitCell.fcc().generate_system(4)
+        views = rowan.random.rand(3)
+        dp = freud.diffraction.DiffractionPattern(grid_size=128)
+        diffractions = []
+        for view_orientation in views:
+            dp.compute((box, positions), view_orientation=view_orientation)
+            diffractions.append(dp.diffraction)
+
+        for i, view_orientation in enumerate(views):
+            dp.compute((box, positions), view_orientation=view_orientation,
+                       reset=(i == 0))
+        npt.assert_allclose(dp.diffraction, np.mean(diffractions, axis=0),
+                            rtol=1e-6, atol=1e-12)
+        npt.assert_allclose(
+            dp.diffraction[dp.output_size//2, dp.output_size//2], 1)
+
     def test_repr(self):
         dp = freud.diffraction.DiffractionPattern()
         self.assertEqual(str(dp), str(eval(repr(dp))))
@@ -145,5 +186,149 @@ class TestDiffractionPattern(unittest.TestCase):
                 npt.assert_allclose(dp.k_vectors[center_index], [0, 0, 0])
 
 
+class TestStaticStructureFactor(unittest.TestCase):
+    def test_compute(self):
+        sf = freud.diffraction.StaticStructureFactor(bins=20, k_max=6)
+        box, positions = freud.data.UnitCell.fcc().generate_system(4)
+        sf.compute((box, positions))
+        self.assertEqual(sf.S_k.shape, (20,))
+        self.assertEqual(sf.k_vectors.shape[1], 3)
+        self.assertEqual(sf.S_k_vectors.shape, (len(sf.k_vectors),))
+
+    def test_attribute_access(self):
+        sf = freud.diffraction.StaticStructureFactor(
+            bins=10, k_max=5, k_min=1, max_k_points=100, seed=2)
+        self.assertEqual(sf.bins, 10)
+        npt.assert_allclose(sf.k_max, 5)
+        npt.assert_allclose(sf.k_min, 1)
+        self.assertEqual(sf.max_k_points, 100)
+        npt.assert_allclose(sf.bin_edges, np.linspace(1, 5, 11), rtol=1e-6)
+        npt.assert_allclose(sf.bin_centers, np.linspace(1.2, 4.8, 10),
+                            rtol=1e-6)
+
+        with self.assertRaises(AttributeError):
+            sf.S_k
+        with self.assertRaises(AttributeError):
+            sf.k_vectors
+        with self.assertRaises(AttributeError):
+            sf.S_k_vectors
+
+        box, positions = freud.data.make_random_system(10, 100, seed=0)
+        sf.compute((box, positions))
+        sf.S_k
+        sf.k_vectors
+        sf.S_k_vectors
+        sf.plot()
+        sf._repr_png_()
+
+    def test_reference(self):
+        """Compare against a direct evaluation with numpy."""
+        box, positions = freud.data.make_random_system(10, 200, seed=0)
+        sf = freud.diffraction.StaticStructureFactor(bins=10, k_max=4)
+        sf.compute((box, positions))
+
+        k_vectors = sf.k_vectors.astype(np.float64)
+        rho_k = np.exp(1j * k_vectors @ positions.astype(np.float64).T).sum(
+            axis=1)
+        reference = np.abs(rho_k)**2 / len(positions)
+        npt.assert_allclose(sf.S_k_vectors, reference, rtol=1e-4, atol=1e-5)
+
+        k_norms = np.linalg.norm(k_vectors, axis=1)
+        bins = np.digitize(k_norms, sf.bin_edges) - 1
+        for i in range(sf.bins):
+            if np.any(bins == i):
+                npt.assert_allclose(sf.S_k[i], reference[bins == i].mean(),
+                                    rtol=1e-4)
+            else:
+                self.assertTrue(np.isnan(sf.S_k[i]))
+
+    def test_k_vectors(self):
+        """The sampled wavevectors are half of the reciprocal lattice."""
+        L = 10
+        k_max = 3
+        box = freud.box.Box.cube(L)
+        sf = freud.diffraction.StaticStructureFactor(
+            bins=10, k_max=k_max, max_k_points=None)
+        sf.compute((box, np.zeros((1, 3))))
+        n = np.arange(-5, 6)
+        lattice = 2*np.pi/L * np.stack(
+            np.meshgrid(n, n, n), axis=-1).reshape(-1, 3)
+        norms = np.linalg.norm(lattice, axis=1)
+        self.assertEqual(len(sf.k_vectors),
+                         np.sum((norms > 0) & (norms < k_max)) // 2)
+
+        # A single point has S(k) = 1 for every wavevector.
+        npt.assert_allclose(sf.S_k_vectors, 1, rtol=1e-5)
+
+        # Subsampling is deterministic and keeps fewer wavevectors.
+        sf = freud.diffraction.StaticStructureFactor(
+            bins=10, k_max=k_max, max_k_points=5)
+        sf.compute((box, np.zeros((1, 3))))
+        k_vectors = sf.k_vectors
+        sf.compute((box, np.zeros((1, 3))))
+        npt.assert_equal(sf.k_vectors, k_vectors)
+        self.assertLess(len(k_vectors), np.sum(norms < k_max) // 2)
+
+    def test_custom_k_vectors(self):
+        box, positions = freud.data.make_random_system(10, 100, seed=0)
+        k_vectors = np.array([[1, 0, 0], [0, 2, 0], [0, 0, 3]])
+        sf = freud.diffraction.StaticStructureFactor(bins=3, k_max=4)
+        sf.compute((box, positions), k_vectors=k_vectors)
+        npt.assert_allclose(sf.k_vectors, k_vectors)
+        rho_k = np.exp(1j * k_vectors @ positions.astype(np.float64).T).sum(
+            axis=1)
+        npt.assert_allclose(sf.S_k_vectors, np.abs(rho_k)**2 / 100,
+                            rtol=1e-4, atol=1e-5)
+
+    def test_accumulate(self):
+        box = freud.box.Box.cube(10)
+        sf = freud.diffraction.StaticStructureFactor(bins=10, k_max=4)
+        frames = [freud.data.make_random_system(10, 100, seed=i)[1]
+                  for i in range(3)]
+        S_k_vectors = []
+        for positions in frames:
+            sf.compute((box, positions))
+            S_k_vectors.append(sf.S_k_vectors)
+        for i, positions in enumerate(frames):
+            sf.compute((box, positions), reset=(i == 0))
+        npt.assert_allclose(sf.S_k_vectors, np.mean(S_k_vectors, axis=0),
+                            rtol=1e-5)
+
+    def test_debye(self):
+        """An ideal gas has S(k) = 1 for the Debye formula."""
+        box, positions = freud.data.make_random_system(20, 10000, seed=0)
+        rdf = freud.density.RDF(bins=50, r_max=5)
+        rdf.compute((box, positions), reset=False)
+        sf = freud.diffraction.StaticStructureFactor(
+            bins=10, k_max=10, k_min=2)
+        sf.compute_debye(rdf, len(positions) / box.volume)
+        self.assertEqual(sf.S_k.shape, (10,))
+        npt.assert_allclose(sf.S_k, 1, atol=0.2)
+        self.assertEqual(len(sf.k_vectors), 0)
+
+        box, positions = freud.data.make_random_system(
+            20, 4000, is2D=True, seed=0)
+        rdf.compute((box, positions))
+        sf.compute_debye(rdf, len(positions) / box.volume)
+        npt.assert_allclose(sf.S_k, 1, atol=0.2)
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            freud.diffraction.StaticStructureFactor(bins=0, k_max=1)
+        with self.assertRaises(ValueError):
+            freud.diffraction.StaticStructureFactor(bins=10, k_max=1, k_min=2)
+        sf = freud.diffraction.StaticStructureFactor(bins=10, k_max=1)
+        with self.assertRaises(ValueError):
+            sf.compute((freud.box.Box.cube(10), np.zeros((1, 3))),
+                       k_vectors=np.zeros((0, 3)))
+
+    def test_repr(self):
+        sf = freud.diffraction.StaticStructureFactor(bins=10, k_max=5)
+        self.assertEqual(str(sf), str(eval(repr(sf))))
+        sf = freud.diffraction.StaticStructureFactor(
+            bins=5, k_max=4, k_min=1, max_k_points=None, seed=3)
+        self.assertEqual(str(sf), str(eval(repr(sf))))
+
+
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,197 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import threading
+import unittest
+
+
+class ThreadComm(object):
+    """Communicator of ranks running on Python threads, with the semantics of
+    the lowercase methods of mpi4py."""
+
+    def __init__(self, rank, shared):
+        self._rank = rank
+        self._shared = shared
+
+    def Get_rank(self):
+        return self._rank
+
+    def Get_size(self):
+        return len(self._shared['slots'])
+
+    def allgather(self, obj):
+        slots, barrier = self._shared['slots'], self._shared['barrier']
+        slots[self._rank] = obj
+        barrier.wait()
+        result = list(slots)
+        barrier.wait()
+        return result
+
+    def alltoall(self, objs):
+        return [objs[self._rank] for objs in self.allgather(objs)]
+
+    def allreduce(self, obj):
+        values = self.allgather(obj)
+        return sum(values[1:], values[0])
+
+    def gather(self, obj, root=0):
+        values = self.allgather(obj)
+        return values if self._rank == root else None
+
+    def scatter(self, objs, root=0):
+        return self.allgather(objs)[root][self._rank]
+
+
+def run_ranks(size, function):
+    """Run function(comm) on size ranks and return the result of each."""
+    shared = {'slots': [None] * size,
+              'barrier': threading.Barrier(size, timeout=60)}
+    results = [None] * size
+    errors = []
+
+    def run(rank):
+        try:
+            results[rank] = function(ThreadComm(rank, shared))
+        except Exception as error:
+            errors.append(error)
+            shared['barrier'].abort()
+
+    threads = [threading.Thread(target=run, args=(rank,))
+               for rank in range(size)]
+    for thread in threads:
+        thread.start()
+    for thread in threads:
+        thread.join()
+    if errors:
+        raise errors[0]
+    return results
+
+
+def distribute(comm, box, points, grid=None):
+    """Start with all points on the first rank, and distribute them along
+    with their indices."""
+    decomposition = freud.distributed.DomainDecomposition(box, comm, grid)
+    if comm.Get_rank() != 0:
+        points = points[:0]
+    local_points, ids = decomposition.distribute(
+        points, np.arange(len(points)))
+    return decomposition, local_points, ids
+
+
+class TestDistributed(unittest.TestCase):
+    def setUp(self):
+        self.box, self.points = freud.data.make_random_system(
+            10, 1000, seed=0)
+
+    def test_grid(self):
+        def grid(comm):
+            return freud.distributed.DomainDecomposition(
+                self.box, comm).grid
+        self.assertEqual(run_ranks(8, grid)[0], (2, 2, 2))
+        box2d = freud.box.Box(20, 10, is2D=True)
+        self.assertEqual(run_ranks(2, lambda comm: (
+            freud.distributed.DomainDecomposition(box2d, comm).grid))[0],
+            (2, 1, 1))
+        with self.assertRaises(ValueError):
+            run_ranks(2, lambda comm: freud.distributed.DomainDecomposition(
+                self.box, comm, grid=(3, 1, 1)))
+
+    def test_distribute(self):
+        def owned(comm):
+            decomposition, points, ids = distribute(
+                comm, self.box, self.points)
+            npt.assert_array_equal(decomposition.owner(points),
+                                   comm.Get_rank())
+            npt.assert_array_equal(points, self.points[ids])
+            return ids
+        ids = np.concatenate(run_ranks(4, owned))
+        npt.assert_array_equal(np.sort(ids), np.arange(len(self.points)))
+
+    def test_ghosts(self):
+        r_max = 2.5
+        aq = freud.locality.AABBQuery(self.box, self.points)
+        nlist = aq.query(self.points, dict(
+            r_max=r_max, exclude_ii=True)).toNeighborList()
+
+        def ghosts(comm):
+            decomposition, points, ids = distribute(
+                comm, self.box, self.points)
+            _, ghost_ids = decomposition.ghosts(points, r_max, ids)
+            self.assertEqual(len(np.intersect1d(ids, ghost_ids)), 0)
+            # Every neighbor of a point of the domain is present.
+            is_owned = np.isin(nlist.query_point_indices, ids)
+            npt.assert_array_equal(np.isin(
+                nlist.point_indices[is_owned],
+                np.concatenate([ids, ghost_ids])), True)
+        run_ranks(4, ghosts)
+
+    def test_rdf(self):
+        r_max = 3
+        rdf = freud.density.RDF(50, r_max).compute((self.box, self.points))
+
+        def compute(comm):
+            decomposition, points, _ = distribute(comm, self.box, self.points)
+            return freud.distributed.RDF(decomposition, 50, r_max).compute(
+                points)
+
+        for size in [1, 3, 4]:
+            for result in run_ranks(size, compute):
+                npt.assert_array_equal(result.bin_counts, rdf.bin_counts)
+                npt.assert_allclose(result.rdf, rdf.rdf, rtol=1e-4)
+                npt.assert_allclose(result.n_r, rdf.n_r, rtol=1e-4)
+
+    def test_gaussian_density(self):
+        gd = freud.density.GaussianDensity(20, 2, 1).compute(
+            (self.box, self.points))
+
+        def compute(comm):
+            decomposition, points, _ = distribute(comm, self.box, self.points)
+            return freud.distributed.GaussianDensity(
+                decomposition, 20, 2, 1).compute(points).density
+
+        for density in run_ranks(4, compute):
+            npt.assert_allclose(density, gd.density, rtol=1e-4, atol=1e-6)
+
+    def test_steinhardt(self):
+        neighbors = dict(r_max=1.5, exclude_ii=True)
+        for average in [False, True]:
+            ql = freud.order.Steinhardt(6, average=average).compute(
+                (self.box, self.points), neighbors=neighbors)
+
+            def compute(comm):
+                decomposition, points, ids = distribute(
+                    comm, self.box, self.points)
+                result = freud.distributed.Steinhardt(
+                    decomposition, 6, average=average).compute(
+                        points, neighbors=neighbors)
+                return ids, result.particle_order
+
+            for ids, particle_order in run_ranks(4, compute):
+                npt.assert_allclose(particle_order, ql.particle_order[ids],
+                                    rtol=1e-4, atol=1e-6)
+
+    def test_cluster(self):
+        neighbors = dict(r_max=0.8)
+        cl = freud.cluster.Cluster().compute(
+            (self.box, self.points), neighbors=neighbors)
+
+        def compute(comm):
+            decomposition, points, ids = distribute(
+                comm, self.box, self.points)
+            result = freud.distributed.Cluster(decomposition).compute(
+                points, neighbors=neighbors)
+            return ids, result.cluster_idx, result.num_clusters
+
+        results = run_ranks(4, compute)
+        cluster_idx = np.zeros(len(self.points), dtype=np.int64)
+        for ids, local_idx, num_clusters in results:
+            self.assertEqual(num_clusters, cl.num_clusters)
+            cluster_idx[ids] = local_idx
+        # Both clusterings are the same partition of the points.
+        self.assertEqual(len(np.unique(cluster_idx)), cl.num_clusters)
+        pairs = np.unique(np.stack([cluster_idx, cl.cluster_idx]), axis=1)
+        self.assertEqual(pairs.shape[1], cl.num_clusters)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -94,6 +94,20 @@ class TestBondOrder(unittest.TestCase):
             bo.compute(nq, random_quats, neighbors=neighbors)
             self.assertGreater(np.sum(bo.bond_order > 0), 30)
 
+    def test_serialize(self):
+        box, positions = freud.data.UnitCell.fcc().generate_system(4)
+        quats = np.array([[1, 0, 0, 0]] * len(positions))
+        bo = freud.environment.BondOrder(6)
+        bo.compute((box, positions), quats,
+                   neighbors={'num_neighbors': 12, 'r_max': 1.5})
+
+        merged = freud.environment.BondOrder(6).merge(bo).merge(bo)
+        np.testing.assert_equal(merged.bin_counts, 2 * bo.bin_counts)
+        np.testing.assert_allclose(merged.bond_order, bo.bond_order,
+                                   rtol=1e-6)
+        with self.assertRaises(ValueError):
+            freud.environment.BondOrder(5).merge(bo)
+
     def test_repr(self):
         bo = freud.environment.BondOrder((6, 6))
         self.assertEqual(str(bo), str(eval(repr(bo))))
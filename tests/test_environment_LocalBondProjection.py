@@ -148,9 +148,40 @@ class TestLocalBondProjection(unittest.TestCase):
         npt.assert_allclose(ang.projections[2], 1.5, atol=1e-6)
         npt.assert_allclose(ang.normed_projections[2], 1, atol=1e-6)
 
+    def test_outputs(self):
+        boxlen = 10
+        N = 100
+        query_args = dict(num_neighbors=8, r_guess=3)
+
+        box, points = freud.data.make_random_system(boxlen, N)
+        ors = rowan.random.rand(N)
+        equiv_quats = np.asarray([[1, 0, 0, 0], [0, 0, 0, 1]])
+        proj_vecs = np.asarray([[0, 0, 1], [1, 0, 0], [0, 1, 1]])
+
+        ang = freud.environment.LocalBondProjection()
+        self.assertEqual(ang.outputs, 'projections')
+        ang.compute((box, points), ors, proj_vecs,
+                    equiv_orientations=equiv_quats, neighbors=query_args)
+
+        normed = freud.environment.LocalBondProjection(
+            outputs='normed_projections')
+        self.assertEqual(normed.outputs, 'normed_projections')
+        normed.compute((box, points), ors, proj_vecs,
+                       equiv_orientations=equiv_quats, neighbors=query_args)
+        npt.assert_array_equal(
+            normed.normed_projections, ang.normed_projections)
+        with self.assertRaises(AttributeError):
+            normed.projections
+
+        with self.assertRaises(ValueError):
+            freud.environment.LocalBondProjection(outputs='vectors')
+
     def test_repr(self):
         ang = freud.environment.LocalBondProjection()
         self.assertEqual(str(ang), str(eval(repr(ang))))
+        ang = freud.environment.LocalBondProjection(
+            outputs='normed_projections')
+        self.assertEqual(str(ang), str(eval(repr(ang))))
 
 
 if __name__ == '__main__':
@@ -159,6 +159,9 @@ class TestLocalDescriptors(unittest.TestCase):
         with self.assertRaises(ValueError):
             freud.environment.LocalDescriptors(
                 l_max, True, mode='particle_local_wrong')
+        with self.assertRaises(ValueError):
+            freud.environment.LocalDescriptors(
+                l_max, True, reduction='sum')
 
     def test_nlist(self):
         """Check that the internally generated NeighborList is correct."""
@@ -199,6 +202,110 @@ class TestLocalDescriptors(unittest.TestCase):
     def test_repr(self):
         comp = freud.environment.LocalDescriptors(8, True)
         self.assertEqual(str(comp), str(eval(repr(comp))))
+        comp = freud.environment.LocalDescriptors(
+            8, False, reduction='power_spectrum', half_precision=True,
+            memory_budget=2**20)
+        self.assertEqual(str(comp), str(eval(repr(comp))))
+
+    def test_reductions(self):
+        """Check that reductions match reducing the bond harmonics."""
+        N = 500
+        num_neighbors = 6
+        l_max = 8
+        L = 10
+
+        box, positions = freud.data.make_random_system(L, N, seed=0)
+        aq = freud.locality.AABBQuery(box, positions)
+        nl = aq.query(positions, dict(exclude_ii=True,
+                                      num_neighbors=num_neighbors)
+                      ).toNeighborList()
+
+        bonds = freud.environment.LocalDescriptors(l_max, mode='global')
+        bonds.compute((box, positions), neighbors=nl)
+        average = np.zeros((N, bonds.sph.shape[1]), dtype=np.complex128)
+        np.add.at(average, nl.query_point_indices, bonds.sph)
+        average /= num_neighbors
+
+        ld = freud.environment.LocalDescriptors(
+            l_max, mode='global', reduction='average')
+        ld.compute((box, positions), neighbors=nl)
+        self.assertEqual(ld.reduction, 'average')
+        npt.assert_allclose(ld.sph, average, atol=1e-6)
+
+        ql = get_ql(positions, bonds, nl)
+        for negative_m in [True, False]:
+            ld = freud.environment.LocalDescriptors(
+                l_max, negative_m, mode='global', reduction='power_spectrum')
+            ld.compute((box, positions), neighbors=nl)
+            self.assertEqual(ld.sph.shape, (N, l_max + 1))
+            self.assertEqual(ld.sph.dtype, np.float32)
+            l = np.arange(l_max + 1)
+            npt.assert_allclose(
+                np.sqrt(4*np.pi/(2*l + 1) * ld.sph), ql, atol=1e-5)
+
+    def test_half_precision(self):
+        """Check that half precision output rounds the full output."""
+        N = 500
+        num_neighbors = 6
+        l_max = 8
+        L = 10
+
+        box, positions = freud.data.make_random_system(L, N, seed=0)
+        qargs = dict(exclude_ii=True, num_neighbors=num_neighbors)
+
+        for reduction in ['none', 'average', 'power_spectrum']:
+            full = freud.environment.LocalDescriptors(
+                l_max, reduction=reduction)
+            full.compute((box, positions), neighbors=qargs)
+            half = freud.environment.LocalDescriptors(
+                l_max, reduction=reduction, half_precision=True)
+            half.compute((box, positions), neighbors=qargs)
+            self.assertTrue(half.half_precision)
+            self.assertEqual(half.sph.dtype, np.float16)
+
+            if reduction == 'power_spectrum':
+                expected = full.sph.astype(np.float16)
+            else:
+                expected = np.stack(
+                    [full.sph.real, full.sph.imag], axis=-1).astype(
+                        np.float16)
+            npt.assert_array_equal(half.sph, expected)
+
+    def test_memory_budget(self):
+        """Check that reductions of chunked bonds match those of the full
+        NeighborList."""
+        N = 2000
+        l_max = 8
+        L = 10
+
+        box, positions = freud.data.make_random_system(L, N, seed=0)
+        for qargs in (dict(exclude_ii=True, num_neighbors=6),
+                      dict(exclude_ii=True, r_max=1.5)):
+            nbytes = freud.locality.AABBQuery(box, positions).query(
+                positions, qargs).estimated_nbytes
+            for mode in ['global', 'neighborhood']:
+                for reduction in ['average', 'power_spectrum']:
+                    full = freud.environment.LocalDescriptors(
+                        l_max, mode=mode, reduction=reduction)
+                    full.compute((box, positions), neighbors=qargs)
+                    chunked = freud.environment.LocalDescriptors(
+                        l_max, mode=mode, reduction=reduction,
+                        memory_budget=nbytes // 10)
+                    self.assertEqual(chunked.memory_budget, nbytes // 10)
+                    chunked.compute((box, positions), neighbors=qargs)
+                    npt.assert_allclose(chunked.sph, full.sph, atol=1e-6)
+                    self.assertEqual(chunked.num_sphs, full.num_sphs)
+                    self.assertEqual(len(chunked.nlist), 0)
+
+        # The harmonics of each bond are never chunked.
+        full = freud.environment.LocalDescriptors(l_max)
+        full.compute((box, positions), neighbors=qargs)
+        chunked = freud.environment.LocalDescriptors(l_max, memory_budget=1)
+        chunked.compute((box, positions), neighbors=qargs)
+        npt.assert_array_equal(chunked.sph, full.sph)
+
+        with self.assertRaises(ValueError):
+            freud.environment.LocalDescriptors(l_max, memory_budget=-1)
 
     def test_ql(self):
         """Check if we can reproduce Steinhardt ql."""
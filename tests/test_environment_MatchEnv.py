@@ -342,6 +342,33 @@ class TestCluster(unittest.TestCase):
             e0, refPoints2[np.asarray(list(isSim_vec_map.values()))],
             atol=1e-5)
 
+    def test_global_search(self):
+        # Clusters found by comparing neighboring points are subsets of the
+        # clusters found by comparing all points
+        box, points = freud.data.UnitCell.fcc().generate_system(
+            4, sigma_noise=0.02, seed=0)
+        query_args = dict(num_neighbors=12)
+        threshold = 0.2
+
+        local = freud.environment.EnvironmentCluster()
+        local.compute((box, points), threshold, neighbors=query_args)
+        match = freud.environment.EnvironmentCluster()
+        match.compute((box, points), threshold, global_search=True,
+                      neighbors=query_args)
+        self.assertLessEqual(match.num_clusters, local.num_clusters)
+        for cluster in range(local.num_clusters):
+            members = match.cluster_idx[local.cluster_idx == cluster]
+            npt.assert_equal(members, members[0])
+
+        # Aligned environments of each cluster match its first environment
+        for cluster in range(match.num_clusters):
+            members = np.flatnonzero(match.cluster_idx == cluster)
+            for i in members[1:]:
+                npt.assert_array_less(np.linalg.norm(
+                    match.point_environments[i] -
+                    match.point_environments[members[0]], axis=-1),
+                    2*threshold)
+
     def test_repr(self):
         match = freud.environment.EnvironmentCluster()
         self.assertEqual(str(match), str(eval(repr(match))))
@@ -393,6 +420,30 @@ class TestEnvironmentMotifMatch(unittest.TestCase):
             self.assertFalse(matches[i])
         self.assertTrue(matches[len(motif)])
 
+    def test_registration_reproducible(self):
+        """Test that registered matches do not change between computes."""
+        motif = [[1, 0, 0], [0, 1, 0], [-1, 0, 0], [0, -1, 0]]
+        points = motif + [[0, 0, 0]]
+
+        r_max = 1.5
+        num_neighbors = 4
+
+        box = freud.box.Box.square(3)
+        match = freud.environment.EnvironmentMotifMatch()
+        query_args = dict(r_guess=r_max, num_neighbors=num_neighbors)
+        match.compute((box, points), motif, 0.1, neighbors=query_args,
+                      registration=True)
+        matches = np.copy(match.matches)
+        point_environments = np.copy(match.point_environments)
+        self.assertTrue(matches[len(motif)])
+
+        for _ in range(3):
+            match.compute((box, points), motif, 0.1, neighbors=query_args,
+                          registration=True)
+            npt.assert_array_equal(match.matches, matches)
+            npt.assert_array_equal(
+                match.point_environments, point_environments)
+
 
 class TestEnvironmentRMSDMinimizer(unittest.TestCase):
     def test_api(self):
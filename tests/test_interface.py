@@ -78,6 +78,27 @@ class TestInterface(unittest.TestCase):
         self.assertEqual(test_twelve.point_count, 12)
         self.assertEqual(len(test_twelve.point_ids), 12)
 
+    def test_unique_bond_indices(self):
+        """Test that the ids are the unique indices of the bonds."""
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        _, query_points = freud.data.make_random_system(10, 300, seed=1)
+        points[:, 0] = points[:, 0] / 2 - 2.5
+        query_points[:, 0] = query_points[:, 0] / 2 + 2.5
+        aq = freud.locality.AABBQuery(box, points)
+        inter = freud.interface.Interface()
+        for query_args in [dict(r_max=1.2), dict(r_max=1.2, r_min=0.5),
+                           dict(num_neighbors=2, r_max=2)]:
+            nlist = aq.query(query_points, query_args).toNeighborList()
+            for neighbors in [query_args, nlist]:
+                inter.compute(aq, query_points, neighbors=neighbors)
+                np.testing.assert_array_equal(
+                    inter.point_ids, np.unique(nlist.point_indices))
+                np.testing.assert_array_equal(
+                    inter.query_point_ids,
+                    np.unique(nlist.query_point_indices))
+                self.assertEqual(inter.point_count,
+                                 len(np.unique(nlist.point_indices)))
+
     def test_repr(self):
         inter = freud.interface.Interface()
         self.assertEqual(str(inter), str(eval(repr(inter))))
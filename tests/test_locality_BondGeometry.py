@@ -0,0 +1,134 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import rowan
+import unittest
+
+
+class TestBondGeometry(unittest.TestCase):
+    def setUp(self):
+        self.box, self.points = freud.data.make_random_system(
+            10, 1000, seed=0)
+        self.aq = freud.locality.AABBQuery(self.box, self.points)
+        self.nlist = self.aq.query(
+            self.points, dict(r_max=1.5, exclude_ii=True)).toNeighborList()
+        self.geometry = freud.locality.BondGeometry(
+            self.aq, self.nlist, l_max=8)
+
+    def test_properties(self):
+        geometry = self.geometry
+        self.assertEqual(len(geometry), len(self.nlist))
+        self.assertEqual(geometry.l_max, 8)
+        npt.assert_array_equal(geometry.nlist.point_indices,
+                               self.nlist.point_indices)
+        npt.assert_array_equal(geometry.vectors, self.nlist.vectors)
+        npt.assert_allclose(
+            geometry.unit_vectors,
+            self.nlist.vectors / self.nlist.distances[:, np.newaxis],
+            atol=1e-6)
+
+        theta = np.arctan2(self.nlist.vectors[:, 1],
+                           self.nlist.vectors[:, 0]) % (2 * np.pi)
+        phi = np.arccos(geometry.unit_vectors[:, 2])
+        npt.assert_allclose(geometry.theta, theta, atol=1e-5)
+        npt.assert_allclose(geometry.phi, phi, atol=1e-5)
+
+        harmonics = geometry.harmonics
+        self.assertEqual(harmonics.shape, (len(self.nlist), 81))
+        npt.assert_allclose(harmonics[:, 0], np.sqrt(1 / (4 * np.pi)),
+                            rtol=1e-6)
+        # Y_1^0 is proportional to the z component of the bond.
+        npt.assert_allclose(
+            harmonics[:, 1].real,
+            np.sqrt(3 / (4 * np.pi)) * geometry.unit_vectors[:, 2],
+            atol=1e-5)
+
+    def test_query_args(self):
+        geometry = freud.locality.BondGeometry(
+            (self.box, self.points), dict(r_max=1.5))
+        npt.assert_array_equal(geometry.nlist.query_point_indices,
+                               self.nlist.query_point_indices)
+        npt.assert_array_equal(geometry.nlist.point_indices,
+                               self.nlist.point_indices)
+
+    def test_steinhardt(self):
+        for average in (False, True):
+            for wl in (False, True):
+                ql = freud.order.Steinhardt(
+                    [4, 6, 8], average=average, wl=wl).compute(
+                        self.aq, self.nlist)
+                cached = freud.order.Steinhardt(
+                    [4, 6, 8], average=average, wl=wl).compute(
+                        self.aq, self.geometry)
+                npt.assert_array_equal(cached.particle_order,
+                                       ql.particle_order)
+
+    def test_solid_liquid(self):
+        solid_liquid = freud.order.SolidLiquid(6, 0.7, 6)
+        solid_liquid.compute(self.aq, self.nlist)
+        cluster_idx = solid_liquid.cluster_idx.copy()
+        num_connections = solid_liquid.num_connections.copy()
+        solid_liquid.compute(self.aq, self.geometry)
+        npt.assert_array_equal(solid_liquid.cluster_idx, cluster_idx)
+        npt.assert_array_equal(solid_liquid.num_connections, num_connections)
+
+    def test_local_descriptors(self):
+        for negative_m in (False, True):
+            ld = freud.environment.LocalDescriptors(
+                8, negative_m=negative_m, mode='global').compute(
+                    self.aq, neighbors=self.nlist)
+            cached = freud.environment.LocalDescriptors(
+                8, negative_m=negative_m, mode='global').compute(
+                    self.aq, neighbors=self.geometry)
+            npt.assert_allclose(cached.sph, ld.sph, atol=1e-5)
+
+        # Modes that rotate the bonds use the bond vectors.
+        orientations = rowan.random.rand(len(self.points))
+        ld = freud.environment.LocalDescriptors(
+            8, mode='particle_local', reduction='power_spectrum').compute(
+                self.aq, orientations=orientations, neighbors=self.nlist)
+        cached = freud.environment.LocalDescriptors(
+            8, mode='particle_local', reduction='power_spectrum').compute(
+                self.aq, orientations=orientations, neighbors=self.geometry)
+        npt.assert_array_equal(cached.power_spectrum, ld.power_spectrum)
+
+    def test_bond_order(self):
+        bod = freud.environment.BondOrder((12, 6)).compute(
+            self.aq, neighbors=self.nlist)
+        cached = freud.environment.BondOrder((12, 6)).compute(
+            self.aq, neighbors=self.geometry)
+        npt.assert_array_equal(cached.bin_counts, bod.bin_counts)
+
+    def test_harmonics_computed_once(self):
+        with freud.profiling.Profiler() as profiler:
+            freud.order.Steinhardt(6).compute(self.aq, self.geometry)
+            freud.order.SolidLiquid(6, 0.7, 6).compute(
+                self.aq, self.geometry)
+            freud.environment.LocalDescriptors(8, mode='global').compute(
+                self.aq, neighbors=self.geometry)
+        if not freud.profiling.is_compiled():
+            return
+        calls, seconds = profiler.timers['BondGeometry::computeHarmonics']
+        self.assertEqual(calls, 1)
+
+    def test_errors(self):
+        # The harmonics of l = 10 are not stored.
+        with self.assertRaises(ValueError):
+            freud.order.Steinhardt(10).compute(self.aq, self.geometry)
+        with self.assertRaises(ValueError):
+            freud.environment.LocalDescriptors(10, mode='global').compute(
+                self.aq, neighbors=self.geometry)
+        # The points do not match the bonds.
+        with self.assertRaises(ValueError):
+            freud.locality.BondGeometry(
+                (self.box, self.points[:10]), self.nlist)
+
+    def test_repr(self):
+        self.assertEqual(
+            repr(self.geometry),
+            "freud.locality.BondGeometry(num_bonds={}, l_max=8)".format(
+                len(self.nlist)))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,116 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import unittest
+
+
+class TestCompressedNeighborList(unittest.TestCase):
+    def setUp(self):
+        self.box, self.points = freud.data.make_random_system(
+            10, 1000, seed=0)
+        self.aq = freud.locality.AABBQuery(self.box, self.points)
+        self.nlist = self.aq.query(
+            self.points, dict(r_max=2, exclude_ii=True)).toNeighborList()
+
+    def assert_bonds_equal(self, nlist, decompressed, rtol=0):
+        npt.assert_array_equal(decompressed.query_point_indices,
+                               nlist.query_point_indices)
+        npt.assert_array_equal(decompressed.point_indices,
+                               nlist.point_indices)
+        npt.assert_array_equal(decompressed.weights, nlist.weights)
+        npt.assert_allclose(decompressed.distances, nlist.distances,
+                            rtol=rtol, atol=rtol)
+        npt.assert_array_equal(decompressed.segments, nlist.segments)
+        npt.assert_array_equal(decompressed.neighbor_counts,
+                               nlist.neighbor_counts)
+
+    def test_round_trip(self):
+        full_size = 16 * len(self.nlist)
+        sizes = {}
+        for distances, rtol in (('full', 0), ('quantized', 1e-4),
+                                ('none', 1e-5)):
+            compressed = freud.locality.CompressedNeighborList(
+                self.nlist, distances=distances)
+            self.assertEqual(len(compressed), len(self.nlist))
+            self.assertEqual(compressed.num_query_points, 1000)
+            self.assertEqual(compressed.num_points, 1000)
+            self.assertEqual(compressed.distances, distances)
+            self.assertFalse(compressed.half)
+            sizes[distances] = compressed.nbytes
+            self.assert_bonds_equal(
+                self.nlist, compressed.to_neighbor_list(self.aq), rtol)
+            if distances != 'none':
+                self.assert_bonds_equal(
+                    self.nlist, compressed.to_neighbor_list(), rtol)
+            else:
+                with self.assertRaises(ValueError):
+                    compressed.to_neighbor_list()
+        self.assertLess(sizes['full'], full_size / 2)
+        self.assertLess(sizes['quantized'], sizes['full'])
+        self.assertLess(sizes['none'], full_size / 4)
+
+        # The bond vectors are computed from the points.
+        decompressed = freud.locality.CompressedNeighborList(
+            self.nlist).to_neighbor_list((self.box, self.points))
+        npt.assert_allclose(decompressed.vectors, self.nlist.vectors,
+                            atol=1e-5)
+
+    def test_weights_and_order(self):
+        """Weights that are not all equal and lists sorted by distance are
+        kept."""
+        nlist = self.aq.query(self.points, dict(num_neighbors=8)) \
+            .toNeighborList(sort_by_distance=True)
+        weights = np.random.RandomState(0).uniform(size=len(nlist))
+        nlist = freud.locality.NeighborList.from_arrays(
+            1000, 1000, nlist.query_point_indices, nlist.point_indices,
+            nlist.distances, weights)
+        compressed = freud.locality.CompressedNeighborList(nlist)
+        self.assert_bonds_equal(nlist, compressed.to_neighbor_list())
+
+    def test_half(self):
+        half = self.aq.query(
+            self.points, dict(r_max=2, exclude_ii=True, half=True)) \
+            .toNeighborList()
+        compressed = freud.locality.CompressedNeighborList(half)
+        self.assertTrue(compressed.half)
+        self.assertTrue(compressed.to_neighbor_list().half)
+
+    def test_empty(self):
+        nlist = self.aq.query(
+            self.points, dict(r_max=0.001, exclude_ii=True)).toNeighborList()
+        compressed = freud.locality.CompressedNeighborList(nlist)
+        self.assertEqual(len(compressed), 0)
+        self.assertEqual(len(compressed.to_neighbor_list()), 0)
+
+    def test_compute(self):
+        """Computes accept compressed lists as neighbors."""
+        rdf = freud.density.RDF(20, 2).compute(self.aq, neighbors=self.nlist)
+        compressed = freud.locality.CompressedNeighborList(
+            self.nlist, distances='none')
+        compressed_rdf = freud.density.RDF(20, 2).compute(
+            self.aq, neighbors=compressed)
+        npt.assert_allclose(compressed_rdf.bin_counts, rdf.bin_counts,
+                            atol=2)
+
+        with self.assertRaises(ValueError):
+            freud.density.RDF(20, 2).compute(
+                (self.box, self.points[:10]), neighbors=compressed)
+
+    def test_errors(self):
+        with self.assertRaises(ValueError):
+            freud.locality.CompressedNeighborList(self.nlist, distances='half')
+        compressed = freud.locality.CompressedNeighborList(self.nlist)
+        with self.assertRaises(ValueError):
+            compressed.to_neighbor_list(self.aq, self.points[:10])
+
+    def test_repr(self):
+        compressed = freud.locality.CompressedNeighborList(
+            self.nlist, distances='quantized')
+        self.assertEqual(
+            repr(compressed),
+            "freud.locality.CompressedNeighborList(num_bonds={}, "
+            "distances='quantized')".format(len(self.nlist)))
+
+
+if __name__ == '__main__':
+    unittest.main()
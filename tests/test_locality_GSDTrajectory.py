@@ -0,0 +1,140 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import os
+import struct
+import tempfile
+import unittest
+
+
+def write_gsd(filename, boxes, points, dimensions=3):
+    """Write a GSD file of the HOOMD schema with the given frames.
+
+    Each frame has a configuration/box chunk unless its box is None, and a
+    particles/position chunk unless its points are None."""
+    names = ['configuration/dimensions', 'configuration/box',
+             'particles/position']
+    index = []
+    data = bytearray()
+    header_size = 256
+
+    def add_chunk(frame, name, type_id, array):
+        array = np.ascontiguousarray(array)
+        index.append(struct.pack(
+            '<QQqIHBB', frame, array.shape[0], header_size + len(data),
+            array.shape[1], names.index(name), type_id, 0))
+        data.extend(array.tobytes())
+
+    # The dimensions chunk misaligns the chunks after it.
+    add_chunk(0, 'configuration/dimensions', 1,
+              np.array([[dimensions]], dtype=np.uint8))
+    for frame, (box, frame_points) in enumerate(zip(boxes, points)):
+        if box is not None:
+            box = freud.box.Box.from_box(box)
+            add_chunk(frame, 'configuration/box', 9, np.array(
+                [[box.Lx], [box.Ly], [box.Lz], [box.xy], [box.xz],
+                 [box.yz]], dtype=np.float32))
+        if frame_points is not None:
+            add_chunk(frame, 'particles/position', 9,
+                      np.asarray(frame_points, dtype=np.float32))
+
+    index_location = header_size + len(data)
+    index = b''.join(index) + bytes(32)
+    namelist_location = index_location + len(index)
+    namelist = b''.join(name.encode() + b'\0' for name in names) + bytes(8)
+    header = struct.pack(
+        '<QQQQQII64s64s80s', 0x65DF65DF65DF65DF, index_location,
+        len(index) // 32, namelist_location, len(namelist), (1 << 16) | 4,
+        2 << 16, b'freud', b'hoomd', b'')
+    with open(filename, 'wb') as f:
+        f.write(header + bytes(data) + index + namelist)
+
+
+class TestGSDTrajectory(unittest.TestCase):
+    def setUp(self):
+        self.directory = tempfile.TemporaryDirectory()
+        self.filename = os.path.join(self.directory.name, 'trajectory.gsd')
+        self.boxes = []
+        self.points = []
+        for frame in range(4):
+            box, points = freud.data.make_random_system(
+                10 + frame, 200, seed=frame)
+            self.boxes.append(box)
+            self.points.append(points)
+        write_gsd(self.filename, self.boxes, self.points)
+
+    def tearDown(self):
+        self.directory.cleanup()
+
+    def test_frames(self):
+        traj = freud.locality.GSDTrajectory(self.filename)
+        self.assertEqual(len(traj), 4)
+        self.assertEqual(traj.n_points, 200)
+        for frame, (box, points) in enumerate(traj):
+            self.assertEqual(box, self.boxes[frame])
+            npt.assert_array_equal(points, self.points[frame])
+            self.assertFalse(points.flags.writeable)
+        box, points = traj[-1]
+        self.assertEqual(box, self.boxes[-1])
+        with self.assertRaises(IndexError):
+            traj[4]
+
+        # The points remain valid after the trajectory is deleted.
+        del traj
+        npt.assert_array_equal(points, self.points[-1])
+
+    def test_missing_chunks(self):
+        """Frames without a chunk use the chunk of the first frame."""
+        write_gsd(self.filename, [self.boxes[0], self.boxes[1], None],
+                  [self.points[0], None, self.points[2]])
+        traj = freud.locality.GSDTrajectory(self.filename)
+        self.assertEqual(len(traj), 3)
+        self.assertEqual(traj[1][0], self.boxes[1])
+        npt.assert_array_equal(traj[1][1], self.points[0])
+        self.assertEqual(traj[2][0], self.boxes[0])
+        npt.assert_array_equal(traj[2][1], self.points[2])
+
+    def test_2d(self):
+        box, points = freud.data.make_random_system(10, 100, is2D=True)
+        write_gsd(self.filename, [box], [points], dimensions=2)
+        traj = freud.locality.GSDTrajectory(self.filename)
+        self.assertTrue(traj[0][0].is2D)
+        self.assertEqual(traj[0][0], box)
+
+    def test_errors(self):
+        write_gsd(self.filename, self.boxes,
+                  [self.points[0], self.points[1][:10]])
+        with self.assertRaises(ValueError):
+            freud.locality.GSDTrajectory(self.filename)
+        with open(self.filename, 'wb') as f:
+            f.write(bytes(1024))
+        with self.assertRaises(ValueError):
+            freud.locality.GSDTrajectory(self.filename)
+        with self.assertRaises(IOError):
+            freud.locality.GSDTrajectory(
+                os.path.join(self.directory.name, 'missing.gsd'))
+
+    def test_compute_trajectory(self):
+        traj = freud.locality.GSDTrajectory(self.filename)
+        rdf = freud.density.RDF(10, 3).compute_trajectory(
+            self.boxes, np.array(self.points))
+        gsd_rdf = freud.density.RDF(10, 3).compute_trajectory(None, traj)
+        npt.assert_equal(gsd_rdf.bin_counts, rdf.bin_counts)
+        npt.assert_allclose(gsd_rdf.rdf, rdf.rdf, rtol=1e-6)
+
+        ql = freud.order.Steinhardt(6).compute_trajectory(
+            self.boxes, np.array(self.points), neighbors=dict(num_neighbors=6))
+        gsd_ql = freud.order.Steinhardt(6).compute_trajectory(
+            None, traj, neighbors=dict(num_neighbors=6))
+        npt.assert_allclose(gsd_ql.trajectory_particle_order,
+                            ql.trajectory_particle_order, rtol=1e-6)
+
+    def test_repr(self):
+        traj = freud.locality.GSDTrajectory(self.filename)
+        self.assertEqual(
+            repr(traj),
+            "freud.locality.GSDTrajectory('{}')".format(self.filename))
+
+
+if __name__ == '__main__':
+    unittest.main()
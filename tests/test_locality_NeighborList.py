@@ -114,12 +114,80 @@ class TestNeighborList(unittest.TestCase):
         for (idx, i) in enumerate(nlist.query_point_indices):
             self.assertLessEqual(nlist.find_first_index(i), idx)
 
+    def test_find_first_index_empty_points(self):
+        # Query points without bonds start where their bonds would be.
+        query_point_indices = np.array([0, 0, 2, 2, 2, 5])
+        point_indices = np.array([1, 2, 0, 1, 3, 0])
+        distances = np.ones(len(query_point_indices))
+        nlist = freud.locality.NeighborList.from_arrays(
+            7, 4, query_point_indices, point_indices, distances)
+        expected = [0, 2, 2, 5, 5, 5, 6]
+        for i, first in enumerate(expected):
+            self.assertEqual(nlist.find_first_index(i), first)
+        npt.assert_equal(nlist.segments, expected)
+        npt.assert_equal(nlist.neighbor_counts, [2, 0, 3, 0, 0, 1, 0])
+
+    def test_filter_keeps_exported_arrays(self):
+        # Arrays obtained before filtering keep the unfiltered bonds.
+        point_indices = self.nlist.point_indices
+        distances = self.nlist.distances
+        expected_point_indices = np.copy(point_indices)
+        expected_distances = np.copy(distances)
+        self.nlist.filter(self.nlist.distances < np.median(distances))
+        npt.assert_equal(point_indices, expected_point_indices)
+        npt.assert_equal(distances, expected_distances)
+        npt.assert_equal(
+            self.nlist.point_indices,
+            expected_point_indices[
+                expected_distances < np.median(expected_distances)])
+
+    def test_bond_array_after_modification(self):
+        # The bond array is regenerated once the bonds change.
+        nlist = self.nlist.copy()
+        npt.assert_equal(nlist[:, 1], nlist.point_indices)
+        nlist.filter(nlist.distances < np.median(nlist.distances))
+        npt.assert_equal(nlist[:, 0], nlist.query_point_indices)
+        npt.assert_equal(nlist[:, 1], nlist.point_indices)
+
+        nlist.copy(self.nlist)
+        npt.assert_equal(nlist[:], self.nlist[:])
+
     def test_segments(self):
         ones = np.ones(len(self.nlist), dtype=np.float32)
         self.assertTrue(
             np.allclose(np.add.reduceat(ones, self.nlist.segments), 6))
         self.assertTrue(np.allclose(self.nlist.neighbor_counts, 6))
 
+    def test_index_arrays(self):
+        # The per-bond index arrays match the columns of the bond array
+        npt.assert_equal(self.nlist.query_point_indices, self.nlist[:, 0])
+        npt.assert_equal(self.nlist.point_indices, self.nlist[:, 1])
+        self.assertTrue(self.nlist.query_point_indices.flags.c_contiguous)
+        self.assertTrue(self.nlist.point_indices.flags.c_contiguous)
+        self.assertEqual(self.nlist.segments.dtype, np.uint64)
+
+    def test_vectors(self):
+        # Queries store the wrapped vector from query point to point
+        points = self.nq.points
+        box = self.nq.box
+        expected = box.wrap(points[self.nlist.point_indices] -
+                            points[self.nlist.query_point_indices])
+        npt.assert_allclose(self.nlist.vectors, expected, atol=1e-5)
+        npt.assert_allclose(np.linalg.norm(self.nlist.vectors, axis=-1),
+                            self.nlist.distances, rtol=1e-5)
+
+        # Vectors are kept through filtering and copying
+        self.nlist.filter_r(2.5)
+        npt.assert_allclose(
+            np.linalg.norm(self.nlist.vectors, axis=-1),
+            self.nlist.distances, rtol=1e-5)
+        npt.assert_equal(self.nlist.copy().vectors, self.nlist.vectors)
+
+        # NeighborLists built from arrays do not store vectors
+        nlist = freud.locality.NeighborList.from_arrays(
+            4, 4, [0, 1], [1, 0], [1, 1])
+        self.assertIsNone(nlist.vectors)
+
     def test_from_arrays(self):
         query_point_indices = [0, 0, 1, 2, 3]
         point_indices = [1, 2, 3, 0, 0]
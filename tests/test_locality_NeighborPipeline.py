@@ -0,0 +1,125 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import rowan
+import unittest
+
+
+class TestNeighborPipeline(unittest.TestCase):
+    def setUp(self):
+        L = 10
+        N = 500
+        self.box, self.points = freud.data.make_random_system(L, N, seed=0)
+        self.orientations = rowan.random.rand(N).astype(np.float32)
+
+    def test_matches_separate_computes(self):
+        """Check that computes run in a pipeline give the same results as
+        separate computes."""
+        system = (self.box, self.points)
+        rdf = freud.density.RDF(bins=20, r_max=2.5)
+        ld = freud.density.LocalDensity(r_max=1.5, diameter=0.5)
+        pmft = freud.pmft.PMFTXYZ(1, 1, 1, 8, 8, 8)
+        pipeline = freud.locality.NeighborPipeline([rdf, ld, pmft])
+        pipeline.compute(system, query_orientations=self.orientations)
+
+        rdf_ref = freud.density.RDF(bins=20, r_max=2.5).compute(system)
+        ld_ref = freud.density.LocalDensity(
+            r_max=1.5, diameter=0.5).compute(system)
+        pmft_ref = freud.pmft.PMFTXYZ(1, 1, 1, 8, 8, 8).compute(
+            system, self.orientations)
+
+        npt.assert_allclose(rdf.rdf, rdf_ref.rdf, rtol=1e-5)
+        npt.assert_allclose(rdf.n_r, rdf_ref.n_r, rtol=1e-5)
+        npt.assert_allclose(ld.density, ld_ref.density, rtol=1e-5)
+        npt.assert_allclose(ld.num_neighbors, ld_ref.num_neighbors,
+                            rtol=1e-5)
+        npt.assert_equal(pmft.bin_counts, pmft_ref.bin_counts)
+
+    def test_steinhardt(self):
+        system = (self.box, self.points)
+        query_args = dict(r_max=1.5, exclude_ii=True)
+        ql = freud.order.Steinhardt(6)
+        rdf = freud.density.RDF(bins=10, r_max=1.5)
+        freud.locality.NeighborPipeline([ql, rdf]).compute(
+            system, neighbors=query_args)
+        ql_ref = freud.order.Steinhardt(6).compute(system, query_args)
+        npt.assert_allclose(ql.particle_order, ql_ref.particle_order,
+                            rtol=1e-5, atol=1e-6)
+        npt.assert_allclose(ql.ql, ql_ref.ql, rtol=1e-5, atol=1e-6)
+
+    def test_nlist(self):
+        """Check that a precomputed NeighborList can be shared."""
+        system = (self.box, self.points)
+        nlist = freud.locality.AABBQuery(*system).query(
+            self.points, dict(r_max=2, exclude_ii=True)).toNeighborList()
+        rdf = freud.density.RDF(bins=20, r_max=2)
+        ld = freud.density.LocalDensity(r_max=1.5, diameter=0.5)
+        freud.locality.NeighborPipeline([rdf, ld]).compute(
+            system, neighbors=nlist)
+        rdf_ref = freud.density.RDF(bins=20, r_max=2).compute(
+            system, neighbors=nlist)
+        ld_ref = freud.density.LocalDensity(r_max=1.5, diameter=0.5).compute(
+            system, neighbors=nlist)
+        npt.assert_allclose(rdf.rdf, rdf_ref.rdf, rtol=1e-5)
+        npt.assert_allclose(ld.density, ld_ref.density, rtol=1e-5)
+
+    def test_reset(self):
+        system = (self.box, self.points)
+        rdf = freud.density.RDF(bins=20, r_max=2)
+        pipeline = freud.locality.NeighborPipeline([rdf])
+        pipeline.compute(system)
+        counts = rdf.bin_counts.copy()
+        pipeline.compute(system, reset=False)
+        npt.assert_equal(rdf.bin_counts, 2 * counts)
+
+    def test_default_query_args(self):
+        rdf = freud.density.RDF(bins=20, r_max=2)
+        ld = freud.density.LocalDensity(r_max=3, diameter=0.5)
+        pipeline = freud.locality.NeighborPipeline([rdf, ld])
+        self.assertEqual(pipeline.default_query_args,
+                         dict(mode='ball', r_max=3.25))
+
+        pipeline = freud.locality.NeighborPipeline(
+            [rdf, freud.order.Steinhardt(6)])
+        with self.assertRaises(NotImplementedError):
+            pipeline.compute((self.box, self.points))
+
+    def test_errors(self):
+        system = (self.box, self.points)
+        with self.assertRaises(ValueError):
+            freud.locality.NeighborPipeline([])
+        with self.assertRaises(TypeError):
+            freud.locality.NeighborPipeline([freud.order.Nematic([1, 0, 0])])
+
+        # Computes that cannot share a traversal.
+        with self.assertRaises(TypeError):
+            freud.locality.NeighborPipeline(
+                [freud.order.SolidLiquid(6, 0.7, 6)]).compute(
+                    system, neighbors=dict(r_max=1.5))
+        with self.assertRaises(ValueError):
+            freud.locality.NeighborPipeline(
+                [freud.order.Steinhardt(6, average=True)]).compute(
+                    system, neighbors=dict(r_max=1.5))
+        with self.assertRaises(ValueError):
+            freud.locality.NeighborPipeline(
+                [freud.pmft.PMFTXYZ(1, 1, 1, 8, 8, 8,
+                                    shiftvec=[0.1, 0, 0])]).compute(
+                    system, query_orientations=self.orientations)
+        with self.assertRaises(ValueError):
+            freud.locality.NeighborPipeline(
+                [freud.pmft.PMFTXYZ(1, 1, 1, 8, 8, 8)]).compute(system)
+
+        # The query arguments must cover the cutoff of every compute.
+        with self.assertRaises(ValueError):
+            freud.locality.NeighborPipeline(
+                [freud.density.RDF(bins=20, r_max=2)]).compute(
+                    system, neighbors=dict(r_max=1))
+
+    def test_repr(self):
+        pipeline = freud.locality.NeighborPipeline(
+            [freud.density.RDF(bins=20, r_max=2)])
+        self.assertEqual(str(pipeline), str(eval(repr(pipeline))))
+
+
+if __name__ == '__main__':
+    unittest.main()
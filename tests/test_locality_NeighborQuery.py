@@ -30,7 +30,8 @@ def nlist_equal(nlist1, nlist2):
 
 class NeighborQueryTest(object):
     @classmethod
-    def build_query_object(cls, box, ref_points, r_max=None):
+    def build_query_object(cls, box, ref_points, r_max=None,
+                           point_types=None):
         raise RuntimeError(
             "The build_query_object function must be defined for every "
             "subclass of NeighborQuery in a separate subclass of "
@@ -251,6 +252,25 @@ class NeighborQueryTest(object):
         npt.assert_equal(get_point_neighbors(result, 2), {3})
         npt.assert_equal(get_point_neighbors(result, 3), {1, 2})
 
+    def test_query_nearest_matches_ball(self):
+        """Nearest neighbors are the closest bonds of a ball query."""
+        L = 10
+        N = 1000
+        r_max = 1.5
+        box, points = freud.data.make_random_system(L, N, seed=1)
+        nq = self.build_query_object(box, points, r_max)
+        ball = nq.query(points, dict(r_max=r_max,
+                                     exclude_ii=True)).toNeighborList()
+        for k in [1, 12, 30]:
+            nearest = nq.query(points, dict(num_neighbors=k, r_max=r_max,
+                                            exclude_ii=True)).toNeighborList()
+            expected = set()
+            for i in range(N):
+                bonds = np.flatnonzero(ball.query_point_indices == i)
+                closest = bonds[np.argsort(ball.distances[bonds])[:k]]
+                expected.update((i, j) for j in ball.point_indices[closest])
+            self.assertEqual(set(map(tuple, nearest[:])), expected)
+
     def test_query_ball_to_nlist(self):
         """Test that generated NeighborLists are identical to the results of
         querying"""
@@ -287,6 +307,117 @@ class NeighborQueryTest(object):
 
         npt.assert_equal(set(result_list), set(list_nlist))
 
+    def test_nlist_order(self):
+        """Test that generated NeighborLists are sorted by query point, then
+        by point index or by distance."""
+        L = 10  # Box Dimensions
+        N = 400  # number of particles
+
+        box, ref_points = freud.data.make_random_system(L, N, seed=0)
+        _, points = freud.data.make_random_system(L, N, seed=1)
+
+        nq = self.build_query_object(box, ref_points, L/10)
+
+        for query_args in [dict(mode='ball', r_max=2),
+                           dict(mode='nearest', num_neighbors=8)]:
+            result_list = list(nq.query(points, query_args))
+
+            nlist = nq.query(points, query_args).toNeighborList()
+            expected = sorted((b[0], b[1]) for b in result_list)
+            npt.assert_equal(
+                list(zip(nlist.query_point_indices, nlist.point_indices)),
+                expected)
+
+            nlist = nq.query(points, query_args).toNeighborList(True)
+            expected = sorted((b[0], b[2], b[1]) for b in result_list)
+            npt.assert_equal(nlist.query_point_indices,
+                             [b[0] for b in expected])
+            npt.assert_equal(nlist.point_indices, [b[2] for b in expected])
+            npt.assert_allclose(nlist.distances, [b[1] for b in expected],
+                                rtol=1e-6)
+            npt.assert_equal(
+                nlist.segments,
+                np.searchsorted(nlist.query_point_indices, np.arange(N)))
+
+    def test_cache(self):
+        """Test that cached and derived NeighborLists match queries."""
+        L = 10  # Box Dimensions
+        N = 400  # number of particles
+
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        nq = self.build_query_object(box, points, L/5)
+        self.assertIsNone(nq.cache_info)
+        nq.enable_cache(max_size=4)
+
+        def check(query_args, **expected_info):
+            query_args = dict(query_args, exclude_ii=True)
+            nlist = freud.locality._make_default_nlist(nq, query_args)
+            expected = nq.query(points, query_args).toNeighborList()
+            npt.assert_equal(nlist.query_point_indices,
+                             expected.query_point_indices)
+            npt.assert_equal(nlist.point_indices, expected.point_indices)
+            npt.assert_equal(nlist.distances, expected.distances)
+            info = nq.cache_info
+            for key, value in expected_info.items():
+                self.assertEqual(info[key], value)
+            return nlist
+
+        nlist = check(dict(r_max=2), queries=1, hits=0, derived=0)
+        self.assertIs(nlist.half, False)
+        check(dict(r_max=2), queries=1, hits=1)
+        check(dict(r_max=1.5, r_min=0.5), queries=1, derived=1)
+        check(dict(num_neighbors=6, r_max=1.8), queries=1, derived=2)
+        check(dict(num_neighbors=8), queries=2, derived=2)
+        check(dict(num_neighbors=3), queries=2, derived=3, size=4)
+        check(dict(r_max=2, half=True), queries=3, size=4)
+
+        # Computes use the cached NeighborList.
+        ld = freud.density.LocalDensity(2, 1)
+        ld.compute(nq, neighbors=dict(r_max=2))
+        self.assertEqual(nq.cache_info['queries'], 4)
+        npt.assert_allclose(
+            ld.num_neighbors, freud.density.LocalDensity(2, 1).compute(
+                (box, points), neighbors=dict(r_max=2)).num_neighbors,
+            rtol=1e-6)
+
+        # Cached NeighborLists cannot be modified.
+        with self.assertRaises(ValueError):
+            nlist.filter_r(1)
+        self.assertEqual(len(nlist.copy().filter_r(1)),
+                         np.sum(nlist.distances < 1))
+
+        nq.clear_cache()
+        self.assertEqual(nq.cache_info['size'], 0)
+        check(dict(r_max=2), queries=5)
+        if hasattr(nq, 'update'):
+            nq.update(points)
+            self.assertEqual(nq.cache_info['size'], 0)
+        nq.disable_cache()
+        self.assertIsNone(nq.cache_info)
+
+    def test_update(self):
+        """Test that updating the points gives the same neighbors as building
+        a new NeighborQuery."""
+        L = 10
+        N = 400
+        r_max = 1.5
+
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        nq = self.build_query_object(box, points, L/10)
+        np.random.seed(0)
+        for _ in range(3):
+            points = box.wrap(points + np.random.normal(
+                scale=0.2, size=points.shape).astype(np.float32))
+            nq.update(points)
+            npt.assert_allclose(nq.points, points)
+            nlist1 = nq.query(points, dict(r_max=r_max)).toNeighborList()
+            nlist2 = self.build_query_object(box, points, L/10).query(
+                points, dict(r_max=r_max)).toNeighborList()
+            self.assertTrue(nlist_equal(nlist1, nlist2))
+
+        with self.assertRaises(ValueError):
+            nq.update(points[:-1])
+
     def test_reciprocal(self):
         """Test that, for a random set of points, for each (i, j) neighbor
         pair there also exists a (j, i) neighbor pair for one set of points"""
@@ -342,6 +473,232 @@ class NeighborQueryTest(object):
 
         self.assertEqual(ij1, ij2)
 
+    def test_half(self):
+        L, r_max, N = (10, 2.01, 1024)
+
+        box, points = freud.data.make_random_system(L, N)
+        nq = self.build_query_object(box, points, r_max)
+        query_args = dict(mode='ball', r_max=r_max, exclude_ii=True)
+        full = nq.query(points, query_args).toNeighborList()
+        query_args['half'] = True
+        half = nq.query(points, query_args).toNeighborList()
+
+        self.assertFalse(full.half)
+        self.assertTrue(half.half)
+        self.assertEqual(2 * len(half), len(full))
+        self.assertTrue(np.all(half.point_indices > half.query_point_indices))
+        self.assertEqual({(i, j) for i, j in full if j > i},
+                         {(i, j) for i, j in half})
+        self.assertTrue(half.copy().half)
+
+        # The per-point iterators find the same bonds.
+        self.assertEqual({(i, j) for i, j, _ in nq.query(points, query_args)},
+                         {(i, j) for i, j in half})
+
+        with self.assertRaises(RuntimeError):
+            nq.query(points, dict(num_neighbors=4, half=True))
+        with self.assertRaises(ValueError):
+            nq.query(points[:N//2], query_args).toNeighborList()
+        # Other query points with as many points are also rejected.
+        _, other_points = freud.data.make_random_system(L, N, seed=1)
+        with self.assertRaises(ValueError):
+            nq.query(other_points, query_args).toNeighborList()
+
+    def test_chunks(self):
+        """Test that the chunks of query results concatenate to the
+        NeighborList of the query."""
+        L, r_max, N = (10, 2.01, 500)
+
+        box, points = freud.data.make_random_system(L, N, seed=2)
+        nq = self.build_query_object(box, points, r_max)
+        for query_args in (dict(r_max=r_max, exclude_ii=True),
+                           dict(num_neighbors=6),
+                           dict(r_max=0.01, exclude_ii=True)):
+            for sort_by_distance in (False, True):
+                result = nq.query(points, query_args)
+                nlist = result.toNeighborList(sort_by_distance)
+                for chunk_size in (1, 777, 10**6):
+                    chunks = list(result.toChunks(
+                        chunk_size, sort_by_distance))
+                    self.assertTrue(all(
+                        len(a) == chunk_size for chunk in chunks[:-1]
+                        for a in chunk))
+                    self.assertTrue(all(
+                        0 < len(a) <= chunk_size for a in chunks[-1])
+                        if chunks else len(nlist) == 0)
+                    if not chunks:
+                        continue
+                    query_point_indices, point_indices, distances = (
+                        np.concatenate(a) for a in zip(*chunks))
+                    npt.assert_array_equal(
+                        query_point_indices, nlist.query_point_indices)
+                    npt.assert_array_equal(
+                        point_indices, nlist.point_indices)
+                    npt.assert_array_equal(distances, nlist.distances)
+
+        with self.assertRaises(ValueError):
+            list(nq.query(points, dict(r_max=r_max)).toChunks(0))
+
+    def test_estimated_nbytes(self):
+        """Test that the estimated size of the NeighborList of a query is
+        close to its size."""
+        L, r_max, N = (10, 2.01, 2000)
+
+        box, points = freud.data.make_random_system(L, N, seed=3)
+        nq = self.build_query_object(box, points, r_max)
+        bond_bytes, query_point_bytes = (28, 12)
+        for query_args in (dict(r_max=r_max, exclude_ii=True),
+                           dict(r_max=r_max, r_min=1, exclude_ii=True),
+                           dict(num_neighbors=6, exclude_ii=True)):
+            result = nq.query(points, query_args)
+            nbytes = (len(result.toNeighborList()) * bond_bytes +
+                      N * query_point_bytes)
+            if 'num_neighbors' in query_args:
+                self.assertEqual(result.estimated_nbytes, nbytes)
+            else:
+                npt.assert_allclose(result.estimated_nbytes, nbytes,
+                                    rtol=0.05)
+
+        for mode in ('count', 'exists'):
+            with self.assertRaises(ValueError):
+                nq.query(points, dict(mode=mode, r_max=r_max)
+                         ).estimated_nbytes
+
+    def test_point_types(self):
+        """Test that type filtered queries find the bonds of the unfiltered
+        queries between points of the given types."""
+        L, r_max, N = (10, 2.01, 600)
+
+        box, points = freud.data.make_random_system(L, N, seed=1)
+        types = np.random.RandomState(1).randint(3, size=N) * 2
+        nq = self.build_query_object(box, points, r_max, point_types=types)
+        npt.assert_array_equal(nq.point_types, types)
+        # Type 1 has no points.
+        for point_type, query_point_type in itertools.product(
+                (None, 0, 1, 4), repeat=2):
+            for query_args in (dict(r_max=r_max, exclude_ii=True),
+                               dict(num_neighbors=4, r_max=r_max,
+                                    exclude_ii=False)):
+                query_args.update(point_type=point_type,
+                                  query_point_type=query_point_type)
+                result = nq.query(points, query_args)
+                nlist = result.toNeighborList()
+
+                # Nearest neighbor queries find the nearest points of the
+                # type, so their reference is a query of those points only.
+                selected = np.arange(N) if point_type is None else \
+                    np.flatnonzero(types == point_type)
+                if len(selected):
+                    reference = self.build_query_object(
+                        box, points[selected], r_max).query(
+                            points, dict(query_args, point_type=None,
+                                         query_point_type=None,
+                                         exclude_ii=False))
+                    expected = {(i, selected[j], round(d, 4))
+                                for i, j, d in reference
+                                if (not query_args['exclude_ii'] or
+                                    selected[j] != i) and (
+                                    query_point_type is None or
+                                    types[i] == query_point_type)}
+                else:
+                    expected = set()
+                self.assertEqual(
+                    {(i, j, round(d, 4)) for i, j, d in zip(
+                        nlist.query_point_indices, nlist.point_indices,
+                        nlist.distances)}, expected)
+                self.assertEqual(
+                    {(i, j) for i, j, _ in nq.query(points, query_args)},
+                    {(i, j) for i, j, _ in expected})
+
+        # Updating the points updates the points of each type.
+        query_args = dict(r_max=r_max, point_type=2, query_point_type=0)
+        points = box.wrap(points + 0.3)
+        nq.update(points)
+        nlist = nq.query(points, query_args).toNeighborList()
+        nlist2 = self.build_query_object(box, points, r_max).query(
+            points, dict(r_max=r_max)).toNeighborList()
+        self.assertTrue(nlist_equal(
+            nlist, [(i, j) for i, j in nlist2
+                    if types[i] == 0 and types[j] == 2]))
+
+        with self.assertRaises(ValueError):
+            nq.query(points, dict(query_args, half=True)).toNeighborList()
+        with self.assertRaises(ValueError):
+            nq.query(points[:10], query_args).toNeighborList()
+        with self.assertRaises(ValueError):
+            self.build_query_object(box, points, r_max).query(
+                points, query_args).toNeighborList()
+        with self.assertRaises(ValueError):
+            self.build_query_object(box, points, r_max, point_types=types[1:])
+
+    def test_counts(self):
+        L, r_max, N = (10, 2.01, 1024)
+
+        box, points = freud.data.make_random_system(L, N)
+        query_points = freud.data.make_random_system(L, N//3)[1]
+        nq = self.build_query_object(box, points, r_max)
+        for qps, r_min, exclude_ii in ((points, 0, True), (points, 0.5, False),
+                                       (query_points, 0.5, False)):
+            query_args = dict(mode='ball', r_max=r_max, r_min=r_min,
+                              exclude_ii=exclude_ii)
+            nlist = nq.query(qps, query_args).toNeighborList()
+            expected = np.bincount(nlist.query_point_indices,
+                                   minlength=len(qps))
+
+            npt.assert_equal(nq.query(qps, query_args).toCounts(), expected)
+            query_args['mode'] = 'count'
+            counts = nq.query(qps, query_args).toCounts()
+            self.assertEqual(counts.dtype, np.uint32)
+            npt.assert_equal(counts, expected)
+
+            # A smaller distance leaves points without neighbors.
+            query_args.update(mode='exists', r_max=r_min + 0.4)
+            nlist = nq.query(qps, dict(query_args, mode='ball')
+                             ).toNeighborList()
+            exists = nq.query(qps, query_args).toCounts()
+            self.assertEqual(exists.dtype, np.bool_)
+            npt.assert_equal(exists, np.bincount(
+                nlist.query_point_indices, minlength=len(qps)) > 0)
+            self.assertFalse(np.all(exists))
+
+        for mode in ('count', 'exists'):
+            query_args = dict(mode=mode, r_max=r_max)
+            with self.assertRaises(ValueError):
+                nq.query(points, query_args).toNeighborList()
+            with self.assertRaises(ValueError):
+                list(nq.query(points, query_args))
+        with self.assertRaises(ValueError):
+            nq.query(points, dict(num_neighbors=4)).toCounts()
+
+    def test_query_grid(self):
+        L, r_max, N = (10, 2.01, 256)
+        for is2D, width in ((False, 16), (True, (24, 12))):
+            box, points = freud.data.make_random_system(L, N, is2D=is2D)
+            nq = self.build_query_object(box, points, r_max)
+            shape = (width,) * box.dimensions if isinstance(width, int) \
+                else width
+            fractions = np.zeros(shape + (3,))
+            for d, w in enumerate(shape):
+                index_shape = [1] * len(shape)
+                index_shape[d] = w
+                fractions[..., d] = (
+                    np.arange(w).reshape(index_shape) + 0.5) / w
+            grid_points = box.make_absolute(fractions.reshape(-1, 3))
+            if is2D:
+                grid_points[:, 2] = 0
+            for query_args in (dict(r_max=r_max),
+                               dict(r_max=r_max, r_min=0.5),
+                               dict(num_neighbors=4)):
+                nlist = nq.query(grid_points, query_args).toNeighborList()
+                grid_nlist = nq.query_grid(
+                    width, query_args).toNeighborList()
+                npt.assert_equal(grid_nlist[:], nlist[:])
+                npt.assert_allclose(
+                    grid_nlist.distances, nlist.distances, rtol=1e-6)
+
+        with self.assertRaises(ValueError):
+            nq.query_grid((4, 4, 4), dict(r_max=r_max))
+
     def test_exhaustive_search(self):
         L, r_max, N = (10, 1.999, 32)
 
@@ -569,8 +926,10 @@ class NeighborQueryTest(object):
 
 class TestNeighborQueryAABB(NeighborQueryTest, unittest.TestCase):
     @classmethod
-    def build_query_object(cls, box, ref_points, r_max=None):
-        return freud.locality.AABBQuery(box, ref_points)
+    def build_query_object(cls, box, ref_points, r_max=None,
+                           point_types=None):
+        return freud.locality.AABBQuery(box, ref_points,
+                                        point_types=point_types)
 
     def test_throws(self):
         """Test that specifying too large an r_max value throws an error"""
@@ -620,13 +979,65 @@ class TestNeighborQueryAABB(NeighborQueryTest, unittest.TestCase):
                 else:
                     original_nlist = nlist
 
+    def test_ghosts_match_images(self):
+        """Check that queries of a tree padded with ghosts find the same
+        neighbors as queries over periodic images."""
+        N = 1000
+        L = 10
+        r_max = 1.5
+        for is2D in [False, True]:
+            box, points = freud.data.make_random_system(
+                L, N, is2D=is2D, seed=3)
+            box = freud.box.Box(L, L, 0 if is2D else L, 0.3, 0.1, 0.2,
+                                is2D=is2D)
+            points = box.wrap(points)
+            query_points = points[:N//2].copy()
+            # Some query points lie exactly on faces of the box.
+            query_points[::7] = box.make_absolute(
+                box.make_fractional(query_points[::7])*[0, 1, 1])
+            aq = freud.locality.AABBQuery(box, points)
+            ghost_aq = freud.locality.AABBQuery(
+                box, points, ghost_width=r_max)
+            self.assertEqual(ghost_aq.ghost_width, np.float32(r_max))
+            for qp, query_args in [
+                    (points, dict(r_max=r_max, exclude_ii=True)),
+                    (points, dict(r_max=1, r_min=0.5)),
+                    (query_points, dict(r_max=r_max)),
+                    (points, dict(num_neighbors=6, r_max=r_max,
+                                  exclude_ii=True))]:
+                nlist1 = aq.query(qp, query_args).toNeighborList()
+                nlist2 = ghost_aq.query(qp, query_args).toNeighborList()
+                npt.assert_array_equal(nlist1[:], nlist2[:])
+                npt.assert_allclose(nlist1.distances, nlist2.distances,
+                                    rtol=1e-5)
+
+            # Ghosts are regenerated when the points move.
+            points = box.wrap(points + np.random.RandomState(0).uniform(
+                -1, 1, points.shape).astype(np.float32)*[1, 1, not is2D])
+            aq.update(points)
+            ghost_aq.update(points)
+            query_args = dict(r_max=r_max, exclude_ii=True)
+            nlist1 = aq.query(points, query_args).toNeighborList()
+            nlist2 = ghost_aq.query(points, query_args).toNeighborList()
+            npt.assert_array_equal(nlist1[:], nlist2[:])
+
+    def test_ghost_width_throws(self):
+        box = freud.box.Box.cube(5)
+        points = [[0, 0, 0], [1, 1, 0], [1, -1, 0]]
+        with self.assertRaises(ValueError):
+            freud.locality.AABBQuery(box, points, ghost_width=-1)
+        with self.assertRaises(ValueError):
+            freud.locality.AABBQuery(box, points, ghost_width=2.5)
+
 
 class TestNeighborQueryLinkCell(NeighborQueryTest, unittest.TestCase):
     @classmethod
-    def build_query_object(cls, box, ref_points, r_max=None):
+    def build_query_object(cls, box, ref_points, r_max=None,
+                           point_types=None):
         if r_max is None:
             raise ValueError("Building LinkCells requires passing an r_max.")
-        return freud.locality.LinkCell(box, ref_points, r_max)
+        return freud.locality.LinkCell(box, ref_points, r_max,
+                                       point_types=point_types)
 
     def test_chaining(self):
         N = 500
@@ -654,6 +1065,61 @@ class TestNeighborQueryLinkCell(NeighborQueryTest, unittest.TestCase):
         self.assertTrue(nlist_equal(nlist1, nlist2))
 
 
+class TestNeighborQueryAABBSpatialSort(NeighborQueryTest, unittest.TestCase):
+    @classmethod
+    def build_query_object(cls, box, ref_points, r_max=None,
+                           point_types=None):
+        return freud.locality.AABBQuery(box, ref_points, spatial_sort=True,
+                                        point_types=point_types)
+
+    def test_spatial_sort_unchanged(self):
+        """Check that spatial sorting does not change query results."""
+        N = 1000
+        L = 10
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        for query_args in [dict(r_max=1.5, exclude_ii=True),
+                           dict(num_neighbors=6, exclude_ii=True)]:
+            nlist1 = freud.locality.AABBQuery(box, points).query(
+                points, query_args).toNeighborList()
+            nlist2 = freud.locality.AABBQuery(
+                box, points, spatial_sort=True).query(
+                points, query_args).toNeighborList()
+            npt.assert_array_equal(nlist1[:], nlist2[:])
+            npt.assert_allclose(nlist1.distances, nlist2.distances)
+
+    def test_packet_traversal_matches_linkcell(self):
+        """Check ball queries of sorted points, which traverse the tree in
+        packets of nearby points, against LinkCell."""
+        N = 2000
+        L = 12
+        r_max = 2.5
+        for is2D in [False, True]:
+            box, points = freud.data.make_random_system(
+                L, N, is2D=is2D, seed=2)
+            for query_args in [dict(r_max=r_max, exclude_ii=True),
+                               dict(r_max=r_max, r_min=0.5)]:
+                nlist1 = freud.locality.AABBQuery(
+                    box, points, spatial_sort=True).query(
+                    points, query_args).toNeighborList()
+                nlist2 = freud.locality.LinkCell(box, points, r_max).query(
+                    points, query_args).toNeighborList()
+                npt.assert_array_equal(nlist1[:], nlist2[:])
+                npt.assert_allclose(nlist1.distances, nlist2.distances,
+                                    rtol=1e-6)
+
+
+class TestNeighborQueryLinkCellSpatialSort(NeighborQueryTest,
+                                           unittest.TestCase):
+    @classmethod
+    def build_query_object(cls, box, ref_points, r_max=None,
+                           point_types=None):
+        if r_max is None:
+            raise ValueError("Building LinkCells requires passing an r_max.")
+        return freud.locality.LinkCell(box, ref_points, r_max,
+                                       spatial_sort=True,
+                                       point_types=point_types)
+
+
 class TestMultipleMethods(unittest.TestCase):
     """Check that different methods of making a NeighborList give the same
     result."""
@@ -676,6 +1142,34 @@ class TestMultipleMethods(unittest.TestCase):
                 query_points, neighbors).toNeighborList()
             self.assertTrue(nlist_equal(nlist, check_nlist))
 
+    def test_default_backend(self):
+        L, r_max, N = (10, 2.01, 256)
+        box, points = freud.data.make_random_system(L, N)
+        aq = freud.locality.AABBQuery(box, points)
+        self.assertEqual(freud.locality.get_default_backend(), 'aabb')
+        try:
+            for selection in ('auto', 'calibrated', 'aabb'):
+                freud.locality.set_default_backend(selection)
+                self.assertEqual(
+                    freud.locality.get_default_backend(), selection)
+                # Nearest neighbor queries of a large fraction of the points
+                # may be answered with a LinkCell.
+                for query_args in (dict(r_max=r_max, exclude_ii=True),
+                                   dict(num_neighbors=N//4, exclude_ii=True),
+                                   dict(num_neighbors=4, r_max=1.5)):
+                    nlist = aq.query(points, query_args).toNeighborList()
+                    raw = freud.locality._RawPoints(box, points)
+                    check_nlist = raw.query(
+                        points, query_args).toNeighborList()
+                    self.assertTrue(nlist_equal(nlist, check_nlist))
+                    npt.assert_allclose(
+                        np.sort(check_nlist.distances),
+                        np.sort(nlist.distances), rtol=1e-6)
+        finally:
+            freud.locality.set_default_backend('aabb')
+        with self.assertRaises(ValueError):
+            freud.locality.set_default_backend('linkcell')
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -0,0 +1,97 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import unittest
+
+
+def nlist_pairs(nlist):
+    return set((i, j) for i, j in nlist)
+
+
+class TestVerletList(unittest.TestCase):
+    def test_matches_query(self):
+        """Check that reused neighbors match a direct query on every
+        frame."""
+        L = 10
+        N = 1000
+        r_max = 1.5
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        vl = freud.locality.VerletList(r_max, skin=0.4, exclude_ii=True)
+        np.random.seed(0)
+        for _ in range(10):
+            points = box.wrap(points + np.random.normal(
+                scale=0.02, size=points.shape).astype(np.float32))
+            vl.compute((box, points))
+            nlist = freud.locality.AABBQuery(box, points).query(
+                points, dict(r_max=r_max, exclude_ii=True)).toNeighborList()
+            self.assertEqual(nlist_pairs(vl.nlist), nlist_pairs(nlist))
+            npt.assert_allclose(vl.nlist.distances, nlist.distances,
+                                rtol=1e-5)
+
+        # Small displacements should not require rebuilding on every frame.
+        self.assertLess(vl.num_builds, 10)
+
+    def test_rebuild(self):
+        """Check that large displacements trigger a rebuild."""
+        L = 10
+        N = 100
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        vl = freud.locality.VerletList(1.5, skin=0.1)
+        vl.compute((box, points))
+        vl.compute((box, points))
+        self.assertEqual(vl.num_builds, 1)
+
+        points = box.wrap(points + np.array([[0.2, 0, 0]], dtype=np.float32))
+        vl.compute((box, points))
+        self.assertEqual(vl.num_builds, 2)
+
+        vl.reset()
+        vl.compute((box, points))
+        self.assertEqual(vl.num_builds, 3)
+
+        # Changing the box always rebuilds.
+        vl.compute((freud.box.Box.cube(L + 1), points))
+        self.assertEqual(vl.num_builds, 4)
+
+    def test_query_points(self):
+        L = 10
+        N = 200
+        r_max = 2
+        box, points = freud.data.make_random_system(L, N, seed=0)
+        _, query_points = freud.data.make_random_system(L, N // 2, seed=1)
+        vl = freud.locality.VerletList(r_max, skin=0.3)
+        vl.compute((box, points), query_points)
+        nlist = freud.locality.AABBQuery(box, points).query(
+            query_points, dict(r_max=r_max)).toNeighborList()
+        self.assertEqual(nlist_pairs(vl.nlist), nlist_pairs(nlist))
+
+    def test_r_min(self):
+        """Check that a pair moving outward across r_min is found without
+        a rebuild."""
+        box = freud.box.Box.cube(10)
+        points = np.array([[0, 0, 0], [0.9, 0, 0]], dtype=np.float32)
+        vl = freud.locality.VerletList(2, skin=0.4, r_min=1)
+        vl.compute((box, points))
+        self.assertEqual(len(vl.nlist), 0)
+
+        points[1, 0] += 0.15
+        vl.compute((box, points))
+        self.assertEqual(vl.num_builds, 1)
+        nlist = freud.locality.AABBQuery(box, points).query(
+            points, dict(r_max=2, r_min=1)).toNeighborList()
+        self.assertEqual(nlist_pairs(nlist), {(0, 1), (1, 0)})
+        self.assertEqual(nlist_pairs(vl.nlist), nlist_pairs(nlist))
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            freud.locality.VerletList(-1, 0.1)
+        with self.assertRaises(ValueError):
+            freud.locality.VerletList(1, -0.1)
+
+    def test_repr(self):
+        vl = freud.locality.VerletList(1.5, 0.25)
+        self.assertEqual(str(vl), str(eval(repr(vl))))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -246,9 +246,72 @@ class TestVoronoi(unittest.TestCase):
             points[vor.nlist.query_point_indices]), axis=-1)
         npt.assert_allclose(wrapped_distances, vor.nlist.distances)
 
+    def test_many_blocks(self):
+        # Test a system large enough to span many voro++ blocks, whose cells
+        # are computed in parallel
+        L = 20  # Box length
+        N = 5000  # Number of particles
+        box, points = freud.data.make_random_system(L, N, seed=1)
+        vor = freud.locality.Voronoi()
+        vor.compute((box, points))
+        polytopes = vor.polytopes
+
+        npt.assert_equal(len(polytopes), N)
+        npt.assert_almost_equal(np.sum(vor.volumes), box.volume, decimal=2)
+        self.assertTrue(np.all(vor.volumes > 0))
+        self.assertTrue(all(len(polytope) >= 4 for polytope in polytopes))
+
+        # Every Voronoi neighbor relation is symmetric with equal weights
+        nlist = vor.nlist
+        forward = np.lexsort((nlist.weights, nlist.point_indices,
+                              nlist.query_point_indices))
+        backward = np.lexsort((nlist.weights, nlist.query_point_indices,
+                               nlist.point_indices))
+        npt.assert_equal(nlist.query_point_indices[forward],
+                         nlist.point_indices[backward])
+        npt.assert_allclose(nlist.weights[forward],
+                            nlist.weights[backward], rtol=1e-4)
+
+        # Polytopes of a previous compute are not changed by a new one
+        vor.compute(freud.data.make_random_system(L, N // 2, seed=2))
+        npt.assert_equal(len(vor.polytopes), N // 2)
+        for i in range(0, N, 500):
+            centroid = np.mean(polytopes[i], axis=0)
+            self.assertLess(np.linalg.norm(box.wrap(centroid - points[i])),
+                            L/4)
+
+    def test_outputs(self):
+        # Test that skipping outputs gives the same neighbors and volumes
+        for is2D in [False, True]:
+            box, points = freud.data.make_random_system(
+                10, 200, is2D=is2D, seed=0)
+            full = freud.locality.Voronoi().compute((box, points))
+            self.assertEqual(full.outputs, 'polytopes')
+            for outputs in ['neighbors', 'volumes']:
+                vor = freud.locality.Voronoi(outputs=outputs)
+                vor.compute((box, points))
+                self.assertEqual(vor.outputs, outputs)
+                npt.assert_equal(vor.nlist.query_point_indices,
+                                 full.nlist.query_point_indices)
+                npt.assert_equal(vor.nlist.point_indices,
+                                 full.nlist.point_indices)
+                npt.assert_allclose(vor.nlist.weights, full.nlist.weights)
+                with self.assertRaises(AttributeError):
+                    vor.polytopes
+                if outputs == 'volumes':
+                    npt.assert_allclose(vor.volumes, full.volumes)
+                else:
+                    with self.assertRaises(AttributeError):
+                        vor.volumes
+
+        with self.assertRaises(ValueError):
+            freud.locality.Voronoi(outputs='vertices')
+
     def test_repr(self):
         vor = freud.locality.Voronoi()
         self.assertEqual(str(vor), str(eval(repr(vor))))
+        vor = freud.locality.Voronoi(outputs='neighbors')
+        self.assertEqual(str(vor), str(eval(repr(vor))))
 
     def test_attributes(self):
         # Test that the class attributes are protected
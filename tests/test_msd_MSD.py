@@ -78,6 +78,48 @@ class TestMSD(unittest.TestCase):
             npt.assert_allclose(solution, simple, atol=1e-6)
             npt.assert_allclose(solution_particle, simple_particle, atol=1e-5)
 
+    def test_unwrap(self):
+        """Unwrapping with images matches unwrapping with the box."""
+        box = freud.box.Box(4, 5, 6, 0.1, 0.2, 0.3)
+        np.random.seed(0)
+        positions = np.random.rand(20, 7, 3).astype(np.float32)
+        images = np.random.randint(-3, 4, size=positions.shape)
+        unwrapped = np.array([box.unwrap(p, i)
+                              for p, i in zip(positions, images)])
+        for mode in ['window', 'direct']:
+            msd = freud.msd.MSD(box, mode=mode)
+            reference = freud.msd.MSD(mode=mode).compute(unwrapped)
+            msd.compute(positions, images)
+            npt.assert_allclose(msd.particle_msd, reference.particle_msd,
+                                rtol=1e-4, atol=1e-4)
+            npt.assert_allclose(msd.msd, reference.msd, rtol=1e-4,
+                                atol=1e-4)
+
+    def test_memmap(self):
+        """Memory-mapped and double precision trajectories give the same
+        results as arrays in memory."""
+        import os
+        import tempfile
+        np.random.seed(1)
+        positions = np.random.rand(30, 11, 3).astype(np.float32)
+        msd = freud.msd.MSD()
+        reference = msd.compute(positions).particle_msd.copy()
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            filename = os.path.join(tmpdir, 'positions.npy')
+            for dtype in [np.float32, np.float64]:
+                np.save(filename, positions.astype(dtype))
+                mapped = np.load(filename, mmap_mode='r')
+                npt.assert_allclose(msd.compute(mapped).particle_msd,
+                                    reference, rtol=1e-5, atol=1e-6)
+                del mapped
+
+    def test_frame_mismatch(self):
+        msd = freud.msd.MSD()
+        msd.compute(np.random.rand(10, 2, 3))
+        with self.assertRaises(ValueError):
+            msd.compute(np.random.rand(5, 2, 3), reset=False)
+
     def test_repr(self):
         msd = freud.msd.MSD()
         self.assertEqual(str(msd), str(eval(repr(msd))))
@@ -86,5 +128,92 @@ class TestMSD(unittest.TestCase):
         self.assertEqual(str(msd2), str(eval(repr(msd2))))
 
 
+class TestMultipleTauMSD(unittest.TestCase):
+    def reference_msd(self, positions, lag, interval):
+        """Average squared displacement over the windows starting at
+        multiples of interval."""
+        starts = np.arange(0, len(positions) - lag, interval)
+        displacements = positions[starts + lag] - positions[starts]
+        return np.mean(np.sum(displacements**2, axis=-1), axis=0)
+
+    def test_lags(self):
+        np.random.seed(0)
+        positions = np.cumsum(np.random.normal(size=(100, 3, 3)), axis=0)
+        msd = freud.msd.MultipleTauMSD(points_per_level=8, decimation=2)
+        with self.assertRaises(AttributeError):
+            msd.msd
+        msd.compute(positions)
+        npt.assert_array_equal(
+            msd.lags, [0, 1, 2, 3, 4, 5, 6, 7, 8, 10, 12, 14, 16, 20, 24, 28,
+                       32, 40, 48, 56, 64, 80, 96])
+        self.assertEqual(msd.msd.shape, (len(msd.lags),))
+        self.assertEqual(msd.particle_msd.shape, (len(msd.lags), 3))
+
+    def test_reference(self):
+        """Each lag matches the MSD over the windows sampled by its level,
+        whether frames are added at once, in blocks or one at a time."""
+        np.random.seed(1)
+        positions = np.cumsum(np.random.normal(size=(70, 5, 3)), axis=0)
+        msd = freud.msd.MultipleTauMSD(points_per_level=6, decimation=3)
+        msd.compute(positions)
+        particle_msd = msd.particle_msd.copy()
+        for i, lag in enumerate(msd.lags):
+            interval = 1
+            while lag >= msd.points_per_level * interval:
+                interval *= msd.decimation
+            npt.assert_allclose(
+                particle_msd[i], self.reference_msd(positions, lag, interval),
+                rtol=1e-4, atol=1e-4)
+        npt.assert_allclose(msd.msd, particle_msd.mean(axis=1), rtol=1e-5)
+
+        msd.compute(positions[:33])
+        msd.compute(positions[33:], reset=False)
+        npt.assert_allclose(msd.particle_msd, particle_msd, rtol=1e-5,
+                            atol=1e-5)
+        msd.compute(positions[0])
+        for frame in positions[1:]:
+            msd.compute(frame, reset=False)
+        npt.assert_allclose(msd.particle_msd, particle_msd, rtol=1e-5,
+                            atol=1e-5)
+
+    def test_short_lags_match_window(self):
+        """Lags below points_per_level average over all windows."""
+        np.random.seed(2)
+        positions = np.random.rand(40, 4, 3)
+        msd = freud.msd.MultipleTauMSD(points_per_level=16)
+        window = freud.msd.MSD().compute(positions).msd
+        msd.compute(positions)
+        npt.assert_allclose(msd.msd[:16], window[:16], rtol=1e-4, atol=1e-5)
+
+    def test_unwrap(self):
+        np.random.seed(3)
+        box = freud.box.Box.cube(10)
+        unwrapped = np.cumsum(np.random.normal(size=(50, 4, 3)), axis=0)
+        images = np.floor((unwrapped + 5) / 10).astype(np.int32)
+        wrapped = unwrapped - 10 * images
+        msd = freud.msd.MultipleTauMSD(box)
+        reference = freud.msd.MultipleTauMSD().compute(unwrapped).msd
+        npt.assert_allclose(msd.compute(wrapped, images).msd, reference,
+                            rtol=1e-4, atol=1e-4)
+
+    def test_invalid(self):
+        with self.assertRaises(ValueError):
+            freud.msd.MultipleTauMSD(points_per_level=2, decimation=2)
+        with self.assertRaises(ValueError):
+            freud.msd.MultipleTauMSD(decimation=1)
+        msd = freud.msd.MultipleTauMSD()
+        msd.compute(np.random.rand(10, 2, 3))
+        with self.assertRaises(ValueError):
+            msd.compute(np.random.rand(5, 3, 3), reset=False)
+
+    def test_repr(self):
+        msd = freud.msd.MultipleTauMSD()
+        self.assertEqual(str(msd), str(eval(repr(msd))))
+        msd2 = freud.msd.MultipleTauMSD(
+            box=freud.box.Box(1, 2, 3, 4, 5, 6), points_per_level=8,
+            decimation=4)
+        self.assertEqual(str(msd2), str(eval(repr(msd2))))
+
+
 if __name__ == '__main__':
     unittest.main()
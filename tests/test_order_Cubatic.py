@@ -96,6 +96,51 @@ class TestCubatic(unittest.TestCase):
             op_max, 0.2,
             err_msg="per particle order parameter value is too high")
 
+    def test_reference(self):
+        """The order parameters match eq. 22 evaluated with full tensors."""
+        np.random.seed(4)
+        orientations = rowan.random.rand(50)
+        cubatic = freud.order.Cubatic(5.0, 0.01, 0.9, 4, seed=7)
+        cubatic.compute(orientations)
+
+        delta = np.eye(3)
+        r4 = 2 / 5 * (np.einsum('ij,kl->ijkl', delta, delta) +
+                      np.einsum('ik,jl->ijkl', delta, delta) +
+                      np.einsum('il,jk->ijkl', delta, delta))
+
+        def cubatic_tensor(q):
+            vectors = rowan.rotate(q, np.eye(3))
+            return 2 * np.einsum('ni,nj,nk,nl->ijkl', vectors, vectors,
+                                 vectors, vectors) - r4
+
+        def order(tensor, global_tensor):
+            return 1 - (np.sum((global_tensor - tensor)**2) /
+                        np.sum(tensor**2))
+
+        global_tensor = np.mean(
+            [cubatic_tensor(q) + r4 for q in orientations], axis=0) - r4
+        npt.assert_allclose(cubatic.global_tensor, global_tensor, atol=1e-5)
+        npt.assert_allclose(
+            cubatic.particle_order,
+            [order(cubatic_tensor(q), global_tensor) for q in orientations],
+            atol=1e-4)
+        npt.assert_allclose(
+            cubatic.order,
+            order(cubatic_tensor(cubatic.orientation), global_tensor),
+            atol=1e-4)
+        npt.assert_allclose(cubatic.cubatic_tensor,
+                            cubatic_tensor(cubatic.orientation), atol=1e-5)
+
+    def test_seed(self):
+        """Results are reproducible for a given seed."""
+        np.random.seed(5)
+        orientations = rowan.random.rand(100)
+        results = [freud.order.Cubatic(5.0, 0.001, 0.95, 8, seed=11).compute(
+            orientations) for _ in range(2)]
+        self.assertEqual(results[0].order, results[1].order)
+        npt.assert_array_equal(results[0].orientation,
+                               results[1].orientation)
+
     def test_valid_inputs(self):
         with self.assertRaises(ValueError):
             # t_initial must be greater than t_final
@@ -0,0 +1,64 @@
+import numpy as np
+import numpy.testing as npt
+import freud
+import unittest
+import util
+
+
+class TestHexaticTranslationalOrder(unittest.TestCase):
+    def test_matches_separate(self):
+        """Fused values match Hexatic and Translational on the same bonds."""
+        box, points = freud.data.make_random_system(
+            20, 400, is2D=True, seed=3)
+        ks = [6, 4, 12]
+        op = freud.order.HexaticTranslationalOrder(ks, translational_k=6)
+
+        # Test access
+        with self.assertRaises(AttributeError):
+            op.particle_order
+        with self.assertRaises(AttributeError):
+            op.translational_order
+
+        test_set = util.make_raw_query_nlist_test_set(
+            box, points, points, 'nearest', 3, 6, True)
+        for nq, neighbors in test_set:
+            op.compute(nq, neighbors=neighbors)
+            self.assertEqual(op.particle_order.shape, (len(points), len(ks)))
+            for i, k in enumerate(ks):
+                hop = freud.order.Hexatic(k)
+                hop.compute(nq, neighbors=neighbors)
+                npt.assert_allclose(op.particle_order[:, i],
+                                    hop.particle_order, atol=1e-5)
+            trans = freud.order.Translational(6)
+            trans.compute(nq, neighbors=neighbors)
+            npt.assert_allclose(op.translational_order,
+                                trans.particle_order, atol=1e-5)
+
+    def test_weighted(self):
+        box, points = freud.data.make_random_system(
+            10, 100, is2D=True, seed=0)
+        voro = freud.locality.Voronoi()
+        voro.compute((box, points))
+        op = freud.order.HexaticTranslationalOrder(6, weighted=True)
+        op.compute((box, points), neighbors=voro.nlist)
+        hop = freud.order.Hexatic(6, weighted=True)
+        hop.compute((box, points), neighbors=voro.nlist)
+        self.assertEqual(op.particle_order.shape, (len(points), ))
+        npt.assert_allclose(op.particle_order, hop.particle_order, atol=1e-5)
+
+    def test_scalar_k(self):
+        op = freud.order.HexaticTranslationalOrder(6)
+        self.assertEqual(op.k, 6)
+        op = freud.order.HexaticTranslationalOrder([4, 6])
+        self.assertEqual(op.k, [4, 6])
+        self.assertEqual(op.default_query_args['num_neighbors'], 6)
+        with self.assertRaises(ValueError):
+            freud.order.HexaticTranslationalOrder([])
+
+    def test_repr(self):
+        op = freud.order.HexaticTranslationalOrder([4, 6], 4.0, True)
+        self.assertEqual(str(op), str(eval(repr(op))))
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -101,6 +101,37 @@ class TestNematicOrder(unittest.TestCase):
         op = freud.order.Nematic(u)
         self.assertEqual(str(op), str(eval(repr(op))))
 
+    def test_compute_frames(self):
+        """Batched frames give the same results as computing each frame."""
+        np.random.seed(2)
+        frames = np.array([
+            rowan.interpolate.slerp([1, 0, 0, 0], rowan.random.rand(200), t)
+            for t in [0.05, 0.2, 0.5]])
+        u = np.array([1, 2, 0])
+        nematic = freud.order.Nematic(u)
+        with self.assertRaises(AttributeError):
+            nematic.frame_order
+        nematic.compute_frames(frames)
+        self.assertEqual(nematic.frame_order.shape, (3, ))
+        self.assertEqual(nematic.frame_director.shape, (3, 3))
+        self.assertEqual(nematic.frame_nematic_tensor.shape, (3, 3, 3))
+
+        reference = freud.order.Nematic(u)
+        for i, frame in enumerate(frames):
+            reference.compute(frame)
+            npt.assert_allclose(nematic.frame_order[i], reference.order,
+                                rtol=1e-5, atol=1e-6)
+            npt.assert_allclose(nematic.frame_nematic_tensor[i],
+                                reference.nematic_tensor,
+                                rtol=1e-5, atol=1e-6)
+            # Directors are only defined up to sign.
+            npt.assert_allclose(
+                np.abs(np.dot(nematic.frame_director[i], reference.director)),
+                1, rtol=1e-5)
+
+        with self.assertRaises(ValueError):
+            nematic.compute_frames(np.zeros((0, 3, 4)))
+
 
 if __name__ == '__main__':
     unittest.main()
@@ -81,9 +81,73 @@ class TestRotationalAutocorrelation(unittest.TestCase):
             ra6.compute(orientations, orientations).order,
             1, rtol=1e-6)
 
+    def test_compute_frames(self):
+        """Batched frames give the same values as computing each frame."""
+        np.random.seed(8)
+        ref_orientations = rowan.random.rand(20)
+        orientations = rowan.random.rand(6 * 20).reshape(6, 20, 4)
+        for l in [2, 6, 12]:
+            ra = freud.order.RotationalAutocorrelation(l)
+            with self.assertRaises(AttributeError):
+                ra.frame_order
+            frame_order = ra.compute_frames(
+                ref_orientations, orientations).frame_order
+            self.assertEqual(frame_order.shape, (6, ))
+            npt.assert_allclose(
+                frame_order,
+                [ra.compute(ref_orientations, frame).order
+                 for frame in orientations], rtol=1e-5, atol=1e-6)
+            npt.assert_allclose(
+                ra.compute_frames(ref_orientations,
+                                  ref_orientations[np.newaxis]).frame_order,
+                1, rtol=1e-5)
+
+    def test_time_correlation(self):
+        """The time correlation at each lag is the average of compute over
+        the pairs of frames sampled at that lag."""
+        np.random.seed(3)
+        n_frames, N = 60, 7
+        steps = rowan.from_axis_angle(
+            np.random.normal(size=(n_frames, N, 3)),
+            np.random.normal(scale=0.2, size=(n_frames, N)))
+        orientations = np.empty_like(steps)
+        orientations[0] = steps[0]
+        for i in range(1, n_frames):
+            orientations[i] = rowan.multiply(orientations[i - 1], steps[i])
+
+        ra = freud.order.RotationalAutocorrelation(4, points_per_level=8)
+        with self.assertRaises(AttributeError):
+            ra.time_correlation
+        ra.compute_time_correlation(orientations[:25])
+        ra.compute_time_correlation(orientations[25:], reset=False)
+        self.assertEqual(len(ra.lags), len(ra.time_correlation))
+        self.assertEqual(ra.lags[0], 0)
+        npt.assert_allclose(ra.time_correlation[0], 1, rtol=1e-5)
+
+        for lag, value in zip(ra.lags, ra.time_correlation):
+            interval = 1
+            while lag >= ra.points_per_level * interval:
+                interval *= ra.decimation
+            reference = np.mean([
+                ra.compute(orientations[start],
+                           orientations[start + lag]).order
+                for start in range(0, n_frames - lag, interval)])
+            npt.assert_allclose(value, reference, rtol=1e-4, atol=1e-5)
+
+    def test_time_correlation_invalid(self):
+        with self.assertRaises(ValueError):
+            freud.order.RotationalAutocorrelation(2, points_per_level=2)
+        ra = freud.order.RotationalAutocorrelation(2)
+        ra.compute_time_correlation(rowan.random.rand(4))
+        with self.assertRaises(ValueError):
+            ra.compute_time_correlation(rowan.random.rand(5), reset=False)
+
     def test_repr(self):
         ra2 = freud.order.RotationalAutocorrelation(2)
         self.assertEqual(str(ra2), str(eval(repr(ra2))))
+        ra4 = freud.order.RotationalAutocorrelation(
+            4, points_per_level=10, decimation=3)
+        self.assertEqual(str(ra4), str(eval(repr(ra4))))
 
 
 def quat_to_greek(q):
@@ -1,3 +1,4 @@
+import numpy as np
 import numpy.testing as npt
 import freud
 import matplotlib
@@ -87,9 +88,47 @@ class TestSolidLiquid(unittest.TestCase):
         comp.ql_ij
         comp._repr_png_()
 
+    def test_memory_budget(self):
+        """Check that chunked bonds give the clusters of the full
+        NeighborList."""
+        box, positions = freud.data.UnitCell.fcc().generate_system(
+            6, scale=2, sigma_noise=0.15, seed=0)
+        # Remove points from half of the box to make several clusters.
+        positions = positions[(positions[:, 0] < 0) |
+                              (np.arange(len(positions)) % 3 != 0)]
+        query_args = dict(r_max=1.8, exclude_ii=True)
+        full = freud.order.SolidLiquid(6, q_threshold=.7, solid_threshold=6)
+        full.compute((box, positions), neighbors=query_args)
+        self.assertIsNone(full.memory_budget)
+        self.assertGreater(full.cluster_sizes.size, 1)
+
+        nbytes = freud.locality.AABBQuery(box, positions).query(
+            positions, query_args).estimated_nbytes
+        for memory_budget in (1, nbytes // 10):
+            comp = freud.order.SolidLiquid(
+                6, q_threshold=.7, solid_threshold=6,
+                memory_budget=memory_budget)
+            self.assertEqual(comp.memory_budget, memory_budget)
+            comp.compute((box, positions), neighbors=query_args)
+            npt.assert_array_equal(comp.cluster_idx, full.cluster_idx)
+            npt.assert_array_equal(comp.num_connections,
+                                   full.num_connections)
+            self.assertEqual(len(comp.nlist), 0)
+            self.assertEqual(len(comp.ql_ij), 0)
+
+        # Budgets larger than the bonds keep the NeighborList.
+        comp.memory_budget = 2 * nbytes
+        comp.compute((box, positions), neighbors=query_args)
+        npt.assert_array_equal(comp.ql_ij, full.ql_ij)
+
+        with self.assertRaises(ValueError):
+            freud.order.SolidLiquid(6, 0.7, 6, memory_budget=0)
+
     def test_repr(self):
         comp = freud.order.SolidLiquid(6, q_threshold=.7, solid_threshold=6)
         self.assertEqual(str(comp), str(eval(repr(comp))))
+        comp = freud.order.SolidLiquid(6, 0.7, 6, memory_budget=2**20)
+        self.assertEqual(str(comp), str(eval(repr(comp))))
 
 
 if __name__ == '__main__':
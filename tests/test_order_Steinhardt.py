@@ -54,6 +54,21 @@ class TestSteinhardt(unittest.TestCase):
             comp.compute((box, positions), neighbors={'num_neighbors': 2})
             npt.assert_allclose(comp.particle_order, 1, atol=1e-5)
 
+    def test_single_bond(self):
+        # A point with a single neighbor has Q_l = 1 for every l, whatever
+        # the direction of the bond.
+        box = freud.box.Box.cube(10)
+        np.random.seed(0)
+        directions = np.random.normal(size=(20, 3))
+        directions /= np.linalg.norm(directions, axis=-1)[:, np.newaxis]
+        directions = np.concatenate([directions, np.eye(3), -np.eye(3)])
+        for direction in directions:
+            positions = [[0, 0, 0], 1.5 * direction]
+            for l in range(0, 16):
+                comp = freud.order.Steinhardt(l)
+                comp.compute((box, positions), neighbors={'num_neighbors': 1})
+                npt.assert_allclose(comp.particle_order, 1, atol=1e-5)
+
     def test_identical_environments_ql(self):
         box, positions = freud.data.UnitCell.fcc().generate_system(4, scale=2)
         r_max = 1.5
@@ -76,6 +91,46 @@ class TestSteinhardt(unittest.TestCase):
                                 comp.particle_order[0], atol=1e-5)
             self.assertAlmostEqual(comp.order, PERFECT_FCC_Q6, delta=1e-5)
 
+    @util.skipIfMissing('scipy.special')
+    def test_average_reference(self):
+        # Compare the second shell averages with an explicit calculation.
+        from scipy.special import sph_harm
+        N = 100
+        r_max = 1.5
+        box, positions = freud.data.make_random_system(5, N, seed=1)
+        nl = freud.locality.AABBQuery(box, positions).query(
+            positions, dict(r_max=r_max, exclude_ii=True)).toNeighborList()
+
+        for l in [4, 6]:
+            ms = np.arange(-l, l+1)
+            qlmi = np.zeros((N, len(ms)), dtype=np.complex128)
+            for i, j in nl:
+                bond = box.wrap(positions[j] - positions[i])
+                theta = np.arccos(bond[2]/np.linalg.norm(bond))
+                phi = np.arctan2(bond[1], bond[0])
+                qlmi[i] += sph_harm(ms, l, phi, theta)
+            counts = nl.neighbor_counts
+            qlmi[counts > 0] /= counts[counts > 0, np.newaxis]
+
+            # Sum over the neighbors of the neighbors of each particle.
+            qlmi_ave = qlmi.copy()
+            shell_counts = np.ones(N)
+            for i, j in nl:
+                qlmi_ave[i] += qlmi[nl.point_indices[
+                    nl.query_point_indices == j]].sum(axis=0)
+                shell_counts[i] += counts[j]
+            qlmi_ave /= shell_counts[:, np.newaxis]
+            ql_ave = np.sqrt(4*np.pi/(2*l+1) *
+                             np.sum(np.abs(qlmi_ave)**2, axis=1))
+
+            test_set = util.make_raw_query_nlist_test_set(
+                box, positions, positions, 'ball', r_max, 0, True)
+            for nq, neighbors in test_set:
+                comp = freud.order.Steinhardt(l, average=True)
+                comp.compute(nq, neighbors=neighbors)
+                npt.assert_allclose(comp.particle_order, ql_ave,
+                                    rtol=1e-4, atol=1e-5)
+
     def test_identical_environments_ql_near(self):
         box, positions = freud.data.UnitCell.fcc().generate_system(4)
 
@@ -224,6 +279,72 @@ class TestSteinhardt(unittest.TestCase):
         comp.order
         comp.particle_order
 
+    def test_multiple_l(self):
+        """Check that computing several l together matches computing each l
+        separately."""
+        box, points = freud.data.make_random_system(10, 500, seed=0)
+        ls = [4, 6, 8, 12]
+        for average in [False, True]:
+            for wl in [False, True]:
+                comp = freud.order.Steinhardt(
+                    ls, average=average, wl=wl, wl_normalize=wl)
+                comp.compute((box, points), neighbors={'r_max': 1.5})
+                self.assertEqual(comp.l, ls)
+                self.assertEqual(comp.particle_order.shape, (len(points),
+                                                             len(ls)))
+                self.assertEqual(comp.ql.shape, (len(points), len(ls)))
+                self.assertEqual(comp.order.shape, (len(ls),))
+                for i, l in enumerate(ls):
+                    single = freud.order.Steinhardt(
+                        l, average=average, wl=wl, wl_normalize=wl)
+                    single.compute((box, points), neighbors={'r_max': 1.5})
+                    npt.assert_allclose(comp.particle_order[:, i],
+                                        single.particle_order, rtol=1e-5,
+                                        atol=1e-6)
+                    npt.assert_allclose(comp.ql[:, i], single.ql, rtol=1e-5,
+                                        atol=1e-6)
+                    npt.assert_allclose(comp.order[i], single.order,
+                                        rtol=1e-5, atol=1e-6)
+
+        # A sequence with one value keeps the column axis.
+        comp = freud.order.Steinhardt([6])
+        comp.compute((box, points), neighbors={'r_max': 1.5})
+        self.assertEqual(comp.particle_order.shape, (len(points), 1))
+
+        with self.assertRaises(ValueError):
+            freud.order.Steinhardt([])
+
+    def test_compute_trajectory(self):
+        """Check that trajectory averages match the mean over frames."""
+        num_points = 200
+        box = freud.box.Box.cube(8)
+        points = np.array([freud.data.make_random_system(
+            box.Lx, num_points, seed=frame)[1] for frame in range(4)])
+        neighbors = {'num_neighbors': 12}
+        for ls in [6, [4, 6]]:
+            comp = freud.order.Steinhardt(ls)
+            particle_orders = []
+            orders = []
+            for frame_points in points:
+                comp.compute((box, frame_points), neighbors=neighbors)
+                particle_orders.append(comp.particle_order)
+                orders.append(comp.order)
+            for parallel_frames in [False, True]:
+                comp.compute_trajectory(box, points, neighbors=neighbors,
+                                        parallel_frames=parallel_frames)
+                npt.assert_allclose(comp.trajectory_particle_order,
+                                    np.mean(particle_orders, axis=0),
+                                    rtol=1e-5, atol=1e-6)
+                npt.assert_allclose(comp.trajectory_order,
+                                    np.mean(orders, axis=0), rtol=1e-5,
+                                    atol=1e-6)
+                # The per-frame properties hold the last frame.
+                npt.assert_allclose(comp.particle_order, particle_orders[-1],
+                                    rtol=1e-5, atol=1e-6)
+
+        with self.assertRaises(ValueError):
+            comp.compute_trajectory([box, box], points, neighbors=neighbors)
+
     def test_compute_twice_norm(self):
         """Test that computing norm twice works as expected."""
         L = 5
@@ -286,12 +407,85 @@ class TestSteinhardt(unittest.TestCase):
             npt.assert_allclose(w6.particle_order[0],
                                 PERFECT_FCC_W6, rtol=1e-5)
 
+    def test_wl_large_l(self):
+        # Wigner 3j coefficients of l > 20 are computed at runtime.
+        box = freud.box.Box.cube(10)
+        positions = np.array([[0, 0, 0],
+                              [-1, -1, 0],
+                              [-1, 1, 0],
+                              [1, -1, 0],
+                              [1, 1, 0],
+                              [-1, 0, -1],
+                              [-1, 0, 1],
+                              [1, 0, -1],
+                              [1, 0, 1],
+                              [0, -1, -1],
+                              [0, -1, 1],
+                              [0, 1, -1],
+                              [0, 1, 1]])
+        query_point_indices = np.zeros(len(positions)-1)
+        point_indices = np.arange(1, len(positions))
+        nlist = freud.locality.NeighborList.from_arrays(
+            len(positions), len(positions), query_point_indices, point_indices,
+            np.full(len(query_point_indices), np.sqrt(2)))
+
+        wl = freud.order.Steinhardt([20, 23, 24], wl=True, wl_normalize=True)
+        wl.compute((box, positions), neighbors=nlist)
+        unrotated_order = wl.particle_order[0]
+
+        # The third-order invariants of odd l vanish.
+        npt.assert_equal(unrotated_order[1], 0)
+        self.assertNotEqual(unrotated_order[2], 0)
+
+        for i in range(5):
+            np.random.seed(i)
+            quat = rowan.random.rand()
+            positions_rotated = rowan.rotate(quat, positions)
+            wl.compute((box, positions_rotated), neighbors=nlist)
+            npt.assert_allclose(wl.particle_order[0], unrotated_order,
+                                rtol=1e-4, atol=1e-6)
+
+    def test_partitioners(self):
+        # Points in a dense cluster have many more neighbors than the rest.
+        box, points = freud.data.make_random_system(10, 1000, seed=0)
+        points[:200] *= 0.1
+        nlist = freud.locality.AABBQuery(box, points).query(
+            points, dict(r_max=1.5, exclude_ii=True)).toNeighborList()
+
+        for average in [False, True]:
+            ref = freud.order.Steinhardt(6, average=average)
+            ref.compute((box, points), neighbors=nlist)
+            comp = freud.order.Steinhardt(6, average=average)
+            self.assertEqual(comp.partitioner, 'auto')
+            self.assertEqual(comp.grain_size, 1)
+            for partitioner in ['simple', 'static', 'affinity', 'balanced']:
+                for grain_size in [1, 16]:
+                    comp.partitioner = partitioner
+                    comp.grain_size = grain_size
+                    self.assertEqual(comp.partitioner, partitioner)
+                    self.assertEqual(comp.grain_size, grain_size)
+                    comp.compute((box, points), neighbors=nlist)
+                    npt.assert_allclose(comp.particle_order,
+                                        ref.particle_order, rtol=1e-5)
+                    # Balanced partitioning falls back to the default
+                    # without a NeighborList.
+                    comp.compute((box, points), neighbors={'r_max': 1.5})
+                    npt.assert_allclose(comp.particle_order,
+                                        ref.particle_order, rtol=1e-5)
+
+        with self.assertRaises(ValueError):
+            comp.partitioner = 'guided'
+        with self.assertRaises(ValueError):
+            comp.grain_size = 0
+
     def test_repr(self):
         comp = freud.order.Steinhardt(6)
         self.assertEqual(str(comp), str(eval(repr(comp))))
         # Use non-default arguments for all parameters
         comp = freud.order.Steinhardt(6, average=True, wl=True, weighted=True)
         self.assertEqual(str(comp), str(eval(repr(comp))))
+        comp = freud.order.Steinhardt([4, 6], wl=True)
+        self.assertEqual(str(comp), str(eval(repr(comp))))
 
     def test_repr_png(self):
         L = 5
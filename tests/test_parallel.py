@@ -1,5 +1,9 @@
+import asyncio
 import freud
+import numpy as np
+import numpy.testing as npt
 import unittest
+from concurrent.futures import ThreadPoolExecutor
 
 
 class TestParallel(unittest.TestCase):
@@ -25,6 +29,68 @@ class TestParallel(unittest.TestCase):
         freud.parallel.set_num_threads(1)
         self.assertEqual(freud.parallel.get_num_threads(), 1)
 
+    def test_concurrent_computes(self):
+        """Test that computes on several Python threads match serial ones."""
+        box_size = 10
+        num_points = 1000
+        frames = [freud.data.make_random_system(box_size, num_points,
+                                                seed=seed)
+                  for seed in range(8)]
+
+        def compute_frame(frame):
+            rdf = freud.density.RDF(bins=50, r_max=3)
+            rdf.compute(frame)
+            gd = freud.density.GaussianDensity(16, 2, 0.5)
+            gd.compute(frame)
+            return np.copy(rdf.rdf), np.copy(gd.density)
+
+        serial = [compute_frame(frame) for frame in frames]
+        with ThreadPoolExecutor(max_workers=4) as executor:
+            concurrent = list(executor.map(compute_frame, frames))
+
+        for (rdf, density), (rdf_concurrent, density_concurrent) in zip(
+                serial, concurrent):
+            npt.assert_allclose(rdf, rdf_concurrent, rtol=1e-6)
+            npt.assert_allclose(density, density_concurrent, rtol=1e-6)
+
+    def test_arena(self):
+        """Test that computes executed in arenas match default ones."""
+        box, points = freud.data.make_random_system(10, 1000, seed=0)
+        rdf = freud.density.RDF(bins=50, r_max=3)
+        expected = np.copy(rdf.compute((box, points)).rdf)
+
+        arena = freud.parallel.Arena(num_threads=2)
+        self.assertEqual(arena.num_threads, 2)
+        self.assertIsNone(arena.numa_node)
+        result = arena.execute(rdf.compute, (box, points), reset=True)
+        self.assertIs(result, rdf)
+        npt.assert_allclose(rdf.rdf, expected, rtol=1e-6)
+
+        # Exceptions raised by the function propagate to the caller.
+        with self.assertRaises(ZeroDivisionError):
+            arena.execute(lambda: 1 / 0)
+
+        with self.assertRaises(ValueError):
+            freud.parallel.Arena(num_threads=0)
+        with self.assertRaises(ValueError):
+            freud.parallel.Arena(numa_node=-1)
+
+    def test_numa_arenas(self):
+        """Test arenas bound to each NUMA node."""
+        nodes = freud.parallel.get_numa_nodes()
+        box, points = freud.data.make_random_system(10, 1000, seed=0)
+        expected = freud.density.RDF(bins=50, r_max=3).compute(
+            (box, points)).rdf
+        for node in nodes:
+            arena = freud.parallel.Arena(numa_node=node)
+            self.assertEqual(arena.numa_node, node)
+            self.assertGreater(arena.num_threads, 0)
+            rdf = freud.density.RDF(bins=50, r_max=3)
+            arena.execute(rdf.compute, (box, points))
+            npt.assert_allclose(rdf.rdf, expected, rtol=1e-6)
+        with self.assertRaises(ValueError):
+            freud.parallel.Arena(numa_node=max(nodes, default=-1) + 1)
+
         with freud.parallel.NumThreads(2):
             self.assertEqual(freud.parallel.get_num_threads(), 2)
 
@@ -32,6 +98,55 @@ class TestParallel(unittest.TestCase):
         # to its previous value.
         self.assertEqual(freud.parallel.get_num_threads(), 1)
 
+    def test_compute_async(self):
+        """Test that asynchronous computes match synchronous ones."""
+        frames = [freud.data.make_random_system(10, 1000, seed=seed)
+                  for seed in range(4)]
+        rdf = freud.density.RDF(bins=50, r_max=3)
+        for frame in frames:
+            rdf.compute(frame, reset=False)
+
+        # Computes of one object run in order of submission.
+        async_rdf = freud.density.RDF(bins=50, r_max=3)
+        futures = [async_rdf.compute_async(frame, reset=False)
+                   for frame in frames]
+        self.assertIs(futures[-1].result(), async_rdf)
+        self.assertTrue(all(future.done() for future in futures))
+        npt.assert_equal(async_rdf.bin_counts, rdf.bin_counts)
+
+        # Computes of separate objects run concurrently.
+        futures = [freud.density.RDF(bins=50, r_max=3).compute_async(frame)
+                   for frame in frames]
+        for future, frame in zip(futures, frames):
+            expected = freud.density.RDF(bins=50, r_max=3).compute(frame)
+            npt.assert_allclose(future.result().rdf, expected.rdf, rtol=1e-6)
+
+        # Errors are raised by the future, and later computes still run.
+        failed = async_rdf.compute_async(frames[0], neighbors='invalid')
+        future = async_rdf.compute_async(frames[0])
+        with self.assertRaises(ValueError):
+            failed.result()
+        self.assertIs(future.result(), async_rdf)
+
+        async def compute_all():
+            return await asyncio.gather(*[asyncio.wrap_future(
+                freud.density.RDF(bins=50, r_max=3).compute_async(frame))
+                for frame in frames])
+        loop = asyncio.new_event_loop()
+        try:
+            results = loop.run_until_complete(compute_all())
+        finally:
+            loop.close()
+        self.assertEqual(len(results), len(frames))
+
+        arena = freud.parallel.Arena(num_threads=2)
+        future = arena.submit(freud.density.RDF(bins=50, r_max=3).compute,
+                              frames[0])
+        npt.assert_allclose(future.result().rdf, futures[0].result().rdf,
+                            rtol=1e-6)
+        with self.assertRaises(ZeroDivisionError):
+            arena.submit(lambda: 1 / 0).result()
+
 
 if __name__ == '__main__':
     unittest.main()
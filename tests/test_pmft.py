@@ -13,6 +13,40 @@ matplotlib.use('agg')
 TWO_PI = 2*np.pi
 
 
+def make_bin_edge_system(n_bins, seed=0):
+    """Make points around the origin in directions within a few float
+    rounding errors of the edges of n_bins angular bins, with random
+    orientations."""
+    offsets = np.arange(-20, 21) * 1e-7
+    theta = (np.arange(n_bins)[:, np.newaxis] * (TWO_PI / n_bins) +
+             offsets[np.newaxis, :]).ravel()
+    points = np.zeros((len(theta), 3), dtype=np.float32)
+    points[:, 0] = 2 * np.cos(theta)
+    points[:, 1] = 2 * np.sin(theta)
+    orientations = np.random.RandomState(seed).uniform(
+        -10, 10, size=len(theta)).astype(np.float32)
+    orientations[::3] = 0
+    return points, orientations
+
+
+def float32_bin(values, lower, upper, n_bins):
+    """Find the bins of float32 values as the C++ regular axes do."""
+    bin_width = np.float32(np.float32(upper) - np.float32(lower)) / \
+        np.float32(n_bins)
+    scaled = (values.astype(np.float32) - np.float32(lower)) * \
+        (np.float32(1) / np.float32(bin_width))
+    return np.minimum(np.floor(scaled).astype(np.int64), n_bins - 1)
+
+
+def float32_angle(orientations, y, x):
+    """Compute the exact angles of the PMFT bins in float32, wrapped into
+    [0, 2*pi) as by util::modulusPositive."""
+    two_pi = np.float32(TWO_PI)
+    angles = orientations.astype(np.float32) - \
+        np.arctan2(y, x).astype(np.float32)
+    return np.fmod(np.fmod(angles, two_pi) + two_pi, two_pi)
+
+
 def build_radii(bin_centers):
     """Given bin centers in Cartesian coordinates, calculate distances from the
     origin."""
@@ -148,6 +182,97 @@ class TestPMFT:
         pmft = self.make_pmft()
         self.assertEqual(str(pmft), str(eval(repr(pmft))))
 
+    def test_adaptive_pmft(self):
+        L = 10
+        N = 500
+        system = freud.data.make_random_system(L, N, self.ndim == 2, seed=3)
+        orientations = rowan.random.rand(N) if self.ndim == 3 else \
+            np.random.rand(N)*2*np.pi
+
+        pmft = self.make_pmft()
+        with self.assertRaises(AttributeError):
+            pmft.adaptive_pmft(10)
+        pmft.compute(system, orientations)
+
+        # Subdividing every cell reproduces the full resolution PMFT.
+        npt.assert_allclose(pmft.adaptive_pmft(0), pmft.pmft, rtol=1e-5)
+
+        # A single cell holds the average over all bins.
+        coarse = pmft.adaptive_pmft(np.sum(pmft.bin_counts) + 1)
+        self.assertEqual(coarse.shape, pmft.pmft.shape)
+        npt.assert_allclose(coarse, coarse.flat[0], rtol=1e-5)
+
+        # Averaging over cells never reaches a larger PCF than the maximum
+        # of the full resolution PCF, and leaves no bond uncounted.
+        adaptive = pmft.adaptive_pmft(20)
+        finite = np.isfinite(pmft.pmft)
+        self.assertGreaterEqual(np.sum(np.isfinite(adaptive)), np.sum(finite))
+        self.assertGreaterEqual(np.min(adaptive[np.isfinite(adaptive)]),
+                                np.min(pmft.pmft[finite]) - 1e-5)
+
+    def test_serialize(self):
+        N = 200
+        pmft = self.make_pmft()
+        shards = [self.make_pmft(), self.make_pmft()]
+        for frame in range(4):
+            box, points = freud.data.make_random_system(
+                10 + frame, N, self.ndim == 2, seed=frame)
+            orientations = (rowan.random.rand(N) if self.ndim == 3 else
+                            np.random.rand(N)*2*np.pi)
+            pmft.compute((box, points), orientations, reset=False)
+            shards[frame % 2].compute((box, points), orientations,
+                                      reset=False)
+
+        merged = self.make_pmft().merge(shards[0]).merge(
+            shards[1].serialize())
+        npt.assert_equal(merged.bin_counts, pmft.bin_counts)
+        self.assertEqual(merged.box, shards[1].box)
+
+        restored = self.make_pmft().deserialize(pmft.serialize())
+        npt.assert_equal(restored.bin_counts, pmft.bin_counts)
+        npt.assert_allclose(restored.pmft, pmft.pmft, rtol=1e-6)
+        with self.assertRaises(ValueError):
+            freud.density.RDF(10, 1).deserialize(pmft.serialize())
+
+    def test_compute_trajectory(self):
+        N = 200
+        boxes = []
+        points = []
+        orientations = []
+        for frame in range(3):
+            box, frame_points = freud.data.make_random_system(
+                10 + frame, N, self.ndim == 2, seed=frame)
+            boxes.append(box)
+            points.append(frame_points)
+            orientations.append(rowan.random.rand(N) if self.ndim == 3 else
+                                np.random.rand(N)*2*np.pi)
+
+        pmft = self.make_pmft()
+        for box, frame_points, frame_orientations in zip(
+                boxes, points, orientations):
+            pmft.compute((box, frame_points), frame_orientations, reset=False)
+        bin_counts = np.copy(pmft.bin_counts)
+
+        trajectory_pmft = self.make_pmft()
+        trajectory_pmft.compute_trajectory(boxes, np.array(points),
+                                           np.array(orientations))
+        npt.assert_equal(trajectory_pmft.bin_counts, bin_counts)
+        npt.assert_allclose(trajectory_pmft.pmft, pmft.pmft, rtol=1e-5)
+
+        trajectory_pmft.compute_trajectory(boxes, np.array(points),
+                                           np.array(orientations),
+                                           parallel_frames=True)
+        npt.assert_equal(trajectory_pmft.bin_counts, bin_counts)
+        npt.assert_allclose(trajectory_pmft.pmft, pmft.pmft, rtol=1e-5)
+
+        # A NeighborList only describes the bonds of one frame.
+        nlist = freud.AABBQuery(boxes[0], points[0]).query(
+            points[0], dict(r_max=1)).toNeighborList()
+        with self.assertRaises(ValueError):
+            trajectory_pmft.compute_trajectory(
+                boxes, np.array(points), np.array(orientations),
+                neighbors=nlist)
+
     def test_pcf(self):
         """Verify that integrating a PMFT to generate an RDF for an ideal gas
         produces approximately unity everywhere."""
@@ -257,6 +382,30 @@ class TestPMFTR12(TestPMFT2D, unittest.TestCase):
             self.assertEqual(len(np.unique(pmft.pmft)), 3)
 
 
+    def test_bin_edges(self):
+        """Check that bonds near the edges of angular bins are binned as
+        with exact angles."""
+        box = self.get_cubic_box(self.L)
+        points, orientations = make_bin_edge_system(self.bins[1])
+        query_points = np.zeros((1, 3), dtype=np.float32)
+        query_orientations = np.array([0.3], dtype=np.float32)
+        pmft = freud.pmft.PMFTR12(*self.limits, bins=self.bins)
+        pmft.compute((box, points), orientations, query_points,
+                     query_orientations,
+                     neighbors=dict(r_max=self.limits[0]))
+
+        x, y = points[:, 0], points[:, 1]
+        distances = np.sqrt(x*x + y*y)
+        bins = (float32_bin(distances, 0, self.limits[0], self.bins[0]),
+                float32_bin(float32_angle(orientations, y, x),
+                            0, TWO_PI, self.bins[1]),
+                float32_bin(float32_angle(query_orientations, -y, -x),
+                            0, TWO_PI, self.bins[2]))
+        expected = np.zeros(self.bins, dtype=np.int64)
+        np.add.at(expected, bins, 1)
+        npt.assert_equal(pmft.bin_counts, expected)
+
+
 class TestPMFTXYT(TestPMFT2D, unittest.TestCase):
     limits = (3.6, 4.2)
     bins = (20, 30, 40)
@@ -329,6 +478,26 @@ class TestPMFTXYT(TestPMFT2D, unittest.TestCase):
 
             self.assertEqual(len(np.unique(pmft.pmft)), 2)
 
+    def test_bin_edges(self):
+        """Check that bonds near the edges of angular bins are binned as
+        with exact angles."""
+        box = self.get_cubic_box(self.L)
+        points, orientations = make_bin_edge_system(self.bins[2])
+        query_points = np.zeros((1, 3), dtype=np.float32)
+        query_orientations = np.zeros(1, dtype=np.float32)
+        pmft = freud.pmft.PMFTXYT(*self.limits, bins=self.bins)
+        pmft.compute((box, points), orientations, query_points,
+                     query_orientations, neighbors=dict(r_max=3.5))
+
+        x, y = points[:, 0], points[:, 1]
+        bins = (float32_bin(x, -self.limits[0], self.limits[0], self.bins[0]),
+                float32_bin(y, -self.limits[1], self.limits[1], self.bins[1]),
+                float32_bin(float32_angle(orientations, -y, -x),
+                            0, TWO_PI, self.bins[2]))
+        expected = np.zeros(self.bins, dtype=np.int64)
+        np.add.at(expected, bins, 1)
+        npt.assert_equal(pmft.bin_counts, expected)
+
     def test_nontrivial_orientations(self):
         """Ensure that orientations are applied to the right particles."""
         box = self.get_cubic_box(6)
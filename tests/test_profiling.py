@@ -0,0 +1,67 @@
+import freud
+import numpy as np
+import unittest
+
+
+class TestProfiling(unittest.TestCase):
+    """Test the timers and counters of freud.profiling."""
+
+    def tearDown(self):
+        freud.profiling.disable()
+        freud.profiling.reset()
+
+    def compute_rdf(self):
+        box, points = freud.data.make_random_system(10, 1000, seed=0)
+        rdf = freud.density.RDF(bins=10, r_max=2)
+        rdf.compute((box, points), reset=False)
+        return rdf.rdf
+
+    def test_enable(self):
+        self.assertFalse(freud.profiling.is_enabled())
+        freud.profiling.enable()
+        self.assertTrue(freud.profiling.is_enabled())
+        freud.profiling.disable()
+        self.assertFalse(freud.profiling.is_enabled())
+
+    def test_disabled(self):
+        """Nothing is recorded while profiling is disabled."""
+        freud.profiling.reset()
+        self.compute_rdf()
+        self.assertEqual(freud.profiling.get_timers(), {})
+        self.assertEqual(set(freud.profiling.get_counters().values()), {0})
+
+    def test_profiler(self):
+        with freud.profiling.Profiler() as profiler:
+            rdf = self.compute_rdf()
+        self.assertFalse(freud.profiling.is_enabled())
+        self.assertEqual(set(profiler.counters),
+                         {'bonds_visited', 'cells_scanned', 'nodes_tested'})
+        self.assertIn('phase', profiler.report())
+
+        # Profiling does not change results.
+        np.testing.assert_allclose(rdf, self.compute_rdf())
+
+        if not freud.profiling.is_compiled():
+            self.assertEqual(profiler.timers, {})
+            return
+
+        # Timers of different modules are recorded in the same profile.
+        for phase in ['AABBQuery::build', 'NeighborQuery::forEachNeighbor',
+                      'BondHistogramCompute::accumulate', 'RDF::reduce']:
+            self.assertIn(phase, profiler.timers)
+            calls, seconds = profiler.timers[phase]
+            self.assertGreaterEqual(calls, 1)
+            self.assertGreaterEqual(seconds, 0)
+        self.assertGreater(profiler.counters['bonds_visited'], 0)
+        self.assertGreater(profiler.counters['nodes_tested'], 0)
+
+    def test_reset(self):
+        freud.profiling.enable()
+        self.compute_rdf()
+        freud.profiling.reset()
+        self.assertEqual(freud.profiling.get_timers(), {})
+        self.assertEqual(set(freud.profiling.get_counters().values()), {0})
+
+
+if __name__ == '__main__':
+    unittest.main()
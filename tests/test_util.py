@@ -49,6 +49,57 @@ class TestCommon(unittest.TestCase):
         with self.assertRaises(ValueError):
             freud.util._convert_array(z, shape=(None, 9))
 
+    def test_convert_strided_array(self):
+        """Test that strided and float64 arrays convert to the same
+        contiguous float32 arrays as NumPy."""
+        np.random.seed(0)
+        for dtype in (np.float32, np.float64):
+            x = np.random.uniform(-10, 10, size=(100000, 4)).astype(dtype)
+            for y in (x, x[:, :3], x[::-3, 1:], x[:30].T, x[:, 2],
+                      x[::7, 0], x[:0, :3]):
+                z = freud.util._convert_array(y)
+                self.assertEqual(z.dtype, np.float32)
+                self.assertTrue(z.flags.c_contiguous)
+                npt.assert_array_equal(z, y.astype(np.float32))
+
+        # Copies are only made when requested for arrays that are not
+        # converted.
+        x = np.random.uniform(size=(10, 3)).astype(np.float32)
+        self.assertIs(freud.util._convert_array(x), x)
+        z = freud.util._convert_array(x, copy=True)
+        self.assertFalse(np.may_share_memory(z, x))
+        npt.assert_array_equal(z, x)
+        z = freud.util._convert_array(x[:, ::-1], copy=True)
+        npt.assert_array_equal(z, x[:, ::-1])
+
+    def test_convert_device_array(self):
+        x = np.arange(30, dtype=np.float32).reshape(10, 3)
+
+        class CudaArray:
+            """Array exposing the CUDA array interface without CuPy."""
+            __cuda_array_interface__ = {}
+
+            def get(self):
+                return x
+
+        try:
+            import cupy  # noqa: F401
+        except ImportError:
+            npt.assert_equal(freud.util._convert_array(CudaArray()), x)
+
+        class HostDLPackArray:
+            """Array in host memory exposing the DLPack protocol."""
+
+            def __dlpack__(self, stream=None):
+                return x.__dlpack__()
+
+            def __dlpack_device__(self):
+                return x.__dlpack_device__()
+
+        if hasattr(np, 'from_dlpack'):
+            npt.assert_equal(
+                freud.util._convert_array(HostDLPackArray(), (None, 3)), x)
+
     def test_convert_matrix_box(self):
         matrix_box = np.array([[1, 2, 3],
                                [0, 2, 3],